@@ -0,0 +1,4 @@
+// The parser waits for this script, so by now the preload scanner has been through the rest of the document.
+window.testResults = window.preloadCandidates.map(function (url) {
+    return !!(window.internals && internals.isPreloaded(url));
+});
@@ -0,0 +1 @@
+// Only here to be preloaded.
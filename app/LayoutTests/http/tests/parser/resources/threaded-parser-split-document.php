@@ -0,0 +1,25 @@
+<?php
+// Sends a document in small pieces, and waits after each one, so that the parser gets its input in
+// reads that end partway through tokens.
+header("Content-Type: text/html; charset=utf-8");
+
+$pieces = array(
+    "<!DOCTYPE html><html><head><ti", "tle>a &am", "p; b</ti", "tle>",
+    "<sty", "le>p { color: green } </sty", "x> </st", "yle>",
+    "</head><body><p id=\"para", "graph\" cla", "ss=a>text &amp", "; more</p>",
+    "<!-", "- a comment -", "->",
+    "<scr", "ipt>document.write(\"<b>wri", "tten</b><i title='a\");</scr", "ipt>b'>c</i>",
+    "<script>var d = 1;</script>", "<p>after a script at the end of a read</p>",
+    "<textarea>&lt;b&", "gt;</texta", "rea>",
+    "<svg><![CD", "ATA[<b>e</b>]]", "></svg>",
+    "<select><sty", "le><b>f</b></st", "yle></select>",
+    "caf\xc3", "\xa9 a\r", "\nb",
+    "<plain", "text></plaintext><b>g</b>",
+);
+
+foreach ($pieces as $piece) {
+    echo $piece;
+    flush();
+    usleep(20000);
+}
+?>
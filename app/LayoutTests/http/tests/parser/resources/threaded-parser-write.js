@@ -0,0 +1 @@
+document.write("<b>written by an external script</b><i>partial");
@@ -0,0 +1,195 @@
+// Loads documents into a frame with the threaded HTML parser off and then on, and checks that both
+// build the same tree. Documents given as source are loaded from blob URLs, so that they come through
+// the loader like a network document instead of being written into a frame by script.
+
+if (window.testRunner) {
+    testRunner.dumpAsText();
+    testRunner.waitUntilDone();
+}
+
+if (window.internals) {
+    // The XSS auditor turns the threaded parser off.
+    internals.settings.setXSSAuditorEnabled(false);
+}
+
+function log(message)
+{
+    document.getElementById("log").textContent += message + "\n";
+}
+
+function check(condition, message)
+{
+    log((condition ? "PASS: " : "FAIL: ") + message);
+}
+
+function namespacePrefix(namespaceURI)
+{
+    switch (namespaceURI) {
+    case null:
+    case "http://www.w3.org/1999/xhtml":
+        return "";
+    case "http://www.w3.org/2000/svg":
+        return "svg ";
+    case "http://www.w3.org/1998/Math/MathML":
+        return "math ";
+    case "http://www.w3.org/1999/xlink":
+        return "xlink ";
+    case "http://www.w3.org/XML/1998/namespace":
+        return "xml ";
+    case "http://www.w3.org/2000/xmlns/":
+        return "xmlns ";
+    }
+    return "{" + namespaceURI + "} ";
+}
+
+function dumpNode(node, indent, lines)
+{
+    var line;
+    switch (node.nodeType) {
+    case Node.ELEMENT_NODE:
+        var attributes = Array.prototype.map.call(node.attributes, function (attribute) {
+            return " " + namespacePrefix(attribute.namespaceURI) + attribute.localName + "=" + JSON.stringify(attribute.value);
+        });
+        line = "<" + namespacePrefix(node.namespaceURI) + node.localName + attributes.sort().join("") + ">";
+        break;
+    case Node.TEXT_NODE:
+        line = JSON.stringify(node.data);
+        break;
+    case Node.COMMENT_NODE:
+        line = "<!-- " + JSON.stringify(node.data) + " -->";
+        break;
+    case Node.DOCUMENT_TYPE_NODE:
+        line = "<!DOCTYPE " + node.name + ">";
+        break;
+    default:
+        line = node.nodeName;
+    }
+    lines.push(indent + line);
+
+    var children = node.localName == "template" && node.content ? node.content.childNodes : node.childNodes;
+    for (var i = 0; i < children.length; ++i)
+        dumpNode(children[i], indent + "  ", lines);
+}
+
+function dumpTree(document)
+{
+    var lines = [];
+    dumpNode(document, "", lines);
+    return lines;
+}
+
+function blobURL(source)
+{
+    return URL.createObjectURL(new Blob([source], { type: "text/html;charset=utf-8" }));
+}
+
+function loadDocument(url, threaded, callback)
+{
+    internals.settings.setThreadedHTMLParserEnabled(threaded);
+
+    var frame = document.createElement("iframe");
+    frame.onload = function () {
+        var frameDocument = frame.contentDocument;
+        var result = {
+            tree: dumpTree(frameDocument),
+            // Whatever the document's own scripts want to report.
+            testResults: frame.contentWindow.testResults,
+            chunks: internals.backgroundParsedChunkCount(frameDocument),
+            rewinds: internals.discardedParserSpeculationCount(frameDocument),
+        };
+        frame.remove();
+        callback(result);
+    };
+    frame.src = url;
+    document.body.appendChild(frame);
+}
+
+// Returns a description of the first difference between the trees, or null if they are the same.
+function treeDifference(expected, actual)
+{
+    for (var i = 0; i < Math.max(expected.length, actual.length); ++i) {
+        if (expected[i] !== actual[i])
+            return "line " + i + " is " + JSON.stringify(actual[i]) + " but should be " + JSON.stringify(expected[i]);
+    }
+    return null;
+}
+
+// The background parser sends its tokens to the main thread in chunks of 500. Returns copies of the
+// markup that start at each token position around the end of the first chunk.
+function atChunkBoundary(markup)
+{
+    var sources = [];
+    // <!DOCTYPE html> and each <br> are one token.
+    for (var padding = 494; padding <= 501; ++padding)
+        sources.push("<!DOCTYPE html>" + "<br>".repeat(padding) + markup);
+    return sources;
+}
+
+// Each test has a name and a list of document sources or URLs. Some also set expectRewind, if the
+// background parser is known to guess wrong for every one of them and have to resume from a checkpoint,
+// or compare(serial, threaded), to check more than the tree.
+function runThreadedParserTests(tests)
+{
+    if (!window.internals) {
+        log("This test needs window.internals.");
+        finishThreadedParserTests();
+        return;
+    }
+
+    var testIndex = 0;
+    function runNextTest()
+    {
+        if (testIndex == tests.length) {
+            finishThreadedParserTests();
+            return;
+        }
+
+        var test = tests[testIndex++];
+        var urls = test.sources ? test.sources.map(blobURL) : test.urls;
+        var failures = [];
+        var urlIndex = 0;
+        function loadNextURL()
+        {
+            if (urlIndex == urls.length) {
+                if (test.sources)
+                    urls.forEach(function (url) { URL.revokeObjectURL(url); });
+                check(!failures.length, test.name + (failures.length ? ": " + failures.join("; ") : ""));
+                runNextTest();
+                return;
+            }
+
+            var url = urls[urlIndex];
+            var label = urls.length > 1 ? "document " + urlIndex + " " : "";
+            ++urlIndex;
+            loadDocument(url, false, function (serial) {
+                loadDocument(url, true, function (threaded) {
+                    var difference = treeDifference(serial.tree, threaded.tree);
+                    if (difference)
+                        failures.push(label + "has a different tree: " + difference);
+                    if (serial.chunks)
+                        failures.push(label + "was parsed on a background thread with the setting off");
+                    if (!threaded.chunks)
+                        failures.push(label + "was not parsed on a background thread");
+                    if (test.expectRewind && !threaded.rewinds)
+                        failures.push(label + "did not make the parser resume from a checkpoint");
+                    if (test.compare) {
+                        var message = test.compare(serial, threaded);
+                        if (message)
+                            failures.push(label + message);
+                    }
+                    loadNextURL();
+                });
+            });
+        }
+        loadNextURL();
+    }
+    runNextTest();
+}
+
+function finishThreadedParserTests()
+{
+    if (window.internals)
+        internals.settings.setThreadedHTMLParserEnabled(false);
+    if (window.testRunner)
+        testRunner.notifyDone();
+}
@@ -112,6 +112,39 @@ void JSContextGroupClearExecutionTimeLimit(JSContextGroupRef group)
         vm.watchdog()->setTimeLimit(Watchdog::noTimeLimit);
 }
 
+static HeapGrowthPolicy toHeapGrowthPolicy(JSHeapGrowthPolicy growthPolicy)
+{
+    switch (growthPolicy) {
+    case kJSHeapGrowthPolicyThroughput:
+        return HeapGrowthPolicy::Throughput;
+    case kJSHeapGrowthPolicyFootprint:
+        return HeapGrowthPolicy::Footprint;
+    case kJSHeapGrowthPolicyDefault:
+        break;
+    }
+    return HeapGrowthPolicy::Default;
+}
+
+void JSContextGroupSetHeapBudget(JSContextGroupRef group, size_t softLimit, size_t hardLimit, JSHeapGrowthPolicy growthPolicy, JSHeapLimitCallback callback, void* context)
+{
+    VM& vm = *toJS(group);
+    JSLockHolder locker(&vm);
+
+    HeapBudget budget;
+    budget.softLimit = softLimit;
+    budget.hardLimit = hardLimit;
+    budget.growthPolicy = toHeapGrowthPolicy(growthPolicy);
+    vm.heap.setBudget(budget);
+
+    if (!callback) {
+        vm.heap.setHeapLimitCallback(nullptr);
+        return;
+    }
+    vm.heap.setHeapLimitCallback([group, callback, context] (HeapLimit limit, size_t heapSize) {
+        callback(group, limit == HeapLimit::Hard ? kJSHeapLimitHard : kJSHeapLimitSoft, heapSize, context);
+    });
+}
+
 // From the API's perspective, a global context remains alive iff it has been JSGlobalContextRetained.
 
 JSGlobalContextRef JSGlobalContextCreate(JSClassRef globalObjectClass)
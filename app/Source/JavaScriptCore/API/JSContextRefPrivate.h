@@ -94,6 +94,64 @@ JS_EXPORT void JSContextGroupSetExecutionTimeLimit(JSContextGroupRef group, doub
 */
 JS_EXPORT void JSContextGroupClearExecutionTimeLimit(JSContextGroupRef group) CF_AVAILABLE(10_6, 7_0);
 
+/*!
+@enum JSHeapGrowthPolicy
+@abstract How much a context group's heap may grow between full garbage collections.
+@constant kJSHeapGrowthPolicyDefault Grow quickly while the heap is small compared to the
+ device's memory, and more slowly as it gets larger.
+@constant kJSHeapGrowthPolicyThroughput Always grow quickly, collecting less often at the cost of
+ more memory.
+@constant kJSHeapGrowthPolicyFootprint Always grow slowly, using less memory at the cost of
+ collecting more often.
+*/
+typedef enum {
+    kJSHeapGrowthPolicyDefault = 0,
+    kJSHeapGrowthPolicyThroughput,
+    kJSHeapGrowthPolicyFootprint
+} JSHeapGrowthPolicy;
+
+/*!
+@enum JSHeapLimit
+@abstract The limits passed to JSContextGroupSetHeapBudget.
+*/
+typedef enum {
+    kJSHeapLimitSoft = 0,
+    kJSHeapLimitHard
+} JSHeapLimit;
+
+/*!
+@typedef JSHeapLimitCallback
+@abstract The callback invoked when a garbage collection leaves a context group's heap larger
+ than a limit set with JSContextGroupSetHeapBudget.
+@param group The context group whose heap is over the limit.
+@param limit kJSHeapLimitHard if the heap is over the hard limit, otherwise kJSHeapLimitSoft.
+@param heapSize The size of the heap after the collection, in bytes.
+@param context User specified context data previously passed to JSContextGroupSetHeapBudget.
+@discussion The callback is invoked on the thread that holds the context group's lock, while the
+ group may be in the middle of running script. It must not run script or create JavaScript
+ values. To shed load, it can for example use JSContextGroupSetExecutionTimeLimit to terminate
+ the running script.
+*/
+typedef void
+(*JSHeapLimitCallback) (JSContextGroupRef group, JSHeapLimit limit, size_t heapSize, void* context);
+
+/*!
+@function
+@abstract Sets how far a context group's heap may grow.
+@param group The JavaScript context group whose heap is limited.
+@param softLimit The heap size in bytes that garbage collection tries to stay under, or 0.
+@param hardLimit The heap size in bytes that the embedder considers out of memory, or 0.
+@param growthPolicy How quickly the heap grows while it is under its limits.
+@param callback The callback function that will be invoked each time a full garbage collection
+ leaves the heap over one of the limits, or NULL.
+@param context User data that you can provide to be passed back to you in your callback.
+@discussion Garbage collection is scheduled so that the heap does not grow past the soft limit,
+ or past the hard limit if there is no soft limit, and becomes more frequent once the heap is
+ over it. Neither limit stops script from keeping more objects alive. The new budget takes effect
+ at the end of the next garbage collection.
+*/
+JS_EXPORT void JSContextGroupSetHeapBudget(JSContextGroupRef group, size_t softLimit, size_t hardLimit, JSHeapGrowthPolicy growthPolicy, JSHeapLimitCallback callback, void* context) CF_AVAILABLE(10_13, 11_0);
+
 /*!
 @function
 @abstract Gets a whether or not remote inspection is enabled on the context.
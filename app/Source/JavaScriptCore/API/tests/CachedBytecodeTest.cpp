@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "CachedBytecodeTest.h"
+
+#include "CachedBytecode.h"
+#include "CodeCache.h"
+#include "Completion.h"
+#include "JSCInlines.h"
+#include "JSGlobalObject.h"
+#include "VM.h"
+#include <wtf/RefPtr.h>
+
+using namespace JSC;
+
+namespace {
+
+// Hands bytecode to the code cache and keeps whatever the code cache stores, the way CachedScript does.
+class StoringSourceProvider final : public SourceProvider {
+public:
+    static Ref<StoringSourceProvider> create(const String& source, RefPtr<CachedBytecode>&& cachedBytecode)
+    {
+        return adoptRef(*new StoringSourceProvider(source, WTFMove(cachedBytecode)));
+    }
+
+    unsigned hash() const override { return m_source.impl()->hash(); }
+    StringView source() const override { return m_source; }
+    bool supportsCachedBytecode() const override { return true; }
+    bool shouldStoreCachedBytecode() const override { return true; }
+    RefPtr<CachedBytecode> cachedBytecode() const override { return m_cachedBytecode; }
+
+    void updateCachedBytecode(Ref<CachedBytecode>&& cachedBytecode) override
+    {
+        m_storedBytecode = WTFMove(cachedBytecode);
+        ++m_storeCount;
+    }
+
+    RefPtr<CachedBytecode> storedBytecode() const { return m_storedBytecode; }
+    unsigned storeCount() const { return m_storeCount; }
+
+private:
+    StoringSourceProvider(const String& source, RefPtr<CachedBytecode>&& cachedBytecode)
+        : SourceProvider(SourceOrigin(), String(), TextPosition(), SourceProviderSourceType::Program)
+        , m_source(source)
+        , m_cachedBytecode(WTFMove(cachedBytecode))
+    {
+    }
+
+    String m_source;
+    RefPtr<CachedBytecode> m_cachedBytecode;
+    RefPtr<CachedBytecode> m_storedBytecode;
+    unsigned m_storeCount { 0 };
+};
+
+struct RunResult {
+    String result;
+    RefPtr<CachedBytecode> storedBytecode;
+    unsigned storeCount;
+};
+
+} // anonymous namespace
+
+// The code cache of a VM would answer from memory, so every run gets a VM of its own.
+static RunResult run(const String& program, RefPtr<CachedBytecode>&& cachedBytecode)
+{
+    RunResult runResult;
+    RefPtr<VM> vm = VM::create();
+    {
+        JSLockHolder locker(vm.get());
+        JSGlobalObject* globalObject = JSGlobalObject::create(*vm, JSGlobalObject::createStructure(*vm, jsNull()));
+        ExecState* exec = globalObject->globalExec();
+        Ref<StoringSourceProvider> provider = StoringSourceProvider::create(program, WTFMove(cachedBytecode));
+        NakedPtr<Exception> exception;
+        JSValue result = evaluate(exec, SourceCode(provider.copyRef()), JSValue(), exception);
+        if (!exception && result.isString())
+            runResult.result = asString(result)->value(exec);
+
+        // Re-encode now that the functions have run, so the blob includes their code blocks.
+        vm->codeCache()->writeCachedBytecodes(*vm);
+        runResult.storedBytecode = provider->storedBytecode();
+        runResult.storeCount = provider->storeCount();
+    }
+    vm = nullptr;
+    return runResult;
+}
+
+static Ref<CachedBytecode> copyBytecode(const CachedBytecode& cachedBytecode, size_t size, size_t flippedOffset = notFound, uint8_t flippedBits = 0)
+{
+    Vector<uint8_t> data;
+    data.append(cachedBytecode.data(), size);
+    if (flippedOffset != notFound)
+        data[flippedOffset] ^= flippedBits;
+    return CachedBytecode::create(WTFMove(data));
+}
+
+static bool check(bool condition, const char* description)
+{
+    if (condition)
+        return false;
+    printf("FAIL: %s\n", description);
+    return true;
+}
+
+static const char* program =
+    "var log = [];\n"
+    "function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }\n"
+    "log.push(fib(15));\n"
+    "var counter = (function () { var count = 0; return { next: function () { return ++count; } }; })();\n"
+    "counter.next();\n"
+    "log.push(counter.next());\n"
+    "class Point { constructor(x, y) { this.x = x; this.y = y; } get length() { return Math.sqrt(this.x * this.x + this.y * this.y); } }\n"
+    "log.push(new Point(3, 4).length);\n"
+    "log.push(`template ${1 + 2}`);\n"
+    "log.push(/a(b+)c/.exec('xabbbc')[1]);\n"
+    "try { null.foo; } catch (e) { log.push(e instanceof TypeError); }\n"
+    "log.push([1, 2, 3].map(x => x * 2).join('-'));\n"
+    "var { a, b: [c, ...rest] } = { a: 1, b: [2, 3, 4] };\n"
+    "log.push(a + c + rest.length);\n"
+    "function* gen() { yield 1; yield 2; }\n"
+    "log.push([...gen()].length);\n"
+    "log.push(0.1 + 0.2, '\\u00e9\\u4e2d', 1e21, 2147483648, undefined, null);\n"
+    "for (var i = 0, sum = 0; i < 10; ++i) { if (i % 3) continue; sum += i; }\n"
+    "switch (sum) { case 18: log.push('eighteen'); break; default: log.push('other'); }\n"
+    "JSON.stringify(log);\n";
+
+int testCachedBytecode()
+{
+    Options::initialize(); // Ensure options is initialized first.
+
+    bool failed = false;
+    String source(program);
+
+    RunResult original = run(source, nullptr);
+    failed = check(!original.result.isNull(), "the program did not evaluate to a string") || failed;
+    failed = check(!!original.storedBytecode, "compiling the program stored no bytecode") || failed;
+    if (!original.storedBytecode) {
+        printf("FAIL: cached bytecode.\n");
+        return failed;
+    }
+    const CachedBytecode& blob = *original.storedBytecode;
+
+    RunResult cached = run(source, original.storedBytecode);
+    failed = check(cached.result == original.result, "the program gave a different result when decoded in a fresh VM") || failed;
+    failed = check(cached.storeCount == 1, "the program was compiled again instead of being decoded") || failed;
+
+    // Each of these must be rejected, so the program is compiled again and the result is unchanged.
+    // A compile from source stores the program once before it runs, on top of the store after it.
+    auto checkRejected = [&] (Ref<CachedBytecode>&& bytecode, const String& expectedResult, const String& programSource, const char* description) {
+        RunResult runResult = run(programSource, WTFMove(bytecode));
+        failed = check(runResult.result == expectedResult && runResult.storeCount == 2, description) || failed;
+    };
+
+    // The header is the magic, version, pointer size, opcode count, flags and source length, then
+    // the source digest and the payload size and hash.
+    const size_t versionOffset = sizeof(uint32_t);
+    const size_t digestOffset = 6 * sizeof(uint32_t);
+    const size_t payloadOffset = digestOffset + SHA1::hashSize + 2 * sizeof(uint32_t);
+
+    checkRejected(copyBytecode(blob, 0), original.result, source, "an empty blob was not rejected");
+    checkRejected(copyBytecode(blob, payloadOffset - 1), original.result, source, "a blob with a truncated header was not rejected");
+    checkRejected(copyBytecode(blob, blob.size() / 2), original.result, source, "a blob truncated in its payload was not rejected");
+    checkRejected(copyBytecode(blob, blob.size() - 1), original.result, source, "a blob missing its last byte was not rejected");
+
+    checkRejected(copyBytecode(blob, blob.size(), versionOffset, 1), original.result, source, "a blob with another version was not rejected");
+    checkRejected(copyBytecode(blob, blob.size(), digestOffset, 1), original.result, source, "a blob with another source digest was not rejected");
+
+    // Flip one bit at a time across the payload. The payload hash has to catch every one.
+    size_t step = std::max<size_t>(1, (blob.size() - payloadOffset) / 16);
+    for (size_t offset = payloadOffset; offset < blob.size(); offset += step)
+        checkRejected(copyBytecode(blob, blob.size(), offset, 1 << (offset % 8)), original.result, source, "a blob with a flipped bit was not rejected");
+
+    {
+        // Same length, different text: the blob must not run in place of the new program.
+        String otherSource = source;
+        otherSource.replace("fib(15)", "fib(16)");
+        RunResult otherResult = run(otherSource, nullptr);
+        failed = check(otherResult.result != original.result, "changing the program did not change its result") || failed;
+        checkRejected(copyBytecode(blob, blob.size()), otherResult.result, otherSource, "a blob for different source text was not rejected");
+    }
+
+    printf("%s: cached bytecode.\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ConcurrentProgramCompilationTest.h"
+
+#include "CachedBytecode.h"
+#include "Completion.h"
+#include "ConcurrentProgramCompilation.h"
+#include "JSCInlines.h"
+#include "JSGlobalObject.h"
+#include "VM.h"
+#include <wtf/RefPtr.h>
+#include <wtf/text/StringBuilder.h>
+
+using namespace JSC;
+
+namespace {
+
+// Hands out the result of a background compile the way CachedScript does.
+class CachedBytecodeSourceProvider final : public SourceProvider {
+public:
+    static Ref<CachedBytecodeSourceProvider> create(const String& source, RefPtr<CachedBytecode>&& cachedBytecode)
+    {
+        return adoptRef(*new CachedBytecodeSourceProvider(source, WTFMove(cachedBytecode)));
+    }
+
+    unsigned hash() const override { return m_source.impl()->hash(); }
+    StringView source() const override { return m_source; }
+    bool supportsCachedBytecode() const override { return true; }
+    RefPtr<CachedBytecode> cachedBytecode() const override { return m_cachedBytecode; }
+
+private:
+    CachedBytecodeSourceProvider(const String& source, RefPtr<CachedBytecode>&& cachedBytecode)
+        : SourceProvider(SourceOrigin(), String(), TextPosition(), SourceProviderSourceType::Program)
+        , m_source(source)
+        , m_cachedBytecode(WTFMove(cachedBytecode))
+    {
+    }
+
+    String m_source;
+    RefPtr<CachedBytecode> m_cachedBytecode;
+};
+
+} // anonymous namespace
+
+static bool check(bool condition, const char* description)
+{
+    if (condition)
+        return false;
+    printf("FAIL: %s\n", description);
+    return true;
+}
+
+int testConcurrentProgramCompilation()
+{
+    Options::initialize(); // Ensure options is initialized first.
+
+    bool savedUseConcurrentProgramCompilation = Options::useConcurrentProgramCompilation();
+    unsigned savedMinimumLength = Options::minimumConcurrentProgramCompilationLength();
+
+    bool failed = false;
+
+    StringBuilder builder;
+    builder.appendLiteral("var total = 0;\n");
+    for (unsigned i = 0; i < 100; ++i)
+        builder.appendLiteral("total += (function (x) { return x * 2; })(1);\n");
+    builder.appendLiteral("total;\n");
+    String program = builder.toString();
+
+    Options::useConcurrentProgramCompilation() = false;
+    failed = check(!ConcurrentProgramCompilation::start(program), "start() compiled with useConcurrentProgramCompilation off") || failed;
+
+    Options::useConcurrentProgramCompilation() = true;
+    Options::minimumConcurrentProgramCompilationLength() = 0;
+
+    {
+        RefPtr<ConcurrentProgramCompilation> compilation = ConcurrentProgramCompilation::start(program);
+        failed = check(!!compilation, "start() did not queue a compile") || failed;
+        if (compilation) {
+            ConcurrentProgramCompilation::waitUntilAllCompilationsAreFinishedForTesting();
+            RefPtr<CachedBytecode> cachedBytecode = compilation->takeCachedBytecode();
+            failed = check(!!cachedBytecode, "a finished compile produced no bytecode") || failed;
+            failed = check(!compilation->takeCachedBytecode(), "the result of a compile was taken twice") || failed;
+
+            // The helper VM is gone by now, so this also checks that the result does not depend on it.
+            RefPtr<VM> vm = VM::create();
+            JSLockHolder locker(vm.get());
+            JSGlobalObject* globalObject = JSGlobalObject::create(*vm, JSGlobalObject::createStructure(*vm, jsNull()));
+            NakedPtr<Exception> exception;
+            JSValue result = evaluate(globalObject->globalExec(), SourceCode(CachedBytecodeSourceProvider::create(program, WTFMove(cachedBytecode))), JSValue(), exception);
+            failed = check(!exception && result.isInt32() && result.asInt32() == 200, "a program evaluated from concurrently compiled bytecode gave the wrong result") || failed;
+        }
+    }
+
+    {
+        RefPtr<ConcurrentProgramCompilation> compilation = ConcurrentProgramCompilation::start("var x = ;");
+        if (compilation) {
+            ConcurrentProgramCompilation::waitUntilAllCompilationsAreFinishedForTesting();
+            failed = check(!compilation->takeCachedBytecode(), "a program with a syntax error produced bytecode") || failed;
+        }
+    }
+
+    {
+        // Taking the result never waits. Whatever state the compile is in, a later take finds nothing.
+        RefPtr<ConcurrentProgramCompilation> compilation = ConcurrentProgramCompilation::start(program);
+        if (compilation) {
+            compilation->takeCachedBytecode();
+            ConcurrentProgramCompilation::waitUntilAllCompilationsAreFinishedForTesting();
+            failed = check(!compilation->takeCachedBytecode(), "a compile abandoned by takeCachedBytecode() kept its result") || failed;
+        }
+    }
+
+    {
+        RefPtr<ConcurrentProgramCompilation> compilation = ConcurrentProgramCompilation::start(program);
+        if (compilation) {
+            compilation->cancel();
+            ConcurrentProgramCompilation::waitUntilAllCompilationsAreFinishedForTesting();
+            failed = check(!compilation->takeCachedBytecode(), "a cancelled compile kept its result") || failed;
+        }
+    }
+
+    Options::useConcurrentProgramCompilation() = savedUseConcurrentProgramCompilation;
+    Options::minimumConcurrentProgramCompilationLength() = savedMinimumLength;
+
+    printf("%s: concurrent program compilation.\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
@@ -37,6 +37,8 @@
 using namespace std::chrono;
 using JSC::Options;
 
+extern "C" void JSSynchronousGarbageCollectForDebugging(JSContextRef);
+
 static JSGlobalContextRef context = nullptr;
 
 static JSValueRef currentCPUTimeAsJSFunctionCallback(JSContextRef ctx, JSObjectRef functionObject, JSObjectRef thisObject, size_t argumentCount, const JSValueRef arguments[], JSValueRef* exception)
@@ -372,3 +374,97 @@ int testExecutionTimeLimit()
     
     return failed;
 }
+
+struct HeapLimitCallbackRecord {
+    unsigned calls { 0 };
+    JSHeapLimit lastLimit { kJSHeapLimitSoft };
+    size_t lastHeapSize { 0 };
+};
+
+static void heapLimitCallback(JSContextGroupRef, JSHeapLimit limit, size_t heapSize, void* context)
+{
+    HeapLimitCallbackRecord* record = static_cast<HeapLimitCallbackRecord*>(context);
+    record->calls++;
+    record->lastLimit = limit;
+    record->lastHeapSize = heapSize;
+}
+
+static void evaluateForHeapBudgetTest(JSGlobalContextRef context, const char* source, bool& failed)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    if (exception) {
+        printf("FAIL: Heap budget test script threw: %s\n", source);
+        failed = true;
+    }
+}
+
+int testHeapBudget()
+{
+    static const size_t softLimit = 1 * MB;
+    static const size_t hardLimit = 4 * MB;
+    // Comfortably more than the hard limit once collected.
+    static const char* retainScript = "var retained = []; for (var i = 0; i < 200000; ++i) retained.push({ index: i, name: 'object' + i });";
+
+    bool failed = false;
+
+    JSContextGroupRef contextGroup = JSContextGroupCreate();
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(contextGroup, nullptr);
+
+    HeapLimitCallbackRecord record;
+    JSContextGroupSetHeapBudget(contextGroup, softLimit, hardLimit, kJSHeapGrowthPolicyFootprint, heapLimitCallback, &record);
+
+    evaluateForHeapBudgetTest(context, "var small = [1, 2, 3];", failed);
+    JSSynchronousGarbageCollectForDebugging(context);
+    if (record.calls) {
+        printf("FAIL: Heap limit callback was called for a heap of %zu bytes, which is under the soft limit.\n", record.lastHeapSize);
+        failed = true;
+    }
+
+    evaluateForHeapBudgetTest(context, retainScript, failed);
+    JSSynchronousGarbageCollectForDebugging(context);
+    if (!record.calls) {
+        printf("FAIL: Heap limit callback was not called for a heap over the hard limit.\n");
+        failed = true;
+    } else if (record.lastLimit != kJSHeapLimitHard || record.lastHeapSize <= hardLimit) {
+        printf("FAIL: Heap limit callback reported the %s limit at %zu bytes, expected the hard limit.\n", record.lastLimit == kJSHeapLimitHard ? "hard" : "soft", record.lastHeapSize);
+        failed = true;
+    }
+
+    // With only a soft limit, the same heap is reported as over the soft limit.
+    record = HeapLimitCallbackRecord();
+    JSContextGroupSetHeapBudget(contextGroup, softLimit, 0, kJSHeapGrowthPolicyDefault, heapLimitCallback, &record);
+    JSSynchronousGarbageCollectForDebugging(context);
+    if (record.calls != 1 || record.lastLimit != kJSHeapLimitSoft || record.lastHeapSize <= softLimit) {
+        printf("FAIL: Heap limit callback was not called once for the soft limit.\n");
+        failed = true;
+    }
+
+    // Once the program lets go, the heap is back under budget and nobody is told.
+    record = HeapLimitCallbackRecord();
+    JSContextGroupSetHeapBudget(contextGroup, softLimit, hardLimit, kJSHeapGrowthPolicyDefault, heapLimitCallback, &record);
+    evaluateForHeapBudgetTest(context, "retained = null;", failed);
+    JSSynchronousGarbageCollectForDebugging(context);
+    if (record.calls) {
+        printf("FAIL: Heap limit callback was called after the heap shrank to %zu bytes.\n", record.lastHeapSize);
+        failed = true;
+    }
+
+    // Removing the callback keeps the limits but stops the calls.
+    JSContextGroupSetHeapBudget(contextGroup, softLimit, hardLimit, kJSHeapGrowthPolicyDefault, nullptr, nullptr);
+    evaluateForHeapBudgetTest(context, retainScript, failed);
+    JSSynchronousGarbageCollectForDebugging(context);
+    if (record.calls) {
+        printf("FAIL: Heap limit callback was called after it was removed.\n");
+        failed = true;
+    }
+
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(contextGroup);
+
+    if (!failed)
+        printf("PASS: Heap budget limits were reported.\n");
+    return failed;
+}
@@ -31,6 +31,7 @@ extern "C" {
 
 /* Returns 1 if failures were encountered.  Else, returns 0. */
 int testExecutionTimeLimit();
+int testHeapBudget();
 
 #ifdef __cplusplus
 } /* extern "C" */
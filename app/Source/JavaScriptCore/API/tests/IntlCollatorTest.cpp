@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "IntlCollatorTest.h"
+
+#include "Completion.h"
+#include "IntlCollator.h"
+#include "JSCInlines.h"
+#include "JSGlobalObject.h"
+#include "VM.h"
+#include <wtf/RefPtr.h>
+#include <wtf/text/StringBuilder.h>
+
+using namespace JSC;
+
+#if ENABLE(INTL)
+
+static int sign(double value)
+{
+    return (value > 0) - (value < 0);
+}
+
+static String asciiString(std::initializer_list<LChar> characters)
+{
+    return String(characters.begin(), characters.size());
+}
+
+// Collators for locales that sort ASCII like the root collation compare all-ASCII strings with a
+// table instead of ICU. Every pair of ASCII characters, on their own and followed by letters that
+// only differ in case, must compare the same way both ways.
+static bool testASCIIFastPath(ExecState* exec, const char* sensitivity)
+{
+    VM& vm = exec->vm();
+
+    StringBuilder program;
+    program.appendLiteral("new Intl.Collator('en', { sensitivity: '");
+    program.append(sensitivity);
+    program.appendLiteral("' })");
+    NakedPtr<Exception> exception;
+    JSValue value = evaluate(exec, makeSource(program.toString(), SourceOrigin()), JSValue(), exception);
+    IntlCollator* collator = exception ? nullptr : jsDynamicCast<IntlCollator*>(vm, value);
+    if (!collator) {
+        printf("FAIL: Could not create an Intl.Collator with sensitivity %s.\n", sensitivity);
+        return true;
+    }
+
+    // Initializes the collator, which decides whether the fast path applies.
+    collator->compareStrings(*exec, StringView(), StringView());
+    if (!collator->comparesASCIIStringsWithoutICU()) {
+        printf("FAIL: Intl.Collator('en') with sensitivity %s does not use the ASCII fast path.\n", sensitivity);
+        return true;
+    }
+
+    unsigned mismatches = 0;
+    auto compare = [&] (const String& x, const String& y) {
+        int fastResult = sign(collator->compareStrings(*exec, x, y).asNumber());
+        int icuResult = sign(collator->compareStringsWithICUForTesting(*exec, x, y).asNumber());
+        if (fastResult == icuResult)
+            return;
+        if (mismatches++ < 10) {
+            printf("FAIL: With sensitivity %s, comparing \"%s\" (%u) and \"%s\" (%u) gave %d but ICU gives %d.\n",
+                sensitivity, x.utf8().data(), x[0], y.utf8().data(), y[0], fastResult, icuResult);
+        }
+    };
+
+    for (LChar first = 0; first < 128; ++first) {
+        for (LChar second = 0; second < 128; ++second) {
+            compare(asciiString({ first }), asciiString({ second }));
+            compare(asciiString({ first, 'a' }), asciiString({ second, 'A' }));
+            compare(asciiString({ 'b', first }), asciiString({ 'B', second, 'b' }));
+        }
+    }
+    return mismatches;
+}
+
+int testIntlCollator()
+{
+    bool failed = false;
+
+    RefPtr<VM> vm = VM::create();
+
+    JSLockHolder locker(vm.get());
+    JSGlobalObject* globalObject = JSGlobalObject::create(*vm, JSGlobalObject::createStructure(*vm, jsNull()));
+    ExecState* exec = globalObject->globalExec();
+
+    for (const char* sensitivity : { "base", "accent", "case", "variant" })
+        failed = testASCIIFastPath(exec, sensitivity) || failed;
+
+    if (!failed)
+        printf("PASS: Intl.Collator's ASCII fast path matches ICU.\n");
+    return failed;
+}
+
+#else
+
+int testIntlCollator()
+{
+    return 0;
+}
+
+#endif // ENABLE(INTL)
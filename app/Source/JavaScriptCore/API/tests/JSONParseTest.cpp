@@ -34,6 +34,23 @@
 
 using namespace JSC;
 
+// Parsing reuses the structure transitions of the previous object in the same place, so these
+// check that what comes out is the same as it would be without that.
+static bool testJSONParseRoundTrip(ExecState* exec, const char* json, const char* expected)
+{
+    JSValue value = JSONParse(exec, json);
+    String result = value ? JSONStringify(exec, value, 0) : String();
+    if (result == expected)
+        return false;
+    printf("FAIL: JSONParse(%s) stringified to %s, expected %s.\n", json, result.utf8().data(), expected);
+    return true;
+}
+
+static JSObject* parsedArrayElement(ExecState* exec, JSValue array, unsigned index)
+{
+    return asObject(asObject(array)->getIndex(exec, index));
+}
+
 int testJSONParse()
 {
     bool failed = false;
@@ -58,6 +75,37 @@ int testJSONParse()
     failed = failed || (v3 != v4);
     failed = failed || (v4 == v5);
 
+    // Runs of objects with the same keys, including duplicate keys, which replace the earlier value
+    // in place.
+    failed = testJSONParseRoundTrip(exec, "[{\"a\":1,\"b\":2},{\"a\":3,\"b\":4}]", "[{\"a\":1,\"b\":2},{\"a\":3,\"b\":4}]") || failed;
+    failed = testJSONParseRoundTrip(exec, "[{\"a\":1,\"b\":2},{\"a\":3,\"a\":4,\"b\":5},{\"a\":6,\"b\":7}]", "[{\"a\":1,\"b\":2},{\"a\":4,\"b\":5},{\"a\":6,\"b\":7}]") || failed;
+    failed = testJSONParseRoundTrip(exec, "[{\"a\":1,\"b\":2,\"a\":3},{\"a\":4,\"b\":5,\"a\":6}]", "[{\"a\":3,\"b\":2},{\"a\":6,\"b\":5}]") || failed;
+
+    // __proto__ is an ordinary own property in JSON.
+    failed = testJSONParseRoundTrip(exec, "[{\"__proto__\":1,\"a\":2},{\"__proto__\":3,\"a\":4}]", "[{\"__proto__\":1,\"a\":2},{\"__proto__\":3,\"a\":4}]") || failed;
+    {
+        JSValue array = JSONParse(exec, "[{\"__proto__\":null},{\"__proto__\":null}]");
+        for (unsigned i = 0; i < 2; ++i) {
+            JSObject* object = parsedArrayElement(exec, array, i);
+            failed = failed || object->getPrototypeDirect() != JSValue(globalObject->objectPrototype());
+            failed = failed || !object->hasOwnProperty(exec, vm->propertyNames->underscoreProto);
+        }
+    }
+
+    // Index-like keys are stored as indexed properties, and come out first.
+    failed = testJSONParseRoundTrip(exec, "[{\"a\":1,\"0\":2,\"b\":3},{\"a\":4,\"0\":5,\"b\":6}]", "[{\"0\":2,\"a\":1,\"b\":3},{\"0\":5,\"a\":4,\"b\":6}]") || failed;
+    failed = testJSONParseRoundTrip(exec, "[{\"a\":1,\"b\":2},{\"a\":3,\"4294967295\":4,\"b\":5}]", "[{\"a\":1,\"b\":2},{\"a\":3,\"4294967295\":4,\"b\":5}]") || failed;
+
+    // Shapes that diverge midway, and come back.
+    failed = testJSONParseRoundTrip(exec, "[{\"a\":1,\"b\":2,\"c\":3},{\"a\":4,\"x\":5,\"c\":6},{\"a\":7,\"b\":8,\"c\":9},{\"a\":10}]", "[{\"a\":1,\"b\":2,\"c\":3},{\"a\":4,\"x\":5,\"c\":6},{\"a\":7,\"b\":8,\"c\":9},{\"a\":10}]") || failed;
+    failed = testJSONParseRoundTrip(exec, "[{\"o\":{\"a\":1,\"b\":2}},{\"o\":{\"b\":3,\"a\":4}},{\"p\":{\"a\":5,\"b\":6}}]", "[{\"o\":{\"a\":1,\"b\":2}},{\"o\":{\"b\":3,\"a\":4}},{\"p\":{\"a\":5,\"b\":6}}]") || failed;
+    {
+        JSValue array = JSONParse(exec, "[{\"a\":1,\"b\":2},{\"a\":3,\"x\":4},{\"a\":5,\"b\":6}]");
+        Structure* first = parsedArrayElement(exec, array, 0)->structure();
+        failed = failed || parsedArrayElement(exec, array, 1)->structure() == first;
+        failed = failed || parsedArrayElement(exec, array, 2)->structure() != first;
+    }
+
     vm = nullptr;
 
     if (failed)
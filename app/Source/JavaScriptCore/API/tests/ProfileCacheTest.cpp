@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ProfileCacheTest.h"
+
+#include "CodeBlock.h"
+#include "Completion.h"
+#include "JSCInlines.h"
+#include "JSGlobalObject.h"
+#include "ProfileCache.h"
+#include "VM.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <wtf/ProcessID.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+#include <wtf/text/StringConcatenate.h>
+
+using namespace JSC;
+
+static const unsigned maximumCalls = 1000;
+
+static const char* program =
+    "function hot(o, i) { return o.x + i * 2; }\n";
+
+// Same length, different code: profiles saved for one must not be seeded into the other.
+static const char* otherProgram =
+    "function hot(o, i) { return o.y - i * 3; }\n";
+
+static bool check(bool condition, const char* description)
+{
+    if (condition)
+        return false;
+    printf("FAIL: %s\n", description);
+    return true;
+}
+
+struct RunResult {
+    // How many calls it took for hot() to leave the LLInt, or 0 if it never did.
+    unsigned callsUntilJIT { 0 };
+    bool saved { false };
+};
+
+// Runs the program in a VM of its own, loading profiles from the cache file, and calls hot() until
+// it gets compiled by the baseline JIT.
+static RunResult run(const char* source, const CString& cachePath, bool save)
+{
+    RunResult result;
+    Options::profileCachePath() = cachePath.data();
+    RefPtr<VM> vm = VM::create();
+    {
+        JSLockHolder locker(vm.get());
+        JSGlobalObject* globalObject = JSGlobalObject::create(*vm, JSGlobalObject::createStructure(*vm, jsNull()));
+        ExecState* exec = globalObject->globalExec();
+        NakedPtr<Exception> exception;
+        evaluate(exec, makeSource(source, SourceOrigin()), JSValue(), exception);
+
+        JSValue function = globalObject->get(exec, Identifier::fromString(exec, "hot"));
+        CallData callData;
+        CallType callType = getCallData(function, callData);
+        if (!exception && callType != CallType::None) {
+            JSObject* argument = constructEmptyObject(exec);
+            argument->putDirect(*vm, Identifier::fromString(exec, "x"), jsNumber(1));
+            argument->putDirect(*vm, Identifier::fromString(exec, "y"), jsNumber(2));
+            FunctionExecutable* executable = jsCast<JSFunction*>(function)->jsExecutable();
+            for (unsigned i = 1; i <= maximumCalls; ++i) {
+                MarkedArgumentBuffer arguments;
+                arguments.append(argument);
+                arguments.append(jsNumber(i));
+                call(exec, function, callType, callData, jsUndefined(), arguments, exception);
+                if (exception)
+                    break;
+                CodeBlock* codeBlock = executable->codeBlockForCall();
+                if (codeBlock && codeBlock->jitType() != JITCode::InterpreterThunk) {
+                    result.callsUntilJIT = i;
+                    break;
+                }
+            }
+        }
+
+        if (save)
+            result.saved = vm->profileCache() && vm->profileCache()->save();
+    }
+    vm = nullptr;
+    Options::profileCachePath() = nullptr;
+    return result;
+}
+
+static Vector<uint8_t> readFile(const CString& path)
+{
+    Vector<uint8_t> data;
+    if (FILE* file = fopen(path.data(), "rb")) {
+        uint8_t buffer[4096];
+        while (size_t bytesRead = fread(buffer, 1, sizeof(buffer), file))
+            data.append(buffer, bytesRead);
+        fclose(file);
+    }
+    return data;
+}
+
+static void writeFile(const CString& path, const uint8_t* data, size_t size)
+{
+    if (FILE* file = fopen(path.data(), "wb")) {
+        fwrite(data, 1, size, file);
+        fclose(file);
+    }
+}
+
+static CString temporaryPath(const char* name)
+{
+#if OS(WINDOWS)
+    const char* directory = getenv("TEMP");
+#else
+    const char* directory = getenv("TMPDIR");
+#endif
+    if (!directory)
+        directory = "/tmp";
+    return makeString(directory, "/testapi-", name, '-', String::number(getCurrentProcessID())).utf8();
+}
+
+int testProfileCache()
+{
+    Options::initialize(); // Ensure options is initialized first.
+
+    if (!Options::useJIT()) {
+        printf("PASS: profile cache (skipped without the JIT).\n");
+        return 0;
+    }
+
+    // Keep baseline compiles on the main thread, so that hot() is compiled on the call that
+    // crosses its threshold.
+    bool oldUseConcurrentJIT = Options::useConcurrentJIT();
+    Options::useConcurrentJIT() = false;
+
+    bool failed = false;
+    CString cachePath = temporaryPath("profile-cache");
+    CString stalePath = temporaryPath("stale-profile-cache");
+    remove(cachePath.data());
+    remove(stalePath.data());
+
+    RunResult fresh = run(program, cachePath, true);
+    failed = check(fresh.callsUntilJIT, "hot() never left the LLInt") || failed;
+    failed = check(fresh.saved, "the profile cache was not saved") || failed;
+    Vector<uint8_t> cache = readFile(cachePath);
+    failed = check(!cache.isEmpty(), "the profile cache file is empty") || failed;
+
+    if (fresh.callsUntilJIT && !cache.isEmpty()) {
+        RunResult seeded = run(program, cachePath, false);
+        failed = check(seeded.callsUntilJIT && seeded.callsUntilJIT < fresh.callsUntilJIT, "hot() did not tier up sooner with its profiles seeded") || failed;
+
+        RunResult otherFresh = run(otherProgram, stalePath, false);
+        RunResult otherSeeded = run(otherProgram, cachePath, false);
+        failed = check(otherSeeded.callsUntilJIT == otherFresh.callsUntilJIT, "profiles were seeded into different source") || failed;
+
+        // Each of these is ignored, so hot() tiers up as if there were no cache.
+        auto checkIgnored = [&] (const Vector<uint8_t>& data, const char* description) {
+            writeFile(stalePath, data.data(), data.size());
+            failed = check(run(program, stalePath, false).callsUntilJIT == fresh.callsUntilJIT, description) || failed;
+        };
+
+        Vector<uint8_t> data;
+        checkIgnored(data, "an empty profile cache was not ignored");
+
+        // The header is the magic, version, opcode count, SpecFullTop and entry count.
+        const size_t versionOffset = sizeof(uint32_t);
+        const size_t headerSize = 3 * sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t);
+
+        data = cache;
+        data.shrink(headerSize - 1);
+        checkIgnored(data, "a profile cache with a truncated header was not ignored");
+
+        data = cache;
+        data.shrink(data.size() - 1);
+        checkIgnored(data, "a profile cache missing its last byte was not ignored");
+
+        data = cache;
+        data[versionOffset] ^= 1;
+        checkIgnored(data, "a profile cache from another version was not ignored");
+
+        data = cache;
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<uint8_t>(i * 31 + 7);
+        checkIgnored(data, "a profile cache full of garbage was not ignored");
+    }
+
+    remove(cachePath.data());
+    remove(stalePath.data());
+    Options::useConcurrentJIT() = oldUseConcurrentJIT;
+
+    printf("%s: profile cache.\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SamplingProfilerExportTest.h"
+
+#include "Completion.h"
+#include "JSCInlines.h"
+#include "JSGlobalObject.h"
+#include "SamplingProfiler.h"
+#include "VM.h"
+#include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Stopwatch.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringBuilder.h>
+
+#if ENABLE(SAMPLING_PROFILER)
+
+using namespace JSC;
+
+static const char* sampledFunctionName = "sampledFunctionForExport";
+static const char* url = "sampling-profiler-export.js";
+
+// Keeps sampledFunctionForExport on the stack for long enough to be sampled many times.
+static const char* program =
+    "function sampledFunctionForExport(n) {\n"
+    "    var result = 0;\n"
+    "    for (var i = 0; i < n; ++i)\n"
+    "        result += Math.sqrt(i) | 0;\n"
+    "    return result;\n"
+    "}\n"
+    "var start = Date.now();\n"
+    "while (Date.now() - start < 300)\n"
+    "    sampledFunctionForExport(10000);\n";
+
+static bool check(bool condition, const char* description)
+{
+    if (condition)
+        return false;
+    printf("FAIL: %s\n", description);
+    return true;
+}
+
+// Frames are named "function url:line [tier]".
+static bool isSampledFunctionFrame(const String& frame)
+{
+    StringBuilder prefix;
+    prefix.append(sampledFunctionName);
+    prefix.append(' ');
+    prefix.append(url);
+    prefix.append(':');
+    return frame.startsWith(prefix.toString()) && frame.contains(" [") && frame.endsWith("]");
+}
+
+// Each line is a stack of frames separated by semicolons, root first, then a space and a count.
+static bool checkCollapsedStacks(const String& collapsed)
+{
+    bool failed = false;
+    bool foundSampledFunction = false;
+    Vector<String> lines;
+    collapsed.split('\n', lines);
+    failed = check(!lines.isEmpty(), "collapsed stacks are empty") || failed;
+    HashSet<String> stacks;
+    for (const String& line : lines) {
+        size_t space = line.reverseFind(' ');
+        if (check(space != notFound && space, "a collapsed stack has no count")) {
+            failed = true;
+            continue;
+        }
+        bool ok;
+        unsigned count = line.substring(space + 1).toUIntStrict(&ok);
+        failed = check(ok && count, "a collapsed stack's count is not a positive number") || failed;
+
+        String stack = line.left(space);
+        failed = check(stacks.add(stack).isNewEntry, "a collapsed stack appears twice") || failed;
+        Vector<String> frames;
+        stack.split(';', true, frames);
+        for (const String& frame : frames) {
+            failed = check(!frame.isEmpty(), "a collapsed stack has an empty frame") || failed;
+            if (isSampledFunctionFrame(frame))
+                foundSampledFunction = true;
+        }
+    }
+    failed = check(foundSampledFunction, "no collapsed stack names the sampled function") || failed;
+    return failed;
+}
+
+namespace {
+
+// Reads the subset of the protobuf wire format that pprof profiles use: varints and
+// length-delimited fields.
+class ProtobufReader {
+public:
+    ProtobufReader(const uint8_t* data, size_t size)
+        : m_data(data)
+        , m_end(data + size)
+    {
+    }
+
+    bool atEnd() const { return m_data == m_end; }
+    bool failed() const { return m_failed; }
+
+    uint64_t readVarint()
+    {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (m_data == m_end)
+                break;
+            uint8_t byte = *m_data++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+        m_failed = true;
+        m_data = m_end;
+        return 0;
+    }
+
+    // Returns false at the end of the message, or if the next field has a wire type we do not use.
+    bool readField(unsigned& field, uint64_t& value, ProtobufReader& message)
+    {
+        if (atEnd() || m_failed)
+            return false;
+        uint64_t key = readVarint();
+        field = key >> 3;
+        switch (key & 7) {
+        case 0:
+            value = readVarint();
+            return !m_failed;
+        case 2: {
+            uint64_t size = readVarint();
+            if (m_failed || size > static_cast<uint64_t>(m_end - m_data))
+                break;
+            message = ProtobufReader(m_data, size);
+            m_data += size;
+            return true;
+        }
+        default:
+            break;
+        }
+        m_failed = true;
+        return false;
+    }
+
+    String readString() const { return String::fromUTF8(m_data, m_end - m_data); }
+
+    Vector<uint64_t> readPackedVarints()
+    {
+        Vector<uint64_t> values;
+        while (!atEnd() && !m_failed)
+            values.append(readVarint());
+        return values;
+    }
+
+private:
+    const uint8_t* m_data;
+    const uint8_t* m_end;
+    bool m_failed { false };
+};
+
+} // anonymous namespace
+
+// Checks the messages SamplingProfiler writes; the field numbers are from pprof's profile.proto.
+static bool checkPprof(const Vector<uint8_t>& profile)
+{
+    bool failed = false;
+    Vector<String> strings;
+    HashMap<uint64_t, uint64_t> functionNames;
+    HashMap<uint64_t, uint64_t> locationFunctions;
+    Vector<Vector<uint64_t>> sampleLocations;
+    Vector<Vector<uint64_t>> sampleValues;
+    unsigned sampleTypeCount = 0;
+    uint64_t period = 0;
+
+    ProtobufReader reader(profile.data(), profile.size());
+    unsigned field;
+    uint64_t value;
+    ProtobufReader message(nullptr, 0);
+    while (reader.readField(field, value, message)) {
+        switch (field) {
+        case 1: // sample_type
+            ++sampleTypeCount;
+            break;
+        case 2: { // sample
+            ProtobufReader packed(nullptr, 0);
+            Vector<uint64_t> locations;
+            Vector<uint64_t> values;
+            while (message.readField(field, value, packed)) {
+                if (field == 1)
+                    locations.appendVector(packed.readPackedVarints());
+                else if (field == 2)
+                    values.appendVector(packed.readPackedVarints());
+            }
+            failed = check(!message.failed() && !packed.failed(), "a pprof sample is malformed") || failed;
+            sampleLocations.append(WTFMove(locations));
+            sampleValues.append(WTFMove(values));
+            break;
+        }
+        case 4: { // location
+            ProtobufReader line(nullptr, 0);
+            uint64_t id = 0;
+            uint64_t functionID = 0;
+            while (message.readField(field, value, line)) {
+                if (field == 1)
+                    id = value;
+                else if (field == 4) {
+                    ProtobufReader unused(nullptr, 0);
+                    while (line.readField(field, value, unused)) {
+                        if (field == 1)
+                            functionID = value;
+                    }
+                }
+            }
+            failed = check(!message.failed() && id && functionID, "a pprof location is malformed") || failed;
+            failed = check(locationFunctions.add(id, functionID).isNewEntry, "two pprof locations have the same id") || failed;
+            break;
+        }
+        case 5: { // function
+            ProtobufReader unused(nullptr, 0);
+            uint64_t id = 0;
+            uint64_t name = 0;
+            while (message.readField(field, value, unused)) {
+                if (field == 1)
+                    id = value;
+                else if (field == 2)
+                    name = value;
+            }
+            failed = check(!message.failed() && id && name, "a pprof function is malformed") || failed;
+            failed = check(functionNames.add(id, name).isNewEntry, "two pprof functions have the same id") || failed;
+            break;
+        }
+        case 6: // string_table
+            strings.append(message.readString());
+            break;
+        case 12: // period
+            period = value;
+            break;
+        default:
+            break;
+        }
+    }
+    if (check(reader.atEnd() && !reader.failed(), "the pprof profile does not parse"))
+        return true;
+
+    failed = check(!strings.isEmpty() && strings[0].isEmpty(), "the pprof string table does not start with the empty string") || failed;
+    failed = check(sampleTypeCount == 2, "the pprof profile does not have two sample types") || failed;
+    failed = check(period, "the pprof profile has no period") || failed;
+    failed = check(!sampleLocations.isEmpty(), "the pprof profile has no samples") || failed;
+
+    bool foundSampledFunction = false;
+    for (size_t i = 0; i < sampleLocations.size(); ++i) {
+        failed = check(sampleValues[i].size() == sampleTypeCount, "a pprof sample does not have a value for each sample type") || failed;
+        failed = check(!sampleLocations[i].isEmpty(), "a pprof sample has no locations") || failed;
+        for (uint64_t location : sampleLocations[i]) {
+            auto functionID = locationFunctions.find(location);
+            if (check(functionID != locationFunctions.end(), "a pprof sample refers to a missing location")) {
+                failed = true;
+                continue;
+            }
+            auto name = functionNames.find(functionID->value);
+            if (check(name != functionNames.end(), "a pprof location refers to a missing function")) {
+                failed = true;
+                continue;
+            }
+            if (check(name->value < strings.size(), "a pprof function name is not in the string table")) {
+                failed = true;
+                continue;
+            }
+            if (isSampledFunctionFrame(strings[name->value]))
+                foundSampledFunction = true;
+        }
+    }
+    failed = check(foundSampledFunction, "no pprof sample names the sampled function") || failed;
+    return failed;
+}
+
+int testSamplingProfilerExport()
+{
+    Options::initialize(); // Ensure options is initialized first.
+
+    // Frames only carry their tier when the profile is collected for export.
+    const char* oldExportFormat = Options::samplingProfilerExportFormat();
+    Options::samplingProfilerExportFormat() = "pprof";
+
+    bool failed = false;
+    RefPtr<VM> vm = VM::create();
+    {
+        JSLockHolder locker(vm.get());
+        JSGlobalObject* globalObject = JSGlobalObject::create(*vm, JSGlobalObject::createStructure(*vm, jsNull()));
+        ExecState* exec = globalObject->globalExec();
+
+        SamplingProfiler& samplingProfiler = vm->ensureSamplingProfiler(Stopwatch::create());
+        samplingProfiler.noticeCurrentThreadAsJSCExecutionThread();
+        samplingProfiler.start();
+
+        // Each export consumes the samples taken so far, so each gets a run of its own.
+        auto runProgram = [&] {
+            NakedPtr<Exception> exception;
+            evaluate(exec, makeSource(program, SourceOrigin(), url), JSValue(), exception);
+            failed = check(!exception, "the sampled program threw") || failed;
+        };
+
+        runProgram();
+        failed = checkCollapsedStacks(samplingProfiler.stackTracesAsCollapsedStacks()) || failed;
+
+        runProgram();
+        failed = checkPprof(samplingProfiler.stackTracesAsPprof()) || failed;
+    }
+    vm = nullptr;
+
+    Options::samplingProfilerExportFormat() = oldExportFormat;
+
+    printf("%s: sampling profiler export.\n", failed ? "FAIL" : "PASS");
+    return failed;
+}
+
+#else
+
+int testSamplingProfilerExport()
+{
+    return 0;
+}
+
+#endif // ENABLE(SAMPLING_PROFILER)
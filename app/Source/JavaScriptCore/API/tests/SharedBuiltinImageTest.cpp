@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SharedBuiltinImageTest.h"
+
+#include "Completion.h"
+#include "JSCInlines.h"
+#include "JSGlobalObject.h"
+#include "SharedBuiltinImage.h"
+#include "VM.h"
+#include <wtf/RefPtr.h>
+
+using namespace JSC;
+
+// Calls builtins, some of them several levels deep, and returns a string that depends on all of
+// their results.
+static const char* builtinScript =
+    "var result = [3, 1, 2].map(x => x * 2).filter(x => x > 2).concat(Array.from(new Set([7, 7, 8])));"
+    "result.push([5, 4].includes(4), 'ab'.padStart(4, '-'), Object.entries({ a: 1 }).join());"
+    "result.join('|');";
+
+static const char* expectedResult = "6|4|7|8|true|--ab|a,1";
+
+static bool runBuiltinScript(const char* description)
+{
+    RefPtr<VM> vm = VM::create();
+    JSLockHolder locker(vm.get());
+    JSGlobalObject* globalObject = JSGlobalObject::create(*vm, JSGlobalObject::createStructure(*vm, jsNull()));
+    ExecState* exec = globalObject->globalExec();
+
+    NakedPtr<Exception> exception;
+    JSValue result = evaluate(exec, makeSource(builtinScript, SourceOrigin()), JSValue(), exception);
+    if (!exception && result.isString() && result.toWTFString(exec) == expectedResult)
+        return false;
+    printf("FAIL: %s did not compute %s.\n", description, expectedResult);
+    return true;
+}
+
+int testSharedBuiltinImage()
+{
+    Options::initialize(); // Ensure options is initialized first.
+
+    bool savedUseSharedBuiltinImage = Options::useSharedBuiltinImage();
+    Options::useSharedBuiltinImage() = true;
+
+    bool failed = false;
+    SharedBuiltinImage& image = SharedBuiltinImage::singleton();
+
+    // The first VM compiles the builtins and publishes them.
+    failed = runBuiltinScript("The VM that published the builtins") || failed;
+    if (!image.publishedEntryCount()) {
+        printf("FAIL: No builtins were published to the shared builtin image.\n");
+        failed = true;
+    }
+
+    // A second VM decodes them instead of compiling, and must get the same answers.
+    unsigned decodedAfterFirstVM = image.decodedExecutableCount();
+    failed = runBuiltinScript("A VM using shared builtins") || failed;
+    if (image.decodedExecutableCount() <= decodedAfterFirstVM) {
+        printf("FAIL: A second VM did not decode any builtins from the shared builtin image.\n");
+        failed = true;
+    }
+
+    // Turning the option off makes VMs compile builtins themselves again.
+    Options::useSharedBuiltinImage() = false;
+    unsigned decodedBeforeDisabledVM = image.decodedExecutableCount();
+    failed = runBuiltinScript("A VM with the shared builtin image off") || failed;
+    if (image.decodedExecutableCount() != decodedBeforeDisabledVM) {
+        printf("FAIL: A VM decoded shared builtins with useSharedBuiltinImage off.\n");
+        failed = true;
+    }
+
+    Options::useSharedBuiltinImage() = savedUseSharedBuiltinImage;
+
+    if (!failed)
+        printf("PASS: Builtins were shared between VMs.\n");
+    return failed;
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "StringKernelsTest.h"
+
+#include <wtf/ASCIICType.h>
+#include <wtf/StdLibExtras.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringCommon.h>
+#include <wtf/text/StringKernels.h>
+#include <wtf/text/WTFString.h>
+
+using namespace WTF;
+
+namespace {
+
+// Long enough for two full 8-bit blocks and a tail, so every kernel runs its vector loop, its
+// overlapping last block where it has one, and its scalar tail.
+const unsigned maximumLength = 33;
+// Misaligns the start of the characters by up to a whole vector.
+const unsigned maximumOffset = StringKernels::vectorSize;
+
+// Letters and the characters either side of each ASCII letter range, the edges of ASCII and
+// Latin-1, and, for UChar, characters whose high byte is set, including ones whose low byte is
+// ASCII. Characters with the top bit set catch signed lane comparisons.
+const LChar latin1Characters[] = { 'a', 'Z', 'A', 'z', '@', '[', '`', '{', '0', 0x7F, 0x80, 0xC0, 0xD7, 0xDF, 0xE0, 0xFF };
+const UChar wideCharacters[] = { 'a', 'Z', 'A', 'z', '@', '[', '`', '{', 0x7F, 0x80, 0xFF, 0x100, 0x141, 0x7F80, 0x8000, 0x8041, 0xFF21, 0xFF41, 0xFFFF };
+
+template<typename CharacterType> struct Alphabet;
+template<> struct Alphabet<LChar> {
+    static const LChar* characters() { return latin1Characters; }
+    static size_t size() { return WTF_ARRAY_LENGTH(latin1Characters); }
+};
+template<> struct Alphabet<UChar> {
+    static const UChar* characters() { return wideCharacters; }
+    static size_t size() { return WTF_ARRAY_LENGTH(wideCharacters); }
+};
+
+class Checker {
+public:
+    void check(bool condition, const char* kernel, unsigned length, unsigned offset, unsigned characterSize)
+    {
+        if (condition)
+            return;
+        if (m_failures++ < 20)
+            printf("FAIL: StringKernels::%s disagrees with the scalar loop (length %u, offset %u, %u-byte characters)\n", kernel, length, offset, characterSize);
+    }
+
+    bool failed() const { return m_failures; }
+
+private:
+    unsigned m_failures { 0 };
+};
+
+// Characters at data() + offset, with room for the largest offset, and a guard pattern after
+// length that a kernel must not look at.
+template<typename CharacterType>
+class Buffer {
+public:
+    Buffer(unsigned length, unsigned offset)
+        : m_length(length)
+        , m_offset(offset)
+    {
+        m_storage.fill(static_cast<CharacterType>('!'), maximumOffset + maximumLength + maximumOffset);
+    }
+
+    CharacterType* data() { return m_storage.data() + m_offset; }
+    CharacterType& operator[](unsigned index) { return data()[index]; }
+    unsigned length() const { return m_length; }
+
+    void fill(unsigned seed)
+    {
+        for (unsigned i = 0; i < m_length; ++i)
+            data()[i] = Alphabet<CharacterType>::characters()[(i * 7 + seed) % Alphabet<CharacterType>::size()];
+    }
+
+    void fillASCII(CharacterType character)
+    {
+        for (unsigned i = 0; i < m_length; ++i)
+            data()[i] = character;
+    }
+
+private:
+    Vector<CharacterType> m_storage;
+    unsigned m_length;
+    unsigned m_offset;
+};
+
+template<typename CharacterType>
+unsigned scalarFind(const CharacterType* characters, unsigned length, CharacterType matchCharacter, unsigned index)
+{
+    for (; index < length; ++index) {
+        if (characters[index] == matchCharacter)
+            return index;
+    }
+    return length;
+}
+
+template<typename CharacterType>
+bool scalarEqual(const CharacterType* a, const CharacterType* b, unsigned length)
+{
+    for (unsigned i = 0; i < length; ++i) {
+        if (a[i] != b[i])
+            return false;
+    }
+    return true;
+}
+
+template<typename CharacterType>
+bool scalarIsAllASCII(const CharacterType* characters, unsigned length)
+{
+    for (unsigned i = 0; i < length; ++i) {
+        if (!isASCII(characters[i]))
+            return false;
+    }
+    return true;
+}
+
+template<typename CharacterType>
+unsigned scalarFindASCIIUpperOrNonASCII(const CharacterType* characters, unsigned length)
+{
+    for (unsigned i = 0; i < length; ++i) {
+        if (!isASCII(characters[i]) || isASCIIUpper(characters[i]))
+            return i;
+    }
+    return length;
+}
+
+template<typename CharacterType>
+void testKernels(Checker& checker, unsigned length, unsigned offset)
+{
+    const unsigned size = sizeof(CharacterType);
+    const CharacterType* alphabet = Alphabet<CharacterType>::characters();
+    const size_t alphabetSize = Alphabet<CharacterType>::size();
+
+    Buffer<CharacterType> text(length, offset);
+    Buffer<CharacterType> other(length, maximumOffset - offset);
+
+    for (unsigned seed = 0; seed < alphabetSize; ++seed) {
+        text.fill(seed);
+
+        // find, for every character in the alphabet, from starts either side of a block boundary.
+        for (size_t i = 0; i < alphabetSize; ++i) {
+            for (unsigned start : { 0u, 1u, 7u, 8u, 15u, 16u, 17u }) {
+                if (start > length)
+                    continue;
+                unsigned expected = scalarFind(text.data(), length, alphabet[i], start);
+                checker.check(StringKernels::find(text.data(), length, alphabet[i], start) == expected, "find", length, offset, size);
+                checker.check(WTF::find(text.data(), length, alphabet[i], start) == (expected == length ? notFound : expected), "find (StringCommon)", length, offset, size);
+            }
+        }
+
+        // equal, with the copy differing in each position in turn, in the low or the high bits.
+        for (unsigned i = 0; i < length; ++i)
+            other[i] = text[i];
+        checker.check(StringKernels::equal(text.data(), other.data(), length), "equal", length, offset, size);
+        checker.check(WTF::equal(text.data(), other.data(), length), "equal (StringCommon)", length, offset, size);
+        for (unsigned i = 0; i < length; ++i) {
+            for (unsigned bit : { 0x01u, 0x80u, size == 2 ? 0x8000u : 0x40u }) {
+                other[i] = text[i] ^ bit;
+                checker.check(!StringKernels::equal(text.data(), other.data(), length), "equal", length, offset, size);
+                checker.check(!WTF::equal(text.data(), other.data(), length), "equal (StringCommon)", length, offset, size);
+                other[i] = text[i];
+            }
+        }
+
+        checker.check(StringKernels::isAllASCII(text.data(), length) == scalarIsAllASCII(text.data(), length), "isAllASCII", length, offset, size);
+        checker.check(StringKernels::findASCIIUpperOrNonASCII(text.data(), length) == scalarFindASCIIUpperOrNonASCII(text.data(), length), "findASCIIUpperOrNonASCII", length, offset, size);
+
+        StringKernels::convertASCIIToLowercase(other.data(), text.data(), length);
+        bool lowercased = true;
+        for (unsigned i = 0; i < length; ++i)
+            lowercased &= other[i] == toASCIILower(text[i]);
+        checker.check(lowercased && other[length] == '!', "convertASCIIToLowercase", length, offset, size);
+    }
+
+    // A single non-ASCII or uppercase character in each position of an all-ASCII string.
+    for (unsigned i = 0; i < length; ++i) {
+        for (size_t j = 0; j < alphabetSize; ++j) {
+            text.fillASCII('a');
+            text[i] = alphabet[j];
+            checker.check(StringKernels::isAllASCII(text.data(), length) == scalarIsAllASCII(text.data(), length), "isAllASCII", length, offset, size);
+            checker.check(StringKernels::findASCIIUpperOrNonASCII(text.data(), length) == scalarFindASCIIUpperOrNonASCII(text.data(), length), "findASCIIUpperOrNonASCII", length, offset, size);
+        }
+    }
+}
+
+void testWidenAndMixedEqual(Checker& checker, unsigned length, unsigned offset)
+{
+    Buffer<LChar> narrow(length, offset);
+    Buffer<UChar> wide(length, maximumOffset - offset);
+
+    for (unsigned seed = 0; seed < WTF_ARRAY_LENGTH(latin1Characters); ++seed) {
+        narrow.fill(seed);
+
+        StringKernels::widen(wide.data(), narrow.data(), length);
+        bool widened = true;
+        for (unsigned i = 0; i < length; ++i)
+            widened &= wide[i] == narrow[i];
+        checker.check(widened && wide[length] == '!', "widen", length, offset, 1);
+
+        String narrowString(narrow.data(), length);
+        String wideString(wide.data(), length);
+        checker.check(equal(narrow.data(), wide.data(), length) && equal(wide.data(), narrow.data(), length), "equal (8-bit with 16-bit)", length, offset, 1);
+        checker.check(narrowString == wideString, "String equality (8-bit with 16-bit)", length, offset, 1);
+
+        // Differ in the high byte only, so that comparing just the low bytes would match.
+        for (unsigned i = 0; i < length; ++i) {
+            for (UChar highBits : { 0x100, 0x8000 }) {
+                wide[i] = narrow[i] | highBits;
+                String changedWideString(wide.data(), length);
+                checker.check(!equal(narrow.data(), wide.data(), length) && !equal(wide.data(), narrow.data(), length), "equal (8-bit with 16-bit)", length, offset, 1);
+                checker.check(narrowString != changedWideString, "String equality (8-bit with 16-bit)", length, offset, 1);
+                wide[i] = narrow[i];
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+int testStringKernels()
+{
+    Checker checker;
+    for (unsigned length = 0; length <= maximumLength; ++length) {
+        for (unsigned offset = 0; offset < maximumOffset; ++offset) {
+            testKernels<LChar>(checker, length, offset);
+            testKernels<UChar>(checker, length, offset);
+            testWidenAndMixedEqual(checker, length, offset);
+        }
+    }
+
+    printf("%s: string kernels.\n", checker.failed() ? "FAIL" : "PASS");
+    return checker.failed();
+}
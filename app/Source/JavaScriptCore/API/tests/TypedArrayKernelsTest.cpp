@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "TypedArrayKernelsTest.h"
+
+#include "ArrayBuffer.h"
+#include "Completion.h"
+#include "ErrorInstance.h"
+#include "JSArrayBuffer.h"
+#include "JSCInlines.h"
+#include "JSGlobalObject.h"
+#include "VM.h"
+#include <wtf/RefPtr.h>
+
+using namespace JSC;
+
+// The typed array prototype functions convert their arguments before running a kernel over the
+// elements. A conversion that detaches the buffer must make them throw, not touch freed storage.
+// The C API cannot detach a buffer, so these run against the VM directly.
+
+static EncodedJSValue JSC_HOST_CALL detachArrayBuffer(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    JSArrayBuffer* buffer = jsDynamicCast<JSArrayBuffer*>(vm, exec->argument(0));
+    RELEASE_ASSERT(buffer);
+    ArrayBufferContents contents;
+    buffer->impl()->transferTo(vm, contents);
+    return JSValue::encode(jsUndefined());
+}
+
+static bool checkThrowsTypeError(ExecState* exec, const char* program)
+{
+    NakedPtr<Exception> exception;
+    evaluate(exec, makeSource(program, SourceOrigin()), JSValue(), exception);
+    if (exception) {
+        JSValue value = exception->value();
+        if (value.isObject() && asObject(value)->inherits(exec->vm(), ErrorInstance::info()) && value.toWTFString(exec).startsWith("TypeError"))
+            return false;
+    }
+    printf("FAIL: %s should throw a TypeError.\n", program);
+    exec->vm().clearException();
+    return true;
+}
+
+static bool checkTrue(ExecState* exec, const char* program)
+{
+    NakedPtr<Exception> exception;
+    JSValue result = evaluate(exec, makeSource(program, SourceOrigin()), JSValue(), exception);
+    if (!exception && result.isTrue())
+        return false;
+    printf("FAIL: %s should be true.\n", program);
+    exec->vm().clearException();
+    return true;
+}
+
+int testTypedArrayKernels()
+{
+    bool failed = false;
+
+    RefPtr<VM> vm = VM::create();
+
+    JSLockHolder locker(vm.get());
+    JSGlobalObject* globalObject = JSGlobalObject::create(*vm, JSGlobalObject::createStructure(*vm, jsNull()));
+    globalObject->putDirect(*vm, Identifier::fromString(vm.get(), "detach"), JSFunction::create(*vm, globalObject, 1, ASCIILiteral("detach"), detachArrayBuffer));
+    ExecState* exec = globalObject->globalExec();
+
+    failed = checkTrue(exec, "var detachingValue = (array) => ({ valueOf() { detach(array.buffer); return 1; } }); true") || failed;
+
+    failed = checkThrowsTypeError(exec, "var a = new Int32Array(64); a.fill(detachingValue(a))") || failed;
+    failed = checkThrowsTypeError(exec, "var a = new Float64Array(64); a.fill(1, detachingValue(a))") || failed;
+    failed = checkThrowsTypeError(exec, "var a = new Uint8Array(64); a.fill(1, 0, detachingValue(a))") || failed;
+    failed = checkThrowsTypeError(exec, "var a = new Int16Array(64); a.indexOf(0, detachingValue(a))") || failed;
+    failed = checkThrowsTypeError(exec, "var a = new Float32Array(64); a.lastIndexOf(0, detachingValue(a))") || failed;
+    failed = checkThrowsTypeError(exec, "var a = new Uint32Array(64); a.includes(0, detachingValue(a))") || failed;
+
+    // The value searched for is never converted, so it cannot detach anything.
+    failed = checkTrue(exec, "var a = new Int32Array(64); var v = detachingValue(a); a.indexOf(v) === -1 && a.lastIndexOf(v) === -1 && !a.includes(v) && a.length === 64") || failed;
+
+    // Already detached buffers throw before any conversion.
+    failed = checkThrowsTypeError(exec, "var a = new Int8Array(64); detach(a.buffer); a.fill(0)") || failed;
+    failed = checkThrowsTypeError(exec, "var a = new Int8Array(64); detach(a.buffer); a.indexOf(0)") || failed;
+    failed = checkThrowsTypeError(exec, "var a = new Int8Array(64); detach(a.buffer); a.lastIndexOf(0)") || failed;
+
+    if (!failed)
+        printf("PASS: Typed array kernels check for detached buffers.\n");
+    return failed;
+}
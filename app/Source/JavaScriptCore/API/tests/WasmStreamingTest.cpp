@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WasmStreamingTest.h"
+
+#include "JSCInlines.h"
+#include "VM.h"
+#include "WasmPlan.h"
+#include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
+
+#if ENABLE(WEBASSEMBLY)
+
+using namespace JSC;
+
+// (func (export "inc") (param i32) (result i32) (i32.add (get_local 0) (i32.const 1)))
+static const uint8_t incModule[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+    0x01, 0x06, 0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f, // Type
+    0x03, 0x02, 0x01, 0x00, // Function
+    0x07, 0x07, 0x01, 0x03, 0x69, 0x6e, 0x63, 0x00, 0x00, // Export
+    0x0a, 0x09, 0x01, 0x07, 0x00, 0x20, 0x00, 0x41, 0x01, 0x6a, 0x0b, // Code
+};
+
+// Declares two functions but only has a body for one.
+static const uint8_t missingBodyModule[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+    0x01, 0x06, 0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f, // Type
+    0x03, 0x03, 0x02, 0x00, 0x00, // Function
+    0x0a, 0x09, 0x01, 0x07, 0x00, 0x20, 0x00, 0x41, 0x01, 0x6a, 0x0b, // Code
+};
+
+// i32.add with only one operand.
+static const uint8_t invalidBodyModule[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+    0x01, 0x06, 0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f, // Type
+    0x03, 0x02, 0x01, 0x00, // Function
+    0x0a, 0x07, 0x01, 0x05, 0x00, 0x20, 0x00, 0x6a, 0x0b, // Code
+};
+
+static std::unique_ptr<Wasm::Plan> streamModule(VM& vm, const uint8_t* bytes, size_t length, size_t chunkSize)
+{
+    auto plan = std::make_unique<Wasm::Plan>(&vm);
+    for (size_t offset = 0; offset < length; offset += chunkSize) {
+        if (!plan->addBytes(bytes + offset, std::min(chunkSize, length - offset)))
+            break;
+    }
+    plan->finishStreaming();
+    return plan;
+}
+
+static bool check(bool condition, const char* description, size_t chunkSize)
+{
+    if (condition)
+        printf("PASS: %s, %zu byte chunks.\n", description, chunkSize);
+    else
+        printf("FAIL: %s, %zu byte chunks.\n", description, chunkSize);
+    return !condition;
+}
+
+int testWasmStreaming()
+{
+    bool failed = false;
+
+    RefPtr<VM> vm = VM::create();
+    {
+        JSLockHolder locker(vm.get());
+
+        const size_t chunkSizes[] = { 1, 3, 16, sizeof(incModule) };
+        for (size_t chunkSize : chunkSizes) {
+            auto plan = streamModule(*vm, incModule, sizeof(incModule), chunkSize);
+            failed |= check(!plan->failed(), "Streamed module compiles", chunkSize);
+            if (plan->failed())
+                continue;
+            failed |= check(plan->internalFunctionCount() == 1, "Streamed module has one function", chunkSize);
+            failed |= check(plan->exports().size() == 1 && plan->exports()[0].field.string() == "inc", "Streamed module exports inc", chunkSize);
+            failed |= check(plan->sourceLength() == sizeof(incModule) && !memcmp(plan->source(), incModule, sizeof(incModule)), "Streamed module keeps its source", chunkSize);
+        }
+
+        for (size_t chunkSize : chunkSizes) {
+            auto plan = streamModule(*vm, incModule, sizeof(incModule) - 1, chunkSize);
+            failed |= check(plan->failed(), "Truncated module fails", chunkSize);
+        }
+
+        for (size_t chunkSize : chunkSizes) {
+            auto plan = streamModule(*vm, missingBodyModule, sizeof(missingBodyModule), chunkSize);
+            failed |= check(plan->failed() && plan->errorMessage().contains("Code section count 1 doesn't match the declared number of functions 2"), "Module missing a function body fails", chunkSize);
+        }
+
+        for (size_t chunkSize : chunkSizes) {
+            auto plan = streamModule(*vm, invalidBodyModule, sizeof(invalidBodyModule), chunkSize);
+            failed |= check(plan->failed(), "Module with an invalid function body fails", chunkSize);
+        }
+    }
+    vm = nullptr;
+
+    return failed;
+}
+
+#else
+
+int testWasmStreaming()
+{
+    return 0;
+}
+
+#endif // ENABLE(WEBASSEMBLY)
@@ -39,14 +39,23 @@
 #include <windows.h>
 #endif
 
+#include "CachedBytecodeTest.h"
 #include "CompareAndSwapTest.h"
+#include "ConcurrentProgramCompilationTest.h"
 #include "CustomGlobalObjectClassTest.h"
 #include "ExecutionTimeLimitTest.h"
 #include "FunctionOverridesTest.h"
 #include "GlobalContextWithFinalizerTest.h"
+#include "IntlCollatorTest.h"
 #include "JSONParseTest.h"
 #include "PingPongStackOverflowTest.h"
+#include "ProfileCacheTest.h"
+#include "SamplingProfilerExportTest.h"
+#include "SharedBuiltinImageTest.h"
+#include "StringKernelsTest.h"
 #include "TypedArrayCTest.h"
+#include "TypedArrayKernelsTest.h"
+#include "WasmStreamingTest.h"
 
 #if JSC_OBJC_API_ENABLED
 void testObjectiveCAPI(void);
@@ -1837,6 +1846,19 @@ int main(int argc, char* argv[])
         }
         JSScriptRelease(scriptObject);
         free(scriptUTF8);
+
+        // The microtasks testapi.js queued ran when it returned, so their ordering can be checked now.
+        if (result) {
+            JSStringRef checkScript = JSStringCreateWithUTF8CString("checkAwaitOrdering()");
+            exception = NULL;
+            JSEvaluateScript(context, checkScript, NULL, NULL, 1, &exception);
+            JSStringRelease(checkScript);
+            if (exception) {
+                printf("FAIL: await and then() callbacks ran in an unexpected order.\n");
+                failed = 1;
+            } else
+                printf("PASS: await and then() callbacks ran in the expected order.\n");
+        }
     }
 
     // Check Promise is not exposed.
@@ -1885,10 +1907,20 @@ int main(int argc, char* argv[])
 
     failed = testTypedArrayCAPI() || failed;
     failed = testExecutionTimeLimit() || failed;
+    failed = testHeapBudget() || failed;
     failed = testFunctionOverrides() || failed;
     failed = testGlobalContextWithFinalizer() || failed;
     failed = testPingPongStackOverflow() || failed;
     failed = testJSONParse() || failed;
+    failed = testWasmStreaming() || failed;
+    failed = testConcurrentProgramCompilation() || failed;
+    failed = testTypedArrayKernels() || failed;
+    failed = testSharedBuiltinImage() || failed;
+    failed = testIntlCollator() || failed;
+    failed = testCachedBytecode() || failed;
+    failed = testSamplingProfilerExport() || failed;
+    failed = testProfileCache() || failed;
+    failed = testStringKernels() || failed;
 
     // Clear out local variables pointing at JSObjectRefs to allow their values to be collected
     function = NULL;
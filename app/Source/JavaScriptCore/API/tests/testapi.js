@@ -303,5 +303,384 @@ for (var i = 0; i < 6; ++i)
     var z = PropertyCatchalls.z;
 shouldBe("z", null);
 
+// Each iteration of a quantified capturing group saves a paren context; these
+// iterate far past what the JIT's initial paren context area holds.
+var longParenInput = "ab".repeat(5000);
+shouldBe("/(ab)*c/.exec(longParenInput + 'c')[0].length", 10001);
+shouldBe("/(ab)*c/.exec(longParenInput + 'c')[1]", "ab");
+shouldBe("/^(a|ab)*c$/.test(longParenInput + 'd')", false);
+shouldBe("/^(?:(a)(b))*$/.exec(longParenInput)[2]", "b");
+shouldBe("/^(a)\\1*(ab)+$/.exec('a' + longParenInput)[2]", "ab");
+shouldBe("/(ab)*?c/.exec(longParenInput + 'c').index", 0);
+
+// Back-references are matched by the JIT on 8-bit subjects, case-insensitively
+// too; Latin-1 letters fold within the Latin-1 range but \xd7/\xf7 and \xdf/\xff
+// do not.
+shouldBe("JSON.stringify(/(a)\\1/i.exec('aA'))", '["aA","a"]');
+shouldBe("JSON.stringify(/(abc)\\1/i.exec('xABCabc'))", '["ABCabc","ABC"]');
+shouldBe("/(a)\\1/.exec('aA')", null);
+shouldBe("/(\\xe0)\\1/i.exec('\\xe0\\xc0')[0]", "\xe0\xc0");
+shouldBe("/(\\xc0)\\1/i.exec('\\xc0\\xe0')[0]", "\xc0\xe0");
+shouldBe("/(\\xe0)\\1+/i.exec('\\xe0\\xc0\\xe0x')[0]", "\xe0\xc0\xe0");
+shouldBe("/(\\xdf)\\1/i.exec('\\xdf\\xff')", null);
+shouldBe("/(\\xff)\\1/i.exec('\\xff\\xdf')", null);
+shouldBe("/(\\xd7)\\1/i.exec('\\xd7\\xf7')", null);
+shouldBe("/(\\xf7)\\1/i.exec('\\xf7\\xd7')", null);
+shouldBe("/(@)\\1/i.exec('@`')", null);
+shouldBe("/(\\[)\\1/i.exec('[{')", null);
+shouldBe("JSON.stringify(/(a)\\1*/i.exec('aAaAb'))", '["aAaA","a"]');
+shouldBe("JSON.stringify(/(a)\\1/i.exec('\\u0100aA'))", '["aA","a"]');
+
+// A back-reference to a group that has not matched, or that comes later in the
+// pattern, matches the empty string.
+shouldBe("JSON.stringify(/(a)|\\1b/.exec('b'))", '["b",null]');
+shouldBe("JSON.stringify(/(a)?\\1b/.exec('b'))", '["b",null]');
+shouldBe("JSON.stringify(/\\1(a)/.exec('aa'))", '["a","a"]');
+shouldBe("JSON.stringify(/(?:(a)|b)\\1c/.exec('bc'))", '["bc",null]');
+
+// Quantified back-references backtrack one repetition at a time.
+shouldBe("JSON.stringify(/(a+)\\1+?/.exec('aaaaaaa'))", '["aaaaaa","aaa"]');
+shouldBe("JSON.stringify(/^(a+?)\\1+$/.exec('aaaaaa'))", '["aaaaaa","a"]');
+shouldBe("JSON.stringify(/^(a+)\\1*?b/.exec('aaaab'))", '["aaaab","aaaa"]');
+shouldBe("JSON.stringify(/(a)\\1{2,3}/.exec('aaaaa'))", '["aaaa","a"]');
+shouldBe("JSON.stringify(/(a)\\1{2,3}a/.exec('aaaaa'))", '["aaaaa","a"]');
+shouldBe("JSON.stringify(/(a)\\1{2,3}?a/.exec('aaaaa'))", '["aaaa","a"]');
+shouldBe("/(a)\\1{3}/.exec('aaa')", null);
+shouldBe("JSON.stringify(/(a)\\1{3}/.exec('aaaa'))", '["aaaa","a"]');
+shouldBe("JSON.stringify(/^(a+)\\1{3}$/.exec('aaaaaaaa'))", '["aaaaaaaa","aa"]');
+shouldBe("JSON.stringify(/(ab)\\1*x/.exec('abababx'))", '["abababx","ab"]');
+
+// Captures inside a quantified group are reset on each iteration, so a later
+// back-reference sees only what the last iteration captured.
+shouldBe("JSON.stringify(/(?:(a)|b)*\\1/.exec('aba'))", '["ab",null]');
+shouldBe("JSON.stringify(/(?:(a)|b)*\\1c/.exec('abc'))", '["abc",null]');
+shouldBe("/(?:(a)|(b))+\\1\\2/.exec('abab')", null);
+shouldBe("JSON.stringify(/((a)|b)+\\2/.exec('abb'))", '["abb","b",null]');
+shouldBe("JSON.stringify(/(?:(\\w)\\1)+/.exec('aabbcd'))", '["aabb","b"]');
+shouldBe("JSON.stringify(/(?:(\\w)\\1)+$/.exec('aabbcc'))", '["aabbcc","c"]');
+shouldBe("JSON.stringify(/(?:x(\\w)\\1){2}/.exec('xaaxbb'))", '["xaaxbb","b"]');
+shouldBe("/(?:x(\\w)\\1){2}/.exec('xaaxbc')", null);
+shouldBe("JSON.stringify(/(\\w)(?:\\1{2}|y)+/.exec('aaayaa'))", '["aaayaa","a"]');
+
+// Array.prototype.sort sorts Int32, Double and Contiguous arrays natively. These
+// are long enough to need merging runs, not just insertion sort.
+function isSortedStably(array, keyOf) {
+    for (var i = 1; i < array.length; ++i) {
+        var previous = keyOf(array[i - 1]), current = keyOf(array[i]);
+        if (previous > current || (previous == current && array[i - 1].index > array[i].index))
+            return false;
+    }
+    return true;
+}
+var stableSortInput = [];
+for (var i = 0; i < 2000; ++i)
+    stableSortInput.push({ key: (i * 7919) % 13, index: i });
+var stableSorted = stableSortInput.slice().sort(function (a, b) { return a.key - b.key; });
+shouldBe("isSortedStably(stableSorted, function (entry) { return entry.key; })", true);
+shouldBe("stableSorted.length", 2000);
+var stableStringSorted = stableSortInput.map(function (entry) { return { key: String(entry.key), index: entry.index, toString: function () { return this.key; } }; }).sort();
+shouldBe("isSortedStably(stableStringSorted, function (entry) { return entry.key; })", true);
+var stableDescending = [];
+for (var i = 0; i < 2000; ++i)
+    stableDescending.push({ key: 1000 - (i >> 1), index: i });
+shouldBe("isSortedStably(stableDescending.slice().sort(function (a, b) { return a.key - b.key; }), function (entry) { return entry.key; })", true);
+
+shouldBe("[10, 9, 1, -1, -10, 100, 0].sort()", "-1,-10,0,1,10,100,9");
+shouldBe("[2147483647, -2147483648, 0, 5].sort()", "-2147483648,0,2147483647,5");
+shouldBe("[0.5, -0.5, 10.25, 1e21, NaN, Infinity].sort()", "-0.5,0.5,10.25,1e+21,Infinity,NaN");
+shouldBe("[3, undefined, 1, , 2].sort().length", 5);
+shouldBe("String([3, undefined, 1, , 2].sort())", "1,2,3,,");
+shouldBe("3 in [3, undefined, 1, , 2].sort()", true);
+shouldBe("4 in [3, undefined, 1, , 2].sort()", false);
+shouldBe("[3, 1, 2].sort(function () { return NaN; })", "3,1,2");
+shouldBe("[3, 1, 2].sort(function () { return undefined; })", "3,1,2");
+shouldBe("[3, 1, 2].sort(function (a, b) { return { valueOf: function () { return a - b; } }; })", "1,2,3");
+
+// Inconsistent comparators give an unspecified order but must keep every element.
+var inconsistentSortInput = [];
+for (var i = 0; i < 1000; ++i)
+    inconsistentSortInput.push(i);
+var inconsistentSorted = inconsistentSortInput.slice().sort(function () { return Math.random() - 0.5; });
+shouldBe("inconsistentSorted.length", 1000);
+shouldBe("inconsistentSorted.slice().sort(function (a, b) { return a - b; })", inconsistentSortInput.join());
+var alwaysLessSorted = inconsistentSortInput.slice().sort(function () { return -1; });
+shouldBe("alwaysLessSorted.slice().sort(function (a, b) { return a - b; })", inconsistentSortInput.join());
+
+// A throwing comparator leaves the array as it was.
+var throwingSortInput = inconsistentSortInput.slice().reverse();
+var throwingSortCalls = 0;
+shouldThrow("throwingSortInput.sort(function (a, b) { if (++throwingSortCalls == 500) throw 'stop'; return a - b; })");
+shouldBe("throwingSortInput.join()", inconsistentSortInput.slice().reverse().join());
+
+// A comparator that changes the array must not crash the sort, whatever order results.
+var mutatedSortInput = inconsistentSortInput.slice().reverse();
+mutatedSortInput.sort(function (a, b) { mutatedSortInput.length = 10; mutatedSortInput[20] = 1.5; return a - b; });
+shouldBe("mutatedSortInput.length >= 10", true);
+var growingSortInput = [5, 4, 3, 2, 1, 0.5, 0.25];
+growingSortInput.sort(function (a, b) { growingSortInput.push({}); return a - b; });
+shouldBe("growingSortInput.length >= 7", true);
+
+// Typed array fill, indexOf, lastIndexOf and includes run vector kernels over
+// the elements. These are long enough to cover both the vector loop and the tail.
+var kernelTypes = [Int8Array, Uint8Array, Uint8ClampedArray, Int16Array, Uint16Array, Int32Array, Uint32Array, Float32Array, Float64Array];
+var kernelFailures = [];
+kernelTypes.forEach(function (TypedArray) {
+    var name = TypedArray.name;
+    var array = new TypedArray(37);
+    array.fill(-0);
+    for (var i = 0; i < array.length; ++i) {
+        if (array[i] !== 0)
+            kernelFailures.push(name + " fill(-0)");
+    }
+    if (array.indexOf(0) != 0 || array.indexOf(-0) != 0 || array.lastIndexOf(0) != 36 || array.lastIndexOf(-0) != 36)
+        kernelFailures.push(name + " searching for zeros");
+    if (array.indexOf(NaN) != -1 || array.lastIndexOf(NaN) != -1 || array.includes(NaN))
+        kernelFailures.push(name + " searching for NaN among zeros");
+
+    array.fill(NaN);
+    var isFloat = TypedArray === Float32Array || TypedArray === Float64Array;
+    if (isFloat != isNaN(array[36]))
+        kernelFailures.push(name + " fill(NaN)");
+    if (array.indexOf(NaN) != -1 || array.lastIndexOf(NaN) != -1)
+        kernelFailures.push(name + " indexOf(NaN)");
+    if (array.includes(NaN) != isFloat)
+        kernelFailures.push(name + " includes(NaN)");
+
+    array.fill(1);
+    array.fill(5, 3, 34);
+    if (array[2] != 1 || array[3] != 5 || array[33] != 5 || array[34] != 1)
+        kernelFailures.push(name + " fill(value, start, end)");
+    if (array.indexOf(5) != 3 || array.lastIndexOf(5) != 33 || array.indexOf(5, 34) != -1 || array.lastIndexOf(5, 2) != -1 || array.indexOf(1, -3) != 34)
+        kernelFailures.push(name + " indexOf with a start index");
+});
+shouldBe("kernelFailures.join()", "");
+
+var floatZeros = new Float64Array(33);
+floatZeros.fill(-0);
+shouldBe("1 / floatZeros[0]", -Infinity);
+shouldBe("1 / floatZeros[32]", -Infinity);
+floatZeros[20] = 0;
+shouldBe("1 / floatZeros[20]", Infinity);
+shouldBe("floatZeros.indexOf(0)", 0);
+shouldBe("floatZeros.lastIndexOf(-0)", 32);
+var float32Zeros = new Float32Array(33).fill(-0);
+shouldBe("1 / float32Zeros[17]", -Infinity);
+shouldBe("float32Zeros.indexOf(0)", 0);
+var floatWithNaN = new Float64Array(33);
+floatWithNaN[31] = NaN;
+shouldBe("floatWithNaN.includes(NaN)", true);
+shouldBe("floatWithNaN.indexOf(NaN)", -1);
+shouldBe("floatWithNaN.lastIndexOf(NaN)", -1);
+shouldBe("new Float32Array([1, 2, NaN]).includes(NaN)", true);
+shouldBe("new Float32Array([1, 2, 3]).includes(NaN)", false);
+shouldBe("new Int8Array([1, 2, 3]).indexOf(2.5)", -1);
+shouldBe("new Uint8Array([1, 2, 255]).indexOf(-1)", -1);
+shouldBe("new Int8Array([1, 2, -1]).indexOf(-1)", 2);
+shouldBe("new Uint8ClampedArray(4).fill(300)", "255,255,255,255");
+shouldBe("new Uint8ClampedArray(4).fill(-5)", "0,0,0,0");
+shouldBe("new Int8Array(4).fill(257)", "1,1,1,1");
+
+// await takes one job for native promises and primitives, like then(), and more for thenables and
+// subclassed promises. Microtasks only run once the script returns, so checkAwaitOrdering() is
+// called by testapi.c afterwards.
+var awaitOrderingLogs = {};
+function awaitOrderingLog(name) {
+    var log = awaitOrderingLogs[name] = [];
+    return function (entry) { log.push(entry); };
+}
+
+(function () {
+    var log = awaitOrderingLog("primitive");
+    async function f() { log("f start"); await 1; log("f resumed"); }
+    Promise.resolve().then(function () { log("then 1"); }).then(function () { log("then 2"); });
+    f();
+    log("sync end");
+})();
+
+(function () {
+    var log = awaitOrderingLog("resolved promise");
+    var promise = Promise.resolve(42);
+    async function f() { log("resumed with " + await promise); }
+    f();
+    promise.then(function () { log("then"); });
+})();
+
+(function () {
+    var log = awaitOrderingLog("rejected promise");
+    var promise = Promise.reject("no");
+    async function f() { try { await promise; } catch (e) { log("caught " + e); } }
+    f();
+    promise.catch(function (e) { log("catch " + e); });
+})();
+
+(function () {
+    var log = awaitOrderingLog("pending promise");
+    var resolve;
+    var promise = new Promise(function (r) { resolve = r; });
+    async function f() { log("first resumed with " + await promise); }
+    async function g() { log("second resumed with " + await promise); }
+    f();
+    promise.then(function (value) { log("then " + value); });
+    g();
+    resolve("x");
+})();
+
+(function () {
+    var log = awaitOrderingLog("thenable");
+    var thenable = { then: function (resolve) { log("then called"); resolve("t"); } };
+    async function f() { log("resumed with " + await thenable); }
+    f();
+    Promise.resolve().then(function () { log("tick 1"); }).then(function () { log("tick 2"); }).then(function () { log("tick 3"); });
+})();
+
+(function () {
+    var log = awaitOrderingLog("subclass");
+    class MyPromise extends Promise { }
+    var promise = MyPromise.resolve("s");
+    async function f() { log("resumed with " + await promise); }
+    f();
+    Promise.resolve().then(function () { log("tick 1"); }).then(function () { log("tick 2"); }).then(function () { log("tick 3"); });
+})();
+
+(function () {
+    var log = awaitOrderingLog("patched then");
+    var promise = Promise.resolve("p");
+    promise.then = function () { log("own then called"); return Promise.prototype.then.apply(this, arguments); };
+    async function f() { log("resumed with " + await promise); }
+    f();
+})();
+
+(function () {
+    var log = awaitOrderingLog("throwing constructor");
+    var promise = Promise.resolve("c");
+    Object.defineProperty(promise, "constructor", { get: function () { throw "constructor getter"; } });
+    async function f() { try { await promise; log("not thrown"); } catch (e) { log("caught " + e); } }
+    f();
+    log("sync end");
+})();
+
+function checkAwaitOrdering() {
+    shouldBe("awaitOrderingLogs['primitive'].join()", "f start,sync end,then 1,f resumed,then 2");
+    shouldBe("awaitOrderingLogs['resolved promise'].join()", "resumed with 42,then");
+    shouldBe("awaitOrderingLogs['rejected promise'].join()", "caught no,catch no");
+    shouldBe("awaitOrderingLogs['pending promise'].join()", "first resumed with x,then x,second resumed with x");
+    shouldBe("awaitOrderingLogs['thenable'].join()", "then called,tick 1,resumed with t,tick 2,tick 3");
+    shouldBe("awaitOrderingLogs['subclass'].join()", "tick 1,tick 2,resumed with s,tick 3");
+    shouldBe("awaitOrderingLogs['patched then'].join()", "resumed with p");
+    shouldBe("awaitOrderingLogs['throwing constructor'].join()", "caught constructor getter,sync end");
+    if (failed)
+        throw "Some await ordering tests failed";
+}
+
+// JSON.stringify caches the property names of each structure it sees. toJSON functions and
+// replacers can change objects under it, and later objects with the cached structure can
+// transition away from it.
+function stringifyDeletingLaterProperty() {
+    var o = { a: { toJSON: function() { delete o.c; return 1; } }, b: 2, c: 3 };
+    return JSON.stringify(o);
+}
+function stringifyAddingProperty() {
+    var o = { a: { toJSON: function() { o.d = 4; return 1; } }, b: 2 };
+    return JSON.stringify([o, o]);
+}
+function stringifyChangingLaterValue() {
+    var o = { a: { toJSON: function() { o.b = "changed"; return 1; } }, b: 2 };
+    return JSON.stringify(o);
+}
+function stringifyReconfiguringLaterProperty() {
+    var o = { a: { toJSON: function() { Object.defineProperty(o, "b", { get: function() { return "getter"; }, enumerable: true }); return 1; } }, b: 2, c: 3 };
+    return JSON.stringify(o);
+}
+function stringifyHidingLaterProperty() {
+    var o = { a: { toJSON: function() { Object.defineProperty(o, "b", { enumerable: false }); return 1; } }, b: 2 };
+    return JSON.stringify([o, o]);
+}
+function stringifyWithMutatingReplacer() {
+    var o = { a: 1, b: 2, c: 3 };
+    return JSON.stringify(o, function(key, value) {
+        if (key === "a") {
+            delete this.b;
+            this.c = "replaced";
+            this.d = "added";
+        }
+        return value;
+    });
+}
+function makeSharedStructureArray() {
+    var array = [];
+    for (var i = 0; i < 100; ++i)
+        array.push({ x: i, y: "y" + i });
+    return array;
+}
+function sharedStructureArrayString(length, overrides) {
+    var items = [];
+    for (var i = 0; i < length; ++i)
+        items.push(overrides[i] || '{"x":' + i + ',"y":"y' + i + '"}');
+    return "[" + items.join(",") + "]";
+}
+function stringifyArrayWithTransition() {
+    var array = makeSharedStructureArray();
+    array[50].z = "z";
+    delete array[60].x;
+    array[70].y = { nested: true };
+    return JSON.stringify(array);
+}
+function stringifyArrayTransitioningMidway() {
+    var array = makeSharedStructureArray();
+    array[10].x = { toJSON: function() { array[11].w = "w"; delete array[12].y; array[13].y = [1]; return 10; } };
+    return JSON.stringify(array);
+}
+function stringifyArrayBecomingDictionary() {
+    var array = makeSharedStructureArray().slice(0, 5);
+    for (var i = 0; i < 100; ++i)
+        array[3]["p" + i] = i;
+    for (var i = 0; i < 100; ++i)
+        delete array[3]["p" + i];
+    return JSON.stringify(array);
+}
+shouldBe("stringifyDeletingLaterProperty()", '{"a":1,"b":2}');
+shouldBe("stringifyAddingProperty()", '[{"a":1,"b":2},{"a":1,"b":2,"d":4}]');
+shouldBe("stringifyChangingLaterValue()", '{"a":1,"b":"changed"}');
+shouldBe("stringifyReconfiguringLaterProperty()", '{"a":1,"b":"getter","c":3}');
+shouldBe("stringifyHidingLaterProperty()", '[{"a":1,"b":2},{"a":1}]');
+shouldBe("stringifyWithMutatingReplacer()", '{"a":1,"c":"replaced"}');
+shouldBe("stringifyArrayWithTransition()", sharedStructureArrayString(100, { 50: '{"x":50,"y":"y50","z":"z"}', 60: '{"y":"y60"}', 70: '{"x":70,"y":{"nested":true}}' }));
+shouldBe("stringifyArrayTransitioningMidway()", sharedStructureArrayString(100, { 11: '{"x":11,"y":"y11","w":"w"}', 12: '{"x":12}', 13: '{"x":13,"y":[1]}' }));
+shouldBe("stringifyArrayBecomingDictionary()", sharedStructureArrayString(5, {}));
+
+// The cached property names include the separator, which depends on the gap.
+var gapTestValue = [{ a: 1, b: [2, { c: 3 }] }, { a: 4, b: [] }, {}];
+var gapTestString = '[{"a":1,"b":[2,{"c":3}]},{"a":4,"b":[]},{}]';
+var gapTestIndented = '[\n  {\n    "a": 1,\n    "b": [\n      2,\n      {\n        "c": 3\n      }\n    ]\n  },\n  {\n    "a": 4,\n    "b": []\n  },\n  {}\n]';
+shouldBe("JSON.stringify(gapTestValue)", gapTestString);
+shouldBe("JSON.stringify(gapTestValue, null, 2)", gapTestIndented);
+shouldBe("JSON.stringify(gapTestValue, null, 20)", JSON.stringify(gapTestValue, null, "          "));
+shouldBe("JSON.stringify(gapTestValue, null, '\\t')", gapTestIndented.replace(/  /g, "\t"));
+shouldBe("JSON.stringify(gapTestValue, null, '--')", gapTestIndented.replace(/  /g, "--"));
+shouldBe("JSON.stringify(gapTestValue, null, '')", gapTestString);
+shouldBe("JSON.stringify(gapTestValue, null, 2) + JSON.stringify(gapTestValue)", gapTestIndented + gapTestString);
+
+// Property names that need escaping are quoted once, when their structure is cached.
+var escapedNames = { "quote\"": 1, "back\\slash": 2, "new\nline": 3, "\u0001": 4, "\u001f\t": 5, "\u2028": 6, "caf\u00e9": 7, "/": 8 };
+var escapedNamesString = '{"quote\\"":1,"back\\\\slash":2,"new\\nline":3,"\\u0001":4,"\\u001f\\t":5,"\u2028":6,"caf\u00e9":7,"/":8}';
+shouldBe("JSON.stringify([escapedNames, escapedNames])", "[" + escapedNamesString + "," + escapedNamesString + "]");
+shouldBe("JSON.stringify(escapedNames, null, 1)", escapedNamesString.replace(/^{/, "{\n ").replace(/,"/g, ',\n "').replace(/":/g, '": ').replace(/}$/, "\n}"));
+shouldBe("JSON.parse(JSON.stringify(escapedNames))['new\\nline']", 3);
+
+// Number.prototype.toLocaleString with no arguments must not go through the public Intl.NumberFormat.
+if (typeof Intl !== "undefined") {
+    var defaultFormatted = new Intl.NumberFormat().format(1234.5);
+    var originalNumberFormat = Intl.NumberFormat;
+    var originalFormatGetter = Object.getOwnPropertyDescriptor(Intl.NumberFormat.prototype, "format");
+    Object.defineProperty(Intl.NumberFormat.prototype, "format", { get: function() { return function() { return "tampered"; }; }, configurable: true });
+    Intl.NumberFormat = function() { throw "tampered"; };
+    shouldBe("(1234.5).toLocaleString()", defaultFormatted);
+    shouldBe("(1234.5).toLocaleString(undefined, undefined)", defaultFormatted);
+    shouldBe("Number.prototype.toLocaleString.call(new Number(1234.5))", defaultFormatted);
+    Intl.NumberFormat = originalNumberFormat;
+    Object.defineProperty(Intl.NumberFormat.prototype, "format", originalFormatGetter);
+    shouldBe("(1234.5).toLocaleString()", new Intl.NumberFormat().format(1234.5));
+}
+
 if (failed)
     throw "Some tests failed";
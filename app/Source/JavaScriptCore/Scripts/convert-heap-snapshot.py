@@ -0,0 +1,204 @@
+#!/usr/bin/env python
+#
+# Copyright (C) 2017 Apple Inc. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+# THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+# BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+# THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script converts a heap snapshot written by HeapSnapshotStreamWriter (for example with
+# the jsc shell's writeHeapSnapshot()) to the JSON format of HeapSnapshotBuilder::json(), which
+# the Web Inspector can import. See heap/HeapSnapshotStreamWriter.h for the stream format.
+
+import json
+import mmap
+import optparse
+import sys
+
+MAGIC = b'JSCHEAPS'
+VERSION = 1
+
+STRING_TAG = 1
+NODE_TAG = 2
+EDGE_TAG = 3
+END_TAG = 4
+
+EDGE_TYPES = ['Internal', 'Property', 'Index', 'Variable']
+PROPERTY_EDGE = 1
+VARIABLE_EDGE = 3
+
+
+class StreamReader(object):
+    def __init__(self, data):
+        self.data = data
+        self.offset = 0
+
+    def at_end(self):
+        return self.offset >= len(self.data)
+
+    def read_bytes(self, length):
+        if self.offset + length > len(self.data):
+            raise ValueError('Heap snapshot is truncated')
+        result = self.data[self.offset:self.offset + length]
+        self.offset += length
+        return result
+
+    def read_number(self):
+        result = 0
+        shift = 0
+        while True:
+            if self.offset >= len(self.data):
+                raise ValueError('Heap snapshot is truncated')
+            byte = ord(self.data[self.offset:self.offset + 1])
+            self.offset += 1
+            result |= (byte & 0x7f) << shift
+            if not byte & 0x80:
+                return result
+            shift += 7
+
+
+def convert(data, output):
+    reader = StreamReader(data)
+    if reader.read_bytes(len(MAGIC)) != MAGIC:
+        raise ValueError('Not a streamed heap snapshot')
+    version = reader.read_number()
+    if version != VERSION:
+        raise ValueError('Unsupported heap snapshot version %d' % version)
+    reader.read_number()  # Flags only matter to the writer.
+
+    strings = {}
+
+    # Names are deduplicated by content, since the stream may repeat them.
+    class_names = ['<root>']
+    class_name_indexes = {}
+    edge_names = []
+    edge_name_indexes = {}
+
+    def class_name_index(string_index):
+        name = strings[string_index]
+        if name not in class_name_indexes:
+            class_name_indexes[name] = len(class_names)
+            class_names.append(name)
+        return class_name_indexes[name]
+
+    def edge_name_index(string_index):
+        name = strings[string_index]
+        if name not in edge_name_indexes:
+            edge_name_indexes[name] = len(edge_names)
+            edge_names.append(name)
+        return edge_name_indexes[name]
+
+    node_identifiers = {0: 0}
+    nodes = [0, 0, 0, 0]  # <root>
+    edges = []
+    saw_end = False
+
+    while not reader.at_end():
+        tag = reader.read_number()
+        if tag == STRING_TAG:
+            index = reader.read_number()
+            length = reader.read_number()
+            strings[index] = reader.read_bytes(length).decode('utf-8', 'replace')
+        elif tag == NODE_TAG:
+            cell = reader.read_number()
+            size = reader.read_number()
+            class_name = class_name_index(reader.read_number())
+            internal = reader.read_number()
+            identifier = len(node_identifiers)
+            node_identifiers[cell] = identifier
+            nodes.extend([identifier, size, class_name, internal])
+        elif tag == EDGE_TAG:
+            from_cell = reader.read_number()
+            to_cell = reader.read_number()
+            edge_type = reader.read_number()
+            extra_data = reader.read_number()
+            if edge_type == PROPERTY_EDGE or edge_type == VARIABLE_EDGE:
+                extra_data = edge_name_index(extra_data)
+            edges.append((from_cell, to_cell, edge_type, extra_data))
+        elif tag == END_TAG:
+            node_count = reader.read_number()
+            edge_count = reader.read_number()
+            if node_count != len(node_identifiers) - 1 or edge_count != len(edges):
+                raise ValueError('Heap snapshot has %d nodes and %d edges, but says it has %d and %d' % (len(node_identifiers) - 1, len(edges), node_count, edge_count))
+            saw_end = True
+            break
+        else:
+            raise ValueError('Unknown record tag %d at offset %d' % (tag, reader.offset - 1))
+
+    if not saw_end:
+        sys.stderr.write('Warning: heap snapshot is incomplete; converting what is there.\n')
+
+    # Edges come out of the collector before the nodes they point to, so their cells are only
+    # resolved now. Like json(), drop edges to cells that are not in the snapshot.
+    resolved_edges = []
+    for from_cell, to_cell, edge_type, extra_data in edges:
+        from_identifier = node_identifiers.get(from_cell)
+        to_identifier = node_identifiers.get(to_cell)
+        if from_identifier is None or to_identifier is None:
+            continue
+        resolved_edges.append((from_identifier, to_identifier, edge_type, extra_data))
+    edges = None
+    resolved_edges.sort(key=lambda edge: edge[0])
+
+    def write_numbers(numbers):
+        output.write(','.join(str(number) for number in numbers))
+
+    output.write('{"version":1,"nodes":[')
+    write_numbers(nodes)
+    output.write('],"nodeClassNames":')
+    output.write(json.dumps(class_names, separators=(',', ':')))
+    output.write(',"edges":[')
+    first = True
+    for edge in resolved_edges:
+        if not first:
+            output.write(',')
+        first = False
+        write_numbers(edge)
+    output.write('],"edgeTypes":')
+    output.write(json.dumps(EDGE_TYPES, separators=(',', ':')))
+    output.write(',"edgeNames":')
+    output.write(json.dumps(edge_names, separators=(',', ':')))
+    output.write('}')
+
+
+def main():
+    parser = optparse.OptionParser(usage='usage: %prog <streamed heap snapshot> [<output JSON file>]')
+    options, arguments = parser.parse_args()
+    if len(arguments) not in (1, 2):
+        parser.error('Expected an input file and an optional output file')
+
+    with open(arguments[0], 'rb') as input_file:
+        data = mmap.mmap(input_file.fileno(), 0, access=mmap.ACCESS_READ)
+        try:
+            if len(arguments) == 2:
+                with open(arguments[1], 'w') as output_file:
+                    convert(data, output_file)
+            else:
+                convert(data, sys.stdout)
+        except ValueError as error:
+            sys.stderr.write('Error: %s\n' % error)
+            return 1
+        finally:
+            data.close()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
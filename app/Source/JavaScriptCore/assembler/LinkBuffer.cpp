@@ -32,6 +32,7 @@
 #include "JITCode.h"
 #include "JSCInlines.h"
 #include "Options.h"
+#include "PerfLog.h"
 #include "VM.h"
 #include <wtf/CompilationThread.h>
 
@@ -57,19 +58,39 @@ LinkBuffer::CodeRef LinkBuffer::finalizeCodeWithoutDisassembly()
 
 LinkBuffer::CodeRef LinkBuffer::finalizeCodeWithDisassembly(const char* format, ...)
 {
-    CodeRef result = finalizeCodeWithoutDisassembly();
+    va_list argList;
+    va_start(argList, format);
+    CodeRef result = finalizeCodeWithDescriptionV(true, format, argList);
+    va_end(argList);
+    return result;
+}
 
-    if (m_alreadyDisassembled)
-        return result;
-    
-    StringPrintStream out;
-    out.printf("Generated JIT code for ");
+LinkBuffer::CodeRef LinkBuffer::finalizeCodeWithDescription(bool dumpDisassembly, const char* format, ...)
+{
     va_list argList;
     va_start(argList, format);
-    out.vprintf(format, argList);
+    CodeRef result = finalizeCodeWithDescriptionV(dumpDisassembly, format, argList);
     va_end(argList);
-    out.printf(":\n");
+    return result;
+}
+
+LinkBuffer::CodeRef LinkBuffer::finalizeCodeWithDescriptionV(bool dumpDisassembly, const char* format, va_list argList)
+{
+    CodeRef result = finalizeCodeWithoutDisassembly();
+
+    StringPrintStream description;
+    description.vprintf(format, argList);
 
+#if OS(LINUX)
+    if (Options::logJITCodeForPerf() || Options::logJITCodeForPerfMap())
+        PerfLog::log(description.toCString().data(), result.code().executableAddress(), result.size());
+#endif
+
+    if (!dumpDisassembly || m_alreadyDisassembled)
+        return result;
+    
+    StringPrintStream out;
+    out.print("Generated JIT code for ", description.toCString(), ":\n");
     out.printf("    Code at [%p, %p):\n", result.code().executableAddress(), static_cast<char*>(result.code().executableAddress()) + result.size());
     
     CString header = out.toCString();
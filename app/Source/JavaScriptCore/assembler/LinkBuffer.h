@@ -237,6 +237,8 @@ public:
     
     JS_EXPORT_PRIVATE CodeRef finalizeCodeWithoutDisassembly();
     JS_EXPORT_PRIVATE CodeRef finalizeCodeWithDisassembly(const char* format, ...) WTF_ATTRIBUTE_PRINTF(2, 3);
+    // Used by FINALIZE_CODE() when the code needs a name, either for disassembly or for perf.
+    JS_EXPORT_PRIVATE CodeRef finalizeCodeWithDescription(bool dumpDisassembly, const char* format, ...) WTF_ATTRIBUTE_PRINTF(3, 4);
 
     CodePtr trampolineAt(Label label)
     {
@@ -288,6 +290,7 @@ private:
 #endif
 
     void performFinalization();
+    CodeRef finalizeCodeWithDescriptionV(bool dumpDisassembly, const char* format, va_list) WTF_ATTRIBUTE_PRINTF(3, 0);
 
 #if DUMP_LINK_STATISTICS
     static void dumpLinkStatistics(void* code, size_t initialSize, size_t finalSize);
@@ -313,10 +316,17 @@ private:
     Vector<RefPtr<SharedTask<void(LinkBuffer&)>>> m_linkTasks;
 };
 
+#define FINALIZE_CODE_ARGUMENTS(...) __VA_ARGS__
+
+// The condition is evaluated exactly once, since callers pass expressions like
+// shouldDumpDisassemblyFor(codeBlock) that are not free.
 #define FINALIZE_CODE_IF(condition, linkBufferReference, dataLogFArgumentsForHeading)  \
-    (UNLIKELY((condition))                                              \
-     ? ((linkBufferReference).finalizeCodeWithDisassembly dataLogFArgumentsForHeading) \
-     : (linkBufferReference).finalizeCodeWithoutDisassembly())
+    ([&] () -> JSC::MacroAssemblerCodeRef { \
+        bool dumpDisassembly = (condition); \
+        if (UNLIKELY(dumpDisassembly || JSC::Options::logJITCodeForPerf() || JSC::Options::logJITCodeForPerfMap())) \
+            return (linkBufferReference).finalizeCodeWithDescription(dumpDisassembly, FINALIZE_CODE_ARGUMENTS dataLogFArgumentsForHeading); \
+        return (linkBufferReference).finalizeCodeWithoutDisassembly(); \
+    }())
 
 bool shouldDumpDisassemblyFor(CodeBlock*);
 
@@ -337,7 +347,8 @@ bool shouldDumpDisassemblyFor(CodeBlock*);
 // ... and so on.
 //
 // Note that the dataLogFArgumentsForHeading are only evaluated when dumpDisassembly
-// is true, so you can hide expensive disassembly-only computations inside there.
+// is true or the code is being logged for perf, so you can hide expensive
+// disassembly-only computations inside there.
 
 #define FINALIZE_CODE(linkBufferReference, dataLogFArgumentsForHeading)  \
     FINALIZE_CODE_IF(JSC::Options::asyncDisassembly() || JSC::Options::dumpDisassembly(), linkBufferReference, dataLogFArgumentsForHeading)
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "PerfLog.h"
+
+#if ENABLE(ASSEMBLER) && OS(LINUX)
+
+#include "Options.h"
+#include <elf.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <wtf/DataLog.h>
+#include <wtf/Locker.h>
+#include <wtf/PageBlock.h>
+#include <wtf/text/CString.h>
+#include <wtf/text/StringBuilder.h>
+
+namespace JSC {
+
+namespace JITDump {
+
+// See tools/perf/Documentation/jitdump-specification.txt in the Linux source tree.
+static const uint32_t magic = 0x4A695444;
+static const uint32_t version = 1;
+
+enum class RecordType : uint32_t {
+    CodeLoad = 0,
+};
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t totalSize;
+    uint32_t elfMachine;
+    uint32_t padding;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags;
+};
+
+struct RecordHeader {
+    RecordType type;
+    uint32_t totalSize;
+    uint64_t timestamp;
+};
+
+struct CodeLoadRecord {
+    RecordHeader header;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t vma;
+    uint64_t codeAddress;
+    uint64_t codeSize;
+    uint64_t codeIndex;
+};
+
+static uint32_t elfMachine()
+{
+#if CPU(X86_64)
+    return EM_X86_64;
+#elif CPU(X86)
+    return EM_386;
+#elif CPU(ARM64)
+    return EM_AARCH64;
+#elif CPU(ARM)
+    return EM_ARM;
+#elif CPU(MIPS)
+    return EM_MIPS;
+#else
+    return EM_NONE;
+#endif
+}
+
+// perf record -k 1 timestamps samples with CLOCK_MONOTONIC, and perf inject matches records
+// to samples by time.
+static uint64_t timestamp()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+} // namespace JITDump
+
+PerfLog& PerfLog::singleton()
+{
+    static std::once_flag onceFlag;
+    static PerfLog* perfLog;
+    std::call_once(onceFlag, [] {
+        perfLog = new PerfLog;
+    });
+    return *perfLog;
+}
+
+PerfLog::PerfLog()
+{
+    if (Options::logJITCodeForPerf())
+        openJITDump();
+    if (Options::logJITCodeForPerfMap())
+        openMap();
+}
+
+void PerfLog::openJITDump()
+{
+    const char* directory = Options::perfJITDumpDirectory();
+    if (!directory || !*directory)
+        directory = "/tmp";
+
+    StringBuilder path;
+    path.append(directory);
+    path.appendLiteral("/jit-");
+    path.appendNumber(getpid());
+    path.appendLiteral(".dump");
+    CString fileName = path.toString().utf8();
+
+    // The name is predictable, so refuse to reuse or follow anything already there.
+    int fd = open(fileName.data(), O_CREAT | O_EXCL | O_NOFOLLOW | O_RDWR | O_CLOEXEC, 0600);
+    if (fd == -1) {
+        dataLogLn("Could not open ", fileName, " for perf jitdump output");
+        return;
+    }
+
+    // perf finds the jitdump file through this mapping, which shows up as an MMAP event in the
+    // profile. It is never touched.
+    m_jitDumpMarker = mmap(nullptr, pageSize(), PROT_READ | PROT_EXEC, MAP_PRIVATE, fd, 0);
+    if (m_jitDumpMarker == MAP_FAILED) {
+        m_jitDumpMarker = nullptr;
+        close(fd);
+        dataLogLn("Could not map ", fileName, " for perf jitdump output");
+        return;
+    }
+
+    m_jitDumpFile = fdopen(fd, "wb");
+    if (!m_jitDumpFile) {
+        close(fd);
+        return;
+    }
+
+    JITDump::FileHeader header;
+    header.magic = JITDump::magic;
+    header.version = JITDump::version;
+    header.totalSize = sizeof(header);
+    header.elfMachine = JITDump::elfMachine();
+    header.padding = 0;
+    header.pid = getpid();
+    header.timestamp = JITDump::timestamp();
+    header.flags = 0;
+    fwrite(&header, sizeof(header), 1, m_jitDumpFile);
+    fflush(m_jitDumpFile);
+}
+
+void PerfLog::openMap()
+{
+    // perf only looks for the map in /tmp.
+    StringBuilder path;
+    path.appendLiteral("/tmp/perf-");
+    path.appendNumber(getpid());
+    path.appendLiteral(".map");
+    CString fileName = path.toString().utf8();
+
+    int fd = open(fileName.data(), O_CREAT | O_EXCL | O_NOFOLLOW | O_WRONLY | O_CLOEXEC, 0600);
+    if (fd == -1) {
+        dataLogLn("Could not open ", fileName, " for perf map output");
+        return;
+    }
+
+    m_mapFile = fdopen(fd, "w");
+    if (!m_mapFile)
+        close(fd);
+}
+
+void PerfLog::log(const char* name, const void* executableAddress, size_t size)
+{
+    PerfLog& perfLog = singleton();
+    auto locker = holdLock(perfLog.m_lock);
+
+    if (perfLog.m_jitDumpFile) {
+        size_t nameSize = strlen(name) + 1;
+
+        JITDump::CodeLoadRecord record;
+        record.header.type = JITDump::RecordType::CodeLoad;
+        record.header.totalSize = sizeof(record) + nameSize + size;
+        record.header.timestamp = JITDump::timestamp();
+        record.pid = getpid();
+        record.tid = syscall(__NR_gettid);
+        record.vma = bitwise_cast<uintptr_t>(executableAddress);
+        record.codeAddress = bitwise_cast<uintptr_t>(executableAddress);
+        record.codeSize = size;
+        record.codeIndex = perfLog.m_codeIndex++;
+
+        fwrite(&record, sizeof(record), 1, perfLog.m_jitDumpFile);
+        fwrite(name, nameSize, 1, perfLog.m_jitDumpFile);
+        fwrite(executableAddress, size, 1, perfLog.m_jitDumpFile);
+        fflush(perfLog.m_jitDumpFile);
+    }
+
+    if (perfLog.m_mapFile) {
+        fprintf(perfLog.m_mapFile, "%" PRIxPTR " %zx %s\n", bitwise_cast<uintptr_t>(executableAddress), size, name);
+        fflush(perfLog.m_mapFile);
+    }
+}
+
+} // namespace JSC
+
+#endif // ENABLE(ASSEMBLER) && OS(LINUX)
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if ENABLE(ASSEMBLER) && OS(LINUX)
+
+#include <stdio.h>
+#include <wtf/Lock.h>
+
+namespace JSC {
+
+// Tells perf about JIT compiled code. With Options::logJITCodeForPerf() every code region is
+// recorded in a jitdump file, which `perf inject --jit` turns into symbols (and annotatable code)
+// for a `perf record -k 1` profile. Options::logJITCodeForPerfMap() writes the simpler
+// /tmp/perf-<pid>.map that `perf report` reads directly, without the code bytes.
+class PerfLog {
+    WTF_MAKE_NONCOPYABLE(PerfLog);
+public:
+    // The name is whatever the code was finalized with, which for JS code includes the tier and
+    // the CodeBlock hash.
+    static void log(const char* name, const void* executableAddress, size_t);
+
+private:
+    PerfLog();
+
+    static PerfLog& singleton();
+
+    void openJITDump();
+    void openMap();
+
+    Lock m_lock;
+    FILE* m_jitDumpFile { nullptr };
+    void* m_jitDumpMarker { nullptr };
+    FILE* m_mapFile { nullptr };
+    uint64_t m_codeIndex { 0 };
+};
+
+} // namespace JSC
+
+#endif // ENABLE(ASSEMBLER) && OS(LINUX)
@@ -67,6 +67,8 @@ void generate(Procedure& procedure, CCallHelpers& jit)
 void generateToAir(Procedure& procedure, unsigned optLevel)
 {
     TimingScope timingScope("generateToAir");
+
+    procedure.setOptLevel(optLevel);
     
     if (shouldDumpIR(B3Mode) && !shouldDumpIRAtEachPhase(B3Mode)) {
         dataLog("Initial B3:\n");
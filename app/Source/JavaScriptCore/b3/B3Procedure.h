@@ -177,6 +177,11 @@ public:
     
     unsigned numEntrypoints() const { return m_numEntrypoints; }
     void setNumEntrypoints(unsigned numEntrypoints) { m_numEntrypoints = numEntrypoints; }
+
+    // The optimization level that prepareForGeneration() was asked for. Air uses it to decide how
+    // much time to spend on register allocation.
+    unsigned optLevel() const { return m_optLevel; }
+    void setOptLevel(unsigned optLevel) { m_optLevel = optLevel; }
     
     // Only call this after code generation is complete. Note that the label for the 0th entrypoint
     // should point to exactly where the code generation cursor was before you started generating
@@ -246,6 +251,7 @@ private:
     std::unique_ptr<Dominators> m_dominators;
     HashSet<ValueKey> m_fastConstants;
     unsigned m_numEntrypoints { 1 };
+    unsigned m_optLevel { 1 };
     const char* m_lastPhaseName;
     std::unique_ptr<OpaqueByproducts> m_byproducts;
     std::unique_ptr<Air::Code> m_code;
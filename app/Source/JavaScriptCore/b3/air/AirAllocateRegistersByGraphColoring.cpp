@@ -29,6 +29,7 @@
 #if ENABLE(B3_JIT)
 
 #include "AirCode.h"
+#include "AirFixSpillsAfterTerminals.h"
 #include "AirInsertionSet.h"
 #include "AirInstInlines.h"
 #include "AirLiveness.h"
@@ -1796,7 +1797,7 @@ public:
         m_numIterations = 0;
         allocateOnBank<FP>();
 
-        fixSpillsAfterTerminals();
+        fixSpillsAfterTerminals(m_code);
 
         if (reportStats)
             dataLog("Num iterations = ", m_numIterations, "\n");
@@ -2113,66 +2114,6 @@ private:
         }
     }
 
-    void fixSpillsAfterTerminals()
-    {
-        // Because there may be terminals that produce values, IRC may
-        // want to spill those terminals. It'll happen to spill it after
-        // the terminal. If we left the graph in this state, it'd be invalid
-        // because a terminal must be the last instruction in a block.
-        // We fix that here.
-
-        InsertionSet insertionSet(m_code);
-
-        bool addedBlocks = false;
-
-        for (BasicBlock* block : m_code) {
-            unsigned terminalIndex = block->size();
-            bool foundTerminal = false;
-            while (terminalIndex--) {
-                if (block->at(terminalIndex).isTerminal()) {
-                    foundTerminal = true;
-                    break;
-                }
-            }
-            ASSERT_UNUSED(foundTerminal, foundTerminal);
-
-            if (terminalIndex == block->size() - 1)
-                continue;
-
-            // There must be instructions after the terminal because it's not the last instruction.
-            ASSERT(terminalIndex < block->size() - 1);
-            Vector<Inst, 1> instsToMove;
-            for (unsigned i = terminalIndex + 1; i < block->size(); i++)
-                instsToMove.append(block->at(i));
-            RELEASE_ASSERT(instsToMove.size());
-
-            for (FrequentedBlock& frequentedSuccessor : block->successors()) {
-                BasicBlock* successor = frequentedSuccessor.block();
-                // If successor's only predecessor is block, we can plant the spill inside
-                // the successor. Otherwise, we must split the critical edge and create
-                // a new block for the spill.
-                if (successor->numPredecessors() == 1) {
-                    insertionSet.insertInsts(0, instsToMove);
-                    insertionSet.execute(successor);
-                } else {
-                    addedBlocks = true;
-                    // FIXME: We probably want better block ordering here.
-                    BasicBlock* newBlock = m_code.addBlock();
-                    for (const Inst& inst : instsToMove)
-                        newBlock->appendInst(inst);
-                    newBlock->appendInst(Inst(Jump, instsToMove.last().origin));
-                    newBlock->successors().append(successor);
-                    frequentedSuccessor.block() = newBlock;
-                }
-            }
-
-            block->resize(terminalIndex + 1);
-        }
-
-        if (addedBlocks)
-            m_code.resetReachability();
-    }
-
     Code& m_code;
     TmpWidth m_tmpWidth;
     UseCounts<Tmp>& m_useCounts;
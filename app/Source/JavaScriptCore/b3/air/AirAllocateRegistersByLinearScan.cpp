@@ -0,0 +1,405 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "AirAllocateRegistersByLinearScan.h"
+
+#if ENABLE(B3_JIT)
+
+#include "AirArgInlines.h"
+#include "AirCode.h"
+#include "AirFixSpillsAfterTerminals.h"
+#include "AirInsertionSet.h"
+#include "AirInstInlines.h"
+#include "AirLiveness.h"
+#include "AirPadInterference.h"
+#include "AirPhaseScope.h"
+#include "AirTmpInlines.h"
+#include <algorithm>
+#include <wtf/BitVector.h>
+
+namespace JSC { namespace B3 { namespace Air {
+
+namespace {
+
+bool verbose = false;
+bool reportStats = false;
+
+// Positions are the boundaries between instructions, since that is where Air's liveness says
+// that things happen: the early uses and early defs of an instruction are at the boundary before
+// it, and the late uses and late defs are at the boundary after it. Each block has a boundary at
+// its head and one after each of its instructions.
+struct Interval {
+    void add(unsigned position)
+    {
+        begin = std::min(begin, position);
+        end = std::max(end, position + 1);
+    }
+
+    bool isEmpty() const { return begin >= end; }
+
+    unsigned begin { std::numeric_limits<unsigned>::max() };
+    unsigned end { 0 };
+};
+
+struct TmpData {
+    Interval interval;
+    // A Tmp or register that this Tmp is moved to or from. Giving both the same register makes the
+    // move go away.
+    Tmp hint;
+    Reg assigned;
+};
+
+class LinearScanRegisterAllocation {
+public:
+    LinearScanRegisterAllocation(Code& code)
+        : m_code(code)
+    {
+        m_regPositions.resize(Reg::maxIndex() + 1);
+    }
+
+    void run()
+    {
+        padInterference(m_code);
+
+        allocateOnBank<GP>();
+        allocateOnBank<FP>();
+
+        fixSpillsAfterTerminals(m_code);
+
+        if (reportStats)
+            dataLog("Num iterations = ", m_numIterations, ", num spilled tmps = ", m_numSpilledTmps, "\n");
+    }
+
+private:
+    template<Bank bank>
+    void allocateOnBank()
+    {
+        m_unspillableTmps.clearAll();
+        while (true) {
+            ++m_numIterations;
+
+            if (verbose)
+                dataLog("Code at iteration ", m_numIterations, ":\n", m_code);
+
+            buildIntervals<bank>();
+            allocate<bank>();
+            if (m_spilledTmps.isEmpty()) {
+                assignRegisters<bank>();
+                return;
+            }
+            m_numSpilledTmps += m_spilledTmps.size();
+            addSpillAndFill<bank>();
+        }
+    }
+
+    template<Bank bank>
+    void buildIntervals()
+    {
+        m_tmpData.clear();
+        m_tmpData.resize(m_code.numTmps(bank));
+        for (Vector<unsigned>& positions : m_regPositions)
+            positions.shrink(0);
+
+        auto tmpData = [&] (Tmp tmp) -> TmpData& {
+            ASSERT(!tmp.isReg());
+            return m_tmpData[tmp.tmpIndex()];
+        };
+
+        TmpLiveness<bank> liveness(m_code);
+        unsigned headPosition = 0;
+        for (BasicBlock* block : m_code) {
+            typename TmpLiveness<bank>::LocalCalc localCalc(liveness, block);
+
+            auto addBoundary = [&] (unsigned boundary) {
+                unsigned position = headPosition + boundary;
+                auto add = [&] (Tmp tmp) {
+                    if (tmp.isReg())
+                        m_regPositions[tmp.reg().index()].append(position);
+                    else
+                        tmpData(tmp).interval.add(position);
+                };
+
+                for (Tmp tmp : localCalc.live())
+                    add(tmp);
+
+                // Defs interfere with everything live, even if nobody uses them.
+                Inst::forEachDefWithExtraClobberedRegs<Tmp>(
+                    block->get(boundary - 1), block->get(boundary),
+                    [&] (const Tmp& tmp, Arg::Role, Bank defBank, Width) {
+                        if (defBank == bank)
+                            add(tmp);
+                    });
+            };
+
+            for (unsigned instIndex = block->size(); instIndex--;) {
+                addBoundary(instIndex + 1);
+                localCalc.execute(instIndex);
+
+                Inst& inst = block->at(instIndex);
+                if (isCoalescableMove<bank>(inst)) {
+                    Tmp source = inst.args[0].tmp();
+                    Tmp destination = inst.args[1].tmp();
+                    if (!source.isReg())
+                        tmpData(source).hint = destination;
+                    if (!destination.isReg())
+                        tmpData(destination).hint = source;
+                } else if (std::optional<unsigned> defArgIndex = inst.shouldTryAliasingDef()) {
+                    // On x86, the two operand forms want the destination to be the first operand.
+                    Arg& source = inst.args[*defArgIndex - 2];
+                    Arg& destination = inst.args[*defArgIndex];
+                    if (source.isTmp() && destination.isTmp() && destination.bank() == bank && !destination.isReg())
+                        tmpData(destination.tmp()).hint = source.tmp();
+                }
+            }
+            addBoundary(0);
+
+            headPosition += block->size() + 1;
+        }
+
+        // Within a block, we visited the positions backwards.
+        for (Vector<unsigned>& positions : m_regPositions)
+            std::sort(positions.begin(), positions.end());
+    }
+
+    bool isUsedByRegister(Reg reg, const Interval& interval) const
+    {
+        const Vector<unsigned>& positions = m_regPositions[reg.index()];
+        auto iter = std::lower_bound(positions.begin(), positions.end(), interval.begin);
+        return iter != positions.end() && *iter < interval.end;
+    }
+
+    template<Bank bank>
+    void allocate()
+    {
+        m_spilledTmps.shrink(0);
+
+        Vector<unsigned> tmpsInOrder;
+        for (unsigned tmpIndex = 0; tmpIndex < m_tmpData.size(); ++tmpIndex) {
+            if (!m_tmpData[tmpIndex].interval.isEmpty())
+                tmpsInOrder.append(tmpIndex);
+        }
+        std::sort(
+            tmpsInOrder.begin(), tmpsInOrder.end(),
+            [&] (unsigned a, unsigned b) {
+                return m_tmpData[a].interval.begin < m_tmpData[b].interval.begin;
+            });
+
+        RegisterSet allocatableRegs;
+        for (Reg reg : m_code.regsInPriorityOrder(bank))
+            allocatableRegs.set(reg);
+
+        // The Tmps that currently hold a register.
+        Vector<unsigned> active;
+        RegisterSet activeRegs;
+
+        for (unsigned tmpIndex : tmpsInOrder) {
+            TmpData& data = m_tmpData[tmpIndex];
+            const Interval& interval = data.interval;
+
+            active.removeAllMatching(
+                [&] (unsigned activeIndex) {
+                    TmpData& activeData = m_tmpData[activeIndex];
+                    if (activeData.interval.end > interval.begin)
+                        return false;
+                    activeRegs.clear(activeData.assigned);
+                    return true;
+                });
+
+            auto isAvailable = [&] (Reg reg) {
+                return !activeRegs.get(reg) && !isUsedByRegister(reg, interval);
+            };
+
+            Reg chosenReg;
+            if (data.hint) {
+                Reg hintReg = data.hint.isReg() ? data.hint.reg() : m_tmpData[data.hint.tmpIndex()].assigned;
+                if (hintReg && allocatableRegs.get(hintReg) && isAvailable(hintReg))
+                    chosenReg = hintReg;
+            }
+            if (!chosenReg) {
+                for (Reg reg : m_code.regsInPriorityOrder(bank)) {
+                    if (isAvailable(reg)) {
+                        chosenReg = reg;
+                        break;
+                    }
+                }
+            }
+
+            if (!chosenReg) {
+                // Spill whichever of this Tmp and the active Tmps whose register it could take lives
+                // the longest. Tmps that were introduced to load or store a spilled Tmp cannot be
+                // spilled, since they only live across a single instruction.
+                bool isUnspillable = m_unspillableTmps.get(tmpIndex);
+                unsigned victimIndex = tmpIndex;
+                unsigned victimEnd = isUnspillable ? 0 : interval.end;
+                for (unsigned activeIndex : active) {
+                    TmpData& activeData = m_tmpData[activeIndex];
+                    if (m_unspillableTmps.get(activeIndex) || activeData.interval.end <= victimEnd)
+                        continue;
+                    if (isUsedByRegister(activeData.assigned, interval))
+                        continue;
+                    victimIndex = activeIndex;
+                    victimEnd = activeData.interval.end;
+                }
+
+                if (victimIndex == tmpIndex) {
+                    RELEASE_ASSERT_WITH_MESSAGE(!isUnspillable, "An unspillable Tmp could not be given a register");
+                    m_spilledTmps.append(tmpIndex);
+                    continue;
+                }
+
+                TmpData& victimData = m_tmpData[victimIndex];
+                chosenReg = victimData.assigned;
+                victimData.assigned = Reg();
+                active.removeFirst(victimIndex);
+                activeRegs.clear(chosenReg);
+                m_spilledTmps.append(victimIndex);
+            }
+
+            data.assigned = chosenReg;
+            active.append(tmpIndex);
+            activeRegs.set(chosenReg);
+        }
+
+        if (verbose)
+            dataLog("Spilled ", m_spilledTmps.size(), " tmps at iteration ", m_numIterations, "\n");
+    }
+
+    template<Bank bank>
+    static bool isCoalescableMove(const Inst& inst)
+    {
+        if (inst.kind.opcode != (bank == GP ? Move : MoveDouble))
+            return false;
+        return inst.args[0].isTmp() && inst.args[1].isTmp();
+    }
+
+    template<Bank bank>
+    void assignRegisters()
+    {
+        for (BasicBlock* block : m_code) {
+            for (Inst& inst : *block) {
+                inst.forEachTmpFast(
+                    [&] (Tmp& tmp) {
+                        if (tmp.isReg() || tmp.isGP() != (bank == GP))
+                            return;
+                        Reg reg = m_tmpData[tmp.tmpIndex()].assigned;
+                        ASSERT(reg);
+                        tmp = Tmp(reg);
+                    });
+
+                if (isCoalescableMove<bank>(inst) && inst.args[0].tmp() == inst.args[1].tmp())
+                    inst = Inst();
+            }
+
+            block->insts().removeAllMatching(
+                [&] (const Inst& inst) {
+                    return !inst;
+                });
+        }
+    }
+
+    template<Bank bank>
+    void addSpillAndFill()
+    {
+        // Every spill slot is as wide as a register, so we never have to worry about which bits of
+        // the Tmp are live.
+        Opcode move = bank == GP ? Move : MoveDouble;
+        Vector<StackSlot*> stackSlots(m_tmpData.size(), nullptr);
+        for (unsigned tmpIndex : m_spilledTmps) {
+            ASSERT(!m_unspillableTmps.get(tmpIndex));
+            stackSlots[tmpIndex] = m_code.addStackSlot(bytes(conservativeWidth(bank)), StackSlotKind::Spill);
+        }
+
+        auto stackSlotFor = [&] (Tmp tmp) -> StackSlot* {
+            if (tmp.isReg() || tmp.tmpIndex() >= stackSlots.size())
+                return nullptr;
+            return stackSlots[tmp.tmpIndex()];
+        };
+
+        InsertionSet insertionSet(m_code);
+        for (BasicBlock* block : m_code) {
+            for (unsigned instIndex = 0; instIndex < block->size(); ++instIndex) {
+                Inst& inst = block->at(instIndex);
+
+                // Try to replace the register use by memory use when possible. A def narrower than
+                // the slot would leave stale bits in the rest of it, so those go through a Tmp.
+                inst.forEachArg(
+                    [&] (Arg& arg, Arg::Role role, Bank argBank, Width width) {
+                        if (!arg.isTmp() || argBank != bank)
+                            return;
+                        StackSlot* stackSlot = stackSlotFor(arg.tmp());
+                        if (!stackSlot || !inst.admitsStack(arg))
+                            return;
+                        if (Arg::isAnyDef(role) && width < conservativeWidth(bank))
+                            return;
+                        arg = Arg::stack(stackSlot);
+                    });
+
+                // For every other case, add Load/Store as needed.
+                inst.forEachTmp(
+                    [&] (Tmp& tmp, Arg::Role role, Bank argBank, Width) {
+                        if (argBank != bank)
+                            return;
+                        StackSlot* stackSlot = stackSlotFor(tmp);
+                        if (!stackSlot)
+                            return;
+
+                        tmp = m_code.newTmp(bank);
+                        m_unspillableTmps.set(tmp.tmpIndex());
+
+                        Arg arg = Arg::stack(stackSlot);
+                        if (Arg::isAnyUse(role) && role != Arg::Scratch)
+                            insertionSet.insert(instIndex, move, inst.origin, arg, tmp);
+                        if (Arg::isAnyDef(role))
+                            insertionSet.insert(instIndex + 1, move, inst.origin, tmp, arg);
+                    });
+            }
+            insertionSet.execute(block);
+        }
+    }
+
+    Code& m_code;
+    Vector<TmpData> m_tmpData;
+    // For each register, the sorted positions at which it is live or defined.
+    Vector<Vector<unsigned>> m_regPositions;
+    Vector<unsigned> m_spilledTmps;
+    BitVector m_unspillableTmps;
+    unsigned m_numIterations { 0 };
+    unsigned m_numSpilledTmps { 0 };
+};
+
+} // anonymous namespace
+
+void allocateRegistersByLinearScan(Code& code)
+{
+    PhaseScope phaseScope(code, "Air::allocateRegistersByLinearScan");
+
+    LinearScanRegisterAllocation linearScanRegisterAllocation(code);
+    linearScanRegisterAllocation.run();
+}
+
+} } } // namespace JSC::B3::Air
+
+#endif // ENABLE(B3_JIT)
@@ -29,6 +29,7 @@
 #if ENABLE(B3_JIT)
 
 #include "AirAllocateRegistersByGraphColoring.h"
+#include "AirAllocateRegistersByLinearScan.h"
 #include "AirAllocateStack.h"
 #include "AirCode.h"
 #include "AirDumpAsJS.h"
@@ -86,8 +87,16 @@ void prepareForGeneration(Code& code)
     // After this phase, every Tmp has a reg.
     //
     // For debugging, you can use spillEverything() to put everything to the stack between each Inst.
+    //
+    // Graph coloring produces the best code, but its cost grows much faster than the size of the
+    // code. Linear scan is used when we were asked not to optimize, and for code so big that graph
+    // coloring would dominate the compile.
     if (Options::airSpillsEverything())
         spillEverything(code);
+    else if (Options::airForceLinearScanAllocator()
+        || (!Options::airForceGraphColoringAllocator()
+            && (!code.proc().optLevel() || code.numTmps(GP) + code.numTmps(FP) > Options::maximumTmpsForGraphColoring())))
+        allocateRegistersByLinearScan(code);
     else
         allocateRegistersByGraphColoring(code);
 
@@ -1640,6 +1640,46 @@ void testShuffleShiftDouble()
     CHECK(things[3] == 3);
 }
 
+// Keeps numTmps Tmps live at once, so that most of them have to be spilled.
+void testManyLiveTmps(unsigned numTmps)
+{
+    B3::Procedure proc;
+    Code& code = proc.code();
+
+    BasicBlock* root = code.addBlock();
+    Vector<Tmp> tmps;
+    for (unsigned i = 0; i < numTmps; ++i) {
+        Tmp tmp = code.newTmp(GP);
+        root->append(Move, nullptr, Arg::imm(i + 1), tmp);
+        tmps.append(tmp);
+    }
+    Tmp sum = code.newTmp(GP);
+    root->append(Move, nullptr, Arg::imm(0), sum);
+    for (Tmp tmp : tmps)
+        root->append(Add32, nullptr, tmp, sum);
+    root->append(Move, nullptr, sum, Tmp(GPRInfo::returnValueGPR));
+    root->append(Ret32, nullptr, Tmp(GPRInfo::returnValueGPR));
+
+    CHECK(compileAndRun<int>(proc) == static_cast<int>(numTmps * (numTmps + 1) / 2));
+}
+
+// Code with more Tmps than maximumTmpsForGraphColoring is allocated by linear scan; code with
+// fewer is allocated by graph coloring. Other tests may run while the option is changed, but they
+// only change which allocator they get.
+void testManyLiveTmpsAroundGraphColoringLimit()
+{
+    unsigned numTmps = 200;
+    unsigned originalMaximum = Options::maximumTmpsForGraphColoring();
+
+    Options::maximumTmpsForGraphColoring() = numTmps / 2;
+    testManyLiveTmps(numTmps);
+
+    Options::maximumTmpsForGraphColoring() = numTmps * 2;
+    testManyLiveTmps(numTmps);
+
+    Options::maximumTmpsForGraphColoring() = originalMaximum;
+}
+
 #if CPU(X86) || CPU(X86_64)
 void testX86VMULSD()
 {
@@ -1858,6 +1898,10 @@ void run(const char* filter)
     };
 
     RUN(testSimple());
+
+    RUN(testManyLiveTmps(10));
+    RUN(testManyLiveTmps(1000));
+    RUN(testManyLiveTmpsAroundGraphColoringLimit());
     
     RUN(testShuffleSimpleSwap());
     RUN(testShuffleSimpleShift());
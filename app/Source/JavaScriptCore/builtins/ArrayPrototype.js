@@ -637,6 +637,10 @@ function sort(comparator)
     if (length < 2)
         return array;
 
+    // Arrays with Int32, Double or Contiguous storage are sorted natively.
+    if (@sortFast(array, comparator))
+        return array;
+
     if (typeof comparator == "function")
         comparatorSort(array, length, comparator);
     else if (comparator === @undefined)
@@ -47,12 +47,39 @@ function asyncFunctionResume(generator, promiseCapability, sentValue, resumeMode
         return promiseCapability.@promise;
     }
 
-    let wrappedValue = @newPromiseCapability(@Promise);
-    wrappedValue.@resolve.@call(@undefined, value);
+    // Awaiting a primitive or a promise made by our own Promise constructor does not need a
+    // promise to wrap the value, nor resolving functions or a reaction with closures to get back
+    // here. We resume the generator from a native job once the value is settled. Like the
+    // specification's PromiseResolve, this looks at the promise's constructor rather than its
+    // then method, so awaiting a settled native promise takes one job instead of three.
+    if (!@isObject(value)) {
+        @enqueueAsyncFunctionResume(generator, promiseCapability, value, @GeneratorResumeModeNormal);
+        return promiseCapability.@promise;
+    }
+
+    let promise = @undefined;
+    if (@isPromise(value)) {
+        let constructor;
+        try {
+            constructor = value.constructor;
+        } catch (error) {
+            return @asyncFunctionResume(generator, promiseCapability, error, @GeneratorResumeModeThrow);
+        }
+        if (constructor === @Promise)
+            promise = value;
+    }
+
+    if (promise === @undefined) {
+        let wrappedValue = @newPromiseCapability(@Promise);
+        wrappedValue.@resolve.@call(@undefined, value);
+        promise = wrappedValue.@promise;
+    }
 
-    wrappedValue.@promise.@then(
-        function(value) { @asyncFunctionResume(generator, promiseCapability, value, @GeneratorResumeModeNormal); },
-        function(error) { @asyncFunctionResume(generator, promiseCapability, error, @GeneratorResumeModeThrow); });
+    let promiseState = promise.@promiseState;
+    if (promiseState === @promiseStatePending)
+        @putByValDirect(promise.@promiseReactions, promise.@promiseReactions.length, @newAwaitReaction(generator, promiseCapability));
+    else
+        @enqueueAsyncFunctionResume(generator, promiseCapability, promise.@promiseResult, promiseState === @promiseStateFulfilled ? @GeneratorResumeModeNormal : @GeneratorResumeModeThrow);
 
     return promiseCapability.@promise;
 }
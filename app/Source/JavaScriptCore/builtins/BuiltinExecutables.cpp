@@ -30,6 +30,7 @@
 #include "BuiltinNames.h"
 #include "JSCInlines.h"
 #include "Parser.h"
+#include "SharedBuiltinImage.h"
 #include <wtf/NeverDestroyed.h>
 
 namespace JSC {
@@ -71,9 +72,18 @@ UnlinkedFunctionExecutable* createBuiltinExecutable(VM& vm, const SourceCode& co
 
 UnlinkedFunctionExecutable* BuiltinExecutables::createExecutable(VM& vm, const SourceCode& source, const Identifier& name, ConstructorKind constructorKind, ConstructAbility constructAbility)
 {
+    bool isParsingDefaultConstructor = constructorKind != ConstructorKind::None;
+    if (!isParsingDefaultConstructor) {
+        if (UnlinkedFunctionExecutable* executable = SharedBuiltinImage::singleton().decode(vm, source)) {
+            if (executable->name() == name && executable->constructAbility() == constructAbility) {
+                executable->setIsSharedBuiltinImageRoot();
+                return executable;
+            }
+        }
+    }
+
     JSTextPosition positionBeforeLastNewline;
     ParserError error;
-    bool isParsingDefaultConstructor = constructorKind != ConstructorKind::None;
     JSParserBuiltinMode builtinMode = isParsingDefaultConstructor ? JSParserBuiltinMode::NotBuiltin : JSParserBuiltinMode::Builtin;
     UnlinkedFunctionKind kind = isParsingDefaultConstructor ? UnlinkedNormalFunction : UnlinkedBuiltinFunction;
     SourceCode parentSourceOverride = isParsingDefaultConstructor ? source : SourceCode();
@@ -106,6 +116,10 @@ UnlinkedFunctionExecutable* BuiltinExecutables::createExecutable(VM& vm, const S
     metadata->overrideName(name);
     VariableEnvironment dummyTDZVariables;
     UnlinkedFunctionExecutable* functionExecutable = UnlinkedFunctionExecutable::create(&vm, source, metadata, kind, constructAbility, JSParserScriptMode::Classic, dummyTDZVariables, DerivedContextType::None, WTFMove(parentSourceOverride));
+    if (!isParsingDefaultConstructor) {
+        functionExecutable->setIsSharedBuiltinImageRoot();
+        SharedBuiltinImage::singleton().publish(vm, source, functionExecutable, DebuggerOff);
+    }
     return functionExecutable;
 }
 
@@ -83,6 +83,7 @@ namespace JSC {
     macro(getTemplateObject) \
     macro(templateRegistryKey) \
     macro(enqueueJob) \
+    macro(enqueueAsyncFunctionResume) \
     macro(promiseState) \
     macro(promiseReactions) \
     macro(promiseResult) \
@@ -117,6 +118,7 @@ namespace JSC {
     macro(Collator) \
     macro(DateTimeFormat) \
     macro(NumberFormat) \
+    macro(formatWithDefaultNumberFormat) \
     macro(intlSubstituteValue) \
     macro(thisTimeValue) \
     macro(thisNumberValue) \
@@ -132,6 +134,7 @@ namespace JSC {
     macro(isDerivedConstructor) \
     macro(concatMemcpy) \
     macro(appendMemcpy) \
+    macro(sortFast) \
     macro(predictFinalLengthFromArgumunts) \
     macro(print) \
     macro(regExpCreate) \
@@ -36,9 +36,15 @@ function toLocaleString(/* locales, options */)
     // 2. ReturnIfAbrupt(x).
     var number = @thisNumberValue.@call(this);
 
+    // Avoid creating a number format for defaults.
+    var locales = @argument(0);
+    var options = @argument(1);
+    if (locales === @undefined && options === @undefined)
+        return @formatWithDefaultNumberFormat(number);
+
     // 3. Let numberFormat be Construct(%NumberFormat%, «locales, options»).
     // 4. ReturnIfAbrupt(numberFormat).
-    var numberFormat = new @NumberFormat(@argument(0), @argument(1));
+    var numberFormat = new @NumberFormat(locales, options);
 
     // 5. Return FormatNumber(numberFormat, x).
     return numberFormat.format(number);
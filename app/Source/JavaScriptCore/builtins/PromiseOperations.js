@@ -46,6 +46,21 @@ function newPromiseReaction(capability, onFulfilled, onRejected)
     };
 }
 
+@globalPrivate
+function newAwaitReaction(generator, promiseCapability)
+{
+    "use strict";
+
+    // Resumes an async function awaiting the promise instead of calling a handler. It is told
+    // apart from other reactions by having no handlers.
+    return {
+        @capabilities: promiseCapability,
+        @onFulfilled: @undefined,
+        @onRejected: @undefined,
+        @generator: generator,
+    };
+}
+
 @globalPrivate
 function newPromiseCapability(constructor)
 {
@@ -89,8 +104,13 @@ function triggerPromiseReactions(state, reactions, argument)
 {
     "use strict";
 
-    for (var index = 0, length = reactions.length; index < length; ++index)
-        @enqueueJob(@promiseReactionJob, [state, reactions[index], argument]);
+    for (var index = 0, length = reactions.length; index < length; ++index) {
+        var reaction = reactions[index];
+        if (reaction.@onFulfilled === @undefined)
+            @enqueueAsyncFunctionResume(reaction.@generator, reaction.@capabilities, argument, state === @promiseStateFulfilled ? @GeneratorResumeModeNormal : @GeneratorResumeModeThrow);
+        else
+            @enqueueJob(@promiseReactionJob, [state, reaction, argument]);
+    }
 }
 
 @globalPrivate
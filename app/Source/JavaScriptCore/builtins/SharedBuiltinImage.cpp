@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SharedBuiltinImage.h"
+
+#include "CachedBytecode.h"
+#include "CachedTypes.h"
+#include "JSCInlines.h"
+#include "SourceCodeKey.h"
+#include "UnlinkedFunctionExecutable.h"
+#include <wtf/Locker.h>
+
+namespace JSC {
+
+SharedBuiltinImage& SharedBuiltinImage::singleton()
+{
+    static NeverDestroyed<SharedBuiltinImage> image;
+    return image;
+}
+
+static bool canUseSharedBuiltinImage(VM& vm, const SourceCode& source)
+{
+    if (!Options::useSharedBuiltinImage() || Options::functionOverrides())
+        return false;
+    // The profilers add opcodes and side tables that only make sense to the VM that has them.
+    if (vm.typeProfiler() || vm.controlFlowProfiler())
+        return false;
+    // Entries describe a builtin's whole source, which is what its executable is created from.
+    SourceProvider* provider = source.provider();
+    return provider && !source.startOffset() && source.length() == static_cast<int>(provider->source().length());
+}
+
+static const void* keyForSource(const SourceCode& source)
+{
+    StringView text = source.provider()->source();
+    if (text.is8Bit())
+        return text.characters8();
+    return text.characters16();
+}
+
+static SourceCodeKey sourceCodeKeyForBuiltin(const SourceCode& source)
+{
+    return SourceCodeKey(
+        source, String(), SourceCodeType::FunctionType, JSParserStrictMode::NotStrict, JSParserScriptMode::Classic,
+        DerivedContextType::None, EvalContextType::None, false, DebuggerOff, TypeProfilerEnabled::No, ControlFlowProfilerEnabled::No);
+}
+
+UnlinkedFunctionExecutable* SharedBuiltinImage::decode(VM& vm, const SourceCode& source)
+{
+    if (!canUseSharedBuiltinImage(vm, source))
+        return nullptr;
+
+    RefPtr<CachedBytecode> bytecode;
+    {
+        auto locker = holdLock(m_lock);
+        auto iter = m_entries.find(keyForSource(source));
+        if (iter == m_entries.end())
+            return nullptr;
+        bytecode = iter->value.bytecode;
+    }
+
+    UnlinkedFunctionExecutable* executable = decodeBuiltinExecutable(vm, sourceCodeKeyForBuiltin(source), source, *bytecode);
+    if (executable) {
+        auto locker = holdLock(m_lock);
+        m_decodedExecutableCount++;
+    }
+    return executable;
+}
+
+void SharedBuiltinImage::publish(VM& vm, const SourceCode& source, UnlinkedFunctionExecutable* executable, DebuggerMode debuggerMode)
+{
+    if (debuggerMode != DebuggerOff || !canUseSharedBuiltinImage(vm, source))
+        return;
+
+    unsigned codeBlockCount = executable->generatedCodeBlockCount();
+    const void* key = keyForSource(source);
+    {
+        auto locker = holdLock(m_lock);
+        auto iter = m_entries.find(key);
+        if (iter != m_entries.end() && iter->value.codeBlockCount >= codeBlockCount)
+            return;
+    }
+
+    // Encoding happens outside the lock, so two VMs may race to publish the same builtin. Either
+    // result is fine; we keep whichever has more code blocks.
+    RefPtr<CachedBytecode> bytecode = encodeBuiltinExecutable(vm, sourceCodeKeyForBuiltin(source), executable);
+    if (!bytecode)
+        return;
+
+    auto locker = holdLock(m_lock);
+    auto result = m_entries.add(key, Entry());
+    if (!result.isNewEntry && result.iterator->value.codeBlockCount >= codeBlockCount)
+        return;
+    result.iterator->value.bytecode = WTFMove(bytecode);
+    result.iterator->value.codeBlockCount = codeBlockCount;
+}
+
+unsigned SharedBuiltinImage::publishedEntryCount()
+{
+    auto locker = holdLock(m_lock);
+    return m_entries.size();
+}
+
+unsigned SharedBuiltinImage::decodedExecutableCount()
+{
+    auto locker = holdLock(m_lock);
+    return m_decodedExecutableCount;
+}
+
+} // namespace JSC
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "ParserModes.h"
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/RefPtr.h>
+
+namespace JSC {
+
+class CachedBytecode;
+class SourceCode;
+class UnlinkedFunctionExecutable;
+class VM;
+
+// A process-wide store of serialized builtin executables. The first VM to compile a builtin
+// publishes it here, together with whatever bytecode it generated for it, and later VMs decode
+// the executable instead of parsing the builtin and generating its bytecode again. Entries are
+// keyed by the address of the builtin's source text, which is a static literal shared by every
+// VM, so the text itself never needs to be hashed or compared.
+//
+// Off by default (Options::useSharedBuiltinImage). Publishing costs an encode per builtin, which
+// only pays off for embedders that create many VMs.
+//
+// Only the serialized form is shared. Every VM still owns the UnlinkedFunctionExecutables and
+// code blocks it decodes, since those are GC cells referring to identifiers in its own tables.
+class SharedBuiltinImage {
+    WTF_MAKE_NONCOPYABLE(SharedBuiltinImage);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    static SharedBuiltinImage& singleton();
+
+    // Returns null if no VM has published this builtin yet, or if the VM is set up to generate
+    // bytecode that differs from what is published, such as when profilers are enabled.
+    UnlinkedFunctionExecutable* decode(VM&, const SourceCode&);
+
+    // Replaces the published entry if this executable has more code blocks than it.
+    void publish(VM&, const SourceCode&, UnlinkedFunctionExecutable*, DebuggerMode);
+
+    JS_EXPORT_PRIVATE unsigned publishedEntryCount();
+    JS_EXPORT_PRIVATE unsigned decodedExecutableCount();
+
+private:
+    friend class NeverDestroyed<SharedBuiltinImage>;
+    SharedBuiltinImage() = default;
+
+    struct Entry {
+        RefPtr<CachedBytecode> bytecode;
+        unsigned codeBlockCount { 0 };
+    };
+
+    Lock m_lock;
+    HashMap<const void*, Entry> m_entries;
+    unsigned m_decodedExecutableCount { 0 };
+};
+
+} // namespace JSC
@@ -106,23 +106,6 @@ function every(callback /*, thisArg */)
     return true;
 }
 
-function fill(value /* [, start [, end]] */)
-{
-    "use strict";
-
-    let length = @typedArrayLength(this);
-
-    let start = @argument(1);
-    let end = @argument(2);
-
-    start = @typedArrayClampArgumentToStartOrEnd(start, length, 0);
-    end = @typedArrayClampArgumentToStartOrEnd(end, length, length);
-
-    for (let i = start; i < end; i++)
-        this[i] = value;
-    return this;
-}
-
 function find(callback /* [, thisArg] */)
 {
     "use strict";
@@ -227,6 +227,17 @@ public:
     
     bool usesOriginalArrayStructures(const ConcurrentJSLocker&) const { return m_usesOriginalArrayStructures; }
     
+    // Merges in what the same access saw in an earlier run. Those modes are not
+    // first-run noise, so they are exempt from pruning.
+    void seed(const ConcurrentJSLocker&, ArrayModes observedArrayModes, bool mayStoreToHole, bool outOfBounds)
+    {
+        m_observedArrayModes |= observedArrayModes;
+        m_mayStoreToHole |= mayStoreToHole;
+        m_outOfBounds |= outOfBounds;
+        if (observedArrayModes)
+            m_didPerformFirstRunPruning = true;
+    }
+
     CString briefDescription(const ConcurrentJSLocker&, CodeBlock*);
     CString briefDescriptionWithoutUpdating(const ConcurrentJSLocker&);
     
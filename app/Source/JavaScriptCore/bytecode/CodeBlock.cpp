@@ -65,6 +65,7 @@
 #include "ModuleProgramCodeBlock.h"
 #include "PCToCodeOriginMap.h"
 #include "PolymorphicAccess.h"
+#include "ProfileCache.h"
 #include "ProfilerDatabase.h"
 #include "ProgramCodeBlock.h"
 #include "ReduceWhitespace.h"
@@ -300,6 +301,7 @@ CodeBlock::CodeBlock(VM* vm, Structure* structure, CopyParsedBlockTag, CodeBlock
     , m_didFailJITCompilation(false)
     , m_didFailFTLCompilation(false)
     , m_hasBeenCompiledWithFTL(false)
+    , m_didSeedProfiles(false)
     , m_isConstructor(other.m_isConstructor)
     , m_isStrictMode(other.m_isStrictMode)
     , m_codeType(other.m_codeType)
@@ -365,6 +367,7 @@ CodeBlock::CodeBlock(VM* vm, Structure* structure, ScriptExecutable* ownerExecut
     , m_didFailJITCompilation(false)
     , m_didFailFTLCompilation(false)
     , m_hasBeenCompiledWithFTL(false)
+    , m_didSeedProfiles(false)
     , m_isConstructor(unlinkedCodeBlock->isConstructor())
     , m_isStrictMode(unlinkedCodeBlock->isStrictMode())
     , m_codeType(unlinkedCodeBlock->codeType())
@@ -806,6 +809,10 @@ void CodeBlock::finishCreation(VM& vm, ScriptExecutable* ownerExecutable, Unlink
 
     m_instructions = WTFMove(instructions);
 
+    // Seed before setting the thresholds, since seeded code blocks warm up faster.
+    if (ProfileCache* profileCache = vm.profileCache())
+        m_didSeedProfiles = profileCache->seed(this);
+
     // Set optimization thresholds only after m_instructions is initialized, since these
     // rely on the instruction count (and are in theory permitted to also inspect the
     // instruction stream to more accurate assess the cost of tier-up).
@@ -1893,6 +1900,14 @@ void CodeBlock::jettison(Profiler::JettisonReason reason, ReoptimizationMode mod
         baselineAlternative()->countReoptimization();
         if (DFG::shouldDumpDisassembly())
             dataLog("    Did count reoptimization for ", *this, "\n");
+
+        // We sped through warm-up on profiles from an earlier run, and they were wrong. Warm up
+        // normally from now on.
+        if (baselineAlternative()->m_didSeedProfiles) {
+            baselineAlternative()->m_didSeedProfiles = false;
+            if (ProfileCache* profileCache = m_vm->profileCache())
+                profileCache->didJettisonSeededCode();
+        }
     }
     
     if (this != replacement()) {
@@ -2256,8 +2271,10 @@ void CodeBlock::optimizeAfterWarmUp()
     if (Options::verboseOSR())
         dataLog(*this, ": Optimizing after warm-up.\n");
 #if ENABLE(DFG_JIT)
-    m_jitExecuteCounter.setNewThreshold(
-        adjustedCounterValue(Options::thresholdForOptimizeAfterWarmUp()), this);
+    int32_t threshold = Options::thresholdForOptimizeAfterWarmUp();
+    if (m_didSeedProfiles)
+        threshold = static_cast<int32_t>(threshold * Options::profileCacheWarmUpMultiplier());
+    m_jitExecuteCounter.setNewThreshold(adjustedCounterValue(threshold), this);
 #endif
 }
 
@@ -2510,8 +2527,9 @@ bool CodeBlock::shouldOptimizeNow()
             numberOfSamplesInProfiles, ValueProfile::numberOfBuckets * numberOfValueProfiles());
     }
 
+    // Seeded predictions count as live, but they didn't come with any samples.
     if ((!numberOfValueProfiles() || (double)numberOfLiveNonArgumentValueProfiles / numberOfValueProfiles() >= Options::desiredProfileLivenessRate())
-        && (!totalNumberOfValueProfiles() || (double)numberOfSamplesInProfiles / ValueProfile::numberOfBuckets / totalNumberOfValueProfiles() >= Options::desiredProfileFullnessRate())
+        && (m_didSeedProfiles || !totalNumberOfValueProfiles() || (double)numberOfSamplesInProfiles / ValueProfile::numberOfBuckets / totalNumberOfValueProfiles() >= Options::desiredProfileFullnessRate())
         && static_cast<unsigned>(m_optimizationDelayCounter) + 1 >= Options::minimumOptimizationDelay())
         return true;
     
@@ -2958,7 +2976,10 @@ int32_t CodeBlock::thresholdForJIT(int32_t threshold)
 
 void CodeBlock::jitAfterWarmUp()
 {
-    m_llintExecuteCounter.setNewThreshold(thresholdForJIT(Options::thresholdForJITAfterWarmUp()), this);
+    int32_t threshold = Options::thresholdForJITAfterWarmUp();
+    if (m_didSeedProfiles)
+        threshold = static_cast<int32_t>(threshold * Options::profileCacheWarmUpMultiplier());
+    m_llintExecuteCounter.setNewThreshold(thresholdForJIT(threshold), this);
 }
 
 void CodeBlock::jitSoon()
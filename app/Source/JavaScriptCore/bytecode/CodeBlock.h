@@ -848,6 +848,7 @@ public:
     bool m_didFailJITCompilation : 1;
     bool m_didFailFTLCompilation : 1;
     bool m_hasBeenCompiledWithFTL : 1;
+    bool m_didSeedProfiles : 1;
     bool m_isConstructor : 1;
     bool m_isStrictMode : 1;
     unsigned m_codeType : 2; // CodeType
@@ -85,6 +85,13 @@ Vector<FrequentExitSite> ExitProfile::exitSitesFor(unsigned bytecodeIndex)
     return result;
 }
 
+Vector<FrequentExitSite> ExitProfile::allExitSites(const ConcurrentJSLocker&) const
+{
+    if (!m_frequentExitSites)
+        return Vector<FrequentExitSite>();
+    return *m_frequentExitSites;
+}
+
 bool ExitProfile::hasExitSite(const ConcurrentJSLocker&, const FrequentExitSite& site) const
 {
     if (!m_frequentExitSites)
@@ -165,6 +165,10 @@ public:
     // Get the frequent exit sites for a bytecode index. This is O(n), and is
     // meant to only be used from debugging/profiling code.
     Vector<FrequentExitSite> exitSitesFor(unsigned bytecodeIndex);
+
+    // Get all of the frequent exit sites. This is O(n), and is meant to be used when
+    // saving profiles for a later run.
+    Vector<FrequentExitSite> allExitSites(const ConcurrentJSLocker&) const;
     
     // This is O(n) and should be called on less-frequently executed code paths
     // in the compiler. It should be strictly cheaper than building a
@@ -0,0 +1,424 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ProfileCache.h"
+
+#include "CodeBlock.h"
+#include "DFGWorklist.h"
+#include "DeferGC.h"
+#include "HeapInlines.h"
+#include "Interpreter.h"
+#include "JSCInlines.h"
+#include <stdio.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/DataLog.h>
+#include <wtf/ProcessID.h>
+#include <wtf/text/StringConcatenate.h>
+
+namespace JSC {
+
+static const bool verbose = false;
+
+static const uint32_t profileCacheMagic = 0x4a534350; // "JSCP"
+static const uint32_t profileCacheVersion = 1;
+
+namespace {
+
+class Writer {
+public:
+    template<typename T> void write(T value)
+    {
+        m_data.append(reinterpret_cast<const uint8_t*>(&value), sizeof(T));
+    }
+
+    const Vector<uint8_t>& data() const { return m_data; }
+
+private:
+    Vector<uint8_t> m_data;
+};
+
+class Reader {
+public:
+    Reader(const Vector<uint8_t>& data)
+        : m_data(data)
+    {
+    }
+
+    template<typename T> bool read(T& value)
+    {
+        if (m_data.size() - m_offset < sizeof(T))
+            return false;
+        memcpy(&value, m_data.data() + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return true;
+    }
+
+    // Guards against sizing vectors from a corrupt count.
+    bool canRead(uint32_t count, size_t elementSize) const
+    {
+        return static_cast<uint64_t>(count) * elementSize <= m_data.size() - m_offset;
+    }
+
+private:
+    const Vector<uint8_t>& m_data;
+    size_t m_offset { 0 };
+};
+
+// Keeps concurrent compiles from reading profiles while updateAllPredictions() writes them.
+class CompilerThreadSuspender {
+public:
+    CompilerThreadSuspender()
+    {
+#if ENABLE(DFG_JIT)
+        for (unsigned i = DFG::numberOfWorklists(); i--;) {
+            if (DFG::Worklist* worklist = DFG::existingWorklistForIndexOrNull(i))
+                worklist->suspendAllThreads();
+        }
+#endif
+    }
+
+    ~CompilerThreadSuspender()
+    {
+#if ENABLE(DFG_JIT)
+        for (unsigned i = DFG::numberOfWorklists(); i--;) {
+            if (DFG::Worklist* worklist = DFG::existingWorklistForIndexOrNull(i))
+                worklist->resumeAllThreads();
+        }
+#endif
+    }
+};
+
+} // anonymous namespace
+
+ProfileCache::ProfileCache(VM& vm, const char* path)
+    : m_vm(vm)
+    , m_path(path)
+{
+    load();
+}
+
+ProfileCache::~ProfileCache()
+{
+}
+
+ProfileCache::Key ProfileCache::keyFor(CodeBlock* codeBlock)
+{
+    return Key(codeBlock->hash().hash(), codeBlock->instructionCount());
+}
+
+ProfileCache::Entry ProfileCache::entryFor(CodeBlock* codeBlock)
+{
+    Entry entry;
+    codeBlock->updateAllPredictions();
+
+    ConcurrentJSLocker locker(codeBlock->m_lock);
+
+    for (unsigned i = 0; i < codeBlock->numberOfArgumentValueProfiles(); ++i)
+        entry.argumentPredictions.append(codeBlock->valueProfileForArgument(i)->m_prediction);
+
+    for (unsigned i = 0; i < codeBlock->numberOfValueProfiles(); ++i) {
+        ValueProfile* profile = codeBlock->valueProfile(i);
+        if (profile->m_prediction != SpecNone)
+            entry.valuePredictions.append(std::make_pair(profile->m_bytecodeOffset, profile->m_prediction));
+    }
+
+    for (ArrayProfile& profile : codeBlock->arrayProfiles()) {
+        ArrayProfileRecord record;
+        record.bytecodeOffset = profile.bytecodeOffset();
+        record.observedArrayModes = profile.observedArrayModes(locker);
+        record.mayStoreToHole = profile.mayStoreToHole(locker);
+        record.outOfBounds = profile.outOfBounds(locker);
+        if (record.observedArrayModes || record.mayStoreToHole || record.outOfBounds)
+            entry.arrayProfiles.append(record);
+    }
+
+    Interpreter* interpreter = codeBlock->vm()->interpreter;
+    auto& instructions = codeBlock->instructions();
+    for (unsigned i = 0; i < instructions.size();) {
+        if (ArithProfile* profile = codeBlock->arithProfileForPC(instructions.begin() + i))
+            entry.arithProfiles.append(std::make_pair(i, profile->bits()));
+        i += opcodeLength(interpreter->getOpcodeID(instructions[i]));
+    }
+
+    entry.exitSites = codeBlock->exitProfile().allExitSites(locker);
+    return entry;
+}
+
+bool ProfileCache::seed(CodeBlock* codeBlock)
+{
+    if (m_entries.isEmpty())
+        return false;
+
+    auto iter = m_entries.find(keyFor(codeBlock));
+    if (iter == m_entries.end())
+        return false;
+    const Entry& entry = iter->value;
+
+    // The source hash is only 32 bits, so make sure the profiles fit before trusting them.
+    if (entry.argumentPredictions.size() != codeBlock->numberOfArgumentValueProfiles())
+        return false;
+
+    ConcurrentJSLocker locker(codeBlock->m_lock);
+
+    for (unsigned i = 0; i < entry.argumentPredictions.size(); ++i)
+        mergeSpeculation(codeBlock->valueProfileForArgument(i)->m_prediction, entry.argumentPredictions[i]);
+
+    // Both lists are in bytecode order.
+    unsigned profileIndex = 0;
+    for (auto& prediction : entry.valuePredictions) {
+        while (profileIndex < codeBlock->numberOfValueProfiles() && codeBlock->valueProfile(profileIndex)->m_bytecodeOffset < prediction.first)
+            profileIndex++;
+        if (profileIndex == codeBlock->numberOfValueProfiles())
+            break;
+        ValueProfile* profile = codeBlock->valueProfile(profileIndex);
+        if (profile->m_bytecodeOffset == prediction.first)
+            mergeSpeculation(profile->m_prediction, prediction.second);
+    }
+
+    for (const ArrayProfileRecord& record : entry.arrayProfiles) {
+        if (ArrayProfile* profile = codeBlock->getArrayProfile(locker, record.bytecodeOffset))
+            profile->seed(locker, record.observedArrayModes, record.mayStoreToHole, record.outOfBounds);
+    }
+
+    // Only look for arith profiles at instruction boundaries, in case the bytecode differs after all.
+    Interpreter* interpreter = codeBlock->vm()->interpreter;
+    auto& instructions = codeBlock->instructions();
+    unsigned arithIndex = 0;
+    for (unsigned i = 0; i < instructions.size() && arithIndex < entry.arithProfiles.size();) {
+        if (entry.arithProfiles[arithIndex].first == i) {
+            if (ArithProfile* profile = codeBlock->arithProfileForPC(instructions.begin() + i))
+                *profile = ArithProfile::fromInt(profile->bits() | entry.arithProfiles[arithIndex].second);
+        }
+        while (arithIndex < entry.arithProfiles.size() && entry.arithProfiles[arithIndex].first <= i)
+            arithIndex++;
+        i += opcodeLength(interpreter->getOpcodeID(instructions[i]));
+    }
+
+    for (const DFG::FrequentExitSite& site : entry.exitSites)
+        codeBlock->exitProfile().add(locker, codeBlock, site);
+
+    m_seededCodeBlocks++;
+    if (verbose)
+        dataLogLn("Seeded profiles of ", *codeBlock);
+    return true;
+}
+
+void ProfileCache::load()
+{
+    FILE* file = fopen(m_path.data(), "rb");
+    if (!file)
+        return;
+
+    Vector<uint8_t> data;
+    uint8_t buffer[4096];
+    while (size_t bytesRead = fread(buffer, 1, sizeof(buffer), file))
+        data.append(buffer, bytesRead);
+    fclose(file);
+
+    // Profiles only make sense for the build that wrote them.
+    Reader reader(data);
+    uint32_t magic;
+    uint32_t version;
+    uint32_t opcodeCount;
+    uint64_t speculationTop;
+    uint32_t entryCount;
+    if (!reader.read(magic) || magic != profileCacheMagic
+        || !reader.read(version) || version != profileCacheVersion
+        || !reader.read(opcodeCount) || opcodeCount != static_cast<uint32_t>(numOpcodeIDs)
+        || !reader.read(speculationTop) || speculationTop != SpecFullTop
+        || !reader.read(entryCount))
+        return;
+
+    HashMap<Key, Entry> entries;
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        Key key;
+        uint32_t argumentCount;
+        uint32_t valueCount;
+        uint32_t arrayCount;
+        uint32_t arithCount;
+        uint32_t exitSiteCount;
+        if (!reader.read(key.first) || !reader.read(key.second)
+            || !reader.read(argumentCount) || !reader.read(valueCount) || !reader.read(arrayCount)
+            || !reader.read(arithCount) || !reader.read(exitSiteCount))
+            return;
+        if (!key.first || !reader.canRead(argumentCount, sizeof(SpeculatedType)) || !reader.canRead(valueCount, sizeof(int32_t) + sizeof(SpeculatedType))
+            || !reader.canRead(arrayCount, sizeof(uint32_t) * 2 + 2) || !reader.canRead(arithCount, sizeof(uint32_t) * 2)
+            || !reader.canRead(exitSiteCount, sizeof(uint32_t) + 2))
+            return;
+
+        Entry entry;
+        entry.argumentPredictions.reserveInitialCapacity(argumentCount);
+        for (uint32_t j = 0; j < argumentCount; ++j) {
+            SpeculatedType prediction;
+            if (!reader.read(prediction))
+                return;
+            entry.argumentPredictions.uncheckedAppend(prediction & SpecFullTop);
+        }
+        entry.valuePredictions.reserveInitialCapacity(valueCount);
+        for (uint32_t j = 0; j < valueCount; ++j) {
+            int32_t bytecodeOffset;
+            SpeculatedType prediction;
+            if (!reader.read(bytecodeOffset) || !reader.read(prediction))
+                return;
+            entry.valuePredictions.uncheckedAppend(std::make_pair(bytecodeOffset, prediction & SpecFullTop));
+        }
+        entry.arrayProfiles.reserveInitialCapacity(arrayCount);
+        for (uint32_t j = 0; j < arrayCount; ++j) {
+            ArrayProfileRecord record;
+            uint32_t observedArrayModes;
+            uint8_t mayStoreToHole;
+            uint8_t outOfBounds;
+            if (!reader.read(record.bytecodeOffset) || !reader.read(observedArrayModes) || !reader.read(mayStoreToHole) || !reader.read(outOfBounds))
+                return;
+            record.observedArrayModes = observedArrayModes;
+            record.mayStoreToHole = mayStoreToHole;
+            record.outOfBounds = outOfBounds;
+            entry.arrayProfiles.uncheckedAppend(record);
+        }
+        entry.arithProfiles.reserveInitialCapacity(arithCount);
+        for (uint32_t j = 0; j < arithCount; ++j) {
+            uint32_t bytecodeOffset;
+            uint32_t bits;
+            if (!reader.read(bytecodeOffset) || !reader.read(bits))
+                return;
+            entry.arithProfiles.uncheckedAppend(std::make_pair(bytecodeOffset, bits));
+        }
+        for (uint32_t j = 0; j < exitSiteCount; ++j) {
+            uint32_t bytecodeOffset;
+            uint8_t kind;
+            uint8_t jitType;
+            if (!reader.read(bytecodeOffset) || !reader.read(kind) || !reader.read(jitType))
+                return;
+            if (kind == ExitKindUnset || kind > GenericUnwind || jitType == ExitFromAnything || jitType > ExitFromFTL)
+                continue;
+            entry.exitSites.append(DFG::FrequentExitSite(bytecodeOffset, static_cast<ExitKind>(kind), static_cast<ExitingJITType>(jitType)));
+        }
+        entries.set(key, WTFMove(entry));
+    }
+
+    m_entries = WTFMove(entries);
+    m_loadedEntries = m_entries.size();
+    if (verbose)
+        dataLogLn("Loaded ", m_loadedEntries, " code block profiles from ", m_path);
+}
+
+bool ProfileCache::save()
+{
+    // Profiles are updated by the mutator under the API lock, and read by the compiler threads.
+    ASSERT(m_vm.currentThreadIsHoldingAPILock());
+    DeferGC deferGC(m_vm.heap);
+    CompilerThreadSuspender suspender;
+
+    double before = 0;
+    if (Options::reportProfileCacheStatistics())
+        before = monotonicallyIncreasingTimeMS();
+
+    // Code that ran this time replaces what was loaded for it. Its profiles started out seeded
+    // with the loaded ones, so nothing is lost.
+    unsigned liveCodeBlocks = 0;
+    m_vm.heap.forEachCodeBlock([&] (CodeBlock* codeBlock) {
+        if (JITCode::isOptimizingJIT(codeBlock->jitType()))
+            return false;
+        Key key = keyFor(codeBlock);
+        if (key.first) {
+            m_entries.set(key, entryFor(codeBlock));
+            liveCodeBlocks++;
+        }
+        return false;
+    });
+
+    // VMs that never run anything, like the one that compiles programs in the background,
+    // would only write back what they loaded, possibly over another VM's newer profiles.
+    if (!liveCodeBlocks)
+        return false;
+
+    Writer writer;
+    writer.write(profileCacheMagic);
+    writer.write(profileCacheVersion);
+    writer.write(static_cast<uint32_t>(numOpcodeIDs));
+    writer.write(static_cast<uint64_t>(SpecFullTop));
+    writer.write(static_cast<uint32_t>(m_entries.size()));
+    for (auto& iter : m_entries) {
+        const Entry& entry = iter.value;
+        writer.write(iter.key.first);
+        writer.write(iter.key.second);
+        writer.write(static_cast<uint32_t>(entry.argumentPredictions.size()));
+        writer.write(static_cast<uint32_t>(entry.valuePredictions.size()));
+        writer.write(static_cast<uint32_t>(entry.arrayProfiles.size()));
+        writer.write(static_cast<uint32_t>(entry.arithProfiles.size()));
+        writer.write(static_cast<uint32_t>(entry.exitSites.size()));
+        for (SpeculatedType prediction : entry.argumentPredictions)
+            writer.write(prediction);
+        for (auto& prediction : entry.valuePredictions) {
+            writer.write(static_cast<int32_t>(prediction.first));
+            writer.write(prediction.second);
+        }
+        for (const ArrayProfileRecord& record : entry.arrayProfiles) {
+            writer.write(static_cast<uint32_t>(record.bytecodeOffset));
+            writer.write(static_cast<uint32_t>(record.observedArrayModes));
+            writer.write(static_cast<uint8_t>(record.mayStoreToHole));
+            writer.write(static_cast<uint8_t>(record.outOfBounds));
+        }
+        for (auto& profile : entry.arithProfiles) {
+            writer.write(static_cast<uint32_t>(profile.first));
+            writer.write(profile.second);
+        }
+        for (const DFG::FrequentExitSite& site : entry.exitSites) {
+            writer.write(static_cast<uint32_t>(site.bytecodeOffset()));
+            writer.write(static_cast<uint8_t>(site.kind()));
+            writer.write(static_cast<uint8_t>(site.jitType()));
+        }
+    }
+
+    // Write to a temporary file first so that a concurrent load never sees half of it.
+    CString temporaryPath = makeString(m_path.data(), ".tmp.", String::number(getCurrentProcessID())).utf8();
+    const Vector<uint8_t>& data = writer.data();
+    bool success = false;
+    if (FILE* file = fopen(temporaryPath.data(), "wb")) {
+        success = fwrite(data.data(), 1, data.size(), file) == data.size();
+        success &= !fclose(file);
+        if (success)
+            success = !rename(temporaryPath.data(), m_path.data());
+        if (!success)
+            remove(temporaryPath.data());
+    }
+
+    if (Options::reportProfileCacheStatistics()) {
+        dumpStatistics(WTF::dataFile());
+        dataLogLn("    ", success ? "Wrote " : "Failed to write ", m_entries.size(), " code block profiles (", data.size(), " bytes) to ", m_path, " in ", monotonicallyIncreasingTimeMS() - before, " ms");
+    }
+    return success;
+}
+
+void ProfileCache::dumpStatistics(PrintStream& out) const
+{
+    out.print("Profile cache ", m_path, ":\n");
+    out.print("    Loaded profiles for ", m_loadedEntries, " code blocks\n");
+    out.print("    Seeded ", m_seededCodeBlocks, " code blocks\n");
+    out.print("    Jettisoned ", m_jettisonedSeededCodeBlocks, " optimized code blocks because of stale seeded profiles\n");
+}
+
+} // namespace JSC
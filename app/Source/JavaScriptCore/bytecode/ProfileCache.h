@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "ArrayProfile.h"
+#include "DFGExitProfile.h"
+#include "SpeculatedType.h"
+#include <wtf/HashMap.h>
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+
+namespace JSC {
+
+class CodeBlock;
+class VM;
+
+// Carries a VM's value, array and arith profiles, and the frequent exit sites the optimizing
+// JITs found, over to the next run of the same program. Profiles are saved to
+// Options::profileCachePath() when the VM is destroyed or when the embedder calls save(), and seeded into
+// each new CodeBlock whose source hash and instruction count match. Seeded code blocks then
+// tier up after a shorter warm-up.
+//
+// Call link statistics are not saved: callees are identified by pointer, and nothing ties those
+// to the next run. The exit sites do carry the "don't speculate on this" part of that knowledge.
+class ProfileCache {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    ProfileCache(VM&, const char* path);
+    ~ProfileCache();
+
+    // Returns true if anything was seeded. Called as the code block is created, before it has
+    // run or been compiled.
+    bool seed(CodeBlock*);
+
+    // Writes the profiles of every live code block, plus whatever was loaded for code that did
+    // not run this time, to the cache file. The caller must hold the API lock. Compiler threads
+    // are suspended while the profiles are read. Embedders whose VM is never destroyed, like the
+    // jsc shell, call this themselves before exiting.
+    JS_EXPORT_PRIVATE bool save();
+
+    // A code block whose profiles were seeded got jettisoned and will be reoptimized. That
+    // means the profiles from the last run were stale.
+    void didJettisonSeededCode() { m_jettisonedSeededCodeBlocks++; }
+
+    void dumpStatistics(PrintStream&) const;
+
+    struct ArrayProfileRecord {
+        unsigned bytecodeOffset;
+        ArrayModes observedArrayModes;
+        bool mayStoreToHole;
+        bool outOfBounds;
+    };
+
+    struct Entry {
+        Vector<SpeculatedType> argumentPredictions;
+        Vector<std::pair<int, SpeculatedType>> valuePredictions;
+        Vector<ArrayProfileRecord> arrayProfiles;
+        Vector<std::pair<unsigned, uint32_t>> arithProfiles;
+        Vector<DFG::FrequentExitSite> exitSites;
+    };
+
+private:
+    // Source hash and instruction count. The hash already covers the specialization kind.
+    typedef std::pair<unsigned, unsigned> Key;
+
+    static Key keyFor(CodeBlock*);
+    static Entry entryFor(CodeBlock*);
+
+    void load();
+
+    VM& m_vm;
+    CString m_path;
+    HashMap<Key, Entry> m_entries;
+
+    unsigned m_loadedEntries { 0 };
+    unsigned m_seededCodeBlocks { 0 };
+    unsigned m_jettisonedSeededCodeBlocks { 0 };
+};
+
+} // namespace JSC
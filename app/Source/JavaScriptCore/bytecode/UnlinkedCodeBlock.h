@@ -393,6 +393,8 @@ protected:
     }
 
 private:
+    friend class BytecodeCacheReader;
+    friend class BytecodeCacheWriter;
     friend class BytecodeRewriter;
     void applyModification(BytecodeRewriter&);
 
@@ -34,6 +34,7 @@
 #include "FunctionOverrides.h"
 #include "JSCInlines.h"
 #include "Parser.h"
+#include "SharedBuiltinImage.h"
 #include "SourceProvider.h"
 #include "Structure.h"
 #include "UnlinkedFunctionCodeBlock.h"
@@ -94,6 +95,7 @@ UnlinkedFunctionExecutable::UnlinkedFunctionExecutable(VM* vm, Structure* struct
     , m_isInStrictContext(node->isInStrictContext())
     , m_hasCapturedVariables(false)
     , m_isBuiltinFunction(kind == UnlinkedBuiltinFunction)
+    , m_isSharedBuiltinImageRoot(false)
     , m_constructAbility(static_cast<unsigned>(constructAbility))
     , m_constructorKind(static_cast<unsigned>(node->constructorKind()))
     , m_functionMode(static_cast<unsigned>(node->functionMode()))
@@ -117,6 +119,35 @@ UnlinkedFunctionExecutable::UnlinkedFunctionExecutable(VM* vm, Structure* struct
     m_parentScopeTDZVariables.swap(parentScopeTDZVariables);
 }
 
+UnlinkedFunctionExecutable::UnlinkedFunctionExecutable(VM* vm, Structure* structure)
+    : Base(*vm, structure)
+    , m_firstLineOffset(0)
+    , m_lineCount(0)
+    , m_unlinkedFunctionNameStart(0)
+    , m_unlinkedBodyStartColumn(0)
+    , m_unlinkedBodyEndColumn(0)
+    , m_startOffset(0)
+    , m_sourceLength(0)
+    , m_parametersStartOffset(0)
+    , m_typeProfilingStartOffset(0)
+    , m_typeProfilingEndOffset(0)
+    , m_parameterCount(0)
+    , m_functionLength(0)
+    , m_features(0)
+    , m_sourceParseMode(SourceParseMode::NormalFunctionMode)
+    , m_isInStrictContext(false)
+    , m_hasCapturedVariables(false)
+    , m_isBuiltinFunction(false)
+    , m_isSharedBuiltinImageRoot(false)
+    , m_constructAbility(0)
+    , m_constructorKind(0)
+    , m_functionMode(0)
+    , m_scriptMode(0)
+    , m_superBinding(0)
+    , m_derivedContextType(0)
+{
+}
+
 void UnlinkedFunctionExecutable::destroy(JSCell* cell)
 {
     static_cast<UnlinkedFunctionExecutable*>(cell)->~UnlinkedFunctionExecutable();
@@ -223,6 +254,9 @@ UnlinkedFunctionCodeBlock* UnlinkedFunctionExecutable::unlinkedCodeBlockFor(
         m_unlinkedCodeBlockForConstruct.set(vm, this, result);
         break;
     }
+
+    if (isSharedBuiltinImageRoot())
+        SharedBuiltinImage::singleton().publish(vm, SourceCode(makeRef(*source.provider())), this, debuggerMode);
     return result;
 }
 
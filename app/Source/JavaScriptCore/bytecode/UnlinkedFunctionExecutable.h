@@ -58,6 +58,8 @@ enum UnlinkedFunctionKind {
 
 class UnlinkedFunctionExecutable final : public JSCell {
 public:
+    friend class BytecodeCacheReader;
+    friend class BytecodeCacheWriter;
     friend class CodeCache;
     friend class VM;
 
@@ -105,6 +107,7 @@ public:
     UnlinkedFunctionCodeBlock* unlinkedCodeBlockFor(
         VM&, const SourceCode&, CodeSpecializationKind, DebuggerMode,
         ParserError&, SourceParseMode);
+    unsigned generatedCodeBlockCount() const { return !!m_unlinkedCodeBlockForCall.get() + !!m_unlinkedCodeBlockForConstruct.get(); }
 
     static UnlinkedFunctionExecutable* fromGlobalCode(
         const Identifier&, ExecState&, const SourceCode&, JSObject*& exception, 
@@ -131,6 +134,10 @@ public:
     static void destroy(JSCell*);
 
     bool isBuiltinFunction() const { return m_isBuiltinFunction; }
+    // Set on the executable for a builtin's outermost function, which is what SharedBuiltinImage
+    // stores. Functions nested inside builtins are builtins too, but are reached through it.
+    bool isSharedBuiltinImageRoot() const { return m_isSharedBuiltinImageRoot; }
+    void setIsSharedBuiltinImageRoot() { m_isSharedBuiltinImageRoot = true; }
     ConstructAbility constructAbility() const { return static_cast<ConstructAbility>(m_constructAbility); }
     JSParserScriptMode scriptMode() const { return static_cast<JSParserScriptMode>(m_scriptMode); }
     bool isClassConstructorFunction() const { return constructorKind() != ConstructorKind::None; }
@@ -147,6 +154,8 @@ public:
 
 private:
     UnlinkedFunctionExecutable(VM*, Structure*, const SourceCode&, SourceCode&& parentSourceOverride, FunctionMetadataNode*, UnlinkedFunctionKind, ConstructAbility, JSParserScriptMode, VariableEnvironment&,  JSC::DerivedContextType);
+    // Used by BytecodeCacheReader, which fills in the fields from the serialized executable.
+    UnlinkedFunctionExecutable(VM*, Structure*);
 
     unsigned m_firstLineOffset;
     unsigned m_lineCount;
@@ -165,6 +174,7 @@ private:
     unsigned m_isInStrictContext : 1;
     unsigned m_hasCapturedVariables : 1;
     unsigned m_isBuiltinFunction : 1;
+    unsigned m_isSharedBuiltinImageRoot : 1;
     unsigned m_constructAbility: 1;
     unsigned m_constructorKind : 2;
     unsigned m_functionMode : 2; // FunctionMode
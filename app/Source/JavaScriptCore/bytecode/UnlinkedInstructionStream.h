@@ -61,8 +61,16 @@ public:
 #endif
 
 private:
+    friend class BytecodeCacheReader;
+    friend class BytecodeCacheWriter;
     friend class Reader;
 
+    UnlinkedInstructionStream(RefCountedArray<unsigned char>&& data, unsigned instructionCount)
+        : m_data(WTFMove(data))
+        , m_instructionCount(instructionCount)
+    {
+    }
+
 #ifndef NDEBUG
     mutable RefCountedArray<UnlinkedInstruction> m_unpackedInstructionsForDebugging;
 #endif
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ConcurrentSweeper.h"
+
+#include "Heap.h"
+#include "HeapHelperPool.h"
+#include "JSCInlines.h"
+#include "MarkedAllocatorInlines.h"
+#include "MarkedSpaceInlines.h"
+#include <wtf/MonotonicTime.h>
+
+namespace JSC {
+
+ConcurrentSweeper::ConcurrentSweeper(Heap& heap)
+    : m_heap(heap)
+    , m_helperClient(&heapHelperPool())
+{
+    m_nextBlockIndex.store(0);
+    m_shouldStop.store(false);
+}
+
+ConcurrentSweeper::~ConcurrentSweeper()
+{
+    ASSERT(m_blocks.isEmpty());
+}
+
+void ConcurrentSweeper::startSweeping()
+{
+    RELEASE_ASSERT(m_blocks.isEmpty());
+
+    // With only one marker, the helper pool has no threads to give us.
+    if (!Options::useConcurrentSweeping() || Options::sweepSynchronously() || Options::numberOfGCMarkers() <= 1)
+        return;
+
+    m_heap.objectSpace().forEachBlock(
+        [&] (MarkedBlock::Handle* block) {
+            if (block->startConcurrentSweep())
+                m_blocks.append(block);
+        });
+
+    if (m_blocks.isEmpty())
+        return;
+
+    m_nextBlockIndex.store(0);
+    m_shouldStop.store(false);
+    m_helperClient.setFunction(
+        [this] () {
+            sweepBlocks();
+        });
+}
+
+void ConcurrentSweeper::stopSweeping()
+{
+    if (m_blocks.isEmpty())
+        return;
+
+    m_shouldStop.store(true);
+    m_helperClient.finish();
+
+    // None of these blocks can have been freed yet: only empty blocks are freed, and a block is
+    // only found to be empty by a collection or by sweeping it with destructors.
+    for (MarkedBlock::Handle* block : m_blocks)
+        block->cancelConcurrentSweep();
+    m_blocks.clear();
+}
+
+Seconds ConcurrentSweeper::takeSweepTime()
+{
+    auto locker = holdLock(m_sweepTimeLock);
+    return std::exchange(m_sweepTime, Seconds());
+}
+
+void ConcurrentSweeper::sweepBlocks()
+{
+    MonotonicTime before;
+    if (Options::logGC())
+        before = MonotonicTime::now();
+
+    while (!m_shouldStop.load(std::memory_order_relaxed)) {
+        unsigned index = m_nextBlockIndex.exchangeAdd(1);
+        if (index >= m_blocks.size())
+            break;
+        m_blocks[index]->sweepToFreeListConcurrently();
+    }
+
+    if (Options::logGC()) {
+        auto locker = holdLock(m_sweepTimeLock);
+        m_sweepTime += MonotonicTime::now() - before;
+    }
+}
+
+} // namespace JSC
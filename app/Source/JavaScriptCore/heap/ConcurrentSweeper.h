@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "MarkedBlock.h"
+#include <wtf/Atomics.h>
+#include <wtf/Lock.h>
+#include <wtf/ParallelHelperPool.h>
+#include <wtf/Seconds.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class Heap;
+
+// Builds free lists on the heap helper threads after a collection, so that the mutator does not
+// have to sweep those blocks itself when it next allocates from them.
+//
+// Only blocks without destructors are swept here. Running destructors and sweeping weak sets
+// touches state that is not thread-safe, so those blocks are left to IncrementalSweeper and to
+// the allocator. Even for the blocks swept here, the helpers only write to dead cells and to the
+// block's concurrent sweep state; the allocator's bits are only ever changed on the mutator,
+// when it picks the free list up in MarkedBlock::Handle::sweep().
+class ConcurrentSweeper {
+    WTF_MAKE_NONCOPYABLE(ConcurrentSweeper);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    ConcurrentSweeper(Heap&);
+    ~ConcurrentSweeper();
+
+    // Called at the end of a collection, while the world is stopped.
+    void startSweeping();
+
+    // Called before the next collection starts marking, and before the heap is torn down. Waits
+    // for the helpers to quit and throws away any free lists the mutator has not picked up yet,
+    // since they were built from the previous collection's mark bits.
+    void stopSweeping();
+
+    // Time the helpers have spent sweeping since this was last called. Only measured when
+    // Options::logGC() is set.
+    Seconds takeSweepTime();
+
+private:
+    void sweepBlocks();
+
+    Heap& m_heap;
+    ParallelHelperClient m_helperClient;
+    Vector<MarkedBlock::Handle*> m_blocks;
+    Atomic<unsigned> m_nextBlockIndex;
+    Atomic<bool> m_shouldStop;
+
+    Lock m_sweepTimeLock;
+    Seconds m_sweepTime;
+};
+
+} // namespace JSC
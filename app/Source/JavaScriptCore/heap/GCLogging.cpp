@@ -31,6 +31,7 @@
 #include "HeapIterationScope.h"
 #include "JSCell.h"
 #include "JSCellInlines.h"
+#include <wtf/CommaPrinter.h>
 #include <wtf/PrintStream.h>
 
 namespace JSC {
@@ -50,6 +51,19 @@ const char* GCLogging::levelAsString(Level level)
     }
 }
 
+void GCLogging::SweepTimes::clear()
+{
+    for (Seconds& time : m_times)
+        time = Seconds();
+}
+
+void GCLogging::SweepTimes::dump(PrintStream& out) const
+{
+    CommaPrinter comma(" ");
+    for (unsigned i = 0; i < numberOfSweepPhases; ++i)
+        out.print(comma, static_cast<SweepPhase>(i), "=", m_times[i].milliseconds(), "ms");
+}
+
 } // namespace JSC
 
 namespace WTF {
@@ -72,5 +86,24 @@ void printInternal(PrintStream& out, JSC::GCLogging::Level level)
     }
 }
 
+void printInternal(PrintStream& out, JSC::GCLogging::SweepPhase phase)
+{
+    switch (phase) {
+    case JSC::GCLogging::SweepPhase::Concurrent:
+        out.print("Concurrent");
+        return;
+    case JSC::GCLogging::SweepPhase::Incremental:
+        out.print("Incremental");
+        return;
+    case JSC::GCLogging::SweepPhase::Allocation:
+        out.print("Allocation");
+        return;
+    case JSC::GCLogging::SweepPhase::Synchronous:
+        out.print("Synchronous");
+        return;
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+}
+
 } // namespace WTF
 
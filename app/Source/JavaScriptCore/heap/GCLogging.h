@@ -26,6 +26,11 @@
 #pragma once
 
 #include <wtf/Assertions.h>
+#include <wtf/Seconds.h>
+
+namespace WTF {
+class PrintStream;
+}
 
 namespace JSC {
 
@@ -41,6 +46,26 @@ public:
 
     static const char* levelAsString(Level);
     static void dumpObjectGraph(Heap*);
+
+    // Who did the sweeping between two collections. Only measured when logGC is set.
+    enum class SweepPhase : uint8_t {
+        Concurrent, // Building free lists on the heap helper threads.
+        Incremental, // IncrementalSweeper's timer.
+        Allocation, // The allocator sweeping a block it is about to allocate from.
+        Synchronous // Heap::sweepSynchronously().
+    };
+    static const unsigned numberOfSweepPhases = 4;
+
+    class SweepTimes {
+    public:
+        void add(SweepPhase phase, Seconds time) { m_times[static_cast<unsigned>(phase)] += time; }
+        Seconds operator[](SweepPhase phase) const { return m_times[static_cast<unsigned>(phase)]; }
+        void clear();
+        void dump(WTF::PrintStream&) const;
+
+    private:
+        Seconds m_times[numberOfSweepPhases];
+    };
 };
 
 typedef GCLogging::Level gcLogLevel;
@@ -49,8 +74,7 @@ typedef GCLogging::Level gcLogLevel;
 
 namespace WTF {
 
-class PrintStream;
-
 void printInternal(PrintStream&, JSC::GCLogging::Level);
+void printInternal(PrintStream&, JSC::GCLogging::SweepPhase);
 
 } // namespace WTF
@@ -24,6 +24,7 @@
 #include "CodeBlock.h"
 #include "CodeBlockSetInlines.h"
 #include "CollectingScope.h"
+#include "ConcurrentSweeper.h"
 #include "ConservativeRoots.h"
 #include "DFGWorklistInlines.h"
 #include "EdenGCActivityCallback.h"
@@ -95,9 +96,9 @@ double maxPauseMS(double thisPauseMS)
     return maxPauseMS;
 }
 
-size_t minHeapSize(HeapType heapType, size_t ramSize)
+size_t minHeapSize(HeapType heapType, size_t ramSize, HeapGrowthPolicy growthPolicy = HeapGrowthPolicy::Default)
 {
-    if (heapType == LargeHeap) {
+    if (heapType == LargeHeap && growthPolicy != HeapGrowthPolicy::Footprint) {
         double result = min(
             static_cast<double>(Options::largeHeapSize()),
             ramSize * Options::smallHeapRAMFraction());
@@ -106,8 +107,16 @@ size_t minHeapSize(HeapType heapType, size_t ramSize)
     return Options::smallHeapSize();
 }
 
-size_t proportionalHeapSize(size_t heapSize, size_t ramSize)
+size_t proportionalHeapSize(size_t heapSize, size_t ramSize, HeapGrowthPolicy growthPolicy)
 {
+    switch (growthPolicy) {
+    case HeapGrowthPolicy::Throughput:
+        return Options::smallHeapGrowthFactor() * heapSize;
+    case HeapGrowthPolicy::Footprint:
+        return Options::largeHeapGrowthFactor() * heapSize;
+    case HeapGrowthPolicy::Default:
+        break;
+    }
     if (heapSize < ramSize * Options::smallHeapRAMFraction())
         return Options::smallHeapGrowthFactor() * heapSize;
     if (heapSize < ramSize * Options::mediumHeapRAMFraction())
@@ -287,6 +296,7 @@ Heap::Heap(VM* vm, HeapType heapType)
     , m_sharedCollectorMarkStack(std::make_unique<MarkStackArray>())
     , m_sharedMutatorMarkStack(std::make_unique<MarkStackArray>())
     , m_helperClient(&heapHelperPool())
+    , m_concurrentSweeper(std::make_unique<ConcurrentSweeper>(*this))
     , m_threadLock(Box<Lock>::create())
     , m_threadCondition(AutomaticThreadCondition::create())
 {
@@ -408,6 +418,7 @@ void Heap::lastChanceToFinalize()
     if (Options::logGC())
         dataLog("5 ");
     
+    m_concurrentSweeper->stopSweeping();
     m_arrayBuffers.lastChanceToFinalize();
     m_codeBlocks->lastChanceToFinalize(*m_vm);
     m_objectSpace.stopAllocating();
@@ -896,16 +907,17 @@ void Heap::addToRememberedSet(const JSCell* constCell)
 
 void Heap::sweepSynchronously()
 {
-    double before = 0;
+    MonotonicTime before;
     if (Options::logGC()) {
         dataLog("Full sweep: ", capacity() / 1024, "kb ");
-        before = currentTimeMS();
+        before = MonotonicTime::now();
     }
     m_objectSpace.sweep();
     m_objectSpace.shrink();
     if (Options::logGC()) {
-        double after = currentTimeMS();
-        dataLog("=> ", capacity() / 1024, "kb, ", after - before, "ms");
+        Seconds elapsed = MonotonicTime::now() - before;
+        m_sweepTimes.add(GCLogging::SweepPhase::Synchronous, elapsed);
+        dataLog("=> ", capacity() / 1024, "kb, ", elapsed.milliseconds(), "ms");
     }
 }
 
@@ -1085,8 +1097,15 @@ NEVER_INLINE bool Heap::runBeginPhase(GCConductor conn)
         scope = m_requests.first();
     }
         
-    if (Options::logGC())
-        dataLog("[GC<", RawPointer(this), ">: START ", gcConductorShortName(conn), " ", capacity() / 1024, "kb ");
+    // The free lists that the helpers built are only good until marking changes the mark bits,
+    // and marking needs the helpers.
+    m_concurrentSweeper->stopSweeping();
+    
+    if (Options::logGC()) {
+        m_sweepTimes.add(GCLogging::SweepPhase::Concurrent, m_concurrentSweeper->takeSweepTime());
+        dataLog("[GC<", RawPointer(this), ">: START ", gcConductorShortName(conn), " ", capacity() / 1024, "kb sweep(", m_sweepTimes, ") ");
+        m_sweepTimes.clear();
+    }
 
     m_beforeGC = MonotonicTime::now();
 
@@ -1355,6 +1374,7 @@ NEVER_INLINE bool Heap::runEndPhase(GCConductor conn)
     m_codeBlocks->clearCurrentlyExecuting();
         
     m_objectSpace.prepareForAllocation();
+    m_concurrentSweeper->startSweeping();
     updateAllocationLimits();
 
     didFinishCollection();
@@ -1918,6 +1938,13 @@ void Heap::finalize()
     if (Options::sweepSynchronously())
         sweepSynchronously();
 
+    if (std::optional<HeapLimit> exceededHeapLimit = std::exchange(m_exceededHeapLimit, std::nullopt)) {
+        if (Options::logGC())
+            dataLog("heap limit callback (", *exceededHeapLimit, ") ");
+        if (m_heapLimitCallback)
+            m_heapLimitCallback(*exceededHeapLimit, m_sizeAfterLastFullCollect);
+    }
+
     if (Options::logGC()) {
         MonotonicTime after = MonotonicTime::now();
         dataLog((after - before).milliseconds(), "ms]\n");
@@ -2062,6 +2089,9 @@ void Heap::notifyIncrementalSweeper()
 void Heap::updateAllocationLimits()
 {
     static const bool verbose = false;
+
+    // This may run on the collector thread while the mutator changes the budget.
+    HeapBudget budget = this->budget();
     
     if (verbose) {
         dataLog("\n");
@@ -2095,9 +2125,14 @@ void Heap::updateAllocationLimits()
         // To avoid pathological GC churn in very small and very large heaps, we set
         // the new allocation limit based on the current size of the heap, with a
         // fixed minimum.
-        m_maxHeapSize = max(minHeapSize(m_heapType, m_ramSize), proportionalHeapSize(currentHeapSize, m_ramSize));
+        m_maxHeapSize = max(minHeapSize(m_heapType, m_ramSize, budget.growthPolicy), proportionalHeapSize(currentHeapSize, m_ramSize, budget.growthPolicy));
+        m_maxHeapSize = min(m_maxHeapSize, budgetedMaxHeapSize(budget, currentHeapSize));
         if (verbose)
             dataLog("Full: maxHeapSize = ", m_maxHeapSize, "\n");
+        if (budget.hardLimit && currentHeapSize > budget.hardLimit)
+            m_exceededHeapLimit = HeapLimit::Hard;
+        else if (budget.softLimit && currentHeapSize > budget.softLimit)
+            m_exceededHeapLimit = HeapLimit::Soft;
         m_maxEdenSize = m_maxHeapSize - currentHeapSize;
         if (verbose)
             dataLog("Full: maxEdenSize = ", m_maxEdenSize, "\n");
@@ -2123,6 +2158,7 @@ void Heap::updateAllocationLimits()
             m_shouldDoFullCollection = true;
         // This seems suspect at first, but what it does is ensure that the nursery size is fixed.
         m_maxHeapSize += currentHeapSize - m_sizeAfterLastCollect;
+        m_maxHeapSize = min(m_maxHeapSize, budgetedMaxHeapSize(budget, currentHeapSize));
         if (verbose)
             dataLog("Eden: maxHeapSize = ", m_maxHeapSize, "\n");
         m_maxEdenSize = m_maxHeapSize - currentHeapSize;
@@ -2139,8 +2175,53 @@ void Heap::updateAllocationLimits()
         dataLog("sizeAfterLastCollect = ", m_sizeAfterLastCollect, "\n");
     m_bytesAllocatedThisCycle = 0;
 
-    if (Options::logGC())
-        dataLog("=> ", currentHeapSize / 1024, "kb, ");
+    if (budget.growthLimit() && currentHeapSize > budget.growthLimit()) {
+        // Only a full collection can get us back under budget.
+        m_shouldDoFullCollection = true;
+    }
+
+    if (Options::logGC()) {
+        dataLog("=> ", currentHeapSize / 1024, "kb");
+        if (budget.softLimit || budget.hardLimit || budget.growthPolicy != HeapGrowthPolicy::Default) {
+            dataLog(" (", budget.growthPolicy, " growth to ", m_maxHeapSize / 1024, "kb");
+            if (budget.softLimit)
+                dataLog(", soft limit ", budget.softLimit / 1024, "kb");
+            if (budget.hardLimit)
+                dataLog(", hard limit ", budget.hardLimit / 1024, "kb");
+            if (m_exceededHeapLimit)
+                dataLog(", over ", *m_exceededHeapLimit, " limit");
+            dataLog(")");
+        }
+        dataLog(", ");
+    }
+}
+
+size_t Heap::budgetedMaxHeapSize(const HeapBudget& budget, size_t currentHeapSize)
+{
+    size_t growthLimit = budget.growthLimit();
+    if (!growthLimit)
+        return std::numeric_limits<size_t>::max();
+    // Once the live heap is over budget, still let the mutator allocate a little between
+    // collections. Otherwise we would collect on every allocation.
+    return max(growthLimit, currentHeapSize + Options::smallHeapSize());
+}
+
+HeapBudget Heap::budget() const
+{
+    auto locker = holdLock(*m_threadLock);
+    return m_budget;
+}
+
+void Heap::setBudget(const HeapBudget& budget)
+{
+    // The collector thread reads the budget when it updates the allocation limits.
+    auto locker = holdLock(*m_threadLock);
+    m_budget = budget;
+}
+
+void Heap::setHeapLimitCallback(HeapLimitCallback&& callback)
+{
+    m_heapLimitCallback = WTFMove(callback);
 }
 
 void Heap::didFinishCollection()
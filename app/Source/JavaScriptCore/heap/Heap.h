@@ -30,6 +30,7 @@
 #include "GCIncomingRefCountedSet.h"
 #include "HandleSet.h"
 #include "HandleStack.h"
+#include "HeapBudget.h"
 #include "HeapObserver.h"
 #include "ListableHandler.h"
 #include "MarkedBlock.h"
@@ -65,6 +66,7 @@ class GCAwareJITStubRoutine;
 class Heap;
 class HeapProfiler;
 class HeapVerifier;
+class ConcurrentSweeper;
 class IncrementalSweeper;
 class JITStubRoutine;
 class JITStubRoutineSet;
@@ -146,6 +148,9 @@ public:
     JS_EXPORT_PRIVATE void setGarbageCollectionTimerEnabled(bool);
 
     JS_EXPORT_PRIVATE IncrementalSweeper* sweeper();
+    
+    // Only kept up to date when Options::logGC() is set.
+    GCLogging::SweepTimes& sweepTimes() { return m_sweepTimes; }
 
     void addObserver(HeapObserver* observer) { m_observers.append(observer); }
     void removeObserver(HeapObserver* observer) { m_observers.removeFirst(observer); }
@@ -243,6 +248,11 @@ public:
     size_t sizeBeforeLastFullCollection() const { return m_sizeBeforeLastFullCollect; }
     size_t sizeAfterLastFullCollection() const { return m_sizeAfterLastFullCollect; }
 
+    // The budget takes effect at the end of the next collection.
+    JS_EXPORT_PRIVATE HeapBudget budget() const;
+    JS_EXPORT_PRIVATE void setBudget(const HeapBudget&);
+    JS_EXPORT_PRIVATE void setHeapLimitCallback(HeapLimitCallback&&);
+
     void deleteAllCodeBlocks(DeleteAllCodeEffort);
     void deleteAllUnlinkedCodeBlocks(DeleteAllCodeEffort);
 
@@ -478,6 +488,7 @@ private:
     void deleteUnmarkedCompiledCode();
     JS_EXPORT_PRIVATE void addToRememberedSet(const JSCell*);
     void updateAllocationLimits();
+    size_t budgetedMaxHeapSize(const HeapBudget&, size_t currentHeapSize);
     void didFinishCollection();
     void resumeCompilerThreads();
     void gatherExtraHeapSnapshotData(HeapProfiler&);
@@ -530,6 +541,10 @@ private:
     size_t m_totalBytesVisited;
     size_t m_totalBytesVisitedThisCycle;
     double m_incrementBalance { 0 };
+
+    HeapBudget m_budget; // Guarded by m_threadLock.
+    HeapLimitCallback m_heapLimitCallback;
+    std::optional<HeapLimit> m_exceededHeapLimit;
     
     std::optional<CollectionScope> m_collectionScope;
     std::optional<CollectionScope> m_lastCollectionScope;
@@ -628,6 +643,8 @@ private:
     ListableHandler<UnconditionalFinalizer>::List m_unconditionalFinalizers;
 
     ParallelHelperClient m_helperClient;
+    std::unique_ptr<ConcurrentSweeper> m_concurrentSweeper;
+    GCLogging::SweepTimes m_sweepTimes;
 
 #if ENABLE(RESOURCE_USAGE)
     size_t m_blockBytesAllocated { 0 };
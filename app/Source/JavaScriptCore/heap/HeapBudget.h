@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <wtf/Function.h>
+
+namespace JSC {
+
+// How much a heap may grow between full collections, relative to its size after the last one.
+enum class HeapGrowthPolicy : uint8_t {
+    // Grow quickly while the heap is small compared to RAM, and more slowly as it gets larger.
+    Default,
+    // Always grow as fast as a small heap does. Fewer collections, more memory.
+    Throughput,
+    // Always grow as slowly as a large heap does, starting from the small heap size. More
+    // collections, less memory.
+    Footprint
+};
+
+enum class HeapLimit : uint8_t { Soft, Hard };
+
+// Lets an embedder that runs many VMs bound each one's heap. Sizes are in bytes, as measured
+// for collection scheduling: bytes visited plus reported extra memory. 0 means no limit.
+//
+// The heap never schedules its next collection past the soft limit, or past the hard limit if
+// there is no soft limit, and once it is over either, every collection is a full one. This
+// cannot stop a program from keeping more than that alive, so when a full collection leaves the
+// heap over a limit, the VM's heap limit callback is told. The embedder can then shed load, for
+// example by terminating scripts with the watchdog.
+struct HeapBudget {
+    size_t softLimit { 0 };
+    size_t hardLimit { 0 };
+    HeapGrowthPolicy growthPolicy { HeapGrowthPolicy::Default };
+
+    size_t growthLimit() const { return softLimit ? softLimit : hardLimit; }
+};
+
+// Called on the thread that holds the VM's lock, right after the collection, with the heap size
+// that collection left. It must not run JavaScript or allocate in the heap.
+typedef WTF::Function<void(HeapLimit, size_t heapSize)> HeapLimitCallback;
+
+const char* heapGrowthPolicyName(HeapGrowthPolicy);
+const char* heapLimitName(HeapLimit);
+
+} // namespace JSC
+
+namespace WTF {
+
+class PrintStream;
+
+void printInternal(PrintStream& out, JSC::HeapGrowthPolicy);
+void printInternal(PrintStream& out, JSC::HeapLimit);
+
+} // namespace WTF
@@ -30,6 +30,7 @@
 #include "Heap.h"
 #include "HeapProfiler.h"
 #include "HeapSnapshot.h"
+#include "HeapSnapshotStreamWriter.h"
 #include "JSCInlines.h"
 #include "JSCell.h"
 #include "PreventCollectionScope.h"
@@ -47,6 +48,12 @@ HeapSnapshotBuilder::HeapSnapshotBuilder(HeapProfiler& profiler)
 {
 }
 
+HeapSnapshotBuilder::HeapSnapshotBuilder(HeapProfiler& profiler, HeapSnapshotStreamWriter& streamWriter)
+    : m_profiler(profiler)
+    , m_streamWriter(&streamWriter)
+{
+}
+
 HeapSnapshotBuilder::~HeapSnapshotBuilder()
 {
 }
@@ -54,6 +61,13 @@ HeapSnapshotBuilder::~HeapSnapshotBuilder()
 void HeapSnapshotBuilder::buildSnapshot()
 {
     PreventCollectionScope preventCollectionScope(m_profiler.vm().heap);
+
+    if (m_streamWriter) {
+        m_profiler.setActiveSnapshotBuilder(this);
+        m_profiler.vm().heap.collectAllGarbage();
+        m_profiler.setActiveSnapshotBuilder(nullptr);
+        return;
+    }
     
     m_snapshot = std::make_unique<HeapSnapshot>(m_profiler.mostRecentSnapshot());
     {
@@ -71,6 +85,11 @@ void HeapSnapshotBuilder::appendNode(JSCell* cell)
     ASSERT(m_profiler.activeSnapshotBuilder() == this);
     ASSERT(Heap::isMarkedConcurrently(cell));
 
+    if (m_streamWriter) {
+        m_streamWriter->appendNode(cell);
+        return;
+    }
+
     if (hasExistingNodeForCell(cell))
         return;
 
@@ -88,6 +107,11 @@ void HeapSnapshotBuilder::appendEdge(JSCell* from, JSCell* to)
     if (from == to)
         return;
 
+    if (m_streamWriter) {
+        m_streamWriter->appendEdge(HeapSnapshotEdge(from, to));
+        return;
+    }
+
     std::lock_guard<Lock> lock(m_buildingEdgeMutex);
 
     m_edges.append(HeapSnapshotEdge(from, to));
@@ -98,6 +122,11 @@ void HeapSnapshotBuilder::appendPropertyNameEdge(JSCell* from, JSCell* to, Uniqu
     ASSERT(m_profiler.activeSnapshotBuilder() == this);
     ASSERT(to);
 
+    if (m_streamWriter) {
+        m_streamWriter->appendEdge(HeapSnapshotEdge(from, to, EdgeType::Property, propertyName));
+        return;
+    }
+
     std::lock_guard<Lock> lock(m_buildingEdgeMutex);
 
     m_edges.append(HeapSnapshotEdge(from, to, EdgeType::Property, propertyName));
@@ -108,6 +137,11 @@ void HeapSnapshotBuilder::appendVariableNameEdge(JSCell* from, JSCell* to, Uniqu
     ASSERT(m_profiler.activeSnapshotBuilder() == this);
     ASSERT(to);
 
+    if (m_streamWriter) {
+        m_streamWriter->appendEdge(HeapSnapshotEdge(from, to, EdgeType::Variable, variableName));
+        return;
+    }
+
     std::lock_guard<Lock> lock(m_buildingEdgeMutex);
 
     m_edges.append(HeapSnapshotEdge(from, to, EdgeType::Variable, variableName));
@@ -118,6 +152,11 @@ void HeapSnapshotBuilder::appendIndexEdge(JSCell* from, JSCell* to, uint32_t ind
     ASSERT(m_profiler.activeSnapshotBuilder() == this);
     ASSERT(to);
 
+    if (m_streamWriter) {
+        m_streamWriter->appendEdge(HeapSnapshotEdge(from, to, index));
+        return;
+    }
+
     std::lock_guard<Lock> lock(m_buildingEdgeMutex);
 
     m_edges.append(HeapSnapshotEdge(from, to, index));
@@ -35,6 +35,7 @@ namespace JSC {
 
 class HeapProfiler;
 class HeapSnapshot;
+class HeapSnapshotStreamWriter;
 class JSCell;
 
 struct HeapSnapshotNode {
@@ -102,6 +103,9 @@ class JS_EXPORT_PRIVATE HeapSnapshotBuilder {
     WTF_MAKE_FAST_ALLOCATED;
 public:
     HeapSnapshotBuilder(HeapProfiler&);
+    // Streams nodes and edges to the writer as they are found. The snapshot is not kept, so the
+    // profiler does not learn about it and json() has nothing to serialize.
+    HeapSnapshotBuilder(HeapProfiler&, HeapSnapshotStreamWriter&);
     ~HeapSnapshotBuilder();
 
     static unsigned nextAvailableObjectIdentifier;
@@ -129,6 +133,7 @@ private:
     bool hasExistingNodeForCell(JSCell*);
 
     HeapProfiler& m_profiler;
+    HeapSnapshotStreamWriter* m_streamWriter { nullptr };
 
     // SlotVisitors run in parallel.
     Lock m_buildingNodeMutex;
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HeapSnapshotStreamWriter.h"
+
+#include "JSCInlines.h"
+#include "JSCell.h"
+#include "VM.h"
+
+namespace JSC {
+
+static const char magic[] = "JSCHEAPS";
+static const unsigned deduplicatedEdgeNamesFlag = 1;
+
+HeapSnapshotStreamWriter::HeapSnapshotStreamWriter(VM& vm, FILE* file, EdgeNames edgeNames)
+    : m_vm(vm)
+    , m_file(file)
+    , m_edgeNames(edgeNames)
+{
+    Record header;
+    header.append(reinterpret_cast<const uint8_t*>(magic), sizeof(magic) - 1);
+    appendNumber(header, version);
+    appendNumber(header, edgeNames == EdgeNames::Deduplicate ? deduplicatedEdgeNamesFlag : 0);
+    write(header);
+}
+
+void HeapSnapshotStreamWriter::appendNumber(Record& record, uint64_t value)
+{
+    do {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        if (value)
+            byte |= 0x80;
+        record.append(byte);
+    } while (value);
+}
+
+unsigned HeapSnapshotStreamWriter::appendString(Record& record, const CString& string)
+{
+    unsigned index = m_nextStringIndex++;
+    record.append(static_cast<uint8_t>(Tag::String));
+    appendNumber(record, index);
+    appendNumber(record, string.length());
+    record.append(reinterpret_cast<const uint8_t*>(string.data()), string.length());
+    return index;
+}
+
+unsigned HeapSnapshotStreamWriter::classNameIndex(Record& record, const char* className)
+{
+    auto iterator = m_classNameIndexes.find(className);
+    if (iterator != m_classNameIndexes.end())
+        return iterator->value;
+    unsigned index = appendString(record, CString(className));
+    m_classNameIndexes.add(className, index);
+    return index;
+}
+
+unsigned HeapSnapshotStreamWriter::edgeNameIndex(Record& record, UniquedStringImpl* edgeName)
+{
+    if (m_edgeNames == EdgeNames::WriteEachTime)
+        return appendString(record, String(edgeName).utf8());
+
+    auto iterator = m_edgeNameIndexes.find(edgeName);
+    if (iterator != m_edgeNameIndexes.end())
+        return iterator->value;
+    unsigned index = appendString(record, String(edgeName).utf8());
+    m_edgeNameIndexes.add(edgeName, index);
+    return index;
+}
+
+void HeapSnapshotStreamWriter::write(const Record& record)
+{
+    if (m_didFail)
+        return;
+    if (fwrite(record.data(), 1, record.size(), m_file) != record.size())
+        m_didFail = true;
+}
+
+void HeapSnapshotStreamWriter::appendNode(JSCell* cell)
+{
+    // The mutator is stopped while the snapshot's collection runs, so the cell can be inspected
+    // here just as json() does after the collection.
+    const char* className = cell->classInfo(m_vm)->className;
+    size_t sizeInBytes = cell->estimatedSizeInBytes();
+    bool isInternal = false;
+    if (!cell->isString()) {
+        Structure* structure = cell->structure(m_vm);
+        isInternal = !structure || !structure->globalObject();
+    }
+
+    Record record;
+    auto locker = holdLock(m_lock);
+    unsigned classNameStringIndex = classNameIndex(record, className);
+    record.append(static_cast<uint8_t>(Tag::Node));
+    appendNumber(record, bitwise_cast<uintptr_t>(cell));
+    appendNumber(record, sizeInBytes);
+    appendNumber(record, classNameStringIndex);
+    appendNumber(record, isInternal);
+    write(record);
+    m_nodeCount++;
+}
+
+void HeapSnapshotStreamWriter::appendEdge(const HeapSnapshotEdge& edge)
+{
+    Record record;
+    auto locker = holdLock(m_lock);
+    uint64_t extraData = 0;
+    switch (edge.type) {
+    case EdgeType::Property:
+    case EdgeType::Variable:
+        extraData = edgeNameIndex(record, edge.u.name);
+        break;
+    case EdgeType::Index:
+        extraData = edge.u.index;
+        break;
+    case EdgeType::Internal:
+        break;
+    }
+    record.append(static_cast<uint8_t>(Tag::Edge));
+    appendNumber(record, bitwise_cast<uintptr_t>(edge.from.cell));
+    appendNumber(record, bitwise_cast<uintptr_t>(edge.to.cell));
+    appendNumber(record, static_cast<uint8_t>(edge.type));
+    appendNumber(record, extraData);
+    write(record);
+    m_edgeCount++;
+}
+
+bool HeapSnapshotStreamWriter::finish()
+{
+    auto locker = holdLock(m_lock);
+    Record record;
+    record.append(static_cast<uint8_t>(Tag::End));
+    appendNumber(record, m_nodeCount);
+    appendNumber(record, m_edgeCount);
+    write(record);
+    if (fflush(m_file))
+        m_didFail = true;
+
+    m_classNameIndexes.clear();
+    m_edgeNameIndexes.clear();
+    return !m_didFail;
+}
+
+} // namespace JSC
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "HeapSnapshotBuilder.h"
+#include <stdio.h>
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/text/CString.h>
+
+namespace JSC {
+
+class VM;
+
+// Writes a heap snapshot to a file while the collector walks the heap, instead of keeping every
+// node and edge until HeapSnapshotBuilder::json() serializes them. Only the string table is kept
+// in memory, so this works on heaps whose JSON would not fit. Scripts/convert-heap-snapshot.py
+// converts the file to the JSON format that json() produces and the Web Inspector reads.
+//
+// Stream Format:
+//
+//   "JSCHEAPS" <version> <flags> <record>...
+//
+//   Every number is an unsigned LEB128. Each record is a tag followed by its fields:
+//
+//     String (1):  <stringIndex>, <byteLength>, <UTF-8 bytes>
+//     Node (2):    <cell>, <sizeInBytes>, <classNameStringIndex>, <internal>
+//     Edge (3):    <fromCell>, <toCell>, <edgeTypeIndex>, <edgeExtraData>
+//     End (4):     <nodeCount>, <edgeCount>
+//
+// Notes:
+//
+//     <cell>, <fromCell>, <toCell>
+//       - the address of the cell, which is unique within one snapshot. 0 is <root>. The
+//         converter numbers the nodes in the order they appear.
+//
+//     <stringIndex>
+//       - a string is always written before the first record that refers to it.
+//
+//     <edgeExtraData>
+//       - as in the JSON format, except that Property and Variable edges refer to the string table.
+//
+//     <flags>
+//       - 1 if edge names are deduplicated. Otherwise each named edge is preceded by a fresh
+//         String record, and the writer keeps no table of edge names at all. Class names are
+//         always deduplicated, since there are few of them.
+//
+//     End
+//       - a stream without it was cut short, for example because the process died while writing.
+class HeapSnapshotStreamWriter {
+    WTF_MAKE_NONCOPYABLE(HeapSnapshotStreamWriter);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    static const unsigned version = 1;
+
+    enum class EdgeNames { Deduplicate, WriteEachTime };
+
+    // The writer does not take ownership of the file.
+    HeapSnapshotStreamWriter(VM&, FILE*, EdgeNames = EdgeNames::Deduplicate);
+
+    // These are called by SlotVisitors in parallel.
+    void appendNode(JSCell*);
+    void appendEdge(const HeapSnapshotEdge&);
+
+    // Writes the End record and flushes the file. Returns false if any write failed.
+    bool finish();
+
+    uint64_t nodeCount() const { return m_nodeCount; }
+    uint64_t edgeCount() const { return m_edgeCount; }
+
+private:
+    enum class Tag : uint8_t {
+        String = 1,
+        Node = 2,
+        Edge = 3,
+        End = 4,
+    };
+
+    typedef Vector<uint8_t, 64> Record;
+
+    static void appendNumber(Record&, uint64_t);
+    unsigned appendString(Record&, const CString&);
+    unsigned classNameIndex(Record&, const char*);
+    unsigned edgeNameIndex(Record&, UniquedStringImpl*);
+    void write(const Record&);
+
+    VM& m_vm;
+    FILE* m_file;
+    EdgeNames m_edgeNames;
+
+    Lock m_lock;
+    HashMap<const char*, unsigned> m_classNameIndexes;
+    HashMap<UniquedStringImpl*, unsigned> m_edgeNameIndexes;
+    unsigned m_nextStringIndex { 0 };
+    uint64_t m_nodeCount { 0 };
+    uint64_t m_edgeCount { 0 };
+    bool m_didFail { false };
+};
+
+} // namespace JSC
@@ -57,16 +57,23 @@ void IncrementalSweeper::doWork()
 
 void IncrementalSweeper::doSweep(double sweepBeginTime)
 {
+    bool didFinish = true;
     while (sweepNextBlock()) {
         double elapsedTime = WTF::monotonicallyIncreasingTime() - sweepBeginTime;
         if (elapsedTime < sweepTimeSlice)
             continue;
 
-        scheduleTimer();
-        return;
+        didFinish = false;
+        break;
     }
 
-    cancelTimer();
+    if (Options::logGC())
+        m_vm->heap.sweepTimes().add(GCLogging::SweepPhase::Incremental, Seconds(WTF::monotonicallyIncreasingTime() - sweepBeginTime));
+
+    if (didFinish)
+        cancelTimer();
+    else
+        scheduleTimer();
 }
 
 bool IncrementalSweeper::sweepNextBlock()
@@ -36,6 +36,7 @@
 #include "SuperSampler.h"
 #include "VM.h"
 #include <wtf/CurrentTime.h>
+#include <wtf/MonotonicTime.h>
 
 namespace JSC {
 
@@ -139,8 +140,15 @@ void* MarkedAllocator::tryAllocateIn(MarkedBlock::Handle* block)
     ASSERT(block);
     ASSERT(!block->isFreeListed());
     
+    MonotonicTime before;
+    if (UNLIKELY(Options::logGC()))
+        before = MonotonicTime::now();
+    
     FreeList freeList = block->sweep(MarkedBlock::Handle::SweepToFreeList);
     
+    if (UNLIKELY(Options::logGC()))
+        m_heap->sweepTimes().add(GCLogging::SweepPhase::Allocation, MonotonicTime::now() - before);
+    
     // It's possible to stumble on a completely full block. Marking tries to retire these, but
     // that algorithm is racy and may forget to do it sometimes.
     if (freeList.allocationWillFail()) {
@@ -89,6 +89,58 @@ MarkedBlock::MarkedBlock(VM& vm, Handle& handle)
         dataLog(RawPointer(this), ": Allocated.\n");
 }
 
+bool MarkedBlock::Handle::startConcurrentSweep()
+{
+    ASSERT(!space()->isMarking());
+    ASSERT(m_concurrentSweepState == ConcurrentSweepState::None);
+    
+    // These are the blocks that sweep() would hand to the NotEmpty, MarksNotStale specialization
+    // of specializedSweep(). That is the one that gives the helpers a real list to build. Blocks
+    // that are full do not get one, since the allocator will not look at them.
+    if (m_attributes.destruction == NeedsDestruction
+        || m_isFreeListed
+        || !m_allocator->isCanAllocateButNotEmpty(NoLockingNecessary, this)
+        || emptyMode() != NotEmpty
+        || scribbleMode() != DontScribble
+        || newlyAllocatedMode() != DoesNotHaveNewlyAllocated
+        || marksMode() != MarksNotStale)
+        return false;
+    
+    m_concurrentSweepState = ConcurrentSweepState::Pending;
+    return true;
+}
+
+void MarkedBlock::Handle::sweepToFreeListConcurrently()
+{
+    MarkedBlock& block = this->block();
+    auto locker = holdLock(block.m_lock);
+    if (m_concurrentSweepState != ConcurrentSweepState::Pending)
+        return;
+    
+    // Same as the slow path of specializedSweep() for this kind of block, except that it leaves
+    // the allocator's bits alone. The mutator sets those when it takes the list.
+    FreeCell* head = nullptr;
+    size_t count = 0;
+    for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell) {
+        if (block.m_marks.get(i))
+            continue;
+        FreeCell* freeCell = reinterpret_cast_ptr<FreeCell*>(&block.atoms()[i]);
+        freeCell->next = head;
+        head = freeCell;
+        ++count;
+    }
+    
+    m_concurrentlySweptFreeList = FreeList::list(head, count * cellSize());
+    m_concurrentSweepState = ConcurrentSweepState::Done;
+}
+
+void MarkedBlock::Handle::cancelConcurrentSweep()
+{
+    auto locker = holdLock(block().m_lock);
+    m_concurrentSweepState = ConcurrentSweepState::None;
+    m_concurrentlySweptFreeList = FreeList();
+}
+
 void MarkedBlock::Handle::unsweepWithNoNewlyAllocated()
 {
     RELEASE_ASSERT(m_isFreeListed);
@@ -425,6 +477,17 @@ FreeList MarkedBlock::Handle::sweep(SweepMode sweepMode)
     
     ASSERT(!m_allocator->isAllocated(NoLockingNecessary, this));
     
+    if (sweepMode == SweepToFreeList && m_attributes.destruction == DoesNotNeedDestruction) {
+        // If a helper thread has already built our free list, take it. Otherwise make sure that
+        // no helper starts on this block while we sweep it ourselves.
+        auto locker = holdLock(block().m_lock);
+        ConcurrentSweepState concurrentSweepState = std::exchange(m_concurrentSweepState, ConcurrentSweepState::None);
+        if (concurrentSweepState == ConcurrentSweepState::Done) {
+            setIsFreeListed();
+            return std::exchange(m_concurrentlySweptFreeList, FreeList());
+        }
+    }
+    
     if (space()->isMarking())
         block().m_lock.lock();
     
@@ -135,6 +135,14 @@ public:
         
         void unsweepWithNoNewlyAllocated();
         
+        // ConcurrentSweeper calls these. startConcurrentSweep() is called while the world is
+        // stopped, and returns true if this block can have its free list built on a helper thread.
+        // sweepToFreeListConcurrently() builds it, unless the mutator has already swept this block.
+        // The list is picked up by sweep(SweepToFreeList).
+        bool startConcurrentSweep();
+        void sweepToFreeListConcurrently();
+        void cancelConcurrentSweep();
+        
         void zap(const FreeList&);
         
         void shrink();
@@ -220,6 +228,8 @@ public:
         
         void setIsFreeListed();
         
+        enum class ConcurrentSweepState : uint8_t { None, Pending, Done };
+        
         MarkedBlock::Handle* m_prev;
         MarkedBlock::Handle* m_next;
             
@@ -230,6 +240,10 @@ public:
             
         AllocatorAttributes m_attributes;
         bool m_isFreeListed { false };
+        
+        // Guarded by the block's lock.
+        ConcurrentSweepState m_concurrentSweepState { ConcurrentSweepState::None };
+        FreeList m_concurrentlySweptFreeList;
             
         MarkedAllocator* m_allocator { nullptr };
         size_t m_index { std::numeric_limits<size_t>::max() };
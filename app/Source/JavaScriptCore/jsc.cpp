@@ -28,6 +28,7 @@
 #include "BuiltinNames.h"
 #include "ButterflyInlines.h"
 #include "CodeBlock.h"
+#include "CodeCache.h"
 #include "Completion.h"
 #include "ConfigFile.h"
 #include "DOMJITGetterSetter.h"
@@ -39,6 +40,7 @@
 #include "GetterSetter.h"
 #include "HeapProfiler.h"
 #include "HeapSnapshotBuilder.h"
+#include "HeapSnapshotStreamWriter.h"
 #include "InitializeThreading.h"
 #include "Interpreter.h"
 #include "JIT.h"
@@ -57,10 +59,12 @@
 #include "JSString.h"
 #include "JSTypedArrays.h"
 #include "JSWebAssemblyCallee.h"
+#include "JSWebAssemblyModule.h"
 #include "LLIntData.h"
 #include "LLIntThunks.h"
 #include "ObjectConstructor.h"
 #include "ParserError.h"
+#include "ProfileCache.h"
 #include "ProfilerDatabase.h"
 #include "ProtoCallFrame.h"
 #include "ReleaseHeapAccessScope.h"
@@ -1018,6 +1022,7 @@ static EncodedJSValue JSC_HOST_CALL functionJSCStack(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionGCAndSweep(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionFullGC(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionEdenGC(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionSaveProfileCache(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionForceGCSlowPaths(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionHeapSize(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionAddressOf(ExecState*);
@@ -1068,6 +1073,7 @@ static EncodedJSValue JSC_HOST_CALL functionLoadModule(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionCheckModuleSyntax(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionPlatformSupportsSamplingProfiler(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionGenerateHeapSnapshot(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionWriteHeapSnapshot(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionResetSuperSamplerState(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionEnsureArrayStorage(ExecState*);
 #if ENABLE(SAMPLING_PROFILER)
@@ -1079,6 +1085,7 @@ static EncodedJSValue JSC_HOST_CALL functionMaxArguments(ExecState*);
 
 #if ENABLE(WEBASSEMBLY)
 static EncodedJSValue JSC_HOST_CALL functionTestWasmModuleFunctions(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionCompileWasmModuleStreaming(ExecState*);
 #endif
 
 #if ENABLE(SAMPLING_FLAGS)
@@ -1244,6 +1251,7 @@ protected:
         addFunction(vm, "gc", functionGCAndSweep, 0);
         addFunction(vm, "fullGC", functionFullGC, 0);
         addFunction(vm, "edenGC", functionEdenGC, 0);
+        addFunction(vm, "saveProfileCache", functionSaveProfileCache, 0);
         addFunction(vm, "forceGCSlowPaths", functionForceGCSlowPaths, 0);
         addFunction(vm, "gcHeapSize", functionHeapSize, 0);
         addFunction(vm, "addressOf", functionAddressOf, 1);
@@ -1339,6 +1347,7 @@ protected:
 
         addFunction(vm, "platformSupportsSamplingProfiler", functionPlatformSupportsSamplingProfiler, 0);
         addFunction(vm, "generateHeapSnapshot", functionGenerateHeapSnapshot, 0);
+        addFunction(vm, "writeHeapSnapshot", functionWriteHeapSnapshot, 2);
         addFunction(vm, "resetSuperSamplerState", functionResetSuperSamplerState, 0);
         addFunction(vm, "ensureArrayStorage", functionEnsureArrayStorage, 0);
 #if ENABLE(SAMPLING_PROFILER)
@@ -1350,6 +1359,7 @@ protected:
 
 #if ENABLE(WEBASSEMBLY)
         addFunction(vm, "testWasmModuleFunctions", functionTestWasmModuleFunctions, 0);
+        addFunction(vm, "compileWasmModuleStreaming", functionCompileWasmModuleStreaming, 2);
 #endif
 
         if (!arguments.isEmpty()) {
@@ -2023,6 +2033,14 @@ EncodedJSValue JSC_HOST_CALL functionEdenGC(ExecState* exec)
     return JSValue::encode(jsNumber(exec->heap()->sizeAfterLastEdenCollection()));
 }
 
+EncodedJSValue JSC_HOST_CALL functionSaveProfileCache(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    JSLockHolder lock(vm);
+    ProfileCache* profileCache = vm.profileCache();
+    return JSValue::encode(jsBoolean(profileCache && profileCache->save()));
+}
+
 EncodedJSValue JSC_HOST_CALL functionForceGCSlowPaths(ExecState*)
 {
     // It's best for this to be the first thing called in the 
@@ -2741,8 +2759,11 @@ EncodedJSValue JSC_HOST_CALL functionFailNextNewCodeBlock(ExecState* exec)
     return JSValue::encode(jsUndefined());
 }
 
-EncodedJSValue JSC_HOST_CALL functionQuit(ExecState*)
+EncodedJSValue JSC_HOST_CALL functionQuit(ExecState* exec)
 {
+    if (ProfileCache* profileCache = exec->vm().profileCache())
+        profileCache->save();
+
     jscExit(EXIT_SUCCESS);
 
 #if COMPILER(MSVC)
@@ -2990,6 +3011,30 @@ EncodedJSValue JSC_HOST_CALL functionGenerateHeapSnapshot(ExecState* exec)
     return result;
 }
 
+// writeHeapSnapshot(path, [deduplicateEdgeNames = true])
+// Streams a heap snapshot to path in the HeapSnapshotStreamWriter format. Returns true on success.
+EncodedJSValue JSC_HOST_CALL functionWriteHeapSnapshot(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    JSLockHolder lock(vm);
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    String fileName = exec->argument(0).toWTFString(exec);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+    bool deduplicateEdgeNames = exec->argument(1).isUndefined() || exec->argument(1).toBoolean(exec);
+
+    FILE* file = fopen(fileName.utf8().data(), "wb");
+    if (!file)
+        return JSValue::encode(throwException(exec, scope, createError(exec, ASCIILiteral("Could not open file."))));
+
+    HeapSnapshotStreamWriter writer(vm, file, deduplicateEdgeNames ? HeapSnapshotStreamWriter::EdgeNames::Deduplicate : HeapSnapshotStreamWriter::EdgeNames::WriteEachTime);
+    HeapSnapshotBuilder snapshotBuilder(vm.ensureHeapProfiler(), writer);
+    snapshotBuilder.buildSnapshot();
+    bool success = writer.finish();
+    success &= !fclose(file);
+    return JSValue::encode(jsBoolean(success));
+}
+
 EncodedJSValue JSC_HOST_CALL functionResetSuperSamplerState(ExecState*)
 {
     resetSuperSamplerState();
@@ -3164,7 +3209,7 @@ static EncodedJSValue JSC_HOST_CALL functionTestWasmModuleFunctions(ExecState* e
                 lastIndex = calleeIndex;
             });
     }
-    std::unique_ptr<Wasm::ModuleInformation> moduleInformation = plan.takeModuleInformation();
+    Ref<Wasm::ModuleInformation> moduleInformation = plan.takeModuleInformation();
     RELEASE_ASSERT(!moduleInformation->memory);
 
     for (uint32_t i = 0; i < functionCount; ++i) {
@@ -3201,6 +3246,38 @@ static EncodedJSValue JSC_HOST_CALL functionTestWasmModuleFunctions(ExecState* e
     return encodedJSUndefined();
 }
 
+// compileWasmModuleStreaming(JSArrayBufferView source, number chunkSize) compiles the source as if it
+// arrived chunkSize bytes at a time, and returns the WebAssembly.Module.
+static EncodedJSValue JSC_HOST_CALL functionCompileWasmModuleStreaming(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (!Options::useWebAssembly())
+        return throwVMTypeError(exec, scope, ASCIILiteral("compileWasmModuleStreaming should only be called if the useWebAssembly option is set"));
+
+    JSArrayBufferView* source = jsDynamicCast<JSArrayBufferView*>(vm, exec->argument(0));
+    if (!source)
+        return throwVMTypeError(exec, scope, ASCIILiteral("compileWasmModuleStreaming expects an ArrayBufferView"));
+    uint32_t chunkSize = exec->argument(1).toUInt32(exec);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+    if (!chunkSize)
+        return throwVMRangeError(exec, scope, ASCIILiteral("compileWasmModuleStreaming expects a chunk size of at least 1"));
+
+    const uint8_t* bytes = static_cast<uint8_t*>(source->vector());
+    size_t length = source->length();
+
+    Wasm::Plan plan(&vm);
+    for (size_t offset = 0; offset < length; offset += chunkSize) {
+        if (!plan.addBytes(bytes + offset, std::min<size_t>(chunkSize, length - offset)))
+            break;
+    }
+    plan.finishStreaming();
+
+    scope.release();
+    return JSValue::encode(JSWebAssemblyModule::create(vm, exec, exec->lexicalGlobalObject()->WebAssemblyModuleStructure(), plan));
+}
+
 #endif // ENABLE(WEBASSEBLY)
 
 // Use SEH for Release builds only to get rid of the crash report dialog
@@ -3727,6 +3804,13 @@ int runJSC(CommandLine options, const Func& func)
     vm.drainMicrotasks();
     result = success && (test262AsyncTest == test262AsyncPassed) ? 0 : 3;
 
+    if (Options::bytecodeCachePath())
+        vm.codeCache()->writeCachedBytecodes(vm);
+
+    // The VM is leaked, so it never gets to save its profiles itself.
+    if (ProfileCache* profileCache = vm.profileCache())
+        profileCache->save();
+
     if (options.m_exitCode)
         printf("jsc exiting %d\n", result);
 
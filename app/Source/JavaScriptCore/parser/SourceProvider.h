@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include "CachedBytecode.h"
 #include "SourceOrigin.h"
 #include <wtf/RefCounted.h>
 #include <wtf/text/TextPosition.h>
@@ -77,6 +78,16 @@ namespace JSC {
         void setSourceURLDirective(const String& sourceURL) { m_sourceURLDirective = sourceURL; }
         void setSourceMappingURLDirective(const String& sourceMappingURL) { m_sourceMappingURLDirective = sourceMappingURL; }
 
+        // Providers that can keep serialized bytecode around, for instance next to a cached network
+        // resource, override these. The CodeCache validates anything returned by cachedBytecode()
+        // against the source text, so a stale blob is harmless. Encoding freshly generated bytecode
+        // costs a walk over the whole program, so the CodeCache only hands it to providers that
+        // return true from shouldStoreCachedBytecode(), because they persist it somewhere.
+        virtual bool supportsCachedBytecode() const { return false; }
+        virtual bool shouldStoreCachedBytecode() const { return false; }
+        virtual RefPtr<CachedBytecode> cachedBytecode() const { return nullptr; }
+        virtual void updateCachedBytecode(Ref<CachedBytecode>&&) { }
+
     private:
         JS_EXPORT_PRIVATE void getID();
 
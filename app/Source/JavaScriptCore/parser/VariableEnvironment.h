@@ -57,6 +57,9 @@ public:
     ALWAYS_INLINE void clearIsVar() { m_bits &= ~IsVar; }
 
 private:
+    friend class BytecodeCacheReader;
+    friend class BytecodeCacheWriter;
+
     enum Traits : uint16_t {
         IsCaptured = 1 << 0,
         IsConst = 1 << 1,
@@ -105,6 +108,7 @@ public:
     void markVariableAsCaptured(const RefPtr<UniquedStringImpl>& identifier);
     void markAllVariablesAsCaptured();
     bool hasCapturedVariables() const;
+    bool isEverythingCaptured() const { return m_isEverythingCaptured; }
     bool captures(UniquedStringImpl* identifier) const;
     void markVariableAsImported(const RefPtr<UniquedStringImpl>& identifier);
     void markVariableAsExported(const RefPtr<UniquedStringImpl>& identifier);
@@ -28,6 +28,7 @@
 #include "ArrayConstructor.h"
 #include "BuiltinNames.h"
 #include "ButterflyInlines.h"
+#include "CachedCall.h"
 #include "CodeBlock.h"
 #include "Error.h"
 #include "GetterSetter.h"
@@ -45,6 +46,7 @@
 #include "StringRecursionChecker.h"
 #include <algorithm>
 #include <wtf/Assertions.h>
+#include <wtf/TimSort.h>
 
 namespace JSC {
 
@@ -1328,6 +1330,269 @@ EncodedJSValue JSC_HOST_CALL arrayProtoPrivateFuncAppendMemcpy(ExecState* exec)
     return JSValue::encode(jsUndefined());
 }
 
+// Compares the decimal representations of two integers, which is what the default comparator
+// does, without creating the strings.
+static bool int32StringLessThan(int32_t a, int32_t b)
+{
+    if (a == b)
+        return false;
+    // '-' sorts before all digits.
+    if ((a < 0) != (b < 0))
+        return a < 0;
+
+    auto writeDigits = [] (int32_t value, LChar* end) -> LChar* {
+        uint32_t magnitude = value < 0 ? -static_cast<uint32_t>(value) : value;
+        LChar* start = end;
+        do {
+            *--start = '0' + magnitude % 10;
+            magnitude /= 10;
+        } while (magnitude);
+        return start;
+    };
+
+    LChar aBuffer[10];
+    LChar bBuffer[10];
+    LChar* aDigits = writeDigits(a, aBuffer + 10);
+    LChar* bDigits = writeDigits(b, bBuffer + 10);
+    unsigned aLength = aBuffer + 10 - aDigits;
+    unsigned bLength = bBuffer + 10 - bDigits;
+    if (int result = memcmp(aDigits, bDigits, std::min(aLength, bLength)))
+        return result < 0;
+    return aLength < bLength;
+}
+
+// Sorts with a user comparator. If the comparator throws, the remaining comparisons return false
+// without calling it, and the caller leaves the array alone.
+template<typename Element, typename ToJSValue>
+static void sortWithComparator(ExecState* exec, Vector<Element>& elements, JSValue comparator, CallType callType, const CallData& callData, const ToJSValue& toJSValue)
+{
+    VM& vm = exec->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    auto isNegative = [&] (JSValue result) -> bool {
+        if (UNLIKELY(scope.exception()))
+            return false;
+        double number = result.toNumber(exec);
+        return !scope.exception() && number < 0;
+    };
+
+    if (callType == CallType::JS) {
+        CachedCall cachedCall(exec, jsCast<JSFunction*>(comparator), 2);
+        RETURN_IF_EXCEPTION(scope, void());
+        cachedCall.setThis(jsUndefined());
+        timSort(elements.data(), elements.size(), [&] (const Element& a, const Element& b) -> bool {
+            if (UNLIKELY(scope.exception()))
+                return false;
+            cachedCall.clearArguments();
+            cachedCall.appendArgument(toJSValue(a));
+            cachedCall.appendArgument(toJSValue(b));
+            return isNegative(cachedCall.call());
+        });
+        return;
+    }
+
+    MarkedArgumentBuffer arguments;
+    timSort(elements.data(), elements.size(), [&] (const Element& a, const Element& b) -> bool {
+        if (UNLIKELY(scope.exception()))
+            return false;
+        arguments.clear();
+        arguments.append(toJSValue(a));
+        arguments.append(toJSValue(b));
+        return isNegative(call(exec, comparator, callType, callData, jsUndefined(), arguments));
+    });
+}
+
+struct StringSortEntry {
+    String key;
+    JSValue value;
+};
+
+// Writes back the result of a sort: the sorted values, then undefineds, then holes. If the array
+// still has the storage we read from, we write to it directly. Otherwise a comparator or toString
+// changed it, and we store the way the JS implementation would.
+template<typename ValueAt>
+static void writeSortedValues(ExecState* exec, JSArray* array, IndexingType indexingType, Butterfly* butterfly, unsigned length, unsigned valueCount, unsigned undefinedCount, const ValueAt& valueAt)
+{
+    VM& vm = exec->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (array->indexingType() == indexingType && array->butterfly() == butterfly && butterfly->publicLength() == length) {
+        switch (indexingType) {
+        case ArrayWithInt32:
+            for (unsigned i = 0; i < valueCount; ++i)
+                butterfly->contiguousInt32()[i].setWithoutWriteBarrier(valueAt(i));
+            for (unsigned i = valueCount; i < length; ++i)
+                butterfly->contiguousInt32()[i].clear();
+            return;
+        case ArrayWithDouble:
+            for (unsigned i = 0; i < valueCount; ++i)
+                butterfly->contiguousDouble()[i] = valueAt(i).asNumber();
+            for (unsigned i = valueCount; i < length; ++i)
+                butterfly->contiguousDouble()[i] = PNaN;
+            return;
+        case ArrayWithContiguous:
+            for (unsigned i = 0; i < valueCount; ++i)
+                butterfly->contiguous()[i].set(vm, array, valueAt(i));
+            for (unsigned i = valueCount; i < valueCount + undefinedCount; ++i)
+                butterfly->contiguous()[i].setWithoutWriteBarrier(jsUndefined());
+            for (unsigned i = valueCount + undefinedCount; i < length; ++i)
+                butterfly->contiguous()[i].clear();
+            return;
+        default:
+            RELEASE_ASSERT_NOT_REACHED();
+        }
+    }
+
+    for (unsigned i = 0; i < valueCount + undefinedCount; ++i) {
+        array->methodTable(vm)->putByIndex(array, exec, i, i < valueCount ? valueAt(i) : jsUndefined(), true);
+        RETURN_IF_EXCEPTION(scope, void());
+    }
+    for (unsigned i = valueCount + undefinedCount; i < length; ++i) {
+        bool deleted = array->methodTable(vm)->deletePropertyByIndex(array, exec, i);
+        RETURN_IF_EXCEPTION(scope, void());
+        if (!deleted) {
+            throwTypeError(exec, scope, ASCIILiteral(UnableToDeletePropertyError));
+            return;
+        }
+    }
+}
+
+// Sorts arrays with Int32, Double or Contiguous storage without going through the generic JS
+// implementation. The elements are copied out, sorted with TimSort, and copied back, so a
+// comparator that changes the array cannot make us read or write out of bounds. Returns false,
+// having done nothing observable, if the array needs the JS implementation.
+EncodedJSValue JSC_HOST_CALL arrayProtoPrivateFuncSortFast(ExecState* exec)
+{
+    ASSERT(exec->argumentCount() == 2);
+    VM& vm = exec->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    JSValue thisValue = exec->uncheckedArgument(0);
+    JSValue comparator = exec->uncheckedArgument(1);
+    if (!isJSArray(thisValue))
+        return JSValue::encode(jsBoolean(false));
+    JSArray* array = asArray(thisValue);
+
+    CallData callData;
+    CallType callType = CallType::None;
+    if (!comparator.isUndefined()) {
+        callType = getCallData(comparator, callData);
+        if (callType == CallType::None)
+            return JSValue::encode(jsBoolean(false));
+    }
+
+    IndexingType indexingType = array->indexingType();
+    if (indexingType != ArrayWithInt32 && indexingType != ArrayWithDouble && indexingType != ArrayWithContiguous)
+        return JSValue::encode(jsBoolean(false));
+
+    Butterfly* butterfly = array->butterfly();
+    unsigned length = butterfly->publicLength();
+    if (length < 2)
+        return JSValue::encode(jsBoolean(true));
+
+    // Holes sort to the end, where they become holes again. That is only unobservable if reading
+    // one would not look at the prototype chain.
+    auto holesAreUnobservable = [&] {
+        return !array->structure(vm)->holesMustForwardToPrototype(vm);
+    };
+
+    if (indexingType == ArrayWithInt32) {
+        Vector<int32_t> values;
+        values.reserveInitialCapacity(length);
+        for (unsigned i = 0; i < length; ++i) {
+            if (JSValue value = butterfly->contiguousInt32()[i].get())
+                values.uncheckedAppend(value.asInt32());
+        }
+        if (values.size() < length && !holesAreUnobservable())
+            return JSValue::encode(jsBoolean(false));
+
+        if (callType == CallType::None)
+            timSort(values.data(), values.size(), int32StringLessThan);
+        else {
+            sortWithComparator(exec, values, comparator, callType, callData, [] (int32_t value) { return jsNumber(value); });
+            RETURN_IF_EXCEPTION(scope, encodedJSValue());
+        }
+
+        scope.release();
+        writeSortedValues(exec, array, indexingType, butterfly, length, values.size(), 0, [&] (unsigned i) { return jsNumber(values[i]); });
+        return JSValue::encode(jsBoolean(true));
+    }
+
+    if (indexingType == ArrayWithDouble) {
+        Vector<double> values;
+        values.reserveInitialCapacity(length);
+        for (unsigned i = 0; i < length; ++i) {
+            double value = butterfly->contiguousDouble()[i];
+            if (value == value)
+                values.uncheckedAppend(value);
+        }
+        if (values.size() < length && !holesAreUnobservable())
+            return JSValue::encode(jsBoolean(false));
+
+        if (callType == CallType::None) {
+            // Number to string conversion is expensive, so each key is computed once.
+            Vector<std::pair<String, double>> entries;
+            entries.reserveInitialCapacity(values.size());
+            for (double value : values)
+                entries.uncheckedAppend(std::make_pair(String::numberToStringECMAScript(value), value));
+            timSort(entries.data(), entries.size(), [] (const std::pair<String, double>& a, const std::pair<String, double>& b) {
+                return codePointCompareLessThan(a.first, b.first);
+            });
+            for (size_t i = 0; i < entries.size(); ++i)
+                values[i] = entries[i].second;
+        } else {
+            sortWithComparator(exec, values, comparator, callType, callData, [] (double value) { return jsNumber(value); });
+            RETURN_IF_EXCEPTION(scope, encodedJSValue());
+        }
+
+        scope.release();
+        writeSortedValues(exec, array, indexingType, butterfly, length, values.size(), 0, [&] (unsigned i) { return jsDoubleNumber(values[i]); });
+        return JSValue::encode(jsBoolean(true));
+    }
+
+    // The values are only referenced from C++ heap memory while we sort, and the comparator may
+    // remove them from the array, so keep them alive.
+    MarkedArgumentBuffer liveValues;
+    Vector<JSValue> values;
+    values.reserveInitialCapacity(length);
+    unsigned undefinedCount = 0;
+    for (unsigned i = 0; i < length; ++i) {
+        JSValue value = butterfly->contiguous()[i].get();
+        if (!value)
+            continue;
+        if (value.isUndefined()) {
+            ++undefinedCount;
+            continue;
+        }
+        values.uncheckedAppend(value);
+        liveValues.append(value);
+    }
+    if (values.size() + undefinedCount < length && !holesAreUnobservable())
+        return JSValue::encode(jsBoolean(false));
+
+    if (callType == CallType::None) {
+        Vector<StringSortEntry> entries;
+        entries.reserveInitialCapacity(values.size());
+        for (JSValue value : values) {
+            String key = value.isString() ? asString(value)->value(exec) : value.toWTFString(exec);
+            RETURN_IF_EXCEPTION(scope, encodedJSValue());
+            entries.uncheckedAppend(StringSortEntry { WTFMove(key), value });
+        }
+        timSort(entries.data(), entries.size(), [] (const StringSortEntry& a, const StringSortEntry& b) {
+            return codePointCompareLessThan(a.key, b.key);
+        });
+        for (size_t i = 0; i < entries.size(); ++i)
+            values[i] = entries[i].value;
+    } else {
+        sortWithComparator(exec, values, comparator, callType, callData, [] (JSValue value) { return value; });
+        RETURN_IF_EXCEPTION(scope, encodedJSValue());
+    }
+
+    scope.release();
+    writeSortedValues(exec, array, indexingType, butterfly, length, values.size(), undefinedCount, [&] (unsigned i) { return values[i]; });
+    return JSValue::encode(jsBoolean(true));
+}
+
 
 // -------------------- ArrayPrototype.constructor Watchpoint ------------------
 
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "CachedBytecode.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <wtf/ProcessID.h>
+#include <wtf/text/CString.h>
+#include <wtf/text/StringConcatenate.h>
+
+#if OS(UNIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace JSC {
+
+RefPtr<CachedBytecode> CachedBytecode::createFromFile(const String& path)
+{
+    CString fileName = path.utf8();
+
+#if OS(UNIX)
+    int fd = open(fileName.data(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) || !fileStat.st_size) {
+        close(fd);
+        return nullptr;
+    }
+
+    size_t size = static_cast<size_t>(fileStat.st_size);
+    void* mappedData = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mappedData == MAP_FAILED)
+        return nullptr;
+
+    return adoptRef(*new CachedBytecode(static_cast<const uint8_t*>(mappedData), size));
+#else
+    FILE* file = fopen(fileName.data(), "rb");
+    if (!file)
+        return nullptr;
+
+    Vector<uint8_t> data;
+    uint8_t buffer[4096];
+    while (size_t bytesRead = fread(buffer, 1, sizeof(buffer), file))
+        data.append(buffer, bytesRead);
+    fclose(file);
+
+    if (data.isEmpty())
+        return nullptr;
+    return create(WTFMove(data));
+#endif
+}
+
+CachedBytecode::~CachedBytecode()
+{
+#if OS(UNIX)
+    if (m_mappedData)
+        munmap(const_cast<uint8_t*>(m_mappedData), m_mappedSize);
+#endif
+}
+
+bool CachedBytecode::writeToFile(const String& path) const
+{
+    CString fileName = path.utf8();
+
+    // Several VMs, in this process or others, may write the same entry at once. Each writes its
+    // own uniquely named file and the last rename wins.
+#if OS(UNIX)
+    CString temporaryFileName = makeString(path, ".XXXXXX").utf8();
+    int fd = mkstemp(temporaryFileName.mutableData());
+    if (fd < 0)
+        return false;
+    FILE* file = fdopen(fd, "wb");
+    if (!file) {
+        close(fd);
+        remove(temporaryFileName.data());
+        return false;
+    }
+#else
+    static std::atomic<unsigned> temporaryFileCount;
+    CString temporaryFileName = makeString(path, ".tmp.", String::number(getCurrentProcessID()), ".", String::number(temporaryFileCount++)).utf8();
+    FILE* file = fopen(temporaryFileName.data(), "wb");
+    if (!file)
+        return false;
+#endif
+
+    bool success = fwrite(data(), 1, size(), file) == size();
+    success &= !fclose(file);
+    if (success)
+        success = !rename(temporaryFileName.data(), fileName.data());
+    if (!success)
+        remove(temporaryFileName.data());
+    return success;
+}
+
+} // namespace JSC
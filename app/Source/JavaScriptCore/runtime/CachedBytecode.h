@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <wtf/ThreadSafeRefCounted.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace JSC {
+
+// An immutable blob of serialized unlinked bytecode, as produced by encodeCodeBlock() in
+// CachedTypes.h. The bytes are either owned by this object or mapped read-only from a file,
+// so a cache on disk can be shared between processes without copying it into the heap. Since
+// the bytes never change, one blob may also be shared between VMs on different threads.
+class CachedBytecode : public ThreadSafeRefCounted<CachedBytecode> {
+public:
+    static Ref<CachedBytecode> create(Vector<uint8_t>&& data)
+    {
+        return adoptRef(*new CachedBytecode(WTFMove(data)));
+    }
+
+    // Returns null if the file does not exist or cannot be mapped.
+    JS_EXPORT_PRIVATE static RefPtr<CachedBytecode> createFromFile(const String& path);
+
+    JS_EXPORT_PRIVATE ~CachedBytecode();
+
+    const uint8_t* data() const { return m_mappedData ? m_mappedData : m_data.data(); }
+    size_t size() const { return m_mappedData ? m_mappedSize : m_data.size(); }
+
+    // Writes to a temporary file first and renames it into place, so concurrent readers
+    // never observe a partially written cache.
+    JS_EXPORT_PRIVATE bool writeToFile(const String& path) const;
+
+private:
+    explicit CachedBytecode(Vector<uint8_t>&& data)
+        : m_data(WTFMove(data))
+    {
+    }
+
+    CachedBytecode(const uint8_t* mappedData, size_t mappedSize)
+        : m_mappedData(mappedData)
+        , m_mappedSize(mappedSize)
+    {
+    }
+
+    Vector<uint8_t> m_data;
+    const uint8_t* m_mappedData { nullptr };
+    size_t m_mappedSize { 0 };
+};
+
+} // namespace JSC
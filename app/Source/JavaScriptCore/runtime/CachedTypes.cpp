@@ -0,0 +1,1203 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "CachedTypes.h"
+
+#include "CachedBytecode.h"
+#include "CodeCache.h"
+#include "DeferGC.h"
+#include "JSCInlines.h"
+#include "JSTemplateRegistryKey.h"
+#include "SymbolTable.h"
+#include "TemplateRegistryKeyTable.h"
+#include "UnlinkedFunctionCodeBlock.h"
+#include "UnlinkedInstructionStream.h"
+#include "UnlinkedProgramCodeBlock.h"
+#include <wtf/Hasher.h>
+#include <wtf/SHA1.h>
+#include <wtf/text/StringBuilder.h>
+#include <wtf/text/StringHash.h>
+
+namespace JSC {
+
+// The layout of the serialized form follows the in-memory layout of the unlinked code closely,
+// so bump this whenever UnlinkedCodeBlock, UnlinkedFunctionExecutable or the bytecode changes.
+static const uint32_t cachedBytecodeMagic = 0x4342534a; // "JSBC"
+static const uint32_t cachedBytecodeVersion = 3;
+
+enum class CachedValueTag : uint8_t {
+    Empty,
+    Undefined,
+    Null,
+    True,
+    False,
+    Int32,
+    Double,
+    String,
+    SymbolTable,
+    TemplateRegistryKey,
+};
+
+enum class CachedIdentifierTag : uint8_t {
+    Null,
+    String,
+    PrivateName,
+};
+
+SHA1::Digest computeSourceDigest(const SourceCodeKey& key)
+{
+    StringView source = key.string();
+    SHA1 sha1;
+    if (source.is8Bit())
+        sha1.addBytes(source.characters8(), source.length());
+    else
+        sha1.addBytes(reinterpret_cast<const uint8_t*>(source.characters16()), source.length() * sizeof(UChar));
+    SHA1::Digest digest;
+    sha1.computeHash(digest);
+    return digest;
+}
+
+class BytecodeCacheWriter {
+public:
+    enum class Contents { UserCode, Builtins };
+
+    BytecodeCacheWriter(VM& vm, const SourceCodeKey& key, const SHA1::Digest& sourceDigest, Contents contents = Contents::UserCode)
+        : m_vm(vm)
+        , m_key(key)
+        , m_sourceDigest(sourceDigest)
+        , m_contents(contents)
+    {
+    }
+
+    bool encode(UnlinkedCodeBlock*);
+    bool encode(UnlinkedFunctionExecutable*);
+    Vector<uint8_t> takeBuffer() { return WTFMove(m_buffer); }
+
+private:
+    size_t appendHeader();
+    void finishPayload(size_t payloadSizeOffset);
+
+    void append8(uint8_t value) { m_buffer.append(value); }
+    void append32(uint32_t value) { appendBytes(&value, sizeof(value)); }
+    void append64(uint64_t value) { appendBytes(&value, sizeof(value)); }
+    void appendBytes(const void* data, size_t size) { m_buffer.append(static_cast<const uint8_t*>(data), size); }
+
+    template<typename T>
+    void appendPODVector(const Vector<T>& vector)
+    {
+        append32(vector.size());
+        appendBytes(vector.data(), vector.size() * sizeof(T));
+    }
+
+    void appendString(const String&);
+    bool appendUid(UniquedStringImpl*);
+    bool appendIdentifier(const Identifier& identifier) { return appendUid(identifier.impl()); }
+    bool appendValue(JSValue);
+    bool appendSymbolTable(SymbolTable*);
+    bool appendVariableEnvironment(const VariableEnvironment&);
+    bool appendCodeBlock(UnlinkedCodeBlock*);
+    bool appendFunctionExecutable(UnlinkedFunctionExecutable*);
+
+    VM& m_vm;
+    const SourceCodeKey& m_key;
+    const SHA1::Digest& m_sourceDigest;
+    Contents m_contents;
+    Vector<uint8_t> m_buffer;
+    HashMap<RefPtr<StringImpl>, uint32_t> m_stringIndices;
+};
+
+class BytecodeCacheReader {
+public:
+    BytecodeCacheReader(VM& vm, const SourceCodeKey& key, const SHA1::Digest& sourceDigest, const SourceCode& source, const uint8_t* data, size_t size)
+        : m_vm(vm)
+        , m_key(key)
+        , m_sourceDigest(sourceDigest)
+        , m_source(source)
+        , m_cursor(data)
+        , m_end(data + size)
+    {
+    }
+
+    UnlinkedCodeBlock* decode();
+    UnlinkedFunctionExecutable* decodeFunctionExecutable();
+
+private:
+    bool readHeader();
+
+    uint8_t read8()
+    {
+        uint8_t result = 0;
+        readBytes(&result, sizeof(result));
+        return result;
+    }
+
+    uint32_t read32()
+    {
+        uint32_t result = 0;
+        readBytes(&result, sizeof(result));
+        return result;
+    }
+
+    uint64_t read64()
+    {
+        uint64_t result = 0;
+        readBytes(&result, sizeof(result));
+        return result;
+    }
+
+    bool readBytes(void* data, size_t size)
+    {
+        if (m_failed || static_cast<size_t>(m_end - m_cursor) < size) {
+            m_failed = true;
+            return false;
+        }
+        memcpy(data, m_cursor, size);
+        m_cursor += size;
+        return true;
+    }
+
+    // Reads an element count and checks that the remaining data could possibly hold that many
+    // elements, so a corrupt count never turns into a huge allocation.
+    uint32_t readLength(size_t minimumElementSize)
+    {
+        uint32_t length = read32();
+        if (m_failed || (minimumElementSize && static_cast<size_t>(m_end - m_cursor) / minimumElementSize < length)) {
+            m_failed = true;
+            return 0;
+        }
+        return length;
+    }
+
+    template<typename T>
+    void readPODVector(Vector<T>& vector)
+    {
+        uint32_t length = readLength(sizeof(T));
+        vector.resize(length);
+        readBytes(vector.data(), length * sizeof(T));
+    }
+
+    String readString();
+    RefPtr<UniquedStringImpl> readUid();
+    Identifier readIdentifier();
+    JSValue readValue();
+    SymbolTable* readSymbolTable();
+    void readVariableEnvironment(VariableEnvironment&);
+    UnlinkedCodeBlock* readCodeBlock();
+    UnlinkedFunctionExecutable* readFunctionExecutable();
+
+    VM& m_vm;
+    const SourceCodeKey& m_key;
+    const SHA1::Digest& m_sourceDigest;
+    const SourceCode& m_source;
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+    Vector<String> m_strings;
+    bool m_failed { false };
+};
+
+void BytecodeCacheWriter::appendString(const String& string)
+{
+    // Index 0 is the null string. An index one past the end of the table introduces a new string,
+    // anything else refers back to one that has already been written.
+    if (string.isNull()) {
+        append32(0);
+        return;
+    }
+
+    auto addResult = m_stringIndices.add(string.impl(), m_stringIndices.size() + 1);
+    append32(addResult.iterator->value);
+    if (!addResult.isNewEntry)
+        return;
+
+    append8(string.is8Bit());
+    append32(string.length());
+    if (string.is8Bit())
+        appendBytes(string.characters8(), string.length());
+    else
+        appendBytes(string.characters16(), string.length() * sizeof(UChar));
+}
+
+String BytecodeCacheReader::readString()
+{
+    uint32_t index = read32();
+    if (!index || m_failed)
+        return String();
+    if (index <= m_strings.size())
+        return m_strings[index - 1];
+    if (index != m_strings.size() + 1) {
+        m_failed = true;
+        return String();
+    }
+
+    bool is8Bit = read8();
+    uint32_t length = readLength(is8Bit ? sizeof(LChar) : sizeof(UChar));
+    if (m_failed)
+        return String();
+
+    String result;
+    if (is8Bit) {
+        LChar* characters;
+        result = String::createUninitialized(length, characters);
+        readBytes(characters, length * sizeof(LChar));
+    } else {
+        UChar* characters;
+        result = String::createUninitialized(length, characters);
+        readBytes(characters, length * sizeof(UChar));
+    }
+    m_strings.append(result);
+    return result;
+}
+
+bool BytecodeCacheWriter::appendUid(UniquedStringImpl* uid)
+{
+    if (!uid) {
+        append8(static_cast<uint8_t>(CachedIdentifierTag::Null));
+        return true;
+    }
+
+    if (!uid->isSymbol()) {
+        append8(static_cast<uint8_t>(CachedIdentifierTag::String));
+        appendString(uid);
+        return true;
+    }
+
+    // The bytecode generator refers to builtin private names and to well-known symbols such as
+    // Symbol.iterator. Both can be found again through the public-to-private name map, so we
+    // record the key we need to look up rather than the symbol itself.
+    Identifier identifier = Identifier::fromUid(&m_vm, uid);
+    Identifier publicName = m_vm.propertyNames->lookUpPublicName(identifier);
+    String lookupKey = publicName.isEmpty() ? String() : publicName.string();
+#define CHECK_WELL_KNOWN_SYMBOL(name) \
+    if (lookupKey.isNull() && uid == m_vm.propertyNames->name##Symbol.impl()) \
+        lookupKey = ASCIILiteral(#name "Symbol");
+    JSC_COMMON_PRIVATE_IDENTIFIERS_EACH_WELL_KNOWN_SYMBOL(CHECK_WELL_KNOWN_SYMBOL)
+#undef CHECK_WELL_KNOWN_SYMBOL
+
+    if (lookupKey.isNull())
+        return false;
+    const Identifier* privateName = m_vm.propertyNames->lookUpPrivateName(Identifier::fromString(&m_vm, lookupKey));
+    if (!privateName || privateName->impl() != uid)
+        return false;
+
+    append8(static_cast<uint8_t>(CachedIdentifierTag::PrivateName));
+    appendString(lookupKey);
+    return true;
+}
+
+RefPtr<UniquedStringImpl> BytecodeCacheReader::readUid()
+{
+    switch (static_cast<CachedIdentifierTag>(read8())) {
+    case CachedIdentifierTag::Null:
+        return nullptr;
+    case CachedIdentifierTag::String: {
+        String string = readString();
+        if (string.isNull())
+            break;
+        return Identifier::fromString(&m_vm, string).impl();
+    }
+    case CachedIdentifierTag::PrivateName: {
+        String lookupKey = readString();
+        if (lookupKey.isNull())
+            break;
+        const Identifier* privateName = m_vm.propertyNames->lookUpPrivateName(Identifier::fromString(&m_vm, lookupKey));
+        if (!privateName)
+            break;
+        return privateName->impl();
+    }
+    }
+
+    m_failed = true;
+    return nullptr;
+}
+
+Identifier BytecodeCacheReader::readIdentifier()
+{
+    RefPtr<UniquedStringImpl> uid = readUid();
+    if (!uid)
+        return Identifier();
+    return Identifier::fromUid(&m_vm, uid.get());
+}
+
+bool BytecodeCacheWriter::appendValue(JSValue value)
+{
+    if (!value) {
+        append8(static_cast<uint8_t>(CachedValueTag::Empty));
+        return true;
+    }
+    if (value.isUndefined()) {
+        append8(static_cast<uint8_t>(CachedValueTag::Undefined));
+        return true;
+    }
+    if (value.isNull()) {
+        append8(static_cast<uint8_t>(CachedValueTag::Null));
+        return true;
+    }
+    if (value.isBoolean()) {
+        append8(static_cast<uint8_t>(value.asBoolean() ? CachedValueTag::True : CachedValueTag::False));
+        return true;
+    }
+    if (value.isInt32()) {
+        append8(static_cast<uint8_t>(CachedValueTag::Int32));
+        append32(static_cast<uint32_t>(value.asInt32()));
+        return true;
+    }
+    if (value.isDouble()) {
+        append8(static_cast<uint8_t>(CachedValueTag::Double));
+        append64(bitwise_cast<uint64_t>(value.asDouble()));
+        return true;
+    }
+    if (value.isString()) {
+        JSString* string = asString(value);
+        if (string->isRope())
+            return false;
+        append8(static_cast<uint8_t>(CachedValueTag::String));
+        appendString(string->tryGetValue());
+        return true;
+    }
+    if (SymbolTable* symbolTable = jsDynamicCast<SymbolTable*>(m_vm, value)) {
+        append8(static_cast<uint8_t>(CachedValueTag::SymbolTable));
+        return appendSymbolTable(symbolTable);
+    }
+    if (JSTemplateRegistryKey* templateRegistryKey = jsDynamicCast<JSTemplateRegistryKey*>(m_vm, value)) {
+        append8(static_cast<uint8_t>(CachedValueTag::TemplateRegistryKey));
+        const TemplateRegistryKey& key = templateRegistryKey->templateRegistryKey();
+        append32(key.rawStrings().size());
+        for (const String& string : key.rawStrings())
+            appendString(string);
+        append32(key.cookedStrings().size());
+        for (const auto& string : key.cookedStrings()) {
+            append8(!!string);
+            if (string)
+                appendString(string.value());
+        }
+        return true;
+    }
+    return false;
+}
+
+JSValue BytecodeCacheReader::readValue()
+{
+    switch (static_cast<CachedValueTag>(read8())) {
+    case CachedValueTag::Empty:
+        return JSValue();
+    case CachedValueTag::Undefined:
+        return jsUndefined();
+    case CachedValueTag::Null:
+        return jsNull();
+    case CachedValueTag::True:
+        return jsBoolean(true);
+    case CachedValueTag::False:
+        return jsBoolean(false);
+    case CachedValueTag::Int32:
+        return jsNumber(static_cast<int32_t>(read32()));
+    case CachedValueTag::Double:
+        return JSValue(JSValue::EncodeAsDouble, bitwise_cast<double>(read64()));
+    case CachedValueTag::String: {
+        String string = readString();
+        if (m_failed)
+            return JSValue();
+        return jsString(&m_vm, string);
+    }
+    case CachedValueTag::SymbolTable:
+        return readSymbolTable();
+    case CachedValueTag::TemplateRegistryKey: {
+        TemplateRegistryKey::StringVector rawStrings;
+        uint32_t rawStringCount = readLength(sizeof(uint32_t));
+        for (uint32_t i = 0; i < rawStringCount && !m_failed; ++i)
+            rawStrings.append(readString());
+        TemplateRegistryKey::OptionalStringVector cookedStrings;
+        uint32_t cookedStringCount = readLength(sizeof(uint8_t));
+        for (uint32_t i = 0; i < cookedStringCount && !m_failed; ++i) {
+            if (read8())
+                cookedStrings.append(readString());
+            else
+                cookedStrings.append(std::nullopt);
+        }
+        if (m_failed)
+            return JSValue();
+        return JSTemplateRegistryKey::create(m_vm, m_vm.templateRegistryKeyTable().createKey(WTFMove(rawStrings), WTFMove(cookedStrings)));
+    }
+    }
+
+    m_failed = true;
+    return JSValue();
+}
+
+bool BytecodeCacheWriter::appendSymbolTable(SymbolTable* symbolTable)
+{
+    ConcurrentJSLocker locker(symbolTable->m_lock);
+
+    append8(symbolTable->scopeType());
+    append8(symbolTable->usesNonStrictEval());
+    append8(symbolTable->isNestedLexicalScope());
+    append32(symbolTable->maxScopeOffset().offsetUnchecked());
+
+    append32(symbolTable->size(locker));
+    for (auto iter = symbolTable->begin(locker), end = symbolTable->end(locker); iter != end; ++iter) {
+        if (!appendUid(iter->key.get()))
+            return false;
+        VarOffset offset = iter->value.varOffset();
+        append8(static_cast<uint8_t>(offset.kind()));
+        append32(offset.rawOffset());
+        append32(iter->value.getAttributes());
+        append8(iter->value.isWatchable());
+    }
+
+    ScopedArgumentsTable* arguments = symbolTable->arguments();
+    append8(!!arguments);
+    if (arguments) {
+        append32(arguments->length());
+        for (uint32_t i = 0; i < arguments->length(); ++i)
+            append32(arguments->get(i).offsetUnchecked());
+    }
+    return true;
+}
+
+SymbolTable* BytecodeCacheReader::readSymbolTable()
+{
+    SymbolTable* symbolTable = SymbolTable::create(m_vm);
+
+    symbolTable->setScopeType(static_cast<SymbolTable::ScopeType>(read8()));
+    symbolTable->setUsesNonStrictEval(read8());
+    if (read8())
+        symbolTable->markIsNestedLexicalScope();
+    uint32_t maxScopeOffset = read32();
+    if (maxScopeOffset != ScopeOffset::invalidOffset)
+        symbolTable->m_maxScopeOffset = ScopeOffset(maxScopeOffset);
+
+    uint32_t entryCount = readLength(sizeof(uint8_t) * 3 + sizeof(uint32_t) * 2);
+    ConcurrentJSLocker locker(symbolTable->m_lock);
+    for (uint32_t i = 0; i < entryCount && !m_failed; ++i) {
+        RefPtr<UniquedStringImpl> uid = readUid();
+        VarKind kind = static_cast<VarKind>(read8());
+        uint32_t rawOffset = read32();
+        unsigned attributes = read32();
+        bool isWatchable = read8();
+        if (m_failed || !uid || (kind != VarKind::Scope && kind != VarKind::Stack && kind != VarKind::DirectArgument)) {
+            m_failed = true;
+            return nullptr;
+        }
+
+        SymbolTableEntry entry(VarOffset::assemble(kind, rawOffset), attributes);
+        if (!isWatchable)
+            entry.disableWatching(m_vm);
+        symbolTable->add(locker, uid.get(), WTFMove(entry));
+    }
+    locker.unlockEarly();
+
+    if (read8()) {
+        uint32_t argumentsLength = readLength(sizeof(uint32_t));
+        symbolTable->setArgumentsLength(m_vm, argumentsLength);
+        for (uint32_t i = 0; i < argumentsLength && !m_failed; ++i) {
+            uint32_t offset = read32();
+            symbolTable->setArgumentOffset(m_vm, i, offset == ScopeOffset::invalidOffset ? ScopeOffset() : ScopeOffset(offset));
+        }
+    }
+
+    if (m_failed)
+        return nullptr;
+    return symbolTable;
+}
+
+bool BytecodeCacheWriter::appendVariableEnvironment(const VariableEnvironment& environment)
+{
+    append8(environment.isEverythingCaptured());
+    append32(environment.size());
+    for (auto& entry : environment) {
+        if (!appendUid(entry.key.get()))
+            return false;
+        append32(entry.value.m_bits);
+    }
+    return true;
+}
+
+void BytecodeCacheReader::readVariableEnvironment(VariableEnvironment& environment)
+{
+    if (read8())
+        environment.markAllVariablesAsCaptured();
+    uint32_t size = readLength(sizeof(uint8_t) + sizeof(uint32_t));
+    for (uint32_t i = 0; i < size && !m_failed; ++i) {
+        RefPtr<UniquedStringImpl> uid = readUid();
+        uint32_t bits = read32();
+        if (m_failed || !uid) {
+            m_failed = true;
+            return;
+        }
+        environment.add(uid).iterator->value.m_bits = bits;
+    }
+}
+
+bool BytecodeCacheWriter::appendFunctionExecutable(UnlinkedFunctionExecutable* executable)
+{
+    // Builtins are linked against a different source provider and are never part of user code.
+    // Default constructors are parsed from a source of their own for the same reason.
+    if (!executable->m_parentSourceOverride.isNull())
+        return false;
+    if (executable->isBuiltinFunction() != (m_contents == Contents::Builtins))
+        return false;
+
+    append32(executable->m_firstLineOffset);
+    append32(executable->m_lineCount);
+    append32(executable->m_unlinkedFunctionNameStart);
+    append32(executable->m_unlinkedBodyStartColumn);
+    append32(executable->m_unlinkedBodyEndColumn);
+    append32(executable->m_startOffset);
+    append32(executable->m_sourceLength);
+    append32(executable->m_parametersStartOffset);
+    append32(executable->m_typeProfilingStartOffset);
+    append32(executable->m_typeProfilingEndOffset);
+    append32(executable->m_parameterCount);
+    append32(executable->m_functionLength);
+    append32(executable->m_features);
+    append32(static_cast<uint32_t>(executable->m_sourceParseMode));
+    append8(executable->m_isInStrictContext);
+    append8(executable->m_hasCapturedVariables);
+    append8(executable->m_isBuiltinFunction);
+    append8(executable->m_constructAbility);
+    append8(executable->m_constructorKind);
+    append8(executable->m_functionMode);
+    append8(executable->m_scriptMode);
+    append8(executable->m_superBinding);
+    append8(executable->m_derivedContextType);
+
+    if (!appendIdentifier(executable->m_name)
+        || !appendIdentifier(executable->m_ecmaName)
+        || !appendIdentifier(executable->m_inferredName))
+        return false;
+
+    // The class source is recorded relative to the start of the program, so that the same
+    // bytes can be linked against a different provider holding the same text.
+    const SourceCode& classSource = executable->m_classSource;
+    append8(!classSource.isNull());
+    if (!classSource.isNull()) {
+        if (classSource.provider() != m_key.source().provider())
+            return false;
+        append32(classSource.startOffset() - m_key.source().startOffset());
+        append32(classSource.endOffset() - m_key.source().startOffset());
+        append32(classSource.firstLine().oneBasedInt());
+        append32(classSource.startColumn().oneBasedInt());
+    }
+
+    appendString(executable->m_sourceURLDirective);
+    appendString(executable->m_sourceMappingURLDirective);
+
+    if (!appendVariableEnvironment(executable->m_parentScopeTDZVariables))
+        return false;
+
+    UnlinkedFunctionCodeBlock* codeBlockForCall = executable->m_unlinkedCodeBlockForCall.get();
+    append8(!!codeBlockForCall);
+    if (codeBlockForCall && !appendCodeBlock(codeBlockForCall))
+        return false;
+
+    UnlinkedFunctionCodeBlock* codeBlockForConstruct = executable->m_unlinkedCodeBlockForConstruct.get();
+    append8(!!codeBlockForConstruct);
+    if (codeBlockForConstruct && !appendCodeBlock(codeBlockForConstruct))
+        return false;
+
+    return true;
+}
+
+UnlinkedFunctionExecutable* BytecodeCacheReader::readFunctionExecutable()
+{
+    UnlinkedFunctionExecutable* executable = new (NotNull, allocateCell<UnlinkedFunctionExecutable>(m_vm.heap))
+        UnlinkedFunctionExecutable(&m_vm, m_vm.unlinkedFunctionExecutableStructure.get());
+    executable->finishCreation(m_vm);
+
+    executable->m_firstLineOffset = read32();
+    executable->m_lineCount = read32();
+    executable->m_unlinkedFunctionNameStart = read32();
+    executable->m_unlinkedBodyStartColumn = read32();
+    executable->m_unlinkedBodyEndColumn = read32();
+    executable->m_startOffset = read32();
+    executable->m_sourceLength = read32();
+    executable->m_parametersStartOffset = read32();
+    executable->m_typeProfilingStartOffset = read32();
+    executable->m_typeProfilingEndOffset = read32();
+    executable->m_parameterCount = read32();
+    executable->m_functionLength = read32();
+    executable->m_features = read32();
+    executable->m_sourceParseMode = static_cast<SourceParseMode>(read32());
+    executable->m_isInStrictContext = read8();
+    executable->m_hasCapturedVariables = read8();
+    executable->m_isBuiltinFunction = read8();
+    executable->m_constructAbility = read8();
+    executable->m_constructorKind = read8();
+    executable->m_functionMode = read8();
+    executable->m_scriptMode = read8();
+    executable->m_superBinding = read8();
+    executable->m_derivedContextType = read8();
+
+    executable->m_name = readIdentifier();
+    executable->m_ecmaName = readIdentifier();
+    executable->m_inferredName = readIdentifier();
+
+    if (read8()) {
+        uint32_t startOffset = read32();
+        uint32_t endOffset = read32();
+        uint32_t firstLine = read32();
+        uint32_t startColumn = read32();
+        if (m_failed || startOffset > endOffset || endOffset > static_cast<unsigned>(m_source.length())) {
+            m_failed = true;
+            return nullptr;
+        }
+        executable->m_classSource = SourceCode(makeRefPtr(m_source.provider()),
+            m_source.startOffset() + startOffset, m_source.startOffset() + endOffset, firstLine, startColumn);
+    }
+
+    executable->m_sourceURLDirective = readString();
+    executable->m_sourceMappingURLDirective = readString();
+
+    readVariableEnvironment(executable->m_parentScopeTDZVariables);
+
+    if (read8()) {
+        UnlinkedCodeBlock* codeBlock = readCodeBlock();
+        if (!codeBlock || codeBlock->codeType() != FunctionCode) {
+            m_failed = true;
+            return nullptr;
+        }
+        executable->m_unlinkedCodeBlockForCall.set(m_vm, executable, jsCast<UnlinkedFunctionCodeBlock*>(codeBlock));
+    }
+
+    if (read8()) {
+        UnlinkedCodeBlock* codeBlock = readCodeBlock();
+        if (!codeBlock || codeBlock->codeType() != FunctionCode) {
+            m_failed = true;
+            return nullptr;
+        }
+        executable->m_unlinkedCodeBlockForConstruct.set(m_vm, executable, jsCast<UnlinkedFunctionCodeBlock*>(codeBlock));
+    }
+
+    if (m_failed || executable->m_startOffset + executable->m_sourceLength > static_cast<unsigned>(m_source.length()))
+        return nullptr;
+    return executable;
+}
+
+bool BytecodeCacheWriter::appendCodeBlock(UnlinkedCodeBlock* codeBlock)
+{
+    CodeType codeType = codeBlock->codeType();
+    if (codeType != GlobalCode && codeType != FunctionCode)
+        return false;
+    if (codeType == GlobalCode && !jsDynamicCast<UnlinkedProgramCodeBlock*>(m_vm, codeBlock))
+        return false;
+
+    append8(codeType);
+    append8(codeBlock->m_usesEval);
+    append8(codeBlock->m_isStrictMode);
+    append8(codeBlock->m_isConstructor);
+    append8(codeBlock->m_isBuiltinFunction);
+    append8(codeBlock->m_constructorKind);
+    append8(codeBlock->m_scriptMode);
+    append8(codeBlock->m_superBinding);
+    append32(static_cast<uint32_t>(codeBlock->m_parseMode));
+    append8(codeBlock->m_derivedContextType);
+    append8(codeBlock->m_isArrowFunctionContext);
+    append8(codeBlock->m_isClassContext);
+    append8(codeBlock->m_evalContextType);
+    append8(codeBlock->m_wasCompiledWithDebuggingOpcodes);
+
+    append8(codeBlock->m_hasCapturedVariables);
+    append32(codeBlock->m_lineCount);
+    append32(codeBlock->m_endColumn);
+    append32(codeBlock->m_features);
+    append32(codeBlock->m_numParameters);
+    append32(codeBlock->m_numVars);
+    append32(codeBlock->m_numCapturedVars);
+    append32(codeBlock->m_numCalleeLocals);
+    append32(codeBlock->m_thisRegister.offset());
+    append32(codeBlock->m_scopeRegister.offset());
+    append32(codeBlock->m_globalObjectRegister.offset());
+    appendString(codeBlock->m_sourceURLDirective);
+    appendString(codeBlock->m_sourceMappingURLDirective);
+
+    const UnlinkedInstructionStream& instructions = codeBlock->instructions();
+    append32(instructions.m_instructionCount);
+    append32(instructions.m_data.size());
+    appendBytes(instructions.m_data.data(), instructions.m_data.size());
+
+    appendPODVector(codeBlock->m_jumpTargets);
+    appendPODVector(codeBlock->m_propertyAccessInstructions);
+
+    append32(codeBlock->m_identifiers.size());
+    for (const Identifier& identifier : codeBlock->m_identifiers) {
+        if (!appendIdentifier(identifier))
+            return false;
+    }
+
+    append32(codeBlock->m_bitVectors.size());
+    for (const BitVector& bitVector : codeBlock->m_bitVectors) {
+        append32(bitVector.size());
+        for (size_t i = 0; i < bitVector.size(); i += 8) {
+            uint8_t bits = 0;
+            for (size_t bit = i; bit < std::min<size_t>(i + 8, bitVector.size()); ++bit)
+                bits |= bitVector.get(bit) << (bit - i);
+            append8(bits);
+        }
+    }
+
+    append32(codeBlock->m_constantRegisters.size());
+    for (size_t i = 0; i < codeBlock->m_constantRegisters.size(); ++i) {
+        if (!appendValue(codeBlock->m_constantRegisters[i].get()))
+            return false;
+        append8(static_cast<uint8_t>(codeBlock->m_constantsSourceCodeRepresentation[i]));
+    }
+    for (unsigned linkTimeConstant : codeBlock->m_linkTimeConstants)
+        append32(linkTimeConstant);
+
+    append32(codeBlock->m_functionDecls.size());
+    for (auto& functionDecl : codeBlock->m_functionDecls) {
+        if (!appendFunctionExecutable(functionDecl.get()))
+            return false;
+    }
+    append32(codeBlock->m_functionExprs.size());
+    for (auto& functionExpr : codeBlock->m_functionExprs) {
+        if (!appendFunctionExecutable(functionExpr.get()))
+            return false;
+    }
+
+    append32(codeBlock->m_arrayProfileCount);
+    append32(codeBlock->m_arrayAllocationProfileCount);
+    append32(codeBlock->m_objectAllocationProfileCount);
+    append32(codeBlock->m_valueProfileCount);
+    append32(codeBlock->m_llintCallLinkInfoCount);
+
+    appendPODVector(codeBlock->m_expressionInfo);
+
+    UnlinkedCodeBlock::RareData* rareData = codeBlock->m_rareData.get();
+    append8(!!rareData);
+    if (rareData) {
+        appendPODVector(rareData->m_exceptionHandlers);
+
+        append32(rareData->m_regexps.size());
+        for (auto& regExp : rareData->m_regexps) {
+            appendString(regExp->pattern());
+            uint8_t flags = NoFlags;
+            if (regExp->global())
+                flags |= FlagGlobal;
+            if (regExp->ignoreCase())
+                flags |= FlagIgnoreCase;
+            if (regExp->multiline())
+                flags |= FlagMultiline;
+            if (regExp->sticky())
+                flags |= FlagSticky;
+            if (regExp->unicode())
+                flags |= FlagUnicode;
+            append8(flags);
+        }
+
+        append32(rareData->m_constantBuffers.size());
+        for (auto& constantBuffer : rareData->m_constantBuffers) {
+            append32(constantBuffer.size());
+            for (JSValue value : constantBuffer) {
+                if (!appendValue(value))
+                    return false;
+            }
+        }
+
+        append32(rareData->m_switchJumpTables.size());
+        for (auto& jumpTable : rareData->m_switchJumpTables) {
+            append32(jumpTable.min);
+            appendPODVector(jumpTable.branchOffsets);
+        }
+
+        append32(rareData->m_stringSwitchJumpTables.size());
+        for (auto& jumpTable : rareData->m_stringSwitchJumpTables) {
+            append32(jumpTable.offsetTable.size());
+            for (auto& entry : jumpTable.offsetTable) {
+                appendString(entry.key.get());
+                append32(entry.value.branchOffset);
+            }
+        }
+
+        appendPODVector(rareData->m_expressionInfoFatPositions);
+
+        append32(rareData->m_typeProfilerInfoMap.size());
+        for (auto& entry : rareData->m_typeProfilerInfoMap) {
+            append32(entry.key);
+            append32(entry.value.m_startDivot);
+            append32(entry.value.m_endDivot);
+        }
+
+        append32(rareData->m_opProfileControlFlowBytecodeOffsets.size());
+        for (size_t offset : rareData->m_opProfileControlFlowBytecodeOffsets)
+            append64(offset);
+    }
+
+    if (codeType == GlobalCode) {
+        UnlinkedProgramCodeBlock* programCodeBlock = jsCast<UnlinkedProgramCodeBlock*>(codeBlock);
+        if (!appendVariableEnvironment(programCodeBlock->variableDeclarations())
+            || !appendVariableEnvironment(programCodeBlock->lexicalDeclarations()))
+            return false;
+    }
+
+    return true;
+}
+
+UnlinkedCodeBlock* BytecodeCacheReader::readCodeBlock()
+{
+    CodeType codeType = static_cast<CodeType>(read8());
+    bool usesEval = read8();
+    bool isStrictMode = read8();
+    bool isConstructor = read8();
+    bool isBuiltinFunction = read8();
+    ConstructorKind constructorKind = static_cast<ConstructorKind>(read8());
+    JSParserScriptMode scriptMode = static_cast<JSParserScriptMode>(read8());
+    SuperBinding superBinding = static_cast<SuperBinding>(read8());
+    SourceParseMode parseMode = static_cast<SourceParseMode>(read32());
+    DerivedContextType derivedContextType = static_cast<DerivedContextType>(read8());
+    bool isArrowFunctionContext = read8();
+    bool isClassContext = read8();
+    EvalContextType evalContextType = static_cast<EvalContextType>(read8());
+    DebuggerMode debuggerMode = read8() ? DebuggerOn : DebuggerOff;
+    if (m_failed)
+        return nullptr;
+
+    ExecutableInfo info(usesEval, isStrictMode, isConstructor, isBuiltinFunction, constructorKind, scriptMode, superBinding, parseMode, derivedContextType, isArrowFunctionContext, isClassContext, evalContextType);
+    UnlinkedCodeBlock* codeBlock;
+    switch (codeType) {
+    case GlobalCode:
+        codeBlock = UnlinkedProgramCodeBlock::create(&m_vm, info, debuggerMode);
+        break;
+    case FunctionCode:
+        codeBlock = UnlinkedFunctionCodeBlock::create(&m_vm, FunctionCode, info, debuggerMode);
+        break;
+    default:
+        m_failed = true;
+        return nullptr;
+    }
+
+    codeBlock->m_hasCapturedVariables = read8();
+    codeBlock->m_lineCount = read32();
+    codeBlock->m_endColumn = read32();
+    codeBlock->m_features = read32();
+    codeBlock->m_numParameters = read32();
+    codeBlock->m_numVars = read32();
+    codeBlock->m_numCapturedVars = read32();
+    codeBlock->m_numCalleeLocals = read32();
+    codeBlock->m_thisRegister = VirtualRegister(static_cast<int>(read32()));
+    codeBlock->m_scopeRegister = VirtualRegister(static_cast<int>(read32()));
+    codeBlock->m_globalObjectRegister = VirtualRegister(static_cast<int>(read32()));
+    codeBlock->m_sourceURLDirective = readString();
+    codeBlock->m_sourceMappingURLDirective = readString();
+
+    unsigned instructionCount = read32();
+    uint32_t instructionBytes = readLength(sizeof(uint8_t));
+    if (m_failed)
+        return nullptr;
+    RefCountedArray<unsigned char> instructionData(instructionBytes);
+    readBytes(instructionData.data(), instructionBytes);
+    codeBlock->setInstructions(std::unique_ptr<UnlinkedInstructionStream>(new UnlinkedInstructionStream(WTFMove(instructionData), instructionCount)));
+
+    readPODVector(codeBlock->m_jumpTargets);
+    readPODVector(codeBlock->m_propertyAccessInstructions);
+
+    uint32_t identifierCount = readLength(sizeof(uint8_t));
+    for (uint32_t i = 0; i < identifierCount && !m_failed; ++i)
+        codeBlock->addIdentifier(readIdentifier());
+
+    uint32_t bitVectorCount = readLength(sizeof(uint32_t));
+    for (uint32_t i = 0; i < bitVectorCount && !m_failed; ++i) {
+        uint32_t size = read32();
+        if (m_failed || static_cast<size_t>(m_end - m_cursor) < (static_cast<size_t>(size) + 7) / 8) {
+            m_failed = true;
+            break;
+        }
+        BitVector bitVector(size);
+        for (uint32_t i = 0; i < size; i += 8) {
+            uint8_t bits = read8();
+            for (uint32_t bit = i; bit < std::min(i + 8, size); ++bit) {
+                if (bits & (1 << (bit - i)))
+                    bitVector.set(bit);
+            }
+        }
+        codeBlock->addBitVector(WTFMove(bitVector));
+    }
+
+    // Constant buffers are not visited by the GC, so the strings they contain must also be kept
+    // alive as constant registers, as BytecodeGenerator::addStringConstant() does.
+    HashMap<String, JSString*> constantStrings;
+    uint32_t constantCount = readLength(sizeof(uint8_t) * 2);
+    for (uint32_t i = 0; i < constantCount && !m_failed; ++i) {
+        JSValue value = readValue();
+        SourceCodeRepresentation sourceCodeRepresentation = static_cast<SourceCodeRepresentation>(read8());
+        if (value.isString())
+            constantStrings.add(asString(value)->tryGetValue(), asString(value));
+        codeBlock->addConstant(value, sourceCodeRepresentation);
+    }
+    for (unsigned& linkTimeConstant : codeBlock->m_linkTimeConstants) {
+        linkTimeConstant = read32();
+        if (linkTimeConstant && linkTimeConstant >= codeBlock->m_constantRegisters.size())
+            m_failed = true;
+    }
+
+    uint32_t functionDeclCount = readLength(sizeof(uint32_t));
+    for (uint32_t i = 0; i < functionDeclCount && !m_failed; ++i) {
+        if (UnlinkedFunctionExecutable* executable = readFunctionExecutable())
+            codeBlock->addFunctionDecl(executable);
+    }
+    uint32_t functionExprCount = readLength(sizeof(uint32_t));
+    for (uint32_t i = 0; i < functionExprCount && !m_failed; ++i) {
+        if (UnlinkedFunctionExecutable* executable = readFunctionExecutable())
+            codeBlock->addFunctionExpr(executable);
+    }
+
+    codeBlock->m_arrayProfileCount = read32();
+    codeBlock->m_arrayAllocationProfileCount = read32();
+    codeBlock->m_objectAllocationProfileCount = read32();
+    codeBlock->m_valueProfileCount = read32();
+    codeBlock->m_llintCallLinkInfoCount = read32();
+
+    readPODVector(codeBlock->m_expressionInfo);
+
+    if (read8()) {
+        uint32_t exceptionHandlerCount = readLength(sizeof(UnlinkedHandlerInfo));
+        for (uint32_t i = 0; i < exceptionHandlerCount && !m_failed; ++i) {
+            UnlinkedHandlerInfo handler(0, 0, 0, HandlerType::Catch);
+            readBytes(&handler, sizeof(handler));
+            codeBlock->addExceptionHandler(handler);
+        }
+
+        uint32_t regExpCount = readLength(sizeof(uint32_t) + sizeof(uint8_t));
+        for (uint32_t i = 0; i < regExpCount && !m_failed; ++i) {
+            String pattern = readString();
+            RegExpFlags flags = static_cast<RegExpFlags>(read8());
+            if (m_failed || pattern.isNull() || flags >= InvalidFlags) {
+                m_failed = true;
+                break;
+            }
+            codeBlock->addRegExp(RegExp::create(m_vm, pattern, flags));
+        }
+
+        uint32_t constantBufferCount = readLength(sizeof(uint32_t));
+        for (uint32_t i = 0; i < constantBufferCount && !m_failed; ++i) {
+            uint32_t length = readLength(sizeof(uint8_t));
+            unsigned index = codeBlock->addConstantBuffer(length);
+            UnlinkedCodeBlock::ConstantBuffer& constantBuffer = codeBlock->constantBuffer(index);
+            for (uint32_t j = 0; j < length && !m_failed; ++j) {
+                JSValue value = readValue();
+                if (value.isString()) {
+                    value = constantStrings.get(asString(value)->tryGetValue());
+                    if (!value)
+                        m_failed = true;
+                }
+                constantBuffer[j] = value;
+            }
+        }
+
+        uint32_t switchJumpTableCount = readLength(sizeof(uint32_t) * 2);
+        for (uint32_t i = 0; i < switchJumpTableCount && !m_failed; ++i) {
+            UnlinkedSimpleJumpTable& jumpTable = codeBlock->addSwitchJumpTable();
+            jumpTable.min = static_cast<int32_t>(read32());
+            readPODVector(jumpTable.branchOffsets);
+        }
+
+        uint32_t stringSwitchJumpTableCount = readLength(sizeof(uint32_t));
+        for (uint32_t i = 0; i < stringSwitchJumpTableCount && !m_failed; ++i) {
+            UnlinkedStringJumpTable& jumpTable = codeBlock->addStringSwitchJumpTable();
+            uint32_t entryCount = readLength(sizeof(uint32_t) * 2);
+            for (uint32_t j = 0; j < entryCount && !m_failed; ++j) {
+                String key = readString();
+                int32_t branchOffset = static_cast<int32_t>(read32());
+                if (m_failed || key.isNull()) {
+                    m_failed = true;
+                    break;
+                }
+                jumpTable.offsetTable.add(key.impl(), UnlinkedStringJumpTable::OffsetLocation { branchOffset });
+            }
+        }
+
+        UnlinkedCodeBlock::RareData* rareData = codeBlock->m_rareData.get();
+        readPODVector(rareData->m_expressionInfoFatPositions);
+
+        uint32_t typeProfilerInfoCount = readLength(sizeof(uint32_t) * 3);
+        for (uint32_t i = 0; i < typeProfilerInfoCount && !m_failed; ++i) {
+            unsigned instructionOffset = read32();
+            UnlinkedCodeBlock::RareData::TypeProfilerExpressionRange range;
+            range.m_startDivot = read32();
+            range.m_endDivot = read32();
+            rareData->m_typeProfilerInfoMap.set(instructionOffset, range);
+        }
+
+        uint32_t controlFlowOffsetCount = readLength(sizeof(uint64_t));
+        for (uint32_t i = 0; i < controlFlowOffsetCount && !m_failed; ++i)
+            codeBlock->addOpProfileControlFlowBytecodeOffset(static_cast<size_t>(read64()));
+    }
+
+    if (codeType == GlobalCode) {
+        UnlinkedProgramCodeBlock* programCodeBlock = jsCast<UnlinkedProgramCodeBlock*>(codeBlock);
+        VariableEnvironment variableDeclarations;
+        readVariableEnvironment(variableDeclarations);
+        programCodeBlock->setVariableDeclarations(variableDeclarations);
+        VariableEnvironment lexicalDeclarations;
+        readVariableEnvironment(lexicalDeclarations);
+        programCodeBlock->setLexicalDeclarations(lexicalDeclarations);
+    }
+
+    if (m_failed)
+        return nullptr;
+
+    codeBlock->shrinkToFit();
+    return codeBlock;
+}
+
+size_t BytecodeCacheWriter::appendHeader()
+{
+    append32(cachedBytecodeMagic);
+    append32(cachedBytecodeVersion);
+    append32(sizeof(void*));
+    append32(numOpcodeIDs);
+    append32(m_key.flags().bits());
+    append32(m_key.length());
+    appendBytes(m_sourceDigest.data(), m_sourceDigest.size());
+
+    size_t payloadSizeOffset = m_buffer.size();
+    append32(0);
+    append32(0);
+    return payloadSizeOffset;
+}
+
+void BytecodeCacheWriter::finishPayload(size_t payloadSizeOffset)
+{
+    size_t payloadStart = payloadSizeOffset + 2 * sizeof(uint32_t);
+    uint32_t payloadSize = m_buffer.size() - payloadStart;
+    uint32_t payloadHash = StringHasher::hashMemory(m_buffer.data() + payloadStart, payloadSize);
+    memcpy(m_buffer.data() + payloadSizeOffset, &payloadSize, sizeof(payloadSize));
+    memcpy(m_buffer.data() + payloadSizeOffset + sizeof(payloadSize), &payloadHash, sizeof(payloadHash));
+}
+
+bool BytecodeCacheWriter::encode(UnlinkedCodeBlock* codeBlock)
+{
+    size_t payloadSizeOffset = appendHeader();
+    if (!appendCodeBlock(codeBlock))
+        return false;
+    finishPayload(payloadSizeOffset);
+    return true;
+}
+
+bool BytecodeCacheWriter::encode(UnlinkedFunctionExecutable* executable)
+{
+    size_t payloadSizeOffset = appendHeader();
+    if (!appendFunctionExecutable(executable))
+        return false;
+    finishPayload(payloadSizeOffset);
+    return true;
+}
+
+bool BytecodeCacheReader::readHeader()
+{
+    if (read32() != cachedBytecodeMagic
+        || read32() != cachedBytecodeVersion
+        || read32() != sizeof(void*)
+        || read32() != static_cast<uint32_t>(numOpcodeIDs))
+        return false;
+
+    uint32_t flags = read32();
+    uint32_t sourceLength = read32();
+    SHA1::Digest digest;
+    readBytes(digest.data(), digest.size());
+    uint32_t payloadSize = read32();
+    uint32_t payloadHash = read32();
+    if (m_failed || static_cast<size_t>(m_end - m_cursor) != payloadSize)
+        return false;
+
+    if (sourceLength != m_key.length() || flags != m_key.flags().bits() || digest != m_sourceDigest)
+        return false;
+    return payloadHash == StringHasher::hashMemory(m_cursor, payloadSize);
+}
+
+UnlinkedCodeBlock* BytecodeCacheReader::decode()
+{
+    if (!readHeader())
+        return nullptr;
+
+    DeferGC deferGC(m_vm.heap);
+    UnlinkedCodeBlock* codeBlock = readCodeBlock();
+    if (m_failed || m_cursor != m_end)
+        return nullptr;
+    return codeBlock;
+}
+
+UnlinkedFunctionExecutable* BytecodeCacheReader::decodeFunctionExecutable()
+{
+    if (!readHeader())
+        return nullptr;
+
+    DeferGC deferGC(m_vm.heap);
+    UnlinkedFunctionExecutable* executable = readFunctionExecutable();
+    if (m_failed || m_cursor != m_end)
+        return nullptr;
+    return executable;
+}
+
+RefPtr<CachedBytecode> encodeCodeBlock(VM& vm, const SourceCodeKey& key, const SHA1::Digest& sourceDigest, UnlinkedCodeBlock* codeBlock)
+{
+    BytecodeCacheWriter writer(vm, key, sourceDigest);
+    if (!writer.encode(codeBlock))
+        return nullptr;
+    return CachedBytecode::create(writer.takeBuffer());
+}
+
+UnlinkedCodeBlock* decodeCodeBlock(VM& vm, const SourceCodeKey& key, const SHA1::Digest& sourceDigest, const SourceCode& source, const CachedBytecode& cachedBytecode)
+{
+    BytecodeCacheReader reader(vm, key, sourceDigest, source, cachedBytecode.data(), cachedBytecode.size());
+    return reader.decode();
+}
+
+// Builtin entries are keyed by the address of the builtin's static source text, which cannot
+// change within a process, so hashing that text would only cost time. The digest is left zero.
+static const SHA1::Digest& builtinSourceDigest()
+{
+    static const SHA1::Digest digest { };
+    return digest;
+}
+
+RefPtr<CachedBytecode> encodeBuiltinExecutable(VM& vm, const SourceCodeKey& key, UnlinkedFunctionExecutable* executable)
+{
+    BytecodeCacheWriter writer(vm, key, builtinSourceDigest(), BytecodeCacheWriter::Contents::Builtins);
+    if (!writer.encode(executable))
+        return nullptr;
+    return CachedBytecode::create(writer.takeBuffer());
+}
+
+UnlinkedFunctionExecutable* decodeBuiltinExecutable(VM& vm, const SourceCodeKey& key, const SourceCode& source, const CachedBytecode& cachedBytecode)
+{
+    BytecodeCacheReader reader(vm, key, builtinSourceDigest(), source, cachedBytecode.data(), cachedBytecode.size());
+    UnlinkedFunctionExecutable* executable = reader.decodeFunctionExecutable();
+    if (!executable || !executable->isBuiltinFunction())
+        return nullptr;
+    return executable;
+}
+
+String cachedBytecodeFileName(const SourceCodeKey& key, const SHA1::Digest& sourceDigest)
+{
+    StringBuilder builder;
+    builder.append(SHA1::hexDigest(sourceDigest).data());
+    builder.append('-');
+    builder.append(String::format("%x", key.flags().bits()));
+    builder.appendLiteral(".jsbc");
+    return builder.toString();
+}
+
+} // namespace JSC
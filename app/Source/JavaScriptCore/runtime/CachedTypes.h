@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <wtf/Forward.h>
+#include <wtf/SHA1.h>
+
+namespace JSC {
+
+class CachedBytecode;
+class SourceCode;
+class SourceCodeKey;
+class UnlinkedCodeBlock;
+class UnlinkedFunctionExecutable;
+class VM;
+
+// A digest of the source text, which the functions below use to key and validate the cache. It
+// hashes the whole source, so callers compute it once and pass it to each of them.
+SHA1::Digest computeSourceDigest(const SourceCodeKey&);
+
+// Serializes a top-level UnlinkedProgramCodeBlock together with its identifiers, constants and
+// tree of UnlinkedFunctionExecutables. UnlinkedFunctionCodeBlocks are included for functions that
+// have already been compiled. Returns null if the code block uses something the format cannot
+// represent, in which case the caller should just not cache it.
+RefPtr<CachedBytecode> encodeCodeBlock(VM&, const SourceCodeKey&, const SHA1::Digest& sourceDigest, UnlinkedCodeBlock*);
+
+// Returns null if the blob was produced by a different build, for different source text or
+// parser flags, or is truncated.
+UnlinkedCodeBlock* decodeCodeBlock(VM&, const SourceCodeKey&, const SHA1::Digest& sourceDigest, const SourceCode&, const CachedBytecode&);
+
+// Serializes a builtin's UnlinkedFunctionExecutable and whichever of its code blocks have been
+// generated. The source text is not hashed; the caller keys the result by the address of the
+// builtin's static source, and only its length is checked on decode. Used by SharedBuiltinImage to hand builtins that
+// one VM has already compiled to the other VMs in the process.
+RefPtr<CachedBytecode> encodeBuiltinExecutable(VM&, const SourceCodeKey&, UnlinkedFunctionExecutable*);
+UnlinkedFunctionExecutable* decodeBuiltinExecutable(VM&, const SourceCodeKey&, const SourceCode&, const CachedBytecode&);
+
+// A file name derived from a digest of the source text and the parser flags, suitable for use
+// inside Options::bytecodeCachePath().
+String cachedBytecodeFileName(const SourceCodeKey&, const SHA1::Digest& sourceDigest);
+
+} // namespace JSC
@@ -26,7 +26,10 @@
 #include "config.h"
 #include "CodeCache.h"
 
+#include "CachedBytecode.h"
+#include "CachedTypes.h"
 #include "IndirectEvalExecutable.h"
+#include <wtf/text/StringBuilder.h>
 
 namespace JSC {
 
@@ -48,6 +51,115 @@ void CodeCacheMap::pruneSlowCase()
     }
 }
 
+template <class UnlinkedCodeBlockType, class ExecutableType>
+void CodeCache::recordCacheHit(UnlinkedCodeBlockType* unlinkedCodeBlock, ExecutableType* executable, const SourceCode& source)
+{
+    unsigned lineCount = unlinkedCodeBlock->lineCount();
+    unsigned startColumn = unlinkedCodeBlock->startColumn() + source.startColumn().oneBasedInt();
+    bool endColumnIsOnStartLine = !lineCount;
+    unsigned endColumn = unlinkedCodeBlock->endColumn() + (endColumnIsOnStartLine ? startColumn : 1);
+    executable->recordParse(unlinkedCodeBlock->codeFeatures(), unlinkedCodeBlock->hasCapturedVariables(), source.firstLine().oneBasedInt() + lineCount, endColumn);
+    source.provider()->setSourceURLDirective(unlinkedCodeBlock->sourceURLDirective());
+    source.provider()->setSourceMappingURLDirective(unlinkedCodeBlock->sourceMappingURLDirective());
+}
+
+static bool canUseCachedBytecode(VM& vm)
+{
+    // Profiler side tables are keyed by the profiling state of the VM that generated them, and
+    // are not worth persisting.
+    return Options::useCodeCache() && !vm.typeProfiler() && !vm.controlFlowProfiler();
+}
+
+static const SHA1::Digest& ensureSourceDigest(const SourceCodeKey& key, std::optional<SHA1::Digest>& sourceDigest)
+{
+    if (!sourceDigest)
+        sourceDigest = computeSourceDigest(key);
+    return *sourceDigest;
+}
+
+static bool hasCachedBytecodeDirectory()
+{
+    const char* directory = Options::bytecodeCachePath();
+    return directory && *directory;
+}
+
+static String cachedBytecodePath(const SourceCodeKey& key, std::optional<SHA1::Digest>& sourceDigest)
+{
+    const char* directory = Options::bytecodeCachePath();
+    if (!directory || !*directory)
+        return String();
+
+    StringBuilder path;
+    path.append(directory);
+    if (path[path.length() - 1] != '/')
+        path.append('/');
+    path.append(cachedBytecodeFileName(key, ensureSourceDigest(key, sourceDigest)));
+    return path.toString();
+}
+
+UnlinkedCodeBlock* CodeCache::fetchCachedBytecode(VM& vm, const SourceCodeKey& key, const SourceCode& source, std::optional<SHA1::Digest>& sourceDigest)
+{
+    if (!canUseCachedBytecode(vm))
+        return nullptr;
+
+    SourceProvider* provider = source.provider();
+    if (provider->supportsCachedBytecode()) {
+        if (RefPtr<CachedBytecode> cachedBytecode = provider->cachedBytecode()) {
+            if (UnlinkedCodeBlock* codeBlock = decodeCodeBlock(vm, key, ensureSourceDigest(key, sourceDigest), source, *cachedBytecode))
+                return codeBlock;
+        }
+    }
+
+    if (!hasCachedBytecodeDirectory())
+        return nullptr;
+
+    RefPtr<CachedBytecode> cachedBytecode = CachedBytecode::createFromFile(cachedBytecodePath(key, sourceDigest));
+    if (!cachedBytecode)
+        return nullptr;
+
+    UnlinkedCodeBlock* codeBlock = decodeCodeBlock(vm, key, ensureSourceDigest(key, sourceDigest), source, *cachedBytecode);
+    if (codeBlock && provider->supportsCachedBytecode())
+        provider->updateCachedBytecode(cachedBytecode.releaseNonNull());
+    return codeBlock;
+}
+
+void CodeCache::storeCachedBytecode(VM& vm, const SourceCodeKey& key, UnlinkedCodeBlock* codeBlock, std::optional<SHA1::Digest>& sourceDigest)
+{
+    if (!canUseCachedBytecode(vm))
+        return;
+
+    // Encoding walks the whole program, so only do it when something will keep the result.
+    SourceProvider* provider = key.source().provider();
+    bool shouldWriteToFile = hasCachedBytecodeDirectory();
+    bool shouldUpdateProvider = provider->supportsCachedBytecode() && provider->shouldStoreCachedBytecode();
+    if (!shouldWriteToFile && !shouldUpdateProvider)
+        return;
+
+    // Only the top-level code has been generated at this point. Function bodies are picked up
+    // when writeCachedBytecodes() re-encodes the program after it has run.
+    RefPtr<CachedBytecode> cachedBytecode = encodeCodeBlock(vm, key, ensureSourceDigest(key, sourceDigest), codeBlock);
+    if (!cachedBytecode)
+        return;
+
+    if (shouldWriteToFile)
+        cachedBytecode->writeToFile(cachedBytecodePath(key, sourceDigest));
+    if (shouldUpdateProvider)
+        provider->updateCachedBytecode(cachedBytecode.releaseNonNull());
+}
+
+void CodeCache::writeCachedBytecodes(VM& vm)
+{
+    if (!canUseCachedBytecode(vm))
+        return;
+
+    for (auto& entry : m_sourceCode) {
+        if (auto* codeBlock = jsDynamicCast<UnlinkedProgramCodeBlock*>(vm, entry.value.cell.get())) {
+            std::optional<SHA1::Digest> sourceDigest;
+            storeCachedBytecode(vm, entry.key, codeBlock, sourceDigest);
+        }
+    }
+}
+
 template <class UnlinkedCodeBlockType, class ExecutableType>
 UnlinkedCodeBlockType* CodeCache::getUnlinkedGlobalCodeBlock(VM& vm, ExecutableType* executable, const SourceCode& source, JSParserStrictMode strictMode, JSParserScriptMode scriptMode, DebuggerMode debuggerMode, ParserError& error, EvalContextType evalContextType)
 {
@@ -61,21 +173,28 @@ UnlinkedCodeBlockType* CodeCache::getUnlinkedGlobalCodeBlock(VM& vm, ExecutableT
     SourceCodeValue* cache = m_sourceCode.findCacheAndUpdateAge(key);
     if (cache && Options::useCodeCache()) {
         UnlinkedCodeBlockType* unlinkedCodeBlock = jsCast<UnlinkedCodeBlockType*>(cache->cell.get());
-        unsigned lineCount = unlinkedCodeBlock->lineCount();
-        unsigned startColumn = unlinkedCodeBlock->startColumn() + source.startColumn().oneBasedInt();
-        bool endColumnIsOnStartLine = !lineCount;
-        unsigned endColumn = unlinkedCodeBlock->endColumn() + (endColumnIsOnStartLine ? startColumn : 1);
-        executable->recordParse(unlinkedCodeBlock->codeFeatures(), unlinkedCodeBlock->hasCapturedVariables(), source.firstLine().oneBasedInt() + lineCount, endColumn);
-        source.provider()->setSourceURLDirective(unlinkedCodeBlock->sourceURLDirective());
-        source.provider()->setSourceMappingURLDirective(unlinkedCodeBlock->sourceMappingURLDirective());
+        recordCacheHit(unlinkedCodeBlock, executable, source);
         return unlinkedCodeBlock;
     }
-    
+
+    std::optional<SHA1::Digest> sourceDigest;
+    if (CacheTypes<UnlinkedCodeBlockType>::codeType == SourceCodeType::ProgramType) {
+        if (UnlinkedCodeBlock* cachedCodeBlock = fetchCachedBytecode(vm, key, source, sourceDigest)) {
+            UnlinkedCodeBlockType* unlinkedCodeBlock = jsCast<UnlinkedCodeBlockType*>(cachedCodeBlock);
+            m_sourceCode.addCache(key, SourceCodeValue(vm, unlinkedCodeBlock, m_sourceCode.age()));
+            recordCacheHit(unlinkedCodeBlock, executable, source);
+            return unlinkedCodeBlock;
+        }
+    }
+
     VariableEnvironment variablesUnderTDZ;
     UnlinkedCodeBlockType* unlinkedCodeBlock = generateUnlinkedCodeBlock<UnlinkedCodeBlockType, ExecutableType>(vm, executable, source, strictMode, scriptMode, debuggerMode, error, evalContextType, &variablesUnderTDZ);
 
-    if (unlinkedCodeBlock && Options::useCodeCache())
+    if (unlinkedCodeBlock && Options::useCodeCache()) {
         m_sourceCode.addCache(key, SourceCodeValue(vm, unlinkedCodeBlock, m_sourceCode.age()));
+        if (CacheTypes<UnlinkedCodeBlockType>::codeType == SourceCodeType::ProgramType)
+            storeCachedBytecode(vm, key, unlinkedCodeBlock, sourceDigest);
+    }
 
     return unlinkedCodeBlock;
 }
@@ -40,6 +40,8 @@
 #include "UnlinkedSourceCode.h"
 #include <wtf/CurrentTime.h>
 #include <wtf/Forward.h>
+#include <wtf/Optional.h>
+#include <wtf/SHA1.h>
 #include <wtf/text/WTFString.h>
 
 namespace JSC {
@@ -79,6 +81,7 @@ class CodeCacheMap {
 public:
     typedef HashMap<SourceCodeKey, SourceCodeValue, SourceCodeKey::Hash, SourceCodeKey::HashTraits> MapType;
     typedef MapType::iterator iterator;
+    typedef MapType::const_iterator const_iterator;
     typedef MapType::AddResult AddResult;
 
     CodeCacheMap()
@@ -147,6 +150,9 @@ public:
 
     int64_t age() { return m_age; }
 
+    const_iterator begin() const { return m_map.begin(); }
+    const_iterator end() const { return m_map.end(); }
+
 private:
     // This constant factor biases cache capacity toward allowing a minimum
     // working set to enter the cache before it starts evicting.
@@ -200,7 +206,19 @@ public:
 
     void clear() { m_sourceCode.clear(); }
 
+    // Serializes every cached top-level program into Options::bytecodeCachePath(), so that the
+    // next process to evaluate the same source can skip parsing and bytecode generation.
+    JS_EXPORT_PRIVATE void writeCachedBytecodes(VM&);
+
 private:
+    template <class UnlinkedCodeBlockType, class ExecutableType>
+    void recordCacheHit(UnlinkedCodeBlockType*, ExecutableType*, const SourceCode&);
+
+    // The source digest is computed on first use, and shared between the lookup and the store
+    // that follows a miss.
+    UnlinkedCodeBlock* fetchCachedBytecode(VM&, const SourceCodeKey&, const SourceCode&, std::optional<SHA1::Digest>& sourceDigest);
+    void storeCachedBytecode(VM&, const SourceCodeKey&, UnlinkedCodeBlock*, std::optional<SHA1::Digest>& sourceDigest);
+
     template <class UnlinkedCodeBlockType, class ExecutableType> 
     UnlinkedCodeBlockType* getUnlinkedGlobalCodeBlock(VM&, ExecutableType*, const SourceCode&, JSParserStrictMode, JSParserScriptMode, DebuggerMode, ParserError&, EvalContextType);
 
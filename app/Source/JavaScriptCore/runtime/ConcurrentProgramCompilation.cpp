@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ConcurrentProgramCompilation.h"
+
+#include "CachedBytecode.h"
+#include "CachedTypes.h"
+#include "CodeCache.h"
+#include "JSCInlines.h"
+#include "ProgramExecutable.h"
+#include "SourceCodeKey.h"
+#include "StrongInlines.h"
+#include <wtf/Condition.h>
+#include <wtf/DataLog.h>
+#include <wtf/Lock.h>
+#include <wtf/Locker.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/WorkQueue.h>
+
+namespace JSC {
+
+static const bool verbose = false;
+
+static WorkQueue& compilationQueue()
+{
+    static NeverDestroyed<Ref<WorkQueue>> queue(WorkQueue::create("jsc.program-compilation.queue"));
+    return queue.get();
+}
+
+namespace {
+
+// The VM that background compiles run in. It belongs to the compilation queue: it is created on
+// the queue when a compile starts and destroyed on the queue once no compiles are pending, so it
+// never outlives the work that needs it. The queue is serial, so only one thread uses it at a
+// time, and taking its lock installs its atomic string table on whichever thread that is.
+struct CompilationContext {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    CompilationContext()
+        : vm(VM::createContextGroup())
+    {
+        JSLockHolder locker(vm.get());
+        globalObject.set(*vm, JSGlobalObject::create(*vm, JSGlobalObject::createStructure(*vm, jsNull())));
+    }
+
+    ~CompilationContext()
+    {
+        // The locker keeps its own reference, so the VM is destroyed under its lock when it goes away.
+        JSLockHolder locker(vm.get());
+        globalObject.clear();
+        vm = nullptr;
+    }
+
+    RefPtr<VM> vm;
+    Strong<JSGlobalObject> globalObject;
+};
+
+} // anonymous namespace
+
+// Only touched on the compilation queue.
+static CompilationContext* compilationContext;
+
+static StaticLock pendingCompilationsLock;
+static StaticCondition pendingCompilationsCondition;
+static unsigned pendingCompilations;
+
+RefPtr<ConcurrentProgramCompilation> ConcurrentProgramCompilation::start(StringView source)
+{
+    if (!Options::useConcurrentProgramCompilation() || !Options::useCodeCache())
+        return nullptr;
+    if (source.length() < Options::minimumConcurrentProgramCompilationLength())
+        return nullptr;
+
+    Ref<ConcurrentProgramCompilation> compilation = adoptRef(*new ConcurrentProgramCompilation(source.toString().isolatedCopy()));
+    {
+        auto locker = holdLock(pendingCompilationsLock);
+        ++pendingCompilations;
+    }
+    compilationQueue().dispatch([protectedCompilation = compilation.copyRef()] {
+        protectedCompilation->compile();
+
+        auto locker = holdLock(pendingCompilationsLock);
+        if (--pendingCompilations)
+            return;
+        delete compilationContext;
+        compilationContext = nullptr;
+        pendingCompilationsCondition.notifyAll();
+    });
+    return WTFMove(compilation);
+}
+
+ConcurrentProgramCompilation::ConcurrentProgramCompilation(String&& source)
+    : m_source(WTFMove(source))
+{
+}
+
+ConcurrentProgramCompilation::~ConcurrentProgramCompilation()
+{
+}
+
+void ConcurrentProgramCompilation::compile()
+{
+    {
+        auto locker = holdLock(m_lock);
+        if (m_state == State::Cancelled)
+            return;
+        m_state = State::Compiling;
+    }
+
+    MonotonicTime startTime;
+    if (verbose || Options::reportCompileTimes())
+        startTime = MonotonicTime::now();
+
+    RefPtr<CachedBytecode> cachedBytecode;
+    {
+        if (!compilationContext)
+            compilationContext = new CompilationContext;
+        CompilationContext& context = *compilationContext;
+        VM& vm = *context.vm;
+        JSLockHolder locker(vm);
+
+        // Evaluating a classic script uses these flags unless a debugger or profiler is attached,
+        // in which case the evaluating VM's key will not match and the result is ignored.
+        SourceCode source = makeSource(m_source, SourceOrigin());
+        ProgramExecutable* executable = ProgramExecutable::create(context.globalObject->globalExec(), source);
+        ParserError error;
+        VariableEnvironment variablesUnderTDZ;
+        UnlinkedProgramCodeBlock* unlinkedCodeBlock = generateUnlinkedCodeBlock<UnlinkedProgramCodeBlock>(
+            vm, executable, source, JSParserStrictMode::NotStrict, JSParserScriptMode::Classic, DebuggerOff, error, EvalContextType::None, &variablesUnderTDZ);
+        if (unlinkedCodeBlock) {
+            SourceCodeKey key(
+                source, String(), SourceCodeType::ProgramType, JSParserStrictMode::NotStrict, JSParserScriptMode::Classic,
+                DerivedContextType::None, EvalContextType::None, false, DebuggerOff,
+                TypeProfilerEnabled::No, ControlFlowProfilerEnabled::No);
+            cachedBytecode = encodeCodeBlock(vm, key, computeSourceDigest(key), unlinkedCodeBlock);
+        }
+        m_source = String();
+    }
+
+    if (verbose || Options::reportCompileTimes())
+        dataLogLn("Took ", (MonotonicTime::now() - startTime).microseconds(), " us to compile a program concurrently", cachedBytecode ? "" : " (failed)");
+
+    auto locker = holdLock(m_lock);
+    // The program was evaluated without waiting for us, so nobody will take the result.
+    if (m_state == State::Cancelled)
+        return;
+    m_cachedBytecode = WTFMove(cachedBytecode);
+    m_state = State::Done;
+}
+
+RefPtr<CachedBytecode> ConcurrentProgramCompilation::takeCachedBytecode()
+{
+    auto locker = holdLock(m_lock);
+    if (m_state != State::Done) {
+        m_state = State::Cancelled;
+        return nullptr;
+    }
+    m_state = State::Cancelled;
+    return WTFMove(m_cachedBytecode);
+}
+
+void ConcurrentProgramCompilation::cancel()
+{
+    auto locker = holdLock(m_lock);
+    m_state = State::Cancelled;
+    m_cachedBytecode = nullptr;
+}
+
+void ConcurrentProgramCompilation::waitUntilAllCompilationsAreFinishedForTesting()
+{
+    auto locker = holdLock(pendingCompilationsLock);
+    while (pendingCompilations)
+        pendingCompilationsCondition.wait(pendingCompilationsLock);
+}
+
+} // namespace JSC
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <wtf/Lock.h>
+#include <wtf/ThreadSafeRefCounted.h>
+#include <wtf/text/WTFString.h>
+
+namespace JSC {
+
+class CachedBytecode;
+
+// Parses and generates bytecode for the top-level code of a classic script on a background
+// thread, so that evaluating it later only has to look the result up.
+//
+// Unlinked code blocks are heap objects and cannot move between VMs, so the compile runs in a VM
+// owned by the compilation queue and the result is handed over in the serialized form used by
+// the bytecode cache. The embedder returns it from SourceProvider::cachedBytecode(), and the
+// CodeCache decodes it the first time the program is evaluated.
+class ConcurrentProgramCompilation : public ThreadSafeRefCounted<ConcurrentProgramCompilation> {
+public:
+    // Copies the source and queues it for compilation. Returns null if the result could not be
+    // used or the source is too short to be worth compiling in the background.
+    JS_EXPORT_PRIVATE static RefPtr<ConcurrentProgramCompilation> start(StringView source);
+
+    // Called on the thread that evaluates the program. Never blocks: returns the result if the
+    // compile has finished and null otherwise, in which case the compile is abandoned and the
+    // program is compiled on the calling thread as usual. Null is also returned if the source
+    // failed to parse or the result was already taken.
+    JS_EXPORT_PRIVATE RefPtr<CachedBytecode> takeCachedBytecode();
+
+    // Drops the compile and its result. The embedder calls this when the source goes away.
+    JS_EXPORT_PRIVATE void cancel();
+
+    JS_EXPORT_PRIVATE static void waitUntilAllCompilationsAreFinishedForTesting();
+
+    JS_EXPORT_PRIVATE ~ConcurrentProgramCompilation();
+
+private:
+    explicit ConcurrentProgramCompilation(String&& source);
+
+    void compile();
+
+    enum class State { Queued, Compiling, Done, Cancelled };
+
+    Lock m_lock;
+    State m_state { State::Queued };
+    // Only touched on the compilation thread once the compilation has been queued.
+    String m_source;
+    RefPtr<CachedBytecode> m_cachedBytecode;
+};
+
+} // namespace JSC
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "IntlCache.h"
+
+#if ENABLE(INTL)
+
+namespace JSC {
+
+UCollator* IntlCache::cloneCollator(const String& key)
+{
+    auto* entry = m_collators.find(key);
+    if (!entry)
+        return nullptr;
+
+    UErrorCode status = U_ZERO_ERROR;
+    UCollator* collator = ucol_safeClone(entry->object, nullptr, nullptr, &status);
+    if (U_FAILURE(status)) {
+        if (collator)
+            ucol_close(collator);
+        return nullptr;
+    }
+    return collator;
+}
+
+UNumberFormat* IntlCache::cloneNumberFormat(const String& key)
+{
+    auto* entry = m_numberFormats.find(key);
+    if (!entry)
+        return nullptr;
+
+    UErrorCode status = U_ZERO_ERROR;
+    UNumberFormat* numberFormat = unum_clone(entry->object, &status);
+    if (U_FAILURE(status)) {
+        if (numberFormat)
+            unum_close(numberFormat);
+        return nullptr;
+    }
+    return numberFormat;
+}
+
+UDateFormat* IntlCache::cloneDateFormat(const String& key, String& pattern)
+{
+    auto* entry = m_dateFormats.find(key);
+    if (!entry)
+        return nullptr;
+
+    UErrorCode status = U_ZERO_ERROR;
+    UDateFormat* dateFormat = udat_clone(entry->object, &status);
+    if (U_FAILURE(status)) {
+        if (dateFormat)
+            udat_close(dateFormat);
+        return nullptr;
+    }
+    pattern = entry->pattern;
+    return dateFormat;
+}
+
+void IntlCache::addCollator(const String& key, const UCollator* collator)
+{
+    UErrorCode status = U_ZERO_ERROR;
+    UCollator* clone = ucol_safeClone(collator, nullptr, nullptr, &status);
+    if (U_FAILURE(status)) {
+        if (clone)
+            ucol_close(clone);
+        return;
+    }
+    m_collators.add(key, clone);
+}
+
+void IntlCache::addNumberFormat(const String& key, const UNumberFormat* numberFormat)
+{
+    UErrorCode status = U_ZERO_ERROR;
+    UNumberFormat* clone = unum_clone(numberFormat, &status);
+    if (U_FAILURE(status)) {
+        if (clone)
+            unum_close(clone);
+        return;
+    }
+    m_numberFormats.add(key, clone);
+}
+
+void IntlCache::addDateFormat(const String& key, const UDateFormat* dateFormat, const String& pattern)
+{
+    UErrorCode status = U_ZERO_ERROR;
+    UDateFormat* clone = udat_clone(dateFormat, &status);
+    if (U_FAILURE(status)) {
+        if (clone)
+            udat_close(clone);
+        return;
+    }
+    m_dateFormats.add(key, clone, pattern);
+}
+
+} // namespace JSC
+
+#endif // ENABLE(INTL)
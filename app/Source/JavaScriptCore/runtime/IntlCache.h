@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if ENABLE(INTL)
+
+#include <unicode/ucol.h>
+#include <unicode/udat.h>
+#include <unicode/unum.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace JSC {
+
+// Opening an ICU collator or formatter loads and parses locale data, which costs far more than
+// the comparison or formatting it is then used for. Code like String.prototype.localeCompare and
+// Date.prototype.toLocaleString creates a new Intl object on every call, so each global object
+// keeps the most recently opened ICU objects here, keyed by the resolved locale and options.
+//
+// The cached objects are never used directly. Each Intl object gets its own clone, which is much
+// cheaper than opening a new one.
+class IntlCache {
+    WTF_MAKE_NONCOPYABLE(IntlCache);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    IntlCache() = default;
+
+    // These return null if nothing is cached for the key, or if cloning fails.
+    UCollator* cloneCollator(const String& key);
+    UNumberFormat* cloneNumberFormat(const String& key);
+    // Also returns the pattern the date format was opened with.
+    UDateFormat* cloneDateFormat(const String& key, String& pattern);
+
+    // These clone the object passed in, so the caller keeps ownership of it.
+    void addCollator(const String& key, const UCollator*);
+    void addNumberFormat(const String& key, const UNumberFormat*);
+    void addDateFormat(const String& key, const UDateFormat*, const String& pattern);
+
+private:
+    template<typename ICUType, void (*closeFunction)(ICUType*), size_t capacity = 8>
+    class LRU {
+    public:
+        struct Entry {
+            String key;
+            ICUType* object;
+            String pattern;
+        };
+
+        ~LRU()
+        {
+            for (auto& entry : m_entries)
+                closeFunction(entry.object);
+        }
+
+        const Entry* find(const String& key)
+        {
+            for (size_t i = m_entries.size(); i--;) {
+                if (m_entries[i].key != key)
+                    continue;
+
+                // The last entry is the most recently used one.
+                if (i != m_entries.size() - 1) {
+                    Entry entry = WTFMove(m_entries[i]);
+                    m_entries.remove(i);
+                    m_entries.append(WTFMove(entry));
+                }
+                return &m_entries.last();
+            }
+            return nullptr;
+        }
+
+        void add(const String& key, ICUType* object, const String& pattern = String())
+        {
+            if (m_entries.size() == capacity) {
+                closeFunction(m_entries[0].object);
+                m_entries.remove(0);
+            }
+            m_entries.append(Entry { key, object, pattern });
+        }
+
+    private:
+        Vector<Entry, capacity> m_entries;
+    };
+
+    LRU<UCollator, ucol_close> m_collators;
+    LRU<UNumberFormat, unum_close> m_numberFormats;
+    LRU<UDateFormat, udat_close> m_dateFormats;
+};
+
+} // namespace JSC
+
+#endif // ENABLE(INTL)
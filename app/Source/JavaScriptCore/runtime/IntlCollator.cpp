@@ -31,6 +31,7 @@
 #if ENABLE(INTL)
 
 #include "Error.h"
+#include "IntlCache.h"
 #include "IntlCollatorConstructor.h"
 #include "IntlObject.h"
 #include "JSBoundFunction.h"
@@ -39,6 +40,8 @@
 #include "SlotVisitorInlines.h"
 #include "StructureInlines.h"
 #include <unicode/ucol.h>
+#include <wtf/text/ASCIIFastPath.h>
+#include <wtf/text/StringBuilder.h>
 #include <wtf/unicode/Collator.h>
 
 namespace JSC {
@@ -311,6 +314,7 @@ void IntlCollator::initializeCollator(ExecState& state, JSValue locales, JSValue
     // 31. Set collator.[[boundCompare]] to undefined.
     // 32. Set collator.[[initializedCollator]] to true.
     m_initializedCollator = true;
+    m_canCompareASCIIStringsWithoutICU = canCompareASCIIStringsWithoutICU();
 
     // 33. Return collator.
 }
@@ -326,6 +330,13 @@ void IntlCollator::createCollator(ExecState& state)
         ASSERT_UNUSED(scope, !scope.exception());
     }
 
+    IntlCache& cache = globalObject()->intlCache();
+    String key = cacheKey();
+    if (UCollator* cachedCollator = cache.cloneCollator(key)) {
+        m_collator = std::unique_ptr<UCollator, UCollatorDeleter>(cachedCollator);
+        return;
+    }
+
     UErrorCode status = U_ZERO_ERROR;
     auto collator = std::unique_ptr<UCollator, UCollatorDeleter>(ucol_open(m_locale.utf8().data(), &status));
     if (U_FAILURE(status))
@@ -363,15 +374,131 @@ void IntlCollator::createCollator(ExecState& state)
     if (U_FAILURE(status))
         return;
 
+    cache.addCollator(key, collator.get());
     m_collator = WTFMove(collator);
 }
 
+String IntlCollator::cacheKey() const
+{
+    // Usage and collation are not listed because they only reach ICU through the locale's extensions.
+    StringBuilder key;
+    key.append(m_locale);
+    key.append('|');
+    key.append(sensitivityString(m_sensitivity));
+    key.append(m_numeric ? "|kn" : "|");
+    key.append(m_ignorePunctuation ? "|ip" : "|");
+    return key.toString();
+}
+
+// Languages whose default collation orders ASCII exactly as the root collation does. Many others,
+// such as Danish ("aa" after "z"), Czech ("ch" after "h") and Welsh, have tailorings that do not.
+static const char* const languagesWithRootASCIIOrder[] = { "ca", "de", "en", "es", "fr", "it", "ja", "ko", "nl", "pt", "ru" };
+
+bool IntlCollator::canCompareASCIIStringsWithoutICU() const
+{
+    if (m_numeric || m_ignorePunctuation || m_collation != "default")
+        return false;
+
+    // Only a bare language or a language and region qualify. Scripts, variants and extensions such as
+    // -u-co-trad or -u-va-posix can all change the order.
+    size_t separator = m_locale.find('-');
+    String language = m_locale.left(separator);
+    if (separator != notFound) {
+        size_t regionLength = m_locale.length() - separator - 1;
+        if (regionLength != 2 && regionLength != 3)
+            return false;
+        for (unsigned i = separator + 1; i < m_locale.length(); ++i) {
+            if (!isASCIIAlphanumeric(m_locale[i]))
+                return false;
+        }
+    }
+
+    for (const char* candidate : languagesWithRootASCIIOrder) {
+        if (language == candidate)
+            return true;
+    }
+    return false;
+}
+
+// The primary weights the root collation gives each ASCII character, with zero for the ones it
+// ignores (control characters other than whitespace, and DEL). Whitespace sorts before
+// punctuation and symbols, which sort before digits, which sort before letters. Upper and lower
+// case letters share a primary weight.
+static const uint8_t asciiPrimaryWeights[128] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    6, 12, 16, 28, 38, 29, 27, 15, 17, 18, 24, 32, 9, 8, 14, 25,
+    39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 11, 10, 33, 34, 35, 13,
+    23, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63,
+    64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 19, 26, 20, 31, 7,
+    30, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63,
+    64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 21, 36, 22, 37, 0,
+};
+
+static bool isAllASCII(StringView string)
+{
+    if (string.is8Bit())
+        return charactersAreAllASCII(string.characters8(), string.length());
+    return charactersAreAllASCII(string.characters16(), string.length());
+}
+
+// Compares two ASCII strings the way ICU's root collation does: first by the primary weights of
+// the characters that are not ignorable, and then, if case matters, by the case of the letters,
+// with lower case first.
+static int compareASCIIWithRootCollation(StringView x, StringView y, bool considerCase)
+{
+    unsigned xLength = x.length();
+    unsigned yLength = y.length();
+    int caseResult = 0;
+    unsigned i = 0;
+    unsigned j = 0;
+    while (true) {
+        uint8_t xWeight = 0;
+        UChar xCharacter = 0;
+        while (i < xLength && !(xWeight = asciiPrimaryWeights[xCharacter = x[i++]])) { }
+        uint8_t yWeight = 0;
+        UChar yCharacter = 0;
+        while (j < yLength && !(yWeight = asciiPrimaryWeights[yCharacter = y[j++]])) { }
+
+        if (xWeight != yWeight) {
+            // A string that runs out first sorts first, and its weight reads as zero here.
+            return xWeight < yWeight ? -1 : 1;
+        }
+        if (!xWeight)
+            return caseResult;
+
+        if (considerCase && !caseResult && xCharacter != yCharacter) {
+            // Same primary weight but different characters means the same letter in different cases.
+            caseResult = isASCIILower(xCharacter) ? -1 : 1;
+        }
+    }
+}
+
 JSValue IntlCollator::compareStrings(ExecState& state, StringView x, StringView y)
 {
     VM& vm = state.vm();
     auto scope = DECLARE_THROW_SCOPE(vm);
 
     // 10.3.4 CompareStrings abstract operation (ECMA-402 2.0)
+    if (!m_initializedCollator) {
+        initializeCollator(state, jsUndefined(), jsUndefined());
+        RETURN_IF_EXCEPTION(scope, { });
+    }
+
+    if (m_canCompareASCIIStringsWithoutICU && isAllASCII(x) && isAllASCII(y)) {
+        bool considerCase = m_sensitivity == Sensitivity::Case || m_sensitivity == Sensitivity::Variant;
+        return jsNumber(compareASCIIWithRootCollation(x, y, considerCase));
+    }
+
+    scope.release();
+    return compareStringsWithICU(state, x, y);
+}
+
+JSValue IntlCollator::compareStringsWithICU(ExecState& state, StringView x, StringView y)
+{
+    VM& vm = state.vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
     if (!m_collator) {
         createCollator(state);
         if (!m_collator)
@@ -387,6 +514,20 @@ JSValue IntlCollator::compareStrings(ExecState& state, StringView x, StringView
     return jsNumber(result);
 }
 
+JSValue IntlCollator::compareStringsWithICUForTesting(ExecState& state, StringView x, StringView y)
+{
+    VM& vm = state.vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    if (!m_initializedCollator) {
+        initializeCollator(state, jsUndefined(), jsUndefined());
+        RETURN_IF_EXCEPTION(scope, { });
+    }
+
+    scope.release();
+    return compareStringsWithICU(state, x, y);
+}
+
 const char* IntlCollator::usageString(Usage usage)
 {
     switch (usage) {
@@ -49,6 +49,10 @@ public:
     JSValue compareStrings(ExecState&, StringView, StringView);
     JSObject* resolvedOptions(ExecState&);
 
+    // Lets tests check compareStrings()' ASCII fast path against ICU.
+    bool comparesASCIIStringsWithoutICU() const { return m_canCompareASCIIStringsWithoutICU; }
+    JS_EXPORT_PRIVATE JSValue compareStringsWithICUForTesting(ExecState&, StringView, StringView);
+
     JSBoundFunction* boundCompare() const { return m_boundCompare.get(); }
     void setBoundCompare(VM&, JSBoundFunction*);
 
@@ -67,6 +71,9 @@ private:
     };
 
     void createCollator(ExecState&);
+    JSValue compareStringsWithICU(ExecState&, StringView, StringView);
+    String cacheKey() const;
+    bool canCompareASCIIStringsWithoutICU() const;
     static const char* usageString(Usage);
     static const char* sensitivityString(Sensitivity);
 
@@ -79,6 +86,7 @@ private:
     bool m_numeric;
     bool m_ignorePunctuation;
     bool m_initializedCollator { false };
+    bool m_canCompareASCIIStringsWithoutICU { false };
 };
 
 } // namespace JSC
@@ -31,6 +31,7 @@
 
 #include "DateInstance.h"
 #include "Error.h"
+#include "IntlCache.h"
 #include "IntlDateTimeFormatConstructor.h"
 #include "IntlObject.h"
 #include "JSBoundFunction.h"
@@ -620,6 +621,29 @@ void IntlDateTimeFormat::initializeDateTimeFormat(ExecState& exec, JSValue local
     // 27. ReturnIfAbrupt(matcher).
     RETURN_IF_EXCEPTION(scope, void());
 
+    String skeleton = skeletonBuilder.toString();
+
+    // Reuse the pattern and formatter of an earlier DateTimeFormat with the same locale, time zone
+    // and fields, so repeated calls to Date.prototype.toLocaleString skip the pattern generator.
+    StringBuilder keyBuilder;
+    keyBuilder.append(m_locale);
+    keyBuilder.append('|');
+    keyBuilder.append(dataLocale);
+    keyBuilder.append('|');
+    keyBuilder.append(m_timeZone);
+    keyBuilder.append('|');
+    keyBuilder.append(skeleton);
+    String key = keyBuilder.toString();
+
+    IntlCache& cache = globalObject()->intlCache();
+    String cachedPattern;
+    if (UDateFormat* cachedDateFormat = cache.cloneDateFormat(key, cachedPattern)) {
+        setFormatsFromPattern(cachedPattern);
+        m_dateFormat = std::unique_ptr<UDateFormat, UDateFormatDeleter>(cachedDateFormat);
+        m_initializedDateTimeFormat = true;
+        return;
+    }
+
     // Always use ICU date format generator, rather than our own pattern list and matcher.
     // Covers steps 28-36.
     UErrorCode status = U_ZERO_ERROR;
@@ -629,7 +653,6 @@ void IntlDateTimeFormat::initializeDateTimeFormat(ExecState& exec, JSValue local
         return;
     }
 
-    String skeleton = skeletonBuilder.toString();
     StringView skeletonView(skeleton);
     Vector<UChar, 32> patternBuffer(32);
     status = U_ZERO_ERROR;
@@ -655,6 +678,7 @@ void IntlDateTimeFormat::initializeDateTimeFormat(ExecState& exec, JSValue local
         throwTypeError(&exec, scope, ASCIILiteral("failed to initialize DateTimeFormat"));
         return;
     }
+    cache.addDateFormat(key, m_dateFormat.get(), pattern.toString());
 
     // 37. Set dateTimeFormat.[[boundFormat]] to undefined.
     // Already undefined.
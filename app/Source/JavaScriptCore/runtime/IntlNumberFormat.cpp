@@ -31,12 +31,14 @@
 #if ENABLE(INTL)
 
 #include "Error.h"
+#include "IntlCache.h"
 #include "IntlNumberFormatConstructor.h"
 #include "IntlObject.h"
 #include "JSBoundFunction.h"
 #include "JSCInlines.h"
 #include "ObjectConstructor.h"
 #include <unicode/ucurr.h>
+#include <wtf/text/StringBuilder.h>
 
 namespace JSC {
 
@@ -344,6 +346,27 @@ void IntlNumberFormat::createNumberFormat(ExecState& state)
         ASSERT_NOT_REACHED();
     }
 
+    // Everything that goes into opening and configuring the ICU formatter.
+    StringBuilder keyBuilder;
+    keyBuilder.append(m_locale);
+    keyBuilder.append('|');
+    keyBuilder.appendNumber(static_cast<int>(style));
+    keyBuilder.append('|');
+    keyBuilder.append(m_currency);
+    keyBuilder.append('|');
+    for (unsigned digits : { m_minimumIntegerDigits, m_minimumFractionDigits, m_maximumFractionDigits, m_minimumSignificantDigits, m_maximumSignificantDigits }) {
+        keyBuilder.appendNumber(digits);
+        keyBuilder.append(',');
+    }
+    keyBuilder.append(m_useGrouping ? "g" : "");
+    String key = keyBuilder.toString();
+
+    IntlCache& cache = globalObject()->intlCache();
+    if (UNumberFormat* cachedNumberFormat = cache.cloneNumberFormat(key)) {
+        m_numberFormat = std::unique_ptr<UNumberFormat, UNumberFormatDeleter>(cachedNumberFormat);
+        return;
+    }
+
     UErrorCode status = U_ZERO_ERROR;
     auto numberFormat = std::unique_ptr<UNumberFormat, UNumberFormatDeleter>(unum_open(style, nullptr, 0, m_locale.utf8().data(), nullptr, &status));
     if (U_FAILURE(status))
@@ -365,6 +388,7 @@ void IntlNumberFormat::createNumberFormat(ExecState& state)
     if (U_FAILURE(status))
         return;
 
+    cache.addNumberFormat(key, numberFormat.get());
     m_numberFormat = WTFMove(numberFormat);
 }
 
@@ -32,6 +32,7 @@
 #include "JSArrayBuffer.h"
 #include "JSGenericTypedArrayView.h"
 #include "TypeError.h"
+#include "TypedArrayKernels.h"
 #include "TypedArrays.h"
 
 namespace JSC {
@@ -202,10 +203,15 @@ bool JSGenericTypedArrayView<Adaptor>::setWithSpecificType(
 
     unsigned otherElementSize = sizeof(typename OtherAdaptor::Type);
 
-    // Handle cases (1) and (2A).
+    // Handle case (1).
     if (!hasArrayBuffer() || !other->hasArrayBuffer()
-        || existingBuffer() != other->existingBuffer()
-        || (elementSize == otherElementSize && vector() <= other->vector())
+        || existingBuffer() != other->existingBuffer()) {
+        TypedArrayKernels::convert<Adaptor, OtherAdaptor>(typedVector() + offset, other->typedVector() + otherOffset, length);
+        return true;
+    }
+
+    // Handle case (2A).
+    if ((elementSize == otherElementSize && vector() <= other->vector())
         || type == CopyType::LeftToRight) {
         for (unsigned i = 0; i < length; ++i) {
             setIndexQuicklyToNativeValue(
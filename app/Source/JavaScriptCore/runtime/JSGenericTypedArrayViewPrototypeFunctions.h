@@ -38,6 +38,7 @@
 #include "StructureInlines.h"
 #include "TypedArrayAdaptors.h"
 #include "TypedArrayController.h"
+#include "TypedArrayKernels.h"
 #include <wtf/StdLibExtras.h>
 
 namespace JSC {
@@ -179,6 +180,32 @@ EncodedJSValue JSC_HOST_CALL genericTypedArrayViewProtoFuncCopyWithin(VM& vm, Ex
     return JSValue::encode(exec->thisValue());
 }
 
+template<typename ViewClass>
+EncodedJSValue JSC_HOST_CALL genericTypedArrayViewProtoFuncFill(VM& vm, ExecState* exec)
+{
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    // 22.2.3.8
+    ViewClass* thisObject = jsCast<ViewClass*>(exec->thisValue());
+    if (thisObject->isNeutered())
+        return throwVMTypeError(exec, scope, typedArrayBufferHasBeenDetachedErrorMessage);
+
+    unsigned length = thisObject->length();
+
+    typename ViewClass::ElementType value = ViewClass::toAdaptorNativeFromValue(exec, exec->argument(0));
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+    unsigned start = argumentClampedIndexFromStartOrEnd(exec, 1, length);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+    unsigned end = argumentClampedIndexFromStartOrEnd(exec, 2, length, length);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+
+    if (thisObject->isNeutered())
+        return throwVMTypeError(exec, scope, typedArrayBufferHasBeenDetachedErrorMessage);
+
+    TypedArrayKernels::fill(thisObject->typedVector(), start, end, value);
+    return JSValue::encode(thisObject);
+}
+
 template<typename ViewClass>
 EncodedJSValue JSC_HOST_CALL genericTypedArrayViewProtoFuncIncludes(VM& vm, ExecState* exec)
 {
@@ -209,19 +236,9 @@ EncodedJSValue JSC_HOST_CALL genericTypedArrayViewProtoFuncIncludes(VM& vm, Exec
     ASSERT(!scope.exception());
     RELEASE_ASSERT(!thisObject->isNeutered());
 
-    if (std::isnan(static_cast<double>(*targetOption))) {
-        for (; index < length; ++index) {
-            if (std::isnan(static_cast<double>(array[index])))
-                return JSValue::encode(jsBoolean(true));
-        }
-    } else {
-        for (; index < length; ++index) {
-            if (array[index] == targetOption)
-                return JSValue::encode(jsBoolean(true));
-        }
-    }
-
-    return JSValue::encode(jsBoolean(false));
+    if (std::isnan(static_cast<double>(*targetOption)))
+        return JSValue::encode(jsBoolean(TypedArrayKernels::findNaN(array, index, length) != notFound));
+    return JSValue::encode(jsBoolean(TypedArrayKernels::indexOf(array, index, length, *targetOption) != notFound));
 }
 
 template<typename ViewClass>
@@ -253,12 +270,10 @@ EncodedJSValue JSC_HOST_CALL genericTypedArrayViewProtoFuncIndexOf(VM& vm, ExecS
     ASSERT(!scope.exception());
     RELEASE_ASSERT(!thisObject->isNeutered());
 
-    for (; index < length; ++index) {
-        if (array[index] == targetOption)
-            return JSValue::encode(jsNumber(index));
-    }
-
-    return JSValue::encode(jsNumber(-1));
+    size_t result = TypedArrayKernels::indexOf(array, index, length, *targetOption);
+    if (result == notFound)
+        return JSValue::encode(jsNumber(-1));
+    return JSValue::encode(jsNumber(static_cast<unsigned>(result)));
 }
 
 template<typename ViewClass>
@@ -344,12 +359,12 @@ EncodedJSValue JSC_HOST_CALL genericTypedArrayViewProtoFuncLastIndexOf(VM& vm, E
     ASSERT(!scope.exception());
     RELEASE_ASSERT(!thisObject->isNeutered());
 
-    for (; index >= 0; --index) {
-        if (array[index] == targetOption)
-            return JSValue::encode(jsNumber(index));
-    }
-
-    return JSValue::encode(jsNumber(-1));
+    if (index < 0)
+        return JSValue::encode(jsNumber(-1));
+    size_t result = TypedArrayKernels::lastIndexOf(array, index, *targetOption);
+    if (result == notFound)
+        return JSValue::encode(jsNumber(-1));
+    return JSValue::encode(jsNumber(static_cast<unsigned>(result)));
 }
 
 template<typename ViewClass>
@@ -399,8 +414,7 @@ EncodedJSValue JSC_HOST_CALL genericTypedArrayViewProtoFuncReverse(VM& vm, ExecS
     if (thisObject->isNeutered())
         return throwVMTypeError(exec, scope, typedArrayBufferHasBeenDetachedErrorMessage);
 
-    typename ViewClass::ElementType* array = thisObject->typedVector();
-    std::reverse(array, array + thisObject->length());
+    TypedArrayKernels::reverse(thisObject->typedVector(), thisObject->length());
 
     return JSValue::encode(thisObject);
 }
@@ -55,11 +55,39 @@ private:
     Strong<JSArray> m_arguments;
 };
 
+class AsyncFunctionResumeMicrotask final : public Microtask {
+public:
+    AsyncFunctionResumeMicrotask(VM& vm, JSObject* generator, JSObject* promiseCapability, JSValue argument, JSGeneratorFunction::GeneratorResumeMode resumeMode)
+        : m_resumeMode(resumeMode)
+    {
+        m_generator.set(vm, generator);
+        m_promiseCapability.set(vm, promiseCapability);
+        m_argument.set(vm, argument);
+    }
+
+    virtual ~AsyncFunctionResumeMicrotask()
+    {
+    }
+
+private:
+    void run(ExecState*) override;
+
+    Strong<JSObject> m_generator;
+    Strong<JSObject> m_promiseCapability;
+    Strong<Unknown> m_argument;
+    JSGeneratorFunction::GeneratorResumeMode m_resumeMode;
+};
+
 Ref<Microtask> createJSJob(VM& vm, JSValue job, JSArray* arguments)
 {
     return adoptRef(*new JSJobMicrotask(vm, job, arguments));
 }
 
+Ref<Microtask> createAsyncFunctionResumeJob(VM& vm, JSObject* generator, JSObject* promiseCapability, JSValue argument, JSGeneratorFunction::GeneratorResumeMode resumeMode)
+{
+    return adoptRef(*new AsyncFunctionResumeMicrotask(vm, generator, promiseCapability, argument, resumeMode));
+}
+
 void JSJobMicrotask::run(ExecState* exec)
 {
     VM& vm = exec->vm();
@@ -76,4 +104,23 @@ void JSJobMicrotask::run(ExecState* exec)
     scope.clearException();
 }
 
+void AsyncFunctionResumeMicrotask::run(ExecState* exec)
+{
+    VM& vm = exec->vm();
+    auto scope = DECLARE_CATCH_SCOPE(vm);
+
+    JSFunction* asyncFunctionResume = exec->lexicalGlobalObject()->asyncFunctionResumeFunction();
+    CallData callData;
+    CallType callType = getCallData(asyncFunctionResume, callData);
+    ASSERT(callType != CallType::None);
+
+    MarkedArgumentBuffer arguments;
+    arguments.append(m_generator.get());
+    arguments.append(m_promiseCapability.get());
+    arguments.append(m_argument.get());
+    arguments.append(jsNumber(static_cast<int32_t>(m_resumeMode)));
+    profiledCall(exec, ProfilingReason::Microtask, asyncFunctionResume, callType, callData, jsUndefined(), arguments);
+    scope.clearException();
+}
+
 } // namespace JSC
@@ -26,6 +26,7 @@
 #pragma once
 
 #include "JSCell.h"
+#include "JSGeneratorFunction.h"
 #include "Structure.h"
 
 namespace JSC {
@@ -35,4 +36,9 @@ class JSArray;
 
 Ref<Microtask> createJSJob(VM&, JSValue job, JSArray* arguments);
 
+// Resumes an async function once the value it awaits is settled. This is what a promise reaction
+// job calling back into @asyncFunctionResume would do, without the reaction's handler closures
+// or an arguments array.
+Ref<Microtask> createAsyncFunctionResumeJob(VM&, JSObject* generator, JSObject* promiseCapability, JSValue argument, JSGeneratorFunction::GeneratorResumeMode);
+
 } // namespace JSC
@@ -91,6 +91,17 @@ public:
     void visitAggregate(SlotVisitor&);
 
 private:
+    // A plain object's enumerable properties are fixed by its structure, so we look them up once
+    // per structure rather than once per object. We also keep each name already quoted and
+    // followed by its separator. The object may still change while we stringify its values, so
+    // whoever uses these has to check that the object still has the structure.
+    struct StructureProperty {
+        Identifier name;
+        PropertyOffset offset;
+        String quotedNameAndSeparator;
+    };
+    const Vector<StructureProperty>* cachedStructureProperties(JSObject*, Structure*&);
+
     class Holder {
     public:
         enum RootHolderTag { RootHolder };
@@ -109,6 +120,8 @@ private:
         unsigned m_index;
         unsigned m_size;
         RefPtr<PropertyNameArrayData> m_propertyNames;
+        Structure* m_structure { nullptr };
+        const Vector<StructureProperty>* m_structureProperties { nullptr };
     };
 
     friend class Holder;
@@ -135,6 +148,10 @@ private:
     Vector<Holder, 16, UnsafeVectorOverflow> m_holderStack;
     String m_repeatedGap;
     String m_indent;
+
+    HashMap<Structure*, std::unique_ptr<Vector<StructureProperty>>> m_structureProperties;
+    // Keeps the structures in m_structureProperties alive, so that their addresses are not reused.
+    MarkedArgumentBuffer m_cachedStructures;
 };
 
 // ------------------------------ helper functions --------------------------------
@@ -409,6 +426,41 @@ Stringifier::StringifyResult Stringifier::appendStringifiedValue(StringBuilder&
     return StringifySucceeded;
 }
 
+auto Stringifier::cachedStructureProperties(JSObject* object, Structure*& structure) -> const Vector<StructureProperty>*
+{
+    VM& vm = m_exec->vm();
+    structure = object->structure(vm);
+    if (object->type() != FinalObjectType
+        || structure->isDictionary()
+        || hasIndexedProperties(structure->indexingType())
+        || structure->hasGetterSetterProperties()
+        || structure->hasCustomGetterSetterProperties())
+        return nullptr;
+
+    auto result = m_structureProperties.add(structure, nullptr);
+    if (!result.isNewEntry)
+        return result.iterator->value.get();
+
+    auto properties = std::make_unique<Vector<StructureProperty>>();
+    PropertyNameArray propertyNames(m_exec, PropertyNameMode::Strings);
+    structure->getPropertyNamesFromStructure(vm, propertyNames, EnumerationMode());
+    properties->reserveInitialCapacity(propertyNames.size());
+    for (const Identifier& name : propertyNames.propertyNameVector()) {
+        PropertyOffset offset = structure->get(vm, name);
+        ASSERT(isValidOffset(offset));
+        StringBuilder quotedNameAndSeparator;
+        quotedNameAndSeparator.appendQuotedJSONString(name.string());
+        quotedNameAndSeparator.append(':');
+        if (willIndent())
+            quotedNameAndSeparator.append(' ');
+        properties->uncheckedAppend(StructureProperty { name, offset, quotedNameAndSeparator.toString() });
+    }
+
+    m_cachedStructures.append(structure);
+    result.iterator->value = WTFMove(properties);
+    return result.iterator->value.get();
+}
+
 inline bool Stringifier::willIndent() const
 {
     return !m_gap.isEmpty();
@@ -483,13 +535,16 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, StringBui
         } else {
             if (stringifier.m_usingArrayReplacer)
                 m_propertyNames = stringifier.m_arrayReplacerPropertyNames.data();
+            else if ((m_structureProperties = stringifier.cachedStructureProperties(m_object.get(), m_structure)))
+                m_size = m_structureProperties->size();
             else {
                 PropertyNameArray objectPropertyNames(exec, PropertyNameMode::Strings);
                 m_object->methodTable()->getOwnPropertyNames(m_object.get(), exec, objectPropertyNames, EnumerationMode());
                 RETURN_IF_EXCEPTION(scope, false);
                 m_propertyNames = objectPropertyNames.releaseData();
             }
-            m_size = m_propertyNames->propertyNameVector().size();
+            if (m_propertyNames)
+                m_size = m_propertyNames->propertyNameVector().size();
             builder.append('{');
         }
         stringifier.indent();
@@ -531,13 +586,25 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, StringBui
         stringifyResult = stringifier.appendStringifiedValue(builder, value, *this, index);
         ASSERT(stringifyResult != StringifyFailedDueToUndefinedOrSymbolValue);
     } else {
-        // Get the value.
-        PropertySlot slot(m_object.get(), PropertySlot::InternalMethodType::Get);
-        Identifier& propertyName = m_propertyNames->propertyNameVector()[index];
-        if (!m_object->methodTable()->getOwnPropertySlot(m_object.get(), exec, propertyName, slot))
-            return true;
-        JSValue value = slot.getValue(exec, propertyName);
-        RETURN_IF_EXCEPTION(scope, false);
+        // Get the value. A toJSON function or the replacer may have changed the object since we
+        // looked up its properties, in which case we go the slow way.
+        const StructureProperty* structureProperty = nullptr;
+        const Identifier* propertyName;
+        JSValue value;
+        if (m_structureProperties) {
+            structureProperty = &m_structureProperties->at(index);
+            propertyName = &structureProperty->name;
+            if (m_object->structureID() == m_structure->id())
+                value = m_object->getDirect(structureProperty->offset);
+        } else
+            propertyName = &m_propertyNames->propertyNameVector()[index];
+        if (!value) {
+            PropertySlot slot(m_object.get(), PropertySlot::InternalMethodType::Get);
+            if (!m_object->methodTable()->getOwnPropertySlot(m_object.get(), exec, *propertyName, slot))
+                return true;
+            value = slot.getValue(exec, *propertyName);
+            RETURN_IF_EXCEPTION(scope, false);
+        }
 
         rollBackPoint = builder.length();
 
@@ -547,13 +614,17 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, StringBui
         stringifier.startNewLine(builder);
 
         // Append the property name.
-        builder.appendQuotedJSONString(propertyName.string());
-        builder.append(':');
-        if (stringifier.willIndent())
-            builder.append(' ');
+        if (structureProperty)
+            builder.append(structureProperty->quotedNameAndSeparator);
+        else {
+            builder.appendQuotedJSONString(propertyName->string());
+            builder.append(':');
+            if (stringifier.willIndent())
+                builder.append(' ');
+        }
 
         // Append the stringified value.
-        stringifyResult = stringifier.appendStringifiedValue(builder, value, *this, propertyName);
+        stringifyResult = stringifier.appendStringifiedValue(builder, value, *this, *propertyName);
     }
     RETURN_IF_EXCEPTION(scope, false);
 
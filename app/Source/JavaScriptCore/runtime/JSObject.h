@@ -569,6 +569,9 @@ public:
     bool putDirect(VM&, PropertyName, JSValue, unsigned attributes = 0);
     bool putDirect(VM&, PropertyName, JSValue, PutPropertySlot&);
     void putDirectWithoutTransition(VM&, PropertyName, JSValue, unsigned attributes = 0);
+    // Adds a property with no attributes by taking a transition from this object's structure that
+    // the caller already found, such as one that an earlier object with the same shape took.
+    void putDirectWithKnownTransition(VM&, Structure* newStructure, PropertyName, PropertyOffset, JSValue);
     bool putDirectNonIndexAccessor(VM&, PropertyName, JSValue, unsigned attributes);
     bool putDirectAccessor(ExecState*, PropertyName, JSValue, unsigned attributes);
     JS_EXPORT_PRIVATE bool putDirectCustomAccessor(VM&, PropertyName, JSValue, unsigned attributes);
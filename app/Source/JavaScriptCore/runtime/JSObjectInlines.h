@@ -171,6 +171,27 @@ inline void JSObject::putDirectWithoutTransition(VM& vm, PropertyName propertyNa
         structure->setContainsReadOnlyProperties();
 }
 
+ALWAYS_INLINE void JSObject::putDirectWithKnownTransition(VM& vm, Structure* newStructure, PropertyName propertyName, PropertyOffset offset, JSValue value)
+{
+    StructureID structureID = this->structureID();
+    Structure* structure = vm.heap.structureIDTable().get(structureID);
+    ASSERT(!structure->isDictionary());
+    ASSERT(newStructure->previousID() == structure);
+    ASSERT(newStructure->isValidOffset(offset));
+
+    newStructure->willStoreValueForExistingTransition(vm, propertyName, value, false);
+
+    size_t currentCapacity = structure->outOfLineCapacity();
+    if (currentCapacity != newStructure->outOfLineCapacity()) {
+        Butterfly* newButterfly = allocateMoreOutOfLineStorage(vm, currentCapacity, newStructure->outOfLineCapacity());
+        nukeStructureAndSetButterfly(vm, structureID, newButterfly);
+    }
+
+    validateOffset(offset);
+    putDirect(vm, offset, value);
+    setStructure(vm, newStructure);
+}
+
 ALWAYS_INLINE PropertyOffset JSObject::prepareToPutDirectWithoutTransition(VM& vm, PropertyName propertyName, unsigned attributes, StructureID structureID, Structure* structure)
 {
     unsigned oldOutOfLineCapacity = structure->outOfLineCapacity();
@@ -38,6 +38,10 @@
 #include <wtf/ASCIICType.h>
 #include <wtf/dtoa.h>
 
+#if CPU(X86_SSE2)
+#include <emmintrin.h>
+#endif
+
 namespace JSC {
 
 template <typename CharType>
@@ -48,6 +52,50 @@ static ALWAYS_INLINE bool isJSONWhiteSpace(const CharType& c)
     return c == ' ' || c == 0x9 || c == 0xA || c == 0xD;
 }
 
+// JSON text is mostly string bodies and the whitespace between tokens, so we scan both sixteen
+// bytes at a time where we can. Each vector loop stops at the first block that has anything
+// interesting in it, and leaves that block to the scalar loop.
+
+template <typename CharType>
+static ALWAYS_INLINE const CharType* skipJSONWhiteSpace(const CharType* ptr, const CharType* end)
+{
+#if CPU(X86_SSE2)
+    const size_t charactersPerVector = sizeof(__m128i) / sizeof(CharType);
+    if (sizeof(CharType) == 1) {
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i tab = _mm_set1_epi8(0x9);
+        const __m128i lineFeed = _mm_set1_epi8(0xA);
+        const __m128i carriageReturn = _mm_set1_epi8(0xD);
+        while (static_cast<size_t>(end - ptr) >= charactersPerVector) {
+            __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+            __m128i isWhiteSpace = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(characters, space), _mm_cmpeq_epi8(characters, tab)),
+                _mm_or_si128(_mm_cmpeq_epi8(characters, lineFeed), _mm_cmpeq_epi8(characters, carriageReturn)));
+            if (_mm_movemask_epi8(isWhiteSpace) != 0xFFFF)
+                break;
+            ptr += charactersPerVector;
+        }
+    } else {
+        const __m128i space = _mm_set1_epi16(' ');
+        const __m128i tab = _mm_set1_epi16(0x9);
+        const __m128i lineFeed = _mm_set1_epi16(0xA);
+        const __m128i carriageReturn = _mm_set1_epi16(0xD);
+        while (static_cast<size_t>(end - ptr) >= charactersPerVector) {
+            __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+            __m128i isWhiteSpace = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi16(characters, space), _mm_cmpeq_epi16(characters, tab)),
+                _mm_or_si128(_mm_cmpeq_epi16(characters, lineFeed), _mm_cmpeq_epi16(characters, carriageReturn)));
+            if (_mm_movemask_epi8(isWhiteSpace) != 0xFFFF)
+                break;
+            ptr += charactersPerVector;
+        }
+    }
+#endif
+    while (ptr < end && isJSONWhiteSpace(*ptr))
+        ++ptr;
+    return ptr;
+}
+
 template <typename CharType>
 bool LiteralParser<CharType>::tryJSONPParse(Vector<JSONPData>& results, bool needsFullSourceInfo)
 {
@@ -175,8 +223,7 @@ template <ParserMode mode> TokenType LiteralParser<CharType>::Lexer::lex(Literal
     m_currentTokenID++;
 #endif
 
-    while (m_ptr < m_end && isJSONWhiteSpace(*m_ptr))
-        ++m_ptr;
+    m_ptr = skipJSONWhiteSpace(m_ptr, m_end);
 
     ASSERT(m_ptr <= m_end);
     if (m_ptr >= m_end) {
@@ -348,13 +395,66 @@ template <ParserMode mode, typename CharType, UChar terminator> static ALWAYS_IN
     return (c >= ' ' && (mode == StrictJSON || c <= 0xff) && c != '\\' && c != terminator) || (c == '\t' && mode != StrictJSON);
 }
 
+template <ParserMode mode, char terminator>
+static ALWAYS_INLINE const LChar* skipSafeStringCharacters(const LChar* ptr, const LChar* end)
+{
+#if CPU(X86_SSE2)
+    const size_t charactersPerVector = sizeof(__m128i);
+    const __m128i terminatorCharacter = _mm_set1_epi8(terminator);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i lastControlCharacter = _mm_set1_epi8(0x1F);
+    while (static_cast<size_t>(end - ptr) >= charactersPerVector) {
+        __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        // There is no unsigned byte compare, but c <= 0x1F exactly when min(c, 0x1F) == c.
+        __m128i isUnsafe = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(characters, terminatorCharacter), _mm_cmpeq_epi8(characters, backslash)),
+            _mm_cmpeq_epi8(_mm_min_epu8(characters, lastControlCharacter), characters));
+        if (_mm_movemask_epi8(isUnsafe))
+            break;
+        ptr += charactersPerVector;
+    }
+#endif
+    while (ptr < end && isSafeStringCharacter<mode, LChar, terminator>(*ptr))
+        ++ptr;
+    return ptr;
+}
+
+template <ParserMode mode, char terminator>
+static ALWAYS_INLINE const UChar* skipSafeStringCharacters(const UChar* ptr, const UChar* end)
+{
+#if CPU(X86_SSE2)
+    const size_t charactersPerVector = sizeof(__m128i) / sizeof(UChar);
+    const __m128i terminatorCharacter = _mm_set1_epi16(terminator);
+    const __m128i backslash = _mm_set1_epi16('\\');
+    const __m128i nonControlBits = _mm_set1_epi16(static_cast<short>(0xFFE0));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i allOnes = _mm_cmpeq_epi16(zero, zero);
+    while (static_cast<size_t>(end - ptr) >= charactersPerVector) {
+        __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        __m128i isUnsafe = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi16(characters, terminatorCharacter), _mm_cmpeq_epi16(characters, backslash)),
+            _mm_cmpeq_epi16(_mm_and_si128(characters, nonControlBits), zero));
+        if (mode != StrictJSON) {
+            // Outside of strict mode, only Latin-1 characters are safe.
+            __m128i isLatin1 = _mm_cmpeq_epi16(_mm_srli_epi16(characters, 8), zero);
+            isUnsafe = _mm_or_si128(isUnsafe, _mm_andnot_si128(isLatin1, allOnes));
+        }
+        if (_mm_movemask_epi8(isUnsafe))
+            break;
+        ptr += charactersPerVector;
+    }
+#endif
+    while (ptr < end && isSafeStringCharacter<mode, UChar, terminator>(*ptr))
+        ++ptr;
+    return ptr;
+}
+
 template <typename CharType>
 template <ParserMode mode, char terminator> ALWAYS_INLINE TokenType LiteralParser<CharType>::Lexer::lexString(LiteralParserToken<CharType>& token)
 {
     ++m_ptr;
     const CharType* runStart = m_ptr;
-    while (m_ptr < m_end && isSafeStringCharacter<mode, CharType, terminator>(*m_ptr))
-        ++m_ptr;
+    m_ptr = skipSafeStringCharacters<mode, terminator>(m_ptr, m_end);
     if (LIKELY(m_ptr < m_end && *m_ptr == terminator)) {
         setParserTokenString<CharType>(token, runStart);
         token.stringLength = m_ptr - runStart;
@@ -568,6 +668,63 @@ TokenType LiteralParser<CharType>::Lexer::lexNumber(LiteralParserToken<CharType>
     return TokNumber;
 }
 
+template <typename CharType>
+auto LiteralParser<CharType>::startObjectShape(unsigned depth, UniquedStringImpl* key) -> ObjectShape
+{
+    ASSERT(depth);
+    if (depth <= m_lastObjectShapes.size()) {
+        LastObjectShape& lastObjectShape = m_lastObjectShapes[depth - 1];
+        if (lastObjectShape.transitions && lastObjectShape.key == key)
+            return ObjectShape { lastObjectShape.transitions, 0, true };
+    } else
+        m_lastObjectShapes.grow(depth);
+
+    auto result = m_structureTransitions.add(std::make_pair(depth, key), nullptr);
+    if (result.isNewEntry)
+        result.iterator->value = std::make_unique<Vector<StructureTransition>>();
+    m_lastObjectShapes[depth - 1] = LastObjectShape { key, result.iterator->value.get() };
+    return ObjectShape { result.iterator->value.get(), 0, true };
+}
+
+template <typename CharType>
+ALWAYS_INLINE void LiteralParser<CharType>::putDirectFollowingShape(VM& vm, JSObject* object, const Identifier& ident, JSValue value, ObjectShape& shape)
+{
+    Vector<StructureTransition>& transitions = *shape.transitions;
+    if (shape.index < transitions.size()) {
+        const StructureTransition& transition = transitions[shape.index];
+        if (transition.uid == ident.impl() && transition.from->id() == object->structureID()) {
+            object->putDirectWithKnownTransition(vm, transition.to, ident, transition.offset, value);
+            ++shape.index;
+            return;
+        }
+    }
+
+    if (std::optional<uint32_t> index = parseIndex(ident)) {
+        object->putDirectIndex(m_exec, index.value(), value);
+        shape.isRecording = false;
+        return;
+    }
+
+    Structure* from = object->structure(vm);
+    PutPropertySlot slot(object);
+    object->putDirect(vm, ident, value, slot);
+    if (!shape.isRecording)
+        return;
+
+    // This object has left the trail the last one took, so the rest of that trail is of no use.
+    // Record this object's trail in its place, for as long as it keeps taking plain transitions.
+    transitions.shrink(shape.index);
+    Structure* to = object->structure(vm);
+    if (slot.type() != PutPropertySlot::NewProperty || from->isDictionary() || to->isDictionary()) {
+        shape.isRecording = false;
+        return;
+    }
+    transitions.append(StructureTransition { ident.impl(), from, to, slot.cachedOffset() });
+    // The new structure refers to the old one, so this keeps both alive.
+    m_structureTransitionTargets.append(to);
+    ++shape.index;
+}
+
 template <typename CharType>
 JSValue LiteralParser<CharType>::parse(ParserState initialState)
 {
@@ -578,6 +735,7 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
     JSValue lastValue;
     Vector<ParserState, 16, UnsafeVectorOverflow> stateStack;
     Vector<Identifier, 16, UnsafeVectorOverflow> identifierStack;
+    Vector<ObjectShape, 16, UnsafeVectorOverflow> shapeStack;
     HashSet<JSObject*> visitedUnderscoreProto;
     while (1) {
         switch(state) {
@@ -625,7 +783,9 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
             startParseObject:
             case StartParseObject: {
                 JSObject* object = constructEmptyObject(m_exec);
+                UniquedStringImpl* key = !stateStack.isEmpty() && stateStack.last() == DoParseObjectEndExpression ? identifierStack.last().impl() : nullptr;
                 objectStack.append(object);
+                shapeStack.append(startObjectShape(objectStack.size(), key));
 
                 TokenType type = m_lexer.next();
                 if (type == TokString || (m_mode != StrictJSON && type == TokIdentifier)) {
@@ -652,6 +812,7 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
                 m_lexer.next();
                 lastValue = objectStack.last();
                 objectStack.removeLast();
+                shapeStack.removeLast();
                 break;
             }
             doParseObjectStartExpression:
@@ -689,12 +850,9 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
                     CodeBlock* codeBlock = m_exec->codeBlock();
                     PutPropertySlot slot(object, codeBlock ? codeBlock->isStrictMode() : false);
                     objectStack.last().put(m_exec, ident, lastValue, slot);
-                } else {
-                    if (std::optional<uint32_t> index = parseIndex(ident))
-                        object->putDirectIndex(m_exec, index.value(), lastValue);
-                    else
-                        object->putDirect(vm, ident, lastValue);
-                }
+                    shapeStack.last().isRecording = false;
+                } else
+                    putDirectFollowingShape(vm, object, identifierStack.last(), lastValue, shapeStack.last());
                 identifierStack.removeLast();
                 if (m_lexer.currentToken()->type == TokComma)
                     goto doParseObjectStartExpression;
@@ -705,6 +863,7 @@ JSValue LiteralParser<CharType>::parse(ParserState initialState)
                 m_lexer.next();
                 lastValue = objectStack.last();
                 objectStack.removeLast();
+                shapeStack.removeLast();
                 break;
             }
             startParseExpression:
@@ -25,15 +25,21 @@
 
 #pragma once
 
+#include "ArgList.h"
 #include "Identifier.h"
 #include "JSCJSValue.h"
 #include "JSGlobalObjectFunctions.h"
+#include "PropertyOffset.h"
 #include <array>
+#include <wtf/HashMap.h>
 #include <wtf/text/StringBuilder.h>
 #include <wtf/text/WTFString.h>
 
 namespace JSC {
 
+class JSObject;
+class Structure;
+
 typedef enum { StrictJSON, NonStrictJSON, JSONP } ParserMode;
 
 enum JSONPPathEntryType {
@@ -191,6 +197,34 @@ private:
     class StackGuard;
     JSValue parse(ParserState);
 
+    // JSON documents tend to hold runs of objects with the same keys in the same order, like the
+    // records of an array. For each place an object can appear, identified by its depth and the
+    // key it is stored under, we remember the structure transitions that the last object there
+    // took, and take them again directly while the next object's keys keep matching. The object
+    // that took a transition may be dropped, as when a key is repeated, so we keep the structures
+    // alive ourselves. The key is only compared by address; a stale match is harmless, since every
+    // cached transition is checked against the object's structure and the property's key before
+    // it is taken.
+    struct StructureTransition {
+        UniquedStringImpl* uid;
+        Structure* from;
+        Structure* to;
+        PropertyOffset offset;
+    };
+    struct ObjectShape {
+        Vector<StructureTransition>* transitions;
+        unsigned index;
+        bool isRecording;
+    };
+    // The last place an object at each depth was found, so that runs of objects in the same place
+    // can find their transitions again without a hash lookup.
+    struct LastObjectShape {
+        UniquedStringImpl* key { nullptr };
+        Vector<StructureTransition>* transitions { nullptr };
+    };
+    ObjectShape startObjectShape(unsigned depth, UniquedStringImpl* key);
+    ALWAYS_INLINE void putDirectFollowingShape(VM&, JSObject*, const Identifier&, JSValue, ObjectShape&);
+
     ExecState* m_exec;
     typename LiteralParser<CharType>::Lexer m_lexer;
     ParserMode m_mode;
@@ -200,6 +234,11 @@ private:
     std::array<Identifier, MaximumCachableCharacter> m_recentIdentifiers;
     ALWAYS_INLINE const Identifier makeIdentifier(const LChar* characters, size_t length);
     ALWAYS_INLINE const Identifier makeIdentifier(const UChar* characters, size_t length);
+    // Depth counts the object itself, so it is never zero.
+    HashMap<std::pair<unsigned, UniquedStringImpl*>, std::unique_ptr<Vector<StructureTransition>>> m_structureTransitions;
+    MarkedArgumentBuffer m_structureTransitionTargets;
+    // Indexed by depth - 1.
+    Vector<LastObjectShape, 16> m_lastObjectShapes;
 };
 
 } // namespace JSC
@@ -109,6 +109,7 @@ typedef const char* optionString;
     v(bool, useJIT,    true, Normal, "allows the baseline JIT to be used if true") \
     v(bool, useDFGJIT, true, Normal, "allows the DFG JIT to be used if true") \
     v(bool, useRegExpJIT, true, Normal, "allows the RegExp JIT to be used if true") \
+    v(bool, dumpRegExpJITFallbacks, false, Normal, "logs each RegExp that is compiled for the interpreter because the JIT cannot handle it, and why") \
     v(bool, useDOMJIT, true, Normal, "allows the DOMJIT to be used if true") \
     \
     v(bool, reportMustSucceedExecutableAllocations, false, Normal, nullptr) \
@@ -143,6 +144,9 @@ typedef const char* optionString;
     /* dumpDisassembly implies dumpDFGDisassembly. */ \
     v(bool, dumpDisassembly, false, Normal, "dumps disassembly of all JIT compiled code upon compilation") \
     v(bool, asyncDisassembly, false, Normal, nullptr) \
+    v(bool, logJITCodeForPerf, false, Normal, "writes a perf jitdump file (jit-<pid>.dump) describing all JIT compiled code, for use with perf inject --jit (Linux only)") \
+    v(bool, logJITCodeForPerfMap, false, Normal, "writes /tmp/perf-<pid>.map naming all JIT compiled code, for perf report without perf inject (Linux only)") \
+    v(optionString, perfJITDumpDirectory, nullptr, Normal, "directory to write the perf jitdump file to; defaults to /tmp") \
     v(bool, dumpDFGDisassembly, false, Normal, "dumps disassembly of DFG function upon compilation") \
     v(bool, dumpFTLDisassembly, false, Normal, "dumps disassembly of FTL function upon compilation") \
     v(bool, dumpAllDFGNodes, false, Normal, nullptr) \
@@ -324,6 +328,10 @@ typedef const char* optionString;
     v(double, desiredProfileLivenessRate, 0.75, Normal, nullptr) \
     v(double, desiredProfileFullnessRate, 0.35, Normal, nullptr) \
     \
+    v(optionString, profileCachePath, nullptr, Normal, "If set, profiles are loaded from this file when the VM is created and written back to it when the VM is destroyed or the embedder asks for it.") \
+    v(double, profileCacheWarmUpMultiplier, 0.25, Normal, "Scales the JIT and optimization warm-up thresholds of code blocks whose profiles were loaded from profileCachePath.") \
+    v(bool, reportProfileCacheStatistics, false, Normal, "Logs how many code blocks were seeded from profileCachePath, and how many of those were later jettisoned, when the profiles are saved.") \
+    \
     v(double, doubleVoteRatioForDoubleFormat, 2, Normal, nullptr) \
     v(double, structureCheckVoteRatioForHoisting, 1, Normal, nullptr) \
     v(double, checkArrayVoteRatioForHoisting, 1, Normal, nullptr) \
@@ -347,6 +355,7 @@ typedef const char* optionString;
     v(bool, useZombieMode, false, Normal, "debugging option to scribble over dead objects with 0xbadbeef0") \
     v(bool, useImmortalObjects, false, Normal, "debugging option to keep all objects alive forever") \
     v(bool, sweepSynchronously, false, Normal, "debugging option to sweep all dead objects synchronously at GC end before resuming mutator") \
+    v(bool, useConcurrentSweeping, true, Normal, "build free lists for blocks without destructors on the GC helper threads after each collection") \
     v(unsigned, maxSingleAllocationSize, 0, Configurable, "debugging option to limit individual allocations to a max size (0 = limit not set, N = limit size in bytes)") \
     \
     v(gcLogLevel, logGC, GCLogging::None, Normal, "debugging option to log GC activity (0 = None, 1 = Basic, 2 = Verbose)") \
@@ -369,6 +378,7 @@ typedef const char* optionString;
     v(unsigned, samplingProfilerTopFunctionsCount, 12, Normal, "Number of top functions to report when using the command line interface.") \
     v(unsigned, samplingProfilerTopBytecodesCount, 40, Normal, "Number of top bytecodes to report when using the command line interface.") \
     v(optionString, samplingProfilerPath, nullptr, Normal, "The path to the directory to write sampiling profiler output to. This probably will not work with WK2 unless the path is in the whitelist.") \
+    v(optionString, samplingProfilerExportFormat, nullptr, Normal, "If \"collapsed\" or \"pprof\", the sampling profiler also writes its stack traces to samplingProfilerPath in that format, with each frame's tier.") \
     v(bool, sampleCCode, false, Normal, "Causes the sampling profiler to record profiling data for C frames.") \
     \
     v(bool, alwaysGeneratePCToCodeOriginMap, false, Normal, "This will make sure we always generate a PCToCodeOriginMap for JITed code.") \
@@ -397,6 +407,9 @@ typedef const char* optionString;
     v(bool, airSpillsEverything, false, Normal, nullptr) \
     v(bool, airForceBriggsAllocator, false, Normal, nullptr) \
     v(bool, airForceIRCAllocator, false, Normal, nullptr) \
+    v(bool, airForceLinearScanAllocator, false, Normal, "If true, Air always allocates registers by linear scan.") \
+    v(bool, airForceGraphColoringAllocator, false, Normal, "If true, Air always allocates registers by graph coloring, even for code compiled without optimization.") \
+    v(unsigned, maximumTmpsForGraphColoring, 60000, Normal, "Air code with more Tmps than this has its registers allocated by linear scan, which is much faster for huge functions.") \
     v(bool, logAirRegisterPressure, false, Normal, nullptr) \
     v(unsigned, maxB3TailDupBlockSize, 3, Normal, nullptr) \
     v(unsigned, maxB3TailDupBlockSuccessors, 3, Normal, nullptr) \
@@ -427,10 +440,17 @@ typedef const char* optionString;
     \
     v(bool, useSourceProviderCache, true, Normal, "If false, the parser will not use the source provider cache. It's good to verify everything works when this is false. Because the cache is so successful, it can mask bugs.") \
     v(bool, useCodeCache, true, Normal, "If false, the unlinked byte code cache will not be used.") \
+    v(optionString, bytecodeCachePath, nullptr, Normal, "Directory in which serialized bytecode for top-level programs is stored and reused across runs.") \
+    v(bool, useSharedBuiltinImage, false, Normal, "If true, builtin bytecode compiled by one VM is shared with the other VMs in the process.") \
+    v(bool, useConcurrentProgramCompilation, false, Normal, "Lets embedders compile the top-level code of a program on a background thread before it is evaluated.") \
+    v(unsigned, minimumConcurrentProgramCompilationLength, 4096, Normal, "Programs shorter than this are not worth compiling on a background thread.") \
     \
     v(bool, useWebAssembly, true, Normal, "Expose the WebAssembly global object.") \
     v(bool, simulateWebAssemblyLowMemory, false, Normal, "If true, the Memory object won't mmap the full 'maximum' range and instead will allocate the minimum required amount.") \
-    v(bool, useWebAssemblyFastMemory, true, Normal, "If true, we will try to use a 32-bit address space with a signal handler to bounds check wasm memory.")
+    v(bool, useWebAssemblyFastMemory, true, Normal, "If true, we will try to use a 32-bit address space with a signal handler to bounds check wasm memory.") \
+    v(bool, useWebAssemblyTierUp, true, Normal, "If true, WebAssembly functions are first compiled by a quick baseline compile and recompiled with full optimization in the background once they get hot.") \
+    v(int32, webAssemblyTierUpThreshold, 1000, Normal, "The number of function entries (counted as 15 each) and loop iterations (counted as 1 each) after which a baseline WebAssembly function tiers up.") \
+    v(optionString, webAssemblyCachePath, nullptr, Normal, "Directory in which WebAssembly modules that are known to validate are remembered across runs.")
 
 
 enum OptionEquivalence {
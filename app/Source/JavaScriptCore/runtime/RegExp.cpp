@@ -35,6 +35,10 @@ namespace JSC {
 
 const ClassInfo RegExp::s_info = { "RegExp", 0, 0, CREATE_METHOD_TABLE(RegExp) };
 
+#if ENABLE(YARR_JIT)
+static std::atomic<unsigned> s_jitFallbackCounts[Yarr::numberOfJITFailureReasons];
+#endif
+
 RegExpFlags regExpFlags(const String& string)
 {
     RegExpFlags flags = NoFlags;
@@ -281,12 +285,21 @@ void RegExp::compile(VM* vm, Yarr::YarrCharSize charSize)
     }
 
 #if ENABLE(YARR_JIT)
-    if (!pattern.m_containsBackreferences && !pattern.containsUnsignedLengthPattern() && !unicode() && vm->canUseRegExpJIT()) {
+    if (unicode())
+        noteJITFallback(Yarr::JITFailureReason::UnicodePattern);
+    else if (pattern.containsUnsignedLengthPattern())
+        noteJITFallback(Yarr::JITFailureReason::UnsignedLengthPattern);
+    else if (vm->canUseRegExpJIT()) {
         Yarr::jitCompile(pattern, charSize, vm, m_regExpJITCode);
         if (!m_regExpJITCode.isFallBack()) {
             m_state = JITCode;
+            // The JIT code hands the match back to the interpreter if it runs out of
+            // space for its parentheses contexts.
+            if (m_regExpJITCode.usesParenContexts() && !m_regExpBytecode)
+                m_regExpBytecode = Yarr::byteCompile(pattern, &vm->m_regExpAllocator, &vm->m_regExpAllocatorLock);
             return;
         }
+        noteJITFallback(m_regExpJITCode.failureReason());
     }
 #else
     UNUSED_PARAM(charSize);
@@ -334,12 +347,21 @@ void RegExp::compileMatchOnly(VM* vm, Yarr::YarrCharSize charSize)
     }
 
 #if ENABLE(YARR_JIT)
-    if (!pattern.m_containsBackreferences && !pattern.containsUnsignedLengthPattern() && !unicode() && vm->canUseRegExpJIT()) {
+    if (unicode())
+        noteJITFallback(Yarr::JITFailureReason::UnicodePattern);
+    else if (pattern.containsUnsignedLengthPattern())
+        noteJITFallback(Yarr::JITFailureReason::UnsignedLengthPattern);
+    else if (vm->canUseRegExpJIT()) {
         Yarr::jitCompile(pattern, charSize, vm, m_regExpJITCode, Yarr::MatchOnly);
         if (!m_regExpJITCode.isFallBack()) {
             m_state = JITCode;
+            // The JIT code hands the match back to the interpreter if it runs out of
+            // space for its parentheses contexts.
+            if (m_regExpJITCode.usesParenContexts() && !m_regExpBytecode)
+                m_regExpBytecode = Yarr::byteCompile(pattern, &vm->m_regExpAllocator, &vm->m_regExpAllocatorLock);
             return;
         }
+        noteJITFallback(m_regExpJITCode.failureReason());
     }
 #else
     UNUSED_PARAM(charSize);
@@ -354,6 +376,24 @@ MatchResult RegExp::match(VM& vm, const String& s, unsigned startOffset)
     return matchInline(vm, s, startOffset);
 }
 
+#if ENABLE(YARR_JIT)
+unsigned RegExp::jitFallbackCount(Yarr::JITFailureReason reason)
+{
+    return s_jitFallbackCounts[static_cast<unsigned>(reason)].load();
+}
+
+void RegExp::noteJITFallback(Yarr::JITFailureReason reason)
+{
+    // Recompiling after deleteCode(), or for the other character size, is not a new fallback.
+    if (m_didNoteJITFallback)
+        return;
+    m_didNoteJITFallback = true;
+    ++s_jitFallbackCounts[static_cast<unsigned>(reason)];
+    if (Options::dumpRegExpJITFallbacks())
+        dataLog("RegExp /", m_patternString, "/ will use the interpreter: ", reason, "\n");
+}
+#endif
+
 bool RegExp::matchConcurrently(VM& vm, const String& s, unsigned startOffset, MatchResult& result)
 {
     ConcurrentJSLocker locker(m_lock);
@@ -89,6 +89,12 @@ public:
 
     void deleteCode();
 
+#if ENABLE(YARR_JIT)
+    // The number of patterns, process wide, that were compiled for the
+    // interpreter because the JIT could not handle them for the given reason.
+    JS_EXPORT_PRIVATE static unsigned jitFallbackCount(Yarr::JITFailureReason);
+#endif
+
 #if ENABLE(REGEXP_TRACING)
     void printTraceData();
 #endif
@@ -126,6 +132,10 @@ private:
     void compileMatchOnly(VM*, Yarr::YarrCharSize);
     void compileIfNecessaryMatchOnly(VM&, Yarr::YarrCharSize);
 
+#if ENABLE(YARR_JIT)
+    void noteJITFallback(Yarr::JITFailureReason);
+#endif
+
 #if ENABLE(YARR_JIT_DEBUG)
     void matchCompareWithInterpreter(const String&, int startOffset, int* offsetVector, int jitResult);
 #endif
@@ -134,6 +144,9 @@ private:
     RegExpFlags m_flags;
     const char* m_constructionError;
     unsigned m_numSubpatterns;
+#if ENABLE(YARR_JIT)
+    bool m_didNoteJITFallback { false };
+#endif
 #if ENABLE(REGEXP_TRACING)
     double m_rtMatchOnlyTotalSubjectStringLen;
     double m_rtMatchTotalSubjectStringLen;
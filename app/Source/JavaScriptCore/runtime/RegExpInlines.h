@@ -115,8 +115,13 @@ ALWAYS_INLINE int RegExp::matchInline(VM& vm, const String& s, unsigned startOff
             result = m_regExpJITCode.execute(s.characters8(), startOffset, s.length(), offsetVector).start;
         else
             result = m_regExpJITCode.execute(s.characters16(), startOffset, s.length(), offsetVector).start;
+        if (result == Yarr::JSRegExpJITCodeFailure) {
+            // The match outgrew the largest paren context area; run it again in the interpreter.
+            result = Yarr::interpret(m_regExpBytecode.get(), s, startOffset, reinterpret_cast<unsigned*>(offsetVector));
+        }
 #if ENABLE(YARR_JIT_DEBUG)
-        matchCompareWithInterpreter(s, startOffset, offsetVector, result);
+        else
+            matchCompareWithInterpreter(s, startOffset, offsetVector, result);
 #endif
     } else
 #endif
@@ -203,11 +208,14 @@ ALWAYS_INLINE MatchResult RegExp::matchInline(VM& vm, const String& s, unsigned
         MatchResult result = s.is8Bit() ?
             m_regExpJITCode.execute(s.characters8(), startOffset, s.length()) :
             m_regExpJITCode.execute(s.characters16(), startOffset, s.length());
+        // If the match outgrew the largest paren context area, fall through to run it again in the interpreter.
+        if (result.start != static_cast<size_t>(Yarr::JSRegExpJITCodeFailure)) {
 #if ENABLE(REGEXP_TRACING)
-        if (!result)
-            m_rtMatchOnlyFoundCount++;
+            if (!result)
+                m_rtMatchOnlyFoundCount++;
 #endif
-        return result;
+            return result;
+        }
     }
 #endif
 
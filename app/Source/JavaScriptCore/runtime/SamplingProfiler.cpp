@@ -448,6 +448,12 @@ static ALWAYS_INLINE unsigned tryGetBytecodeIndex(unsigned llintPC, CodeBlock* c
 #endif
 }
 
+static bool shouldRecordCodeLocations()
+{
+    // Only the JSC shell's reports and the export formats look at tiers and CodeBlock hashes.
+    return Options::collectSamplingProfilerDataForJSCShell() || Options::samplingProfilerExportFormat();
+}
+
 void SamplingProfiler::processUnverifiedStackTraces()
 {
     // This function needs to be called from the JSC execution thread.
@@ -469,7 +475,7 @@ void SamplingProfiler::processUnverifiedStackTraces()
                     location.lineNumber, location.columnNumber);
                 location.bytecodeIndex = bytecodeIndex;
             }
-            if (Options::collectSamplingProfilerDataForJSCShell()) {
+            if (shouldRecordCodeLocations()) {
                 location.codeBlockHash = codeBlock->hash();
                 location.jitType = codeBlock->jitType();
             }
@@ -550,7 +556,7 @@ void SamplingProfiler::processUnverifiedStackTraces()
                 appendCodeBlock(codeOrigin.inlineCallFrame ? codeOrigin.inlineCallFrame->baselineCodeBlock.get() : machineCodeBlock, codeOrigin.bytecodeIndex);
             });
 
-            if (Options::collectSamplingProfilerDataForJSCShell()) {
+            if (shouldRecordCodeLocations()) {
                 RELEASE_ASSERT(machineOrigin.isSet());
                 RELEASE_ASSERT(!machineOrigin.inlineCallFrame);
 
@@ -911,6 +917,260 @@ String SamplingProfiler::stackTracesAsJSON()
     return json.toString();
 }
 
+static const char* tierName(const SamplingProfiler::StackFrame& frame)
+{
+    switch (frame.frameType) {
+    case SamplingProfiler::FrameType::Host:
+        return "Host";
+    case SamplingProfiler::FrameType::C:
+        return "C";
+    case SamplingProfiler::FrameType::Unknown:
+        return nullptr;
+    case SamplingProfiler::FrameType::Executable:
+        break;
+    }
+
+    // Inlined frames run at the tier of the frame they were inlined into.
+    JITCode::JITType jitType = frame.machineLocation ? frame.machineLocation->first.jitType : frame.semanticLocation.jitType;
+    if (jitType == JITCode::None)
+        return nullptr;
+    return JITCode::typeName(jitType);
+}
+
+// "name url:line [tier]", using the line the function starts on.
+static String exportedFunctionName(VM& vm, SamplingProfiler::StackFrame& frame)
+{
+    StringBuilder name;
+    name.append(frame.displayName(vm));
+    String url = frame.url();
+    if (!url.isEmpty()) {
+        name.append(' ');
+        name.append(url);
+        int line = frame.functionStartLine();
+        if (line >= 0) {
+            name.append(':');
+            name.appendNumber(line);
+        }
+    }
+    if (const char* tier = tierName(frame)) {
+        name.appendLiteral(" [");
+        name.append(tier);
+        if (frame.machineLocation)
+            name.appendLiteral(", inlined");
+        name.append(']');
+    }
+    return name.toString();
+}
+
+String SamplingProfiler::stackTracesAsCollapsedStacks()
+{
+    DeferGC deferGC(m_vm.heap);
+    LockHolder locker(m_lock);
+
+    {
+        HeapIterationScope heapIterationScope(m_vm.heap);
+        processUnverifiedStackTraces();
+    }
+
+    HashMap<String, size_t> stackCounts;
+    Vector<String> stacks;
+    for (StackTrace& stackTrace : m_stackTraces) {
+        if (!stackTrace.frames.size())
+            continue;
+
+        StringBuilder stack;
+        for (size_t i = stackTrace.frames.size(); i--;) {
+            if (!stack.isEmpty())
+                stack.append(';');
+            // Semicolons separate frames and the last space separates the count.
+            String name = exportedFunctionName(m_vm, stackTrace.frames[i]);
+            stack.append(name.replace(';', ':').replace('\n', ' '));
+        }
+
+        auto addResult = stackCounts.add(stack.toString(), 0);
+        if (addResult.isNewEntry)
+            stacks.append(addResult.iterator->key);
+        addResult.iterator->value++;
+    }
+
+    StringBuilder result;
+    for (const String& stack : stacks) {
+        result.append(stack);
+        result.append(' ');
+        result.appendNumber(stackCounts.get(stack));
+        result.append('\n');
+    }
+
+    clearData(locker);
+
+    return result.toString();
+}
+
+namespace {
+
+// Just enough of the protobuf wire format to write a pprof profile.
+class ProtobufWriter {
+public:
+    void appendVarint(uint64_t value)
+    {
+        while (value >= 0x80) {
+            m_data.append(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        m_data.append(static_cast<uint8_t>(value));
+    }
+
+    void appendVarintField(unsigned field, uint64_t value)
+    {
+        if (!value)
+            return;
+        appendVarint(field << 3);
+        appendVarint(value);
+    }
+
+    void appendBytesField(unsigned field, const uint8_t* data, size_t size)
+    {
+        appendVarint(field << 3 | 2);
+        appendVarint(size);
+        m_data.append(data, size);
+    }
+
+    void appendStringField(unsigned field, const CString& string)
+    {
+        appendBytesField(field, reinterpret_cast<const uint8_t*>(string.data()), string.length());
+    }
+
+    void appendMessageField(unsigned field, const ProtobufWriter& message)
+    {
+        appendBytesField(field, message.m_data.data(), message.m_data.size());
+    }
+
+    void appendPackedVarintField(unsigned field, const Vector<uint64_t>& values)
+    {
+        ProtobufWriter packed;
+        for (uint64_t value : values)
+            packed.appendVarint(value);
+        appendMessageField(field, packed);
+    }
+
+    Vector<uint8_t> takeData() { return WTFMove(m_data); }
+
+private:
+    Vector<uint8_t> m_data;
+};
+
+// Field numbers from pprof's profile.proto.
+namespace Pprof {
+enum ProfileField { SampleType = 1, Sample = 2, Location = 4, Function = 5, StringTable = 6, DurationNanos = 10, PeriodType = 11, Period = 12 };
+enum ValueTypeField { Type = 1, Unit = 2 };
+enum SampleField { LocationID = 1, Value = 2 };
+enum LocationField { ID = 1, Line = 4 };
+enum LineField { FunctionID = 1, LineNumber = 2 };
+enum FunctionField { FunctionName = 2, SystemName = 3, FileName = 4, StartLine = 5 };
+}
+
+} // anonymous namespace
+
+Vector<uint8_t> SamplingProfiler::stackTracesAsPprof()
+{
+    DeferGC deferGC(m_vm.heap);
+    LockHolder locker(m_lock);
+
+    {
+        HeapIterationScope heapIterationScope(m_vm.heap);
+        processUnverifiedStackTraces();
+    }
+
+    ProtobufWriter profile;
+
+    HashMap<String, uint64_t> stringIndices;
+    Vector<String> strings;
+    auto stringIndex = [&] (const String& string) -> uint64_t {
+        if (string.isEmpty())
+            return 0;
+        auto addResult = stringIndices.add(string, strings.size() + 1);
+        if (addResult.isNewEntry)
+            strings.append(string);
+        return addResult.iterator->value;
+    };
+
+    auto appendValueType = [&] (unsigned field, const char* type, const char* unit) {
+        ProtobufWriter valueType;
+        valueType.appendVarintField(Pprof::Type, stringIndex(type));
+        valueType.appendVarintField(Pprof::Unit, stringIndex(unit));
+        profile.appendMessageField(field, valueType);
+    };
+    appendValueType(Pprof::SampleType, "samples", "count");
+    appendValueType(Pprof::SampleType, "cpu", "nanoseconds");
+
+    uint64_t intervalNanoseconds = static_cast<uint64_t>(m_timingInterval.count()) * 1000;
+
+    HashMap<String, uint64_t> functionIDs;
+    // Keyed by function ID in the high bits and line in the low bits. Function IDs start at 1, so
+    // no key is 0.
+    HashMap<uint64_t, uint64_t> locationIDs;
+    auto locationID = [&] (StackFrame& frame) -> uint64_t {
+        String name = exportedFunctionName(m_vm, frame);
+        auto functionAddResult = functionIDs.add(name, functionIDs.size() + 1);
+        uint64_t functionID = functionAddResult.iterator->value;
+        if (functionAddResult.isNewEntry) {
+            ProtobufWriter function;
+            function.appendVarintField(Pprof::ID, functionID);
+            function.appendVarintField(Pprof::FunctionName, stringIndex(name));
+            function.appendVarintField(Pprof::SystemName, stringIndex(frame.displayName(m_vm)));
+            function.appendVarintField(Pprof::FileName, stringIndex(frame.url()));
+            int startLine = frame.functionStartLine();
+            if (startLine > 0)
+                function.appendVarintField(Pprof::StartLine, startLine);
+            profile.appendMessageField(Pprof::Function, function);
+        }
+
+        uint32_t line = frame.hasExpressionInfo() ? frame.lineNumber() : 0;
+        auto locationAddResult = locationIDs.add(functionID << 32 | line, locationIDs.size() + 1);
+        if (locationAddResult.isNewEntry) {
+            ProtobufWriter lineMessage;
+            lineMessage.appendVarintField(Pprof::FunctionID, functionID);
+            lineMessage.appendVarintField(Pprof::LineNumber, line);
+            ProtobufWriter location;
+            location.appendVarintField(Pprof::ID, locationAddResult.iterator->value);
+            location.appendMessageField(Pprof::Line, lineMessage);
+            profile.appendMessageField(Pprof::Location, location);
+        }
+        return locationAddResult.iterator->value;
+    };
+
+    for (StackTrace& stackTrace : m_stackTraces) {
+        if (!stackTrace.frames.size())
+            continue;
+
+        // Like our frames, pprof's locations start at the leaf.
+        Vector<uint64_t> locations;
+        for (StackFrame& frame : stackTrace.frames)
+            locations.append(locationID(frame));
+
+        ProtobufWriter sample;
+        sample.appendPackedVarintField(Pprof::LocationID, locations);
+        sample.appendPackedVarintField(Pprof::Value, { 1, intervalNanoseconds });
+        profile.appendMessageField(Pprof::Sample, sample);
+    }
+
+    // The string table must start with the empty string.
+    profile.appendStringField(Pprof::StringTable, CString(""));
+    for (const String& string : strings)
+        profile.appendStringField(Pprof::StringTable, string.utf8());
+
+    if (m_stackTraces.size()) {
+        double duration = m_stackTraces.last().timestamp - m_stackTraces.first().timestamp;
+        profile.appendVarintField(Pprof::DurationNanos, static_cast<uint64_t>(duration * 1e9));
+    }
+    appendValueType(Pprof::PeriodType, "cpu", "nanoseconds");
+    profile.appendVarintField(Pprof::Period, intervalNanoseconds);
+
+    clearData(locker);
+
+    return profile.takeData();
+}
+
 void SamplingProfiler::registerForReportAtExit()
 {
     static StaticLock registrationLock;
@@ -941,6 +1201,26 @@ void SamplingProfiler::reportDataToOptionFile()
         auto out = FilePrintStream::open(pathOut.toCString().data(), "w");
         reportTopFunctions(*out);
         reportTopBytecodes(*out);
+
+        const char* format = Options::samplingProfilerExportFormat();
+        if (!format)
+            return;
+        StringPrintStream exportPathOut;
+        exportPathOut.print(path, "/");
+        exportPathOut.print("JSCSampilingProfile-", reinterpret_cast<uintptr_t>(this));
+        if (!strcmp(format, "collapsed")) {
+            exportPathOut.print(".collapsed");
+            auto exportOut = FilePrintStream::open(exportPathOut.toCString().data(), "w");
+            exportOut->print(stackTracesAsCollapsedStacks());
+        } else if (!strcmp(format, "pprof")) {
+            exportPathOut.print(".pb");
+            Vector<uint8_t> profile = stackTracesAsPprof();
+            if (FILE* file = fopen(exportPathOut.toCString().data(), "wb")) {
+                fwrite(profile.data(), 1, profile.size(), file);
+                fclose(file);
+            }
+        } else
+            dataLogLn("Unknown samplingProfilerExportFormat: ", format);
     }
 }
 
@@ -169,6 +169,14 @@ public:
     void start(const LockHolder&);
     Vector<StackTrace> releaseStackTraces(const LockHolder&);
     JS_EXPORT_PRIVATE String stackTracesAsJSON();
+    // Formats for external profilers. Like stackTracesAsJSON(), these consume the samples taken so
+    // far. Frames are named after their function, source location and tier; the tier is only known
+    // if Options::samplingProfilerExportFormat() or collectSamplingProfilerDataForJSCShell() was
+    // set while sampling.
+    // One line per distinct stack, root first, in the format flame graph tools read.
+    JS_EXPORT_PRIVATE String stackTracesAsCollapsedStacks();
+    // An uncompressed pprof profile.proto message.
+    JS_EXPORT_PRIVATE Vector<uint8_t> stackTracesAsPprof();
     JS_EXPORT_PRIVATE void noticeCurrentThreadAsJSCExecutionThread();
     void noticeCurrentThreadAsJSCExecutionThread(const LockHolder&);
     void processUnverifiedStackTraces(); // You should call this only after acquiring the lock.
@@ -689,6 +689,8 @@ public:
     DECLARE_EXPORT_INFO;
 
 private:
+    friend class BytecodeCacheReader;
+
     JS_EXPORT_PRIVATE SymbolTable(VM&);
     ~SymbolTable();
     
@@ -0,0 +1,399 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <wtf/Vector.h>
+
+#if CPU(X86_SSE2)
+#include <emmintrin.h>
+#elif CPU(ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace JSC { namespace TypedArrayKernels {
+
+// The loops behind the typed array prototype functions. They work on the raw element vector
+// and compare, fill and reverse 16 bytes at a time where the CPU has vector instructions
+// (SSE2 on x86, NEON on ARM64), falling back to plain loops elsewhere and for the tail.
+//
+// Comparisons follow the rules of the scalar element type: for Float32 and Float64, NaN equals
+// nothing and -0 equals +0, as indexOf requires. includes uses findNaN() separately.
+
+static const size_t vectorSize = 16;
+
+#if CPU(X86_SSE2) || CPU(ARM64)
+
+template<typename T, size_t = sizeof(T), bool = std::is_floating_point<T>::value> class EqualMatcher;
+template<typename T, size_t = sizeof(T)> class NaNMatcher;
+
+#if CPU(X86_SSE2)
+
+template<typename T> class EqualMatcher<T, 1, false> {
+public:
+    explicit EqualMatcher(T target) : m_target(_mm_set1_epi8(static_cast<char>(target))) { }
+    bool matches(const T* block) const { return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), m_target)); }
+private:
+    __m128i m_target;
+};
+
+template<typename T> class EqualMatcher<T, 2, false> {
+public:
+    explicit EqualMatcher(T target) : m_target(_mm_set1_epi16(static_cast<short>(target))) { }
+    bool matches(const T* block) const { return _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), m_target)); }
+private:
+    __m128i m_target;
+};
+
+template<typename T> class EqualMatcher<T, 4, false> {
+public:
+    explicit EqualMatcher(T target) : m_target(_mm_set1_epi32(static_cast<int>(target))) { }
+    bool matches(const T* block) const { return _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), m_target)); }
+private:
+    __m128i m_target;
+};
+
+template<> class EqualMatcher<float, 4, true> {
+public:
+    explicit EqualMatcher(float target) : m_target(_mm_set1_ps(target)) { }
+    bool matches(const float* block) const { return _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(block), m_target)); }
+private:
+    __m128 m_target;
+};
+
+template<> class EqualMatcher<double, 8, true> {
+public:
+    explicit EqualMatcher(double target) : m_target(_mm_set1_pd(target)) { }
+    bool matches(const double* block) const { return _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(block), m_target)); }
+private:
+    __m128d m_target;
+};
+
+template<> class NaNMatcher<float, 4> {
+public:
+    bool matches(const float* block) const
+    {
+        __m128 values = _mm_loadu_ps(block);
+        return _mm_movemask_ps(_mm_cmpunord_ps(values, values));
+    }
+};
+
+template<> class NaNMatcher<double, 8> {
+public:
+    bool matches(const double* block) const
+    {
+        __m128d values = _mm_loadu_pd(block);
+        return _mm_movemask_pd(_mm_cmpunord_pd(values, values));
+    }
+};
+
+template<size_t elementSize> inline __m128i reverseVector(__m128i);
+
+template<> inline __m128i reverseVector<8>(__m128i vector)
+{
+    return _mm_shuffle_epi32(vector, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+template<> inline __m128i reverseVector<4>(__m128i vector)
+{
+    return _mm_shuffle_epi32(vector, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+template<> inline __m128i reverseVector<2>(__m128i vector)
+{
+    vector = _mm_shufflelo_epi16(vector, _MM_SHUFFLE(0, 1, 2, 3));
+    vector = _mm_shufflehi_epi16(vector, _MM_SHUFFLE(0, 1, 2, 3));
+    return _mm_shuffle_epi32(vector, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+template<> inline __m128i reverseVector<1>(__m128i vector)
+{
+    // SSE2 has no byte shuffle, so reverse the 16-bit lanes and then swap the bytes within each.
+    vector = reverseVector<2>(vector);
+    return _mm_or_si128(_mm_slli_epi16(vector, 8), _mm_srli_epi16(vector, 8));
+}
+
+inline void reverseBlocks(void* low, void* high, size_t elementSize)
+{
+    __m128i lowVector = _mm_loadu_si128(static_cast<const __m128i*>(low));
+    __m128i highVector = _mm_loadu_si128(static_cast<const __m128i*>(high));
+    switch (elementSize) {
+    case 1:
+        lowVector = reverseVector<1>(lowVector);
+        highVector = reverseVector<1>(highVector);
+        break;
+    case 2:
+        lowVector = reverseVector<2>(lowVector);
+        highVector = reverseVector<2>(highVector);
+        break;
+    case 4:
+        lowVector = reverseVector<4>(lowVector);
+        highVector = reverseVector<4>(highVector);
+        break;
+    default:
+        lowVector = reverseVector<8>(lowVector);
+        highVector = reverseVector<8>(highVector);
+        break;
+    }
+    _mm_storeu_si128(static_cast<__m128i*>(low), highVector);
+    _mm_storeu_si128(static_cast<__m128i*>(high), lowVector);
+}
+
+#else // CPU(ARM64)
+
+template<typename T> class EqualMatcher<T, 1, false> {
+public:
+    explicit EqualMatcher(T target) : m_target(vdupq_n_u8(static_cast<uint8_t>(target))) { }
+    bool matches(const T* block) const { return vmaxvq_u8(vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(block)), m_target)); }
+private:
+    uint8x16_t m_target;
+};
+
+template<typename T> class EqualMatcher<T, 2, false> {
+public:
+    explicit EqualMatcher(T target) : m_target(vdupq_n_u16(static_cast<uint16_t>(target))) { }
+    bool matches(const T* block) const { return vmaxvq_u16(vceqq_u16(vld1q_u16(reinterpret_cast<const uint16_t*>(block)), m_target)); }
+private:
+    uint16x8_t m_target;
+};
+
+template<typename T> class EqualMatcher<T, 4, false> {
+public:
+    explicit EqualMatcher(T target) : m_target(vdupq_n_u32(static_cast<uint32_t>(target))) { }
+    bool matches(const T* block) const { return vmaxvq_u32(vceqq_u32(vld1q_u32(reinterpret_cast<const uint32_t*>(block)), m_target)); }
+private:
+    uint32x4_t m_target;
+};
+
+template<> class EqualMatcher<float, 4, true> {
+public:
+    explicit EqualMatcher(float target) : m_target(vdupq_n_f32(target)) { }
+    bool matches(const float* block) const { return vmaxvq_u32(vceqq_f32(vld1q_f32(block), m_target)); }
+private:
+    float32x4_t m_target;
+};
+
+template<> class EqualMatcher<double, 8, true> {
+public:
+    explicit EqualMatcher(double target) : m_target(vdupq_n_f64(target)) { }
+    bool matches(const double* block) const { return vmaxvq_u32(vreinterpretq_u32_u64(vceqq_f64(vld1q_f64(block), m_target))); }
+private:
+    float64x2_t m_target;
+};
+
+template<> class NaNMatcher<float, 4> {
+public:
+    bool matches(const float* block) const
+    {
+        float32x4_t values = vld1q_f32(block);
+        return vmaxvq_u32(vmvnq_u32(vceqq_f32(values, values)));
+    }
+};
+
+template<> class NaNMatcher<double, 8> {
+public:
+    bool matches(const double* block) const
+    {
+        float64x2_t values = vld1q_f64(block);
+        return vmaxvq_u32(vmvnq_u32(vreinterpretq_u32_u64(vceqq_f64(values, values))));
+    }
+};
+
+inline uint8x16_t reverseVector(uint8x16_t vector, size_t elementSize)
+{
+    switch (elementSize) {
+    case 1:
+        vector = vrev64q_u8(vector);
+        break;
+    case 2:
+        vector = vreinterpretq_u8_u16(vrev64q_u16(vreinterpretq_u16_u8(vector)));
+        break;
+    case 4:
+        vector = vreinterpretq_u8_u32(vrev64q_u32(vreinterpretq_u32_u8(vector)));
+        break;
+    default:
+        break;
+    }
+    // Swap the two 64-bit halves.
+    return vextq_u8(vector, vector, 8);
+}
+
+inline void reverseBlocks(void* low, void* high, size_t elementSize)
+{
+    uint8x16_t lowVector = vld1q_u8(static_cast<const uint8_t*>(low));
+    uint8x16_t highVector = vld1q_u8(static_cast<const uint8_t*>(high));
+    vst1q_u8(static_cast<uint8_t*>(low), reverseVector(highVector, elementSize));
+    vst1q_u8(static_cast<uint8_t*>(high), reverseVector(lowVector, elementSize));
+}
+
+#endif
+
+// Finds the first element in [from, length) for which predicate holds. The matcher must agree
+// with the predicate about whether a block holds such an element.
+template<typename T, typename Matcher, typename Predicate>
+inline size_t findForward(const T* data, size_t from, size_t length, const Matcher& matcher, const Predicate& predicate)
+{
+    const size_t stride = vectorSize / sizeof(T);
+    size_t index = from;
+    for (; index + stride <= length; index += stride) {
+        if (!matcher.matches(data + index))
+            continue;
+        for (size_t i = index; i < index + stride; ++i) {
+            if (predicate(data[i]))
+                return i;
+        }
+    }
+    for (; index < length; ++index) {
+        if (predicate(data[index]))
+            return index;
+    }
+    return notFound;
+}
+
+// Finds the last element in [0, end) for which predicate holds.
+template<typename T, typename Matcher, typename Predicate>
+inline size_t findBackward(const T* data, size_t end, const Matcher& matcher, const Predicate& predicate)
+{
+    const size_t stride = vectorSize / sizeof(T);
+    for (; end >= stride; end -= stride) {
+        if (!matcher.matches(data + end - stride))
+            continue;
+        for (size_t i = end; i-- > end - stride;) {
+            if (predicate(data[i]))
+                return i;
+        }
+    }
+    while (end--) {
+        if (predicate(data[end]))
+            return end;
+    }
+    return notFound;
+}
+
+#endif // CPU(X86_SSE2) || CPU(ARM64)
+
+template<typename T>
+inline size_t indexOf(const T* data, size_t from, size_t length, T target)
+{
+    auto isTarget = [target] (T value) { return value == target; };
+#if CPU(X86_SSE2) || CPU(ARM64)
+    return findForward(data, from, length, EqualMatcher<T>(target), isTarget);
+#else
+    for (size_t index = from; index < length; ++index) {
+        if (isTarget(data[index]))
+            return index;
+    }
+    return notFound;
+#endif
+}
+
+// Searches backwards from index, inclusive.
+template<typename T>
+inline size_t lastIndexOf(const T* data, size_t index, T target)
+{
+    auto isTarget = [target] (T value) { return value == target; };
+#if CPU(X86_SSE2) || CPU(ARM64)
+    return findBackward(data, index + 1, EqualMatcher<T>(target), isTarget);
+#else
+    for (size_t end = index + 1; end--;) {
+        if (isTarget(data[end]))
+            return end;
+    }
+    return notFound;
+#endif
+}
+
+template<typename T>
+inline typename std::enable_if<!std::is_floating_point<T>::value, size_t>::type findNaN(const T*, size_t, size_t)
+{
+    return notFound;
+}
+
+template<typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, size_t>::type findNaN(const T* data, size_t from, size_t length)
+{
+    auto isNaN = [] (T value) { return value != value; };
+#if CPU(X86_SSE2) || CPU(ARM64)
+    return findForward(data, from, length, NaNMatcher<T>(), isNaN);
+#else
+    for (size_t index = from; index < length; ++index) {
+        if (isNaN(data[index]))
+            return index;
+    }
+    return notFound;
+#endif
+}
+
+template<typename T>
+inline void fill(T* data, size_t begin, size_t end, T value)
+{
+    if (begin >= end)
+        return;
+    // Checking the bits rather than the value keeps -0 from turning into +0.
+    uint8_t firstByte;
+    memcpy(&firstByte, &value, 1);
+    bool isRepeatedByte = true;
+    for (size_t i = 1; i < sizeof(T); ++i)
+        isRepeatedByte &= reinterpret_cast<const uint8_t*>(&value)[i] == firstByte;
+    if (isRepeatedByte) {
+        memset(data + begin, firstByte, (end - begin) * sizeof(T));
+        return;
+    }
+    // Compilers turn this into vector stores.
+    std::fill(data + begin, data + end, value);
+}
+
+template<typename T>
+inline void reverse(T* data, size_t length)
+{
+#if CPU(X86_SSE2) || CPU(ARM64)
+    const size_t stride = vectorSize / sizeof(T);
+    T* low = data;
+    T* high = data + length;
+    while (static_cast<size_t>(high - low) >= 2 * stride) {
+        high -= stride;
+        reverseBlocks(low, high, sizeof(T));
+        low += stride;
+    }
+    std::reverse(low, high);
+#else
+    std::reverse(data, data + length);
+#endif
+}
+
+// Converts between arrays of different types that are known not to overlap. Without the
+// per-element bounds checks and vector reloads of setIndexQuicklyToNativeValue, compilers
+// vectorize most of these conversions.
+template<typename Adaptor, typename OtherAdaptor>
+inline void convert(typename Adaptor::Type* __restrict destination, const typename OtherAdaptor::Type* __restrict source, size_t length)
+{
+    for (size_t i = 0; i < length; ++i)
+        destination[i] = OtherAdaptor::template convertTo<Adaptor>(source[i]);
+}
+
+} } // namespace JSC::TypedArrayKernels
@@ -83,6 +83,7 @@
 #include "NativeStdFunctionCell.h"
 #include "Nodes.h"
 #include "Parser.h"
+#include "ProfileCache.h"
 #include "ProfilerDatabase.h"
 #include "ProgramCodeBlock.h"
 #include "PropertyMapHashTable.h"
@@ -104,6 +105,7 @@
 #include "UnlinkedCodeBlock.h"
 #include "VMEntryScope.h"
 #include "VMInspector.h"
+#include "WasmTierUpPlan.h"
 #include "Watchdog.h"
 #include "WeakGCMapInlines.h"
 #include "WeakMapData.h"
@@ -315,6 +317,9 @@ VM::VM(VMType vmType, HeapType heapType)
         m_perBytecodeProfiler->registerToSaveAtExit(pathOut.toCString().data());
     }
 
+    if (Options::profileCachePath())
+        m_profileCache = std::make_unique<ProfileCache>(*this, Options::profileCachePath());
+
     callFrameForCatch = nullptr;
 
 #if ENABLE(DFG_JIT)
@@ -387,8 +392,23 @@ VM::~VM()
         }
     }
 #endif // ENABLE(DFG_JIT)
+
+#if ENABLE(WEBASSEMBLY)
+    // Tier-up compiles that finish now have nowhere to install their code, and would outlive us.
+    Wasm::TierUpPlan::cancelAndWaitForPlansForVM(*this);
+#endif
     
     waitForAsynchronousDisassembly();
+
+    if (m_profileCache) {
+        // The API lock cannot be taken here, since that would ref this VM. Whoever drops the
+        // last reference normally holds it, as JSContextGroupRelease() does.
+        if (currentThreadIsHoldingAPILock())
+            m_profileCache->save();
+        else if (Options::reportProfileCacheStatistics())
+            dataLogLn("Not saving profiles to ", Options::profileCachePath(), ": the VM was destroyed without holding its lock");
+        m_profileCache = nullptr;
+    }
     
     // Clear this first to ensure that nobody tries to remove themselves from it.
     m_perBytecodeProfiler = nullptr;
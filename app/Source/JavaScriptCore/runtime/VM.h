@@ -106,6 +106,7 @@ class JSObject;
 class JSWebAssemblyInstance;
 class LLIntOffsetsExtractor;
 class NativeExecutable;
+class ProfileCache;
 class RegExpCache;
 class Register;
 class RegisterAtOffsetList;
@@ -598,6 +599,8 @@ public:
     double cachedDateStringValue;
 
     std::unique_ptr<Profiler::Database> m_perBytecodeProfiler;
+    ProfileCache* profileCache() { return m_profileCache.get(); }
+    std::unique_ptr<ProfileCache> m_profileCache;
     RefPtr<TypedArrayController> m_typedArrayController;
     RegExpCache* m_regExpCache;
     BumpPointerAllocator m_regExpAllocator;
@@ -26,15 +26,24 @@ add_dependencies(testRegExp testRegExpLib)
 target_link_libraries(testRegExpLib JavaScriptCore)
 
 add_library(testapiLib SHARED
+    ../API/tests/CachedBytecodeTest.cpp
     ../API/tests/CompareAndSwapTest.cpp
+    ../API/tests/ConcurrentProgramCompilationTest.cpp
     ../API/tests/CustomGlobalObjectClassTest.c
     ../API/tests/ExecutionTimeLimitTest.cpp
     ../API/tests/FunctionOverridesTest.cpp
     ../API/tests/GlobalContextWithFinalizerTest.cpp
+    ../API/tests/IntlCollatorTest.cpp
     ../API/tests/JSONParseTest.cpp
     ../API/tests/PingPongStackOverflowTest.cpp
+    ../API/tests/ProfileCacheTest.cpp
+    ../API/tests/SamplingProfilerExportTest.cpp
+    ../API/tests/SharedBuiltinImageTest.cpp
+    ../API/tests/StringKernelsTest.cpp
     ../API/tests/testapi.c
     ../API/tests/TypedArrayCTest.cpp
+    ../API/tests/TypedArrayKernelsTest.cpp
+    ../API/tests/WasmStreamingTest.cpp
 )
 set_source_files_properties(../API/tests/CustomGlobalObjectClassTest.c PROPERTIES COMPILE_FLAGS "/TP /MT")
 set_source_files_properties(../API/tests/testapi.c PROPERTIES COMPILE_FLAGS "/TP /MT")
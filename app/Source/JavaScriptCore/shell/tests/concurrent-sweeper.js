@@ -0,0 +1,87 @@
+// Allocates heavily while the GC helper threads build free lists behind the mutator, and checks
+// that no live object is ever handed out again. The heap mixes cells without destructors, which
+// ConcurrentSweeper sweeps, with destructible ones, which it leaves to the mutator, often in the
+// same size classes. Collections are started mid-allocation so that stopSweeping() regularly
+// cancels a sweep that is still running.
+// Usage: jsc --useConcurrentSweeping=true --numberOfGCMarkers=<more than 1> concurrent-sweeper.js
+
+function assert(condition, message)
+{
+    if (!condition)
+        throw new Error("FAIL: " + message);
+}
+
+let seed = 1;
+function random(limit)
+{
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    return seed % limit;
+}
+
+const kinds = [
+    // No destructor.
+    (id) => ({ id: id, name: "object" + id, next: { id: id + 1 } }),
+    (id) => [id, id + 1, id + 2, "array" + id],
+    (id) => { const f = function() { return id; }; f.id = id; return f; },
+    // Destructible, or holding destructible cells.
+    (id) => ["string", id, "x".repeat(id % 40)].join(":"),
+    (id) => { const map = new Map; map.set("id", id); map.set(id, "value" + id); return map; },
+    (id) => { const array = new Int32Array(4 + id % 8); array.fill(id); return array; },
+    (id) => new RegExp("id" + id + "(a|b)*"),
+];
+
+function check(value, kind, id)
+{
+    switch (kind) {
+    case 0:
+        return value.id === id && value.name === "object" + id && value.next.id === id + 1;
+    case 1:
+        return value.length === 4 && value[0] === id && value[2] === id + 2 && value[3] === "array" + id;
+    case 2:
+        return value() === id && value.id === id;
+    case 3:
+        return value === ["string", id, "x".repeat(id % 40)].join(":");
+    case 4:
+        return value.size === 2 && value.get("id") === id && value.get(id) === "value" + id;
+    case 5:
+        return value.length === 4 + id % 8 && value.every((element) => element === id);
+    case 6:
+        return value.source === "id" + id + "(a|b)*" && value.test("id" + id + "ab");
+    }
+    return false;
+}
+
+const liveCount = 2000;
+const live = [];
+let nextId = 0;
+function makeEntry()
+{
+    const kind = random(kinds.length);
+    const id = nextId++;
+    return { kind: kind, id: id, value: kinds[kind](id) };
+}
+
+for (let i = 0; i < liveCount; ++i)
+    live.push(makeEntry());
+
+let garbage;
+for (let round = 0; round < 200; ++round) {
+    for (let i = 0; i < 5000; ++i) {
+        // Mostly garbage, which the helpers sweep and the mutator then allocates into.
+        garbage = kinds[random(kinds.length)](i);
+
+        if (!random(10))
+            live[random(liveCount)] = makeEntry();
+
+        // Start collections while the helpers are still sweeping the last one's blocks.
+        if (i === 1000 + round * 10)
+            edenGC();
+        if (i === 3000 && !(round % 10))
+            fullGC();
+    }
+
+    for (let i = 0; i < liveCount; ++i) {
+        const entry = live[i];
+        assert(check(entry.value, entry.kind, entry.id), "entry " + i + " (kind " + entry.kind + ", id " + entry.id + ") was overwritten in round " + round);
+    }
+}
@@ -0,0 +1,155 @@
+// Checks that WebAssembly calls keep returning the right values while their callees tier up
+// and the optimized entrypoints are swapped in: direct wasm->wasm calls, call_indirect and
+// JS calls through a table, exported functions, and JS and wasm imports. Some of the swaps
+// happen while baseline frames of the callers are still on the stack.
+// Usage: jsc --useWebAssemblyTierUp=true --webAssemblyTierUpThreshold=<small> wasm-tier-up.js
+
+function assert(condition, message)
+{
+    if (!condition)
+        throw new Error("FAIL: " + message);
+}
+
+function varuint(value)
+{
+    const bytes = [];
+    do {
+        let byte = value & 0x7f;
+        value >>>= 7;
+        if (value)
+            byte |= 0x80;
+        bytes.push(byte);
+    } while (value);
+    return bytes;
+}
+
+function string(text)
+{
+    return [...varuint(text.length), ...Array.from(text, (c) => c.charCodeAt(0))];
+}
+
+function vector(entries)
+{
+    return [...varuint(entries.length), ...[].concat(...entries)];
+}
+
+function section(id, entries)
+{
+    const payload = vector(entries);
+    return [id, ...varuint(payload.length), ...payload];
+}
+
+function body(locals, code)
+{
+    const payload = [...vector(locals), ...code, Op.End];
+    return [...varuint(payload.length), ...payload];
+}
+
+function module(sections)
+{
+    return new WebAssembly.Module(new Uint8Array([0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, ...[].concat(...sections)]));
+}
+
+const I32 = 0x7f;
+const AnyFunc = 0x70;
+const Kind = { Function: 0, Table: 1 };
+const Section = { Type: 1, Import: 2, Function: 3, Table: 4, Export: 7, Element: 9, Code: 10 };
+const Op = {
+    Loop: 0x03, End: 0x0b, BrIf: 0x0d, Call: 0x10, CallIndirect: 0x11,
+    GetLocal: 0x20, SetLocal: 0x21, TeeLocal: 0x22, I32Const: 0x41,
+    I32LtS: 0x48, I32Add: 0x6a, I32Mul: 0x6c,
+};
+const Void = 0x40;
+
+// (i32) -> i32 and (i32, i32) -> i32.
+const types = section(Section.Type, [[0x60, 1, I32, 1, I32], [0x60, 2, I32, I32, 1, I32]]);
+
+// triple(x) = 3x, imported into the second module as a wasm->wasm import.
+const provider = new WebAssembly.Instance(module([
+    types,
+    section(Section.Function, [[0]]),
+    section(Section.Export, [[...string("triple"), Kind.Function, 0]]),
+    section(Section.Code, [body([], [Op.GetLocal, 0, Op.I32Const, 3, Op.I32Mul])]),
+]), {});
+
+// Function indices: 0 js, 1 triple (imports), 2 leaf, 3 direct, 4 indirect, 5 viaImports, 6 loop.
+//   leaf(x) = 2x + 1
+//   direct(x) = leaf(x) + leaf(x + 1)
+//   indirect(x, i) = table[i](x), with table = [leaf, direct, triple, viaImports]
+//   viaImports(x) = js(x) + triple(x) + leaf(x)
+//   loop(n) = direct(0) + ... + direct(n - 1), for n > 0
+const callerBytes = [
+    types,
+    section(Section.Import, [
+        [...string("env"), ...string("js"), Kind.Function, 0],
+        [...string("env"), ...string("triple"), Kind.Function, 0],
+    ]),
+    section(Section.Function, [[0], [0], [1], [0], [0]]),
+    section(Section.Table, [[AnyFunc, 0, 4]]),
+    section(Section.Export, [
+        [...string("leaf"), Kind.Function, 2],
+        [...string("direct"), Kind.Function, 3],
+        [...string("indirect"), Kind.Function, 4],
+        [...string("viaImports"), Kind.Function, 5],
+        [...string("loop"), Kind.Function, 6],
+        [...string("table"), Kind.Table, 0],
+    ]),
+    section(Section.Element, [[0, Op.I32Const, 0, Op.End, ...vector([[2], [3], [1], [5]])]]),
+    section(Section.Code, [
+        body([], [Op.GetLocal, 0, Op.I32Const, 2, Op.I32Mul, Op.I32Const, 1, Op.I32Add]),
+        body([], [Op.GetLocal, 0, Op.Call, 2, Op.GetLocal, 0, Op.I32Const, 1, Op.I32Add, Op.Call, 2, Op.I32Add]),
+        body([], [Op.GetLocal, 0, Op.GetLocal, 1, Op.CallIndirect, 0, 0]),
+        body([], [Op.GetLocal, 0, Op.Call, 0, Op.GetLocal, 0, Op.Call, 1, Op.I32Add, Op.GetLocal, 0, Op.Call, 2, Op.I32Add]),
+        body([[2, I32]], [
+            Op.Loop, Void,
+            Op.GetLocal, 2, Op.GetLocal, 1, Op.Call, 3, Op.I32Add, Op.SetLocal, 2,
+            Op.GetLocal, 1, Op.I32Const, 1, Op.I32Add, Op.TeeLocal, 1,
+            Op.GetLocal, 0, Op.I32LtS, Op.BrIf, 0,
+            Op.End,
+            Op.GetLocal, 2,
+        ]),
+    ]),
+];
+
+const leaf = (x) => 2 * x + 1;
+const direct = (x) => leaf(x) + leaf(x + 1);
+const triple = (x) => 3 * x;
+const js = (x) => x + 1;
+const viaImports = (x) => js(x) + triple(x) + leaf(x);
+const loop = (n) => 2 * n * n + 2 * n;
+const table = [leaf, direct, triple, viaImports];
+
+let exports;
+let reentries = 0;
+
+function checkAll(x)
+{
+    assert(exports.leaf(x) === leaf(x), "leaf(" + x + ")");
+    assert(exports.direct(x) === direct(x), "direct(" + x + ")");
+    for (let i = 0; i < table.length; ++i) {
+        assert(exports.indirect(x, i) === table[i](x), "indirect(" + x + ", " + i + ")");
+        assert(exports.table.get(i)(x) === table[i](x), "table.get(" + i + ")(" + x + ")");
+    }
+    assert(exports.viaImports(x) === viaImports(x), "viaImports(" + x + ")");
+    const n = (x & 63) + 1;
+    assert(exports.loop(n) === loop(n), "loop(" + n + ")");
+}
+
+// Every so often the JS import runs the whole suite again, and more, before it returns to the
+// baseline viaImports frame that called it, so callees tier up underneath that frame.
+function jsImport(x)
+{
+    if (x % 97 === 0 && !reentries) {
+        ++reentries;
+        for (let i = 0; i < 50; ++i)
+            checkAll(x + i + 1);
+        assert(exports.loop(1000) === loop(1000), "loop(1000) under a baseline frame");
+        --reentries;
+    }
+    return js(x);
+}
+
+exports = new WebAssembly.Instance(module(callerBytes), { env: { js: jsImport, triple: provider.exports.triple } }).exports;
+
+for (let x = 0; x < 20000; ++x)
+    checkAll(x);
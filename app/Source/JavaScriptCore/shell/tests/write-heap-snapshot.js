@@ -0,0 +1,112 @@
+// Checks that writeHeapSnapshot() produces a complete stream in the format described in
+// heap/HeapSnapshotStreamWriter.h, with and without deduplicated edge names.
+// Usage: jsc write-heap-snapshot.js -- <scratch file>
+
+if (arguments.length < 1)
+    throw new Error("Usage: jsc write-heap-snapshot.js -- <scratch file>");
+const path = arguments[0];
+
+const Tag = { String: 1, Node: 2, Edge: 3, End: 4 };
+const EdgeType = { Internal: 0, Property: 1, Index: 2, Variable: 3 };
+
+function assert(condition, message)
+{
+    if (!condition)
+        throw new Error("FAIL: " + message);
+}
+
+function parse(bytes)
+{
+    let offset = 0;
+    function readNumber() {
+        let value = 0;
+        let scale = 1;
+        for (;;) {
+            assert(offset < bytes.length, "number runs past the end of the stream");
+            let byte = bytes[offset++];
+            value += (byte & 0x7f) * scale;
+            if (!(byte & 0x80))
+                return value;
+            scale *= 128;
+        }
+    }
+
+    const magic = "JSCHEAPS";
+    for (let i = 0; i < magic.length; ++i)
+        assert(bytes[offset++] === magic.charCodeAt(i), "bad magic");
+
+    const snapshot = { version: readNumber(), flags: readNumber(), strings: [], nodes: new Map, edges: [], end: null };
+    while (offset < bytes.length) {
+        assert(!snapshot.end, "records after End");
+        const tag = bytes[offset++];
+        switch (tag) {
+        case Tag.String: {
+            const index = readNumber();
+            const length = readNumber();
+            assert(index === snapshot.strings.length, "string indexes are not sequential");
+            let string = "";
+            for (let i = 0; i < length; ++i)
+                string += String.fromCharCode(bytes[offset++]);
+            snapshot.strings.push(string);
+            break;
+        }
+        case Tag.Node: {
+            const cell = readNumber();
+            const node = { size: readNumber(), className: readNumber(), internal: readNumber() };
+            assert(node.className < snapshot.strings.length, "node refers to a string that was not written yet");
+            assert(!snapshot.nodes.has(cell), "node written twice");
+            snapshot.nodes.set(cell, node);
+            break;
+        }
+        case Tag.Edge: {
+            const edge = { from: readNumber(), to: readNumber(), type: readNumber(), extraData: readNumber() };
+            assert(edge.type <= EdgeType.Variable, "bad edge type");
+            if (edge.type === EdgeType.Property || edge.type === EdgeType.Variable)
+                assert(edge.extraData < snapshot.strings.length, "edge refers to a string that was not written yet");
+            snapshot.edges.push(edge);
+            break;
+        }
+        case Tag.End:
+            snapshot.end = { nodeCount: readNumber(), edgeCount: readNumber() };
+            break;
+        default:
+            assert(false, "unknown tag " + tag);
+        }
+    }
+    return snapshot;
+}
+
+// Something to look for: an object reachable from the global object through a distinctive name,
+// holding an array through another.
+this.heapSnapshotTestObject = { heapSnapshotTestArray: [1, 2, 3] };
+
+for (const deduplicate of [true, false]) {
+    assert(writeHeapSnapshot(path, deduplicate) === true, "writeHeapSnapshot failed");
+    const snapshot = parse(readFile(path, "binary"));
+
+    assert(snapshot.version === 1, "unexpected version " + snapshot.version);
+    assert(snapshot.flags === (deduplicate ? 1 : 0), "flags do not match deduplicateEdgeNames");
+    assert(snapshot.end, "stream has no End record");
+    assert(snapshot.end.nodeCount === snapshot.nodes.size, "End node count does not match");
+    assert(snapshot.end.edgeCount === snapshot.edges.length, "End edge count does not match");
+    assert(snapshot.nodes.size > 0 && snapshot.edges.length > 0, "empty snapshot");
+
+    for (const edge of snapshot.edges)
+        assert((!edge.from || snapshot.nodes.has(edge.from)) && snapshot.nodes.has(edge.to), "edge to or from a cell that is not a node");
+
+    if (deduplicate) {
+        const seen = new Set;
+        for (const string of snapshot.strings) {
+            assert(!seen.has(string), "string " + string + " written twice");
+            seen.add(string);
+        }
+    }
+
+    const propertyEdge = (name) => snapshot.edges.find((edge) => edge.type === EdgeType.Property && snapshot.strings[edge.extraData] === name);
+    const objectEdge = propertyEdge("heapSnapshotTestObject");
+    assert(objectEdge, "no edge to heapSnapshotTestObject");
+    assert(snapshot.strings[snapshot.nodes.get(objectEdge.to).className] === "Object", "heapSnapshotTestObject is not an Object");
+    const arrayEdge = propertyEdge("heapSnapshotTestArray");
+    assert(arrayEdge && arrayEdge.from === objectEdge.to, "no edge from heapSnapshotTestObject to its array");
+    assert(snapshot.strings[snapshot.nodes.get(arrayEdge.to).className] === "Array", "heapSnapshotTestArray is not an Array");
+}
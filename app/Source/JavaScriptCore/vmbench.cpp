@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures how long it takes to bring up a VM with a global object, and how much memory each
+// one adds, the way an embedder filling a pool of worker VMs would. Every VM stays alive until
+// the end. Compare runs with and without JSC_useSharedBuiltinImage=true to see what sharing
+// builtins across VMs buys.
+
+#include "config.h"
+
+#include "Completion.h"
+#include "Exception.h"
+#include "InitializeThreading.h"
+#include "JSCInlines.h"
+#include "JSGlobalObject.h"
+#include "JSLock.h"
+#include "VM.h"
+#include <wtf/CurrentTime.h>
+#include <wtf/MainThread.h>
+#include <wtf/MemoryFootprint.h>
+#include <wtf/Vector.h>
+
+using namespace JSC;
+
+namespace {
+
+// Calls a handful of builtins so that their bytecode gets generated, as it would in a worker
+// that runs anything at all.
+const char* warmUpScript =
+    "[3, 1, 2].map(x => x + 1).filter(x => x > 2).sort().forEach(x => x);"
+    "Array.from(new Set([1, 2, 3])).includes(2);"
+    "Promise.resolve(42).then(x => x);"
+    "'abc'.padStart(5).repeat(2);";
+
+size_t currentFootprint()
+{
+    return memoryFootprint().value_or(0);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    unsigned vmCount = 64;
+    if (argc >= 2) {
+        if (argv[1][0] == '-' || sscanf(argv[1], "%u", &vmCount) != 1 || !vmCount) {
+            dataLog("Usage: vmbench [<VM count>]\n");
+            return 1;
+        }
+    }
+
+    WTF::initializeMainThread();
+    JSC::initializeThreading();
+
+    dataLog("Shared builtin image: ", Options::useSharedBuiltinImage() ? "on" : "off", "\n");
+
+    Vector<VM*> vms;
+    size_t footprintBefore = currentFootprint();
+    double firstVMTime = 0;
+    double totalTime = 0;
+    double totalWarmUpTime = 0;
+    for (unsigned i = 0; i < vmCount; ++i) {
+        double before = monotonicallyIncreasingTimeMS();
+        VM* vm = &VM::create(SmallHeap).leakRef();
+        {
+            JSLockHolder locker(vm);
+            JSGlobalObject* globalObject = JSGlobalObject::create(*vm, JSGlobalObject::createStructure(*vm, jsNull()));
+            double created = monotonicallyIncreasingTimeMS();
+
+            NakedPtr<Exception> exception;
+            evaluate(globalObject->globalExec(), makeSource(warmUpScript, { }), JSValue(), exception);
+            if (exception) {
+                dataLog("Warm-up script threw: ", exception->value(), "\n");
+                return 1;
+            }
+            double warmedUp = monotonicallyIncreasingTimeMS();
+
+            if (!i)
+                firstVMTime = created - before;
+            totalTime += created - before;
+            totalWarmUpTime += warmedUp - created;
+        }
+        vms.append(vm);
+    }
+    size_t footprintAfter = currentFootprint();
+
+    dataLog("First VM: ", firstVMTime, " ms.\n");
+    if (vmCount > 1)
+        dataLog("Later VMs: ", (totalTime - firstVMTime) / (vmCount - 1), " ms each.\n");
+    dataLog("Warm-up script: ", totalWarmUpTime / vmCount, " ms per VM.\n");
+    if (footprintBefore && footprintAfter)
+        dataLog("Footprint: ", (footprintAfter - footprintBefore) / vmCount / 1024, " KB per VM.\n");
+    else
+        dataLog("Footprint: not available on this platform.\n");
+    return 0;
+}
@@ -31,6 +31,7 @@
 #include "JSWebAssemblyCallee.h"
 #include "UnconditionalFinalizer.h"
 #include "WasmFormat.h"
+#include "WasmTierUpState.h"
 #include <wtf/Bag.h>
 #include <wtf/Vector.h>
 
@@ -44,9 +45,9 @@ public:
     typedef JSCell Base;
     static const unsigned StructureFlags = Base::StructureFlags | StructureIsImmortal;
 
-    static JSWebAssemblyCodeBlock* create(VM& vm, JSWebAssemblyModule* owner, Bag<CallLinkInfo>&& callLinkInfos, Vector<Wasm::WasmExitStubs>&& exitStubs, Wasm::Memory::Mode mode, unsigned calleeCount)
+    static JSWebAssemblyCodeBlock* create(VM& vm, JSWebAssemblyModule* owner, Bag<CallLinkInfo>&& callLinkInfos, Vector<Wasm::WasmExitStubs>&& exitStubs, Ref<Wasm::TierUpState>&& tierUpState, Wasm::Memory::Mode mode, unsigned calleeCount)
     {
-        auto* result = new (NotNull, allocateCell<JSWebAssemblyCodeBlock>(vm.heap, allocationSize(calleeCount))) JSWebAssemblyCodeBlock(vm, owner, std::forward<Bag<CallLinkInfo>>(callLinkInfos), std::forward<Vector<Wasm::WasmExitStubs>>(exitStubs), mode, calleeCount);
+        auto* result = new (NotNull, allocateCell<JSWebAssemblyCodeBlock>(vm.heap, allocationSize(calleeCount))) JSWebAssemblyCodeBlock(vm, owner, std::forward<Bag<CallLinkInfo>>(callLinkInfos), std::forward<Vector<Wasm::WasmExitStubs>>(exitStubs), WTFMove(tierUpState), mode, calleeCount);
         result->finishCreation(vm);
         return result;
     }
@@ -59,6 +60,8 @@ public:
     unsigned functionImportCount() const { return m_wasmExitStubs.size(); }
     Wasm::Memory::Mode mode() const { return m_mode; }
     JSWebAssemblyModule* module() const { return m_module.get(); }
+    Wasm::TierUpState& tierUpState() { return m_tierUpState.get(); }
+    const Wasm::WasmExitStubs& wasmExitStubs(unsigned importFunctionIndex) const { return m_wasmExitStubs[importFunctionIndex]; }
     bool isSafeToRun(JSWebAssemblyMemory*);
 
     JSWebAssemblyCallee* jsEntrypointCalleeFromFunctionIndexSpace(unsigned functionIndexSpace)
@@ -77,6 +80,14 @@ public:
         return callees()[calleeIndex + m_calleeCount].get();
     }
 
+    void** wasmEntrypointLoadLocationFromFunctionIndexSpace(unsigned functionIndexSpace)
+    {
+        RELEASE_ASSERT(functionIndexSpace >= functionImportCount());
+        unsigned calleeIndex = functionIndexSpace - functionImportCount();
+        RELEASE_ASSERT(calleeIndex < m_calleeCount);
+        return m_tierUpState->entrypointLoadLocation(calleeIndex);
+    }
+
     void setJSEntrypointCallee(VM& vm, unsigned calleeIndex, JSWebAssemblyCallee* callee)
     {
         RELEASE_ASSERT(calleeIndex < m_calleeCount);
@@ -89,13 +100,21 @@ public:
         callees()[calleeIndex + m_calleeCount].set(vm, this, callee);
     }
 
+    // The baseline callee stays alive too, since it may still be on the stack.
+    void setOptimizedWasmEntrypointCallee(VM& vm, unsigned calleeIndex, JSWebAssemblyCallee* callee)
+    {
+        RELEASE_ASSERT(calleeIndex < m_calleeCount);
+        callees()[calleeIndex + m_calleeCount * 2].set(vm, this, callee);
+    }
+
     WriteBarrier<JSWebAssemblyCallee>* callees()
     {
         return bitwise_cast<WriteBarrier<JSWebAssemblyCallee>*>(bitwise_cast<char*>(this) + offsetOfCallees());
     }
 
 private:
-    JSWebAssemblyCodeBlock(VM&, JSWebAssemblyModule*, Bag<CallLinkInfo>&&, Vector<Wasm::WasmExitStubs>&&, Wasm::Memory::Mode, unsigned calleeCount);
+    JSWebAssemblyCodeBlock(VM&, JSWebAssemblyModule*, Bag<CallLinkInfo>&&, Vector<Wasm::WasmExitStubs>&&, Ref<Wasm::TierUpState>&&, Wasm::Memory::Mode, unsigned calleeCount);
+    ~JSWebAssemblyCodeBlock();
     DECLARE_EXPORT_INFO;
     static const bool needsDestruction = true;
     static void destroy(JSCell*);
@@ -108,7 +127,7 @@ private:
 
     static size_t allocationSize(unsigned numCallees)
     {
-        return offsetOfCallees() + sizeof(WriteBarrier<JSWebAssemblyCallee>) * numCallees * 2;
+        return offsetOfCallees() + sizeof(WriteBarrier<JSWebAssemblyCallee>) * numCallees * 3;
     }
 
     class UnconditionalFinalizer : public JSC::UnconditionalFinalizer {
@@ -119,6 +138,7 @@ private:
     UnconditionalFinalizer m_unconditionalFinalizer;
     Bag<CallLinkInfo> m_callLinkInfos;
     Vector<Wasm::WasmExitStubs> m_wasmExitStubs;
+    Ref<Wasm::TierUpState> m_tierUpState;
     Wasm::Memory::Mode m_mode;
     unsigned m_calleeCount;
 };
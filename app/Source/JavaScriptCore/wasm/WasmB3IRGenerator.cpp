@@ -51,6 +51,7 @@
 #include "WasmExceptionType.h"
 #include "WasmFunctionParser.h"
 #include "WasmMemory.h"
+#include "WasmTierUpState.h"
 #include <wtf/Optional.h>
 
 void dumpProcedure(void* ptr)
@@ -155,7 +156,7 @@ public:
             return fail(__VA_ARGS__);             \
     } while (0)
 
-    B3IRGenerator(VM&, const ModuleInformation&, Procedure&, WasmInternalFunction*, Vector<UnlinkedWasmToWasmCall>&);
+    B3IRGenerator(VM&, const ModuleInformation&, Procedure&, WasmInternalFunction*, Vector<UnlinkedWasmToWasmCall>&, TierUpState*, unsigned functionIndex);
 
     PartialResult WARN_UNUSED_RETURN addArguments(const Signature*);
     PartialResult WARN_UNUSED_RETURN addLocal(Type, uint32_t);
@@ -217,8 +218,12 @@ private:
 
     void emitChecksForModOrDiv(B3::Opcode, ExpressionType left, ExpressionType right);
 
+    void emitTierUpCheck(int32_t decrement);
+
     VM& m_vm;
     const ModuleInformation& m_info;
+    TierUpState* m_tierUpState;
+    unsigned m_functionIndex;
     Procedure& m_proc;
     BasicBlock* m_currentBlock;
     Vector<Variable*> m_locals;
@@ -229,9 +234,11 @@ private:
     Value* m_instanceValue;
 };
 
-B3IRGenerator::B3IRGenerator(VM& vm, const ModuleInformation& info, Procedure& procedure, WasmInternalFunction* compilation, Vector<UnlinkedWasmToWasmCall>& unlinkedWasmToWasmCalls)
+B3IRGenerator::B3IRGenerator(VM& vm, const ModuleInformation& info, Procedure& procedure, WasmInternalFunction* compilation, Vector<UnlinkedWasmToWasmCall>& unlinkedWasmToWasmCalls, TierUpState* tierUpState, unsigned functionIndex)
     : m_vm(vm)
     , m_info(info)
+    , m_tierUpState(tierUpState)
+    , m_functionIndex(functionIndex)
     , m_proc(procedure)
     , m_unlinkedWasmToWasmCalls(unlinkedWasmToWasmCalls)
 {
@@ -272,6 +279,41 @@ B3IRGenerator::B3IRGenerator(VM& vm, const ModuleInformation& info, Procedure& p
 
     m_instanceValue = m_currentBlock->appendNew<MemoryValue>(m_proc, Load, pointerType(), Origin(),
         m_currentBlock->appendNew<ConstPtrValue>(m_proc, Origin(), &m_vm.topJSWebAssemblyInstance));
+
+    emitTierUpCheck(TierUpCount::functionEntryDecrement);
+}
+
+void B3IRGenerator::emitTierUpCheck(int32_t decrement)
+{
+    if (!m_tierUpState)
+        return;
+
+    void (*triggerTierUp) (ExecState*, TierUpState*, uint32_t) = [] (ExecState* exec, TierUpState* tierUpState, uint32_t functionIndex) {
+        tierUpState->triggerTierUp(exec->vm(), functionIndex);
+    };
+
+    Value* countAddress = m_currentBlock->appendNew<ConstPtrValue>(m_proc, Origin(), &m_tierUpState->tierUpCount(m_functionIndex).count);
+    Value* count = m_currentBlock->appendNew<MemoryValue>(m_proc, Load, Int32, Origin(), countAddress);
+    Value* newCount = m_currentBlock->appendNew<Value>(m_proc, Sub, Origin(), count,
+        m_currentBlock->appendNew<Const32Value>(m_proc, Origin(), decrement));
+    m_currentBlock->appendNew<MemoryValue>(m_proc, Store, Origin(), newCount, countAddress);
+
+    BasicBlock* tierUp = m_proc.addBlock();
+    BasicBlock* continuation = m_proc.addBlock();
+
+    m_currentBlock->appendNewControlValue(m_proc, B3::Branch, Origin(),
+        m_currentBlock->appendNew<Value>(m_proc, LessThan, Origin(), newCount,
+            m_currentBlock->appendNew<Const32Value>(m_proc, Origin(), 0)),
+        FrequentedBlock(tierUp, FrequencyClass::Rare), FrequentedBlock(continuation));
+
+    tierUp->appendNew<CCallValue>(m_proc, B3::Void, Origin(),
+        tierUp->appendNew<ConstPtrValue>(m_proc, Origin(), bitwise_cast<void*>(triggerTierUp)),
+        tierUp->appendNew<B3::Value>(m_proc, B3::FramePointer, Origin()),
+        tierUp->appendNew<ConstPtrValue>(m_proc, Origin(), m_tierUpState),
+        tierUp->appendNew<Const32Value>(m_proc, Origin(), m_functionIndex));
+    tierUp->appendNewControlValue(m_proc, Jump, Origin(), continuation);
+
+    m_currentBlock = continuation;
 }
 
 struct MemoryBaseAndSize {
@@ -727,6 +769,7 @@ B3IRGenerator::ControlData B3IRGenerator::addLoop(Type signature)
     m_currentBlock->appendNewControlValue(m_proc, Jump, Origin(), body);
     body->addPredecessor(m_currentBlock);
     m_currentBlock = body;
+    emitTierUpCheck(TierUpCount::loopDecrement);
     return ControlData(m_proc, signature, BlockType::Loop, continuation, body);
 }
 
@@ -976,7 +1019,12 @@ auto B3IRGenerator::addCallIndirect(const Signature* signature, SignatureIndex s
         });
     }
 
-    ExpressionType calleeCode = m_currentBlock->appendNew<MemoryValue>(m_proc, Load, pointerType(), Origin(), callableFunction, OBJECT_OFFSETOF(CallableFunction, code));
+    // The table points at where the callee's current entrypoint is stored, rather than at the
+    // entrypoint itself, so that it picks up optimized code without having to find every table
+    // the callee is in. The first load does not depend on the checks above, so this only adds
+    // the latency of one load that stays in cache for hot callees.
+    ExpressionType calleeCode = m_currentBlock->appendNew<MemoryValue>(m_proc, Load, pointerType(), Origin(),
+        m_currentBlock->appendNew<MemoryValue>(m_proc, Load, pointerType(), Origin(), callableFunction, OBJECT_OFFSETOF(CallableFunction, entrypointLoadLocation)));
 
     Type returnType = signature->returnType();
     result = wasmCallingConvention().setupCall(m_proc, m_currentBlock, Origin(), args, toB3Type(returnType),
@@ -1035,8 +1083,10 @@ void B3IRGenerator::dump(const Vector<ControlEntry>& controlStack, const Express
     dataLogLn();
 }
 
-static void createJSToWasmWrapper(VM& vm, CompilationContext& compilationContext, WasmInternalFunction& function, const Signature* signature, const ModuleInformation& info)
+void createJSToWasmWrapper(VM& vm, CompilationContext& compilationContext, WasmInternalFunction& function, const Signature* signature, const ModuleInformation& info)
 {
+    compilationContext.jsEntrypointJIT = std::make_unique<CCallHelpers>(&vm);
+
     Procedure proc;
     BasicBlock* block = proc.addBlock();
 
@@ -1118,15 +1168,15 @@ static void createJSToWasmWrapper(VM& vm, CompilationContext& compilationContext
     function.jsToWasmEntrypoint.calleeSaveRegisters = proc.calleeSaveRegisters();
 }
 
-Expected<std::unique_ptr<WasmInternalFunction>, String> parseAndCompile(VM& vm, CompilationContext& compilationContext, const uint8_t* functionStart, size_t functionLength, const Signature* signature, Vector<UnlinkedWasmToWasmCall>& unlinkedWasmToWasmCalls, const ModuleInformation& info, const Vector<SignatureIndex>& moduleSignatureIndicesToUniquedSignatureIndices, unsigned optLevel)
+Expected<std::unique_ptr<WasmInternalFunction>, String> parseAndCompile(VM& vm, CompilationContext& compilationContext, const uint8_t* functionStart, size_t functionLength, const Signature* signature, Vector<UnlinkedWasmToWasmCall>& unlinkedWasmToWasmCalls, const ModuleInformation& info, const Vector<SignatureIndex>& moduleSignatureIndicesToUniquedSignatureIndices, unsigned functionIndex, CompilationMode compilationMode, TierUpState* tierUpState)
 {
+    ASSERT(!tierUpState || compilationMode == CompilationMode::BaselineMode);
     auto result = std::make_unique<WasmInternalFunction>();
 
-    compilationContext.jsEntrypointJIT = std::make_unique<CCallHelpers>(&vm);
     compilationContext.wasmEntrypointJIT = std::make_unique<CCallHelpers>(&vm);
 
     Procedure procedure;
-    B3IRGenerator context(vm, info, procedure, result.get(), unlinkedWasmToWasmCalls);
+    B3IRGenerator context(vm, info, procedure, result.get(), unlinkedWasmToWasmCalls, tierUpState, functionIndex);
     FunctionParser<B3IRGenerator> parser(&vm, context, functionStart, functionLength, signature, info, moduleSignatureIndicesToUniquedSignatureIndices);
     WASM_FAIL_IF_HELPER_FAILS(parser.parse());
 
@@ -1140,13 +1190,14 @@ Expected<std::unique_ptr<WasmInternalFunction>, String> parseAndCompile(VM& vm,
         dataLog("Post SSA: ", procedure);
 
     {
+        // Baseline code only lives until the function gets hot, so it isn't worth optimizing.
+        unsigned optLevel = compilationMode == CompilationMode::BaselineMode ? 0 : 1;
         B3::prepareForGeneration(procedure, optLevel);
         B3::generate(procedure, *compilationContext.wasmEntrypointJIT);
         compilationContext.wasmEntrypointByproducts = procedure.releaseByproducts();
         result->wasmEntrypoint.calleeSaveRegisters = procedure.calleeSaveRegisters();
     }
 
-    createJSToWasmWrapper(vm, compilationContext, *result, signature, info);
     return WTFMove(result);
 }
 
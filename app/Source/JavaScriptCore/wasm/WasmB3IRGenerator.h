@@ -38,6 +38,7 @@ extern "C" void dumpProcedure(void*);
 namespace JSC { namespace Wasm {
 
 class MemoryInformation;
+class TierUpState;
 
 struct CompilationContext {
     std::unique_ptr<CCallHelpers> jsEntrypointJIT;
@@ -47,7 +48,15 @@ struct CompilationContext {
     CCallHelpers::Call jsEntrypointToWasmEntrypointCall;
 };
 
-Expected<std::unique_ptr<WasmInternalFunction>, String> parseAndCompile(VM&, CompilationContext&, const uint8_t*, size_t, const Signature*, Vector<UnlinkedWasmToWasmCall>&, const ModuleInformation&, const Vector<SignatureIndex>&, unsigned optLevel = 1);
+enum class CompilationMode {
+    // Compiles quickly and counts how often the function runs, so that it can tier up.
+    BaselineMode,
+    OptimizedMode,
+};
+
+Expected<std::unique_ptr<WasmInternalFunction>, String> parseAndCompile(VM&, CompilationContext&, const uint8_t*, size_t, const Signature*, Vector<UnlinkedWasmToWasmCall>&, const ModuleInformation&, const Vector<SignatureIndex>&, unsigned functionIndex, CompilationMode, TierUpState* = nullptr);
+
+void createJSToWasmWrapper(VM&, CompilationContext&, WasmInternalFunction&, const Signature*, const ModuleInformation&);
 
 } } // namespace JSC::Wasm
 
@@ -449,7 +449,8 @@ static MacroAssemblerCodeRef wasmToWasm(VM* vm, unsigned importIndex)
     }
 
     // Tail call into the callee WebAssembly function.
-    jit.loadPtr(JIT::Address(scratch, WebAssemblyFunction::offsetOfWasmEntryPointCode()), scratch);
+    jit.loadPtr(JIT::Address(scratch, WebAssemblyFunction::offsetOfWasmEntrypointLoadLocation()), scratch);
+    jit.loadPtr(JIT::Address(scratch), scratch);
     jit.jump(scratch);
 
     LinkBuffer patchBuffer(*vm, jit, GLOBAL_THUNK_ID);
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WasmCachedModule.h"
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "CachedBytecode.h"
+#include "Options.h"
+#include <wtf/Hasher.h>
+#include <wtf/SHA1.h>
+#include <wtf/text/StringBuilder.h>
+#include <wtf/text/StringHash.h>
+
+namespace JSC { namespace Wasm {
+
+// Bump this whenever CachedModule changes, or the meaning of a function index does.
+static const uint32_t cachedModuleMagic = 0x4357534a; // "JSWC"
+static const uint32_t cachedModuleVersion = 1;
+
+class CachedModuleReader {
+public:
+    CachedModuleReader(const uint8_t* data, size_t size)
+        : m_cursor(data)
+        , m_end(data + size)
+    {
+    }
+
+    std::optional<CachedModule> decode(const CachedModuleKey&);
+
+private:
+    uint32_t read32()
+    {
+        uint32_t result = 0;
+        readBytes(&result, sizeof(result));
+        return result;
+    }
+
+    uint64_t read64()
+    {
+        uint64_t result = 0;
+        readBytes(&result, sizeof(result));
+        return result;
+    }
+
+    bool readBytes(void* data, size_t size)
+    {
+        if (m_failed || static_cast<size_t>(m_end - m_cursor) < size) {
+            m_failed = true;
+            return false;
+        }
+        memcpy(data, m_cursor, size);
+        m_cursor += size;
+        return true;
+    }
+
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+    bool m_failed { false };
+};
+
+std::optional<CachedModule> CachedModuleReader::decode(const CachedModuleKey& key)
+{
+    if (read32() != cachedModuleMagic
+        || read32() != cachedModuleVersion
+        || read32() != sizeof(void*))
+        return std::nullopt;
+
+    uint64_t cachedSourceLength = read64();
+    SHA1::Digest digest;
+    readBytes(digest.data(), digest.size());
+    uint32_t payloadSize = read32();
+    uint32_t payloadHash = read32();
+    if (m_failed || static_cast<size_t>(m_end - m_cursor) != payloadSize)
+        return std::nullopt;
+
+    if (cachedSourceLength != key.sourceLength || digest != key.sourceDigest)
+        return std::nullopt;
+    if (payloadHash != StringHasher::hashMemory(m_cursor, payloadSize))
+        return std::nullopt;
+
+    CachedModule result;
+    result.functionCount = read32();
+    uint32_t hotFunctionCount = read32();
+    if (m_failed || hotFunctionCount > result.functionCount || static_cast<size_t>(m_end - m_cursor) != hotFunctionCount * sizeof(uint32_t))
+        return std::nullopt;
+
+    result.hotFunctions.reserveInitialCapacity(hotFunctionCount);
+    for (uint32_t i = 0; i < hotFunctionCount; ++i) {
+        uint32_t functionIndex = read32();
+        if (functionIndex >= result.functionCount)
+            return std::nullopt;
+        result.hotFunctions.uncheckedAppend(functionIndex);
+    }
+    return WTFMove(result);
+}
+
+static Ref<CachedBytecode> encodeCachedModule(const CachedModuleKey& key, const CachedModule& module)
+{
+    Vector<uint8_t> buffer;
+    auto appendBytes = [&] (const void* data, size_t size) { buffer.append(static_cast<const uint8_t*>(data), size); };
+    auto append32 = [&] (uint32_t value) { appendBytes(&value, sizeof(value)); };
+    auto append64 = [&] (uint64_t value) { appendBytes(&value, sizeof(value)); };
+
+    append32(cachedModuleMagic);
+    append32(cachedModuleVersion);
+    append32(sizeof(void*));
+    append64(key.sourceLength);
+    appendBytes(key.sourceDigest.data(), key.sourceDigest.size());
+
+    size_t payloadSizeOffset = buffer.size();
+    append32(0);
+    append32(0);
+    size_t payloadStart = buffer.size();
+
+    append32(module.functionCount);
+    append32(module.hotFunctions.size());
+    for (unsigned functionIndex : module.hotFunctions) {
+        ASSERT(functionIndex < module.functionCount);
+        append32(functionIndex);
+    }
+
+    uint32_t payloadSize = buffer.size() - payloadStart;
+    uint32_t payloadHash = StringHasher::hashMemory(buffer.data() + payloadStart, payloadSize);
+    memcpy(buffer.data() + payloadSizeOffset, &payloadSize, sizeof(payloadSize));
+    memcpy(buffer.data() + payloadSizeOffset + sizeof(payloadSize), &payloadHash, sizeof(payloadHash));
+    return CachedBytecode::create(WTFMove(buffer));
+}
+
+std::optional<CachedModuleKey> cachedModuleKey(const uint8_t* source, size_t sourceLength)
+{
+    const char* directory = Options::webAssemblyCachePath();
+    if (!directory || !*directory)
+        return std::nullopt;
+
+    CachedModuleKey key;
+    SHA1 sha1;
+    sha1.addBytes(source, sourceLength);
+    sha1.computeHash(key.sourceDigest);
+    key.sourceLength = sourceLength;
+    return key;
+}
+
+static String cachedModulePath(const CachedModuleKey& key)
+{
+    StringBuilder path;
+    path.append(Options::webAssemblyCachePath());
+    if (path[path.length() - 1] != '/')
+        path.append('/');
+    path.append(SHA1::hexDigest(key.sourceDigest).data());
+    path.appendLiteral(".wasmcache");
+    return path.toString();
+}
+
+std::optional<CachedModule> fetchCachedModule(const CachedModuleKey& key)
+{
+    RefPtr<CachedBytecode> cachedModule = CachedBytecode::createFromFile(cachedModulePath(key));
+    if (!cachedModule)
+        return std::nullopt;
+    CachedModuleReader reader(cachedModule->data(), cachedModule->size());
+    return reader.decode(key);
+}
+
+void storeCachedModule(const CachedModuleKey& key, const CachedModule& module)
+{
+    encodeCachedModule(key, module)->writeToFile(cachedModulePath(key));
+}
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if ENABLE(WEBASSEMBLY)
+
+#include <wtf/Optional.h>
+#include <wtf/SHA1.h>
+#include <wtf/Vector.h>
+
+namespace JSC { namespace Wasm {
+
+// What we remember about a module from one compile to the next: the functions that tiered up last
+// time, which are compiled with full optimization straight away instead of going through the
+// baseline tier first. It is only a hint. Function bodies are validated on every compile.
+//
+// Machine code is deliberately not part of this. B3 bakes VM-specific addresses (the current
+// instance slot, tier-up counters, C call targets) into the code it generates, in forms that
+// cannot be reliably found again to relocate them.
+struct CachedModule {
+    uint32_t functionCount { 0 };
+    Vector<unsigned> hotFunctions;
+};
+
+// Where a module's bytes are cached in Options::webAssemblyCachePath().
+struct CachedModuleKey {
+    SHA1::Digest sourceDigest;
+    uint64_t sourceLength;
+};
+
+// Returns nullopt, without looking at the bytes, if there is no cache path. Otherwise this hashes
+// the bytes, so it should only be done once per module.
+std::optional<CachedModuleKey> cachedModuleKey(const uint8_t* source, size_t sourceLength);
+
+// Returns nullopt if there is no entry, or it was produced by a different build or is truncated.
+std::optional<CachedModule> fetchCachedModule(const CachedModuleKey&);
+void storeCachedModule(const CachedModuleKey&, const CachedModule&);
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
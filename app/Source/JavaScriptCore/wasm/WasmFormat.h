@@ -40,6 +40,7 @@
 #include <limits>
 #include <memory>
 #include <wtf/Optional.h>
+#include <wtf/ThreadSafeRefCounted.h>
 #include <wtf/Vector.h>
 
 namespace JSC {
@@ -230,7 +231,8 @@ struct CustomSection {
     Vector<uint8_t> payload;
 };
 
-struct ModuleInformation {
+// Shared with the background compiles that tier up a module's functions.
+struct ModuleInformation : public ThreadSafeRefCounted<ModuleInformation> {
     Vector<Import> imports;
     Vector<SignatureIndex> importFunctionSignatureIndices;
     Vector<SignatureIndex> internalFunctionSignatureIndices;
@@ -296,15 +298,16 @@ struct WasmExitStubs {
 struct CallableFunction {
     CallableFunction() = default;
 
-    CallableFunction(SignatureIndex signatureIndex, void* code = nullptr)
+    CallableFunction(SignatureIndex signatureIndex, void** entrypointLoadLocation = nullptr)
         : signatureIndex(signatureIndex)
-        , code(code)
+        , entrypointLoadLocation(entrypointLoadLocation)
     {
     }
 
     // FIXME pack the SignatureIndex and the code pointer into one 64-bit value. https://bugs.webkit.org/show_bug.cgi?id=165511
     SignatureIndex signatureIndex { Signature::invalidIndex };
-    void* code { nullptr };
+    // Where the callee's current entrypoint is stored. This changes when the callee tiers up.
+    void** entrypointLoadLocation { nullptr };
 };
 typedef Vector<CallableFunction> FunctionIndexSpace;
 
@@ -49,15 +49,7 @@ ALWAYS_INLINE I32InitExpr makeI32InitExpr(uint8_t opcode, uint32_t bits)
 
 auto ModuleParser::parse() -> Result
 {
-    m_result.module = std::make_unique<ModuleInformation>();
-    const size_t minSize = 8;
-    uint32_t versionNumber;
-
-    WASM_PARSER_FAIL_IF(length() < minSize, "expected a module of at least ", minSize, " bytes");
-    WASM_PARSER_FAIL_IF(!consumeCharacter(0) || !consumeString("asm"), "modules doesn't start with '\\0asm'");
-    WASM_PARSER_FAIL_IF(!parseUInt32(versionNumber), "can't parse version number");
-    if (versionNumber != 0xD) // FIXME Stop supporting version 0xD temporarily. https://bugs.webkit.org/show_bug.cgi?id=168788
-        WASM_PARSER_FAIL_IF(versionNumber != expectedVersionNumber, "unexpected version number ", versionNumber, " expected ", expectedVersionNumber);
+    WASM_FAIL_IF_HELPER_FAILS(parseHeader());
 
     Section previousSection = Section::Custom;
     while (m_offset < length()) {
@@ -76,29 +68,49 @@ auto ModuleParser::parse() -> Result
         WASM_PARSER_FAIL_IF(!parseVarUInt32(sectionLength), "can't get ", section, " section's length");
         WASM_PARSER_FAIL_IF(sectionLength > length() - m_offset, section, "section of size ", sectionLength, " would overflow Module's size");
 
-        auto end = m_offset + sectionLength;
+        WASM_FAIL_IF_HELPER_FAILS(parseSection(section, sectionLength));
 
-        switch (section) {
-#define WASM_SECTION_PARSE(NAME, ID, DESCRIPTION)                   \
-        case Section::NAME: {                                       \
-            WASM_FAIL_IF_HELPER_FAILS(parse ## NAME());             \
-            break;                                                  \
-        }
-        FOR_EACH_WASM_SECTION(WASM_SECTION_PARSE)
-#undef WASM_SECTION_PARSE
+        previousSection = section;
+    }
 
-        case Section::Custom: {
-            WASM_FAIL_IF_HELPER_FAILS(parseCustom(sectionLength));
-            break;
-        }
-        }
+    return WTFMove(m_result);
+}
 
-        WASM_PARSER_FAIL_IF(end != m_offset, "parsing ended before the end of ", section, " section");
+auto ModuleParser::parseHeader() -> PartialResult
+{
+    m_result.module = adoptRef(*new ModuleInformation);
+    uint32_t versionNumber;
 
-        previousSection = section;
+    WASM_PARSER_FAIL_IF(length() < headerSize, "expected a module of at least ", headerSize, " bytes");
+    WASM_PARSER_FAIL_IF(!consumeCharacter(0) || !consumeString("asm"), "modules doesn't start with '\\0asm'");
+    WASM_PARSER_FAIL_IF(!parseUInt32(versionNumber), "can't parse version number");
+    if (versionNumber != 0xD) // FIXME Stop supporting version 0xD temporarily. https://bugs.webkit.org/show_bug.cgi?id=168788
+        WASM_PARSER_FAIL_IF(versionNumber != expectedVersionNumber, "unexpected version number ", versionNumber, " expected ", expectedVersionNumber);
+
+    return { };
+}
+
+auto ModuleParser::parseSection(Section section, uint32_t sectionLength) -> PartialResult
+{
+    auto end = m_offset + sectionLength;
+
+    switch (section) {
+#define WASM_SECTION_PARSE(NAME, ID, DESCRIPTION)                   \
+    case Section::NAME: {                                           \
+        WASM_FAIL_IF_HELPER_FAILS(parse ## NAME());                 \
+        break;                                                      \
     }
+    FOR_EACH_WASM_SECTION(WASM_SECTION_PARSE)
+#undef WASM_SECTION_PARSE
 
-    return WTFMove(m_result);
+    case Section::Custom: {
+        WASM_FAIL_IF_HELPER_FAILS(parseCustom(sectionLength));
+        break;
+    }
+    }
+
+    WASM_PARSER_FAIL_IF(end != m_offset, "parsing ended before the end of ", section, " section");
+    return { };
 }
 
 auto ModuleParser::parseType() -> PartialResult
@@ -36,13 +36,14 @@
 namespace JSC { namespace Wasm {
 
 struct ModuleParserResult {
-    std::unique_ptr<ModuleInformation> module;
+    RefPtr<ModuleInformation> module;
     Vector<FunctionLocationInBinary> functionLocationInBinary;
     Vector<SignatureIndex> moduleSignatureIndicesToUniquedSignatureIndices;
 };
 
 class ModuleParser : public Parser<ModuleParserResult> {
 public:
+    static const size_t headerSize = 8;
 
     ModuleParser(VM* vm, const uint8_t* sourceBuffer, size_t sourceLength, std::optional<Memory::Mode> mode)
         : Parser(vm, sourceBuffer, sourceLength)
@@ -53,6 +54,12 @@ public:
     Result WARN_UNUSED_RETURN parse();
 
 private:
+    // StreamingParser frames the module itself as its bytes arrive, and has us parse each section
+    // once all of it is available.
+    friend class StreamingParser;
+
+    PartialResult WARN_UNUSED_RETURN parseHeader();
+    PartialResult WARN_UNUSED_RETURN parseSection(Section, uint32_t sectionLength);
 
 #define WASM_SECTION_DECLARE_PARSER(NAME, ID, DESCRIPTION) PartialResult WARN_UNUSED_RETURN parse ## NAME();
     FOR_EACH_WASM_SECTION(WASM_SECTION_DECLARE_PARSER)
@@ -81,6 +81,13 @@ protected:
     const uint8_t* source() const { return m_source; }
     size_t length() const { return m_sourceLength; }
 
+    // For parsers whose input grows as it arrives.
+    void setSource(const uint8_t* source, size_t sourceLength)
+    {
+        m_source = source;
+        m_sourceLength = sourceLength;
+    }
+
     VM* m_vm;
     size_t m_offset = 0;
 
@@ -38,6 +38,7 @@
 #include "WasmFaultSignalHandler.h"
 #include "WasmMemory.h"
 #include "WasmModuleParser.h"
+#include "WasmStreamingParser.h"
 #include "WasmValidate.h"
 #include <wtf/DataLog.h>
 #include <wtf/Locker.h>
@@ -62,6 +63,14 @@ Plan::Plan(VM* vm, const uint8_t* source, size_t sourceLength)
 {
 }
 
+Plan::Plan(VM* vm)
+    : m_vm(vm)
+    , m_source(nullptr)
+    , m_sourceLength(0)
+    , m_streamingParser(std::make_unique<StreamingParser>(vm, *this))
+{
+}
+
 bool Plan::parseAndValidateModule(std::optional<Memory::Mode> recompileMode)
 {
     MonotonicTime startTime;
@@ -106,17 +115,8 @@ bool Plan::parseAndValidateModule(std::optional<Memory::Mode> recompileMode)
     return true;
 }
 
-// We are creating a bunch of threads that touch the main thread's stack. This will make ASAN unhappy.
-// The reason this is OK is that we guarantee that the main thread doesn't continue until all threads
-// that could touch its stack are done executing.
-SUPPRESS_ASAN 
-void Plan::run(std::optional<Memory::Mode> recompileMode)
+bool Plan::prepare()
 {
-    if (!parseAndValidateModule(recompileMode))
-        return;
-    if (recompileMode)
-        ASSERT(m_moduleInformation->memory.mode() == recompileMode);
-
     auto tryReserveCapacity = [this] (auto& vector, size_t size, const char* what) {
         if (UNLIKELY(!vector.tryReserveCapacity(size))) {
             StringBuilder builder;
@@ -133,7 +133,7 @@ void Plan::run(std::optional<Memory::Mode> recompileMode)
         || !tryReserveCapacity(m_unlinkedWasmToWasmCalls, m_functionLocationInBinary.size(), " unlinked WebAssembly to WebAssembly calls")
         || !tryReserveCapacity(m_wasmInternalFunctions, m_functionLocationInBinary.size(), " WebAssembly functions")
         || !tryReserveCapacity(m_compilationContexts, m_functionLocationInBinary.size(), " compilation contexts"))
-        return;
+        return false;
 
     m_unlinkedWasmToWasmCalls.resize(m_functionLocationInBinary.size());
     m_wasmInternalFunctions.resize(m_functionLocationInBinary.size());
@@ -150,6 +150,80 @@ void Plan::run(std::optional<Memory::Mode> recompileMode)
         m_wasmExitStubs.uncheckedAppend(exitStubGenerator(m_vm, m_callLinkInfos, signatureIndex, importFunctionIndex));
     }
 
+    m_tierUpState = TierUpState::create(makeRef(*m_moduleInformation), m_functionLocationInBinary.size(), m_moduleSignatureIndicesToUniquedSignatureIndices);
+
+    // With tier-up enabled, every function starts out in a baseline tier that is cheap to compile and
+    // is recompiled with full optimization in the background once it gets hot.
+    m_compilationMode = Options::useWebAssemblyTierUp() ? CompilationMode::BaselineMode : CompilationMode::OptimizedMode;
+
+    if (m_cachedModuleKey && m_compilationMode == CompilationMode::BaselineMode) {
+        CachedModule cachedModule;
+        if (std::optional<CachedModule> fetchedModule = fetchCachedModule(*m_cachedModuleKey)) {
+            if (fetchedModule->functionCount == m_functionLocationInBinary.size())
+                cachedModule = WTFMove(*fetchedModule);
+        }
+        cachedModule.functionCount = m_functionLocationInBinary.size();
+
+        // Functions that got hot the last time around would tier up again soon, so skip straight
+        // to the optimized code. Their counters say they already have.
+        for (unsigned functionIndex : cachedModule.hotFunctions) {
+            m_functionsToOptimize.set(functionIndex);
+            m_tierUpState->tierUpCount(functionIndex).compilationStarted = true;
+        }
+        m_tierUpState->setCachedModule(*m_cachedModuleKey, WTFMove(cachedModule));
+    }
+    return true;
+}
+
+bool Plan::compileFunction(unsigned functionIndex, const uint8_t* functionStart, size_t functionLength, bool needsValidation)
+{
+    SignatureIndex signatureIndex = m_moduleInformation->internalFunctionSignatureIndices[functionIndex];
+    const Signature* signature = SignatureInformation::get(m_vm, signatureIndex);
+    unsigned functionIndexSpace = m_wasmExitStubs.size() + functionIndex;
+    ASSERT_UNUSED(functionIndexSpace, m_moduleInformation->signatureIndexFromFunctionIndexSpace(functionIndexSpace) == signatureIndex);
+
+    auto fail = [&] (const String& error) {
+        auto locker = holdLock(m_lock);
+        if (!m_errorMessage) {
+            // Multiple compiles could fail simultaneously. We arbitrarily choose the first.
+            m_errorMessage = makeString(error, ", in function at index ", String::number(functionIndex)); // FIXME make this an Expected.
+        }
+        return false;
+    };
+
+    if (needsValidation) {
+        auto validationResult = validateFunction(m_vm, functionStart, functionLength, signature, *m_moduleInformation, m_moduleSignatureIndicesToUniquedSignatureIndices);
+        if (!validationResult)
+            return fail(validationResult.error());
+    } else
+        ASSERT(validateFunction(m_vm, functionStart, functionLength, signature, *m_moduleInformation, m_moduleSignatureIndicesToUniquedSignatureIndices));
+
+    CompilationMode compilationMode = m_functionsToOptimize.get(functionIndex) ? CompilationMode::OptimizedMode : m_compilationMode;
+    TierUpState* tierUpState = compilationMode == CompilationMode::BaselineMode ? m_tierUpState.get() : nullptr;
+    m_unlinkedWasmToWasmCalls[functionIndex] = Vector<UnlinkedWasmToWasmCall>();
+    auto parseAndCompileResult = parseAndCompile(*m_vm, m_compilationContexts[functionIndex], functionStart, functionLength, signature, m_unlinkedWasmToWasmCalls[functionIndex], *m_moduleInformation, m_moduleSignatureIndicesToUniquedSignatureIndices, functionIndex, compilationMode, tierUpState);
+    if (UNLIKELY(!parseAndCompileResult))
+        return fail(parseAndCompileResult.error());
+
+    m_wasmInternalFunctions[functionIndex] = WTFMove(*parseAndCompileResult);
+    createJSToWasmWrapper(*m_vm, m_compilationContexts[functionIndex], *m_wasmInternalFunctions[functionIndex], signature, *m_moduleInformation);
+    return true;
+}
+
+// We are creating a bunch of threads that touch the main thread's stack. This will make ASAN unhappy.
+// The reason this is OK is that we guarantee that the main thread doesn't continue until all threads
+// that could touch its stack are done executing.
+SUPPRESS_ASAN 
+void Plan::run(std::optional<Memory::Mode> recompileMode)
+{
+    if (!parseAndValidateModule(recompileMode))
+        return;
+    if (recompileMode)
+        ASSERT(m_moduleInformation->memory.mode() == recompileMode);
+
+    if (!prepare())
+        return;
+
     m_currentIndex = 0;
 
     auto doWork = [this] {
@@ -166,28 +240,11 @@ void Plan::run(std::optional<Memory::Mode> recompileMode)
             const uint8_t* functionStart = m_source + m_functionLocationInBinary[functionIndex].start;
             size_t functionLength = m_functionLocationInBinary[functionIndex].end - m_functionLocationInBinary[functionIndex].start;
             ASSERT(functionLength <= m_sourceLength);
-            SignatureIndex signatureIndex = m_moduleInformation->internalFunctionSignatureIndices[functionIndex];
-            const Signature* signature = SignatureInformation::get(m_vm, signatureIndex);
-            unsigned functionIndexSpace = m_wasmExitStubs.size() + functionIndex;
-            ASSERT_UNUSED(functionIndexSpace, m_moduleInformation->signatureIndexFromFunctionIndexSpace(functionIndexSpace) == signatureIndex);
-            ASSERT(validateFunction(m_vm, functionStart, functionLength, signature, *m_moduleInformation, m_moduleSignatureIndicesToUniquedSignatureIndices));
-
-            m_unlinkedWasmToWasmCalls[functionIndex] = Vector<UnlinkedWasmToWasmCall>();
-            auto parseAndCompileResult = parseAndCompile(*m_vm, m_compilationContexts[functionIndex], functionStart, functionLength, signature, m_unlinkedWasmToWasmCalls[functionIndex], *m_moduleInformation, m_moduleSignatureIndicesToUniquedSignatureIndices);
 
-            if (UNLIKELY(!parseAndCompileResult)) {
+            if (UNLIKELY(!compileFunction(functionIndex, functionStart, functionLength, false))) {
                 auto locker = holdLock(m_lock);
-                if (!m_errorMessage) {
-                    // Multiple compiles could fail simultaneously. We arbitrarily choose the first.
-                    m_errorMessage = makeString(parseAndCompileResult.error(), ", in function at index ", String::number(functionIndex)); // FIXME make this an Expected.
-                }
                 m_currentIndex = m_functionLocationInBinary.size();
-
-                // We will terminate on the next execution.
-                continue; 
             }
-
-            m_wasmInternalFunctions[functionIndex] = WTFMove(*parseAndCompileResult);
         }
     };
 
@@ -207,6 +264,21 @@ void Plan::run(std::optional<Memory::Mode> recompileMode)
     for (uint32_t i = 0; i < numWorkerThreads; i++)
         waitForThreadCompletion(threads[i]);
 
+    complete();
+
+    if (verbose || Options::reportCompileTimes()) {
+        dataLogLn("Took ", (MonotonicTime::now() - startTime).microseconds(),
+            " us to compile and link the module");
+    }
+}
+
+void Plan::complete()
+{
+    if (!m_errorMessage.isNull())
+        return;
+
+    m_tierUpState->setFunctionLocationInBinary(m_functionLocationInBinary);
+
     for (uint32_t functionIndex = 0; functionIndex < m_functionLocationInBinary.size(); functionIndex++) {
         {
             CompilationContext& context = m_compilationContexts[functionIndex];
@@ -216,11 +288,13 @@ void Plan::run(std::optional<Memory::Mode> recompileMode)
                 LinkBuffer linkBuffer(*m_vm, *context.wasmEntrypointJIT, nullptr);
                 m_wasmInternalFunctions[functionIndex]->wasmEntrypoint.compilation =
                     std::make_unique<B3::Compilation>(FINALIZE_CODE(linkBuffer, ("WebAssembly function[%i] %s", functionIndex, signatureDescription.ascii().data())), WTFMove(context.wasmEntrypointByproducts));
+                m_tierUpState->setEntrypoint(functionIndex, m_wasmInternalFunctions[functionIndex]->wasmEntrypoint.compilation->code().executableAddress());
             }
 
             {
                 LinkBuffer linkBuffer(*m_vm, *context.jsEntrypointJIT, nullptr);
                 linkBuffer.link(context.jsEntrypointToWasmEntrypointCall, FunctionPtr(m_wasmInternalFunctions[functionIndex]->wasmEntrypoint.compilation->code().executableAddress()));
+                m_tierUpState->callSitesTo(functionIndex).append(linkBuffer.locationOf(context.jsEntrypointToWasmEntrypointCall));
 
                 m_wasmInternalFunctions[functionIndex]->jsToWasmEntrypoint.compilation =
                     std::make_unique<B3::Compilation>(FINALIZE_CODE(linkBuffer, ("JavaScript->WebAssembly entrypoint[%i] %s", functionIndex, signatureDescription.ascii().data())), WTFMove(context.jsEntrypointByproducts));
@@ -228,11 +302,6 @@ void Plan::run(std::optional<Memory::Mode> recompileMode)
         }
     }
 
-    if (verbose || Options::reportCompileTimes()) {
-        dataLogLn("Took ", (MonotonicTime::now() - startTime).microseconds(),
-            " us to compile and link the module");
-    }
-
     // Patch the call sites for each WebAssembly function.
     for (auto& unlinked : m_unlinkedWasmToWasmCalls) {
         for (auto& call : unlinked) {
@@ -244,7 +313,10 @@ void Plan::run(std::optional<Memory::Mode> recompileMode)
                     : m_wasmExitStubs.at(call.functionIndex).wasmToWasm.code().executableAddress();
             } else {
                 ASSERT(call.target != UnlinkedWasmToWasmCall::Target::ToJs);
-                executableAddress = m_wasmInternalFunctions.at(call.functionIndex - m_wasmExitStubs.size())->wasmEntrypoint.compilation->code().executableAddress();
+                unsigned calleeIndex = call.functionIndex - m_wasmExitStubs.size();
+                executableAddress = *m_tierUpState->entrypointLoadLocation(calleeIndex);
+                // Repatched when the callee tiers up.
+                m_tierUpState->callSitesTo(calleeIndex).append(call.callLocation);
             }
             MacroAssembler::repatchCall(call.callLocation, CodeLocationLabel(executableAddress));
         }
@@ -253,6 +325,136 @@ void Plan::run(std::optional<Memory::Mode> recompileMode)
     m_failed = false;
 }
 
+bool Plan::addBytes(const uint8_t* bytes, size_t length)
+{
+    RELEASE_ASSERT(m_streamingParser);
+    return m_streamingParser->addBytes(bytes, length) != StreamingParser::State::FatalError;
+}
+
+void Plan::willReceiveFunctionData(const ModuleParserResult& result)
+{
+    MonotonicTime startTime;
+    if (verbose || Options::reportCompileTimes())
+        startTime = MonotonicTime::now();
+
+    m_moduleInformation = result.module;
+    m_functionLocationInBinary = result.functionLocationInBinary;
+    m_moduleSignatureIndicesToUniquedSignatureIndices = result.moduleSignatureIndicesToUniquedSignatureIndices;
+    if (!prepare())
+        return;
+    m_streamingPrepared = true;
+
+    if (!m_streamingFunctionBodies.tryReserveCapacity(m_functionLocationInBinary.size())) {
+        m_errorMessage = ASCIILiteral("Failed allocating enough space for WebAssembly function bodies");
+        return;
+    }
+    m_streamingFunctionBodies.resize(m_functionLocationInBinary.size());
+
+    // Function bodies are compiled as they arrive. Without concurrent JIT, they are compiled on the
+    // main thread as it receives them.
+    if (Options::useConcurrentJIT()) {
+        uint32_t numWorkerThreads = WTF::numberOfProcessorCores();
+        m_streamingThreads.reserveCapacity(numWorkerThreads);
+        for (uint32_t i = 0; i < numWorkerThreads; i++)
+            m_streamingThreads.uncheckedAppend(createThread("jsc.wasm-b3-streaming-compilation.thread", [this] { compileStreamedFunctions(); }));
+    }
+
+    if (verbose || Options::reportCompileTimes())
+        dataLogLn("Took ", (MonotonicTime::now() - startTime).microseconds(), " us to prepare for streaming ", m_functionLocationInBinary.size(), " functions");
+}
+
+void Plan::didReceiveFunctionData(unsigned functionIndex, const uint8_t* functionStart, size_t functionLength)
+{
+    if (!m_streamingPrepared)
+        return;
+
+    if (m_streamingThreads.isEmpty()) {
+        if (m_errorMessage.isNull())
+            compileFunction(functionIndex, functionStart, functionLength, true);
+        return;
+    }
+
+    // The parser's buffer moves as more bytes arrive, so the compiling thread gets its own copy.
+    m_streamingFunctionBodies[functionIndex].append(functionStart, functionLength);
+
+    auto locker = holdLock(m_lock);
+    m_streamedFunctions.append(functionIndex);
+    m_streamedFunctionsCondition.notifyOne();
+}
+
+void Plan::compileStreamedFunctions()
+{
+    while (true) {
+        unsigned functionIndex;
+        {
+            auto locker = holdLock(m_lock);
+            while (m_streamedFunctions.isEmpty() && !m_receivedAllStreamedFunctions)
+                m_streamedFunctionsCondition.wait(m_lock);
+            if (m_streamedFunctions.isEmpty())
+                return;
+            functionIndex = m_streamedFunctions.takeFirst();
+            if (!m_errorMessage.isNull())
+                continue;
+        }
+
+        Vector<uint8_t> functionBody = WTFMove(m_streamingFunctionBodies[functionIndex]);
+        compileFunction(functionIndex, functionBody.data(), functionBody.size(), true);
+    }
+}
+
+void Plan::stopStreamingThreads()
+{
+    {
+        auto locker = holdLock(m_lock);
+        m_receivedAllStreamedFunctions = true;
+        m_streamedFunctionsCondition.notifyAll();
+    }
+    for (ThreadIdentifier thread : m_streamingThreads)
+        waitForThreadCompletion(thread);
+    m_streamingThreads.clear();
+}
+
+void Plan::finishStreaming()
+{
+    RELEASE_ASSERT(m_streamingParser);
+
+    MonotonicTime startTime;
+    if (verbose || Options::reportCompileTimes())
+        startTime = MonotonicTime::now();
+
+    StreamingParser::State state = m_streamingParser->finalize();
+    stopStreamingThreads();
+
+    if (state == StreamingParser::State::FatalError) {
+        m_errorMessage = m_streamingParser->errorMessage();
+        return;
+    }
+    if (!m_errorMessage.isNull())
+        return;
+
+    ModuleParserResult& result = m_streamingParser->result();
+    if (!m_streamingPrepared) {
+        // There was no Code section.
+        m_moduleInformation = result.module;
+        m_moduleSignatureIndicesToUniquedSignatureIndices = result.moduleSignatureIndicesToUniquedSignatureIndices;
+        if (!result.functionLocationInBinary.isEmpty()) {
+            m_errorMessage = makeString("WebAssembly.Module declares ", String::number(result.functionLocationInBinary.size()), " functions but has no Code section");
+            return;
+        }
+        if (!prepare())
+            return;
+    }
+
+    m_functionLocationInBinary = result.functionLocationInBinary;
+    m_source = m_streamingParser->source().data();
+    m_sourceLength = m_streamingParser->source().size();
+
+    complete();
+
+    if (verbose || Options::reportCompileTimes())
+        dataLogLn("Took ", (MonotonicTime::now() - startTime).microseconds(), " us to finish compiling and link the streamed module");
+}
+
 void Plan::initializeCallees(JSGlobalObject* globalObject, std::function<void(unsigned, JSWebAssemblyCallee*, JSWebAssemblyCallee*)> callback)
 {
     ASSERT(!failed());
@@ -269,7 +471,12 @@ void Plan::initializeCallees(JSGlobalObject* globalObject, std::function<void(un
     }
 }
 
-Plan::~Plan() { }
+Plan::~Plan()
+{
+    // A streaming compile can be abandoned before all of the module arrives.
+    if (!m_streamingThreads.isEmpty())
+        stopStreamingThreads();
+}
 
 } } // namespace JSC::Wasm
 
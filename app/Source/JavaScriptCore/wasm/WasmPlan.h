@@ -30,8 +30,14 @@
 #include "CompilationResult.h"
 #include "VM.h"
 #include "WasmB3IRGenerator.h"
+#include "WasmCachedModule.h"
 #include "WasmFormat.h"
+#include "WasmStreamingParser.h"
+#include "WasmTierUpState.h"
 #include <wtf/Bag.h>
+#include <wtf/BitVector.h>
+#include <wtf/Condition.h>
+#include <wtf/Deque.h>
 #include <wtf/ThreadSafeRefCounted.h>
 #include <wtf/Vector.h>
 
@@ -43,16 +49,32 @@ class JSWebAssemblyCallee;
 
 namespace Wasm {
 
-class Plan {
+class Plan : public StreamingParserClient {
 public:
     JS_EXPORT_PRIVATE Plan(VM*, Vector<uint8_t>);
     JS_EXPORT_PRIVATE Plan(VM*, const uint8_t*, size_t);
+    // Creates a plan for a module whose bytes are handed to addBytes() as they arrive. Function
+    // bodies are compiled while the rest of the module is still arriving.
+    JS_EXPORT_PRIVATE explicit Plan(VM*);
     JS_EXPORT_PRIVATE ~Plan();
 
     bool parseAndValidateModule(std::optional<Memory::Mode> = std::nullopt);
 
+    // Compiles the functions that got hot the last time these bytes were compiled with full
+    // optimization from the start, and keeps the cache entry up to date as more of them tier up.
+    // Must be called before run().
+    void setCachedModuleKey(const CachedModuleKey& key) { m_cachedModuleKey = key; }
+    const std::optional<CachedModuleKey>& cachedModuleKey() const { return m_cachedModuleKey; }
+
     JS_EXPORT_PRIVATE void run(std::optional<Memory::Mode> = std::nullopt);
 
+    // Returns false once the bytes so far are known not to be a valid module. The plan still needs to
+    // be finished to find out why.
+    JS_EXPORT_PRIVATE bool addBytes(const uint8_t*, size_t);
+    // Called once all of the module's bytes have been added. Waits for the remaining compiles, then
+    // links the module as run() does.
+    JS_EXPORT_PRIVATE void finishStreaming();
+
     JS_EXPORT_PRIVATE void initializeCallees(JSGlobalObject*, std::function<void(unsigned, JSWebAssemblyCallee*, JSWebAssemblyCallee*)>);
 
     bool WARN_UNUSED_RETURN failed() const { return m_failed; }
@@ -74,10 +96,16 @@ public:
         return m_wasmInternalFunctions.size();
     }
 
-    std::unique_ptr<ModuleInformation>&& takeModuleInformation()
+    Ref<ModuleInformation> takeModuleInformation()
+    {
+        RELEASE_ASSERT(!failed());
+        return m_moduleInformation.releaseNonNull();
+    }
+
+    Ref<TierUpState> takeTierUpState()
     {
         RELEASE_ASSERT(!failed());
-        return WTFMove(m_moduleInformation);
+        return m_tierUpState.releaseNonNull();
     }
 
     Bag<CallLinkInfo>&& takeCallLinkInfos()
@@ -94,8 +122,21 @@ public:
 
     Memory::Mode mode() const { return m_moduleInformation->memory.mode(); }
 
+    const uint8_t* source() const { return m_source; }
+    size_t sourceLength() const { return m_sourceLength; }
+
 private:
-    std::unique_ptr<ModuleInformation> m_moduleInformation;
+    bool prepare();
+    bool compileFunction(unsigned functionIndex, const uint8_t* functionStart, size_t functionLength, bool needsValidation);
+    void complete();
+
+    void willReceiveFunctionData(const ModuleParserResult&) override;
+    void didReceiveFunctionData(unsigned functionIndex, const uint8_t* functionStart, size_t functionLength) override;
+    void compileStreamedFunctions();
+    void stopStreamingThreads();
+
+    RefPtr<ModuleInformation> m_moduleInformation;
+    RefPtr<TierUpState> m_tierUpState;
     Vector<FunctionLocationInBinary> m_functionLocationInBinary;
     Vector<SignatureIndex> m_moduleSignatureIndicesToUniquedSignatureIndices;
     Bag<CallLinkInfo> m_callLinkInfos;
@@ -106,11 +147,23 @@ private:
     VM* m_vm;
     Vector<Vector<UnlinkedWasmToWasmCall>> m_unlinkedWasmToWasmCalls;
     const uint8_t* m_source;
-    const size_t m_sourceLength;
+    size_t m_sourceLength;
+    CompilationMode m_compilationMode { CompilationMode::OptimizedMode };
     bool m_failed { true };
     String m_errorMessage;
     uint32_t m_currentIndex;
     Lock m_lock;
+
+    std::optional<CachedModuleKey> m_cachedModuleKey;
+    BitVector m_functionsToOptimize;
+
+    std::unique_ptr<StreamingParser> m_streamingParser;
+    bool m_streamingPrepared { false };
+    Vector<ThreadIdentifier> m_streamingThreads;
+    Vector<Vector<uint8_t>> m_streamingFunctionBodies;
+    Deque<unsigned> m_streamedFunctions;
+    Condition m_streamedFunctionsCondition;
+    bool m_receivedAllStreamedFunctions { false };
 };
 
 } } // namespace JSC::Wasm
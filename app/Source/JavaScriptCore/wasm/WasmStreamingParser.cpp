@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WasmStreamingParser.h"
+
+#if ENABLE(WEBASSEMBLY)
+
+#include <wtf/LEBDecoder.h>
+#include <wtf/text/StringConcatenate.h>
+
+namespace JSC { namespace Wasm {
+
+// An unsigned 32-bit LEB number takes at most this many bytes.
+static const size_t maxVarUInt32Length = 5;
+
+StreamingParser::StreamingParser(VM* vm, StreamingParserClient& client)
+    : m_moduleParser(vm, nullptr, 0, std::nullopt)
+    , m_client(client)
+{
+}
+
+auto StreamingParser::fail(const String& message) -> Progress
+{
+    m_state = State::FatalError;
+    m_errorMessage = makeString(ASCIILiteral("WebAssembly.Module doesn't parse at byte "), String::number(m_offset), ASCIILiteral(": "), message);
+    return Progress::Failed;
+}
+
+auto StreamingParser::parseVarUInt32(uint32_t& result, const char* what) -> Progress
+{
+    size_t offset = m_offset;
+    if (WTF::LEBDecoder::decodeUInt32(m_source.data(), m_source.size(), offset, result)) {
+        m_offset = offset;
+        return Progress::Advanced;
+    }
+    // A number cut short by the end of the bytes we have so far may still be completed by the next chunk.
+    if (available() < maxVarUInt32Length)
+        return Progress::NeedMoreBytes;
+    return fail(makeString(ASCIILiteral("can't get "), what));
+}
+
+auto StreamingParser::parseModuleHeader() -> Progress
+{
+    if (available() < ModuleParser::headerSize)
+        return Progress::NeedMoreBytes;
+
+    m_moduleParser.m_offset = m_offset;
+    auto result = m_moduleParser.parseHeader();
+    if (!result) {
+        m_state = State::FatalError;
+        m_errorMessage = result.error();
+        return Progress::Failed;
+    }
+    m_offset = m_moduleParser.m_offset;
+    m_state = State::SectionID;
+    return Progress::Advanced;
+}
+
+auto StreamingParser::parseSectionID() -> Progress
+{
+    if (!available())
+        return Progress::NeedMoreBytes;
+
+    uint8_t sectionByte = m_source[m_offset];
+    if (sectionByte & 0x80)
+        return fail(ASCIILiteral("can't get section byte"));
+    ++m_offset;
+
+    Section section = Section::Custom;
+    if (sectionByte && isValidSection(sectionByte))
+        section = static_cast<Section>(sectionByte);
+    if (!validateOrder(m_previousSection, section))
+        return fail(makeString(ASCIILiteral("invalid section order, "), makeString(m_previousSection), ASCIILiteral(" followed by "), makeString(section)));
+
+    m_section = section;
+    m_state = State::SectionSize;
+    return Progress::Advanced;
+}
+
+auto StreamingParser::parseSectionSize() -> Progress
+{
+    Progress progress = parseVarUInt32(m_sectionLength, "section's length");
+    if (progress != Progress::Advanced)
+        return progress;
+
+    m_sectionEnd = m_offset + m_sectionLength;
+    m_state = m_section == Section::Code ? State::CodeSectionCount : State::SectionPayload;
+    return Progress::Advanced;
+}
+
+auto StreamingParser::parseSectionPayload() -> Progress
+{
+    if (available() < m_sectionLength)
+        return Progress::NeedMoreBytes;
+
+    m_moduleParser.m_offset = m_offset;
+    auto result = m_moduleParser.parseSection(m_section, m_sectionLength);
+    if (!result) {
+        m_state = State::FatalError;
+        m_errorMessage = result.error();
+        return Progress::Failed;
+    }
+    ASSERT(m_moduleParser.m_offset == m_sectionEnd);
+    m_offset = m_sectionEnd;
+    m_previousSection = m_section;
+    m_state = State::SectionID;
+    return Progress::Advanced;
+}
+
+auto StreamingParser::parseCodeSectionCount() -> Progress
+{
+    Progress progress = parseVarUInt32(m_functionCount, "Code section's count");
+    if (progress != Progress::Advanced)
+        return progress;
+
+    size_t declaredFunctionCount = m_moduleParser.m_result.functionLocationInBinary.size();
+    if (m_functionCount != declaredFunctionCount)
+        return fail(makeString(ASCIILiteral("Code section count "), String::number(m_functionCount), ASCIILiteral(" doesn't match the declared number of functions "), String::number(declaredFunctionCount)));
+
+    m_functionIndex = 0;
+    m_client.willReceiveFunctionData(m_moduleParser.m_result);
+
+    if (!m_functionCount) {
+        if (m_offset != m_sectionEnd)
+            return fail(ASCIILiteral("parsing ended before the end of Code section"));
+        m_previousSection = Section::Code;
+        m_state = State::SectionID;
+        return Progress::Advanced;
+    }
+    m_state = State::FunctionSize;
+    return Progress::Advanced;
+}
+
+auto StreamingParser::parseFunctionSize() -> Progress
+{
+    Progress progress = parseVarUInt32(m_functionSize, "Code function's size");
+    if (progress != Progress::Advanced)
+        return progress;
+
+    if (m_offset > m_sectionEnd || m_functionSize > m_sectionEnd - m_offset)
+        return fail(makeString(ASCIILiteral("Code function's size "), String::number(m_functionSize), ASCIILiteral(" exceeds the Code section's remaining size")));
+    m_state = State::FunctionPayload;
+    return Progress::Advanced;
+}
+
+auto StreamingParser::parseFunctionPayload() -> Progress
+{
+    if (available() < m_functionSize)
+        return Progress::NeedMoreBytes;
+
+    FunctionLocationInBinary& location = m_moduleParser.m_result.functionLocationInBinary[m_functionIndex];
+    location.start = m_offset;
+    location.end = m_offset + m_functionSize;
+    m_client.didReceiveFunctionData(m_functionIndex, m_source.data() + m_offset, m_functionSize);
+    m_offset = location.end;
+
+    if (++m_functionIndex < m_functionCount) {
+        m_state = State::FunctionSize;
+        return Progress::Advanced;
+    }
+
+    if (m_offset != m_sectionEnd)
+        return fail(ASCIILiteral("parsing ended before the end of Code section"));
+    m_previousSection = Section::Code;
+    m_state = State::SectionID;
+    return Progress::Advanced;
+}
+
+auto StreamingParser::addBytes(const uint8_t* bytes, size_t length) -> State
+{
+    if (m_state == State::FatalError)
+        return m_state;
+    RELEASE_ASSERT(m_state != State::Finished);
+
+    m_source.append(bytes, length);
+    m_moduleParser.setSource(m_source.data(), m_source.size());
+
+    while (true) {
+        Progress progress = Progress::Failed;
+        switch (m_state) {
+        case State::ModuleHeader:
+            progress = parseModuleHeader();
+            break;
+        case State::SectionID:
+            progress = parseSectionID();
+            break;
+        case State::SectionSize:
+            progress = parseSectionSize();
+            break;
+        case State::SectionPayload:
+            progress = parseSectionPayload();
+            break;
+        case State::CodeSectionCount:
+            progress = parseCodeSectionCount();
+            break;
+        case State::FunctionSize:
+            progress = parseFunctionSize();
+            break;
+        case State::FunctionPayload:
+            progress = parseFunctionPayload();
+            break;
+        case State::Finished:
+        case State::FatalError:
+            RELEASE_ASSERT_NOT_REACHED();
+            break;
+        }
+        if (progress != Progress::Advanced)
+            return m_state;
+    }
+}
+
+auto StreamingParser::finalize() -> State
+{
+    switch (m_state) {
+    case State::FatalError:
+        break;
+    case State::ModuleHeader:
+        fail(makeString(ASCIILiteral("expected a module of at least "), String::number(ModuleParser::headerSize), ASCIILiteral(" bytes")));
+        break;
+    case State::SectionID:
+        ASSERT(!available());
+        m_state = State::Finished;
+        break;
+    case State::SectionSize:
+    case State::SectionPayload:
+        fail(makeString(ASCIILiteral("module ends in the middle of its "), makeString(m_section), ASCIILiteral(" section")));
+        break;
+    case State::CodeSectionCount:
+    case State::FunctionSize:
+    case State::FunctionPayload:
+        fail(makeString(ASCIILiteral("module ends in the middle of its Code section, at function "), String::number(m_functionIndex)));
+        break;
+    case State::Finished:
+        RELEASE_ASSERT_NOT_REACHED();
+        break;
+    }
+    return m_state;
+}
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "WasmModuleParser.h"
+#include "WasmSections.h"
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace JSC { namespace Wasm {
+
+class StreamingParserClient {
+public:
+    virtual ~StreamingParserClient() { }
+
+    // Called once every section that precedes the function bodies has been parsed, just before the
+    // first function body is handed out. The module's signatures, imports, tables, memory and
+    // globals are all known by then, but function locations and the sections after Code are not.
+    virtual void willReceiveFunctionData(const ModuleParserResult&) = 0;
+
+    // The bytes are only valid for the duration of the call.
+    virtual void didReceiveFunctionData(unsigned functionIndex, const uint8_t* functionStart, size_t functionLength) = 0;
+};
+
+// Parses a module whose bytes arrive in chunks, such as while it is being downloaded. Sections are
+// parsed as soon as all of their bytes have arrived, and function bodies are handed to the client
+// one at a time while the Code section is still arriving, so that they can be compiled right away.
+class StreamingParser {
+public:
+    enum class State : uint8_t {
+        ModuleHeader,
+        SectionID,
+        SectionSize,
+        SectionPayload,
+        CodeSectionCount,
+        FunctionSize,
+        FunctionPayload,
+        Finished,
+        FatalError,
+    };
+
+    StreamingParser(VM*, StreamingParserClient&);
+
+    State addBytes(const uint8_t*, size_t);
+    // Called once all of the module's bytes have been added.
+    State finalize();
+
+    State state() const { return m_state; }
+    const String& errorMessage() const
+    {
+        RELEASE_ASSERT(m_state == State::FatalError);
+        return m_errorMessage;
+    }
+
+    // The module's bytes so far. This grows, and may move, as bytes are added.
+    const Vector<uint8_t>& source() const { return m_source; }
+
+    ModuleParserResult& result()
+    {
+        RELEASE_ASSERT(m_state == State::Finished);
+        return m_moduleParser.m_result;
+    }
+
+private:
+    enum class Progress : uint8_t { Advanced, NeedMoreBytes, Failed };
+
+    Progress parseModuleHeader();
+    Progress parseSectionID();
+    Progress parseSectionSize();
+    Progress parseSectionPayload();
+    Progress parseCodeSectionCount();
+    Progress parseFunctionSize();
+    Progress parseFunctionPayload();
+
+    Progress parseVarUInt32(uint32_t&, const char* what);
+    Progress fail(const String&);
+
+    size_t available() const { return m_source.size() - m_offset; }
+
+    Vector<uint8_t> m_source;
+    ModuleParser m_moduleParser;
+    StreamingParserClient& m_client;
+    size_t m_offset { 0 };
+
+    State m_state { State::ModuleHeader };
+    Section m_section { Section::Custom };
+    Section m_previousSection { Section::Custom };
+    uint32_t m_sectionLength { 0 };
+    size_t m_sectionEnd { 0 };
+
+    uint32_t m_functionCount { 0 };
+    uint32_t m_functionIndex { 0 };
+    uint32_t m_functionSize { 0 };
+
+    String m_errorMessage;
+};
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WasmTierUpPlan.h"
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "B3Compilation.h"
+#include "JSCInlines.h"
+#include "JSWebAssemblyCallee.h"
+#include "JSWebAssemblyCodeBlock.h"
+#include "LinkBuffer.h"
+#include "WasmTierUpState.h"
+#include <wtf/Condition.h>
+#include <wtf/DataLog.h>
+#include <wtf/HashSet.h>
+#include <wtf/Lock.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/WorkQueue.h>
+
+namespace JSC { namespace Wasm {
+
+static const bool verbose = false;
+
+static WorkQueue& tierUpQueue()
+{
+    static NeverDestroyed<Ref<WorkQueue>> queue(WorkQueue::create("jsc.wasm-tier-up.queue"));
+    return queue.get();
+}
+
+// The plans that are queued or compiling, for all VMs.
+static StaticLock activePlansLock;
+static StaticCondition activePlansCondition;
+
+static HashSet<TierUpPlan*>& activePlans()
+{
+    static NeverDestroyed<HashSet<TierUpPlan*>> plans;
+    return plans;
+}
+
+TierUpPlan::TierUpPlan(VM& vm, Ref<TierUpState>&& tierUpState, unsigned functionIndex, Vector<uint8_t>&& functionBody)
+    : m_vm(vm)
+    , m_tierUpState(WTFMove(tierUpState))
+    , m_functionIndex(functionIndex)
+    , m_functionBody(WTFMove(functionBody))
+{
+}
+
+void TierUpPlan::start()
+{
+    {
+        auto locker = holdLock(activePlansLock);
+        activePlans().add(this);
+    }
+
+    tierUpQueue().dispatch([protectedThis = makeRef(*this)] {
+        {
+            auto locker = holdLock(activePlansLock);
+            if (protectedThis->m_state == State::Cancelled)
+                return;
+            ASSERT(protectedThis->m_state == State::Queued);
+            protectedThis->m_state = State::Compiling;
+        }
+
+        protectedThis->compile();
+
+        auto locker = holdLock(activePlansLock);
+        protectedThis->m_state = State::Done;
+        activePlans().remove(protectedThis.ptr());
+        activePlansCondition.notifyAll();
+    });
+}
+
+void TierUpPlan::cancelAndWaitForPlansForVM(VM& vm)
+{
+    auto locker = holdLock(activePlansLock);
+
+    // Plans that have not started never touch the VM. The queue still holds a reference to them,
+    // and drops it without compiling.
+    Vector<TierUpPlan*> cancelledPlans;
+    for (TierUpPlan* plan : activePlans()) {
+        if (&plan->m_vm == &vm && plan->m_state == State::Queued) {
+            plan->m_state = State::Cancelled;
+            cancelledPlans.append(plan);
+        }
+    }
+    for (TierUpPlan* plan : cancelledPlans)
+        activePlans().remove(plan);
+
+    activePlansCondition.wait(activePlansLock, [&] {
+        for (TierUpPlan* plan : activePlans()) {
+            if (&plan->m_vm == &vm)
+                return false;
+        }
+        return true;
+    });
+}
+
+void TierUpPlan::compile()
+{
+    MonotonicTime startTime;
+    if (verbose || Options::reportCompileTimes())
+        startTime = MonotonicTime::now();
+
+    const ModuleInformation& moduleInformation = m_tierUpState->moduleInformation();
+    SignatureIndex signatureIndex = moduleInformation.internalFunctionSignatureIndices[m_functionIndex];
+    const Signature* signature = SignatureInformation::get(&m_vm, signatureIndex);
+
+    auto parseAndCompileResult = parseAndCompile(m_vm, m_compilationContext, m_functionBody.data(), m_functionBody.size(), signature, m_unlinkedWasmToWasmCalls, moduleInformation, m_tierUpState->moduleSignatureIndicesToUniquedSignatureIndices(), m_functionIndex, CompilationMode::OptimizedMode);
+
+    // The module was validated before its baseline code was generated, so this can only fail if
+    // we run out of memory. The baseline code just keeps running if it does.
+    if (parseAndCompileResult) {
+        std::unique_ptr<WasmInternalFunction> function = WTFMove(*parseAndCompileResult);
+        LinkBuffer linkBuffer(m_vm, *m_compilationContext.wasmEntrypointJIT, nullptr, JITCompilationCanFail);
+        if (!linkBuffer.didFailToAllocate()) {
+            String signatureDescription = signature->toString();
+            function->wasmEntrypoint.compilation = std::make_unique<B3::Compilation>(
+                FINALIZE_CODE(linkBuffer, ("Optimized WebAssembly function[%i] %s", m_functionIndex, signatureDescription.ascii().data())),
+                WTFMove(m_compilationContext.wasmEntrypointByproducts));
+            m_function = WTFMove(function);
+        }
+    }
+
+    if (verbose || Options::reportCompileTimes())
+        dataLogLn("Took ", (MonotonicTime::now() - startTime).microseconds(), " us to tier up WebAssembly function ", m_functionIndex);
+
+    m_tierUpState->didCompile(*this);
+}
+
+void TierUpPlan::install(VM& vm, JSWebAssemblyCodeBlock* codeBlock)
+{
+    ASSERT(codeBlock);
+    if (!m_function)
+        return;
+
+    TierUpState& tierUpState = m_tierUpState.get();
+
+    unsigned functionImportCount = codeBlock->functionImportCount();
+    for (auto& call : m_unlinkedWasmToWasmCalls) {
+        if (call.functionIndex < functionImportCount) {
+            const WasmExitStubs& exitStubs = codeBlock->wasmExitStubs(call.functionIndex);
+            void* executableAddress = call.target == UnlinkedWasmToWasmCall::Target::ToJs
+                ? exitStubs.wasmToJs.code().executableAddress()
+                : exitStubs.wasmToWasm.code().executableAddress();
+            MacroAssembler::repatchCall(call.callLocation, CodeLocationLabel(executableAddress));
+            continue;
+        }
+
+        unsigned calleeIndex = call.functionIndex - functionImportCount;
+        MacroAssembler::repatchCall(call.callLocation, CodeLocationLabel(*tierUpState.entrypointLoadLocation(calleeIndex)));
+        tierUpState.callSitesTo(calleeIndex).append(call.callLocation);
+    }
+
+    JSWebAssemblyCallee* callee = JSWebAssemblyCallee::create(vm, WTFMove(m_function->wasmEntrypoint));
+    MacroAssembler::repatchPointer(m_function->wasmCalleeMoveLocation, callee);
+    codeBlock->setOptimizedWasmEntrypointCallee(vm, m_functionIndex, callee);
+
+    void* entrypoint = callee->entrypoint();
+    for (CodeLocationCall callSite : tierUpState.callSitesTo(m_functionIndex))
+        MacroAssembler::repatchCall(callSite, CodeLocationLabel(entrypoint));
+    tierUpState.setEntrypoint(m_functionIndex, entrypoint);
+}
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
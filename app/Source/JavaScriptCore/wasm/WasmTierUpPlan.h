@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "WasmB3IRGenerator.h"
+#include "WasmFormat.h"
+#include <wtf/ThreadSafeRefCounted.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class JSWebAssemblyCodeBlock;
+class VM;
+
+namespace Wasm {
+
+class TierUpState;
+
+// Recompiles one function of a code block with full optimization. The compile runs on a
+// background thread; the result is installed on the main thread the next time the function's
+// baseline code asks to tier up.
+//
+// Plans refer to their VM, so the VM cancels the ones that have not started and waits for the
+// ones that are compiling before it is destroyed.
+class TierUpPlan : public ThreadSafeRefCounted<TierUpPlan> {
+public:
+    static Ref<TierUpPlan> create(VM& vm, Ref<TierUpState>&& tierUpState, unsigned functionIndex, Vector<uint8_t>&& functionBody)
+    {
+        return adoptRef(*new TierUpPlan(vm, WTFMove(tierUpState), functionIndex, WTFMove(functionBody)));
+    }
+
+    unsigned functionIndex() const { return m_functionIndex; }
+
+    // Puts the plan on the tier-up queue.
+    void start();
+
+    // Called by the VM as it is destroyed.
+    static void cancelAndWaitForPlansForVM(VM&);
+
+    void install(VM&, JSWebAssemblyCodeBlock*);
+
+private:
+    TierUpPlan(VM&, Ref<TierUpState>&&, unsigned functionIndex, Vector<uint8_t>&& functionBody);
+
+    void compile();
+
+    enum class State : uint8_t {
+        Queued,
+        Compiling,
+        Done,
+        Cancelled
+    };
+
+    VM& m_vm;
+    // Guarded by the lock in WasmTierUpPlan.cpp.
+    State m_state { State::Queued };
+    Ref<TierUpState> m_tierUpState;
+    unsigned m_functionIndex;
+    Vector<uint8_t> m_functionBody;
+
+    CompilationContext m_compilationContext;
+    std::unique_ptr<WasmInternalFunction> m_function;
+    Vector<UnlinkedWasmToWasmCall> m_unlinkedWasmToWasmCalls;
+};
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
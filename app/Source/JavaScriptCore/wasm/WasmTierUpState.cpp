@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WasmTierUpState.h"
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "JSCInlines.h"
+#include "JSWebAssemblyCodeBlock.h"
+#include "JSWebAssemblyModule.h"
+#include "WasmTierUpPlan.h"
+#include <wtf/DataLog.h>
+#include <wtf/Locker.h>
+
+namespace JSC { namespace Wasm {
+
+static const bool verbose = false;
+
+TierUpState::TierUpState(Ref<ModuleInformation>&& moduleInformation, unsigned functionCount, const Vector<SignatureIndex>& moduleSignatureIndicesToUniquedSignatureIndices)
+    : m_moduleInformation(WTFMove(moduleInformation))
+    , m_moduleSignatureIndicesToUniquedSignatureIndices(moduleSignatureIndicesToUniquedSignatureIndices)
+{
+    m_entrypoints.resize(functionCount);
+    m_entrypoints.fill(nullptr);
+    m_tierUpCounts.resize(functionCount);
+    for (TierUpCount& tierUpCount : m_tierUpCounts)
+        tierUpCount.count = Options::webAssemblyTierUpThreshold();
+    m_callSitesTo.resize(functionCount);
+}
+
+TierUpState::~TierUpState() { }
+
+void TierUpState::setCodeBlock(JSWebAssemblyCodeBlock* codeBlock)
+{
+    Vector<RefPtr<TierUpPlan>> compiledPlans;
+    {
+        auto locker = holdLock(m_lock);
+        m_codeBlock = codeBlock;
+        if (!codeBlock)
+            compiledPlans = WTFMove(m_compiledPlans);
+    }
+}
+
+void TierUpState::triggerTierUp(VM& vm, unsigned functionIndex)
+{
+    TierUpCount& tierUpCount = m_tierUpCounts[functionIndex];
+
+    JSWebAssemblyCodeBlock* codeBlock;
+    RefPtr<TierUpPlan> compiledPlan;
+    {
+        auto locker = holdLock(m_lock);
+        codeBlock = m_codeBlock;
+        for (size_t i = 0; i < m_compiledPlans.size(); ++i) {
+            if (m_compiledPlans[i]->functionIndex() == functionIndex) {
+                compiledPlan = WTFMove(m_compiledPlans[i]);
+                m_compiledPlans.remove(i);
+                break;
+            }
+        }
+    }
+
+    if (compiledPlan) {
+        if (verbose)
+            dataLogLn("Installing optimized code for WebAssembly function ", functionIndex);
+        compiledPlan->install(vm, codeBlock);
+        // Frames already running the baseline code keep running it, but there is nothing
+        // more for them to do here.
+        tierUpCount.count = std::numeric_limits<int32_t>::max();
+        return;
+    }
+
+    if (!codeBlock) {
+        // Code compiled without a code block, such as by jsc's testWasmModule, has nowhere
+        // to install optimized code.
+        tierUpCount.count = std::numeric_limits<int32_t>::max();
+        return;
+    }
+
+    if (!tierUpCount.compilationStarted) {
+        tierUpCount.compilationStarted = true;
+        if (verbose)
+            dataLogLn("Starting to tier up WebAssembly function ", functionIndex);
+
+        const FunctionLocationInBinary& location = m_functionLocationInBinary[functionIndex];
+        Vector<uint8_t> functionBody;
+        functionBody.append(codeBlock->module()->source() + location.start, location.end - location.start);
+        TierUpPlan::create(vm, makeRef(*this), functionIndex, WTFMove(functionBody))->start();
+    }
+
+    // Check back in a while to see whether the compile has finished.
+    tierUpCount.count = Options::webAssemblyTierUpThreshold();
+}
+
+void TierUpState::didCompile(Ref<TierUpPlan>&& plan)
+{
+    std::optional<CachedModule> cachedModule;
+    {
+        auto locker = holdLock(m_lock);
+        if (m_cachedModuleKey) {
+            m_cachedModule.hotFunctions.append(plan->functionIndex());
+            cachedModule = m_cachedModule;
+        }
+        if (m_codeBlock)
+            m_compiledPlans.append(WTFMove(plan));
+    }
+
+    // We are on the tier-up queue, so writing the file does not hold up the main thread.
+    if (cachedModule)
+        storeCachedModule(*m_cachedModuleKey, *cachedModule);
+}
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
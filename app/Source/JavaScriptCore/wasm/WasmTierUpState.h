@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if ENABLE(WEBASSEMBLY)
+
+#include "CodeLocation.h"
+#include "WasmCachedModule.h"
+#include "WasmFormat.h"
+#include <wtf/Lock.h>
+#include <wtf/ThreadSafeRefCounted.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class JSWebAssemblyCodeBlock;
+class VM;
+
+namespace Wasm {
+
+class TierUpPlan;
+
+// Counts down as the baseline code of a function runs. When it drops below zero, the
+// function is recompiled with full optimization in the background.
+struct TierUpCount {
+    static const int32_t functionEntryDecrement = 15;
+    static const int32_t loopDecrement = 1;
+
+    int32_t count { 0 };
+    bool compilationStarted { false };
+};
+
+// The parts of a JSWebAssemblyCodeBlock that its generated code and background compiles refer
+// to directly. It is reference counted so that a compile still running when the code block dies
+// does not touch freed memory.
+//
+// Each internal function has an entrypoint load location, holding the address of its current
+// wasm entrypoint. Tables and exported functions call through it, so they pick up optimized code
+// as soon as it is installed. Direct calls are repatched instead, so we remember where they are.
+class TierUpState : public ThreadSafeRefCounted<TierUpState> {
+public:
+    static Ref<TierUpState> create(Ref<ModuleInformation>&& moduleInformation, unsigned functionCount, const Vector<SignatureIndex>& moduleSignatureIndicesToUniquedSignatureIndices)
+    {
+        return adoptRef(*new TierUpState(WTFMove(moduleInformation), functionCount, moduleSignatureIndicesToUniquedSignatureIndices));
+    }
+
+    ~TierUpState();
+
+    const ModuleInformation& moduleInformation() const { return m_moduleInformation.get(); }
+    const Vector<SignatureIndex>& moduleSignatureIndicesToUniquedSignatureIndices() const { return m_moduleSignatureIndicesToUniquedSignatureIndices; }
+    unsigned functionCount() const { return m_tierUpCounts.size(); }
+
+    // A streaming compile only knows where the function bodies are once all of them have arrived.
+    // This must be set before any of the module's code runs.
+    void setFunctionLocationInBinary(const Vector<FunctionLocationInBinary>& functionLocationInBinary)
+    {
+        ASSERT(functionLocationInBinary.size() == functionCount());
+        m_functionLocationInBinary = functionLocationInBinary;
+    }
+
+    void** entrypointLoadLocation(unsigned functionIndex) { return &m_entrypoints[functionIndex]; }
+    void setEntrypoint(unsigned functionIndex, void* entrypoint) { m_entrypoints[functionIndex] = entrypoint; }
+
+    TierUpCount& tierUpCount(unsigned functionIndex) { return m_tierUpCounts[functionIndex]; }
+
+    // Only used on the main thread.
+    Vector<CodeLocationCall>& callSitesTo(unsigned functionIndex) { return m_callSitesTo[functionIndex]; }
+
+    // The code block installs optimized code. It detaches itself when it is destroyed, after
+    // which compiles that finish are thrown away.
+    void setCodeBlock(JSWebAssemblyCodeBlock*);
+
+    // Rewrites the module's cache entry whenever another of its functions tiers up. Must be set
+    // before any of the module's code runs.
+    void setCachedModule(const CachedModuleKey& key, CachedModule&& cachedModule)
+    {
+        m_cachedModuleKey = key;
+        m_cachedModule = WTFMove(cachedModule);
+    }
+
+    // Called by baseline code when a function's count runs out.
+    void triggerTierUp(VM&, unsigned functionIndex);
+
+    // Called on the compiling thread.
+    void didCompile(Ref<TierUpPlan>&&);
+
+private:
+    TierUpState(Ref<ModuleInformation>&&, unsigned functionCount, const Vector<SignatureIndex>&);
+
+    Ref<ModuleInformation> m_moduleInformation;
+    Vector<FunctionLocationInBinary> m_functionLocationInBinary;
+    Vector<SignatureIndex> m_moduleSignatureIndicesToUniquedSignatureIndices;
+    // Generated code refers to these by address, so they are never resized.
+    Vector<void*> m_entrypoints;
+    Vector<TierUpCount> m_tierUpCounts;
+    Vector<Vector<CodeLocationCall>> m_callSitesTo;
+
+    Lock m_lock;
+    JSWebAssemblyCodeBlock* m_codeBlock { nullptr };
+    Vector<RefPtr<TierUpPlan>> m_compiledPlans;
+
+    std::optional<CachedModuleKey> m_cachedModuleKey;
+    // Guarded by m_lock.
+    CachedModule m_cachedModule;
+};
+
+} } // namespace JSC::Wasm
+
+#endif // ENABLE(WEBASSEMBLY)
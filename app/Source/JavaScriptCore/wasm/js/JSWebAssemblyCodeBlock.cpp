@@ -36,15 +36,22 @@ namespace JSC {
 
 const ClassInfo JSWebAssemblyCodeBlock::s_info = { "WebAssemblyCodeBlock", nullptr, 0, CREATE_METHOD_TABLE(JSWebAssemblyCodeBlock) };
 
-JSWebAssemblyCodeBlock::JSWebAssemblyCodeBlock(VM& vm, JSWebAssemblyModule* owner, Bag<CallLinkInfo>&& callLinkInfos, Vector<Wasm::WasmExitStubs>&& wasmExitStubs, Wasm::Memory::Mode mode, unsigned calleeCount)
+JSWebAssemblyCodeBlock::JSWebAssemblyCodeBlock(VM& vm, JSWebAssemblyModule* owner, Bag<CallLinkInfo>&& callLinkInfos, Vector<Wasm::WasmExitStubs>&& wasmExitStubs, Ref<Wasm::TierUpState>&& tierUpState, Wasm::Memory::Mode mode, unsigned calleeCount)
     : Base(vm, vm.webAssemblyCodeBlockStructure.get())
     , m_callLinkInfos(WTFMove(callLinkInfos))
     , m_wasmExitStubs(WTFMove(wasmExitStubs))
+    , m_tierUpState(WTFMove(tierUpState))
     , m_mode(mode)
     , m_calleeCount(calleeCount)
 {
     m_module.set(vm, this, owner);
-    memset(callees(), 0, m_calleeCount * sizeof(WriteBarrier<JSWebAssemblyCallee>) * 2);
+    memset(callees(), 0, m_calleeCount * sizeof(WriteBarrier<JSWebAssemblyCallee>) * 3);
+    m_tierUpState->setCodeBlock(this);
+}
+
+JSWebAssemblyCodeBlock::~JSWebAssemblyCodeBlock()
+{
+    m_tierUpState->setCodeBlock(nullptr);
 }
 
 void JSWebAssemblyCodeBlock::destroy(JSCell* cell)
@@ -66,7 +73,7 @@ void JSWebAssemblyCodeBlock::visitChildren(JSCell* cell, SlotVisitor& visitor)
 
     Base::visitChildren(thisObject, visitor);
     visitor.append(thisObject->m_module);
-    for (unsigned i = 0; i < thisObject->m_calleeCount * 2; i++)
+    for (unsigned i = 0; i < thisObject->m_calleeCount * 3; i++)
         visitor.append(thisObject->callees()[i]);
 
     visitor.addUnconditionalFinalizer(&thisObject->m_unconditionalFinalizer);
@@ -33,6 +33,7 @@
 #include "JSWebAssemblyCodeBlock.h"
 #include "JSWebAssemblyCompileError.h"
 #include "JSWebAssemblyMemory.h"
+#include "WasmCachedModule.h"
 #include "WasmFormat.h"
 #include "WasmMemory.h"
 #include "WasmPlan.h"
@@ -46,7 +47,6 @@ JSWebAssemblyCodeBlock* JSWebAssemblyModule::buildCodeBlock(VM& vm, ExecState* e
 {
     auto scope = DECLARE_THROW_SCOPE(vm);
     // On failure, a new WebAssembly.CompileError is thrown.
-    plan.run(mode);
     if (plan.failed()) {
         throwException(exec, scope, createJSWebAssemblyCompileError(exec, vm, plan.errorMessage()));
         return nullptr;
@@ -55,7 +55,7 @@ JSWebAssemblyCodeBlock* JSWebAssemblyModule::buildCodeBlock(VM& vm, ExecState* e
         ASSERT(*mode == plan.mode());
 
     unsigned calleeCount = plan.internalFunctionCount();
-    auto* codeBlock = JSWebAssemblyCodeBlock::create(vm, this, plan.takeCallLinkInfos(), plan.takeWasmExitStubs(), plan.mode(), calleeCount);
+    auto* codeBlock = JSWebAssemblyCodeBlock::create(vm, this, plan.takeCallLinkInfos(), plan.takeWasmExitStubs(), plan.takeTierUpState(), plan.mode(), calleeCount);
 
     plan.initializeCallees(exec->jsCallee()->globalObject(),
         [&] (unsigned calleeIndex, JSWebAssemblyCallee* jsEntrypointCallee, JSWebAssemblyCallee* wasmEntrypointCallee) {
@@ -66,10 +66,19 @@ JSWebAssemblyCodeBlock* JSWebAssemblyModule::buildCodeBlock(VM& vm, ExecState* e
 }
 
 JSWebAssemblyModule* JSWebAssemblyModule::create(VM& vm, ExecState* exec, Structure* structure, uint8_t* source, size_t byteSize)
+{
+    Wasm::Plan plan(&vm, source, byteSize);
+    if (std::optional<Wasm::CachedModuleKey> cachedModuleKey = Wasm::cachedModuleKey(source, byteSize))
+        plan.setCachedModuleKey(*cachedModuleKey);
+    plan.run();
+    return create(vm, exec, structure, plan);
+}
+
+JSWebAssemblyModule* JSWebAssemblyModule::create(VM& vm, ExecState* exec, Structure* structure, Wasm::Plan& plan)
 {
     auto* instance = new (NotNull, allocateCell<JSWebAssemblyModule>(vm.heap)) JSWebAssemblyModule(vm, structure);
 
-    instance->finishCreation(vm, exec, source, byteSize);
+    instance->finishCreation(vm, exec, plan);
     return instance;
 }
 
@@ -96,6 +105,9 @@ JSWebAssemblyCodeBlock* JSWebAssemblyModule::codeBlock(VM& vm, ExecState* exec,
     auto scope = DECLARE_THROW_SCOPE(vm);
     // We don't have a code block for this mode, we need to recompile...
     Wasm::Plan plan(&vm, static_cast<uint8_t*>(m_sourceBuffer->data()), m_sourceBuffer->byteLength());
+    if (m_cachedModuleKey)
+        plan.setCachedModuleKey(*m_cachedModuleKey);
+    plan.run(mode);
 
     auto* codeBlock = buildCodeBlock(vm, exec, plan, mode);
     RETURN_IF_EXCEPTION(scope, nullptr);
@@ -111,14 +123,12 @@ JSWebAssemblyCodeBlock* JSWebAssemblyModule::codeBlock(VM& vm, ExecState* exec,
     return codeBlock;
 }
 
-void JSWebAssemblyModule::finishCreation(VM& vm, ExecState* exec, uint8_t* source, size_t byteSize)
+void JSWebAssemblyModule::finishCreation(VM& vm, ExecState* exec, Wasm::Plan& plan)
 {
     Base::finishCreation(vm);
     ASSERT(inherits(vm, info()));
 
     auto scope = DECLARE_THROW_SCOPE(vm);
-    Wasm::Plan plan(&vm, source, byteSize);
-
     auto* codeBlock = buildCodeBlock(vm, exec, plan);
     RETURN_IF_EXCEPTION(scope,);
 
@@ -129,7 +139,8 @@ void JSWebAssemblyModule::finishCreation(VM& vm, ExecState* exec, uint8_t* sourc
         exportSymbolTable->set(NoLockingNecessary, exp.field.impl(), SymbolTableEntry(VarOffset(offset)));
     }
 
-    m_sourceBuffer = ArrayBuffer::create(source, byteSize);
+    m_sourceBuffer = ArrayBuffer::create(plan.source(), plan.sourceLength());
+    m_cachedModuleKey = plan.cachedModuleKey();
     m_moduleInformation = plan.takeModuleInformation();
     m_exportSymbolTable.set(vm, this, exportSymbolTable);
     m_codeBlocks[codeBlock->mode()].set(vm, this, codeBlock);
@@ -31,6 +31,7 @@
 #include "JSObject.h"
 #include "JSWebAssemblyCodeBlock.h"
 #include "UnconditionalFinalizer.h"
+#include "WasmCachedModule.h"
 #include "WasmFormat.h"
 #include <wtf/Bag.h>
 #include <wtf/Vector.h>
@@ -48,7 +49,10 @@ class JSWebAssemblyModule : public JSDestructibleObject {
 public:
     typedef JSDestructibleObject Base;
 
+    // Uses, and keeps up to date, the module's entry in Options::webAssemblyCachePath() if set.
     static JSWebAssemblyModule* create(VM&, ExecState*, Structure*, uint8_t* source, size_t byteSize);
+    // Creates the module from a plan that has already run, such as one that was streamed.
+    JS_EXPORT_PRIVATE static JSWebAssemblyModule* create(VM&, ExecState*, Structure*, Wasm::Plan&);
     static Structure* createStructure(VM&, JSGlobalObject*, JSValue);
 
     DECLARE_INFO;
@@ -56,6 +60,8 @@ public:
     const Wasm::ModuleInformation& moduleInformation() const { return *m_moduleInformation.get(); }
     RefPtr<Wasm::Memory> takeReservedMemory() { return m_moduleInformation->memory.takeReservedMemory(); }
     SymbolTable* exportSymbolTable() const { return m_exportSymbolTable.get(); }
+    const uint8_t* source() const { return static_cast<const uint8_t*>(m_sourceBuffer->data()); }
+    size_t sourceLength() const { return m_sourceBuffer->byteLength(); }
     Wasm::SignatureIndex signatureIndexFromFunctionIndexSpace(unsigned functionIndexSpace) const
     {
         return m_moduleInformation->signatureIndexFromFunctionIndexSpace(functionIndexSpace);
@@ -70,12 +76,13 @@ private:
     JSWebAssemblyCodeBlock* buildCodeBlock(VM&, ExecState*, Wasm::Plan&, std::optional<Wasm::Memory::Mode> mode = std::nullopt);
 
     JSWebAssemblyModule(VM&, Structure*);
-    void finishCreation(VM&, ExecState*, uint8_t* source, size_t byteSize);
+    void finishCreation(VM&, ExecState*, Wasm::Plan&);
     static void destroy(JSCell*);
     static void visitChildren(JSCell*, SlotVisitor&);
 
     RefPtr<ArrayBuffer> m_sourceBuffer;
-    std::unique_ptr<Wasm::ModuleInformation> m_moduleInformation;
+    RefPtr<Wasm::ModuleInformation> m_moduleInformation;
+    std::optional<Wasm::CachedModuleKey> m_cachedModuleKey;
     WriteBarrier<SymbolTable> m_exportSymbolTable;
     WriteBarrier<JSWebAssemblyCodeBlock> m_codeBlocks[Wasm::Memory::NumberOfModes];
 };
@@ -128,7 +128,7 @@ void JSWebAssemblyTable::setFunction(VM& vm, uint32_t index, WebAssemblyFunction
 {
     RELEASE_ASSERT(index < m_size);
     m_jsFunctions.get()[index].set(vm, this, function);
-    m_functions.get()[index] = Wasm::CallableFunction(function->signatureIndex(), function->wasmEntrypoint());
+    m_functions.get()[index] = Wasm::CallableFunction(function->signatureIndex(), function->wasmEntrypointLoadLocation());
 }
 
 } // namespace JSC
@@ -38,7 +38,7 @@ namespace JSC { namespace Yarr {
 #define YarrStackSpaceForBackTrackInfoParentheticalAssertion 1
 #define YarrStackSpaceForBackTrackInfoParenthesesOnce 1 // Only for !fixed quantifiers.
 #define YarrStackSpaceForBackTrackInfoParenthesesTerminal 1
-#define YarrStackSpaceForBackTrackInfoParentheses 2
+#define YarrStackSpaceForBackTrackInfoParentheses 3
 
 static const unsigned quantifyInfinite = UINT_MAX;
 static const unsigned offsetNoMatch = std::numeric_limits<unsigned>::max();
@@ -53,7 +53,8 @@ enum JSRegExpResult {
     JSRegExpErrorNoMatch = -1,
     JSRegExpErrorHitLimit = -2,
     JSRegExpErrorNoMemory = -3,
-    JSRegExpErrorInternal = -4
+    JSRegExpErrorInternal = -4,
+    JSRegExpJITCodeFailure = -5
 };
 
 enum YarrCharSize {
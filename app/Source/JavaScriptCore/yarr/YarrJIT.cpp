@@ -61,6 +61,11 @@ class YarrGenerator : private MacroAssembler {
 
     static const RegisterID regT0 = ARM64Registers::x4;
     static const RegisterID regT1 = ARM64Registers::x5;
+    static const RegisterID regT2 = ARM64Registers::x6;
+    static const RegisterID regT3 = ARM64Registers::x7;
+
+    // The ParenContextArea argument, read into the frame before regT0 is first used.
+    static const RegisterID parenContextAreaArgument = ARM64Registers::x4;
 
     static const RegisterID returnRegister = ARM64Registers::x0;
     static const RegisterID returnRegister2 = ARM64Registers::x1;
@@ -104,6 +109,13 @@ class YarrGenerator : private MacroAssembler {
 
     static const RegisterID regT0 = X86Registers::eax;
     static const RegisterID regT1 = X86Registers::ebx;
+#if !OS(WINDOWS)
+    static const RegisterID regT2 = X86Registers::r8;
+    static const RegisterID regT3 = X86Registers::r9;
+
+    // The ParenContextArea argument, read into the frame before regT2 is first used.
+    static const RegisterID parenContextAreaArgument = X86Registers::r8;
+#endif
 
     static const RegisterID returnRegister = X86Registers::eax;
     static const RegisterID returnRegister2 = X86Registers::edx;
@@ -340,6 +352,11 @@ class YarrGenerator : private MacroAssembler {
         poke(imm, frameLocation);
     }
 
+    void storeToFrame(TrustedImmPtr imm, unsigned frameLocation)
+    {
+        poke(imm, frameLocation);
+    }
+
     DataLabelPtr storeToFrameWithPatch(unsigned frameLocation)
     {
         return storePtrWithPatch(TrustedImmPtr(0), Address(stackPointerRegister, frameLocation * sizeof(void*)));
@@ -358,7 +375,7 @@ class YarrGenerator : private MacroAssembler {
     unsigned alignCallFrameSizeInBytes(unsigned callFrameSize)
     {
         callFrameSize *= sizeof(void*);
-        if (callFrameSize / sizeof(void*) != m_pattern.m_body->m_callFrameSize)
+        if (callFrameSize / sizeof(void*) != m_callFrameSize)
             CRASH();
         callFrameSize = (callFrameSize + 0x3f) & ~0x3f;
         if (!callFrameSize)
@@ -367,17 +384,175 @@ class YarrGenerator : private MacroAssembler {
     }
     void initCallFrame()
     {
-        unsigned callFrameSize = m_pattern.m_body->m_callFrameSize;
+        unsigned callFrameSize = m_callFrameSize;
         if (callFrameSize)
             subPtr(Imm32(alignCallFrameSizeInBytes(callFrameSize)), stackPointerRegister);
     }
     void removeCallFrame()
     {
-        unsigned callFrameSize = m_pattern.m_body->m_callFrameSize;
+        unsigned callFrameSize = m_callFrameSize;
         if (callFrameSize)
             addPtr(Imm32(alignCallFrameSizeInBytes(callFrameSize)), stackPointerRegister);
     }
 
+    // The frame holds the backtracking state laid out by YarrPattern, followed by the bounds of
+    // the ParenContextArea (if any parentheses need one), followed by the output vector used by
+    // MatchOnly code for patterns with back-references.
+    void layOutCallFrame()
+    {
+        m_callFrameSize = m_pattern.m_body->m_callFrameSize;
+
+        if (m_usesParenContexts) {
+            m_parenContextTopFrameLocation = m_callFrameSize++;
+            m_parenContextLimitFrameLocation = m_callFrameSize++;
+        }
+
+        if (compileMode == MatchOnly && m_recordSubpatterns) {
+            m_outputFrameLocation = m_callFrameSize;
+            // Each slot holds the start and end of one subpattern.
+            m_callFrameSize += m_pattern.m_numSubpatterns + 1;
+        }
+    }
+
+    // Parentheses that are neither 'Once' nor 'Terminal' may match more than once. They keep a
+    // ParenContext for each iteration, so that we can backtrack back into earlier iterations.
+    static bool usesParenContexts(PatternTerm* term)
+    {
+        return term->type == PatternTerm::TypeParenthesesSubpattern
+            && (term->quantityMaxCount != 1 || term->parentheses.isCopy)
+            && !term->parentheses.isTerminal;
+    }
+
+    // Fixed count 'Once' parentheses check that the minimum size of their disjunction is
+    // available before they are entered; for other subpatterns each alternative checks for all
+    // of its own minimum size.
+    static bool minimumSizeIsPrechecked(PatternTerm* term)
+    {
+        return term->quantityType == QuantifierFixedCount
+            && term->type != PatternTerm::TypeParentheticalAssertion
+            && !usesParenContexts(term);
+    }
+
+    // The frame slot holding the return address used to backtrack into a subpattern's alternatives.
+    static unsigned alternativeFrameLocation(PatternTerm* term)
+    {
+        if (usesParenContexts(term))
+            return term->frameLocation + YarrStackSpaceForBackTrackInfoParentheses;
+        if (term->quantityType != QuantifierFixedCount)
+            return term->frameLocation + YarrStackSpaceForBackTrackInfoParenthesesOnce;
+        return term->frameLocation;
+    }
+
+    // The frame slots used by OpParenthesesSubpatternBegin/End, relative to the term's frame
+    // location. Nested alternatives compare the index against the first slot to reject empty
+    // iterations, so that has to be where the current iteration began.
+    enum ParenthesesFrameSlot {
+        ParenthesesBeginIndex,
+        ParenthesesMatchAmount,
+        ParenthesesContextHead,
+    };
+
+    // A ParenContext holds a link to the context of the previous iteration, and the captures of
+    // the subpattern from before its iteration started, so they can be put back if it fails.
+    // Once the iteration has matched it also holds where the iteration began, and the frame
+    // slots of the terms within the subpattern, so we can backtrack back into it later.
+    static const unsigned parenContextNextOffset = 0;
+    static const unsigned parenContextBeginIndexOffset = sizeof(void*);
+    static const unsigned parenContextCapturesOffset = 2 * sizeof(void*);
+
+    unsigned parenContextNumberOfCaptures(PatternTerm* term)
+    {
+        if (!m_recordSubpatterns)
+            return 0;
+        return term->parentheses.lastSubpatternId + 1 - term->parentheses.subpatternId;
+    }
+    static unsigned parenContextFirstFrameLocation(PatternTerm* term)
+    {
+        return term->frameLocation + YarrStackSpaceForBackTrackInfoParentheses;
+    }
+    unsigned parenContextFrameOffset(PatternTerm* term)
+    {
+        return parenContextCapturesOffset + parenContextNumberOfCaptures(term) * sizeof(void*);
+    }
+    unsigned parenContextSize(PatternTerm* term)
+    {
+        unsigned frameSize = term->parentheses.disjunction->m_callFrameSize - parenContextFirstFrameLocation(term);
+        return parenContextFrameOffset(term) + frameSize * sizeof(void*);
+    }
+
+    void initParenContextArea()
+    {
+        const RegisterID temp = regT1;
+        ASSERT(temp != parenContextAreaArgument);
+        loadPtr(Address(parenContextAreaArgument, ParenContextArea::offsetOfBegin()), temp);
+        storeToFrame(temp, m_parenContextTopFrameLocation);
+        loadPtr(Address(parenContextAreaArgument, ParenContextArea::offsetOfEnd()), temp);
+        storeToFrame(temp, m_parenContextLimitFrameLocation);
+    }
+
+    // Contexts are allocated from the area in LIFO order. If the area is full, give up; the
+    // caller runs the match again with a bigger area.
+    void pushParenContext(PatternTerm* term, RegisterID parenContextPointer, RegisterID temp)
+    {
+        unsigned headFrameLocation = term->frameLocation + ParenthesesContextHead;
+        loadFromFrame(m_parenContextTopFrameLocation, parenContextPointer);
+        move(parenContextPointer, temp);
+        addPtr(TrustedImm32(parenContextSize(term)), temp);
+        m_abortExecution.append(branchPtr(Above, temp, Address(stackPointerRegister, m_parenContextLimitFrameLocation * sizeof(void*))));
+        storeToFrame(temp, m_parenContextTopFrameLocation);
+        loadFromFrame(headFrameLocation, temp);
+        storePtr(temp, Address(parenContextPointer, parenContextNextOffset));
+        storeToFrame(parenContextPointer, headFrameLocation);
+    }
+    // Freeing a context also frees any allocated after it, such as those left behind by
+    // subpatterns within a lookahead that matched.
+    void popParenContext(PatternTerm* term, RegisterID parenContextPointer, RegisterID temp)
+    {
+        storeToFrame(parenContextPointer, m_parenContextTopFrameLocation);
+        loadPtr(Address(parenContextPointer, parenContextNextOffset), temp);
+        storeToFrame(temp, term->frameLocation + ParenthesesContextHead);
+    }
+
+    void saveParenContextCaptures(PatternTerm* term, RegisterID parenContextPointer, RegisterID temp)
+    {
+        for (unsigned i = 0; i < parenContextNumberOfCaptures(term); ++i) {
+            unsigned subpattern = term->parentheses.subpatternId + i;
+            loadPtr(Address(output, (subpattern << 1) * sizeof(int)), temp);
+            storePtr(temp, Address(parenContextPointer, parenContextCapturesOffset + i * sizeof(void*)));
+        }
+    }
+    void restoreParenContextCaptures(PatternTerm* term, RegisterID parenContextPointer, RegisterID temp)
+    {
+        for (unsigned i = 0; i < parenContextNumberOfCaptures(term); ++i) {
+            unsigned subpattern = term->parentheses.subpatternId + i;
+            loadPtr(Address(parenContextPointer, parenContextCapturesOffset + i * sizeof(void*)), temp);
+            storePtr(temp, Address(output, (subpattern << 1) * sizeof(int)));
+        }
+    }
+
+    void saveParenContextFrame(PatternTerm* term, RegisterID parenContextPointer, RegisterID temp)
+    {
+        loadFromFrame(term->frameLocation + ParenthesesBeginIndex, temp);
+        storePtr(temp, Address(parenContextPointer, parenContextBeginIndexOffset));
+        unsigned frameOffset = parenContextFrameOffset(term);
+        unsigned firstFrameLocation = parenContextFirstFrameLocation(term);
+        for (unsigned frameLocation = firstFrameLocation; frameLocation < term->parentheses.disjunction->m_callFrameSize; ++frameLocation) {
+            loadFromFrame(frameLocation, temp);
+            storePtr(temp, Address(parenContextPointer, frameOffset + (frameLocation - firstFrameLocation) * sizeof(void*)));
+        }
+    }
+    void restoreParenContextFrame(PatternTerm* term, RegisterID parenContextPointer, RegisterID temp)
+    {
+        loadPtr(Address(parenContextPointer, parenContextBeginIndexOffset), temp);
+        storeToFrame(temp, term->frameLocation + ParenthesesBeginIndex);
+        unsigned frameOffset = parenContextFrameOffset(term);
+        unsigned firstFrameLocation = parenContextFirstFrameLocation(term);
+        for (unsigned frameLocation = firstFrameLocation; frameLocation < term->parentheses.disjunction->m_callFrameSize; ++frameLocation) {
+            loadPtr(Address(parenContextPointer, frameOffset + (frameLocation - firstFrameLocation) * sizeof(void*)), temp);
+            storeToFrame(temp, frameLocation);
+        }
+    }
+
     void generateFailReturn()
     {
         move(TrustedImmPtr((void*)WTF::notFound), returnRegister);
@@ -385,39 +560,58 @@ class YarrGenerator : private MacroAssembler {
         generateReturn();
     }
 
-    // Used to record subpatters, should only be called if compileMode is IncludeSubpatterns.
+    void generateJITFailReturn()
+    {
+        if (m_abortExecution.empty())
+            return;
+
+        m_abortExecution.link(this);
+        removeCallFrame();
+        move(TrustedImmPtr((void*)static_cast<intptr_t>(JSRegExpJITCodeFailure)), returnRegister);
+        move(TrustedImm32(0), returnRegister2);
+        generateReturn();
+    }
+
+    // Used to record subpatters, should only be called if m_recordSubpatterns is set.
     void setSubpatternStart(RegisterID reg, unsigned subpattern)
     {
         ASSERT(subpattern);
-        // FIXME: should be able to ASSERT(compileMode == IncludeSubpatterns), but then this function is conditionally NORETURN. :-(
+        ASSERT(m_recordSubpatterns);
         store32(reg, Address(output, (subpattern << 1) * sizeof(int)));
     }
     void setSubpatternEnd(RegisterID reg, unsigned subpattern)
     {
         ASSERT(subpattern);
-        // FIXME: should be able to ASSERT(compileMode == IncludeSubpatterns), but then this function is conditionally NORETURN. :-(
+        ASSERT(m_recordSubpatterns);
         store32(reg, Address(output, ((subpattern << 1) + 1) * sizeof(int)));
     }
     void clearSubpatternStart(unsigned subpattern)
     {
         ASSERT(subpattern);
-        // FIXME: should be able to ASSERT(compileMode == IncludeSubpatterns), but then this function is conditionally NORETURN. :-(
+        ASSERT(m_recordSubpatterns);
         store32(TrustedImm32(-1), Address(output, (subpattern << 1) * sizeof(int)));
     }
+    void clearSubpattern(unsigned subpattern)
+    {
+        ASSERT(subpattern);
+        ASSERT(m_recordSubpatterns);
+        store32(TrustedImm32(-1), Address(output, (subpattern << 1) * sizeof(int)));
+        store32(TrustedImm32(-1), Address(output, ((subpattern << 1) + 1) * sizeof(int)));
+    }
 
     // We use one of three different strategies to track the start of the current match,
     // while matching.
     // 1) If the pattern has a fixed size, do nothing! - we calculate the value lazily
     //    at the end of matching. This is irrespective of compileMode, and in this case
     //    these methods should never be called.
-    // 2) If we're compiling IncludeSubpatterns, 'output' contains a pointer to an output
+    // 2) If we're recording subpatterns, 'output' contains a pointer to an output
     //    vector, store the match start in the output vector.
-    // 3) If we're compiling MatchOnly, 'output' is unused, store the match start directly
-    //    in this register.
+    // 3) If we're compiling MatchOnly without a vector, 'output' is unused, store the
+    //    match start directly in this register.
     void setMatchStart(RegisterID reg)
     {
         ASSERT(!m_pattern.m_body->m_hasFixedSize);
-        if (compileMode == IncludeSubpatterns)
+        if (m_recordSubpatterns)
             store32(reg, output);
         else
             move(reg, output);
@@ -425,7 +619,7 @@ class YarrGenerator : private MacroAssembler {
     void getMatchStart(RegisterID reg)
     {
         ASSERT(!m_pattern.m_body->m_hasFixedSize);
-        if (compileMode == IncludeSubpatterns)
+        if (m_recordSubpatterns)
             load32(output, reg);
         else
             move(output, reg);
@@ -459,6 +653,10 @@ class YarrGenerator : private MacroAssembler {
         // Used to wrap 'Terminal' subpattern matches (at the end of the regexp).
         OpParenthesesSubpatternTerminalBegin,
         OpParenthesesSubpatternTerminalEnd,
+        // Used to wrap all other subpatterns (those that may match more than once,
+        // and copies made for range quantifiers).
+        OpParenthesesSubpatternBegin,
+        OpParenthesesSubpatternEnd,
         // Used to wrap parenthetical assertions.
         OpParentheticalAssertionBegin,
         OpParentheticalAssertionEnd,
@@ -523,6 +721,10 @@ class YarrGenerator : private MacroAssembler {
         // value that will be pushed into the pattern's frame to return to,
         // upon backtracking back into the disjunction.
         DataLabelPtr m_returnAddress;
+
+        // Used by OpParenthesesSubpatternEnd to hold the entry point for
+        // backtracking back into the most recent iteration of the subpattern.
+        Label m_backtrackReentry;
     };
 
     // BacktrackingState
@@ -1181,6 +1383,195 @@ class YarrGenerator : private MacroAssembler {
         m_backtrackingState.fallthrough();
     }
 
+#if ENABLE(YARR_JIT_BACKREFERENCES)
+    // Loads the bounds of the subpattern a back-reference refers to. If that subpattern has not
+    // matched, or matched the empty string, the back-reference matches the empty string; in that
+    // case this jumps to 'emptyCapture'.
+    void loadBackReferenceCapture(PatternTerm* term, RegisterID captureStart, RegisterID captureEnd, JumpList& emptyCapture)
+    {
+        unsigned subpatternId = term->backReferenceSubpatternId;
+        load32(Address(output, (subpatternId << 1) * sizeof(int)), captureStart);
+        load32(Address(output, ((subpatternId << 1) + 1) * sizeof(int)), captureEnd);
+        emptyCapture.append(branch32(Equal, captureStart, TrustedImm32(-1)));
+        emptyCapture.append(branch32(Equal, captureEnd, TrustedImm32(-1)));
+        emptyCapture.append(branch32(Equal, captureStart, captureEnd));
+    }
+
+    // Matches one copy of the captured text, advancing index past it. captureStart is used as
+    // the cursor into the captured text. On failure index is left unchanged, and we jump to
+    // 'failures'.
+    void matchBackReferenceOnce(PatternTerm* term, RegisterID captureStart, RegisterID captureEnd, JumpList& failures)
+    {
+        const RegisterID character = regT0;
+        const RegisterID patternCharacter = regT1;
+        Checked<unsigned> negativeInputOffset = m_checkedOffset - term->inputPosition;
+
+        // Check there is enough input left for the whole copy.
+        move(captureEnd, character);
+        sub32(captureStart, character);
+        add32(index, character);
+        if (negativeInputOffset)
+            sub32(Imm32(negativeInputOffset.unsafeGet()), character);
+        failures.append(branch32(Above, character, length));
+
+        JumpList mismatches;
+        Label loop(this);
+        Jump copyMatched = branch32(Equal, captureStart, captureEnd);
+        readCharacter(0, patternCharacter, captureStart);
+        readCharacter(negativeInputOffset, character);
+        Jump charactersMatch = branch32(Equal, character, patternCharacter);
+        if (m_pattern.ignoreCase()) {
+            // Only 8-bit strings get here. Characters that differ only in bit 5 are case variants
+            // of each other if they are ASCII letters, or Latin-1 letters other than the division
+            // and multiplication signs; U+00DF and U+00FF are not a pair.
+            ASSERT(m_charSize == Char8);
+            or32(TrustedImm32(0x20), character);
+            or32(TrustedImm32(0x20), patternCharacter);
+            mismatches.append(branch32(NotEqual, character, patternCharacter));
+            sub32(TrustedImm32('a'), character);
+            Jump isASCIILetter = branch32(BelowOrEqual, character, TrustedImm32('z' - 'a'));
+            mismatches.append(branch32(Below, character, TrustedImm32(0xe0 - 'a')));
+            mismatches.append(branch32(Above, character, TrustedImm32(0xfe - 'a')));
+            mismatches.append(branch32(Equal, character, TrustedImm32(0xf7 - 'a')));
+            isASCIILetter.link(this);
+        } else
+            mismatches.append(jump());
+        charactersMatch.link(this);
+        add32(TrustedImm32(1), captureStart);
+        add32(TrustedImm32(1), index);
+        jump(loop);
+
+        // Rewind over the part of the copy that did match.
+        mismatches.link(this);
+        load32(Address(output, (term->backReferenceSubpatternId << 1) * sizeof(int)), character);
+        sub32(character, captureStart);
+        sub32(captureStart, index);
+        failures.append(jump());
+
+        copyMatched.link(this);
+    }
+
+    void generateBackReference(size_t opIndex)
+    {
+        YarrOp& op = m_ops[opIndex];
+        PatternTerm* term = op.m_term;
+
+        ASSERT(!m_pattern.ignoreCase() || m_charSize == Char8);
+
+        const RegisterID countRegister = regT1;
+        const RegisterID captureStart = regT2;
+        const RegisterID captureEnd = regT3;
+        unsigned beginIndexFrameLocation = term->frameLocation;
+        unsigned matchAmountFrameLocation = term->frameLocation + 1;
+
+        storeToFrame(index, beginIndexFrameLocation);
+        storeToFrame(TrustedImm32(0), matchAmountFrameLocation);
+
+        switch (term->quantityType) {
+        case QuantifierFixedCount: {
+            JumpList emptyCapture;
+            loadBackReferenceCapture(term, captureStart, captureEnd, emptyCapture);
+            if (term->quantityMaxCount == 1)
+                matchBackReferenceOnce(term, captureStart, captureEnd, op.m_jumps);
+            else {
+                JumpList failures;
+                Label loop(this);
+                matchBackReferenceOnce(term, captureStart, captureEnd, failures);
+                loadFromFrame(matchAmountFrameLocation, countRegister);
+                add32(TrustedImm32(1), countRegister);
+                storeToFrame(countRegister, matchAmountFrameLocation);
+                Jump finished = branch32(Equal, countRegister, Imm32(term->quantityMaxCount.unsafeGet()));
+                load32(Address(output, (term->backReferenceSubpatternId << 1) * sizeof(int)), captureStart);
+                jump(loop);
+
+                failures.link(this);
+                loadFromFrame(beginIndexFrameLocation, index);
+                op.m_jumps.append(jump());
+
+                finished.link(this);
+            }
+            emptyCapture.link(this);
+            break;
+        }
+        case QuantifierGreedy: {
+            JumpList finished;
+            loadBackReferenceCapture(term, captureStart, captureEnd, finished);
+            Label loop(this);
+            matchBackReferenceOnce(term, captureStart, captureEnd, finished);
+            loadFromFrame(matchAmountFrameLocation, countRegister);
+            add32(TrustedImm32(1), countRegister);
+            storeToFrame(countRegister, matchAmountFrameLocation);
+            if (term->quantityMaxCount != quantifyInfinite)
+                finished.append(branch32(Equal, countRegister, Imm32(term->quantityMaxCount.unsafeGet())));
+            load32(Address(output, (term->backReferenceSubpatternId << 1) * sizeof(int)), captureStart);
+            jump(loop);
+
+            finished.link(this);
+            op.m_reentry = label();
+            break;
+        }
+        case QuantifierNonGreedy:
+            op.m_reentry = label();
+            break;
+        }
+    }
+    void backtrackBackReference(size_t opIndex)
+    {
+        YarrOp& op = m_ops[opIndex];
+        PatternTerm* term = op.m_term;
+
+        const RegisterID countRegister = regT1;
+        const RegisterID captureStart = regT2;
+        const RegisterID captureEnd = regT3;
+        unsigned beginIndexFrameLocation = term->frameLocation;
+        unsigned matchAmountFrameLocation = term->frameLocation + 1;
+
+        m_backtrackingState.link(this);
+
+        switch (term->quantityType) {
+        case QuantifierFixedCount:
+            // There is only one way to match; rewind and backtrack further.
+            loadFromFrame(beginIndexFrameLocation, index);
+            m_backtrackingState.fallthrough();
+            m_backtrackingState.append(op.m_jumps);
+            break;
+
+        case QuantifierGreedy: {
+            // Give back one copy of the captured text, if we have any.
+            loadFromFrame(matchAmountFrameLocation, countRegister);
+            m_backtrackingState.append(branchTest32(Zero, countRegister));
+            sub32(TrustedImm32(1), countRegister);
+            storeToFrame(countRegister, matchAmountFrameLocation);
+            load32(Address(output, (term->backReferenceSubpatternId << 1) * sizeof(int)), captureStart);
+            load32(Address(output, ((term->backReferenceSubpatternId << 1) + 1) * sizeof(int)), captureEnd);
+            add32(captureStart, index);
+            sub32(captureEnd, index);
+            jump(op.m_reentry);
+            break;
+        }
+
+        case QuantifierNonGreedy: {
+            // Try to match one more copy of the captured text.
+            JumpList failures;
+            loadFromFrame(matchAmountFrameLocation, countRegister);
+            if (term->quantityMaxCount != quantifyInfinite)
+                failures.append(branch32(Equal, countRegister, Imm32(term->quantityMaxCount.unsafeGet())));
+            loadBackReferenceCapture(term, captureStart, captureEnd, failures);
+            matchBackReferenceOnce(term, captureStart, captureEnd, failures);
+            loadFromFrame(matchAmountFrameLocation, countRegister);
+            add32(TrustedImm32(1), countRegister);
+            storeToFrame(countRegister, matchAmountFrameLocation);
+            jump(op.m_reentry);
+
+            failures.link(this);
+            loadFromFrame(beginIndexFrameLocation, index);
+            m_backtrackingState.fallthrough();
+            break;
+        }
+        }
+    }
+#endif
+
     void generateDotStarEnclosure(size_t opIndex)
     {
         YarrOp& op = m_ops[opIndex];
@@ -1304,7 +1695,11 @@ class YarrGenerator : private MacroAssembler {
         case PatternTerm::TypeParentheticalAssertion:
             RELEASE_ASSERT_NOT_REACHED();
         case PatternTerm::TypeBackReference:
-            m_shouldFallBack = true;
+#if ENABLE(YARR_JIT_BACKREFERENCES)
+            generateBackReference(opIndex);
+#else
+            RELEASE_ASSERT_NOT_REACHED();
+#endif
             break;
         case PatternTerm::TypeDotStarEnclosure:
             generateDotStarEnclosure(opIndex);
@@ -1375,7 +1770,11 @@ class YarrGenerator : private MacroAssembler {
             break;
 
         case PatternTerm::TypeBackReference:
-            m_shouldFallBack = true;
+#if ENABLE(YARR_JIT_BACKREFERENCES)
+            backtrackBackReference(opIndex);
+#else
+            RELEASE_ASSERT_NOT_REACHED();
+#endif
             break;
         }
     }
@@ -1435,9 +1834,6 @@ class YarrGenerator : private MacroAssembler {
                 PatternAlternative* alternative = op.m_alternative;
 
                 // If we get here, the prior alternative matched - return success.
-                
-                // Adjust the stack pointer to remove the pattern's frame.
-                removeCallFrame();
 
                 // Load appropriate values into the return register and the first output
                 // slot, and return. In the case of pattern with a fixed size, we will
@@ -1455,6 +1851,9 @@ class YarrGenerator : private MacroAssembler {
                     store32(index, Address(output, 4));
                 move(index, returnRegister2);
 
+                // Adjust the stack pointer to remove the pattern's frame. This comes last
+                // since the match start may be held in the frame.
+                removeCallFrame();
                 generateReturn();
 
                 // This is the divide between the tail of the prior alternative, above, and
@@ -1508,7 +1907,7 @@ class YarrGenerator : private MacroAssembler {
 
                 // Calculate how much input we need to check for, and if non-zero check.
                 op.m_checkAdjust = Checked<unsigned>(alternative->m_minimumSize);
-                if ((term->quantityType == QuantifierFixedCount) && (term->type != PatternTerm::TypeParentheticalAssertion))
+                if (minimumSizeIsPrechecked(term))
                     op.m_checkAdjust -= disjunction->m_minimumSize;
                 if (op.m_checkAdjust)
                     op.m_jumps.append(jumpIfNoAvailableInput(op.m_checkAdjust.unsafeGet()));
@@ -1524,11 +1923,7 @@ class YarrGenerator : private MacroAssembler {
 
                 // In the non-simple case, store a 'return address' so we can backtrack correctly.
                 if (op.m_op == OpNestedAlternativeNext) {
-                    unsigned parenthesesFrameLocation = term->frameLocation;
-                    unsigned alternativeFrameLocation = parenthesesFrameLocation;
-                    if (term->quantityType != QuantifierFixedCount)
-                        alternativeFrameLocation += YarrStackSpaceForBackTrackInfoParenthesesOnce;
-                    op.m_returnAddress = storeToFrameWithPatch(alternativeFrameLocation);
+                    op.m_returnAddress = storeToFrameWithPatch(alternativeFrameLocation(term));
                 }
 
                 if (term->quantityType != QuantifierFixedCount && !m_ops[op.m_previousOp].m_alternative->m_minimumSize) {
@@ -1558,7 +1953,7 @@ class YarrGenerator : private MacroAssembler {
 
                 // Calculate how much input we need to check for, and if non-zero check.
                 op.m_checkAdjust = alternative->m_minimumSize;
-                if ((term->quantityType == QuantifierFixedCount) && (term->type != PatternTerm::TypeParentheticalAssertion))
+                if (minimumSizeIsPrechecked(term))
                     op.m_checkAdjust -= disjunction->m_minimumSize;
                 if (op.m_checkAdjust)
                     op.m_jumps.append(jumpIfNoAvailableInput(op.m_checkAdjust.unsafeGet()));
@@ -1574,11 +1969,7 @@ class YarrGenerator : private MacroAssembler {
 
                 // In the non-simple case, store a 'return address' so we can backtrack correctly.
                 if (op.m_op == OpNestedAlternativeEnd) {
-                    unsigned parenthesesFrameLocation = term->frameLocation;
-                    unsigned alternativeFrameLocation = parenthesesFrameLocation;
-                    if (term->quantityType != QuantifierFixedCount)
-                        alternativeFrameLocation += YarrStackSpaceForBackTrackInfoParenthesesOnce;
-                    op.m_returnAddress = storeToFrameWithPatch(alternativeFrameLocation);
+                    op.m_returnAddress = storeToFrameWithPatch(alternativeFrameLocation(term));
                 }
 
                 if (term->quantityType != QuantifierFixedCount && !m_ops[op.m_previousOp].m_alternative->m_minimumSize) {
@@ -1637,7 +2028,7 @@ class YarrGenerator : private MacroAssembler {
                 // FIXME: could avoid offsetting this value in JIT code, apply
                 // offsets only afterwards, at the point the results array is
                 // being accessed.
-                if (term->capture() && compileMode == IncludeSubpatterns) {
+                if (term->capture() && m_recordSubpatterns) {
                     unsigned inputOffset = (m_checkedOffset - term->inputPosition).unsafeGet();
                     if (term->quantityType == QuantifierFixedCount)
                         inputOffset += term->parentheses.disjunction->m_minimumSize;
@@ -1670,7 +2061,7 @@ class YarrGenerator : private MacroAssembler {
                 // FIXME: could avoid offsetting this value in JIT code, apply
                 // offsets only afterwards, at the point the results array is
                 // being accessed.
-                if (term->capture() && compileMode == IncludeSubpatterns) {
+                if (term->capture() && m_recordSubpatterns) {
                     unsigned inputOffset = (m_checkedOffset - term->inputPosition).unsafeGet();
                     if (inputOffset) {
                         move(index, indexTemporary);
@@ -1730,6 +2121,91 @@ class YarrGenerator : private MacroAssembler {
                 break;
             }
 
+            // OpParenthesesSubpatternBegin/End
+            //
+            // These nodes support subpatterns that may match more than once: fixed
+            // counts greater than one, ranges, and the copies made of parentheses with
+            // a range quantifier. Each iteration begins by pushing a ParenContext
+            // holding the captures from before the iteration, and then clears them.
+            // When the iteration matches, the frame slots of the nested terms are saved
+            // in the context so that we can backtrack back into the iteration later.
+            case OpParenthesesSubpatternBegin: {
+                PatternTerm* term = op.m_term;
+                unsigned parenthesesFrameLocation = term->frameLocation;
+                const RegisterID parenContextPointer = regT0;
+                const RegisterID temp = regT1;
+
+                storeToFrame(TrustedImm32(0), parenthesesFrameLocation + ParenthesesMatchAmount);
+                storeToFrame(TrustedImmPtr(nullptr), parenthesesFrameLocation + ParenthesesContextHead);
+
+                // NonGreedy parentheses start by trying the remainder of the expression
+                // without matching the subpattern at all.
+                if (term->quantityType == QuantifierNonGreedy)
+                    op.m_jumps.append(jump());
+
+                // This is the entry point for each iteration.
+                op.m_reentry = label();
+
+                pushParenContext(term, parenContextPointer, temp);
+                saveParenContextCaptures(term, parenContextPointer, temp);
+                for (unsigned i = 0; i < parenContextNumberOfCaptures(term); ++i)
+                    clearSubpattern(term->parentheses.subpatternId + i);
+
+                storeToFrame(index, parenthesesFrameLocation + ParenthesesBeginIndex);
+
+                if (term->capture() && m_recordSubpatterns) {
+                    unsigned inputOffset = (m_checkedOffset - term->inputPosition).unsafeGet();
+                    if (inputOffset) {
+                        move(index, temp);
+                        sub32(Imm32(inputOffset), temp);
+                        setSubpatternStart(temp, term->parentheses.subpatternId);
+                    } else
+                        setSubpatternStart(index, term->parentheses.subpatternId);
+                }
+                break;
+            }
+            case OpParenthesesSubpatternEnd: {
+                PatternTerm* term = op.m_term;
+                unsigned parenthesesFrameLocation = term->frameLocation;
+                const RegisterID parenContextPointer = regT0;
+                const RegisterID countTemporary = regT1;
+                YarrOp& beginOp = m_ops[op.m_previousOp];
+
+                if (term->capture() && m_recordSubpatterns) {
+                    unsigned inputOffset = (m_checkedOffset - term->inputPosition).unsafeGet();
+                    if (inputOffset) {
+                        move(index, countTemporary);
+                        sub32(Imm32(inputOffset), countTemporary);
+                        setSubpatternEnd(countTemporary, term->parentheses.subpatternId);
+                    } else
+                        setSubpatternEnd(index, term->parentheses.subpatternId);
+                }
+
+                loadFromFrame(parenthesesFrameLocation + ParenthesesContextHead, parenContextPointer);
+                saveParenContextFrame(term, parenContextPointer, countTemporary);
+
+                loadFromFrame(parenthesesFrameLocation + ParenthesesMatchAmount, countTemporary);
+                add32(TrustedImm32(1), countTemporary);
+                storeToFrame(countTemporary, parenthesesFrameLocation + ParenthesesMatchAmount);
+
+                // FixedCount and Greedy parentheses go round again until they reach their
+                // maximum count; NonGreedy ones try the remainder of the expression first.
+                if (term->quantityType != QuantifierNonGreedy) {
+                    if (term->quantityMaxCount == quantifyInfinite)
+                        jump(beginOp.m_reentry);
+                    else
+                        branch32(Below, countTemporary, Imm32(term->quantityMaxCount.unsafeGet())).linkTo(beginOp.m_reentry, this);
+                }
+
+                // This is the entry point for the remainder of the expression.
+                op.m_reentry = label();
+                if (term->quantityType == QuantifierNonGreedy) {
+                    beginOp.m_jumps.link(this);
+                    beginOp.m_jumps.clear();
+                }
+                break;
+            }
+
             // OpParentheticalAssertionBegin/End
             case OpParentheticalAssertionBegin: {
                 PatternTerm* term = op.m_term;
@@ -2147,11 +2623,7 @@ class YarrGenerator : private MacroAssembler {
                     m_backtrackingState.link(this);
 
                     // Plant a jump to the return address.
-                    unsigned parenthesesFrameLocation = term->frameLocation;
-                    unsigned alternativeFrameLocation = parenthesesFrameLocation;
-                    if (term->quantityType != QuantifierFixedCount)
-                        alternativeFrameLocation += YarrStackSpaceForBackTrackInfoParenthesesOnce;
-                    loadFromFrameAndJump(alternativeFrameLocation);
+                    loadFromFrameAndJump(alternativeFrameLocation(term));
 
                     // Link the DataLabelPtr associated with the end of the last
                     // alternative to this point.
@@ -2183,11 +2655,11 @@ class YarrGenerator : private MacroAssembler {
                 ASSERT(term->quantityMaxCount == 1);
 
                 // We only need to backtrack to thispoint if capturing or greedy.
-                if ((term->capture() && compileMode == IncludeSubpatterns) || term->quantityType == QuantifierGreedy) {
+                if ((term->capture() && m_recordSubpatterns) || term->quantityType == QuantifierGreedy) {
                     m_backtrackingState.link(this);
 
                     // If capturing, clear the capture (we only need to reset start).
-                    if (term->capture() && compileMode == IncludeSubpatterns)
+                    if (term->capture() && m_recordSubpatterns)
                         clearSubpatternStart(term->parentheses.subpatternId);
 
                     // If Greedy, jump to the end.
@@ -2260,6 +2732,71 @@ class YarrGenerator : private MacroAssembler {
                 m_backtrackingState.append(op.m_jumps);
                 break;
 
+            // OpParenthesesSubpatternBegin/End
+            //
+            // When we backtrack into the end of the parentheses the remainder of the
+            // expression has failed. NonGreedy parentheses then try another iteration.
+            // Otherwise we restore the frame of the most recent iteration from its
+            // context and backtrack into that iteration, or, if there are none left,
+            // backtrack out of the parentheses.
+            //
+            // When we backtrack into the beginning of the parentheses an iteration has
+            // failed to match. We put back the captures from before it and free its
+            // context. Greedy parentheses then continue with the remainder of the
+            // expression; the others backtrack into the previous iteration.
+            case OpParenthesesSubpatternBegin: {
+                PatternTerm* term = op.m_term;
+                unsigned parenthesesFrameLocation = term->frameLocation;
+                const RegisterID parenContextPointer = regT0;
+                const RegisterID temp = regT1;
+                YarrOp& endOp = m_ops[op.m_nextOp];
+
+                m_backtrackingState.link(this);
+
+                loadFromFrame(parenthesesFrameLocation + ParenthesesContextHead, parenContextPointer);
+                restoreParenContextCaptures(term, parenContextPointer, temp);
+                popParenContext(term, parenContextPointer, temp);
+                loadFromFrame(parenthesesFrameLocation + ParenthesesBeginIndex, index);
+
+                if (term->quantityType == QuantifierGreedy)
+                    jump(endOp.m_reentry);
+                else
+                    jump(endOp.m_backtrackReentry);
+
+                // The End node will have planted jumps for when there are no iterations
+                // left to backtrack into.
+                m_backtrackingState.append(op.m_jumps);
+                break;
+            }
+            case OpParenthesesSubpatternEnd: {
+                PatternTerm* term = op.m_term;
+                unsigned parenthesesFrameLocation = term->frameLocation;
+                const RegisterID parenContextPointer = regT0;
+                const RegisterID countTemporary = regT1;
+                YarrOp& beginOp = m_ops[op.m_previousOp];
+
+                m_backtrackingState.link(this);
+
+                if (term->quantityType == QuantifierNonGreedy) {
+                    if (term->quantityMaxCount == quantifyInfinite)
+                        jump(beginOp.m_reentry);
+                    else {
+                        loadFromFrame(parenthesesFrameLocation + ParenthesesMatchAmount, countTemporary);
+                        branch32(Below, countTemporary, Imm32(term->quantityMaxCount.unsafeGet())).linkTo(beginOp.m_reentry, this);
+                    }
+                }
+
+                op.m_backtrackReentry = label();
+                loadFromFrame(parenthesesFrameLocation + ParenthesesMatchAmount, countTemporary);
+                beginOp.m_jumps.append(branchTest32(Zero, countTemporary));
+                sub32(TrustedImm32(1), countTemporary);
+                storeToFrame(countTemporary, parenthesesFrameLocation + ParenthesesMatchAmount);
+                loadFromFrame(parenthesesFrameLocation + ParenthesesContextHead, parenContextPointer);
+                restoreParenContextFrame(term, parenContextPointer, countTemporary);
+                m_backtrackingState.fallthrough();
+                break;
+            }
+
             // OpParentheticalAssertionBegin/End
             case OpParentheticalAssertionBegin: {
                 PatternTerm* term = op.m_term;
@@ -2319,9 +2856,10 @@ class YarrGenerator : private MacroAssembler {
     // Emits ops for a subpattern (set of parentheses). These consist
     // of a set of alternatives wrapped in an outer set of nodes for
     // the parentheses.
-    // Supported types of parentheses are 'Once' (quantityMaxCount == 1)
-    // and 'Terminal' (non-capturing parentheses quantified as greedy
-    // and infinite).
+    // Supported types of parentheses are 'Once' (quantityMaxCount == 1),
+    // 'Terminal' (non-capturing parentheses quantified as greedy
+    // and infinite), and, where enabled, general parentheses that may
+    // match more than once.
     // Alternatives will use the 'Simple' set of ops if either the
     // subpattern is terminal (in which case we will never need to
     // backtrack), or if the subpattern only contains one alternative.
@@ -2333,17 +2871,17 @@ class YarrGenerator : private MacroAssembler {
         YarrOpCode alternativeNextOpCode = OpSimpleNestedAlternativeNext;
         YarrOpCode alternativeEndOpCode = OpSimpleNestedAlternativeEnd;
 
-        // We can currently only compile quantity 1 subpatterns that are
-        // not copies. We generate a copy in the case of a range quantifier,
-        // e.g. /(?:x){3,9}/, or /(?:x)+/ (These are effectively expanded to
-        // /(?:x){3,3}(?:x){0,6}/ and /(?:x)(?:x)*/ repectively). The problem
-        // comes where the subpattern is capturing, in which case we would
-        // need to restore the capture from the first subpattern upon a
-        // failure in the second.
+        // We generate a copy in the case of a range quantifier, e.g. /(?:x){3,9}/,
+        // or /(?:x)+/ (These are effectively expanded to /(?:x){3,3}(?:x){0,6}/
+        // and /(?:x)(?:x)*/ repectively). The copy is compiled with the general
+        // nodes below, which restore the captures from the first subpattern upon
+        // a failure in the second. A range with a non-zero minimum that has not
+        // been split up like this is not supported.
         if (term->quantityMinCount && term->quantityMinCount != term->quantityMaxCount) {
-            m_shouldFallBack = true;
+            m_failureReason = JITFailureReason::VariableCountedParenthesisWithNonZeroMinimum;
             return;
-        } if (term->quantityMaxCount == 1 && !term->parentheses.isCopy) {
+        }
+        if (term->quantityMaxCount == 1 && !term->parentheses.isCopy) {
             // Select the 'Once' nodes.
             parenthesesBeginOpCode = OpParenthesesSubpatternOnceBegin;
             parenthesesEndOpCode = OpParenthesesSubpatternOnceEnd;
@@ -2359,9 +2897,22 @@ class YarrGenerator : private MacroAssembler {
             parenthesesBeginOpCode = OpParenthesesSubpatternTerminalBegin;
             parenthesesEndOpCode = OpParenthesesSubpatternTerminalEnd;
         } else {
+#if ENABLE(YARR_JIT_ALL_PARENS_EXPRESSIONS)
+            // Select the general nodes, which keep a ParenContext per iteration.
+            parenthesesBeginOpCode = OpParenthesesSubpatternBegin;
+            parenthesesEndOpCode = OpParenthesesSubpatternEnd;
+            m_usesParenContexts = true;
+
+            if (term->parentheses.disjunction->m_alternatives.size() != 1) {
+                alternativeBeginOpCode = OpNestedAlternativeBegin;
+                alternativeNextOpCode = OpNestedAlternativeNext;
+                alternativeEndOpCode = OpNestedAlternativeEnd;
+            }
+#else
             // This subpattern is not supported by the JIT.
-            m_shouldFallBack = true;
+            m_failureReason = JITFailureReason::ParenthesizedSubpattern;
             return;
+#endif
         }
 
         size_t parenBegin = m_ops.size();
@@ -2474,6 +3025,17 @@ class YarrGenerator : private MacroAssembler {
                 opCompileParentheticalAssertion(term);
                 break;
 
+            case PatternTerm::TypeBackReference:
+#if ENABLE(YARR_JIT_BACKREFERENCES)
+                // Case insensitive comparison of 16-bit characters needs the canonicalization tables.
+                if (m_pattern.ignoreCase() && m_charSize != Char8)
+                    m_failureReason = JITFailureReason::BackReference;
+#else
+                m_failureReason = JITFailureReason::BackReference;
+#endif
+                m_ops.append(term);
+                break;
+
             default:
                 m_ops.append(term);
             }
@@ -2642,19 +3204,41 @@ public:
         : m_vm(vm)
         , m_pattern(pattern)
         , m_charSize(charSize)
-        , m_shouldFallBack(false)
+        , m_recordSubpatterns(compileMode == IncludeSubpatterns || pattern.m_containsBackreferences)
     {
     }
 
     void compile(VM* vm, YarrCodeBlock& jitObject)
     {
+        // Build the ops first, since they determine the layout of the frame.
+        opCompileBody(m_pattern.m_body);
+
+        if (m_failureReason) {
+            jitObject.setFallBackWithFailureReason(*m_failureReason);
+            return;
+        }
+
+        layOutCallFrame();
+
         generateEnter();
 
         Jump hasInput = checkInput();
         generateFailReturn();
         hasInput.link(this);
 
-        if (compileMode == IncludeSubpatterns) {
+        initCallFrame();
+
+#if ENABLE(YARR_JIT_ALL_PARENS_EXPRESSIONS)
+        if (m_usesParenContexts)
+            initParenContextArea();
+#endif
+
+        // MatchOnly code for patterns with back-references records the subpatterns
+        // in an output vector of its own, in the frame.
+        if (compileMode == MatchOnly && m_recordSubpatterns)
+            addPtr(TrustedImm32(m_outputFrameLocation * sizeof(void*)), stackPointerRegister, output);
+
+        if (m_recordSubpatterns) {
             for (unsigned i = 0; i < m_pattern.m_numSubpatterns + 1; ++i)
                 store32(TrustedImm32(-1), Address(output, (i << 1) * sizeof(int)));
         }
@@ -2662,21 +3246,13 @@ public:
         if (!m_pattern.m_body->m_hasFixedSize)
             setMatchStart(index);
 
-        initCallFrame();
-
-        opCompileBody(m_pattern.m_body);
-
-        if (m_shouldFallBack) {
-            jitObject.setFallBack(true);
-            return;
-        }
-
         generate();
         backtrack();
+        generateJITFailReturn();
 
         LinkBuffer linkBuffer(*vm, *this, REGEXP_CODE_ID, JITCompilationCanFail);
         if (linkBuffer.didFailToAllocate()) {
-            jitObject.setFallBack(true);
+            jitObject.setFallBackWithFailureReason(JITFailureReason::ExecutableMemoryAllocationFailure);
             return;
         }
 
@@ -2693,7 +3269,8 @@ public:
             else
                 jitObject.set16BitCode(FINALIZE_CODE(linkBuffer, ("16-bit regular expression")));
         }
-        jitObject.setFallBack(m_shouldFallBack);
+        jitObject.setFallBack(false);
+        jitObject.setUsesParenContexts(m_usesParenContexts);
     }
 
 private:
@@ -2705,7 +3282,21 @@ private:
 
     // Used to detect regular expression constructs that are not currently
     // supported in the JIT; fall back to the interpreter when this is detected.
-    bool m_shouldFallBack;
+    std::optional<JITFailureReason> m_failureReason;
+
+    // Set when the code records subpatterns, either because the caller wants
+    // them or because back-references need them.
+    bool m_recordSubpatterns;
+    bool m_usesParenContexts { false };
+
+    // See layOutCallFrame().
+    unsigned m_callFrameSize { 0 };
+    unsigned m_parenContextTopFrameLocation { 0 };
+    unsigned m_parenContextLimitFrameLocation { 0 };
+    unsigned m_outputFrameLocation { 0 };
+
+    // Jumps taken when the ParenContext area is exhausted.
+    JumpList m_abortExecution;
 
     // The regular expression expressed as a linear sequence of operations.
     Vector<YarrOp, 128> m_ops;
@@ -2734,6 +3325,67 @@ void jitCompile(YarrPattern& pattern, YarrCharSize charSize, VM* vm, YarrCodeBlo
         YarrGenerator<IncludeSubpatterns>(vm, pattern, charSize).compile(vm, jitObject);
 }
 
+template<typename CharType>
+MatchResult YarrCodeBlock::executeWithParenContextArea(const MacroAssemblerCodeRef& code, const CharType* input, unsigned start, unsigned length, int* output)
+{
+    static const size_t jitCodeFailure = static_cast<size_t>(JSRegExpJITCodeFailure);
+
+    if (m_parenContextAreaExhausted.load(std::memory_order_relaxed))
+        return MatchResult(jitCodeFailure, 0);
+
+    // Each time the area runs out the match is run again with twice the space, so all the runs
+    // together take at most about twice as long as the last one.
+    uint8_t inlineArea[initialParenContextAreaSize];
+    ParenContextArea parenContextArea(inlineArea, sizeof(inlineArea));
+    MatchResult result = callJITCode(code, input, start, length, output, &parenContextArea);
+    for (size_t size = 2 * initialParenContextAreaSize; result.start == jitCodeFailure && size <= maximumParenContextAreaSize; size *= 2) {
+        void* buffer;
+        if (!tryFastMalloc(size).getValue(buffer))
+            break;
+        ParenContextArea parenContextArea(static_cast<uint8_t*>(buffer), size);
+        result = callJITCode(code, input, start, length, output, &parenContextArea);
+        fastFree(buffer);
+    }
+
+    if (result.start == jitCodeFailure)
+        m_parenContextAreaExhausted.store(true, std::memory_order_relaxed);
+    return result;
+}
+
+template MatchResult YarrCodeBlock::executeWithParenContextArea(const MacroAssemblerCodeRef&, const LChar*, unsigned, unsigned, int*);
+template MatchResult YarrCodeBlock::executeWithParenContextArea(const MacroAssemblerCodeRef&, const UChar*, unsigned, unsigned, int*);
+
 }}
 
+namespace WTF {
+
+using namespace JSC::Yarr;
+
+void printInternal(PrintStream& out, JITFailureReason failureReason)
+{
+    switch (failureReason) {
+    case JITFailureReason::UnicodePattern:
+        out.print("UnicodePattern");
+        return;
+    case JITFailureReason::UnsignedLengthPattern:
+        out.print("UnsignedLengthPattern");
+        return;
+    case JITFailureReason::BackReference:
+        out.print("BackReference");
+        return;
+    case JITFailureReason::VariableCountedParenthesisWithNonZeroMinimum:
+        out.print("VariableCountedParenthesisWithNonZeroMinimum");
+        return;
+    case JITFailureReason::ParenthesizedSubpattern:
+        out.print("ParenthesizedSubpattern");
+        return;
+    case JITFailureReason::ExecutableMemoryAllocationFailure:
+        out.print("ExecutableMemoryAllocationFailure");
+        return;
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+}
+
+} // namespace WTF
+
 #endif
@@ -32,6 +32,7 @@
 #include "MatchResult.h"
 #include "Yarr.h"
 #include "YarrPattern.h"
+#include <atomic>
 
 #if CPU(X86) && !COMPILER(MSVC)
 #define YARR_CALL __attribute__ ((regparm (3)))
@@ -39,6 +40,13 @@
 #define YARR_CALL
 #endif
 
+// Back-references and parentheses that match more than once need more temporary registers
+// than are free on the other targets.
+#if CPU(ARM64) || (CPU(X86_64) && !OS(WINDOWS))
+#define ENABLE_YARR_JIT_ALL_PARENS_EXPRESSIONS 1
+#define ENABLE_YARR_JIT_BACKREFERENCES 1
+#endif
+
 namespace JSC {
 
 class VM;
@@ -46,22 +54,40 @@ class ExecutablePool;
 
 namespace Yarr {
 
-class YarrCodeBlock {
-#if CPU(X86_64) || CPU(ARM64)
-    typedef MatchResult (*YarrJITCode8)(const LChar* input, unsigned start, unsigned length, int* output) YARR_CALL;
-    typedef MatchResult (*YarrJITCode16)(const UChar* input, unsigned start, unsigned length, int* output) YARR_CALL;
-    typedef MatchResult (*YarrJITCodeMatchOnly8)(const LChar* input, unsigned start, unsigned length) YARR_CALL;
-    typedef MatchResult (*YarrJITCodeMatchOnly16)(const UChar* input, unsigned start, unsigned length) YARR_CALL;
-#else
-    typedef EncodedMatchResult (*YarrJITCode8)(const LChar* input, unsigned start, unsigned length, int* output) YARR_CALL;
-    typedef EncodedMatchResult (*YarrJITCode16)(const UChar* input, unsigned start, unsigned length, int* output) YARR_CALL;
-    typedef EncodedMatchResult (*YarrJITCodeMatchOnly8)(const LChar* input, unsigned start, unsigned length) YARR_CALL;
-    typedef EncodedMatchResult (*YarrJITCodeMatchOnly16)(const UChar* input, unsigned start, unsigned length) YARR_CALL;
-#endif
+// Why a pattern is run by the interpreter rather than by JIT code.
+enum class JITFailureReason : uint8_t {
+    UnicodePattern,
+    UnsignedLengthPattern,
+    BackReference,
+    VariableCountedParenthesisWithNonZeroMinimum,
+    ParenthesizedSubpattern,
+    ExecutableMemoryAllocationFailure,
+};
+static const unsigned numberOfJITFailureReasons = static_cast<unsigned>(JITFailureReason::ExecutableMemoryAllocationFailure) + 1;
+
+// The memory that JIT code for parentheses that match more than once allocates a ParenContext
+// from for each iteration. If it runs out the code returns JSRegExpJITCodeFailure.
+class ParenContextArea {
+public:
+    ParenContextArea(uint8_t* begin, size_t size)
+        : m_begin(begin)
+        , m_end(begin + size)
+    {
+    }
+
+    static ptrdiff_t offsetOfBegin() { return OBJECT_OFFSETOF(ParenContextArea, m_begin); }
+    static ptrdiff_t offsetOfEnd() { return OBJECT_OFFSETOF(ParenContextArea, m_end); }
 
+private:
+    uint8_t* m_begin;
+    uint8_t* m_end;
+};
+
+class YarrCodeBlock {
 public:
     YarrCodeBlock()
         : m_needFallBack(false)
+        , m_usesParenContexts(false)
     {
     }
 
@@ -70,7 +96,27 @@ public:
     }
 
     void setFallBack(bool fallback) { m_needFallBack = fallback; }
+    void setFallBackWithFailureReason(JITFailureReason failureReason)
+    {
+        m_needFallBack = true;
+        m_failureReason = failureReason;
+    }
     bool isFallBack() { return m_needFallBack; }
+    JITFailureReason failureReason()
+    {
+        ASSERT(m_needFallBack);
+        return m_failureReason;
+    }
+
+    // Code for parentheses that match more than once keeps per-iteration state in a
+    // ParenContextArea. Matches start with a small area on the stack and are run again with a
+    // bigger one when it runs out. Only if an area of maximumParenContextAreaSize is not enough
+    // does execute() return JSRegExpJITCodeFailure, and the match has to be run by the
+    // interpreter. From then on, so do all matches of the pattern.
+    static const size_t initialParenContextAreaSize = 8 * KB;
+    static const size_t maximumParenContextAreaSize = 64 * MB;
+    void setUsesParenContexts(bool usesParenContexts) { m_usesParenContexts = usesParenContexts; }
+    bool usesParenContexts() { return m_usesParenContexts; }
 
     bool has8BitCode() { return m_ref8.size(); }
     bool has16BitCode() { return m_ref16.size(); }
@@ -85,25 +131,33 @@ public:
     MatchResult execute(const LChar* input, unsigned start, unsigned length, int* output)
     {
         ASSERT(has8BitCode());
-        return MatchResult(reinterpret_cast<YarrJITCode8>(m_ref8.code().executableAddress())(input, start, length, output));
+        if (UNLIKELY(m_usesParenContexts))
+            return executeWithParenContextArea(m_ref8, input, start, length, output);
+        return callJITCode(m_ref8, input, start, length, output, nullptr);
     }
 
     MatchResult execute(const UChar* input, unsigned start, unsigned length, int* output)
     {
         ASSERT(has16BitCode());
-        return MatchResult(reinterpret_cast<YarrJITCode16>(m_ref16.code().executableAddress())(input, start, length, output));
+        if (UNLIKELY(m_usesParenContexts))
+            return executeWithParenContextArea(m_ref16, input, start, length, output);
+        return callJITCode(m_ref16, input, start, length, output, nullptr);
     }
 
     MatchResult execute(const LChar* input, unsigned start, unsigned length)
     {
         ASSERT(has8BitCodeMatchOnly());
-        return MatchResult(reinterpret_cast<YarrJITCodeMatchOnly8>(m_matchOnly8.code().executableAddress())(input, start, length));
+        if (UNLIKELY(m_usesParenContexts))
+            return executeWithParenContextArea(m_matchOnly8, input, start, length, nullptr);
+        return callJITCode(m_matchOnly8, input, start, length, nullptr, nullptr);
     }
 
     MatchResult execute(const UChar* input, unsigned start, unsigned length)
     {
         ASSERT(has16BitCodeMatchOnly());
-        return MatchResult(reinterpret_cast<YarrJITCodeMatchOnly16>(m_matchOnly16.code().executableAddress())(input, start, length));
+        if (UNLIKELY(m_usesParenContexts))
+            return executeWithParenContextArea(m_matchOnly16, input, start, length, nullptr);
+        return callJITCode(m_matchOnly16, input, start, length, nullptr, nullptr);
     }
 
 #if ENABLE(REGEXP_TRACING)
@@ -152,14 +206,35 @@ public:
         m_matchOnly8 = MacroAssemblerCodeRef();
         m_matchOnly16 = MacroAssemblerCodeRef();
         m_needFallBack = false;
+        m_usesParenContexts = false;
+        m_parenContextAreaExhausted = false;
     }
 
 private:
+    // MatchOnly code takes the same arguments, and ignores the output vector.
+    template<typename CharType>
+    static MatchResult callJITCode(const MacroAssemblerCodeRef& code, const CharType* input, unsigned start, unsigned length, int* output, ParenContextArea* parenContextArea)
+    {
+#if CPU(X86_64) || CPU(ARM64)
+        typedef MatchResult (*YarrJITCode)(const CharType* input, unsigned start, unsigned length, int* output, ParenContextArea*) YARR_CALL;
+#else
+        typedef EncodedMatchResult (*YarrJITCode)(const CharType* input, unsigned start, unsigned length, int* output, ParenContextArea*) YARR_CALL;
+#endif
+        return MatchResult(reinterpret_cast<YarrJITCode>(code.code().executableAddress())(input, start, length, output, parenContextArea));
+    }
+
+    template<typename CharType>
+    MatchResult executeWithParenContextArea(const MacroAssemblerCodeRef&, const CharType* input, unsigned start, unsigned length, int* output);
+
     MacroAssemblerCodeRef m_ref8;
     MacroAssemblerCodeRef m_ref16;
     MacroAssemblerCodeRef m_matchOnly8;
     MacroAssemblerCodeRef m_matchOnly16;
     bool m_needFallBack;
+    bool m_usesParenContexts;
+    // Matches may run concurrently with RegExp::matchConcurrently().
+    std::atomic<bool> m_parenContextAreaExhausted { false };
+    JITFailureReason m_failureReason { JITFailureReason::ParenthesizedSubpattern };
 };
 
 enum YarrJITCompileMode {
@@ -170,4 +245,12 @@ void jitCompile(YarrPattern&, YarrCharSize, VM*, YarrCodeBlock& jitObject, YarrJ
 
 } } // namespace JSC::Yarr
 
+namespace WTF {
+
+class PrintStream;
+
+void printInternal(PrintStream&, JSC::Yarr::JITFailureReason);
+
+} // namespace WTF
+
 #endif
@@ -655,12 +655,14 @@ public:
                         return error;
                     term.inputPosition = currentInputPosition.unsafeGet();
                 } else {
+                    // The nested frame follows the parentheses' own backtracking state, so that the JIT
+                    // can save and restore it for each iteration. The interpreter gives each iteration
+                    // a frame of the disjunction's call frame size, so these offsets work there too.
                     term.inputPosition = currentInputPosition.unsafeGet();
-                    unsigned ignoredCallFrameSize;
-                    error = setupDisjunctionOffsets(term.parentheses.disjunction, 0, currentInputPosition.unsafeGet(), ignoredCallFrameSize);
+                    currentCallFrameSize += YarrStackSpaceForBackTrackInfoParentheses;
+                    error = setupDisjunctionOffsets(term.parentheses.disjunction, currentCallFrameSize, currentInputPosition.unsafeGet(), currentCallFrameSize);
                     if (error)
                         return error;
-                    currentCallFrameSize += YarrStackSpaceForBackTrackInfoParentheses;
                 }
                 // Fixed count of 1 could be accepted, if they have a fixed size *AND* if all alternatives are of the same length.
                 alternative->m_hasFixedSize = false;
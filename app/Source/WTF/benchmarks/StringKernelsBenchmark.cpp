@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// On Mac, you can build this like so:
+// clang++ -o StringKernelsBenchmark Source/WTF/benchmarks/StringKernelsBenchmark.cpp -O3 -W -ISource/WTF -LWebKitBuild/Release -lWTF -framework Foundation -licucore -std=c++11
+
+#include "config.h"
+
+#include <string.h>
+#include <wtf/ASCIICType.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/DataLog.h>
+#include <wtf/StdLibExtras.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringKernels.h>
+
+namespace {
+
+unsigned length;
+unsigned iterations;
+
+NO_RETURN void usage()
+{
+    printf("Usage: StringKernelsBenchmark find|equal|ascii|lower|widen|all <length> <iterations>\n");
+    exit(1);
+}
+
+// The loops that the kernels replaced, to compare against. The volatile result keeps the
+// compiler from throwing the work away.
+volatile unsigned sink;
+
+template<typename CharacterType>
+unsigned scalarFind(const CharacterType* characters, unsigned length, CharacterType matchCharacter)
+{
+    for (unsigned i = 0; i < length; ++i) {
+        if (characters[i] == matchCharacter)
+            return i;
+    }
+    return length;
+}
+
+template<typename CharacterType>
+bool scalarEqual(const CharacterType* a, const CharacterType* b, unsigned length)
+{
+    for (unsigned i = 0; i < length; ++i) {
+        if (a[i] != b[i])
+            return false;
+    }
+    return true;
+}
+
+template<typename CharacterType>
+bool scalarIsAllASCII(const CharacterType* characters, unsigned length)
+{
+    unsigned allCharacterBits = 0;
+    for (unsigned i = 0; i < length; ++i)
+        allCharacterBits |= characters[i];
+    return !(allCharacterBits & ~0x7F);
+}
+
+template<typename CharacterType>
+void scalarConvertASCIIToLowercase(CharacterType* destination, const CharacterType* source, unsigned length)
+{
+    for (unsigned i = 0; i < length; ++i)
+        destination[i] = toASCIILower(source[i]);
+}
+
+void scalarWiden(UChar* destination, const LChar* source, unsigned length)
+{
+    for (unsigned i = 0; i < length; ++i)
+        destination[i] = source[i];
+}
+
+template<typename Functor>
+double timeIterations(const Functor& functor)
+{
+    double before = monotonicallyIncreasingTime();
+    for (unsigned i = 0; i < iterations; ++i)
+        functor();
+    double after = monotonicallyIncreasingTime();
+    return after - before;
+}
+
+template<typename ScalarFunctor, typename KernelFunctor>
+void report(const char* name, const char* characterType, const ScalarFunctor& scalar, const KernelFunctor& kernel)
+{
+    double scalarTime = timeIterations(scalar);
+    double kernelTime = timeIterations(kernel);
+    double millionsOfCharacters = static_cast<double>(length) * iterations / 1e6;
+    printf("%s<%s>: scalar %.1lf M chars/s, kernel %.1lf M chars/s, %.2lfx\n", name, characterType, millionsOfCharacters / scalarTime, millionsOfCharacters / kernelTime, scalarTime / kernelTime);
+}
+
+template<typename CharacterType>
+void runBenchmarks(const char* which, const char* characterType)
+{
+    // Lowercase ASCII text, which is the common case for every kernel: find has to scan to the
+    // end, equal has to compare everything, and lowercasing has nothing to change.
+    Vector<CharacterType> text(length);
+    for (unsigned i = 0; i < length; ++i)
+        text[i] = 'a' + i % 26;
+    Vector<CharacterType> copy = text;
+    Vector<CharacterType> destination(length);
+    bool all = !strcmp(which, "all");
+
+    if (all || !strcmp(which, "find")) {
+        report("find", characterType,
+            [&] { sink = scalarFind(text.data(), length, static_cast<CharacterType>('!')); },
+            [&] { sink = WTF::StringKernels::find(text.data(), length, static_cast<CharacterType>('!'), 0); });
+    }
+    if (all || !strcmp(which, "equal")) {
+        report("equal", characterType,
+            [&] { sink = scalarEqual(text.data(), copy.data(), length); },
+            [&] { sink = WTF::StringKernels::equal(text.data(), copy.data(), length); });
+    }
+    if (all || !strcmp(which, "ascii")) {
+        report("isAllASCII", characterType,
+            [&] { sink = scalarIsAllASCII(text.data(), length); },
+            [&] { sink = WTF::StringKernels::isAllASCII(text.data(), length); });
+    }
+    if (all || !strcmp(which, "lower")) {
+        report("convertASCIIToLowercase", characterType,
+            [&] { scalarConvertASCIIToLowercase(destination.data(), text.data(), length); sink = destination[0]; },
+            [&] { WTF::StringKernels::convertASCIIToLowercase(destination.data(), text.data(), length); sink = destination[0]; });
+    }
+}
+
+void runWidenBenchmark()
+{
+    Vector<LChar> source(length);
+    for (unsigned i = 0; i < length; ++i)
+        source[i] = 'a' + i % 26;
+    Vector<UChar> destination(length);
+    report("widen", "LChar",
+        [&] { scalarWiden(destination.data(), source.data(), length); sink = destination[0]; },
+        [&] { WTF::StringKernels::widen(destination.data(), source.data(), length); sink = destination[0]; });
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    if (argc != 4
+        || sscanf(argv[2], "%u", &length) != 1
+        || sscanf(argv[3], "%u", &iterations) != 1)
+        usage();
+
+    const char* which = argv[1];
+    if (strcmp(which, "all") && strcmp(which, "find") && strcmp(which, "equal") && strcmp(which, "ascii") && strcmp(which, "lower") && strcmp(which, "widen"))
+        usage();
+
+    if (!WTF::StringKernels::hasVectorInstructions)
+        dataLog("Note: this CPU has no vector kernels, so both columns measure scalar loops.\n");
+
+    runBenchmarks<LChar>(which, "LChar");
+    runBenchmarks<UChar>(which, "UChar");
+    if (!strcmp(which, "all") || !strcmp(which, "widen"))
+        runWidenBenchmark();
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <wtf/Vector.h>
+
+namespace WTF {
+
+// A stable, adaptive merge sort in the style of TimSort. It finds the ascending and strictly
+// descending runs already present in the input, extends short ones with binary insertion sort,
+// and merges runs of similar length, so input that is mostly sorted, reversed, or made of a few
+// sorted pieces sorts in close to linear time. Before merging two runs, the parts of them that
+// are already in place are skipped by binary search.
+//
+// The comparator may be inconsistent, for instance a user-supplied JavaScript function. That
+// leaves the elements in an unspecified order, but the sort still terminates and never reads or
+// writes outside of the input.
+
+namespace TimSortInternal {
+
+static const size_t minimumMergeLength = 32;
+
+inline size_t minimumRunLength(size_t size)
+{
+    size_t lowBits = 0;
+    while (size >= 2 * minimumMergeLength) {
+        lowBits |= size & 1;
+        size >>= 1;
+    }
+    return size + lowBits;
+}
+
+// Returns the length of the run starting at begin, reversing it first if it is descending.
+template<typename T, typename LessThan>
+size_t makeAscendingRun(T* begin, T* end, const LessThan& lessThan)
+{
+    T* runEnd = begin + 1;
+    if (runEnd == end)
+        return 1;
+
+    // Only strictly descending runs are reversed, which keeps the sort stable.
+    if (lessThan(*runEnd++, *begin)) {
+        while (runEnd < end && lessThan(*runEnd, *(runEnd - 1)))
+            ++runEnd;
+        std::reverse(begin, runEnd);
+    } else {
+        while (runEnd < end && !lessThan(*runEnd, *(runEnd - 1)))
+            ++runEnd;
+    }
+    return runEnd - begin;
+}
+
+// [begin, sortedEnd) is sorted. Inserts each following element into place.
+template<typename T, typename LessThan>
+void binaryInsertionSort(T* begin, T* sortedEnd, T* end, const LessThan& lessThan)
+{
+    for (T* current = sortedEnd; current < end; ++current) {
+        T* position = std::upper_bound(begin, current, *current, lessThan);
+        if (position == current)
+            continue;
+        T pivot = WTFMove(*current);
+        std::move_backward(position, current, current + 1);
+        *position = WTFMove(pivot);
+    }
+}
+
+template<typename T, typename LessThan>
+class TimSorter {
+public:
+    TimSorter(T* data, const LessThan& lessThan)
+        : m_data(data)
+        , m_lessThan(lessThan)
+    {
+    }
+
+    void sort(size_t size)
+    {
+        size_t minimumRun = minimumRunLength(size);
+        size_t begin = 0;
+        while (begin < size) {
+            size_t runLength = makeAscendingRun(m_data + begin, m_data + size, m_lessThan);
+            if (runLength < minimumRun) {
+                size_t forcedLength = std::min(minimumRun, size - begin);
+                binaryInsertionSort(m_data + begin, m_data + begin + runLength, m_data + begin + forcedLength, m_lessThan);
+                runLength = forcedLength;
+            }
+            m_runs.append(Run { begin, runLength });
+            mergeCollapse();
+            begin += runLength;
+        }
+
+        while (m_runs.size() > 1)
+            mergeAt(m_runs.size() - 2);
+    }
+
+private:
+    struct Run {
+        size_t begin;
+        size_t length;
+    };
+
+    // Keeps the run lengths on the stack growing at least as fast as the Fibonacci numbers, which
+    // bounds the stack depth and keeps merges balanced. This is the corrected form of the
+    // invariant check, which also looks at the fourth run from the top.
+    void mergeCollapse()
+    {
+        while (m_runs.size() > 1) {
+            size_t index = m_runs.size() - 2;
+            if ((index > 0 && m_runs[index - 1].length <= m_runs[index].length + m_runs[index + 1].length)
+                || (index > 1 && m_runs[index - 2].length <= m_runs[index - 1].length + m_runs[index].length)) {
+                if (m_runs[index - 1].length < m_runs[index + 1].length)
+                    --index;
+            } else if (m_runs[index].length > m_runs[index + 1].length)
+                break;
+            mergeAt(index);
+        }
+    }
+
+    void mergeAt(size_t index)
+    {
+        T* left = m_data + m_runs[index].begin;
+        size_t leftLength = m_runs[index].length;
+        T* right = m_data + m_runs[index + 1].begin;
+        size_t rightLength = m_runs[index + 1].length;
+
+        m_runs[index].length += rightLength;
+        m_runs.remove(index + 1);
+
+        // Elements of the left run that are not greater than the first element of the right run
+        // are already in place, as are elements of the right run that are not less than the last
+        // element of the left run.
+        T* leftStart = std::upper_bound(left, left + leftLength, *right, m_lessThan);
+        leftLength -= leftStart - left;
+        left = leftStart;
+        if (!leftLength)
+            return;
+        rightLength = std::lower_bound(right, right + rightLength, left[leftLength - 1], m_lessThan) - right;
+        if (!rightLength)
+            return;
+
+        if (leftLength <= rightLength)
+            mergeLow(left, leftLength, right, rightLength);
+        else
+            mergeHigh(left, leftLength, right, rightLength);
+    }
+
+    // Moves the left run aside and merges from the front.
+    void mergeLow(T* left, size_t leftLength, T* right, size_t rightLength)
+    {
+        m_buffer.clear();
+        m_buffer.reserveCapacity(leftLength);
+        for (size_t i = 0; i < leftLength; ++i)
+            m_buffer.uncheckedAppend(WTFMove(left[i]));
+
+        T* destination = left;
+        T* buffer = m_buffer.data();
+        T* bufferEnd = buffer + leftLength;
+        T* rightEnd = right + rightLength;
+        while (buffer < bufferEnd && right < rightEnd) {
+            if (m_lessThan(*right, *buffer))
+                *destination++ = WTFMove(*right++);
+            else
+                *destination++ = WTFMove(*buffer++);
+        }
+        while (buffer < bufferEnd)
+            *destination++ = WTFMove(*buffer++);
+    }
+
+    // Moves the right run aside and merges from the back.
+    void mergeHigh(T* left, size_t leftLength, T* right, size_t rightLength)
+    {
+        m_buffer.clear();
+        m_buffer.reserveCapacity(rightLength);
+        for (size_t i = 0; i < rightLength; ++i)
+            m_buffer.uncheckedAppend(WTFMove(right[i]));
+
+        T* destination = right + rightLength;
+        T* leftEnd = left + leftLength;
+        T* bufferBegin = m_buffer.data();
+        T* bufferEnd = bufferBegin + rightLength;
+        while (bufferEnd > bufferBegin && leftEnd > left) {
+            if (m_lessThan(*(bufferEnd - 1), *(leftEnd - 1)))
+                *--destination = WTFMove(*--leftEnd);
+            else
+                *--destination = WTFMove(*--bufferEnd);
+        }
+        while (bufferEnd > bufferBegin)
+            *--destination = WTFMove(*--bufferEnd);
+    }
+
+    T* m_data;
+    const LessThan& m_lessThan;
+    Vector<Run, 64> m_runs;
+    Vector<T> m_buffer;
+};
+
+} // namespace TimSortInternal
+
+template<typename T, typename LessThan>
+void timSort(T* data, size_t size, const LessThan& lessThan)
+{
+    if (size < 2)
+        return;
+
+    if (size < 2 * TimSortInternal::minimumMergeLength) {
+        size_t runLength = TimSortInternal::makeAscendingRun(data, data + size, lessThan);
+        TimSortInternal::binaryInsertionSort(data, data + runLength, data + size, lessThan);
+        return;
+    }
+
+    TimSortInternal::TimSorter<T, LessThan>(data, lessThan).sort(size);
+}
+
+} // namespace WTF
+
+using WTF::timSort;
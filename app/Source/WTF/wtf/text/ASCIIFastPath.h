@@ -27,6 +27,7 @@
 #include "/home/c/Downloads/icu/source/common/unicode/utypes.h"
 #include <wtf/StdLibExtras.h>
 #include <wtf/text/LChar.h>
+#include <wtf/text/StringKernels.h>
 
 #if CPU(X86_SSE2)
 #include <emmintrin.h>
@@ -81,6 +82,9 @@ inline bool isAllASCII(MachineWord word)
 template<typename CharacterType>
 inline bool charactersAreAllASCII(const CharacterType* characters, size_t length)
 {
+    if (StringKernels::hasVectorInstructions)
+        return StringKernels::isAllASCII(characters, length);
+
     MachineWord allCharBits = 0;
     const CharacterType* end = characters + length;
 
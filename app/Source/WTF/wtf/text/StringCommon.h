@@ -29,6 +29,7 @@
 #include "/home/c/Downloads/icu/source/common/unicode/uchar.h"
 //#include <unicode/uchar.h>
 #include <wtf/ASCIICType.h>
+#include <wtf/text/StringKernels.h>
 
 namespace WTF {
 
@@ -55,10 +56,14 @@ inline T loadUnaligned(const char* s)
 #endif
 }
 
-// Do comparisons 8 or 4 bytes-at-a-time on architectures where it's safe.
+// Do comparisons 8 or 4 bytes-at-a-time on architectures where it's safe. Strings of at least
+// one vector are compared a vector at a time.
 #if (CPU(X86_64) || CPU(ARM64)) && !ASAN_ENABLED
 ALWAYS_INLINE bool equal(const LChar* aLChar, const LChar* bLChar, unsigned length)
 {
+    if (length >= StringKernels::vectorSize)
+        return StringKernels::equal(aLChar, bLChar, length);
+
     unsigned dwordLength = length >> 3;
 
     const char* a = reinterpret_cast<const char*>(aLChar);
@@ -98,6 +103,9 @@ ALWAYS_INLINE bool equal(const LChar* aLChar, const LChar* bLChar, unsigned leng
 
 ALWAYS_INLINE bool equal(const UChar* aUChar, const UChar* bUChar, unsigned length)
 {
+    if (length >= StringKernels::vectorSize / sizeof(UChar))
+        return StringKernels::equal(aUChar, bUChar, length);
+
     unsigned dwordLength = length >> 2;
 
     const char* a = reinterpret_cast<const char*>(aUChar);
@@ -532,12 +540,10 @@ ALWAYS_INLINE static size_t findInner(const SearchCharacterType* searchCharacter
 template<typename CharacterType>
 inline size_t find(const CharacterType* characters, unsigned length, CharacterType matchCharacter, unsigned index = 0)
 {
-    while (index < length) {
-        if (characters[index] == matchCharacter)
-            return index;
-        ++index;
-    }
-    return notFound;
+    if (index >= length)
+        return notFound;
+    unsigned result = StringKernels::find(characters, length, matchCharacter, index);
+    return result == length ? notFound : result;
 }
 
 ALWAYS_INLINE size_t find(const UChar* characters, unsigned length, LChar matchCharacter, unsigned index = 0)
@@ -368,36 +368,23 @@ Ref<StringImpl> StringImpl::convertToLowercaseWithoutLocale()
 
     // First scan the string for uppercase and non-ASCII characters:
     if (is8Bit()) {
-        for (unsigned i = 0; i < m_length; ++i) {
-            LChar character = m_data8[i];
-            if (UNLIKELY((character & ~0x7F) || isASCIIUpper(character)))
-                return convertToLowercaseWithoutLocaleStartingAtFailingIndex8Bit(i);
-        }
+        unsigned failingIndex = StringKernels::findASCIIUpperOrNonASCII(m_data8, m_length);
+        if (UNLIKELY(failingIndex != m_length))
+            return convertToLowercaseWithoutLocaleStartingAtFailingIndex8Bit(failingIndex);
 
         return *this;
     }
 
-    bool noUpper = true;
-    unsigned ored = 0;
-
-    for (unsigned i = 0; i < m_length; ++i) {
-        UChar character = m_data16[i];
-        if (UNLIKELY(isASCIIUpper(character)))
-            noUpper = false;
-        ored |= character;
-    }
+    unsigned failingIndex = StringKernels::findASCIIUpperOrNonASCII(m_data16, m_length);
     // Nothing to do if the string is all ASCII with no uppercase.
-    if (noUpper && !(ored & ~0x7F))
+    if (failingIndex == m_length)
         return *this;
 
-    if (!(ored & ~0x7F)) {
+    if (StringKernels::isAllASCII(m_data16 + failingIndex, m_length - failingIndex)) {
         UChar* data16;
         auto newImpl = createUninitializedInternalNonEmpty(m_length, data16);
-        
-        for (unsigned i = 0; i < m_length; ++i) {
-            UChar c = m_data16[i];
-            data16[i] = toASCIILower(c);
-        }
+        copyChars(data16, m_data16, failingIndex);
+        StringKernels::convertASCIIToLowercase(data16 + failingIndex, m_data16 + failingIndex, m_length - failingIndex);
         return newImpl;
     }
 
@@ -433,6 +420,11 @@ Ref<StringImpl> StringImpl::convertToLowercaseWithoutLocaleStartingAtFailingInde
         data8[i] = m_data8[i];
     }
 
+    if (StringKernels::isAllASCII(m_data8 + failingIndex, m_length - failingIndex)) {
+        StringKernels::convertASCIIToLowercase(data8 + failingIndex, m_data8 + failingIndex, m_length - failingIndex);
+        return newImpl;
+    }
+
     for (unsigned i = failingIndex; i < m_length; ++i) {
         LChar character = m_data8[i];
         if (!(character & ~0x7F))
@@ -612,8 +612,7 @@ public:
 
     ALWAYS_INLINE static void copyChars(UChar* destination, const LChar* source, unsigned numCharacters)
     {
-        for (unsigned i = 0; i < numCharacters; ++i)
-            destination[i] = source[i];
+        StringKernels::widen(destination, source, numCharacters);
     }
 
     // Some string features, like refcounting and the atomicity flag, are not
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <string.h>
+#include <wtf/ASCIICType.h>
+#include <wtf/text/LChar.h>
+
+#if CPU(X86_SSE2)
+#include <emmintrin.h>
+#define WTF_STRING_KERNELS_USE_SIMD 1
+#elif CPU(ARM64) && COMPILER(GCC_OR_CLANG)
+#include <arm_neon.h>
+#define WTF_STRING_KERNELS_USE_SIMD 1
+#endif
+
+namespace WTF {
+
+// Vector versions of the inner loops of string searching, comparison, lowercasing, ASCII
+// validation and 8-to-16-bit copying. They process 16 bytes at a time with SSE2 on x86 and NEON
+// on ARM64, which every CPU of those architectures has, and fall back to plain loops elsewhere.
+// Each kernel works for both LChar and UChar, and handles any length.
+namespace StringKernels {
+
+static const unsigned vectorSize = 16;
+
+#if WTF_STRING_KERNELS_USE_SIMD
+static const bool hasVectorInstructions = true;
+#else
+static const bool hasVectorInstructions = false;
+#endif
+
+#if WTF_STRING_KERNELS_USE_SIMD
+
+#if CPU(X86_SSE2)
+
+typedef __m128i SIMDVector;
+
+inline SIMDVector load(const void* pointer) { return _mm_loadu_si128(static_cast<const __m128i*>(pointer)); }
+inline void store(void* pointer, SIMDVector vector) { _mm_storeu_si128(static_cast<__m128i*>(pointer), vector); }
+inline SIMDVector bitOr(SIMDVector a, SIMDVector b) { return _mm_or_si128(a, b); }
+inline SIMDVector bitAnd(SIMDVector a, SIMDVector b) { return _mm_and_si128(a, b); }
+
+// Lane masks are all ones in the lanes where the condition holds.
+inline bool anyLane(SIMDVector mask) { return _mm_movemask_epi8(mask); }
+inline bool allLanes(SIMDVector mask) { return _mm_movemask_epi8(mask) == 0xFFFF; }
+
+template<size_t characterSize> struct Lanes;
+
+template<> struct Lanes<1> {
+    static SIMDVector splat(unsigned value) { return _mm_set1_epi8(static_cast<char>(value)); }
+    static SIMDVector equal(SIMDVector a, SIMDVector b) { return _mm_cmpeq_epi8(a, b); }
+    // Bytes of 0x80 and above are negative as signed bytes.
+    static SIMDVector nonASCII(SIMDVector vector) { return _mm_cmplt_epi8(vector, _mm_setzero_si128()); }
+    static SIMDVector asciiUpper(SIMDVector vector) { return _mm_and_si128(_mm_cmpgt_epi8(vector, splat('A' - 1)), _mm_cmplt_epi8(vector, splat('Z' + 1))); }
+};
+
+template<> struct Lanes<2> {
+    static SIMDVector splat(unsigned value) { return _mm_set1_epi16(static_cast<short>(value)); }
+    static SIMDVector equal(SIMDVector a, SIMDVector b) { return _mm_cmpeq_epi16(a, b); }
+    static SIMDVector nonASCII(SIMDVector vector)
+    {
+        SIMDVector isASCII = _mm_cmpeq_epi16(_mm_and_si128(vector, splat(0xFF80)), _mm_setzero_si128());
+        return _mm_xor_si128(isASCII, _mm_set1_epi32(-1));
+    }
+    static SIMDVector asciiUpper(SIMDVector vector) { return _mm_and_si128(_mm_cmpgt_epi16(vector, splat('A' - 1)), _mm_cmplt_epi16(vector, splat('Z' + 1))); }
+};
+
+template<typename WideCharacterType>
+inline void widenBlock(WideCharacterType* destination, const LChar* source)
+{
+    SIMDVector characters = load(source);
+    store(destination, _mm_unpacklo_epi8(characters, _mm_setzero_si128()));
+    store(destination + 8, _mm_unpackhi_epi8(characters, _mm_setzero_si128()));
+}
+
+#else // CPU(ARM64)
+
+typedef uint8x16_t SIMDVector;
+
+inline SIMDVector load(const void* pointer) { return vld1q_u8(static_cast<const uint8_t*>(pointer)); }
+inline void store(void* pointer, SIMDVector vector) { vst1q_u8(static_cast<uint8_t*>(pointer), vector); }
+inline SIMDVector bitOr(SIMDVector a, SIMDVector b) { return vorrq_u8(a, b); }
+inline SIMDVector bitAnd(SIMDVector a, SIMDVector b) { return vandq_u8(a, b); }
+
+inline bool anyLane(SIMDVector mask) { return vmaxvq_u8(mask); }
+inline bool allLanes(SIMDVector mask) { return vminvq_u8(mask) == 0xFF; }
+
+template<size_t characterSize> struct Lanes;
+
+template<> struct Lanes<1> {
+    static SIMDVector splat(unsigned value) { return vdupq_n_u8(static_cast<uint8_t>(value)); }
+    static SIMDVector equal(SIMDVector a, SIMDVector b) { return vceqq_u8(a, b); }
+    static SIMDVector nonASCII(SIMDVector vector) { return vcgeq_u8(vector, splat(0x80)); }
+    static SIMDVector asciiUpper(SIMDVector vector) { return vandq_u8(vcgeq_u8(vector, splat('A')), vcleq_u8(vector, splat('Z'))); }
+};
+
+template<> struct Lanes<2> {
+    static uint16x8_t wide(SIMDVector vector) { return vreinterpretq_u16_u8(vector); }
+    static SIMDVector narrow(uint16x8_t vector) { return vreinterpretq_u8_u16(vector); }
+
+    static SIMDVector splat(unsigned value) { return narrow(vdupq_n_u16(static_cast<uint16_t>(value))); }
+    static SIMDVector equal(SIMDVector a, SIMDVector b) { return narrow(vceqq_u16(wide(a), wide(b))); }
+    static SIMDVector nonASCII(SIMDVector vector) { return narrow(vcgeq_u16(wide(vector), vdupq_n_u16(0x80))); }
+    static SIMDVector asciiUpper(SIMDVector vector) { return narrow(vandq_u16(vcgeq_u16(wide(vector), vdupq_n_u16('A')), vcleq_u16(wide(vector), vdupq_n_u16('Z')))); }
+};
+
+template<typename WideCharacterType>
+inline void widenBlock(WideCharacterType* destination, const LChar* source)
+{
+    SIMDVector characters = load(source);
+    store(destination, vreinterpretq_u8_u16(vmovl_u8(vget_low_u8(characters))));
+    store(destination + 8, vreinterpretq_u8_u16(vmovl_high_u8(characters)));
+}
+
+#endif
+
+#endif // WTF_STRING_KERNELS_USE_SIMD
+
+// Returns the index of the first matchCharacter at or after index, or length if there is none.
+template<typename CharacterType>
+inline unsigned find(const CharacterType* characters, unsigned length, CharacterType matchCharacter, unsigned index)
+{
+#if WTF_STRING_KERNELS_USE_SIMD
+    const unsigned stride = vectorSize / sizeof(CharacterType);
+    SIMDVector target = Lanes<sizeof(CharacterType)>::splat(matchCharacter);
+    for (; index + stride <= length; index += stride) {
+        if (anyLane(Lanes<sizeof(CharacterType)>::equal(load(characters + index), target)))
+            break;
+    }
+#endif
+    for (; index < length; ++index) {
+        if (characters[index] == matchCharacter)
+            return index;
+    }
+    return length;
+}
+
+template<typename CharacterType>
+inline bool equal(const CharacterType* a, const CharacterType* b, unsigned length)
+{
+#if WTF_STRING_KERNELS_USE_SIMD
+    const unsigned stride = vectorSize / sizeof(CharacterType);
+    if (length >= stride) {
+        unsigned index = 0;
+        for (; index + stride <= length; index += stride) {
+            if (!allLanes(Lanes<1>::equal(load(a + index), load(b + index))))
+                return false;
+        }
+        if (index == length)
+            return true;
+        // Finish with a block that overlaps the last one.
+        return allLanes(Lanes<1>::equal(load(a + length - stride), load(b + length - stride)));
+    }
+#endif
+    return !memcmp(a, b, length * sizeof(CharacterType));
+}
+
+template<typename CharacterType>
+inline bool isAllASCII(const CharacterType* characters, size_t length)
+{
+    size_t index = 0;
+#if WTF_STRING_KERNELS_USE_SIMD
+    const size_t stride = vectorSize / sizeof(CharacterType);
+    SIMDVector allCharacterBits = Lanes<sizeof(CharacterType)>::splat(0);
+    for (; index + stride <= length; index += stride)
+        allCharacterBits = bitOr(allCharacterBits, load(characters + index));
+    if (anyLane(Lanes<sizeof(CharacterType)>::nonASCII(allCharacterBits)))
+        return false;
+#endif
+    unsigned allCharacterBitsInTail = 0;
+    for (; index < length; ++index)
+        allCharacterBitsInTail |= characters[index];
+    return !(allCharacterBitsInTail & ~0x7F);
+}
+
+// Returns the index of the first character that lowercasing would change, or that is not
+// ASCII, or length if there is none.
+template<typename CharacterType>
+inline unsigned findASCIIUpperOrNonASCII(const CharacterType* characters, unsigned length)
+{
+    unsigned index = 0;
+#if WTF_STRING_KERNELS_USE_SIMD
+    const unsigned stride = vectorSize / sizeof(CharacterType);
+    for (; index + stride <= length; index += stride) {
+        SIMDVector block = load(characters + index);
+        if (anyLane(bitOr(Lanes<sizeof(CharacterType)>::nonASCII(block), Lanes<sizeof(CharacterType)>::asciiUpper(block))))
+            break;
+    }
+#endif
+    for (; index < length; ++index) {
+        CharacterType character = characters[index];
+        if ((character & ~0x7F) || isASCIIUpper(character))
+            return index;
+    }
+    return length;
+}
+
+// Lowercases ASCII letters and copies every other character unchanged.
+template<typename CharacterType>
+inline void convertASCIIToLowercase(CharacterType* destination, const CharacterType* source, unsigned length)
+{
+    unsigned index = 0;
+#if WTF_STRING_KERNELS_USE_SIMD
+    const unsigned stride = vectorSize / sizeof(CharacterType);
+    SIMDVector caseBit = Lanes<sizeof(CharacterType)>::splat(0x20);
+    for (; index + stride <= length; index += stride) {
+        SIMDVector block = load(source + index);
+        store(destination + index, bitOr(block, bitAnd(Lanes<sizeof(CharacterType)>::asciiUpper(block), caseBit)));
+    }
+#endif
+    for (; index < length; ++index)
+        destination[index] = toASCIILower(source[index]);
+}
+
+template<typename WideCharacterType>
+inline void widen(WideCharacterType* destination, const LChar* source, unsigned length)
+{
+    static_assert(sizeof(WideCharacterType) == 2, "Widening is from LChar to UChar");
+    unsigned index = 0;
+#if WTF_STRING_KERNELS_USE_SIMD
+    for (; index + vectorSize <= length; index += vectorSize)
+        widenBlock(destination + index, source + index);
+#endif
+    for (; index < length; ++index)
+        destination[index] = source[index];
+}
+
+} // namespace StringKernels
+
+} // namespace WTF
+
+#undef WTF_STRING_KERNELS_USE_SIMD
@@ -0,0 +1,4 @@
+#ifndef WebCore_FWD_CachedBytecode_h
+#define WebCore_FWD_CachedBytecode_h
+#include <JavaScriptCore/CachedBytecode.h>
+#endif
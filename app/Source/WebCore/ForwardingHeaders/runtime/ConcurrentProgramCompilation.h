@@ -0,0 +1,4 @@
+#ifndef WebCore_FWD_ConcurrentProgramCompilation_h
+#define WebCore_FWD_ConcurrentProgramCompilation_h
+#include <JavaScriptCore/ConcurrentProgramCompilation.h>
+#endif
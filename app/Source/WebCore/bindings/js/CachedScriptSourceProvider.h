@@ -47,6 +47,10 @@ public:
     unsigned hash() const override { return m_cachedScript->scriptHash(); }
     StringView source() const override { return m_cachedScript->script(); }
 
+    bool supportsCachedBytecode() const override { return true; }
+    RefPtr<JSC::CachedBytecode> cachedBytecode() const override { return m_cachedScript->cachedBytecode(); }
+    void updateCachedBytecode(Ref<JSC::CachedBytecode>&& cachedBytecode) override { m_cachedScript->setCachedBytecode(WTFMove(cachedBytecode)); }
+
 private:
     CachedScriptSourceProvider(CachedScript* cachedScript, JSC::SourceProviderSourceType sourceType, Ref<CachedScriptFetcher>&& scriptFetcher)
         : SourceProvider(JSC::SourceOrigin { cachedScript->response().url(), WTFMove(scriptFetcher) }, cachedScript->response().url(), TextPosition(), sourceType)
@@ -31,6 +31,7 @@
 
 #include "Chrome.h"
 #include "ChromeClient.h"
+#include "FileSystem.h"
 #include "HTMLAnchorElement.h"
 #include "HTMLAudioElement.h"
 #include "HTMLBRElement.h"
@@ -44,6 +45,7 @@
 #include "MathMLElement.h"
 #include "MediaQueryEvaluator.h"
 #include "Page.h"
+#include "PrecompiledStyleSheet.h"
 #include "RenderTheme.h"
 #include "RuleSet.h"
 #include "RuntimeEnabledFeatures.h"
@@ -51,6 +53,8 @@
 #include "StyleSheetContents.h"
 #include "UserAgentStyleSheets.h"
 #include <wtf/NeverDestroyed.h>
+#include <wtf/ProcessID.h>
+#include <wtf/text/StringConcatenate.h>
 
 namespace WebCore {
 
@@ -94,10 +98,65 @@ static const MediaQueryEvaluator& printEval()
     return staticPrintEval;
 }
 
+static String& precompiledStyleSheetDirectory()
+{
+    static NeverDestroyed<String> precompiledStyleSheetDirectory;
+    return precompiledStyleSheetDirectory;
+}
+
+void CSSDefaultStyleSheets::setPrecompiledStyleSheetDirectory(const String& path)
+{
+    precompiledStyleSheetDirectory() = path;
+}
+
+static RefPtr<StyleSheetContents> loadPrecompiledUASheet(const String& path, const String& sourceText)
+{
+    bool success;
+    MappedFileData mappedFile(path, success);
+    if (!success || !mappedFile)
+        return nullptr;
+    return decodePrecompiledStyleSheet(static_cast<const uint8_t*>(mappedFile.data()), mappedFile.size(), sourceText);
+}
+
+static void savePrecompiledUASheet(const String& path, const StyleSheetContents& sheet, const String& sourceText)
+{
+    Vector<uint8_t> data = encodePrecompiledStyleSheet(sheet, sourceText);
+    if (data.isEmpty())
+        return;
+
+    // Write to a temporary file first and rename it into place, so other processes never map a partially written sheet.
+    String temporaryPath = makeString(path, ".tmp.", String::number(getCurrentProcessID()));
+    PlatformFileHandle handle = openFile(temporaryPath, OpenForWrite);
+    if (!isHandleValid(handle))
+        return;
+    bool success = writeToFile(handle, reinterpret_cast<const char*>(data.data()), data.size()) == static_cast<int>(data.size());
+    closeFile(handle);
+    if (!success || !moveFile(temporaryPath, path))
+        deleteFile(temporaryPath);
+}
+
+String CSSDefaultStyleSheets::userAgentStyleSheetSourceForTesting(const String& name)
+{
+    if (name == "html")
+        return String(htmlUserAgentStyleSheet, sizeof(htmlUserAgentStyleSheet));
+    if (name == "quirks")
+        return String(quirksUserAgentStyleSheet, sizeof(quirksUserAgentStyleSheet));
+    return String();
+}
+
 static StyleSheetContents* parseUASheet(const String& str)
 {
+    const String& directory = precompiledStyleSheetDirectory();
+    String precompiledPath = directory.isEmpty() ? String() : pathByAppendingComponent(directory, precompiledStyleSheetFileName(str));
+    if (!precompiledPath.isNull()) {
+        if (auto precompiledSheet = loadPrecompiledUASheet(precompiledPath, str))
+            return &precompiledSheet.releaseNonNull().leakRef(); // leak the sheet on purpose
+    }
+
     StyleSheetContents& sheet = StyleSheetContents::create(CSSParserContext(UASheetMode)).leakRef(); // leak the sheet on purpose
     sheet.parseString(str);
+    if (!precompiledPath.isNull())
+        savePrecompiledUASheet(precompiledPath, sheet, str);
     return &sheet;
 }
 
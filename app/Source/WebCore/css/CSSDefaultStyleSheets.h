@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <wtf/Forward.h>
+
 namespace WebCore {
 
 class Element;
@@ -49,6 +51,13 @@ public:
     static void loadFullDefaultStyle();
     static void loadSimpleDefaultStyle();
     static void initDefaultStyle(const Element*);
+
+    // When set, each sheet is parsed once and stored in this directory in a binary form, which
+    // later processes map read-only and decode instead of parsing the sheet again.
+    WEBCORE_EXPORT static void setPrecompiledStyleSheetDirectory(const String&);
+
+    // The source of html.css or quirks.css, without the rules the theme adds. Null for any other name.
+    WEBCORE_EXPORT static String userAgentStyleSheetSourceForTesting(const String& name);
 };
 
 } // namespace WebCore
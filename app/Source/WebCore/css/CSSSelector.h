@@ -327,6 +327,8 @@ namespace WebCore {
         bool isForPage() const { return m_isForPage; }
         void setForPage() { m_isForPage = true; }
 
+        bool tagIsForNamespaceRule() const { return m_tagIsForNamespaceRule; }
+
     private:
         unsigned m_relation              : 4; // enum RelationType.
         mutable unsigned m_match         : 4; // enum Match.
@@ -118,22 +118,33 @@ void DocumentRuleSets::collectFeatures() const
     m_siblingRuleSet = makeRuleSet(m_features.siblingRules);
     m_uncommonAttributeRuleSet = makeRuleSet(m_features.uncommonAttributeRules);
 
+    m_ancestorIdRuleSets.clear();
     m_ancestorClassRuleSets.clear();
     m_ancestorAttributeRuleSetsForHTML.clear();
 
     m_features.shrinkToFit();
 }
 
-RuleSet* DocumentRuleSets::ancestorClassRules(AtomicStringImpl* className) const
+static RuleSet* ensureInvalidationRuleSet(HashMap<AtomicStringImpl*, std::unique_ptr<RuleSet>>& ruleSets, const RuleFeatureSet::RuleFeatureMap& ruleFeatures, AtomicStringImpl* key)
 {
-    auto addResult = m_ancestorClassRuleSets.add(className, nullptr);
+    auto addResult = ruleSets.add(key, nullptr);
     if (addResult.isNewEntry) {
-        if (auto* rules = m_features.ancestorClassRules.get(className))
+        if (auto* rules = ruleFeatures.get(key))
             addResult.iterator->value = makeRuleSet(*rules);
     }
     return addResult.iterator->value.get();
 }
 
+RuleSet* DocumentRuleSets::ancestorIdRules(AtomicStringImpl* id) const
+{
+    return ensureInvalidationRuleSet(m_ancestorIdRuleSets, m_features.ancestorIdRules, id);
+}
+
+RuleSet* DocumentRuleSets::ancestorClassRules(AtomicStringImpl* className) const
+{
+    return ensureInvalidationRuleSet(m_ancestorClassRuleSets, m_features.ancestorClassRules, className);
+}
+
 const DocumentRuleSets::AttributeRules* DocumentRuleSets::ancestorAttributeRulesForHTML(AtomicStringImpl* attributeName) const
 {
     auto addResult = m_ancestorAttributeRuleSetsForHTML.add(attributeName, nullptr);
@@ -118,6 +118,12 @@ inline void ElementRuleCollector::addMatchedRule(const RuleData& ruleData, unsig
     m_matchedRules.append({ &ruleData, specificity, styleScopeOrdinal });
 }
 
+void ElementRuleCollector::addCollectedRules(const Vector<MatchedRule>& rules, StyleResolver::RuleRange& ruleRange)
+{
+    for (auto& matchedRule : rules)
+        addMatchedRule(*matchedRule.ruleData, matchedRule.specificity, matchedRule.styleScopeOrdinal, ruleRange);
+}
+
 void ElementRuleCollector::clearMatchedRules()
 {
     m_matchedRules.clear();
@@ -204,6 +210,14 @@ void ElementRuleCollector::matchAuthorRules(bool includeEmptyRules)
     m_result.ranges.lastAuthorRule = m_result.matchedProperties().size() - 1;
     StyleResolver::RuleRange ruleRange = m_result.ranges.authorRuleRange();
 
+    if (m_collectedRules) {
+        ASSERT(!m_regionForStyling);
+        ASSERT(!m_element.shadowRoot() && !m_element.isInShadowTree());
+        addCollectedRules(m_collectedRules->authorRules, ruleRange);
+        sortAndTransferMatchedRules();
+        return;
+    }
+
     {
         MatchRequest matchRequest(&m_authorStyle, includeEmptyRules);
         collectMatchingRules(matchRequest, ruleRange);
@@ -325,8 +339,12 @@ void ElementRuleCollector::matchUserRules(bool includeEmptyRules)
     m_result.ranges.lastUserRule = m_result.matchedProperties().size() - 1;
     MatchRequest matchRequest(m_userStyle, includeEmptyRules);
     StyleResolver::RuleRange ruleRange = m_result.ranges.userRuleRange();
-    collectMatchingRules(matchRequest, ruleRange);
-    collectMatchingRulesForRegion(matchRequest, ruleRange);
+    if (m_collectedRules)
+        addCollectedRules(m_collectedRules->userRules, ruleRange);
+    else {
+        collectMatchingRules(matchRequest, ruleRange);
+        collectMatchingRulesForRegion(matchRequest, ruleRange);
+    }
 
     sortAndTransferMatchedRules();
 }
@@ -338,20 +356,23 @@ void ElementRuleCollector::matchUARules()
         m_result.isCacheable = false;
     RuleSet* userAgentStyleSheet = m_isPrintStyle
         ? CSSDefaultStyleSheets::defaultPrintStyle : CSSDefaultStyleSheets::defaultStyle;
-    matchUARules(userAgentStyleSheet);
+    matchUARules(userAgentStyleSheet, m_collectedRules ? &m_collectedRules->userAgentRules : nullptr);
 
     // In quirks mode, we match rules from the quirks user agent sheet.
     if (m_element.document().inQuirksMode())
-        matchUARules(CSSDefaultStyleSheets::defaultQuirksStyle);
+        matchUARules(CSSDefaultStyleSheets::defaultQuirksStyle, m_collectedRules ? &m_collectedRules->quirksRules : nullptr);
 }
 
-void ElementRuleCollector::matchUARules(RuleSet* rules)
+void ElementRuleCollector::matchUARules(RuleSet* rules, const Vector<MatchedRule>* collectedRules)
 {
     clearMatchedRules();
     
     m_result.ranges.lastUARule = m_result.matchedProperties().size() - 1;
     StyleResolver::RuleRange ruleRange = m_result.ranges.UARuleRange();
-    collectMatchingRules(MatchRequest(rules), ruleRange);
+    if (collectedRules)
+        addCollectedRules(*collectedRules, ruleRange);
+    else
+        collectMatchingRules(MatchRequest(rules), ruleRange);
 
     sortAndTransferMatchedRules();
 }
@@ -398,11 +419,13 @@ inline bool ElementRuleCollector::ruleMatches(const RuleData& ruleData, unsigned
 
 #if ENABLE(CSS_SELECTOR_JIT)
     void* compiledSelectorChecker = ruleData.compiledSelectorCodeRef().code().executableAddress();
-    if (!compiledSelectorChecker && ruleData.compilationStatus() == SelectorCompilationStatus::NotCompiled) {
+    if (!compiledSelectorChecker && ruleData.compilationStatus() == SelectorCompilationStatus::NotCompiled && m_canCompileSelectors) {
         JSC::VM& vm = m_element.document().scriptExecutionContext()->vm();
         SelectorCompilationStatus compilationStatus;
         JSC::MacroAssemblerCodeRef compiledSelectorCodeRef;
         compilationStatus = SelectorCompiler::compileSelector(ruleData.selector(), &vm, SelectorCompiler::SelectorContext::RuleCollector, compiledSelectorCodeRef);
+        if (compilationStatus == SelectorCompilationStatus::CannotCompile)
+            m_element.document().didFailToCompileSelector();
 
         ruleData.setCompiledSelector(compilationStatus, compiledSelectorCodeRef);
         compiledSelectorChecker = ruleData.compiledSelectorCodeRef().code().executableAddress();
@@ -564,6 +587,56 @@ void ElementRuleCollector::matchAllRules(bool matchAuthorAndUserStyles, bool inc
     }
 }
 
+void ElementRuleCollector::collectSortedRules(const RuleSet* ruleSet, Vector<MatchedRule>& rules)
+{
+    if (!ruleSet)
+        return;
+
+    clearMatchedRules();
+
+    int firstRuleIndex = -1, lastRuleIndex = -1;
+    StyleResolver::RuleRange ruleRange(firstRuleIndex, lastRuleIndex);
+    collectMatchingRules(MatchRequest(ruleSet), ruleRange);
+
+    sortMatchedRules();
+    rules.appendVector(m_matchedRules);
+}
+
+void ElementRuleCollector::collectAllRules(bool matchAuthorAndUserStyles, CollectedRules& collectedRules)
+{
+    ASSERT(m_mode == SelectorChecker::Mode::ResolvingStyle);
+    ASSERT(m_pseudoStyleRequest.pseudoId == NOPSEUDO);
+    ASSERT(!m_regionForStyling);
+    ASSERT(!m_element.shadowRoot() && !m_element.isInShadowTree());
+
+    // Compiling a selector modifies the shared RuleData. Selectors that haven't been compiled yet use SelectorChecker.
+    m_canCompileSelectors = false;
+
+    collectSortedRules(m_isPrintStyle ? CSSDefaultStyleSheets::defaultPrintStyle : CSSDefaultStyleSheets::defaultStyle, collectedRules.userAgentRules);
+    if (m_element.document().inQuirksMode())
+        collectSortedRules(CSSDefaultStyleSheets::defaultQuirksStyle, collectedRules.quirksRules);
+
+    if (matchAuthorAndUserStyles) {
+        collectSortedRules(m_userStyle, collectedRules.userRules);
+        collectSortedRules(&m_authorStyle, collectedRules.authorRules);
+    }
+
+    collectedRules.styleRelations = WTFMove(m_styleRelations);
+    collectedRules.matchedPseudoElementIds = m_matchedPseudoElementIds;
+    collectedRules.didMatchUncommonAttributeSelector = m_didMatchUncommonAttributeSelector;
+}
+
+void ElementRuleCollector::setCollectedRules(const CollectedRules* collectedRules)
+{
+    m_collectedRules = collectedRules;
+    if (!collectedRules)
+        return;
+    m_styleRelations = collectedRules->styleRelations;
+    m_matchedPseudoElementIds.merge(collectedRules->matchedPseudoElementIds);
+    if (collectedRules->didMatchUncommonAttributeSelector)
+        m_didMatchUncommonAttributeSelector = true;
+}
+
 bool ElementRuleCollector::hasAnyMatchingRules(const RuleSet* ruleSet)
 {
     clearMatchedRules();
@@ -43,6 +43,17 @@ struct MatchedRule {
     Style::ScopeOrdinal styleScopeOrdinal;
 };
 
+// The rules an element matches, found ahead of time by ElementRuleCollector::collectAllRules().
+struct CollectedRules {
+    Vector<MatchedRule> userAgentRules;
+    Vector<MatchedRule> quirksRules;
+    Vector<MatchedRule> userRules;
+    Vector<MatchedRule> authorRules;
+    Style::Relations styleRelations;
+    PseudoIdSet matchedPseudoElementIds;
+    bool didMatchUncommonAttributeSelector { false };
+};
+
 class ElementRuleCollector {
 public:
     ElementRuleCollector(const Element&, const DocumentRuleSets&, const SelectorFilter*);
@@ -53,6 +64,12 @@ public:
     void matchAuthorRules(bool includeEmptyRules);
     void matchUserRules(bool includeEmptyRules);
 
+    // Finds the rules matchAllRules() would match without touching any state outside this collector, so it can run
+    // off the main thread. Elements in or hosting shadow trees, and slotted elements, are not supported.
+    void collectAllRules(bool matchAuthorAndUserStyles, CollectedRules&);
+    // Makes the match functions use rules found by collectAllRules() instead of matching selectors again.
+    void setCollectedRules(const CollectedRules*);
+
     void setMode(SelectorChecker::Mode mode) { m_mode = mode; }
     void setPseudoStyleRequest(const PseudoStyleRequest& request) { m_pseudoStyleRequest = request; }
     void setSameOriginOnly(bool f) { m_sameOriginOnly = f; } 
@@ -74,7 +91,7 @@ public:
 private:
     void addElementStyleProperties(const StyleProperties*, bool isCacheable = true);
 
-    void matchUARules(RuleSet*);
+    void matchUARules(RuleSet*, const Vector<MatchedRule>* collectedRules);
     void matchAuthorShadowPseudoElementRules(bool includeEmptyRules, StyleResolver::RuleRange&);
     void matchHostPseudoClassRules(bool includeEmptyRules, StyleResolver::RuleRange&);
     void matchSlottedPseudoElementRules(bool includeEmptyRules, StyleResolver::RuleRange&);
@@ -91,6 +108,8 @@ private:
     void sortAndTransferMatchedRules();
 
     void addMatchedRule(const RuleData&, unsigned specificity, Style::ScopeOrdinal, StyleResolver::RuleRange&);
+    void addCollectedRules(const Vector<MatchedRule>&, StyleResolver::RuleRange&);
+    void collectSortedRules(const RuleSet*, Vector<MatchedRule>&);
 
     const Element& m_element;
     const RuleSet& m_authorStyle;
@@ -105,6 +124,8 @@ private:
     bool m_isMatchingSlottedPseudoElements { false };
     bool m_isMatchingHostPseudoClass { false };
     Vector<std::unique_ptr<RuleSet::RuleDataVector>> m_keepAliveSlottedPseudoElementRules;
+    const CollectedRules* m_collectedRules { nullptr };
+    bool m_canCompileSelectors { true };
 
     Vector<MatchedRule, 64> m_matchedRules;
 
@@ -0,0 +1,1005 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "PrecompiledStyleSheet.h"
+
+#include "CSSFontFamily.h"
+#include "CSSParser.h"
+#include "CSSPrimitiveValue.h"
+#include "CSSPropertyNames.h"
+#include "CSSSelector.h"
+#include "CSSSelectorList.h"
+#include "CSSValueKeywords.h"
+#include "CSSValueList.h"
+#include "CSSValuePool.h"
+#include "StyleProperties.h"
+#include "StyleRule.h"
+#include "StyleSheetContents.h"
+#include <mutex>
+#include <wtf/HashMap.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/SHA1.h>
+#include <wtf/text/StringBuilder.h>
+#include <wtf/text/StringHash.h>
+
+namespace WebCore {
+
+// Bump the version whenever the format changes, including when one of the CSSSelector enum counts below does.
+static const uint32_t precompiledStyleSheetMagic = 0x53534155; // "UASS"
+static const uint32_t precompiledStyleSheetFormatVersion = 3;
+
+#if ENABLE(CSS_SELECTORS_LEVEL4)
+static const unsigned hasSelectorsLevel4 = 1;
+#else
+static const unsigned hasSelectorsLevel4 = 0;
+#endif
+#if ENABLE(FULLSCREEN_API)
+static const unsigned hasFullScreenAPI = 1;
+#else
+static const unsigned hasFullScreenAPI = 0;
+#endif
+#if ENABLE(VIDEO_TRACK)
+static const unsigned hasVideoTrack = 1;
+#else
+static const unsigned hasVideoTrack = 0;
+#endif
+
+// Selectors are stored with CSSSelector's enum values, so adding or removing a value shifts the ones
+// after it. Each count is one past its enum's last value, and fails to compile when it changes; update
+// it and the format version together.
+static const unsigned selectorMatchCount = CSSSelector::PagePseudoClass + 1;
+static_assert(selectorMatchCount == 14, "CSSSelector::Match changed, so bump precompiledStyleSheetFormatVersion");
+static const unsigned selectorRelationCount = CSSSelector::ShadowDescendant + 1;
+static_assert(selectorRelationCount == 6 + hasSelectorsLevel4, "CSSSelector::RelationType changed, so bump precompiledStyleSheetFormatVersion");
+static const unsigned pseudoClassTypeCount = CSSSelector::PseudoClassDefined + 1;
+static_assert(pseudoClassTypeCount == 57 + 4 * hasFullScreenAPI + 2 * hasVideoTrack + 2 * hasSelectorsLevel4, "CSSSelector::PseudoClassType changed, so bump precompiledStyleSheetFormatVersion");
+static const unsigned pseudoElementTypeCount = CSSSelector::PseudoElementWebKitCustomLegacyPrefixed + 1;
+static_assert(pseudoElementTypeCount == 17 + hasVideoTrack, "CSSSelector::PseudoElementType changed, so bump precompiledStyleSheetFormatVersion");
+static const unsigned pagePseudoClassTypeCount = CSSSelector::PagePseudoClassRight + 1;
+static_assert(pagePseudoClassTypeCount == 4, "CSSSelector::PagePseudoClassType changed, so bump precompiledStyleSheetFormatVersion");
+
+// Bounds the recursion through value lists and through selector lists nested in pseudo-classes.
+static const unsigned maximumNestingDepth = 16;
+
+enum class PrecompiledRuleTag : uint8_t {
+    Style,
+    Page,
+};
+
+enum class PrecompiledValueTag : uint8_t {
+    Inherit,
+    ExplicitInitial,
+    ImplicitInitial,
+    Unset,
+    Revert,
+    ValueIdentifier,
+    PropertyIdentifier,
+    Number,
+    String,
+    FontFamily,
+    Color,
+    List,
+    // Any other value is stored as text and parsed again for its property when decoding.
+    Text,
+};
+
+static const uint8_t selectorIsLastInSelectorList = 1 << 0;
+static const uint8_t selectorIsLastInTagHistory = 1 << 1;
+static const uint8_t selectorIsForPage = 1 << 2;
+static const uint8_t selectorTagIsForNamespaceRule = 1 << 3;
+static const uint8_t selectorMatchesLowercaseValue = 1 << 4;
+static const uint8_t selectorHasNth = 1 << 5;
+static const uint8_t selectorHasLangArgumentList = 1 << 6;
+static const uint8_t selectorHasSelectorList = 1 << 7;
+
+static const uint8_t attributeHasLowercaseLocalName = 1 << 0;
+static const uint8_t attributeValueIsCaseInsensitive = 1 << 1;
+
+static const uint8_t propertyIsImportant = 1 << 0;
+static const uint8_t propertyIsSetFromShorthand = 1 << 1;
+static const uint8_t propertyIsImplicit = 1 << 2;
+
+static SHA1::Digest computeSourceDigest(StringView source)
+{
+    SHA1 sha1;
+    if (source.is8Bit())
+        sha1.addBytes(source.characters8(), source.length());
+    else
+        sha1.addBytes(reinterpret_cast<const uint8_t*>(source.characters16()), source.length() * sizeof(UChar));
+    SHA1::Digest digest;
+    sha1.computeHash(digest);
+    return digest;
+}
+
+// Properties, value keywords and CSSSelector's enums are all stored by value. The key covers the
+// format version, the CSSSelector enum counts, which vary with the enabled features, and the names
+// in the generated property and keyword tables, which change whenever a property or keyword is
+// added, removed or reordered.
+static const SHA1::Digest& formatKey()
+{
+    static NeverDestroyed<SHA1::Digest> key;
+    static std::once_flag onceFlag;
+    std::call_once(onceFlag, [] {
+        SHA1 sha1;
+        const uint32_t formatParameters[] = { precompiledStyleSheetFormatVersion, selectorMatchCount, selectorRelationCount, pseudoClassTypeCount, pseudoElementTypeCount, pagePseudoClassTypeCount };
+        sha1.addBytes(reinterpret_cast<const uint8_t*>(formatParameters), sizeof(formatParameters));
+        for (int id = firstCSSProperty; id <= lastCSSProperty; ++id) {
+            const char* name = getPropertyName(static_cast<CSSPropertyID>(id));
+            sha1.addBytes(reinterpret_cast<const uint8_t*>(name), strlen(name) + 1);
+        }
+        for (int id = 1; id < numCSSValueKeywords; ++id) {
+            const char* name = getValueName(id);
+            sha1.addBytes(reinterpret_cast<const uint8_t*>(name), strlen(name) + 1);
+        }
+        sha1.computeHash(key.get());
+    });
+    return key;
+}
+
+static bool isValidPseudoType(uint8_t match, uint8_t pseudoType)
+{
+    switch (match) {
+    case CSSSelector::PseudoClass:
+        return pseudoType > CSSSelector::PseudoClassUnknown && pseudoType < pseudoClassTypeCount;
+    case CSSSelector::PseudoElement:
+        return pseudoType > CSSSelector::PseudoElementUnknown && pseudoType < pseudoElementTypeCount;
+    case CSSSelector::PagePseudoClass:
+        return pseudoType >= CSSSelector::PagePseudoClassFirst && pseudoType < pagePseudoClassTypeCount;
+    default:
+        return !pseudoType;
+    }
+}
+
+static bool isNthPseudoClass(CSSSelector::PseudoClassType type)
+{
+    return type == CSSSelector::PseudoClassNthChild
+        || type == CSSSelector::PseudoClassNthLastChild
+        || type == CSSSelector::PseudoClassNthOfType
+        || type == CSSSelector::PseudoClassNthLastOfType;
+}
+
+static bool isNumericUnit(unsigned unit)
+{
+    switch (unit) {
+    case CSSPrimitiveValue::CSS_NUMBER:
+    case CSSPrimitiveValue::CSS_PERCENTAGE:
+    case CSSPrimitiveValue::CSS_EMS:
+    case CSSPrimitiveValue::CSS_EXS:
+    case CSSPrimitiveValue::CSS_PX:
+    case CSSPrimitiveValue::CSS_CM:
+    case CSSPrimitiveValue::CSS_MM:
+    case CSSPrimitiveValue::CSS_IN:
+    case CSSPrimitiveValue::CSS_PT:
+    case CSSPrimitiveValue::CSS_PC:
+    case CSSPrimitiveValue::CSS_DEG:
+    case CSSPrimitiveValue::CSS_RAD:
+    case CSSPrimitiveValue::CSS_GRAD:
+    case CSSPrimitiveValue::CSS_MS:
+    case CSSPrimitiveValue::CSS_S:
+    case CSSPrimitiveValue::CSS_HZ:
+    case CSSPrimitiveValue::CSS_KHZ:
+    case CSSPrimitiveValue::CSS_VW:
+    case CSSPrimitiveValue::CSS_VH:
+    case CSSPrimitiveValue::CSS_VMIN:
+    case CSSPrimitiveValue::CSS_VMAX:
+    case CSSPrimitiveValue::CSS_DPPX:
+    case CSSPrimitiveValue::CSS_DPI:
+    case CSSPrimitiveValue::CSS_DPCM:
+    case CSSPrimitiveValue::CSS_FR:
+    case CSSPrimitiveValue::CSS_TURN:
+    case CSSPrimitiveValue::CSS_REMS:
+    case CSSPrimitiveValue::CSS_CHS:
+    case CSSPrimitiveValue::CSS_QUIRKY_EMS:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool isStringUnit(unsigned unit)
+{
+    return unit == CSSPrimitiveValue::CSS_STRING
+        || unit == CSSPrimitiveValue::CSS_URI
+        || unit == CSSPrimitiveValue::CSS_ATTR
+        || unit == CSSPrimitiveValue::CSS_COUNTER_NAME;
+}
+
+static bool isPlainValueList(const CSSValue& value)
+{
+    return value.isValueList() && !value.isImageSetValue() && !value.isGridLineNamesValue() && !value.isGridAutoRepeatValue();
+}
+
+static bool canEncodeValue(const CSSValue& value, unsigned depth = 0)
+{
+    if (value.isInheritedValue() || value.isInitialValue() || value.isUnsetValue() || value.isRevertValue())
+        return true;
+
+    if (is<CSSPrimitiveValue>(value)) {
+        auto& primitiveValue = downcast<CSSPrimitiveValue>(value);
+        if (primitiveValue.isValueID() || primitiveValue.isPropertyID() || primitiveValue.isFontFamily())
+            return true;
+        if (primitiveValue.isCalculated())
+            return false;
+        if (primitiveValue.isRGBColor())
+            return primitiveValue.color().isValid() && !primitiveValue.color().isExtended();
+        unsigned unit = primitiveValue.primitiveType();
+        if (primitiveValue.isQuirkValue() && unit != CSSPrimitiveValue::CSS_QUIRKY_EMS)
+            return false;
+        return isNumericUnit(unit) || isStringUnit(unit);
+    }
+
+    if (isPlainValueList(value)) {
+        if (depth >= maximumNestingDepth)
+            return false;
+        for (auto& item : downcast<CSSValueList>(value)) {
+            if (!canEncodeValue(item.get(), depth + 1))
+                return false;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+class PrecompiledStyleSheetWriter {
+public:
+    bool encode(const StyleSheetContents&, const String& sourceText);
+    Vector<uint8_t> takeBuffer() { return WTFMove(m_buffer); }
+
+private:
+    void append8(uint8_t value) { m_buffer.append(value); }
+    void append16(uint16_t value) { appendBytes(&value, sizeof(value)); }
+    void append32(uint32_t value) { appendBytes(&value, sizeof(value)); }
+    void appendDouble(double value) { appendBytes(&value, sizeof(value)); }
+    void appendBytes(const void* data, size_t size) { m_buffer.append(static_cast<const uint8_t*>(data), size); }
+
+    void appendString(const String&);
+    void appendQualifiedName(const QualifiedName&);
+    bool appendSelectors(const CSSSelector* firstSelector, unsigned depth = 0);
+    bool appendSelector(const CSSSelector&, unsigned depth);
+    bool appendProperties(const StyleProperties&);
+    void appendValue(const CSSValue&);
+
+    Vector<uint8_t> m_buffer;
+    HashMap<RefPtr<StringImpl>, uint32_t> m_stringIndices;
+};
+
+class PrecompiledStyleSheetReader {
+public:
+    PrecompiledStyleSheetReader(const uint8_t* data, size_t size)
+        : m_cursor(data)
+        , m_end(data + size)
+    {
+    }
+
+    RefPtr<StyleSheetContents> decode(const String& sourceText);
+
+private:
+    bool readHeader(const String& sourceText);
+
+    uint8_t read8()
+    {
+        uint8_t result = 0;
+        readBytes(&result, sizeof(result));
+        return result;
+    }
+
+    uint16_t read16()
+    {
+        uint16_t result = 0;
+        readBytes(&result, sizeof(result));
+        return result;
+    }
+
+    uint32_t read32()
+    {
+        uint32_t result = 0;
+        readBytes(&result, sizeof(result));
+        return result;
+    }
+
+    double readDouble()
+    {
+        double result = 0;
+        readBytes(&result, sizeof(result));
+        return result;
+    }
+
+    bool readBytes(void* data, size_t size)
+    {
+        if (m_failed || static_cast<size_t>(m_end - m_cursor) < size) {
+            m_failed = true;
+            return false;
+        }
+        memcpy(data, m_cursor, size);
+        m_cursor += size;
+        return true;
+    }
+
+    // Reads an element count and checks that the remaining data could possibly hold that many
+    // elements, so a corrupt count never turns into a huge allocation.
+    uint32_t readLength(size_t minimumElementSize)
+    {
+        uint32_t length = read32();
+        if (m_failed || (minimumElementSize && static_cast<size_t>(m_end - m_cursor) / minimumElementSize < length)) {
+            m_failed = true;
+            return 0;
+        }
+        return length;
+    }
+
+    String readString();
+    AtomicString readAtomicString() { return AtomicString(readString()); }
+    bool readQualifiedName(QualifiedName&);
+    bool readSelectors(CSSSelectorList&, unsigned depth = 0);
+    bool readSelector(Vector<CSSSelector>&, unsigned depth);
+    RefPtr<ImmutableStyleProperties> readProperties();
+    RefPtr<CSSValue> readValue(CSSPropertyID, unsigned depth = 0);
+
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+    bool m_failed { false };
+    Vector<String> m_strings;
+    CSSParserContext m_parserContext { UASheetMode };
+};
+
+void PrecompiledStyleSheetWriter::appendString(const String& string)
+{
+    // Index 0 is the null string. An index one past the end of the table introduces a new string,
+    // anything else refers back to one that has already been written.
+    if (string.isNull()) {
+        append32(0);
+        return;
+    }
+
+    auto addResult = m_stringIndices.add(string.impl(), m_stringIndices.size() + 1);
+    append32(addResult.iterator->value);
+    if (!addResult.isNewEntry)
+        return;
+
+    append8(string.is8Bit());
+    append32(string.length());
+    if (string.is8Bit())
+        appendBytes(string.characters8(), string.length());
+    else
+        appendBytes(string.characters16(), string.length() * sizeof(UChar));
+}
+
+String PrecompiledStyleSheetReader::readString()
+{
+    uint32_t index = read32();
+    if (!index || m_failed)
+        return String();
+    if (index <= m_strings.size())
+        return m_strings[index - 1];
+    if (index != m_strings.size() + 1) {
+        m_failed = true;
+        return String();
+    }
+
+    bool is8Bit = read8();
+    uint32_t length = readLength(is8Bit ? sizeof(LChar) : sizeof(UChar));
+    if (m_failed)
+        return String();
+
+    String result;
+    if (is8Bit) {
+        LChar* characters;
+        result = String::createUninitialized(length, characters);
+        readBytes(characters, length * sizeof(LChar));
+    } else {
+        UChar* characters;
+        result = String::createUninitialized(length, characters);
+        readBytes(characters, length * sizeof(UChar));
+    }
+    m_strings.append(result);
+    return result;
+}
+
+void PrecompiledStyleSheetWriter::appendQualifiedName(const QualifiedName& name)
+{
+    appendString(name.prefix());
+    appendString(name.localName());
+    appendString(name.namespaceURI());
+}
+
+bool PrecompiledStyleSheetReader::readQualifiedName(QualifiedName& name)
+{
+    AtomicString prefix = readAtomicString();
+    AtomicString localName = readAtomicString();
+    AtomicString namespaceURI = readAtomicString();
+    if (m_failed || localName.isNull())
+        return false;
+    name = QualifiedName(prefix, localName, namespaceURI);
+    return true;
+}
+
+bool PrecompiledStyleSheetWriter::appendSelectors(const CSSSelector* firstSelector, unsigned depth)
+{
+    if (depth >= maximumNestingDepth)
+        return false;
+
+    unsigned componentCount = 0;
+    if (firstSelector) {
+        for (const CSSSelector* selector = firstSelector; ; ++selector) {
+            ++componentCount;
+            if (selector->isLastInSelectorList())
+                break;
+        }
+    }
+
+    append32(componentCount);
+    for (unsigned i = 0; i < componentCount; ++i) {
+        if (!appendSelector(firstSelector[i], depth))
+            return false;
+    }
+    return true;
+}
+
+bool PrecompiledStyleSheetWriter::appendSelector(const CSSSelector& selector, unsigned depth)
+{
+    bool hasNth = selector.match() == CSSSelector::PseudoClass && isNthPseudoClass(selector.pseudoClassType()) && selector.parseNth();
+
+    uint8_t flags = 0;
+    if (selector.isLastInSelectorList())
+        flags |= selectorIsLastInSelectorList;
+    if (selector.isLastInTagHistory())
+        flags |= selectorIsLastInTagHistory;
+    if (selector.isForPage())
+        flags |= selectorIsForPage;
+    if (selector.tagIsForNamespaceRule())
+        flags |= selectorTagIsForNamespaceRule;
+    if (selector.match() != CSSSelector::Tag) {
+        if (selector.value() != selector.serializingValue())
+            flags |= selectorMatchesLowercaseValue;
+        if (hasNth)
+            flags |= selectorHasNth;
+        if (selector.langArgumentList())
+            flags |= selectorHasLangArgumentList;
+        if (selector.selectorList())
+            flags |= selectorHasSelectorList;
+    }
+
+    uint8_t pseudoType = 0;
+    if (selector.match() == CSSSelector::PseudoClass)
+        pseudoType = selector.pseudoClassType();
+    else if (selector.match() == CSSSelector::PseudoElement)
+        pseudoType = selector.pseudoElementType();
+    else if (selector.match() == CSSSelector::PagePseudoClass)
+        pseudoType = selector.pagePseudoClassType();
+
+    append8(flags);
+    append8(selector.match());
+    append8(selector.relation());
+    append8(pseudoType);
+
+    if (selector.match() == CSSSelector::Tag) {
+        appendQualifiedName(selector.tagQName());
+        return true;
+    }
+
+    appendString(selector.serializingValue());
+    if (selector.isAttributeSelector()) {
+        uint8_t attributeFlags = 0;
+        if (selector.attributeCanonicalLocalName() != selector.attribute().localName())
+            attributeFlags |= attributeHasLowercaseLocalName;
+        if (selector.attributeValueMatchingIsCaseInsensitive())
+            attributeFlags |= attributeValueIsCaseInsensitive;
+        append8(attributeFlags);
+        appendQualifiedName(selector.attribute());
+    }
+    appendString(selector.argument());
+    if (hasNth) {
+        append32(selector.nthA());
+        append32(selector.nthB());
+    }
+    if (auto* langArgumentList = selector.langArgumentList()) {
+        append32(langArgumentList->size());
+        for (auto& argument : *langArgumentList)
+            appendString(argument);
+    }
+    if (auto* selectorList = selector.selectorList())
+        return appendSelectors(selectorList->first(), depth + 1);
+    return true;
+}
+
+static void setSelectorStructure(CSSSelector& selector, uint8_t relation, uint8_t flags)
+{
+    selector.setRelation(static_cast<CSSSelector::RelationType>(relation));
+    if (flags & selectorIsLastInSelectorList)
+        selector.setLastInSelectorList();
+    if (!(flags & selectorIsLastInTagHistory))
+        selector.setNotLastInTagHistory();
+    if (flags & selectorIsForPage)
+        selector.setForPage();
+}
+
+bool PrecompiledStyleSheetReader::readSelector(Vector<CSSSelector>& selectors, unsigned depth)
+{
+    uint8_t flags = read8();
+    uint8_t match = read8();
+    uint8_t relation = read8();
+    uint8_t pseudoType = read8();
+    if (m_failed || match >= selectorMatchCount || relation >= selectorRelationCount || !isValidPseudoType(match, pseudoType))
+        return false;
+
+    if (match == CSSSelector::Tag) {
+        QualifiedName tagQName = anyQName();
+        if (!readQualifiedName(tagQName))
+            return false;
+        selectors.append(CSSSelector(tagQName, flags & selectorTagIsForNamespaceRule));
+        setSelectorStructure(selectors.last(), relation, flags);
+        return true;
+    }
+
+    CSSSelector selector;
+    selector.setMatch(static_cast<CSSSelector::Match>(match));
+    if (match == CSSSelector::PseudoClass)
+        selector.setPseudoClassType(static_cast<CSSSelector::PseudoClassType>(pseudoType));
+    else if (match == CSSSelector::PseudoElement)
+        selector.setPseudoElementType(static_cast<CSSSelector::PseudoElementType>(pseudoType));
+    else if (match == CSSSelector::PagePseudoClass)
+        selector.setPagePseudoType(static_cast<CSSSelector::PagePseudoClassType>(pseudoType));
+
+    AtomicString value = readAtomicString();
+    if (!value.isNull())
+        selector.setValue(value, flags & selectorMatchesLowercaseValue);
+
+    if (selector.isAttributeSelector()) {
+        uint8_t attributeFlags = read8();
+        QualifiedName attribute = anyQName();
+        if (!readQualifiedName(attribute))
+            return false;
+        selector.setAttribute(attribute, attributeFlags & attributeHasLowercaseLocalName, attributeFlags & attributeValueIsCaseInsensitive ? CSSSelector::CaseInsensitive : CSSSelector::CaseSensitive);
+    }
+
+    AtomicString argument = readAtomicString();
+    if (!argument.isNull())
+        selector.setArgument(argument);
+
+    if (flags & selectorHasNth) {
+        int a = static_cast<int32_t>(read32());
+        int b = static_cast<int32_t>(read32());
+        selector.setNth(a, b);
+    }
+
+    if (flags & selectorHasLangArgumentList) {
+        uint32_t length = readLength(sizeof(uint32_t));
+        auto langArgumentList = std::make_unique<Vector<AtomicString>>();
+        langArgumentList->reserveInitialCapacity(length);
+        for (uint32_t i = 0; i < length; ++i)
+            langArgumentList->uncheckedAppend(readAtomicString());
+        selector.setLangArgumentList(WTFMove(langArgumentList));
+    }
+
+    if (flags & selectorHasSelectorList) {
+        auto selectorList = std::make_unique<CSSSelectorList>();
+        if (!readSelectors(*selectorList, depth + 1) || !selectorList->isValid())
+            return false;
+        selector.setSelectorList(WTFMove(selectorList));
+    }
+
+    if (m_failed)
+        return false;
+
+    setSelectorStructure(selector, relation, flags);
+    selectors.append(selector);
+    return true;
+}
+
+bool PrecompiledStyleSheetReader::readSelectors(CSSSelectorList& selectorList, unsigned depth)
+{
+    if (depth >= maximumNestingDepth)
+        return false;
+
+    uint32_t componentCount = readLength(4 * sizeof(uint8_t));
+    if (m_failed)
+        return false;
+    if (!componentCount)
+        return true;
+
+    Vector<CSSSelector> selectors;
+    selectors.reserveInitialCapacity(componentCount);
+    for (uint32_t i = 0; i < componentCount; ++i) {
+        if (!readSelector(selectors, depth))
+            return false;
+    }
+
+    // CSSSelectorList and tagHistory() walk the array until these bits, so they must be exactly right.
+    for (uint32_t i = 0; i + 1 < componentCount; ++i) {
+        if (selectors[i].isLastInSelectorList())
+            return false;
+    }
+    if (!selectors.last().isLastInSelectorList() || !selectors.last().isLastInTagHistory())
+        return false;
+
+    CSSSelector* selectorArray = static_cast<CSSSelector*>(fastMalloc(sizeof(CSSSelector) * componentCount));
+    for (uint32_t i = 0; i < componentCount; ++i)
+        new (NotNull, &selectorArray[i]) CSSSelector(selectors[i]);
+    selectorList.adoptSelectorArray(selectorArray);
+    return true;
+}
+
+bool PrecompiledStyleSheetWriter::appendProperties(const StyleProperties& properties)
+{
+    unsigned propertyCount = properties.propertyCount();
+    append32(propertyCount);
+    for (unsigned i = 0; i < propertyCount; ++i) {
+        CSSProperty property = properties.propertyAt(i).toCSSProperty();
+        const CSSValue* value = property.value();
+        if (!value || property.id() == CSSPropertyCustom)
+            return false;
+
+        const StylePropertyMetadata& metadata = property.metadata();
+        uint8_t flags = 0;
+        if (metadata.m_important)
+            flags |= propertyIsImportant;
+        if (metadata.m_isSetFromShorthand)
+            flags |= propertyIsSetFromShorthand;
+        if (metadata.m_implicit)
+            flags |= propertyIsImplicit;
+
+        append16(property.id());
+        append8(flags);
+        append8(metadata.m_indexInShorthandsVector);
+
+        if (canEncodeValue(*value)) {
+            appendValue(*value);
+            continue;
+        }
+
+        // Only fall back to text if parsing it gives back the same value.
+        String text = value->cssText();
+        RefPtr<CSSValue> reparsedValue = CSSParser::parseSingleValue(property.id(), text, CSSParserContext(UASheetMode));
+        if (!reparsedValue || !reparsedValue->equals(*value))
+            return false;
+        append8(static_cast<uint8_t>(PrecompiledValueTag::Text));
+        appendString(text);
+    }
+    return true;
+}
+
+RefPtr<ImmutableStyleProperties> PrecompiledStyleSheetReader::readProperties()
+{
+    uint32_t propertyCount = readLength(5 * sizeof(uint8_t));
+    if (m_failed)
+        return nullptr;
+
+    Vector<CSSProperty, 256> properties;
+    properties.reserveInitialCapacity(propertyCount);
+    for (uint32_t i = 0; i < propertyCount; ++i) {
+        uint16_t id = read16();
+        uint8_t flags = read8();
+        uint8_t indexInShorthandsVector = read8();
+        if (m_failed || id < firstCSSProperty || id > lastCSSProperty || indexInShorthandsVector > 3)
+            return nullptr;
+
+        CSSPropertyID propertyID = static_cast<CSSPropertyID>(id);
+        RefPtr<CSSValue> value = readValue(propertyID);
+        if (!value)
+            return nullptr;
+        properties.uncheckedAppend(CSSProperty(propertyID, WTFMove(value), flags & propertyIsImportant, flags & propertyIsSetFromShorthand, indexInShorthandsVector, flags & propertyIsImplicit));
+    }
+    return ImmutableStyleProperties::create(properties.data(), properties.size(), UASheetMode);
+}
+
+void PrecompiledStyleSheetWriter::appendValue(const CSSValue& value)
+{
+    ASSERT(canEncodeValue(value));
+
+    if (value.isInheritedValue()) {
+        append8(static_cast<uint8_t>(PrecompiledValueTag::Inherit));
+        return;
+    }
+    if (value.isInitialValue()) {
+        append8(static_cast<uint8_t>(value.isImplicitInitialValue() ? PrecompiledValueTag::ImplicitInitial : PrecompiledValueTag::ExplicitInitial));
+        return;
+    }
+    if (value.isUnsetValue()) {
+        append8(static_cast<uint8_t>(PrecompiledValueTag::Unset));
+        return;
+    }
+    if (value.isRevertValue()) {
+        append8(static_cast<uint8_t>(PrecompiledValueTag::Revert));
+        return;
+    }
+
+    if (is<CSSPrimitiveValue>(value)) {
+        auto& primitiveValue = downcast<CSSPrimitiveValue>(value);
+        if (primitiveValue.isValueID()) {
+            append8(static_cast<uint8_t>(PrecompiledValueTag::ValueIdentifier));
+            append16(primitiveValue.valueID());
+        } else if (primitiveValue.isPropertyID()) {
+            append8(static_cast<uint8_t>(PrecompiledValueTag::PropertyIdentifier));
+            append16(primitiveValue.propertyID());
+        } else if (primitiveValue.isFontFamily()) {
+            append8(static_cast<uint8_t>(PrecompiledValueTag::FontFamily));
+            append8(primitiveValue.fontFamily().fromSystemFontID);
+            appendString(primitiveValue.fontFamily().familyName);
+        } else if (primitiveValue.isRGBColor()) {
+            append8(static_cast<uint8_t>(PrecompiledValueTag::Color));
+            append32(primitiveValue.color().rgb());
+        } else if (isNumericUnit(primitiveValue.primitiveType())) {
+            append8(static_cast<uint8_t>(PrecompiledValueTag::Number));
+            append8(primitiveValue.primitiveType());
+            appendDouble(primitiveValue.doubleValue());
+        } else {
+            append8(static_cast<uint8_t>(PrecompiledValueTag::String));
+            append8(primitiveValue.primitiveType());
+            appendString(primitiveValue.stringValue());
+        }
+        return;
+    }
+
+    auto& list = downcast<CSSValueList>(value);
+    append8(static_cast<uint8_t>(PrecompiledValueTag::List));
+    append8(list.separator());
+    append32(list.length());
+    for (auto& item : list)
+        appendValue(item.get());
+}
+
+RefPtr<CSSValue> PrecompiledStyleSheetReader::readValue(CSSPropertyID propertyID, unsigned depth)
+{
+    auto& pool = CSSValuePool::singleton();
+    switch (static_cast<PrecompiledValueTag>(read8())) {
+    case PrecompiledValueTag::Inherit:
+        return pool.createInheritedValue();
+    case PrecompiledValueTag::ExplicitInitial:
+        return pool.createExplicitInitialValue();
+    case PrecompiledValueTag::ImplicitInitial:
+        return pool.createImplicitInitialValue();
+    case PrecompiledValueTag::Unset:
+        return pool.createUnsetValue();
+    case PrecompiledValueTag::Revert:
+        return pool.createRevertValue();
+    case PrecompiledValueTag::ValueIdentifier: {
+        uint16_t id = read16();
+        if (m_failed || !id || id >= numCSSValueKeywords)
+            return nullptr;
+        return pool.createIdentifierValue(static_cast<CSSValueID>(id));
+    }
+    case PrecompiledValueTag::PropertyIdentifier: {
+        uint16_t id = read16();
+        if (m_failed || id < firstCSSProperty || id > lastCSSProperty)
+            return nullptr;
+        return pool.createIdentifierValue(static_cast<CSSPropertyID>(id));
+    }
+    case PrecompiledValueTag::Number: {
+        uint8_t unit = read8();
+        double number = readDouble();
+        if (m_failed || !isNumericUnit(unit))
+            return nullptr;
+        return pool.createValue(number, static_cast<CSSPrimitiveValue::UnitType>(unit));
+    }
+    case PrecompiledValueTag::String: {
+        uint8_t unit = read8();
+        String string = readString();
+        if (m_failed || !isStringUnit(unit) || string.isNull())
+            return nullptr;
+        return pool.createValue(string, static_cast<CSSPrimitiveValue::UnitType>(unit));
+    }
+    case PrecompiledValueTag::FontFamily: {
+        bool fromSystemFontID = read8();
+        String familyName = readString();
+        if (m_failed || familyName.isNull())
+            return nullptr;
+        return pool.createFontFamilyValue(familyName, fromSystemFontID ? FromSystemFontID::Yes : FromSystemFontID::No);
+    }
+    case PrecompiledValueTag::Color: {
+        RGBA32 color = read32();
+        if (m_failed)
+            return nullptr;
+        return pool.createColorValue(Color(color));
+    }
+    case PrecompiledValueTag::List: {
+        uint8_t separator = read8();
+        uint32_t length = readLength(sizeof(uint8_t));
+        if (m_failed || depth >= maximumNestingDepth)
+            return nullptr;
+
+        RefPtr<CSSValueList> list;
+        switch (separator) {
+        case CSSValue::SpaceSeparator:
+            list = CSSValueList::createSpaceSeparated();
+            break;
+        case CSSValue::CommaSeparator:
+            list = CSSValueList::createCommaSeparated();
+            break;
+        case CSSValue::SlashSeparator:
+            list = CSSValueList::createSlashSeparated();
+            break;
+        default:
+            return nullptr;
+        }
+        for (uint32_t i = 0; i < length; ++i) {
+            RefPtr<CSSValue> item = readValue(propertyID, depth + 1);
+            if (!item)
+                return nullptr;
+            list->append(item.releaseNonNull());
+        }
+        return list;
+    }
+    case PrecompiledValueTag::Text: {
+        String text = readString();
+        if (m_failed || text.isNull())
+            return nullptr;
+        return CSSParser::parseSingleValue(propertyID, text, m_parserContext);
+    }
+    }
+    return nullptr;
+}
+
+bool PrecompiledStyleSheetWriter::encode(const StyleSheetContents& sheet, const String& sourceText)
+{
+    // User agent sheets have no @import rules, and the few other kinds of rule are left to the parser.
+    if (!sheet.importRules().isEmpty())
+        return false;
+
+    append32(precompiledStyleSheetMagic);
+    append32(precompiledStyleSheetFormatVersion);
+    appendBytes(formatKey().data(), formatKey().size());
+    append32(sourceText.length());
+    SHA1::Digest digest = computeSourceDigest(sourceText);
+    appendBytes(digest.data(), digest.size());
+
+    size_t payloadSizeOffset = m_buffer.size();
+    append32(0);
+    append32(0);
+
+    append32(sheet.namespaceRules().size());
+    for (auto& namespaceRule : sheet.namespaceRules()) {
+        appendString(namespaceRule->prefix());
+        appendString(namespaceRule->uri());
+    }
+
+    append32(sheet.childRules().size());
+    for (auto& rule : sheet.childRules()) {
+        if (is<StyleRule>(*rule)) {
+            auto& styleRule = downcast<StyleRule>(*rule);
+            append8(static_cast<uint8_t>(PrecompiledRuleTag::Style));
+            if (!appendSelectors(styleRule.selectorList().first()) || !appendProperties(styleRule.properties()))
+                return false;
+            continue;
+        }
+        if (is<StyleRulePage>(*rule)) {
+            auto& pageRule = downcast<StyleRulePage>(*rule);
+            append8(static_cast<uint8_t>(PrecompiledRuleTag::Page));
+            if (!appendSelectors(pageRule.selector()) || !appendProperties(pageRule.properties()))
+                return false;
+            continue;
+        }
+        return false;
+    }
+
+    size_t payloadStart = payloadSizeOffset + 2 * sizeof(uint32_t);
+    uint32_t payloadSize = m_buffer.size() - payloadStart;
+    uint32_t payloadHash = StringHasher::hashMemory(m_buffer.data() + payloadStart, payloadSize);
+    memcpy(m_buffer.data() + payloadSizeOffset, &payloadSize, sizeof(payloadSize));
+    memcpy(m_buffer.data() + payloadSizeOffset + sizeof(payloadSize), &payloadHash, sizeof(payloadHash));
+    return true;
+}
+
+bool PrecompiledStyleSheetReader::readHeader(const String& sourceText)
+{
+    if (read32() != precompiledStyleSheetMagic || read32() != precompiledStyleSheetFormatVersion)
+        return false;
+
+    SHA1::Digest key;
+    readBytes(key.data(), key.size());
+    if (m_failed || key != formatKey())
+        return false;
+
+    uint32_t sourceLength = read32();
+    SHA1::Digest digest;
+    readBytes(digest.data(), digest.size());
+    uint32_t payloadSize = read32();
+    uint32_t payloadHash = read32();
+    if (m_failed || static_cast<size_t>(m_end - m_cursor) != payloadSize)
+        return false;
+
+    if (sourceLength != sourceText.length() || digest != computeSourceDigest(sourceText))
+        return false;
+    return payloadHash == StringHasher::hashMemory(m_cursor, payloadSize);
+}
+
+RefPtr<StyleSheetContents> PrecompiledStyleSheetReader::decode(const String& sourceText)
+{
+    if (!readHeader(sourceText))
+        return nullptr;
+
+    auto sheet = StyleSheetContents::create(CSSParserContext(UASheetMode));
+
+    uint32_t namespaceRuleCount = readLength(2 * sizeof(uint32_t));
+    for (uint32_t i = 0; i < namespaceRuleCount; ++i) {
+        AtomicString prefix = readAtomicString();
+        AtomicString uri = readAtomicString();
+        if (m_failed)
+            return nullptr;
+        sheet->parserAppendRule(StyleRuleNamespace::create(prefix, uri));
+    }
+
+    uint32_t ruleCount = readLength(sizeof(uint8_t));
+    for (uint32_t i = 0; i < ruleCount; ++i) {
+        switch (static_cast<PrecompiledRuleTag>(read8())) {
+        case PrecompiledRuleTag::Style: {
+            CSSSelectorList selectorList;
+            if (!readSelectors(selectorList) || !selectorList.isValid())
+                return nullptr;
+            auto properties = readProperties();
+            if (!properties)
+                return nullptr;
+            auto styleRule = StyleRule::create(properties.releaseNonNull());
+            styleRule->wrapperAdoptSelectorList(selectorList);
+            sheet->parserAppendRule(WTFMove(styleRule));
+            break;
+        }
+        case PrecompiledRuleTag::Page: {
+            CSSSelectorList selectorList;
+            if (!readSelectors(selectorList))
+                return nullptr;
+            auto properties = readProperties();
+            if (!properties)
+                return nullptr;
+            auto pageRule = StyleRulePage::create(properties.releaseNonNull());
+            pageRule->wrapperAdoptSelectorList(selectorList);
+            sheet->parserAppendRule(WTFMove(pageRule));
+            break;
+        }
+        default:
+            return nullptr;
+        }
+    }
+
+    if (m_failed || m_cursor != m_end)
+        return nullptr;
+    return WTFMove(sheet);
+}
+
+Vector<uint8_t> encodePrecompiledStyleSheet(const StyleSheetContents& sheet, const String& sourceText)
+{
+    PrecompiledStyleSheetWriter writer;
+    if (!writer.encode(sheet, sourceText))
+        return { };
+    return writer.takeBuffer();
+}
+
+RefPtr<StyleSheetContents> decodePrecompiledStyleSheet(const uint8_t* data, size_t size, const String& sourceText)
+{
+    PrecompiledStyleSheetReader reader(data, size);
+    return reader.decode(sourceText);
+}
+
+String precompiledStyleSheetFileName(const String& sourceText)
+{
+    SHA1::Digest digest = computeSourceDigest(sourceText);
+    StringBuilder builder;
+    builder.append(SHA1::hexDigest(digest).data());
+    builder.appendLiteral(".uasheet");
+    return builder.toString();
+}
+
+} // namespace WebCore
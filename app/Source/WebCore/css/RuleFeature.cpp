@@ -42,7 +42,7 @@ void RuleFeatureSet::recursivelyCollectFeaturesFromSelector(SelectorFeatures& se
         if (selector->match() == CSSSelector::Id) {
             idsInRules.add(selector->value().impl());
             if (matchesAncestor)
-                idsMatchingAncestorsInRules.add(selector->value().impl());
+                selectorFeatures.idsMatchingAncestors.append(selector->value().impl());
         } else if (selector->match() == CSSSelector::Class) {
             classesInRules.add(selector->value().impl());
             if (matchesAncestor)
@@ -65,10 +65,25 @@ void RuleFeatureSet::recursivelyCollectFeaturesFromSelector(SelectorFeatures& se
             default:
                 break;
             }
+        } else if (selector->match() == CSSSelector::PseudoClass) {
+            switch (selector->pseudoClassType()) {
+            case CSSSelector::PseudoClassLang:
+            case CSSSelector::PseudoClassDefault:
+            case CSSSelector::PseudoClassValid:
+            case CSSSelector::PseudoClassInvalid:
+            case CSSSelector::PseudoClassInRange:
+            case CSSSelector::PseudoClassOutOfRange:
+                usesMainThreadOnlyPseudoClasses = true;
+                break;
+            default:
+                break;
+            }
         }
 
         if (!selectorFeatures.hasSiblingSelector && selector->isSiblingSelector())
             selectorFeatures.hasSiblingSelector = true;
+        if (matchesAncestor && selector->isSiblingSelector())
+            usesSiblingSelectorsMatchingAncestors = true;
 
         if (const CSSSelectorList* selectorList = selector->selectorList()) {
             for (const CSSSelector* subSelector = selectorList->first(); subSelector; subSelector = CSSSelectorList::next(subSelector)) {
@@ -91,6 +106,24 @@ static RuleFeatureSet::AttributeRules::SelectorKey makeAttributeSelectorKey(cons
     return std::make_pair(selector.attributeCanonicalLocalName().impl(), std::make_pair(selector.value().impl(), matchAndCase));
 }
 
+static void addRuleFeature(RuleFeatureSet::RuleFeatureMap& map, AtomicStringImpl* key, const RuleData& ruleData)
+{
+    auto addResult = map.ensure(key, [] {
+        return std::make_unique<Vector<RuleFeature>>();
+    });
+    addResult.iterator->value->append(RuleFeature(ruleData.rule(), ruleData.selectorIndex(), ruleData.hasDocumentSecurityOrigin()));
+}
+
+static void addRuleFeatures(RuleFeatureSet::RuleFeatureMap& map, const RuleFeatureSet::RuleFeatureMap& other)
+{
+    for (auto& keyValuePair : other) {
+        auto addResult = map.ensure(keyValuePair.key, [] {
+            return std::make_unique<Vector<RuleFeature>>();
+        });
+        addResult.iterator->value->appendVector(*keyValuePair.value);
+    }
+}
+
 void RuleFeatureSet::collectFeatures(const RuleData& ruleData)
 {
     SelectorFeatures selectorFeatures;
@@ -99,12 +132,10 @@ void RuleFeatureSet::collectFeatures(const RuleData& ruleData)
         siblingRules.append(RuleFeature(ruleData.rule(), ruleData.selectorIndex(), ruleData.hasDocumentSecurityOrigin()));
     if (ruleData.containsUncommonAttributeSelector())
         uncommonAttributeRules.append(RuleFeature(ruleData.rule(), ruleData.selectorIndex(), ruleData.hasDocumentSecurityOrigin()));
-    for (auto* className : selectorFeatures.classesMatchingAncestors) {
-        auto addResult = ancestorClassRules.ensure(className, [] {
-            return std::make_unique<Vector<RuleFeature>>();
-        });
-        addResult.iterator->value->append(RuleFeature(ruleData.rule(), ruleData.selectorIndex(), ruleData.hasDocumentSecurityOrigin()));
-    }
+    for (auto* id : selectorFeatures.idsMatchingAncestors)
+        addRuleFeature(ancestorIdRules, id, ruleData);
+    for (auto* className : selectorFeatures.classesMatchingAncestors)
+        addRuleFeature(ancestorClassRules, className, ruleData);
     for (auto* selector : selectorFeatures.attributeSelectorsMatchingAncestors) {
         // Hashing by attributeCanonicalLocalName makes this HTML specific.
         auto addResult = ancestorAttributeRulesForHTML.ensure(selector->attributeCanonicalLocalName().impl(), [] {
@@ -120,18 +151,13 @@ void RuleFeatureSet::collectFeatures(const RuleData& ruleData)
 void RuleFeatureSet::add(const RuleFeatureSet& other)
 {
     idsInRules.add(other.idsInRules.begin(), other.idsInRules.end());
-    idsMatchingAncestorsInRules.add(other.idsMatchingAncestorsInRules.begin(), other.idsMatchingAncestorsInRules.end());
     classesInRules.add(other.classesInRules.begin(), other.classesInRules.end());
     attributeCanonicalLocalNamesInRules.add(other.attributeCanonicalLocalNamesInRules.begin(), other.attributeCanonicalLocalNamesInRules.end());
     attributeLocalNamesInRules.add(other.attributeLocalNamesInRules.begin(), other.attributeLocalNamesInRules.end());
     siblingRules.appendVector(other.siblingRules);
     uncommonAttributeRules.appendVector(other.uncommonAttributeRules);
-    for (auto& keyValuePair : other.ancestorClassRules) {
-        auto addResult = ancestorClassRules.ensure(keyValuePair.key, [] {
-            return std::make_unique<Vector<RuleFeature>>();
-        });
-        addResult.iterator->value->appendVector(*keyValuePair.value);
-    }
+    addRuleFeatures(ancestorIdRules, other.ancestorIdRules);
+    addRuleFeatures(ancestorClassRules, other.ancestorClassRules);
     for (auto& keyValuePair : other.ancestorAttributeRulesForHTML) {
         auto addResult = ancestorAttributeRulesForHTML.ensure(keyValuePair.key, [] {
             return std::make_unique<AttributeRules>();
@@ -143,27 +169,33 @@ void RuleFeatureSet::add(const RuleFeatureSet& other)
     }
     usesFirstLineRules = usesFirstLineRules || other.usesFirstLineRules;
     usesFirstLetterRules = usesFirstLetterRules || other.usesFirstLetterRules;
+    usesMainThreadOnlyPseudoClasses = usesMainThreadOnlyPseudoClasses || other.usesMainThreadOnlyPseudoClasses;
+    usesSiblingSelectorsMatchingAncestors = usesSiblingSelectorsMatchingAncestors || other.usesSiblingSelectorsMatchingAncestors;
 }
 
 void RuleFeatureSet::clear()
 {
     idsInRules.clear();
-    idsMatchingAncestorsInRules.clear();
     classesInRules.clear();
     attributeCanonicalLocalNamesInRules.clear();
     attributeLocalNamesInRules.clear();
     siblingRules.clear();
     uncommonAttributeRules.clear();
+    ancestorIdRules.clear();
     ancestorClassRules.clear();
     ancestorAttributeRulesForHTML.clear();
     usesFirstLineRules = false;
     usesFirstLetterRules = false;
+    usesMainThreadOnlyPseudoClasses = false;
+    usesSiblingSelectorsMatchingAncestors = false;
 }
 
 void RuleFeatureSet::shrinkToFit()
 {
     siblingRules.shrinkToFit();
     uncommonAttributeRules.shrinkToFit();
+    for (auto& rules : ancestorIdRules.values())
+        rules->shrinkToFit();
     for (auto& rules : ancestorClassRules.values())
         rules->shrinkToFit();
     for (auto& rules : ancestorAttributeRulesForHTML.values())
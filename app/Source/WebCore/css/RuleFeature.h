@@ -50,14 +50,16 @@ struct RuleFeatureSet {
     void shrinkToFit();
     void collectFeatures(const RuleData&);
 
+    using RuleFeatureMap = HashMap<AtomicStringImpl*, std::unique_ptr<Vector<RuleFeature>>>;
+
     HashSet<AtomicStringImpl*> idsInRules;
-    HashSet<AtomicStringImpl*> idsMatchingAncestorsInRules;
     HashSet<AtomicStringImpl*> classesInRules;
     HashSet<AtomicStringImpl*> attributeCanonicalLocalNamesInRules;
     HashSet<AtomicStringImpl*> attributeLocalNamesInRules;
     Vector<RuleFeature> siblingRules;
     Vector<RuleFeature> uncommonAttributeRules;
-    HashMap<AtomicStringImpl*, std::unique_ptr<Vector<RuleFeature>>> ancestorClassRules;
+    RuleFeatureMap ancestorIdRules;
+    RuleFeatureMap ancestorClassRules;
 
     struct AttributeRules {
         WTF_MAKE_FAST_ALLOCATED;
@@ -69,10 +71,16 @@ struct RuleFeatureSet {
     HashMap<AtomicStringImpl*, std::unique_ptr<AttributeRules>> ancestorAttributeRulesForHTML;
     bool usesFirstLineRules { false };
     bool usesFirstLetterRules { false };
+    // Matching these reads state that is computed lazily, so it can't be done off the main thread.
+    bool usesMainThreadOnlyPseudoClasses { false };
+    // Whether some selector tests the position or previous siblings of an ancestor of the subject, as in
+    // "li:first-child span" or ".a + .b .c". Otherwise an element's previous siblings can't affect its descendants.
+    bool usesSiblingSelectorsMatchingAncestors { false };
 
 private:
     struct SelectorFeatures {
         bool hasSiblingSelector { false };
+        Vector<AtomicStringImpl*, 32> idsMatchingAncestors;
         Vector<AtomicStringImpl*, 32> classesMatchingAncestors;
         Vector<const CSSSelector*> attributeSelectorsMatchingAncestors;
     };
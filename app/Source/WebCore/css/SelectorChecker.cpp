@@ -80,7 +80,7 @@ struct SelectorChecker::LocalContext {
 
 static inline void addStyleRelation(SelectorChecker::CheckingContext& checkingContext, const Element& element, Style::Relation::Type type, unsigned value = 1)
 {
-    ASSERT(value == 1 || type == Style::Relation::NthChildIndex || type == Style::Relation::AffectedByEmpty);
+    ASSERT(value == 1 || type == Style::Relation::NthChildIndex || type == Style::Relation::NthChildIndexOfType || type == Style::Relation::AffectedByEmpty);
     if (checkingContext.resolvingMode != SelectorChecker::Mode::ResolvingStyle)
         return;
     if (type == Style::Relation::AffectsNextSibling && !checkingContext.styleRelations.isEmpty()) {
@@ -147,8 +147,14 @@ static inline int countElementsOfTypeBefore(SelectorChecker::CheckingContext& ch
     for (const Element* sibling = ElementTraversal::previousSibling(element); sibling; sibling = ElementTraversal::previousSibling(*sibling)) {
         addStyleRelation(checkingContext, *sibling, Style::Relation::AffectsNextSibling);
 
-        if (sibling->hasTagName(type))
+        if (sibling->hasTagName(type)) {
+            unsigned index = sibling->childIndexOfType();
+            if (index) {
+                count += index;
+                break;
+            }
             ++count;
+        }
     }
     return count;
 }
@@ -877,6 +883,7 @@ bool SelectorChecker::checkOne(CheckingContext& checkingContext, const LocalCont
                 addStyleRelation(checkingContext, element, Style::Relation::AffectedByPreviousSibling);
 
                 int count = 1 + countElementsOfTypeBefore(checkingContext, element, element.tagQName());
+                addStyleRelation(checkingContext, element, Style::Relation::NthChildIndexOfType, count);
                 if (selector.matchNth(count))
                     return true;
             }
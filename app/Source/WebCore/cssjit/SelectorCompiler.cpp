@@ -206,6 +206,8 @@ struct SelectorFragment {
     Vector<NthChildOfSelectorInfo> nthChildOfFilters;
     Vector<std::pair<int, int>, 2> nthLastChildFilters;
     Vector<NthChildOfSelectorInfo> nthLastChildOfFilters;
+    Vector<std::pair<int, int>, 2> nthOfTypeFilters;
+    Vector<std::pair<int, int>, 2> nthLastOfTypeFilters;
     SelectorList notFilters;
     Vector<SelectorList> matchesFilters;
     Vector<Vector<SelectorFragment>> anyFilters;
@@ -301,6 +303,9 @@ private:
     void generateElementIsLastChild(Assembler::JumpList& failureCases);
     void generateElementIsOnlyChild(Assembler::JumpList& failureCases);
     void generateElementHasPlaceholderShown(Assembler::JumpList& failureCases);
+    void generateElementIsDragged(Assembler::JumpList& failureCases);
+    void generateElementIsFirstOfType(Assembler::JumpList& failureCases, const SelectorFragment&);
+    void generateElementIsLastOfType(Assembler::JumpList& failureCases);
     void generateSynchronizeStyleAttribute(Assembler::RegisterID elementDataArraySizeAndFlags);
     void generateSynchronizeAllAnimatedSVGAttribute(Assembler::RegisterID elementDataArraySizeAndFlags);
     void generateElementAttributesMatching(Assembler::JumpList& failureCases, const LocalRegister& elementDataAddress, const SelectorFragment&);
@@ -316,6 +321,8 @@ private:
     void generateElementIsNthChildOf(Assembler::JumpList& failureCases, const SelectorFragment&);
     void generateElementIsNthLastChild(Assembler::JumpList& failureCases, const SelectorFragment&);
     void generateElementIsNthLastChildOf(Assembler::JumpList& failureCases, const SelectorFragment&);
+    void generateElementIsNthOfType(Assembler::JumpList& failureCases, const SelectorFragment&);
+    void generateElementIsNthLastOfType(Assembler::JumpList& failureCases, const SelectorFragment&);
     void generateElementMatchesNotPseudoClass(Assembler::JumpList& failureCases, const SelectorFragment&);
     void generateElementMatchesAnyPseudoClass(Assembler::JumpList& failureCases, const SelectorFragment&);
     void generateElementMatchesMatchesPseudoClass(Assembler::JumpList& failureCases, const SelectorFragment&);
@@ -334,6 +341,7 @@ private:
     void generateStoreLastVisitedElement(Assembler::RegisterID element);
     void generateMarkPseudoStyleForPseudoElement(Assembler::JumpList& failureCases, const SelectorFragment&);
     void generateNthFilterTest(Assembler::JumpList& failureCases, Assembler::RegisterID counter, int a, int b);
+    void generateJumpIfTagNameDiffersFromElement(Assembler::JumpList& differentTagNameCases, Assembler::RegisterID otherElement);
     void generateRequestedPseudoElementEqualsToSelectorPseudoElement(Assembler::JumpList& failureCases, const SelectorFragment&, Assembler::RegisterID checkingContext);
     void generateSpecialFailureInQuirksModeForActiveAndHoverIfNeeded(Assembler::JumpList& failureCases, const SelectorFragment&);
     Assembler::JumpList jumpIfNoPreviousAdjacentElement();
@@ -527,6 +535,28 @@ static FunctionType addNthChildType(const CSSSelector& selector, SelectorContext
     return FunctionType::SelectorCheckerWithCheckingContext;
 }
 
+// Handle the forward :nth-of-type() and backward :nth-last-of-type().
+static FunctionType addNthOfTypeType(const CSSSelector& selector, SelectorContext selectorContext, CSSSelector::PseudoClassType firstMatchAlternative, Vector<std::pair<int, int>, 2>& simpleCases, HashSet<unsigned>& pseudoClasses)
+{
+    if (!selector.parseNth())
+        return FunctionType::CannotMatchAnything;
+
+    int a = selector.nthA();
+    int b = selector.nthB();
+
+    // The element count is always positive.
+    if (a <= 0 && b < 1)
+        return FunctionType::CannotMatchAnything;
+
+    if (b == 1 && a <= 0)
+        pseudoClasses.add(firstMatchAlternative);
+    else
+        simpleCases.append(std::pair<int, int>(a, b));
+    if (selectorContext == SelectorContext::QuerySelector)
+        return FunctionType::SimpleSelectorChecker;
+    return FunctionType::SelectorCheckerWithCheckingContext;
+}
+
 static inline FunctionType addPseudoClassType(const CSSSelector& selector, SelectorFragment& fragment, unsigned& internalSpecificity, SelectorContext selectorContext, FragmentsLevel fragmentLevel, FragmentPositionInRootFragments positionInRootFragments, bool visitedMatchEnabled, VisitedMode& visitedMode, PseudoElementMatchingBehavior pseudoElementMatchingBehavior)
 {
     CSSSelector::PseudoClassType type = selector.pseudoClassType();
@@ -623,18 +653,12 @@ static inline FunctionType addPseudoClassType(const CSSSelector& selector, Selec
     case CSSSelector::PseudoClassCornerPresent:
         return FunctionType::CannotMatchAnything;
 
-    // FIXME: Compile these pseudoclasses, too!
-    case CSSSelector::PseudoClassFirstOfType:
-    case CSSSelector::PseudoClassLastOfType:
-    case CSSSelector::PseudoClassOnlyOfType:
-    case CSSSelector::PseudoClassNthOfType:
-    case CSSSelector::PseudoClassNthLastOfType:
-    case CSSSelector::PseudoClassDrag:
 #if ENABLE(CSS_SELECTORS_LEVEL4)
+    // FIXME: Implement :dir() and :role(). SelectorChecker never matches them either.
     case CSSSelector::PseudoClassDir:
     case CSSSelector::PseudoClassRole:
+        return FunctionType::CannotMatchAnything;
 #endif
-        return FunctionType::CannotCompile;
 
     // Optimized pseudo selectors.
     case CSSSelector::PseudoClassAnyLink:
@@ -670,11 +694,15 @@ static inline FunctionType addPseudoClassType(const CSSSelector& selector, Selec
         return FunctionType::SelectorCheckerWithCheckingContext;
 
     case CSSSelector::PseudoClassActive:
+    case CSSSelector::PseudoClassDrag:
     case CSSSelector::PseudoClassEmpty:
     case CSSSelector::PseudoClassFirstChild:
+    case CSSSelector::PseudoClassFirstOfType:
     case CSSSelector::PseudoClassHover:
     case CSSSelector::PseudoClassLastChild:
+    case CSSSelector::PseudoClassLastOfType:
     case CSSSelector::PseudoClassOnlyChild:
+    case CSSSelector::PseudoClassOnlyOfType:
     case CSSSelector::PseudoClassPlaceholderShown:
     case CSSSelector::PseudoClassFocusWithin:
         fragment.pseudoClasses.add(type);
@@ -688,6 +716,12 @@ static inline FunctionType addPseudoClassType(const CSSSelector& selector, Selec
     case CSSSelector::PseudoClassNthLastChild:
         return addNthChildType(selector, selectorContext, positionInRootFragments, CSSSelector::PseudoClassLastChild, visitedMatchEnabled, fragment.nthLastChildFilters, fragment.nthLastChildOfFilters, fragment.pseudoClasses, internalSpecificity);
 
+    case CSSSelector::PseudoClassNthOfType:
+        return addNthOfTypeType(selector, selectorContext, CSSSelector::PseudoClassFirstOfType, fragment.nthOfTypeFilters, fragment.pseudoClasses);
+
+    case CSSSelector::PseudoClassNthLastOfType:
+        return addNthOfTypeType(selector, selectorContext, CSSSelector::PseudoClassLastOfType, fragment.nthLastOfTypeFilters, fragment.pseudoClasses);
+
     case CSSSelector::PseudoClassNot:
         {
             const CSSSelectorList* selectorList = selector.selectorList();
@@ -1069,6 +1103,7 @@ static const unsigned minimumRequiredRegisterCountForAttributeFilter = 6;
 // On x86, we always need 6 registers: Element + SiblingCounter + SiblingCounterCopy + divisor + dividend + remainder.
 // On other architectures, we need 6 registers for style resolution:
 //     Element + elementCounter + previousSibling + checkingContext + lastRelation + nextSiblingElement.
+// The *-of-type filters need as many to compare tag names: Element + elementCounter + sibling + 2 QualifiedNameImpls + name.
 static const unsigned minimumRequiredRegisterCountForNthChildFilter = 6;
 
 static unsigned minimumRegisterRequirements(const SelectorFragment& selectorFragment)
@@ -1096,6 +1131,12 @@ static unsigned minimumRegisterRequirements(const SelectorFragment& selectorFrag
     if (!selectorFragment.nthChildFilters.isEmpty() || !selectorFragment.nthChildOfFilters.isEmpty() || !selectorFragment.nthLastChildFilters.isEmpty() || !selectorFragment.nthLastChildOfFilters.isEmpty())
         minimum = std::max(minimum, minimumRequiredRegisterCountForNthChildFilter);
 
+    if (!selectorFragment.nthOfTypeFilters.isEmpty() || !selectorFragment.nthLastOfTypeFilters.isEmpty()
+        || selectorFragment.pseudoClasses.contains(CSSSelector::PseudoClassFirstOfType)
+        || selectorFragment.pseudoClasses.contains(CSSSelector::PseudoClassLastOfType)
+        || selectorFragment.pseudoClasses.contains(CSSSelector::PseudoClassOnlyOfType))
+        minimum = std::max(minimum, minimumRequiredRegisterCountForNthChildFilter);
+
     // :any pseudo class filters cause some register pressure.
     for (const auto& subFragments : selectorFragment.anyFilters) {
         for (const SelectorFragment& subFragment : subFragments) {
@@ -2596,6 +2637,16 @@ void SelectorCodeGenerator::generateElementMatching(Assembler::JumpList& matchin
         generateElementIsNthChild(matchingPostTagNameFailureCases, fragment);
     if (!fragment.nthLastChildFilters.isEmpty())
         generateElementIsNthLastChild(matchingPostTagNameFailureCases, fragment);
+    if (fragment.pseudoClasses.contains(CSSSelector::PseudoClassFirstOfType) || fragment.pseudoClasses.contains(CSSSelector::PseudoClassOnlyOfType))
+        generateElementIsFirstOfType(matchingPostTagNameFailureCases, fragment);
+    if (fragment.pseudoClasses.contains(CSSSelector::PseudoClassLastOfType) || fragment.pseudoClasses.contains(CSSSelector::PseudoClassOnlyOfType))
+        generateElementIsLastOfType(matchingPostTagNameFailureCases);
+    if (!fragment.nthOfTypeFilters.isEmpty())
+        generateElementIsNthOfType(matchingPostTagNameFailureCases, fragment);
+    if (!fragment.nthLastOfTypeFilters.isEmpty())
+        generateElementIsNthLastOfType(matchingPostTagNameFailureCases, fragment);
+    if (fragment.pseudoClasses.contains(CSSSelector::PseudoClassDrag))
+        generateElementIsDragged(matchingPostTagNameFailureCases);
     if (!fragment.notFilters.isEmpty())
         generateElementMatchesNotPseudoClass(matchingPostTagNameFailureCases, fragment);
     if (!fragment.anyFilters.isEmpty())
@@ -3360,6 +3411,21 @@ static bool isPlaceholderShown(const Element* element)
     return is<HTMLTextFormControlElement>(*element) && downcast<HTMLTextFormControlElement>(*element).isPlaceholderVisible();
 }
 
+static bool elementIsDragged(const Element* element)
+{
+    return element->renderer() && element->renderer()->isDragging();
+}
+
+void SelectorCodeGenerator::generateElementIsDragged(Assembler::JumpList& failureCases)
+{
+    generateAddStyleRelationIfResolvingStyle(elementAddressRegister, Style::Relation::AffectedByDrag);
+
+    FunctionCall functionCall(m_assembler, m_registerAllocator, m_stackAllocator, m_functionCalls);
+    functionCall.setFunctionAddress(elementIsDragged);
+    functionCall.setOneArgument(elementAddressRegister);
+    failureCases.append(functionCall.callAndBranchOnBooleanReturnValue(Assembler::Zero));
+}
+
 void SelectorCodeGenerator::generateElementHasPlaceholderShown(Assembler::JumpList& failureCases)
 {
     if (m_selectorContext == SelectorContext::QuerySelector) {
@@ -3699,6 +3765,186 @@ void SelectorCodeGenerator::generateElementIsNthLastChildOf(Assembler::JumpList&
     }
 }
 
+void SelectorCodeGenerator::generateJumpIfTagNameDiffersFromElement(Assembler::JumpList& differentTagNameCases, Assembler::RegisterID otherElement)
+{
+    // Same as !otherElement->hasTagName(element->tagQName()). Tag names that only differ by their prefix have different QualifiedNameImpls.
+    LocalRegister qualifiedNameImpl(m_registerAllocator);
+    m_assembler.loadPtr(Assembler::Address(elementAddressRegister, Element::tagQNameMemoryOffset() + QualifiedName::implMemoryOffset()), qualifiedNameImpl);
+    LocalRegister otherQualifiedNameImpl(m_registerAllocator);
+    m_assembler.loadPtr(Assembler::Address(otherElement, Element::tagQNameMemoryOffset() + QualifiedName::implMemoryOffset()), otherQualifiedNameImpl);
+    Assembler::Jump sameTagName = m_assembler.branchPtr(Assembler::Equal, qualifiedNameImpl, otherQualifiedNameImpl);
+
+    LocalRegister name(m_registerAllocator);
+    m_assembler.loadPtr(Assembler::Address(otherQualifiedNameImpl, QualifiedName::QualifiedNameImpl::localNameMemoryOffset()), name);
+    differentTagNameCases.append(m_assembler.branchPtr(Assembler::NotEqual, name, Assembler::Address(qualifiedNameImpl, QualifiedName::QualifiedNameImpl::localNameMemoryOffset())));
+    m_assembler.loadPtr(Assembler::Address(otherQualifiedNameImpl, QualifiedName::QualifiedNameImpl::namespaceMemoryOffset()), name);
+    differentTagNameCases.append(m_assembler.branchPtr(Assembler::NotEqual, name, Assembler::Address(qualifiedNameImpl, QualifiedName::QualifiedNameImpl::namespaceMemoryOffset())));
+
+    sameTagName.link(&m_assembler);
+}
+
+void SelectorCodeGenerator::generateElementIsFirstOfType(Assembler::JumpList& failureCases, const SelectorFragment& fragment)
+{
+    {
+        LocalRegister parentElement(m_registerAllocator);
+        generateWalkToParentElement(failureCases, parentElement);
+    }
+
+    if (!isAdjacentRelation(fragment.relationToRightFragment))
+        generateAddStyleRelationIfResolvingStyle(elementAddressRegister, Style::Relation::AffectedByPreviousSibling);
+
+    // Fail on the first previous adjacent element with the same tag name.
+    LocalRegister previousSibling(m_registerAllocator);
+    m_assembler.move(elementAddressRegister, previousSibling);
+
+    Assembler::JumpList noMoreSiblingsCases;
+    Assembler::Label loopStart = m_assembler.label();
+    generateWalkToPreviousAdjacentElement(noMoreSiblingsCases, previousSibling);
+    generateAddStyleRelationIfResolvingStyle(previousSibling, Style::Relation::AffectsNextSibling);
+
+    Assembler::JumpList differentTagNameCases;
+    generateJumpIfTagNameDiffersFromElement(differentTagNameCases, previousSibling);
+    failureCases.append(m_assembler.jump());
+    differentTagNameCases.linkTo(loopStart, &m_assembler);
+
+    noMoreSiblingsCases.link(&m_assembler);
+}
+
+void SelectorCodeGenerator::generateElementIsLastOfType(Assembler::JumpList& failureCases)
+{
+    {
+        LocalRegister parentElement(m_registerAllocator);
+        generateWalkToParentElement(failureCases, parentElement);
+
+        generateAddStyleRelationIfResolvingStyle(parentElement, Style::Relation::ChildrenAffectedByBackwardPositionalRules);
+
+        failureCases.append(m_assembler.branchTest32(Assembler::Zero, Assembler::Address(parentElement, Node::nodeFlagsMemoryOffset()), Assembler::TrustedImm32(Node::flagIsParsingChildrenFinished())));
+    }
+
+    // Fail on the first following adjacent element with the same tag name.
+    LocalRegister nextSibling(m_registerAllocator);
+    m_assembler.move(elementAddressRegister, nextSibling);
+
+    Assembler::JumpList noMoreSiblingsCases;
+    Assembler::Label loopStart = m_assembler.label();
+    generateWalkToNextAdjacentElement(noMoreSiblingsCases, nextSibling);
+
+    Assembler::JumpList differentTagNameCases;
+    generateJumpIfTagNameDiffersFromElement(differentTagNameCases, nextSibling);
+    failureCases.append(m_assembler.jump());
+    differentTagNameCases.linkTo(loopStart, &m_assembler);
+
+    noMoreSiblingsCases.link(&m_assembler);
+}
+
+void SelectorCodeGenerator::generateElementIsNthOfType(Assembler::JumpList& failureCases, const SelectorFragment& fragment)
+{
+    {
+        LocalRegister parentElement(m_registerAllocator);
+        generateWalkToParentElement(failureCases, parentElement);
+    }
+
+    Vector<std::pair<int, int>, 32> validSubsetFilters;
+    validSubsetFilters.reserveInitialCapacity(fragment.nthOfTypeFilters.size());
+    for (const auto& slot : fragment.nthOfTypeFilters) {
+        if (nthFilterIsAlwaysSatisified(slot.first, slot.second))
+            continue;
+        validSubsetFilters.uncheckedAppend(slot);
+    }
+    if (validSubsetFilters.isEmpty())
+        return;
+
+    if (!isAdjacentRelation(fragment.relationToRightFragment))
+        generateAddStyleRelationIfResolvingStyle(elementAddressRegister, Style::Relation::AffectedByPreviousSibling);
+
+    // Setup the counter at 1.
+    LocalRegisterWithPreference elementCounter(m_registerAllocator, JSC::GPRInfo::argumentGPR1);
+    m_assembler.move(Assembler::TrustedImm32(1), elementCounter);
+
+    // Loop over the previous adjacent elements and count those with the same tag name. Like for :nth-child(),
+    // the first of them with a cached index tells how many there are up to it.
+    {
+        LocalRegister previousSibling(m_registerAllocator);
+        m_assembler.move(elementAddressRegister, previousSibling);
+
+        Assembler::JumpList noMoreSiblingsCases;
+        Assembler::Label loopStart = m_assembler.label();
+        generateWalkToPreviousAdjacentElement(noMoreSiblingsCases, previousSibling);
+        generateAddStyleRelationIfResolvingStyle(previousSibling, Style::Relation::AffectsNextSibling);
+
+        Assembler::JumpList differentTagNameCases;
+        generateJumpIfTagNameDiffersFromElement(differentTagNameCases, previousSibling);
+        differentTagNameCases.linkTo(loopStart, &m_assembler);
+
+        Assembler::JumpList noCachedChildIndexCases;
+        noCachedChildIndexCases.append(m_assembler.branchTest32(Assembler::Zero, Assembler::Address(previousSibling, Node::nodeFlagsMemoryOffset()), Assembler::TrustedImm32(Node::flagHasRareData())));
+        {
+            LocalRegister elementRareData(m_registerAllocator);
+            m_assembler.loadPtr(Assembler::Address(previousSibling, Node::rareDataMemoryOffset()), elementRareData);
+            LocalRegister cachedChildIndex(m_registerAllocator);
+            m_assembler.load16(Assembler::Address(elementRareData, ElementRareData::childIndexOfTypeMemoryOffset()), cachedChildIndex);
+            noCachedChildIndexCases.append(m_assembler.branchTest32(Assembler::Zero, cachedChildIndex));
+            m_assembler.add32(cachedChildIndex, elementCounter);
+            noMoreSiblingsCases.append(m_assembler.jump());
+        }
+        noCachedChildIndexCases.link(&m_assembler);
+        m_assembler.add32(Assembler::TrustedImm32(1), elementCounter);
+        m_assembler.jump().linkTo(loopStart, &m_assembler);
+
+        noMoreSiblingsCases.link(&m_assembler);
+    }
+
+    generateAddStyleRelationIfResolvingStyle(elementAddressRegister, Style::Relation::NthChildIndexOfType, Assembler::RegisterID(elementCounter));
+
+    for (const auto& slot : validSubsetFilters)
+        generateNthFilterTest(failureCases, elementCounter, slot.first, slot.second);
+}
+
+void SelectorCodeGenerator::generateElementIsNthLastOfType(Assembler::JumpList& failureCases, const SelectorFragment& fragment)
+{
+    Vector<std::pair<int, int>, 32> validSubsetFilters;
+    validSubsetFilters.reserveInitialCapacity(fragment.nthLastOfTypeFilters.size());
+    { // :nth-last-of-type() must have a parent to match. If there is a parent, do the invalidation marking.
+        LocalRegister parentElement(m_registerAllocator);
+        generateWalkToParentElement(failureCases, parentElement);
+
+        generateAddStyleRelationIfResolvingStyle(parentElement, Style::Relation::ChildrenAffectedByBackwardPositionalRules);
+
+        failureCases.append(m_assembler.branchTest32(Assembler::Zero, Assembler::Address(parentElement, Node::nodeFlagsMemoryOffset()), Assembler::TrustedImm32(Node::flagIsParsingChildrenFinished())));
+
+        for (const auto& slot : fragment.nthLastOfTypeFilters) {
+            if (nthFilterIsAlwaysSatisified(slot.first, slot.second))
+                continue;
+            validSubsetFilters.uncheckedAppend(slot);
+        }
+        if (validSubsetFilters.isEmpty())
+            return;
+    }
+
+    LocalRegister elementCounter(m_registerAllocator);
+    { // Loop over the following sibling elements and count those with the same tag name.
+        LocalRegister nextSibling(m_registerAllocator);
+        m_assembler.move(elementAddressRegister, nextSibling);
+        // Setup the counter at 1.
+        m_assembler.move(Assembler::TrustedImm32(1), elementCounter);
+
+        Assembler::JumpList noMoreSiblingsCases;
+        Assembler::Label loopStart = m_assembler.label();
+        generateWalkToNextAdjacentElement(noMoreSiblingsCases, nextSibling);
+
+        Assembler::JumpList differentTagNameCases;
+        generateJumpIfTagNameDiffersFromElement(differentTagNameCases, nextSibling);
+        differentTagNameCases.linkTo(loopStart, &m_assembler);
+
+        m_assembler.add32(Assembler::TrustedImm32(1), elementCounter);
+        m_assembler.jump().linkTo(loopStart, &m_assembler);
+        noMoreSiblingsCases.link(&m_assembler);
+    }
+
+    for (const auto& slot : validSubsetFilters)
+        generateNthFilterTest(failureCases, elementCounter, slot.first, slot.second);
+}
+
 void SelectorCodeGenerator::generateElementMatchesNotPseudoClass(Assembler::JumpList& failureCases, const SelectorFragment& fragment)
 {
     Assembler::JumpList localFailureCases;
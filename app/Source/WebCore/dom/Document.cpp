@@ -6350,6 +6350,9 @@ void Document::updateLastHandledUserGestureTimestamp()
 void Document::startTrackingStyleRecalcs()
 {
     m_styleRecalcCount = 0;
+    m_styleResolvedElementCount = 0;
+    m_styleChangedElementCount = 0;
+    m_styleParallelMatchedElementCount = 0;
 }
 
 unsigned Document::styleRecalcCount() const
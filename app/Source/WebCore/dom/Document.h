@@ -1156,6 +1156,31 @@ public:
     WEBCORE_EXPORT void startTrackingStyleRecalcs();
     WEBCORE_EXPORT unsigned styleRecalcCount() const;
 
+    // Elements whose style was resolved since tracking started, and how many of those ended up with a different style.
+    void didResolveElementStyle(bool styleChanged)
+    {
+        ++m_styleResolvedElementCount;
+        if (styleChanged)
+            ++m_styleChangedElementCount;
+    }
+    unsigned styleResolvedElementCount() const { return m_styleResolvedElementCount; }
+    unsigned styleChangedElementCount() const { return m_styleChangedElementCount; }
+
+    // Elements whose rules Style::ParallelRuleMatcher matched on worker threads since tracking started.
+    void didMatchRulesInParallel(unsigned elementCount) { m_styleParallelMatchedElementCount += elementCount; }
+    unsigned styleParallelMatchedElementCount() const { return m_styleParallelMatchedElementCount; }
+
+    // Selectors the CSS JIT could not compile while matching them against this document. They run in SelectorChecker instead.
+    void didFailToCompileSelector() { ++m_selectorCompilationFailureCount; }
+    unsigned selectorCompilationFailureCount() const { return m_selectorCompilationFailureCount; }
+
+    // Token chunks a BackgroundHTMLParser sent to this document's parser, and how many times the parser
+    // threw its tokens away and had it resume from a checkpoint.
+    void didReceiveBackgroundParsedChunk() { ++m_backgroundParsedChunkCount; }
+    unsigned backgroundParsedChunkCount() const { return m_backgroundParsedChunkCount; }
+    void didDiscardParserSpeculations() { ++m_discardedParserSpeculationCount; }
+    unsigned discardedParserSpeculationCount() const { return m_discardedParserSpeculationCount; }
+
     void didAddTouchEventHandler(Node&);
     void didRemoveTouchEventHandler(Node&, EventHandlerRemoval = EventHandlerRemoval::One);
 
@@ -1482,6 +1507,12 @@ private:
     unsigned m_ignoreOpensDuringUnloadCount { 0 };
 
     unsigned m_styleRecalcCount { 0 };
+    unsigned m_styleResolvedElementCount { 0 };
+    unsigned m_styleChangedElementCount { 0 };
+    unsigned m_styleParallelMatchedElementCount { 0 };
+    unsigned m_selectorCompilationFailureCount { 0 };
+    unsigned m_backgroundParsedChunkCount { 0 };
+    unsigned m_discardedParserSpeculationCount { 0 };
 
     StringWithDirection m_title;
     StringWithDirection m_rawTitle;
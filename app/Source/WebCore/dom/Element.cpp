@@ -2745,6 +2745,11 @@ void Element::setChildIndex(unsigned index)
     rareData.setChildIndex(index);
 }
 
+void Element::setChildIndexOfType(unsigned index)
+{
+    ensureElementRareData().setChildIndexOfType(index);
+}
+
 bool Element::hasFlagsSetDuringStylingOfChildren() const
 {
     if (childrenAffectedByHover() || childrenAffectedByFirstChildRules() || childrenAffectedByLastChildRules())
@@ -2806,6 +2811,12 @@ unsigned Element::rareDataChildIndex() const
     return elementRareData()->childIndex();
 }
 
+unsigned Element::rareDataChildIndexOfType() const
+{
+    ASSERT(hasRareData());
+    return elementRareData()->childIndexOfType();
+}
+
 void Element::setRegionOversetState(RegionOversetState state)
 {
     ensureElementRareData().setRegionOversetState(state);
@@ -329,6 +329,7 @@ public:
     bool childrenAffectedByPropertyBasedBackwardPositionalRules() const { return hasRareData() && rareDataChildrenAffectedByPropertyBasedBackwardPositionalRules(); }
     bool affectsNextSiblingElementStyle() const { return getFlag(AffectsNextSiblingElementStyle); }
     unsigned childIndex() const { return hasRareData() ? rareDataChildIndex() : 0; }
+    unsigned childIndexOfType() const { return hasRareData() ? rareDataChildIndexOfType() : 0; }
 
     bool hasFlagsSetDuringStylingOfChildren() const;
 
@@ -344,6 +345,7 @@ public:
     void setAffectsNextSiblingElementStyle() { setFlag(AffectsNextSiblingElementStyle); }
     void setStyleIsAffectedByPreviousSibling() { setFlag(StyleIsAffectedByPreviousSibling); }
     void setChildIndex(unsigned);
+    void setChildIndexOfType(unsigned);
 
     void setRegionOversetState(RegionOversetState);
     RegionOversetState regionOversetState() const;
@@ -661,6 +663,7 @@ private:
     bool rareDataChildrenAffectedByBackwardPositionalRules() const;
     bool rareDataChildrenAffectedByPropertyBasedBackwardPositionalRules() const;
     unsigned rareDataChildIndex() const;
+    unsigned rareDataChildIndexOfType() const;
 
     SpellcheckAttributeState spellcheckAttributeState() const;
 
@@ -90,6 +90,10 @@ public:
     void setChildIndex(unsigned index) { m_childIndex = index; }
     static ptrdiff_t childIndexMemoryOffset() { return OBJECT_OFFSETOF(ElementRareData, m_childIndex); }
 
+    unsigned childIndexOfType() const { return m_childIndexOfType; }
+    void setChildIndexOfType(unsigned index) { m_childIndexOfType = index; }
+    static ptrdiff_t childIndexOfTypeMemoryOffset() { return OBJECT_OFFSETOF(ElementRareData, m_childIndexOfType); }
+
     void clearShadowRoot() { m_shadowRoot = nullptr; }
     ShadowRoot* shadowRoot() const { return m_shadowRoot.get(); }
     void setShadowRoot(RefPtr<ShadowRoot>&& shadowRoot) { m_shadowRoot = WTFMove(shadowRoot); }
@@ -124,6 +128,8 @@ public:
 private:
     int m_tabIndex;
     unsigned short m_childIndex;
+    // Like m_childIndex but only counting siblings with the same tag name, for :nth-of-type().
+    unsigned short m_childIndexOfType;
     unsigned m_tabIndexWasSetExplicitly : 1;
     unsigned m_needsFocusAppearanceUpdateSoonAfterAttach : 1;
     unsigned m_styleAffectedByActive : 1;
@@ -171,6 +177,7 @@ inline ElementRareData::ElementRareData(RenderElement* renderer)
     : NodeRareData(renderer)
     , m_tabIndex(0)
     , m_childIndex(0)
+    , m_childIndexOfType(0)
     , m_tabIndexWasSetExplicitly(false)
     , m_needsFocusAppearanceUpdateSoonAfterAttach(false)
     , m_styleAffectedByActive(false)
@@ -218,6 +225,7 @@ inline void ElementRareData::resetComputedStyle()
     setStyleAffectedByEmpty(false);
     setStyleAffectedByFocusWithin(false);
     setChildIndex(0);
+    setChildIndexOfType(0);
 }
 
 inline void ElementRareData::resetDynamicRestyleObservations()
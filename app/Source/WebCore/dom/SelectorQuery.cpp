@@ -481,6 +481,8 @@ bool SelectorDataList::compileSelector(const SelectorData& selectorData, const C
 
     JSC::VM& vm = rootNode.document().scriptExecutionContext()->vm();
     selectorData.compilationStatus = SelectorCompiler::compileSelector(selectorData.selector, &vm, SelectorCompiler::SelectorContext::QuerySelector, selectorData.compiledSelectorCodeRef);
+    if (selectorData.compilationStatus == SelectorCompilationStatus::CannotCompile)
+        rootNode.document().didFailToCompileSelector();
     return isCompiledSelector(selectorData.compilationStatus);
 }
 
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include "CompactHTMLToken.h"
 #include "HTMLToken.h"
 
 namespace WebCore {
@@ -33,6 +34,7 @@ namespace WebCore {
 class AtomicHTMLToken {
 public:
     explicit AtomicHTMLToken(HTMLToken&);
+    explicit AtomicHTMLToken(CompactHTMLToken&);
     AtomicHTMLToken(HTMLToken::Type, const AtomicString& name, Vector<Attribute>&& = { }); // Only StartTag or EndTag.
 
     AtomicHTMLToken(const AtomicHTMLToken&) = delete;
@@ -72,14 +74,14 @@ public:
 private:
     HTMLToken::Type m_type;
 
-    void initializeAttributes(const HTMLToken::AttributeList& attributes);
+    template<typename AttributeList> void initializeAttributes(const AttributeList&);
 
     AtomicString m_name; // StartTag, EndTag, DOCTYPE.
 
     String m_data; // Comment
 
     // We don't want to copy the the characters out of the HTMLToken, so we keep a pointer to its buffer instead.
-    // This buffer is owned by the HTMLToken and causes a lifetime dependence between these objects.
+    // This buffer is owned by the HTMLToken (or CompactHTMLToken) and causes a lifetime dependence between these objects.
     // FIXME: Add a mechanism for "internalizing" the characters when the HTMLToken is destroyed.
     const UChar* m_externalCharacters; // Character
     unsigned m_externalCharactersLength; // Character
@@ -191,7 +193,8 @@ inline bool hasAttribute(const Vector<Attribute>& attributes, const AtomicString
     return false;
 }
 
-inline void AtomicHTMLToken::initializeAttributes(const HTMLToken::AttributeList& attributes)
+template<typename AttributeList>
+inline void AtomicHTMLToken::initializeAttributes(const AttributeList& attributes)
 {
     unsigned size = attributes.size();
     if (!size)
@@ -244,6 +247,37 @@ inline AtomicHTMLToken::AtomicHTMLToken(HTMLToken& token)
     ASSERT_NOT_REACHED();
 }
 
+inline AtomicHTMLToken::AtomicHTMLToken(CompactHTMLToken& token)
+    : m_type(token.type())
+{
+    switch (m_type) {
+    case HTMLToken::Uninitialized:
+        ASSERT_NOT_REACHED();
+        return;
+    case HTMLToken::DOCTYPE:
+        m_name = AtomicString(token.name());
+        m_doctypeData = token.releaseDoctypeData();
+        return;
+    case HTMLToken::EndOfFile:
+        return;
+    case HTMLToken::StartTag:
+    case HTMLToken::EndTag:
+        m_selfClosing = token.selfClosing();
+        m_name = AtomicString(token.name());
+        initializeAttributes(token.attributes());
+        return;
+    case HTMLToken::Comment:
+        m_data = token.comment();
+        return;
+    case HTMLToken::Character:
+        m_externalCharacters = token.characters().characters16();
+        m_externalCharactersLength = token.characters().length();
+        m_externalCharactersIsAll8BitData = token.charactersIsAll8BitData();
+        return;
+    }
+    ASSERT_NOT_REACHED();
+}
+
 inline AtomicHTMLToken::AtomicHTMLToken(HTMLToken::Type type, const AtomicString& name, Vector<Attribute>&& attributes)
     : m_type(type)
     , m_name(name)
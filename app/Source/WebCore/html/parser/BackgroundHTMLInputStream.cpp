@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "BackgroundHTMLInputStream.h"
+
+namespace WebCore {
+
+void BackgroundHTMLInputStream::append(const String& input)
+{
+    m_current.append(input);
+    m_segments.append(input);
+}
+
+void BackgroundHTMLInputStream::close()
+{
+    m_current.close();
+}
+
+auto BackgroundHTMLInputStream::createCheckpoint() -> CheckpointID
+{
+    CheckpointID checkpoint = m_checkpoints.size();
+    auto newCheckpoint = std::make_unique<Checkpoint>();
+    newCheckpoint->input = m_current;
+    newCheckpoint->numberOfSegmentsAlreadyAppended = m_segments.size();
+    m_checkpoints.append(WTFMove(newCheckpoint));
+    return checkpoint;
+}
+
+void BackgroundHTMLInputStream::invalidateCheckpointsBefore(CheckpointID newFirstValidCheckpointID)
+{
+    ASSERT(newFirstValidCheckpointID < m_checkpoints.size());
+    if (newFirstValidCheckpointID <= m_firstValidCheckpointID)
+        return;
+
+    // Rewinding to a checkpoint only needs the segments appended after it.
+    releaseSegmentsBefore(m_checkpoints[newFirstValidCheckpointID]->numberOfSegmentsAlreadyAppended);
+    releaseCheckpointsBefore(newFirstValidCheckpointID);
+}
+
+void BackgroundHTMLInputStream::rewindTo(CheckpointID checkpointID, const String& unparsedInput)
+{
+    ASSERT(checkpointID >= m_firstValidCheckpointID);
+    ASSERT(checkpointID < m_checkpoints.size());
+    auto& checkpoint = *m_checkpoints[checkpointID];
+
+    bool isClosed = m_current.isClosed();
+    if (unparsedInput.isEmpty())
+        m_current = checkpoint.input;
+    else {
+        // Like InsertionPointRecord, number the lines as if the unparsed input were not there.
+        auto line = checkpoint.input.currentLine();
+        auto column = checkpoint.input.currentColumn();
+        m_current = SegmentedString(unparsedInput);
+        m_current.append(checkpoint.input);
+        m_current.setCurrentPosition(line, column, unparsedInput.length());
+    }
+    for (size_t i = checkpoint.numberOfSegmentsAlreadyAppended; i < m_segments.size(); ++i)
+        m_current.append(m_segments[i]);
+    if (isClosed && !m_current.isClosed())
+        m_current.close();
+
+    // Checkpoint IDs keep counting up, so that the main thread cannot mistake an old one for a new one.
+    releaseSegmentsBefore(m_segments.size());
+    releaseCheckpointsBefore(m_checkpoints.size());
+}
+
+void BackgroundHTMLInputStream::releaseSegmentsBefore(size_t newFirstValidSegmentIndex)
+{
+    for (size_t i = m_firstValidSegmentIndex; i < newFirstValidSegmentIndex; ++i)
+        m_segments[i] = String();
+    m_firstValidSegmentIndex = newFirstValidSegmentIndex;
+}
+
+void BackgroundHTMLInputStream::releaseCheckpointsBefore(CheckpointID newFirstValidCheckpointID)
+{
+    for (CheckpointID i = m_firstValidCheckpointID; i < newFirstValidCheckpointID; ++i)
+        m_checkpoints[i] = nullptr;
+    m_firstValidCheckpointID = newFirstValidCheckpointID;
+}
+
+} // namespace WebCore
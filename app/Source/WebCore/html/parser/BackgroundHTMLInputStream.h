@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "SegmentedString.h"
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+// The input of a BackgroundHTMLParser. It keeps everything since the oldest checkpoint the main
+// thread may still rewind to, so that tokenizing can start over from there after document.write().
+class BackgroundHTMLInputStream {
+    WTF_MAKE_NONCOPYABLE(BackgroundHTMLInputStream);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    typedef size_t CheckpointID;
+
+    BackgroundHTMLInputStream() = default;
+
+    void append(const String&);
+    void close();
+
+    SegmentedString& current() { return m_current; }
+
+    CheckpointID createCheckpoint();
+
+    // The main thread has got past the given checkpoint, so it will not rewind to any before it.
+    void invalidateCheckpointsBefore(CheckpointID);
+
+    // Tokenizing starts over from the checkpoint, after the unparsed input. All checkpoints become invalid.
+    void rewindTo(CheckpointID, const String& unparsedInput);
+
+private:
+    void releaseSegmentsBefore(size_t);
+    void releaseCheckpointsBefore(CheckpointID);
+
+    struct Checkpoint {
+        WTF_MAKE_FAST_ALLOCATED;
+    public:
+        SegmentedString input;
+        size_t numberOfSegmentsAlreadyAppended { 0 };
+    };
+
+    SegmentedString m_current;
+    Vector<String> m_segments;
+    size_t m_firstValidSegmentIndex { 0 };
+    Vector<std::unique_ptr<Checkpoint>> m_checkpoints;
+    CheckpointID m_firstValidCheckpointID { 0 };
+};
+
+} // namespace WebCore
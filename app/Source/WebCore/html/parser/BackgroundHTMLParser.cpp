@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "BackgroundHTMLParser.h"
+
+#include "HTMLDocumentParser.h"
+#include "HTMLNames.h"
+#include "HTMLParserIdioms.h"
+#include <wtf/MainThread.h>
+#include <wtf/WorkQueue.h>
+
+namespace WebCore {
+
+using namespace HTMLNames;
+
+// Tokens are sent to the main thread in chunks of about this many, so that it can start building
+// the tree before the whole document is tokenized without paying for a dispatch per token.
+static const size_t pendingTokenLimit = 500;
+
+static WorkQueue& backgroundParserQueue()
+{
+    static auto& queue = WorkQueue::create("org.webkit.BackgroundHTMLParser").leakRef();
+    return queue;
+}
+
+Ref<BackgroundHTMLParser> BackgroundHTMLParser::create(HTMLDocumentParser& parser, const HTMLParserOptions& options)
+{
+    return adoptRef(*new BackgroundHTMLParser(parser, options));
+}
+
+BackgroundHTMLParser::BackgroundHTMLParser(HTMLDocumentParser& parser, const HTMLParserOptions& options)
+    : m_parser(&parser)
+    , m_options(options)
+    , m_tokenizer(std::make_unique<HTMLTokenizer>(m_options))
+    , m_treeBuilderSimulator(m_options)
+    , m_pendingChunk(std::make_unique<ParsedChunk>())
+{
+}
+
+void BackgroundHTMLParser::append(String&& input)
+{
+    ASSERT(isMainThread());
+    ASSERT(!m_isFinished);
+
+    backgroundParserQueue().dispatch([protectedThis = makeRef(*this), input = WTFMove(input).isolatedCopy()] {
+        protectedThis->m_input.append(input);
+        protectedThis->pumpTokenizer();
+    });
+}
+
+void BackgroundHTMLParser::finish()
+{
+    ASSERT(isMainThread());
+
+    // Like HTMLDocumentParser::finish(), this can be called more than once.
+    if (m_isFinished)
+        return;
+    m_isFinished = true;
+
+    backgroundParserQueue().dispatch([protectedThis = makeRef(*this)] {
+        protectedThis->m_input.append(String { &kEndOfFileMarker, 1 });
+        protectedThis->m_input.close();
+        protectedThis->pumpTokenizer();
+    });
+}
+
+void BackgroundHTMLParser::invalidateCheckpointsBefore(CheckpointID checkpoint)
+{
+    ASSERT(isMainThread());
+
+    backgroundParserQueue().dispatch([protectedThis = makeRef(*this), checkpoint] {
+        protectedThis->m_input.invalidateCheckpointsBefore(checkpoint);
+    });
+}
+
+void BackgroundHTMLParser::resumeFrom(CheckpointID inputCheckpoint, const HTMLTokenizer::Checkpoint& tokenizerCheckpoint, const HTMLTreeBuilderSimulator::State& treeBuilderState, String&& unparsedInput)
+{
+    ASSERT(isMainThread());
+
+    // Chunks already on their way to the main thread were tokenized from the old guesses.
+    ++m_mainThreadGeneration;
+
+    backgroundParserQueue().dispatch([protectedThis = makeRef(*this), inputCheckpoint, tokenizerCheckpoint, treeBuilderState, unparsedInput = WTFMove(unparsedInput).isolatedCopy()] {
+        auto& parser = protectedThis.get();
+        ++parser.m_generation;
+        parser.m_input.rewindTo(inputCheckpoint, unparsedInput);
+        // The tokenizer may be partway through a token, so start from a clean one.
+        parser.m_tokenizer = std::make_unique<HTMLTokenizer>(parser.m_options);
+        parser.m_tokenizer->restore(tokenizerCheckpoint);
+        parser.m_treeBuilderSimulator.setState(treeBuilderState);
+        parser.m_pendingChunk = std::make_unique<ParsedChunk>();
+        parser.pumpTokenizer();
+    });
+}
+
+void BackgroundHTMLParser::stop()
+{
+    ASSERT(isMainThread());
+
+    m_parser = nullptr;
+    m_isStopped = true;
+}
+
+void BackgroundHTMLParser::pumpTokenizer()
+{
+    ASSERT(!isMainThread());
+
+    auto& input = m_input.current();
+    while (!m_isStopped) {
+        auto rawToken = m_tokenizer->nextToken(input);
+        if (!rawToken)
+            break;
+
+        m_pendingChunk->tokens.append(CompactHTMLToken(*rawToken, TextPosition(input.currentLine(), input.currentColumn())));
+        rawToken.clear();
+
+        auto& token = m_pendingChunk->tokens.last();
+        if (m_treeBuilderSimulator.simulate(token, *m_tokenizer) && m_tokenizer->canCreateCheckpoint())
+            m_pendingChunk->checkpoints.append(Checkpoint { m_pendingChunk->tokens.size() - 1, m_input.createCheckpoint(), m_tokenizer->checkpoint(), m_treeBuilderSimulator.state() });
+
+        if (token.type() == HTMLToken::EndOfFile) {
+            sendPendingTokens();
+            return;
+        }
+
+        // The main thread may have a script to run after a </script>, so let it start as soon as possible.
+        bool isScriptEndTag = token.type() == HTMLToken::EndTag && threadSafeMatch(token.name(), scriptTag);
+        if (isScriptEndTag || m_pendingChunk->tokens.size() >= pendingTokenLimit)
+            sendPendingTokens();
+    }
+
+    sendPendingTokens();
+}
+
+void BackgroundHTMLParser::sendPendingTokens()
+{
+    ASSERT(!isMainThread());
+
+    if (m_pendingChunk->tokens.isEmpty())
+        return;
+
+    auto chunk = WTFMove(m_pendingChunk);
+    m_pendingChunk = std::make_unique<ParsedChunk>();
+    chunk->generation = m_generation;
+
+    callOnMainThread([protectedThis = makeRef(*this), chunk = WTFMove(chunk)] () mutable {
+        auto& parser = protectedThis.get();
+        if (!parser.m_parser || chunk->generation != parser.m_mainThreadGeneration)
+            return;
+        parser.m_parser->didReceiveParsedChunk(WTFMove(chunk));
+    });
+}
+
+} // namespace WebCore
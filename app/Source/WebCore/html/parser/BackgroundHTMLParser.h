@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "BackgroundHTMLInputStream.h"
+#include "CompactHTMLToken.h"
+#include "HTMLParserOptions.h"
+#include "HTMLTokenizer.h"
+#include "HTMLTreeBuilderSimulator.h"
+#include <atomic>
+#include <wtf/ThreadSafeRefCounted.h>
+
+namespace WebCore {
+
+class HTMLDocumentParser;
+
+// Tokenizes a network-sourced document on a background queue, and sends the tokens to the
+// HTMLDocumentParser in chunks. The tokenizer's state depends on the tree builder, which only
+// runs on the main thread, so the background tokenizer follows an HTMLTreeBuilderSimulator's
+// guesses. The main thread checks the guesses at checkpoints, and rewinds the background parser
+// to the last good one when a guess was wrong or a script wrote into the document.
+class BackgroundHTMLParser : public ThreadSafeRefCounted<BackgroundHTMLParser> {
+public:
+    typedef BackgroundHTMLInputStream::CheckpointID CheckpointID;
+
+    // The state after the token at tokenIndex in its chunk.
+    struct Checkpoint {
+        size_t tokenIndex;
+        CheckpointID inputCheckpoint;
+        HTMLTokenizer::Checkpoint tokenizerCheckpoint;
+        HTMLTreeBuilderSimulator::State treeBuilderState;
+    };
+
+    struct ParsedChunk {
+        WTF_MAKE_FAST_ALLOCATED;
+    public:
+        CompactHTMLTokenStream tokens;
+        Vector<Checkpoint> checkpoints;
+        unsigned generation { 0 };
+    };
+
+    static Ref<BackgroundHTMLParser> create(HTMLDocumentParser&, const HTMLParserOptions&);
+
+    // These are called on the main thread.
+    void append(String&&);
+    void finish();
+    void invalidateCheckpointsBefore(CheckpointID);
+    void resumeFrom(CheckpointID, const HTMLTokenizer::Checkpoint&, const HTMLTreeBuilderSimulator::State&, String&& unparsedInput);
+    void stop();
+
+private:
+    BackgroundHTMLParser(HTMLDocumentParser&, const HTMLParserOptions&);
+
+    // These are called on the background queue.
+    void pumpTokenizer();
+    void sendPendingTokens();
+
+    // Only used on the main thread.
+    HTMLDocumentParser* m_parser;
+    unsigned m_mainThreadGeneration { 0 };
+    bool m_isFinished { false };
+
+    std::atomic<bool> m_isStopped { false };
+
+    // Only used on the background queue.
+    const HTMLParserOptions m_options;
+    BackgroundHTMLInputStream m_input;
+    std::unique_ptr<HTMLTokenizer> m_tokenizer;
+    HTMLTreeBuilderSimulator m_treeBuilderSimulator;
+    std::unique_ptr<ParsedChunk> m_pendingChunk;
+    unsigned m_generation { 0 };
+};
+
+} // namespace WebCore
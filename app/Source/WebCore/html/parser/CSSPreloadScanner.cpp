@@ -50,12 +50,12 @@ void CSSPreloadScanner::reset()
     m_ruleValue.clear();
 }
 
-void CSSPreloadScanner::scan(const HTMLToken::DataVector& data, PreloadRequestStream& requests)
+void CSSPreloadScanner::scan(StringView data, PreloadRequestStream& requests)
 {
     ASSERT(!m_requests);
     SetForScope<PreloadRequestStream*> change(m_requests, &requests);
 
-    for (UChar c : data) {
+    for (UChar c : data.codeUnits()) {
         if (m_state == DoneParsingImportRules)
             break;
 
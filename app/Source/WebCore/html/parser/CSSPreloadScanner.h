@@ -29,6 +29,7 @@
 #include "HTMLResourcePreloader.h"
 #include "HTMLToken.h"
 #include <wtf/Vector.h>
+#include <wtf/text/StringView.h>
 
 namespace WebCore {
 
@@ -40,7 +41,7 @@ public:
 
     void reset();
 
-    void scan(const HTMLToken::DataVector&, PreloadRequestStream&);
+    void scan(StringView, PreloadRequestStream&);
 
 private:
     enum State {
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "HTMLToken.h"
+#include <wtf/text/TextPosition.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+// A copy of an HTMLToken that BackgroundHTMLParser can hand to the main thread. It holds no
+// AtomicStrings, since those belong to the thread that made them; the main thread turns it
+// into an AtomicHTMLToken for the tree builder.
+class CompactHTMLToken {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    struct Attribute {
+        Attribute(String&& name, String&& value)
+            : name(WTFMove(name))
+            , value(WTFMove(value))
+        {
+        }
+
+        String name;
+        String value;
+    };
+
+    CompactHTMLToken(HTMLToken&, const TextPosition&);
+    CompactHTMLToken(CompactHTMLToken&&) = default;
+    CompactHTMLToken& operator=(CompactHTMLToken&&) = default;
+
+    HTMLToken::Type type() const { return m_type; }
+
+    // StartTag, EndTag, DOCTYPE.
+    const String& name() const;
+
+    // StartTag, EndTag.
+    bool selfClosing() const;
+    const Vector<Attribute>& attributes() const;
+
+    // DOCTYPE.
+    std::unique_ptr<DoctypeData> releaseDoctypeData();
+
+    // Character. These are always 16-bit, since the tree builder works on UChars.
+    const String& characters() const;
+    bool charactersIsAll8BitData() const;
+
+    // Comment.
+    const String& comment() const;
+
+    // The position just past the end of the token, which is where the main thread tokenizer would be.
+    const TextPosition& textPosition() const { return m_textPosition; }
+
+private:
+    HTMLToken::Type m_type;
+    bool m_selfClosing { false };
+    bool m_isAll8BitData { false };
+    String m_data; // Name, characters or comment.
+    Vector<Attribute> m_attributes;
+    std::unique_ptr<DoctypeData> m_doctypeData;
+    TextPosition m_textPosition;
+};
+
+typedef Vector<CompactHTMLToken> CompactHTMLTokenStream;
+
+inline const String& CompactHTMLToken::name() const
+{
+    ASSERT(m_type == HTMLToken::StartTag || m_type == HTMLToken::EndTag || m_type == HTMLToken::DOCTYPE);
+    return m_data;
+}
+
+inline bool CompactHTMLToken::selfClosing() const
+{
+    ASSERT(m_type == HTMLToken::StartTag || m_type == HTMLToken::EndTag);
+    return m_selfClosing;
+}
+
+inline const Vector<CompactHTMLToken::Attribute>& CompactHTMLToken::attributes() const
+{
+    ASSERT(m_type == HTMLToken::StartTag || m_type == HTMLToken::EndTag);
+    return m_attributes;
+}
+
+inline std::unique_ptr<DoctypeData> CompactHTMLToken::releaseDoctypeData()
+{
+    ASSERT(m_type == HTMLToken::DOCTYPE);
+    return WTFMove(m_doctypeData);
+}
+
+inline const String& CompactHTMLToken::characters() const
+{
+    ASSERT(m_type == HTMLToken::Character);
+    return m_data;
+}
+
+inline bool CompactHTMLToken::charactersIsAll8BitData() const
+{
+    ASSERT(m_type == HTMLToken::Character);
+    return m_isAll8BitData;
+}
+
+inline const String& CompactHTMLToken::comment() const
+{
+    ASSERT(m_type == HTMLToken::Comment);
+    return m_data;
+}
+
+} // namespace WebCore
@@ -34,6 +34,7 @@
 #include "HTMLPreloadScanner.h"
 #include "HTMLScriptRunner.h"
 #include "HTMLTreeBuilder.h"
+#include "HTMLTreeBuilderSimulator.h"
 #include "HTMLUnknownElement.h"
 #include "JSCustomElementInterface.h"
 #include "ScriptElement.h"
@@ -83,12 +84,14 @@ HTMLDocumentParser::~HTMLDocumentParser()
     ASSERT(!m_pumpSessionNestingLevel);
     ASSERT(!m_preloadScanner);
     ASSERT(!m_insertionPreloadScanner);
+    ASSERT(!m_backgroundParser);
 }
 
 void HTMLDocumentParser::detach()
 {
     ScriptableDocumentParser::detach();
 
+    stopBackgroundParser();
     if (m_scriptRunner)
         m_scriptRunner->detach();
     // FIXME: It seems wrong that we would have a preload scanner here.
@@ -101,6 +104,7 @@ void HTMLDocumentParser::detach()
 void HTMLDocumentParser::stopParsing()
 {
     DocumentParser::stopParsing();
+    stopBackgroundParser();
     m_parserScheduler = nullptr; // Deleting the scheduler will clear any timers.
 }
 
@@ -142,7 +146,7 @@ inline bool HTMLDocumentParser::inPumpSession() const
 
 inline bool HTMLDocumentParser::shouldDelayEnd() const
 {
-    return inPumpSession() || isWaitingForScripts() || isScheduledForResume() || isExecutingScript();
+    return inPumpSession() || isWaitingForScripts() || isScheduledForResume() || isExecutingScript() || m_backgroundParser;
 }
 
 bool HTMLDocumentParser::isParsingFragment() const
@@ -241,6 +245,13 @@ bool HTMLDocumentParser::pumpTokenizerLoop(SynchronousMode mode, bool parsingFra
         if (UNLIKELY(mode == AllowYield && m_parserScheduler->shouldYieldBeforeToken(session)))
             return true;
 
+        if (m_backgroundParser) {
+            ASSERT(!parsingFragment);
+            if (!processNextParsedToken())
+                return false;
+            continue;
+        }
+
         if (!parsingFragment)
             m_sourceTracker.startToken(m_input.current(), m_tokenizer);
 
@@ -289,6 +300,10 @@ void HTMLDocumentParser::pumpTokenizer(SynchronousMode mode)
 
     if (isWaitingForScripts()) {
         ASSERT(m_tokenizer.isInDataState());
+        if (m_backgroundParser) {
+            preloadScanParsedChunks();
+            return;
+        }
         if (!m_preloadScanner) {
             m_preloadScanner = std::make_unique<HTMLPreloadScanner>(m_options, document()->url(), document()->deviceScaleFactor());
             m_preloadScanner->appendToEnd(m_input.current());
@@ -320,6 +335,180 @@ void HTMLDocumentParser::constructTreeFromHTMLToken(HTMLTokenizer::TokenPtr& raw
     m_treeBuilder->constructTree(WTFMove(token));
 }
 
+bool HTMLDocumentParser::shouldStartBackgroundParser() const
+{
+    // The background parser has to see the document from its first character.
+    return m_options.useThreading && !isParsingFragment() && !wasCreatedByScript() && !m_input.haveSeenEndOfFile()
+        && m_input.current().isEmpty() && !m_input.current().numberOfCharactersConsumed();
+}
+
+void HTMLDocumentParser::stopBackgroundParser()
+{
+    if (!m_backgroundParser)
+        return;
+
+    m_backgroundParser->stop();
+    m_backgroundParser = nullptr;
+    m_parsedChunks.clear();
+    m_nextTokenIndex = 0;
+    m_nextCheckpointIndex = 0;
+    m_preloadScannedChunkCount = 0;
+    m_lastCheckpoint = std::nullopt;
+}
+
+// Returns false if there is nothing to do until the background parser sends more tokens or a script finishes.
+bool HTMLDocumentParser::processNextParsedToken()
+{
+    ASSERT(m_backgroundParser);
+
+    // Input written by scripts is tokenized here. Only whole tokens are taken from it; anything left
+    // over is tokenized by the background parser, together with the input that follows it.
+    auto& input = m_input.current();
+    if (!input.isEmpty()) {
+        m_hasTokenizedWrittenInput = true;
+        SegmentedString inputBeforeToken;
+        inputBeforeToken = input;
+        auto tokenizerBeforeToken = m_tokenizer.checkpoint();
+
+        auto token = m_tokenizer.nextToken(input);
+        // A character token at the end of the input may have been cut short, or may end partway into a tag.
+        if (token && !(token->type() == HTMLToken::Character && input.isEmpty())) {
+            constructTreeFromHTMLToken(token);
+            return true;
+        }
+        token.clear();
+        input = inputBeforeToken;
+        m_tokenizer.restore(tokenizerBeforeToken);
+    }
+
+    if (m_input.hasInsertionPoint())
+        return false;
+
+    if (m_hasTokenizedWrittenInput) {
+        m_hasTokenizedWrittenInput = false;
+        // Scripts only run after a </script>, which always has a checkpoint.
+        ASSERT(m_lastCheckpoint);
+        if (m_lastCheckpoint && (!input.isEmpty() || !m_tokenizer.hasSameModeAs(m_lastCheckpoint->tokenizerCheckpoint)
+            || HTMLTreeBuilderSimulator::stateFor(*m_treeBuilder) != m_lastCheckpoint->treeBuilderState)) {
+            discardSpeculationsAndResumeFrom(m_lastCheckpoint->inputCheckpoint);
+            return false;
+        }
+    }
+
+    if (m_parsedChunks.isEmpty())
+        return false;
+
+    auto& chunk = *m_parsedChunks.first();
+    auto& token = chunk.tokens[m_nextTokenIndex];
+
+    // Put the input where the main thread tokenizer would be, for textPosition() and for scripts that write.
+    input.setCurrentPosition(token.textPosition().m_line, token.textPosition().m_column, 0);
+    // The tokenizer goes back to the data state after any token other than characters.
+    if (token.type() != HTMLToken::Character)
+        m_tokenizer.setDataState();
+
+    std::optional<BackgroundHTMLParser::Checkpoint> checkpoint;
+    if (m_nextCheckpointIndex < chunk.checkpoints.size() && chunk.checkpoints[m_nextCheckpointIndex].tokenIndex == m_nextTokenIndex)
+        checkpoint = WTFMove(chunk.checkpoints[m_nextCheckpointIndex++]);
+    bool isEndOfFile = token.type() == HTMLToken::EndOfFile;
+    ++m_nextTokenIndex;
+
+    m_treeBuilder->constructTree(AtomicHTMLToken(token));
+
+    if (isStopped())
+        return false;
+
+    if (checkpoint) {
+        m_tokenizer.restoreBuffers(checkpoint->tokenizerCheckpoint);
+        if (!m_tokenizer.hasSameModeAs(checkpoint->tokenizerCheckpoint) || HTMLTreeBuilderSimulator::stateFor(*m_treeBuilder) != checkpoint->treeBuilderState) {
+            // The background parser guessed wrong, so everything it tokenized after this token is wrong too.
+            discardSpeculationsAndResumeFrom(checkpoint->inputCheckpoint);
+            return true;
+        }
+        m_lastCheckpoint = WTFMove(checkpoint);
+    }
+
+    if (isEndOfFile) {
+        stopBackgroundParser();
+        m_input.closeWithoutMarkingEndOfFile();
+        return true;
+    }
+
+    if (m_nextTokenIndex == chunk.tokens.size()) {
+        bool chunkHadCheckpoints = !chunk.checkpoints.isEmpty();
+        m_parsedChunks.removeFirst();
+        m_nextTokenIndex = 0;
+        m_nextCheckpointIndex = 0;
+        if (m_preloadScannedChunkCount)
+            --m_preloadScannedChunkCount;
+        if (chunkHadCheckpoints && m_lastCheckpoint)
+            m_backgroundParser->invalidateCheckpointsBefore(m_lastCheckpoint->inputCheckpoint);
+    }
+
+    return true;
+}
+
+void HTMLDocumentParser::discardSpeculationsAndResumeFrom(BackgroundHTMLParser::CheckpointID inputCheckpoint)
+{
+    m_parsedChunks.clear();
+    m_nextTokenIndex = 0;
+    m_nextCheckpointIndex = 0;
+    m_preloadScannedChunkCount = 0;
+    m_lastCheckpoint = std::nullopt;
+
+    String unparsedInput = m_input.current().toString();
+    m_input.current() = SegmentedString();
+
+    m_backgroundParser->resumeFrom(inputCheckpoint, m_tokenizer.checkpoint(), HTMLTreeBuilderSimulator::stateFor(*m_treeBuilder), WTFMove(unparsedInput));
+    document()->didDiscardParserSpeculations();
+}
+
+void HTMLDocumentParser::preloadScanParsedChunks()
+{
+    if (!m_preloadScanner) {
+        m_preloadScanner = std::make_unique<HTMLPreloadScanner>(m_options, document()->url(), document()->deviceScaleFactor());
+        m_preloadScannedChunkCount = 0;
+    }
+
+    size_t chunkIndex = 0;
+    for (auto& chunk : m_parsedChunks) {
+        if (chunkIndex >= m_preloadScannedChunkCount)
+            m_preloadScanner->scan(*m_preloader, *document(), chunk->tokens, chunkIndex ? 0 : m_nextTokenIndex);
+        ++chunkIndex;
+    }
+    m_preloadScannedChunkCount = m_parsedChunks.size();
+}
+
+void HTMLDocumentParser::didReceiveParsedChunk(std::unique_ptr<BackgroundHTMLParser::ParsedChunk> chunk)
+{
+    ASSERT(m_backgroundParser);
+
+    if (isStopped())
+        return;
+
+    // pumpTokenizer can cause this parser to be detached from the Document,
+    // but we need to ensure it isn't deleted yet.
+    Ref<HTMLDocumentParser> protectedThis(*this);
+
+    document()->didReceiveBackgroundParsedChunk();
+
+    if (m_preloadScanner && m_parsedChunks.isEmpty() && !isWaitingForScripts()) {
+        // As in append(), the tree builder has caught up with the preload scanner.
+        m_preloadScanner = nullptr;
+    }
+
+    m_parsedChunks.append(WTFMove(chunk));
+    if (m_preloadScanner && isWaitingForScripts())
+        preloadScanParsedChunks();
+
+    if (inPumpSession())
+        return;
+
+    pumpTokenizerIfPossible(AllowYield);
+
+    endIfDelayed();
+}
+
 bool HTMLDocumentParser::hasInsertionPoint()
 {
     // FIXME: The wasCreatedByScript() branch here might not be fully correct.
@@ -365,6 +554,13 @@ void HTMLDocumentParser::append(RefPtr<StringImpl>&& inputSource)
 
     String source { WTFMove(inputSource) };
 
+    if (!m_backgroundParser && shouldStartBackgroundParser())
+        m_backgroundParser = BackgroundHTMLParser::create(*this, m_options);
+    if (m_backgroundParser) {
+        m_backgroundParser->append(WTFMove(source));
+        return;
+    }
+
     if (m_preloadScanner) {
         if (m_input.current().isEmpty() && !isWaitingForScripts()) {
             // We have parsed until the end of the current input and so are now moving ahead of the preload scanner.
@@ -443,6 +639,12 @@ void HTMLDocumentParser::finish()
     // We're not going to get any more data off the network, so we tell the
     // input stream we've reached the end of file. finish() can be called more
     // than once, if the first time does not call end().
+    if (m_backgroundParser) {
+        // The end is delayed until the background parser's end of file token gets to the tree builder.
+        m_backgroundParser->finish();
+        attemptToEnd();
+        return;
+    }
     if (!m_input.haveSeenEndOfFile())
         m_input.markEndOfFile();
 
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include "BackgroundHTMLParser.h"
 #include "HTMLInputStream.h"
 #include "HTMLScriptRunnerHost.h"
 #include "HTMLSourceTracker.h"
@@ -34,6 +35,8 @@
 #include "ScriptableDocumentParser.h"
 #include "XSSAuditor.h"
 #include "XSSAuditorDelegate.h"
+#include <wtf/Deque.h>
+#include <wtf/Optional.h>
 
 namespace WebCore {
 
@@ -62,6 +65,9 @@ public:
     HTMLTokenizer& tokenizer();
     TextPosition textPosition() const final;
 
+    // For BackgroundHTMLParser.
+    void didReceiveParsedChunk(std::unique_ptr<BackgroundHTMLParser::ParsedChunk>);
+
 protected:
     explicit HTMLDocumentParser(HTMLDocument&);
 
@@ -108,6 +114,12 @@ private:
     void pumpTokenizerIfPossible(SynchronousMode);
     void constructTreeFromHTMLToken(HTMLTokenizer::TokenPtr&);
 
+    bool shouldStartBackgroundParser() const;
+    void stopBackgroundParser();
+    bool processNextParsedToken();
+    void discardSpeculationsAndResumeFrom(BackgroundHTMLParser::CheckpointID);
+    void preloadScanParsedChunks();
+
     void runScriptsForPausedTreeBuilder();
     void resumeParsingAfterScriptExecution();
 
@@ -139,6 +151,16 @@ private:
 
     bool m_endWasDelayed { false };
     unsigned m_pumpSessionNestingLevel { 0 };
+
+    RefPtr<BackgroundHTMLParser> m_backgroundParser;
+    Deque<std::unique_ptr<BackgroundHTMLParser::ParsedChunk>> m_parsedChunks;
+    size_t m_nextTokenIndex { 0 };
+    size_t m_nextCheckpointIndex { 0 };
+    size_t m_preloadScannedChunkCount { 0 };
+    // The last checkpoint the tree builder has got to, which is where the background parser resumes from
+    // if a script writes into the document.
+    std::optional<BackgroundHTMLParser::Checkpoint> m_lastCheckpoint;
+    bool m_hasTokenizedWrittenInput { false };
 };
 
 inline HTMLTokenizer& HTMLDocumentParser::tokenizer()
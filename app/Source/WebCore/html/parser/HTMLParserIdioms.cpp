@@ -343,6 +343,11 @@ bool threadSafeMatch(const QualifiedName& a, const QualifiedName& b)
     return threadSafeEqual(*a.localName().impl(), *b.localName().impl());
 }
 
+bool threadSafeMatch(const String& localName, const QualifiedName& name)
+{
+    return localName.impl() && threadSafeEqual(*localName.impl(), *name.localName().impl());
+}
+
 String parseCORSSettingsAttribute(const AtomicString& value)
 {
     if (value.isNull())
@@ -83,6 +83,7 @@ bool parseMetaHTTPEquivRefresh(const StringView&, double& delay, String& url);
 String parseCORSSettingsAttribute(const AtomicString&);
 
 bool threadSafeMatch(const QualifiedName&, const QualifiedName&);
+bool threadSafeMatch(const String& localName, const QualifiedName&);
 
 AtomicString parseHTMLHashNameReference(StringView);
 
@@ -40,6 +40,7 @@ HTMLParserOptions::HTMLParserOptions()
     , pluginsEnabled(false)
     , usePreHTML5ParserQuirks(false)
     , maximumDOMTreeDepth(Settings::defaultMaximumHTMLParserDOMTreeDepth)
+    , useThreading(false)
 {
 }
 
@@ -51,6 +52,9 @@ HTMLParserOptions::HTMLParserOptions(Document& document)
 
     usePreHTML5ParserQuirks = document.settings().usePreHTML5ParserQuirks();
     maximumDOMTreeDepth = document.settings().maximumHTMLParserDOMTreeDepth();
+
+    // The XSS auditor needs the source of every token, which only the main thread tokenizer tracks.
+    useThreading = frame && document.settings().threadedHTMLParserEnabled() && !frame->settings().xssAuditorEnabled();
 }
 
 }
@@ -38,6 +38,7 @@ public:
     bool pluginsEnabled;
     bool usePreHTML5ParserQuirks;
     unsigned maximumDOMTreeDepth;
+    bool useThreading;
 };
 
 } // namespace WebCore
@@ -44,7 +44,42 @@ namespace WebCore {
 
 using namespace HTMLNames;
 
-TokenPreloadScanner::TagId TokenPreloadScanner::tagIdFor(const HTMLToken::DataVector& data)
+static StringView tokenCharacters(const HTMLToken& token)
+{
+    return StringView(token.characters().data(), token.characters().size());
+}
+
+static StringView tokenCharacters(const CompactHTMLToken& token)
+{
+    return token.characters();
+}
+
+static String attributeValueString(const Vector<UChar, 32>& value)
+{
+    return StringImpl::create8BitIfPossible(value);
+}
+
+static const String& attributeValueString(const String& value)
+{
+    return value;
+}
+
+static const HTMLToken::Attribute* findHrefAttribute(const HTMLToken& token)
+{
+    return findAttribute(token.attributes(), hrefAttr.localName().string());
+}
+
+static const CompactHTMLToken::Attribute* findHrefAttribute(const CompactHTMLToken& token)
+{
+    for (auto& attribute : token.attributes()) {
+        if (attribute.name == hrefAttr.localName())
+            return &attribute;
+    }
+    return nullptr;
+}
+
+template<typename Characters>
+TokenPreloadScanner::TagId TokenPreloadScanner::tagIdFor(const Characters& data)
 {
     AtomicString tagName(data);
     if (tagName == imgTag)
@@ -106,7 +141,8 @@ public:
     {
     }
 
-    void processAttributes(const HTMLToken::AttributeList& attributes, Document& document, Vector<bool>& pictureState)
+    template<typename AttributeList>
+    void processAttributes(const AttributeList& attributes, Document& document, Vector<bool>& pictureState)
     {
         ASSERT(isMainThread());
         if (m_tagId >= TagId::Unknown)
@@ -114,7 +150,7 @@ public:
         
         for (auto& attribute : attributes) {
             AtomicString attributeName(attribute.name);
-            String attributeValue = StringImpl::create8BitIfPossible(attribute.value);
+            String attributeValue = attributeValueString(attribute.value);
             processAttribute(attributeName, attributeValue, document, pictureState);
         }
         
@@ -341,12 +377,23 @@ TokenPreloadScanner::TokenPreloadScanner(const URL& documentURL, float deviceSca
 }
 
 void TokenPreloadScanner::scan(const HTMLToken& token, Vector<std::unique_ptr<PreloadRequest>>& requests, Document& document)
+{
+    scanToken(token, requests, document);
+}
+
+void TokenPreloadScanner::scan(const CompactHTMLToken& token, Vector<std::unique_ptr<PreloadRequest>>& requests, Document& document)
+{
+    scanToken(token, requests, document);
+}
+
+template<typename Token>
+void TokenPreloadScanner::scanToken(const Token& token, Vector<std::unique_ptr<PreloadRequest>>& requests, Document& document)
 {
     switch (token.type()) {
     case HTMLToken::Character:
         if (!m_inStyle)
             return;
-        m_cssScanner.scan(token.characters(), requests);
+        m_cssScanner.scan(tokenCharacters(token), requests);
         return;
 
     case HTMLToken::EndTag: {
@@ -402,11 +449,12 @@ void TokenPreloadScanner::scan(const HTMLToken& token, Vector<std::unique_ptr<Pr
     }
 }
 
-void TokenPreloadScanner::updatePredictedBaseURL(const HTMLToken& token)
+template<typename Token>
+void TokenPreloadScanner::updatePredictedBaseURL(const Token& token)
 {
     ASSERT(m_predictedBaseElementURL.isEmpty());
-    if (auto* hrefAttribute = findAttribute(token.attributes(), hrefAttr.localName().string()))
-        m_predictedBaseElementURL = URL(m_documentURL, stripLeadingAndTrailingHTMLSpaces(StringImpl::create8BitIfPossible(hrefAttribute->value))).isolatedCopy();
+    if (auto* hrefAttribute = findHrefAttribute(token))
+        m_predictedBaseElementURL = URL(m_documentURL, stripLeadingAndTrailingHTMLSpaces(attributeValueString(hrefAttribute->value))).isolatedCopy();
 }
 
 HTMLPreloadScanner::HTMLPreloadScanner(const HTMLParserOptions& options, const URL& documentURL, float deviceScaleFactor)
@@ -441,6 +489,22 @@ void HTMLPreloadScanner::scan(HTMLResourcePreloader& preloader, Document& docume
     preloader.preload(WTFMove(requests));
 }
 
+void HTMLPreloadScanner::scan(HTMLResourcePreloader& preloader, Document& document, const CompactHTMLTokenStream& tokens, size_t startIndex)
+{
+    ASSERT(isMainThread());
+
+    const URL& startingBaseElementURL = document.baseElementURL();
+    if (!startingBaseElementURL.isEmpty())
+        m_scanner.setPredictedBaseElementURL(startingBaseElementURL);
+
+    PreloadRequestStream requests;
+
+    for (size_t i = startIndex; i < tokens.size(); ++i)
+        m_scanner.scan(tokens[i], requests, document);
+
+    preloader.preload(WTFMove(requests));
+}
+
 bool testPreloadScannerViewportSupport(Document* document)
 {
     ASSERT(document);
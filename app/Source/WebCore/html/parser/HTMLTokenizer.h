@@ -79,6 +79,21 @@ public:
 
     bool neverSkipNullCharacters() const;
 
+    // Everything needed to carry on tokenizing from the current point with another tokenizer.
+    // BackgroundHTMLParser uses checkpoints to resume tokenizing where document.write() left off.
+    struct Checkpoint;
+
+    // Between tokens, when there is no partially tokenized input. Checkpoints are only valid then.
+    bool canCreateCheckpoint() const;
+    Checkpoint checkpoint() const;
+    void restore(const Checkpoint&);
+
+    // Restores everything except the state and the two flags, which the tree builder controls.
+    void restoreBuffers(const Checkpoint&);
+
+    // Whether the tree builder has left this tokenizer tokenizing the same way as the checkpoint.
+    bool hasSameModeAs(const Checkpoint&) const;
+
 private:
     enum State {
         DataState,
@@ -211,6 +226,16 @@ private:
     const HTMLParserOptions m_options;
 };
 
+struct HTMLTokenizer::Checkpoint {
+    State state;
+    bool forceNullCharacterReplacement;
+    bool shouldAllowCDATA;
+    bool skipNextNewLine;
+    Vector<UChar, 32> appropriateEndTagName;
+    Vector<LChar, 32> temporaryBuffer;
+    Vector<LChar, 32> bufferedEndTagName;
+};
+
 class HTMLTokenizer::TokenPtr {
 public:
     TokenPtr();
@@ -352,4 +377,50 @@ inline bool HTMLTokenizer::neverSkipNullCharacters() const
     return m_forceNullCharacterReplacement;
 }
 
+inline bool HTMLTokenizer::canCreateCheckpoint() const
+{
+    if (m_token.type() != HTMLToken::Uninitialized)
+        return false;
+    switch (m_state) {
+    case DataState:
+    case RCDATAState:
+    case RAWTEXTState:
+    case ScriptDataState:
+    case PLAINTEXTState:
+        return true;
+    default:
+        return false;
+    }
+}
+
+inline auto HTMLTokenizer::checkpoint() const -> Checkpoint
+{
+    ASSERT(canCreateCheckpoint());
+    return { m_state, m_forceNullCharacterReplacement, m_shouldAllowCDATA, m_preprocessor.skipNextNewLine(), m_appropriateEndTagName, m_temporaryBuffer, m_bufferedEndTagName };
+}
+
+inline void HTMLTokenizer::restore(const Checkpoint& checkpoint)
+{
+    ASSERT(m_token.type() == HTMLToken::Uninitialized);
+    m_state = checkpoint.state;
+    m_forceNullCharacterReplacement = checkpoint.forceNullCharacterReplacement;
+    m_shouldAllowCDATA = checkpoint.shouldAllowCDATA;
+    restoreBuffers(checkpoint);
+}
+
+inline void HTMLTokenizer::restoreBuffers(const Checkpoint& checkpoint)
+{
+    m_preprocessor.setSkipNextNewLine(checkpoint.skipNextNewLine);
+    m_appropriateEndTagName = checkpoint.appropriateEndTagName;
+    m_temporaryBuffer = checkpoint.temporaryBuffer;
+    m_bufferedEndTagName = checkpoint.bufferedEndTagName;
+}
+
+inline bool HTMLTokenizer::hasSameModeAs(const Checkpoint& checkpoint) const
+{
+    return m_state == checkpoint.state
+        && m_forceNullCharacterReplacement == checkpoint.forceNullCharacterReplacement
+        && m_shouldAllowCDATA == checkpoint.shouldAllowCDATA;
+}
+
 } // namespace WebCore
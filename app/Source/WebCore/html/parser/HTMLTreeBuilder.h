@@ -72,6 +72,8 @@ public:
     void finished();
 
 private:
+    friend class HTMLTreeBuilderSimulator;
+
     class ExternalCharacterTokenBuffer;
 
     // Represents HTML5 "insertion mode"
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HTMLTreeBuilderSimulator.h"
+
+#include "CompactHTMLToken.h"
+#include "HTMLNames.h"
+#include "HTMLParserIdioms.h"
+#include "HTMLTokenizer.h"
+#include "HTMLTreeBuilder.h"
+#include "MathMLNames.h"
+#include "SVGNames.h"
+#include <wtf/MainThread.h>
+
+namespace WebCore {
+
+using namespace HTMLNames;
+
+static bool tokenExitsForeignContent(const CompactHTMLToken& token)
+{
+    // This is the list in HTMLTreeBuilder::processTokenInForeignContent().
+    auto& tagName = token.name();
+    if (threadSafeMatch(tagName, fontTag)) {
+        for (auto& attribute : token.attributes()) {
+            if (threadSafeMatch(attribute.name, colorAttr) || threadSafeMatch(attribute.name, faceAttr) || threadSafeMatch(attribute.name, sizeAttr))
+                return true;
+        }
+        return false;
+    }
+    return threadSafeMatch(tagName, bTag)
+        || threadSafeMatch(tagName, bigTag)
+        || threadSafeMatch(tagName, blockquoteTag)
+        || threadSafeMatch(tagName, bodyTag)
+        || threadSafeMatch(tagName, brTag)
+        || threadSafeMatch(tagName, centerTag)
+        || threadSafeMatch(tagName, codeTag)
+        || threadSafeMatch(tagName, ddTag)
+        || threadSafeMatch(tagName, divTag)
+        || threadSafeMatch(tagName, dlTag)
+        || threadSafeMatch(tagName, dtTag)
+        || threadSafeMatch(tagName, emTag)
+        || threadSafeMatch(tagName, embedTag)
+        || threadSafeMatch(tagName, h1Tag)
+        || threadSafeMatch(tagName, h2Tag)
+        || threadSafeMatch(tagName, h3Tag)
+        || threadSafeMatch(tagName, h4Tag)
+        || threadSafeMatch(tagName, h5Tag)
+        || threadSafeMatch(tagName, h6Tag)
+        || threadSafeMatch(tagName, headTag)
+        || threadSafeMatch(tagName, hrTag)
+        || threadSafeMatch(tagName, iTag)
+        || threadSafeMatch(tagName, imgTag)
+        || threadSafeMatch(tagName, liTag)
+        || threadSafeMatch(tagName, listingTag)
+        || threadSafeMatch(tagName, menuTag)
+        || threadSafeMatch(tagName, metaTag)
+        || threadSafeMatch(tagName, nobrTag)
+        || threadSafeMatch(tagName, olTag)
+        || threadSafeMatch(tagName, pTag)
+        || threadSafeMatch(tagName, preTag)
+        || threadSafeMatch(tagName, rubyTag)
+        || threadSafeMatch(tagName, sTag)
+        || threadSafeMatch(tagName, smallTag)
+        || threadSafeMatch(tagName, spanTag)
+        || threadSafeMatch(tagName, strongTag)
+        || threadSafeMatch(tagName, strikeTag)
+        || threadSafeMatch(tagName, subTag)
+        || threadSafeMatch(tagName, supTag)
+        || threadSafeMatch(tagName, tableTag)
+        || threadSafeMatch(tagName, ttTag)
+        || threadSafeMatch(tagName, uTag)
+        || threadSafeMatch(tagName, ulTag)
+        || threadSafeMatch(tagName, varTag);
+}
+
+// Whether the token starts or ends an HTML integration point inside SVG.
+static bool tokenExitsSVG(const CompactHTMLToken& token)
+{
+    auto& tagName = token.name();
+    return threadSafeMatch(tagName, SVGNames::foreignObjectTag)
+        || threadSafeMatch(tagName, SVGNames::descTag)
+        || threadSafeMatch(tagName, SVGNames::titleTag);
+}
+
+// Whether the token starts or ends an HTML or MathML text integration point inside MathML.
+static bool tokenExitsMath(const CompactHTMLToken& token)
+{
+    auto& tagName = token.name();
+    if (threadSafeMatch(tagName, MathMLNames::annotation_xmlTag)) {
+        if (token.type() == HTMLToken::EndTag)
+            return true;
+        for (auto& attribute : token.attributes()) {
+            if (threadSafeMatch(attribute.name, MathMLNames::encodingAttr))
+                return equalLettersIgnoringASCIICase(attribute.value, "text/html") || equalLettersIgnoringASCIICase(attribute.value, "application/xhtml+xml");
+        }
+        return false;
+    }
+    return threadSafeMatch(tagName, MathMLNames::miTag)
+        || threadSafeMatch(tagName, MathMLNames::moTag)
+        || threadSafeMatch(tagName, MathMLNames::mnTag)
+        || threadSafeMatch(tagName, MathMLNames::msTag)
+        || threadSafeMatch(tagName, MathMLNames::mtextTag);
+}
+
+HTMLTreeBuilderSimulator::HTMLTreeBuilderSimulator(const HTMLParserOptions& options)
+    : m_options(options)
+{
+}
+
+auto HTMLTreeBuilderSimulator::stateFor(HTMLTreeBuilder& treeBuilder) -> State
+{
+    ASSERT(isMainThread());
+
+    State state;
+    state.inTextMode = treeBuilder.m_insertionMode == HTMLTreeBuilder::InsertionMode::Text;
+    if (treeBuilder.m_tree.isEmpty())
+        return state;
+
+    Vector<HTMLStackItem*, 32> items;
+    for (auto* record = &treeBuilder.m_tree.openElements().topRecord(); record; record = record->next())
+        items.append(&record->stackItem());
+
+    // Walk up from the root, pushing a namespace wherever simulate() would have.
+    for (size_t i = items.size(); i--; ) {
+        auto& item = *items[i];
+        Namespace currentNamespace = state.namespaceStack.last();
+        if (item.hasTagName(SVGNames::svgTag))
+            state.namespaceStack.append(SVG);
+        else if (item.hasTagName(MathMLNames::mathTag))
+            state.namespaceStack.append(MathML);
+        else if (currentNamespace == SVG && HTMLElementStack::isHTMLIntegrationPoint(item))
+            state.namespaceStack.append(HTML);
+        else if (currentNamespace == MathML && (HTMLElementStack::isMathMLTextIntegrationPoint(item) || HTMLElementStack::isHTMLIntegrationPoint(item)))
+            state.namespaceStack.append(HTML);
+    }
+    return state;
+}
+
+bool HTMLTreeBuilderSimulator::simulate(const CompactHTMLToken& token, HTMLTokenizer& tokenizer)
+{
+    bool needsCheckpoint = false;
+
+    if (token.type() == HTMLToken::StartTag) {
+        auto& tagName = token.name();
+        if (threadSafeMatch(tagName, SVGNames::svgTag))
+            m_state.namespaceStack.append(SVG);
+        if (threadSafeMatch(tagName, MathMLNames::mathTag))
+            m_state.namespaceStack.append(MathML);
+        if (inForeignContent() && tokenExitsForeignContent(token))
+            m_state.namespaceStack.removeLast();
+        // An integration point is itself a foreign element. It is only its children that are HTML.
+        bool isForeignElement = inForeignContent();
+        if ((m_state.namespaceStack.last() == SVG && tokenExitsSVG(token)) || (m_state.namespaceStack.last() == MathML && tokenExitsMath(token)))
+            m_state.namespaceStack.append(HTML);
+
+        // This is HTMLTokenizer::updateStateFor(), which only works on the main thread. The tree
+        // builder ignores some of these tags in some insertion modes, so always have them checked.
+        if (threadSafeMatch(tagName, textareaTag) || threadSafeMatch(tagName, titleTag)) {
+            needsCheckpoint = true;
+            if (!isForeignElement) {
+                tokenizer.setRCDATAState();
+                m_state.inTextMode = true;
+            }
+        } else if (threadSafeMatch(tagName, plaintextTag)) {
+            needsCheckpoint = true;
+            if (!isForeignElement)
+                tokenizer.setPLAINTEXTState();
+        } else if (threadSafeMatch(tagName, scriptTag)) {
+            needsCheckpoint = true;
+            if (!isForeignElement) {
+                tokenizer.setScriptDataState();
+                m_state.inTextMode = true;
+            }
+        } else if (threadSafeMatch(tagName, styleTag)
+            || threadSafeMatch(tagName, iframeTag)
+            || threadSafeMatch(tagName, xmpTag)
+            || threadSafeMatch(tagName, noembedTag)
+            || threadSafeMatch(tagName, noframesTag)
+            || threadSafeMatch(tagName, noscriptTag)) {
+            needsCheckpoint = true;
+            bool isRawText = (!threadSafeMatch(tagName, noembedTag) || m_options.pluginsEnabled) && (!threadSafeMatch(tagName, noscriptTag) || m_options.scriptEnabled);
+            if (!isForeignElement && isRawText) {
+                tokenizer.setRAWTEXTState();
+                m_state.inTextMode = true;
+            }
+        }
+    } else if (token.type() == HTMLToken::EndTag) {
+        auto& tagName = token.name();
+        auto& namespaceStack = m_state.namespaceStack;
+        Namespace currentNamespace = namespaceStack.last();
+        Namespace parentNamespace = namespaceStack.size() > 1 ? namespaceStack[namespaceStack.size() - 2] : HTML;
+        if ((currentNamespace == SVG && threadSafeMatch(tagName, SVGNames::svgTag))
+            || (currentNamespace == MathML && threadSafeMatch(tagName, MathMLNames::mathTag))
+            || (currentNamespace == HTML && parentNamespace == SVG && tokenExitsSVG(token))
+            || (currentNamespace == HTML && parentNamespace == MathML && tokenExitsMath(token)))
+            namespaceStack.removeLast();
+
+        // The only end tag the tokenizer emits in the text insertion mode is the one that ends it.
+        m_state.inTextMode = false;
+
+        // Scripts can call document.write().
+        if (threadSafeMatch(tagName, scriptTag))
+            needsCheckpoint = true;
+    }
+
+    bool inForeignContent = this->inForeignContent();
+    bool forceNullCharacterReplacement = m_state.inTextMode || inForeignContent;
+    if (tokenizer.shouldAllowCDATA() != inForeignContent || tokenizer.neverSkipNullCharacters() != forceNullCharacterReplacement)
+        needsCheckpoint = true;
+    tokenizer.setForceNullCharacterReplacement(forceNullCharacterReplacement);
+    tokenizer.setShouldAllowCDATA(inForeignContent);
+
+    // The tree builder's rules for foreign content are more involved than ours, so have every tag in it checked.
+    if (m_state.namespaceStack.size() > 1 && (token.type() == HTMLToken::StartTag || token.type() == HTMLToken::EndTag))
+        needsCheckpoint = true;
+
+    return needsCheckpoint;
+}
+
+} // namespace WebCore
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "HTMLParserOptions.h"
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+class CompactHTMLToken;
+class HTMLTokenizer;
+class HTMLTreeBuilder;
+
+// Guesses, on BackgroundHTMLParser's thread, how the tree builder will change the tokenizer's state.
+// It only tracks which namespace the parser is in and whether it is in the "text" insertion mode,
+// so it is sometimes wrong. The tokens after which a wrong guess would matter get a checkpoint, and
+// the main thread checks the real tokenizer against them.
+class HTMLTreeBuilderSimulator {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    enum Namespace { HTML, SVG, MathML };
+
+    struct State {
+        Vector<Namespace, 1> namespaceStack { HTML };
+        bool inTextMode { false };
+
+        bool operator==(const State& other) const { return namespaceStack == other.namespaceStack && inTextMode == other.inTextMode; }
+        bool operator!=(const State& other) const { return !(*this == other); }
+    };
+
+    explicit HTMLTreeBuilderSimulator(const HTMLParserOptions&);
+
+    // The state the simulator would be in if it had guessed right so far.
+    static State stateFor(HTMLTreeBuilder&);
+
+    const State& state() const { return m_state; }
+    void setState(const State& state) { m_state = state; }
+
+    // Updates the tokenizer the way the tree builder would after this token. Returns whether the
+    // main thread needs to check the guess, in which case the token needs a checkpoint.
+    bool simulate(const CompactHTMLToken&, HTMLTokenizer&);
+
+private:
+    bool inForeignContent() const { return m_state.namespaceStack.last() != HTML; }
+
+    State m_state;
+    const HTMLParserOptions m_options;
+};
+
+} // namespace WebCore
@@ -43,6 +43,10 @@ public:
 
     ALWAYS_INLINE UChar nextInputCharacter() const { return m_nextInputCharacter; }
 
+    // Part of the state HTMLTokenizer saves in a checkpoint.
+    bool skipNextNewLine() const { return m_skipNextNewLine; }
+    void setSkipNextNewLine(bool skipNextNewLine) { m_skipNextNewLine = skipNextNewLine; }
+
     // Returns whether we succeeded in peeking at the next character.
     // The only way we can fail to peek is if there are no more
     // characters in |source| (after collapsing \r\n, etc).
@@ -36,6 +36,8 @@
 #include "RuntimeApplicationChecks.h"
 #include "SharedBuffer.h"
 #include "TextResourceDecoder.h"
+#include <runtime/CachedBytecode.h>
+#include <runtime/ConcurrentProgramCompilation.h>
 
 namespace WebCore {
 
@@ -47,6 +49,8 @@ CachedScript::CachedScript(CachedResourceRequest&& request, SessionID sessionID)
 
 CachedScript::~CachedScript()
 {
+    if (m_concurrentCompilation)
+        m_concurrentCompilation->cancel();
 }
 
 void CachedScript::setEncoding(const String& chs)
@@ -109,10 +113,37 @@ unsigned CachedScript::scriptHash()
 void CachedScript::finishLoading(SharedBuffer* data)
 {
     m_data = data;
+    m_cachedBytecode = nullptr;
+    if (m_concurrentCompilation) {
+        m_concurrentCompilation->cancel();
+        m_concurrentCompilation = nullptr;
+    }
     setEncodedSize(data ? data->size() : 0);
+
+    // Start compiling before telling clients, so the compile overlaps with the rest of the
+    // parser's work if the script cannot run straight away.
+    if (data)
+        m_concurrentCompilation = JSC::ConcurrentProgramCompilation::start(script());
+
     CachedResource::finishLoading(data);
 }
 
+JSC::CachedBytecode* CachedScript::cachedBytecode()
+{
+    if (m_concurrentCompilation) {
+        RefPtr<JSC::CachedBytecode> cachedBytecode = m_concurrentCompilation->takeCachedBytecode();
+        m_concurrentCompilation = nullptr;
+        if (cachedBytecode && !m_cachedBytecode)
+            m_cachedBytecode = WTFMove(cachedBytecode);
+    }
+    return m_cachedBytecode.get();
+}
+
+void CachedScript::setCachedBytecode(Ref<JSC::CachedBytecode>&& cachedBytecode)
+{
+    m_cachedBytecode = WTFMove(cachedBytecode);
+}
+
 void CachedScript::destroyDecodedData()
 {
     m_script = String();
@@ -130,6 +161,7 @@ void CachedScript::setBodyDataFrom(const CachedResource& resource)
     m_scriptHash = script.m_scriptHash;
     m_decodingState = script.m_decodingState;
     m_decoder = script.m_decoder;
+    m_cachedBytecode = script.m_cachedBytecode;
 }
 
 #if ENABLE(NOSNIFF)
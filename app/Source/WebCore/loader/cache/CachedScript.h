@@ -27,6 +27,11 @@
 
 #include "CachedResource.h"
 
+namespace JSC {
+class CachedBytecode;
+class ConcurrentProgramCompilation;
+}
+
 namespace WebCore {
 
 class TextResourceDecoder;
@@ -41,6 +46,13 @@ public:
 
     String mimeType() const;
 
+    // Serialized bytecode for this script, produced on a background thread as soon as the script
+    // has loaded. It is validated against the source text before use, so it survives revalidation
+    // of an unchanged resource. Bytecode the CodeCache generates on the main thread is not stored
+    // here, since nothing persists it beyond the in-memory CodeCache yet.
+    JSC::CachedBytecode* cachedBytecode();
+    void setCachedBytecode(Ref<JSC::CachedBytecode>&&);
+
 #if ENABLE(NOSNIFF)
     bool mimeTypeAllowedByNosniff() const;
 #endif
@@ -66,6 +78,8 @@ private:
     DecodingState m_decodingState { NeverDecoded };
 
     RefPtr<TextResourceDecoder> m_decoder;
+    RefPtr<JSC::CachedBytecode> m_cachedBytecode;
+    RefPtr<JSC::ConcurrentProgramCompilation> m_concurrentCompilation;
 };
 
 } // namespace WebCore
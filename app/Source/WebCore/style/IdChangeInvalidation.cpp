@@ -29,6 +29,7 @@
 #include "DocumentRuleSets.h"
 #include "ElementChildIterator.h"
 #include "ShadowRoot.h"
+#include "StyleInvalidationAnalysis.h"
 #include "StyleResolver.h"
 #include "StyleScope.h"
 
@@ -79,13 +80,17 @@ void IdChangeInvalidation::invalidateStyle(const AtomicString& changedId)
 
     m_element.invalidateStyle();
 
-    // This could be easily optimized for fine-grained descendant invalidation similar to ClassChangeInvalidation.
-    // However using ids for dynamic styling is rare and this is probably not worth the memory cost of the required data structures.
-    bool mayAffectDescendantStyle = ruleSets.features().idsMatchingAncestorsInRules.contains(changedId.impl());
-    if (mayAffectDescendantStyle)
-        m_element.invalidateStyleForSubtree();
-    else
-        m_element.invalidateStyle();
+    if (!childrenOfType<Element>(m_element).first())
+        return;
+
+    auto* ancestorIdRules = ruleSets.ancestorIdRules(changedId.impl());
+    if (!ancestorIdRules)
+        return;
+
+    // The old id is invalidated before the change and the new one after it, so the rules only
+    // need to be matched in the state where the id is present.
+    StyleInvalidationAnalysis invalidationAnalysis(*ancestorIdRules);
+    invalidationAnalysis.invalidateStyle(m_element);
 }
 
 }
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "StyleParallelRuleMatcher.h"
+
+#include "CSSDefaultStyleSheets.h"
+#include "Document.h"
+#include "ElementTraversal.h"
+#include "HTMLDocument.h"
+#include "HTMLNames.h"
+#include "HTMLOptionElement.h"
+#include "HTMLSelectElement.h"
+#include "InspectorInstrumentation.h"
+#include "Settings.h"
+#include "StyleResolver.h"
+#include <wtf/ParallelJobs.h>
+
+namespace WebCore {
+namespace Style {
+
+// Below this, starting the threads costs more than the matching saves.
+static const unsigned minimumElementsPerJob = 500;
+
+static bool canMatchOffMainThread(const Element& element)
+{
+    // Rules from other scopes are found through their Style::Scope, which creates its resolver on demand.
+    if (element.isInShadowTree() || element.shadowRoot())
+        return false;
+    auto* parent = element.parentElement();
+    return !parent || !parent->shadowRoot();
+}
+
+ParallelRuleMatcher::ParallelRuleMatcher(Document& document, StyleResolver& styleResolver)
+    : m_document(document)
+    , m_styleResolver(styleResolver)
+{
+}
+
+std::unique_ptr<ParallelRuleMatcher> ParallelRuleMatcher::createIfUseful(Document& document, StyleResolver& styleResolver)
+{
+    if (!document.settings().parallelStyleResolutionEnabled())
+        return nullptr;
+    // The inspector can force pseudo-classes on, which SelectorChecker asks it about on every match.
+    if (InspectorInstrumentation::hasFrontends())
+        return nullptr;
+
+    auto matcher = std::unique_ptr<ParallelRuleMatcher>(new ParallelRuleMatcher(document, styleResolver));
+    matcher->collectCandidates();
+    unsigned jobCount = matcher->m_elements.size() / minimumElementsPerJob;
+    if (jobCount < 2)
+        return nullptr;
+
+    matcher->prepareCandidates();
+    // Preparing may have added default style sheets, so check the features afterwards.
+    if (styleResolver.ruleSets().features().usesMainThreadOnlyPseudoClasses)
+        return nullptr;
+
+    ParallelJobs<Job> parallelJobs(&ParallelRuleMatcher::matchRulesForJob, jobCount);
+    jobCount = parallelJobs.numberOfJobs();
+    if (jobCount < 2)
+        return nullptr;
+
+    // Jobs take contiguous runs of elements in document order, which keeps each one mostly within its own subtrees.
+    unsigned elementCount = matcher->m_elements.size();
+    matcher->m_collectedRules.resize(elementCount);
+    unsigned begin = 0;
+    for (unsigned i = 0; i < jobCount; ++i) {
+        auto& job = parallelJobs.parameter(i);
+        job.matcher = matcher.get();
+        job.begin = begin;
+        begin += elementCount / jobCount + (i < elementCount % jobCount ? 1 : 0);
+        job.end = begin;
+    }
+    ASSERT(begin == elementCount);
+    parallelJobs.execute();
+    document.didMatchRulesInParallel(elementCount);
+
+    for (unsigned i = 0; i < elementCount; ++i)
+        matcher->m_elementIndices.add(matcher->m_elements[i], i);
+
+    return matcher;
+}
+
+void ParallelRuleMatcher::collectCandidates()
+{
+    auto* root = m_document.documentElement();
+    auto* element = root;
+    while (element) {
+        if (element->styleValidity() >= Validity::SubtreeInvalid) {
+            // TreeResolver resolves everything below this element again.
+            for (auto* descendant = element; descendant; descendant = ElementTraversal::next(*descendant, element)) {
+                if (canMatchOffMainThread(*descendant))
+                    m_elements.append(descendant);
+            }
+            element = ElementTraversal::nextSkippingChildren(*element, root);
+            continue;
+        }
+        if (element->needsStyleRecalc() && canMatchOffMainThread(*element))
+            m_elements.append(element);
+        if (element->childNeedsStyleRecalc())
+            element = ElementTraversal::next(*element, root);
+        else
+            element = ElementTraversal::nextSkippingChildren(*element, root);
+    }
+}
+
+void ParallelRuleMatcher::prepareCandidates()
+{
+    // Compute everything matching would otherwise compute lazily. WebKit's function-local statics aren't thread-safe either.
+    HTMLDocument::isCaseSensitiveAttribute(HTMLNames::idAttr);
+
+    for (auto* element : m_elements) {
+        CSSDefaultStyleSheets::ensureDefaultStyleSheetsForElement(*element);
+        element->synchronizeAllAttributes();
+        if (is<HTMLOptionElement>(*element)) {
+            if (auto* select = downcast<HTMLOptionElement>(*element).ownerSelectElement())
+                select->updateListItemSelectedStates();
+        }
+    }
+
+    // Synchronizing attributes counts as a DOM change.
+    m_domTreeVersion = m_document.domTreeVersion();
+}
+
+void ParallelRuleMatcher::matchRulesForJob(Job* job)
+{
+    auto& matcher = *job->matcher;
+    auto& styleResolver = matcher.m_styleResolver;
+    for (unsigned i = job->begin; i < job->end; ++i) {
+        ElementRuleCollector collector(*matcher.m_elements[i], styleResolver.ruleSets(), nullptr);
+        collector.setMedium(&styleResolver.mediaQueryEvaluator());
+        collector.collectAllRules(styleResolver.matchAuthorAndUserStyles(), matcher.m_collectedRules[i]);
+    }
+}
+
+const CollectedRules* ParallelRuleMatcher::collectedRules(const Element& element) const
+{
+    if (m_document.domTreeVersion() != m_domTreeVersion)
+        return nullptr;
+    auto it = m_elementIndices.find(&element);
+    if (it == m_elementIndices.end())
+        return nullptr;
+    return &m_collectedRules[it->value];
+}
+
+}
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2017 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "ElementRuleCollector.h"
+#include <wtf/HashMap.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+class Document;
+class Element;
+class StyleResolver;
+
+namespace Style {
+
+// Matches the selectors of the elements a style recalc is going to resolve on worker threads before the recalc
+// starts. TreeResolver still builds every style itself, in order, on the main thread; it just skips matching
+// for elements it finds here.
+class ParallelRuleMatcher {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    // Returns null when matching in parallel wouldn't help or can't be done safely.
+    static std::unique_ptr<ParallelRuleMatcher> createIfUseful(Document&, StyleResolver&);
+
+    // Null if the element wasn't matched ahead of time, or if the DOM changed since.
+    const CollectedRules* collectedRules(const Element&) const;
+
+private:
+    ParallelRuleMatcher(Document&, StyleResolver&);
+
+    struct Job {
+        ParallelRuleMatcher* matcher;
+        unsigned begin;
+        unsigned end;
+    };
+    static void matchRulesForJob(Job*);
+
+    void collectCandidates();
+    void prepareCandidates();
+
+    Document& m_document;
+    StyleResolver& m_styleResolver;
+    uint64_t m_domTreeVersion { 0 };
+
+    Vector<const Element*> m_elements;
+    Vector<CollectedRules> m_collectedRules;
+    HashMap<const Element*, unsigned> m_elementIndices;
+};
+
+}
+}
@@ -81,6 +81,7 @@ std::unique_ptr<Relations> commitRelationsToRenderStyle(RenderStyle& style, cons
         case Relation::ChildrenAffectedByPropertyBasedBackwardPositionalRules:
         case Relation::ChildrenAffectedByLastChildRules:
         case Relation::NthChildIndex:
+        case Relation::NthChildIndexOfType:
             appendStyleRelation(relation);
             break;
         }
@@ -145,6 +146,11 @@ void commitRelations(std::unique_ptr<Relations> relations, Update& update)
                 style->setUnique();
             element.setChildIndex(relation.value);
             break;
+        case Relation::NthChildIndexOfType:
+            if (auto* style = update.elementStyle(element))
+                style->setUnique();
+            element.setChildIndexOfType(relation.value);
+            break;
         case Relation::Unique:
             if (auto* style = update.elementStyle(element))
                 style->setUnique();
@@ -53,6 +53,7 @@ struct Relation {
         FirstChild,
         LastChild,
         NthChildIndex,
+        NthChildIndexOfType,
         Unique,
     };
     const Element* element;
@@ -43,6 +43,7 @@
 #include "Settings.h"
 #include "ShadowRoot.h"
 #include "StyleFontSizeFunctions.h"
+#include "StyleParallelRuleMatcher.h"
 #include "StyleResolver.h"
 #include "StyleScope.h"
 #include "Text.h"
@@ -121,7 +122,8 @@ std::unique_ptr<RenderStyle> TreeResolver::styleForElement(Element& element, con
     if (auto style = scope().sharingResolver.resolve(element, *m_update))
         return style;
 
-    auto elementStyle = scope().styleResolver.styleForElement(element, &inheritedStyle, parentBoxStyle(), MatchAllRules, nullptr, &scope().selectorFilter);
+    auto* collectedRules = m_parallelRuleMatcher ? m_parallelRuleMatcher->collectedRules(element) : nullptr;
+    auto elementStyle = scope().styleResolver.styleForElement(element, &inheritedStyle, parentBoxStyle(), MatchAllRules, nullptr, &scope().selectorFilter, collectedRules);
 
     if (elementStyle.relations)
         commitRelations(WTFMove(elementStyle.relations), *m_update);
@@ -361,6 +363,15 @@ static bool hasLoadingStylesheet(const Style::Scope& styleScope, const Element&
     return false;
 }
 
+bool TreeResolver::siblingSelectorsMayMatchDescendants(Element& element)
+{
+    if (scope().styleResolver.ruleSets().features().usesSiblingSelectorsMatchingAncestors)
+        return true;
+    // The shadow tree of a host is matched against its own rules, like ":host(:first-child) span".
+    auto* shadowRoot = element.shadowRoot();
+    return shadowRoot && shadowRoot->styleScope().resolver().ruleSets().features().usesSiblingSelectorsMatchingAncestors;
+}
+
 void TreeResolver::resolveComposedTree()
 {
     ASSERT(m_parentStack.size() == 1);
@@ -425,7 +436,11 @@ void TreeResolver::resolveComposedTree()
             style = elementUpdate.style.get();
             change = elementUpdate.change;
 
-            if (affectedByPreviousSibling && change != Detach)
+            m_document.didResolveElementStyle(change != NoChange);
+
+            // Descendants only need to be re-resolved if some rule tests the siblings of their ancestors, like "li:first-child span".
+            // Otherwise the descendants depend on this element only through inheritance, which the style change already covers.
+            if (affectedByPreviousSibling && change != Detach && siblingSelectorsMayMatchDescendants(element))
                 change = Force;
 
             if (elementUpdate.style)
@@ -479,8 +494,12 @@ std::unique_ptr<Update> TreeResolver::resolve()
     renderView.setUsesFirstLineRules(renderView.usesFirstLineRules() || scope().styleResolver.usesFirstLineRules());
     renderView.setUsesFirstLetterRules(renderView.usesFirstLetterRules() || scope().styleResolver.usesFirstLetterRules());
 
+    m_parallelRuleMatcher = ParallelRuleMatcher::createIfUseful(m_document, scope().styleResolver);
+
     resolveComposedTree();
 
+    m_parallelRuleMatcher = nullptr;
+
     renderView.setUsesFirstLineRules(scope().styleResolver.usesFirstLineRules());
     renderView.setUsesFirstLetterRules(scope().styleResolver.usesFirstLetterRules());
 
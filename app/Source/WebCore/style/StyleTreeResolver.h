@@ -47,6 +47,8 @@ class StyleResolver;
 
 namespace Style {
 
+class ParallelRuleMatcher;
+
 class TreeResolver {
 public:
     TreeResolver(Document&);
@@ -61,6 +63,7 @@ private:
 
     void resolveComposedTree();
     ElementUpdate resolveElement(Element&);
+    bool siblingSelectorsMayMatchDescendants(Element&);
 
     struct Scope : RefCounted<Scope> {
         StyleResolver& styleResolver;
@@ -105,6 +108,7 @@ private:
     bool m_didSeePendingStylesheet { false };
 
     std::unique_ptr<Update> m_update;
+    std::unique_ptr<ParallelRuleMatcher> m_parallelRuleMatcher;
 };
 
 void queuePostResolutionCallback(Function<void ()>&&);
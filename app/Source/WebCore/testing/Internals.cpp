@@ -34,9 +34,11 @@
 #include "BackForwardController.h"
 #include "BitmapImage.h"
 #include "CSSAnimationController.h"
+#include "CSSDefaultStyleSheets.h"
 #include "CSSKeyframesRule.h"
 #include "CSSMediaRule.h"
 #include "CSSStyleRule.h"
+#include "CSSStyleSheet.h"
 #include "CSSSupportsRule.h"
 #include "CachedImage.h"
 #include "CachedResourceLoader.h"
@@ -100,6 +102,7 @@
 #include "PageOverlay.h"
 #include "PathUtilities.h"
 #include "PlatformMediaSessionManager.h"
+#include "PrecompiledStyleSheet.h"
 #include "PrintContext.h"
 #include "PseudoElement.h"
 #include "Range.h"
@@ -2630,6 +2633,82 @@ ExceptionOr<unsigned> Internals::styleRecalcCount()
     return document->styleRecalcCount();
 }
 
+ExceptionOr<unsigned> Internals::styleResolvedElementCount()
+{
+    Document* document = contextDocument();
+    if (!document)
+        return Exception { INVALID_ACCESS_ERR };
+
+    return document->styleResolvedElementCount();
+}
+
+ExceptionOr<unsigned> Internals::styleChangedElementCount()
+{
+    Document* document = contextDocument();
+    if (!document)
+        return Exception { INVALID_ACCESS_ERR };
+
+    return document->styleChangedElementCount();
+}
+
+ExceptionOr<unsigned> Internals::styleParallelMatchedElementCount()
+{
+    Document* document = contextDocument();
+    if (!document)
+        return Exception { INVALID_ACCESS_ERR };
+
+    return document->styleParallelMatchedElementCount();
+}
+
+ExceptionOr<unsigned> Internals::selectorCompilationFailureCount()
+{
+    Document* document = contextDocument();
+    if (!document)
+        return Exception { INVALID_ACCESS_ERR };
+
+    return document->selectorCompilationFailureCount();
+}
+
+static String styleSheetRulesText(StyleSheetContents& contents)
+{
+    auto sheet = CSSStyleSheet::create(contents);
+    StringBuilder builder;
+    for (unsigned i = 0; i < sheet->length(); ++i) {
+        builder.append(sheet->item(i)->cssText());
+        builder.append('\n');
+    }
+    return builder.toString();
+}
+
+ExceptionOr<Vector<String>> Internals::precompiledUserAgentStyleSheetRoundTrip(const String& sheetName)
+{
+    String source = CSSDefaultStyleSheets::userAgentStyleSheetSourceForTesting(sheetName);
+    if (source.isNull())
+        return Exception { NOT_FOUND_ERR };
+
+    auto parsedSheet = StyleSheetContents::create(CSSParserContext(UASheetMode));
+    parsedSheet->parseString(source);
+    Vector<uint8_t> data = encodePrecompiledStyleSheet(parsedSheet, source);
+    if (data.isEmpty())
+        return Exception { INVALID_STATE_ERR };
+
+    auto decodedSheet = decodePrecompiledStyleSheet(data.data(), data.size(), source);
+    if (!decodedSheet)
+        return Exception { INVALID_STATE_ERR };
+
+    return Vector<String> { styleSheetRulesText(parsedSheet), styleSheetRulesText(*decodedSheet) };
+}
+
+unsigned Internals::backgroundParsedChunkCount(Document& document)
+{
+    return document.backgroundParsedChunkCount();
+}
+
+unsigned Internals::discardedParserSpeculationCount(Document& document)
+{
+    return document.discardedParserSpeculationCount();
+}
+
 unsigned Internals::lastStyleUpdateSize() const
 {
     Document* document = contextDocument();
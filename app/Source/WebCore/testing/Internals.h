@@ -357,6 +357,13 @@ public:
     
     ExceptionOr<void> startTrackingStyleRecalcs();
     ExceptionOr<unsigned> styleRecalcCount();
+    ExceptionOr<unsigned> styleResolvedElementCount();
+    ExceptionOr<unsigned> styleChangedElementCount();
+    ExceptionOr<unsigned> styleParallelMatchedElementCount();
+    ExceptionOr<unsigned> selectorCompilationFailureCount();
+    ExceptionOr<Vector<String>> precompiledUserAgentStyleSheetRoundTrip(const String& sheetName);
+    unsigned backgroundParsedChunkCount(Document&);
+    unsigned discardedParserSpeculationCount(Document&);
     unsigned lastStyleUpdateSize() const;
 
     ExceptionOr<void> startTrackingCompositingUpdates();
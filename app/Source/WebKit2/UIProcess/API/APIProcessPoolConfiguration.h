@@ -71,6 +71,10 @@ public:
 
     const WTF::String& mediaCacheDirectory() const { return m_mediaCacheDirectory; }
     void setMediaCacheDirectory(const WTF::String& mediaCacheDirectory) { m_mediaCacheDirectory = mediaCacheDirectory; }
+
+    // Where web processes store the parsed user agent style sheets for each other. Empty disables it.
+    const WTF::String& userAgentStyleSheetCacheDirectory() const { return m_userAgentStyleSheetCacheDirectory; }
+    void setUserAgentStyleSheetCacheDirectory(const WTF::String& userAgentStyleSheetCacheDirectory) { m_userAgentStyleSheetCacheDirectory = userAgentStyleSheetCacheDirectory; }
     
     const WTF::String& indexedDBDatabaseDirectory() const { return m_indexedDBDatabaseDirectory; }
     void setIndexedDBDatabaseDirectory(const WTF::String& indexedDBDatabaseDirectory) { m_indexedDBDatabaseDirectory = indexedDBDatabaseDirectory; }
@@ -128,6 +132,7 @@ private:
     WTF::String m_applicationCacheFlatFileSubdirectoryName;
     WTF::String m_diskCacheDirectory;
     WTF::String m_mediaCacheDirectory;
+    WTF::String m_userAgentStyleSheetCacheDirectory;
     WTF::String m_indexedDBDatabaseDirectory;
     WTF::String m_injectedBundlePath;
     WTF::String m_localStorageDirectory;
@@ -112,6 +112,16 @@ void WKContextConfigurationSetMediaKeysStorageDirectory(WKContextConfigurationRe
     toImpl(configuration)->setMediaKeysStorageDirectory(toImpl(mediaKeysStorageDirectory)->string());
 }
 
+WKStringRef WKContextConfigurationCopyUserAgentStyleSheetCacheDirectory(WKContextConfigurationRef configuration)
+{
+    return toCopiedAPI(toImpl(configuration)->userAgentStyleSheetCacheDirectory());
+}
+
+void WKContextConfigurationSetUserAgentStyleSheetCacheDirectory(WKContextConfigurationRef configuration, WKStringRef userAgentStyleSheetCacheDirectory)
+{
+    toImpl(configuration)->setUserAgentStyleSheetCacheDirectory(toImpl(userAgentStyleSheetCacheDirectory)->string());
+}
+
 bool WKContextConfigurationFullySynchronousModeIsAllowedForTesting(WKContextConfigurationRef configuration)
 {
     return toImpl(configuration)->fullySynchronousModeIsAllowedForTesting();
@@ -552,6 +552,7 @@ void WebProcessPool::resolvePathsForSandboxExtensions()
     m_resolvedPaths.applicationCacheDirectory = resolveAndCreateReadWriteDirectoryForSandboxExtension(m_configuration->applicationCacheDirectory());
     m_resolvedPaths.webSQLDatabaseDirectory = resolveAndCreateReadWriteDirectoryForSandboxExtension(m_configuration->webSQLDatabaseDirectory());
     m_resolvedPaths.mediaCacheDirectory = resolveAndCreateReadWriteDirectoryForSandboxExtension(m_configuration->mediaCacheDirectory());
+    m_resolvedPaths.userAgentStyleSheetCacheDirectory = resolveAndCreateReadWriteDirectoryForSandboxExtension(m_configuration->userAgentStyleSheetCacheDirectory());
     m_resolvedPaths.mediaKeyStorageDirectory = resolveAndCreateReadWriteDirectoryForSandboxExtension(m_configuration->mediaKeysStorageDirectory());
 
     platformResolvePathsForSandboxExtensions();
@@ -592,6 +593,10 @@ WebProcessProxy& WebProcessPool::createNewWebProcess(WebsiteDataStore* websiteDa
     if (!parameters.mediaCacheDirectory.isEmpty())
         SandboxExtension::createHandleWithoutResolvingPath(parameters.mediaCacheDirectory, SandboxExtension::ReadWrite, parameters.mediaCacheDirectoryExtensionHandle);
 
+    parameters.userAgentStyleSheetCacheDirectory = m_resolvedPaths.userAgentStyleSheetCacheDirectory;
+    if (!parameters.userAgentStyleSheetCacheDirectory.isEmpty())
+        SandboxExtension::createHandleWithoutResolvingPath(parameters.userAgentStyleSheetCacheDirectory, SandboxExtension::ReadWrite, parameters.userAgentStyleSheetCacheDirectoryExtensionHandle);
+
     parameters.mediaKeyStorageDirectory = websiteDataStore ? websiteDataStore->resolvedMediaKeysDirectory() : m_resolvedPaths.mediaKeyStorageDirectory;
     if (parameters.mediaKeyStorageDirectory.isEmpty())
         parameters.mediaKeyStorageDirectory = m_resolvedPaths.mediaKeyStorageDirectory;
@@ -586,6 +586,7 @@ private:
         String applicationCacheDirectory;
         String webSQLDatabaseDirectory;
         String mediaCacheDirectory;
+        String userAgentStyleSheetCacheDirectory;
         String mediaKeyStorageDirectory;
         String uiProcessBundleResourcePath;
 
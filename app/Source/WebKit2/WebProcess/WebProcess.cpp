@@ -70,6 +70,7 @@
 #include <WebCore/AXObjectCache.h>
 #include <WebCore/ApplicationCacheStorage.h>
 #include <WebCore/AuthenticationChallenge.h>
+#include <WebCore/CSSDefaultStyleSheets.h>
 #include <WebCore/CommonVM.h>
 #include <WebCore/CrossOriginPreflightResultCache.h>
 #include <WebCore/DNS.h>
@@ -305,6 +306,9 @@ void WebProcess::initializeWebProcess(WebProcessCreationParameters&& parameters)
         WebCore::HTMLMediaElement::setMediaCacheDirectory(parameters.mediaCacheDirectory);
 #endif
 
+    if (!parameters.userAgentStyleSheetCacheDirectory.isEmpty())
+        WebCore::CSSDefaultStyleSheets::setPrecompiledStyleSheetDirectory(parameters.userAgentStyleSheetCacheDirectory);
+
     setCacheModel(static_cast<uint32_t>(parameters.cacheModel));
 
     if (!parameters.languages.isEmpty())